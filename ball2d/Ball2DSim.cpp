@@ -10,6 +10,7 @@
 #include "scisim/ConstrainedMaps/ImpactFrictionMap.h"
 #include "scisim/Math/MathUtilities.h"
 #include "scisim/Utilities.h"
+#include "scisim/Checkpoint.h"
 #include "scisim/Math/Rational.h"
 
 #include "Constraints/BallBallConstraint.h"
@@ -30,7 +31,10 @@
 #include "scisim/HDF5File.h"
 #endif
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <sstream>
 
 Ball2DState& Ball2DSim::state()
 {
@@ -70,7 +74,8 @@ unsigned Ball2DSim::ambientSpaceDimensions() const
 bool Ball2DSim::isKinematicallyScripted( const int i ) const
 {
   assert( i >= 0 ); assert( nvdofs() % 2 == 0 ); assert( i < nvdofs() / 2 );
-  return false;
+  // Sleeping balls are held in place until woken
+  return m_state.asleep( i );
 }
 
 void Ball2DSim::computeForce( const VectorXs& q, const VectorXs& v, const scalar& t, VectorXs& F )
@@ -79,6 +84,18 @@ void Ball2DSim::computeForce( const VectorXs& q, const VectorXs& v, const scalar
 
   F.setZero();
   m_state.accumulateForce( q, v, F );
+
+  // Sleeping balls are not integrated
+  if( m_state.sleepingIslands().enabled() )
+  {
+    for( unsigned ball_idx = 0; ball_idx < m_state.nballs(); ++ball_idx )
+    {
+      if( m_state.asleep( ball_idx ) )
+      {
+        F.segment<2>( 2 * ball_idx ).setZero();
+      }
+    }
+  }
 }
 
 void Ball2DSim::linearInertialConfigurationUpdate( const VectorXs& q0, const VectorXs& v0, const scalar& dt, VectorXs& q1 ) const
@@ -135,6 +152,17 @@ void Ball2DSim::computeAngularMomentum( const VectorXs& v, VectorXs& L ) const
   }
 }
 
+void Ball2DSim::clearSubstepConfigurations()
+{
+  m_substep_q.clear();
+}
+
+void Ball2DSim::addSubstepConfiguration( const VectorXs& q )
+{
+  assert( q.size() == m_state.q().size() );
+  m_substep_q.emplace_back( q );
+}
+
 void Ball2DSim::computeActiveSet( const VectorXs& q0, const VectorXs& qp, const VectorXs& v, std::vector<std::unique_ptr<Constraint>>& active_set )
 {
   assert( q0.size() % 2 == 0 );
@@ -142,14 +170,40 @@ void Ball2DSim::computeActiveSet( const VectorXs& q0, const VectorXs& qp, const
   assert( q0.size() == qp.size() );
   assert( active_set.empty() );
 
+  // Bound each ball over the step, shared by the ball-ball and static geometry passes
+  std::vector<AABB> aabbs;
+  generateAABBs( q0, qp, aabbs );
+
   // Detect ball-ball collisions
-  computeBallBallActiveSetSpatialGrid( q0, qp, active_set );
+  std::vector<unsigned> balls_to_wake;
+  computeBallBallActiveSetSpatialGrid( q0, qp, aabbs, active_set, balls_to_wake );
+  // Sleeping balls skip the static geometry passes, so moving planes have to wake them here
+  if( m_state.sleepingIslands().enabled() )
+  {
+    sleepersTouchingMovingPlanes( aabbs, balls_to_wake );
+  }
 
-  // Check all ball-drum pairs
-  computeBallDrumActiveSetAllPairs( q0, qp, active_set );
+  // Awake balls that touch a sleeping island wake the whole island. The woken balls can in turn
+  // touch other sleeping islands, so detection restarts until no further islands wake.
+  if( !balls_to_wake.empty() )
+  {
+    m_state.sleepingIslands().wakeIslands( balls_to_wake );
+    active_set.clear();
+    computeActiveSet( q0, qp, v, active_set );
+    return;
+  }
+
+  // Detect ball-drum collisions
+  computeBallDrumActiveSet( q0, qp, aabbs, active_set );
+
+  // Detect ball-half-plane collisions
+  computeBallPlaneActiveSet( q0, qp, aabbs, active_set );
 
-  // Check all ball-half-plane pairs
-  computeBallPlaneActiveSetAllPairs( q0, qp, active_set );
+  // Record which balls touch for building sleeping islands at the end of the step
+  if( m_state.sleepingIslands().enabled() )
+  {
+    m_state.sleepingIslands().addContacts( active_set );
+  }
 }
 
 void Ball2DSim::computeImpactBases( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, MatrixXXsc& impact_bases ) const
@@ -205,7 +259,7 @@ void Ball2DSim::computeNumberOfCollisions( std::map<std::string,unsigned>& colli
   collision_counts.clear();
   collision_depths.clear();
   std::vector<std::unique_ptr<Constraint>> active_set;
-  computeActiveSet( m_state.q(), m_state.q(), m_state.v(), active_set );
+  computeMeasurementActiveSet( active_set );
   for( const std::unique_ptr<Constraint>& constraint : active_set )
   {
     const std::string constraint_name{ constraint->name() };
@@ -236,6 +290,33 @@ void Ball2DSim::computeNumberOfCollisions( std::map<std::string,unsigned>& colli
   }
 }
 
+scalar Ball2DSim::computeMaxPenetrationDepth()
+{
+  std::vector<std::unique_ptr<Constraint>> active_set;
+  computeMeasurementActiveSet( active_set );
+  scalar max_depth{ 0.0 };
+  for( const std::unique_ptr<Constraint>& constraint : active_set )
+  {
+    // Depths are negative when bodies overlap and nan when not supported
+    const scalar depth{ constraint->penetrationDepth( m_state.q() ) };
+    if( !std::isnan( depth ) )
+    {
+      max_depth = std::max( max_depth, -depth );
+    }
+  }
+  return max_depth;
+}
+
+void Ball2DSim::computeMeasurementActiveSet( std::vector<std::unique_ptr<Constraint>>& active_set )
+{
+  // Collision detection wakes sleeping islands and records sleeping contacts; restore them so measuring
+  // between steps does not change the next step
+  assert( m_substep_q.empty() );
+  const SleepingIslands sleeping_islands{ m_state.sleepingIslands() };
+  computeActiveSet( m_state.q(), m_state.q(), m_state.v(), active_set );
+  m_state.sleepingIslands() = sleeping_islands;
+}
+
 void Ball2DSim::flow( PythonScripting& call_back, const unsigned iteration, const Rational<std::intmax_t>& dt, UnconstrainedMap& umap )
 {
   call_back.setState( m_state );
@@ -246,13 +327,17 @@ void Ball2DSim::flow( PythonScripting& call_back, const unsigned iteration, cons
   VectorXs v1{ m_state.v().size() };
 
   updatePeriodicBoundaryConditionsStartOfStep( iteration, scalar(dt) );
+  updateSleepingIslandsStartOfStep();
 
   umap.flow( m_state.q(), m_state.v(), *this, iteration, scalar(dt), q1, v1 );
+  // Substeps only bound the motion of the step that produced them
+  m_substep_q.clear();
 
   q1.swap( m_state.q() );
   v1.swap( m_state.v() );
 
   enforcePeriodicBoundaryConditions();
+  updateSleepingIslandsEndOfStep( scalar(dt) );
 
   call_back.setState( m_state );
   call_back.endOfStepCallback( iteration, dt );
@@ -269,13 +354,17 @@ void Ball2DSim::flow( PythonScripting& call_back, const unsigned iteration, cons
   VectorXs v1{ m_state.v().size() };
 
   updatePeriodicBoundaryConditionsStartOfStep( iteration, scalar(dt) );
+  updateSleepingIslandsStartOfStep();
 
   imap.flow( call_back, *this, *this, umap, iop, iteration, scalar(dt), CoR, m_state.q(), m_state.v(), q1, v1 );
+  // Substeps only bound the motion of the step that produced them
+  m_substep_q.clear();
 
   q1.swap( m_state.q() );
   v1.swap( m_state.v() );
 
   enforcePeriodicBoundaryConditions();
+  updateSleepingIslandsEndOfStep( scalar(dt) );
 
   call_back.setState( m_state );
   call_back.endOfStepCallback( iteration, dt );
@@ -292,13 +381,17 @@ void Ball2DSim::flow( PythonScripting& call_back, const unsigned iteration, cons
   VectorXs v1{ m_state.v().size() };
 
   updatePeriodicBoundaryConditionsStartOfStep( iteration, scalar(dt) );
+  updateSleepingIslandsStartOfStep();
 
   ifmap.flow( call_back, *this, *this, umap, solver, iteration, scalar(dt), CoR, mu, m_state.q(), m_state.v(), q1, v1 );
+  // Substeps only bound the motion of the step that produced them
+  m_substep_q.clear();
 
   q1.swap( m_state.q() );
   v1.swap( m_state.v() );
 
   enforcePeriodicBoundaryConditions();
+  updateSleepingIslandsEndOfStep( scalar(dt) );
 
   call_back.setState( m_state );
   call_back.endOfStepCallback( iteration, dt );
@@ -345,7 +438,136 @@ void Ball2DSim::enforcePeriodicBoundaryConditions()
   }
 }
 
-void Ball2DSim::computeBallBallActiveSetSpatialGrid( const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const
+void Ball2DSim::updateSleepingIslandsStartOfStep()
+{
+  SleepingIslands& sleeping_islands{ m_state.sleepingIslands() };
+  if( !sleeping_islands.enabled() )
+  {
+    return;
+  }
+
+  sleeping_islands.clearContacts();
+
+  // Wake any sleeping ball that a script set in motion
+  std::vector<unsigned> balls_to_wake;
+  for( unsigned ball_idx = 0; ball_idx < m_state.nballs(); ++ball_idx )
+  {
+    if( m_state.asleep( ball_idx ) && ( m_state.v().segment<2>( 2 * ball_idx ).array() != 0.0 ).any() )
+    {
+      balls_to_wake.emplace_back( ball_idx );
+    }
+  }
+  sleeping_islands.wakeIslands( balls_to_wake );
+}
+
+void Ball2DSim::updateSleepingIslandsEndOfStep( const scalar& dt )
+{
+  SleepingIslands& sleeping_islands{ m_state.sleepingIslands() };
+  if( !sleeping_islands.enabled() )
+  {
+    return;
+  }
+
+  const unsigned nballs{ m_state.nballs() };
+  VectorXs speeds{ nballs };
+  VectorXs kinetic_energies{ nballs };
+  for( unsigned ball_idx = 0; ball_idx < nballs; ++ball_idx )
+  {
+    const Vector2s v{ m_state.v().segment<2>( 2 * ball_idx ) };
+    speeds( ball_idx ) = v.norm();
+    kinetic_energies( ball_idx ) = 0.5 * m_state.M().valuePtr()[ 2 * ball_idx ] * v.squaredNorm();
+  }
+
+  // Balls in newly sleeping islands come to a complete stop
+  if( sleeping_islands.update( dt, speeds, kinetic_energies, m_state.fixed() ) != 0 )
+  {
+    for( unsigned ball_idx = 0; ball_idx < nballs; ++ball_idx )
+    {
+      if( m_state.asleep( ball_idx ) )
+      {
+        m_state.v().segment<2>( 2 * ball_idx ).setZero();
+      }
+    }
+  }
+}
+
+bool Ball2DSim::scriptedBallMoves( const unsigned ball, const VectorXs& q0, const VectorXs& q1 ) const
+{
+  return ( m_state.v().segment<2>( 2 * ball ).array() != 0.0 ).any() || q0.segment<2>( 2 * ball ) != q1.segment<2>( 2 * ball );
+}
+
+bool Ball2DSim::sleepingPairSkipped( const unsigned ball0, const unsigned ball1, const VectorXs& q0, const VectorXs& q1, std::vector<unsigned>& balls_to_wake ) const
+{
+  const bool asleep0{ m_state.asleep( ball0 ) };
+  const bool asleep1{ m_state.asleep( ball1 ) };
+  if( !asleep0 && !asleep1 )
+  {
+    return false;
+  }
+  // An awake ball wakes the island of the sleeping ball it touches, unless it is a fixed ball at rest
+  if( asleep0 && !asleep1 && ( !m_state.fixed()[ball1] || scriptedBallMoves( ball1, q0, q1 ) ) )
+  {
+    balls_to_wake.emplace_back( ball0 );
+  }
+  else if( asleep1 && !asleep0 && ( !m_state.fixed()[ball0] || scriptedBallMoves( ball0, q0, q1 ) ) )
+  {
+    balls_to_wake.emplace_back( ball1 );
+  }
+  return true;
+}
+
+void Ball2DSim::sleepersTouchingMovingPlanes( const std::vector<AABB>& aabbs, std::vector<unsigned>& balls_to_wake ) const
+{
+  assert( aabbs.size() == m_state.nballs() );
+  for( const StaticPlane& plane : m_state.staticPlanes() )
+  {
+    if( ( plane.v().array() == 0.0 ).all() )
+    {
+      continue;
+    }
+    for( unsigned ball_idx = 0; ball_idx < m_state.nballs(); ++ball_idx )
+    {
+      if( m_state.asleep( ball_idx ) && !aabbs[ball_idx].inFrontOfPlane( plane.x(), plane.n() ) )
+      {
+        balls_to_wake.emplace_back( ball_idx );
+      }
+    }
+  }
+}
+
+void Ball2DSim::generateAABBs( const VectorXs& q0, const VectorXs& q1, std::vector<AABB>& aabbs ) const
+{
+  assert( q0.size() % 2 == 0 ); assert( q0.size() == q1.size() );
+  assert( m_state.r().size() == q0.size() / 2 );
+
+  const unsigned nbodies{ m_state.nballs() };
+
+  aabbs.clear();
+  aabbs.reserve( nbodies );
+  for( unsigned bdy_idx = 0; bdy_idx < nbodies; ++bdy_idx )
+  {
+    aabbs.emplace_back( q1.segment<2>( 2 * bdy_idx ).array() - m_state.r()( bdy_idx ), q1.segment<2>( 2 * bdy_idx ).array() + m_state.r()( bdy_idx ) );
+  }
+  assert( aabbs.size() == nbodies );
+
+  // Sweep each AABB from the start of the step through the intermediate substeps so fast balls can not tunnel through each other
+  for( unsigned bdy_idx = 0; bdy_idx < nbodies; ++bdy_idx )
+  {
+    aabbs[bdy_idx].min() = aabbs[bdy_idx].min().min( q0.segment<2>( 2 * bdy_idx ).array() - m_state.r()( bdy_idx ) );
+    aabbs[bdy_idx].max() = aabbs[bdy_idx].max().max( q0.segment<2>( 2 * bdy_idx ).array() + m_state.r()( bdy_idx ) );
+  }
+  for( const VectorXs& q_substep : m_substep_q )
+  {
+    assert( q_substep.size() == q1.size() );
+    for( unsigned bdy_idx = 0; bdy_idx < nbodies; ++bdy_idx )
+    {
+      aabbs[bdy_idx].min() = aabbs[bdy_idx].min().min( q_substep.segment<2>( 2 * bdy_idx ).array() - m_state.r()( bdy_idx ) );
+      aabbs[bdy_idx].max() = aabbs[bdy_idx].max().max( q_substep.segment<2>( 2 * bdy_idx ).array() + m_state.r()( bdy_idx ) );
+    }
+  }
+}
+
+void Ball2DSim::computeBallBallActiveSetSpatialGrid( const VectorXs& q0, const VectorXs& q1, const std::vector<AABB>& ball_aabbs, std::vector<std::unique_ptr<Constraint>>& active_set, std::vector<unsigned>& balls_to_wake ) const
 {
   assert( q0.size() % 2 == 0 ); assert( q0.size() == q1.size() );
   assert( m_state.r().size() == q0.size() / 2 );
@@ -357,13 +579,8 @@ void Ball2DSim::computeBallBallActiveSetSpatialGrid( const VectorXs& q0, const V
   // Map from teleported AABB indices and body and portal indices
   std::map<unsigned,TeleportedBall> teleported_aabb_body_indices;
   {
-    // Compute an AABB for each ball
-    std::vector<AABB> aabbs;
-    aabbs.reserve( nbodies );
-    for( unsigned bdy_idx = 0; bdy_idx < nbodies; ++bdy_idx )
-    {
-      aabbs.emplace_back( q1.segment<2>( 2 * bdy_idx ).array() - m_state.r()( bdy_idx ), q1.segment<2>( 2 * bdy_idx ).array() + m_state.r()( bdy_idx ) );
-    }
+    // Teleported balls are appended after the AABB of each ball
+    std::vector<AABB> aabbs{ ball_aabbs };
     assert( aabbs.size() == nbodies );
 
     // Compute an AABB for each teleported particle
@@ -409,9 +626,14 @@ void Ball2DSim::computeBallBallActiveSetSpatialGrid( const VectorXs& q0, const V
     // If neither ball in the current collision was teleported
     if( !first_teleported && !second_teleported )
     {
+      // Sleeping balls are not tested against each other
+      if( sleepingPairSkipped( possible_overlap_pair.first, possible_overlap_pair.second, q0, q1, balls_to_wake ) )
+      {
+        continue;
+      }
       // TODO: Abstract this out like the other simulation codes
       // We can run standard narrow phase
-      if( BallBallConstraint::isActive( possible_overlap_pair.first, possible_overlap_pair.second, q1, m_state.r() ) )
+      if( ballBallActiveDuringStep( possible_overlap_pair.first, possible_overlap_pair.second, q0, q1 ) )
       {
         active_set.emplace_back( new BallBallConstraint{ possible_overlap_pair.first, possible_overlap_pair.second, q0, m_state.r()( possible_overlap_pair.first ), m_state.r()( possible_overlap_pair.second ), false } );
       }
@@ -449,6 +671,11 @@ void Ball2DSim::computeBallBallActiveSetSpatialGrid( const VectorXs& q0, const V
         prtl_plane_1 = map_itr->second.planeIndex();
       }
 
+      if( sleepingPairSkipped( bdy_idx_0, bdy_idx_1, q0, q1, balls_to_wake ) )
+      {
+        continue;
+      }
+
       // Check if the collision will be detected in the unteleported state
       if( first_teleported && second_teleported )
       {
@@ -649,16 +876,76 @@ void Ball2DSim::generateTeleportedBallBallCollision( const VectorXs& q0, const V
   }
 }
 
-void Ball2DSim::computeBallDrumActiveSetAllPairs( const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const
+bool Ball2DSim::ballBallActiveDuringStep( const unsigned ball0, const unsigned ball1, const VectorXs& q0, const VectorXs& q1 ) const
+{
+  const scalar& r0{ m_state.r()( ball0 ) };
+  const scalar& r1{ m_state.r()( ball1 ) };
+
+  // Balls move linearly between q0, each intermediate substep, and q1
+  const VectorXs* q_start{ &q0 };
+  for( const VectorXs& q_substep : m_substep_q )
+  {
+    if( BallBallConstraint::timeOfImpact( q_start->segment<2>( 2 * ball0 ), q_start->segment<2>( 2 * ball1 ), q_substep.segment<2>( 2 * ball0 ), q_substep.segment<2>( 2 * ball1 ), r0, r1 ) != SCALAR_INFINITY )
+    {
+      return true;
+    }
+    q_start = &q_substep;
+  }
+  return BallBallConstraint::timeOfImpact( q_start->segment<2>( 2 * ball0 ), q_start->segment<2>( 2 * ball1 ), q1.segment<2>( 2 * ball0 ), q1.segment<2>( 2 * ball1 ), r0, r1 ) != SCALAR_INFINITY;
+}
+
+bool Ball2DSim::ballDrumActiveDuringStep( const unsigned ball_idx, const StaticDrum& drum, const VectorXs& q1 ) const
+{
+  if( StaticDrumConstraint::isActive( ball_idx, q1, m_state.r(), drum.x(), drum.r() ) )
+  {
+    return true;
+  }
+  for( const VectorXs& q_substep : m_substep_q )
+  {
+    if( StaticDrumConstraint::isActive( ball_idx, q_substep, m_state.r(), drum.x(), drum.r() ) )
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Ball2DSim::ballPlaneActiveDuringStep( const unsigned ball_idx, const StaticPlane& plane, const VectorXs& q1 ) const
+{
+  if( StaticPlaneConstraint::isActive( ball_idx, q1, m_state.r(), plane.x(), plane.n() ) )
+  {
+    return true;
+  }
+  for( const VectorXs& q_substep : m_substep_q )
+  {
+    if( StaticPlaneConstraint::isActive( ball_idx, q_substep, m_state.r(), plane.x(), plane.n() ) )
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Ball2DSim::computeBallDrumActiveSet( const VectorXs& q0, const VectorXs& q1, const std::vector<AABB>& aabbs, std::vector<std::unique_ptr<Constraint>>& active_set ) const
 {
   assert( q0.size() == q1.size() ); assert( q0.size() % 2 == 0 ); assert( q0.size() / 2 == m_state.r().size() );
-  // Check all ball-drum pairs
+  assert( aabbs.size() == m_state.nballs() );
   using st = std::vector<StaticDrum>::size_type;
   for( st drm_idx = 0; drm_idx < m_state.staticDrums().size(); ++drm_idx )
   {
     for( unsigned ball_idx = 0; ball_idx < unsigned( m_state.r().size() ); ++ball_idx )
     {
-      if( StaticDrumConstraint::isActive( ball_idx, q1, m_state.r(), m_state.staticDrums()[drm_idx].x(), m_state.staticDrums()[drm_idx].r() ) )
+      // Sleeping balls stay in contact with static geometry without constraints
+      if( m_state.asleep( ball_idx ) )
+      {
+        continue;
+      }
+      // Balls held away from the wall over the whole step can not touch it
+      if( aabbs[ball_idx].insideCircle( m_state.staticDrums()[drm_idx].x(), m_state.staticDrums()[drm_idx].r() ) )
+      {
+        continue;
+      }
+      if( ballDrumActiveDuringStep( ball_idx, m_state.staticDrums()[drm_idx], q1 ) )
       {
         active_set.emplace_back( std::unique_ptr<Constraint>( new StaticDrumConstraint{ ball_idx, q0, m_state.r()( ball_idx ), m_state.staticDrums()[drm_idx].x(), static_cast<unsigned>(drm_idx) } ) );
       }
@@ -666,16 +953,26 @@ void Ball2DSim::computeBallDrumActiveSetAllPairs( const VectorXs& q0, const Vect
   }
 }
 
-void Ball2DSim::computeBallPlaneActiveSetAllPairs( const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const
+void Ball2DSim::computeBallPlaneActiveSet( const VectorXs& q0, const VectorXs& q1, const std::vector<AABB>& aabbs, std::vector<std::unique_ptr<Constraint>>& active_set ) const
 {
   assert( q0.size() == q1.size() ); assert( q0.size() % 2 == 0 ); assert( q0.size() / 2 == m_state.r().size() );
-  // Check all ball-plane pairs
+  assert( aabbs.size() == m_state.nballs() );
   using st = std::vector<StaticPlane>::size_type;
   for( st pln_idx = 0; pln_idx < m_state.staticPlanes().size(); ++pln_idx )
   {
     for( unsigned ball_idx = 0; ball_idx < unsigned( m_state.r().size() ); ++ball_idx )
     {
-      if( StaticPlaneConstraint::isActive( ball_idx, q1, m_state.r(), m_state.staticPlanes()[pln_idx].x(), m_state.staticPlanes()[pln_idx].n() ) )
+      // Sleeping balls stay in contact with static geometry without constraints
+      if( m_state.asleep( ball_idx ) )
+      {
+        continue;
+      }
+      // Balls entirely in front of the plane over the whole step can not touch it
+      if( aabbs[ball_idx].inFrontOfPlane( m_state.staticPlanes()[pln_idx].x(), m_state.staticPlanes()[pln_idx].n() ) )
+      {
+        continue;
+      }
+      if( ballPlaneActiveDuringStep( ball_idx, m_state.staticPlanes()[pln_idx], q1 ) )
       {
         active_set.push_back( std::unique_ptr<Constraint>( new StaticPlaneConstraint{ ball_idx, m_state.r()( ball_idx ), m_state.staticPlanes()[pln_idx], static_cast<unsigned>(pln_idx) } ) );
       }
@@ -693,14 +990,22 @@ void Ball2DSim::writeBinaryState( HDF5File& output_file ) const
     output_file.write( "q", m_state.q() );
     // Output the ball velocities
     output_file.write( "v", m_state.v() );
+  }
+  writeStaticBinaryState( output_file, "" );
+}
+
+void Ball2DSim::writeStaticBinaryState( HDF5File& output_file, const std::string& group ) const
+{
+  if( m_state.q().size() != 0 )
+  {
     // Output the ball radii
-    output_file.write( "r", m_state.r() );
+    output_file.write( group + "/r", m_state.r() );
     // Output the mass
     {
       // Assemble the mass into a single flat vector like q, v, and r
       assert( unsigned(m_state.M().nonZeros()) == 2 * m_state.nballs() );
       const VectorXs m{ Eigen::Map<const VectorXs>( &m_state.M().data().value(0), m_state.q().size() ) };
-      output_file.write( "m", m );
+      output_file.write( group + "/m", m );
     }
   }
   // Output the static planes
@@ -713,7 +1018,7 @@ void Ball2DSim::writeBinaryState( HDF5File& output_file ) const
       static_plane_centers.col( pln_idx ) = m_state.staticPlanes()[pln_idx].x();
     }
     // Save out the plane centers
-    output_file.write( "static_plane_centers", static_plane_centers );
+    output_file.write( group + "/static_plane_centers", static_plane_centers );
   }
   if( !m_state.staticPlanes().empty() )
   {
@@ -724,11 +1029,34 @@ void Ball2DSim::writeBinaryState( HDF5File& output_file ) const
       static_plane_normals.col( pln_idx ) = m_state.staticPlanes()[pln_idx].n();
     }
     // Save out the plane normals
-    output_file.write( "static_plane_normals", static_plane_normals );
+    output_file.write( group + "/static_plane_normals", static_plane_normals );
   }
 }
 #endif
 
+VectorXs Ball2DSim::staticGeometryState() const
+{
+  VectorXs state{ 6 * m_state.staticPlanes().size() };
+  for( std::vector<StaticPlane>::size_type pln_idx = 0; pln_idx < m_state.staticPlanes().size(); ++pln_idx )
+  {
+    const StaticPlane& plane{ m_state.staticPlanes()[pln_idx] };
+    state.segment<2>( 6 * pln_idx ) = plane.x();
+    state.segment<2>( 6 * pln_idx + 2 ) = plane.n();
+    state.segment<2>( 6 * pln_idx + 4 ) = plane.v();
+  }
+  return state;
+}
+
+VectorXu Ball2DSim::kinematicallyScriptedFlags() const
+{
+  VectorXu fixed{ m_state.nballs() };
+  for( unsigned ball_idx = 0; ball_idx < m_state.nballs(); ++ball_idx )
+  {
+    fixed( ball_idx ) = m_state.fixed()[ball_idx] || m_state.asleep( ball_idx ) ? 1 : 0;
+  }
+  return fixed;
+}
+
 void Ball2DSim::serialize( std::ostream& output_stream ) const
 {
   assert( output_stream.good() );
@@ -742,3 +1070,18 @@ void Ball2DSim::deserialize( std::istream& input_stream )
   m_state.deserialize( input_stream );
   m_constraint_cache.deserialize( input_stream );
 }
+
+void Ball2DSim::writeCheckpoint( CheckpointWriter& checkpoint ) const
+{
+  m_state.writeCheckpoint( "state/", checkpoint );
+  std::ostringstream output_stream;
+  m_constraint_cache.serialize( output_stream );
+  checkpoint.addSection( "constraint_cache", output_stream.str() );
+}
+
+void Ball2DSim::readCheckpoint( const CheckpointReader& checkpoint )
+{
+  m_state.readCheckpoint( "state/", checkpoint );
+  CheckpointSectionStream input_stream{ checkpoint, "constraint_cache" };
+  m_constraint_cache.deserialize( input_stream );
+}
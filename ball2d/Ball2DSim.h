@@ -17,11 +17,14 @@
 
 class UnconstrainedMap;
 class ImpactOperator;
+class AABB;
 class TeleportedCollision;
 class ImpactMap;
 class ImpactFrictionMap;
 class PythonScripting;
 class FrictionSolver;
+class CheckpointWriter;
+class CheckpointReader;
 template<typename T> class Rational;
 
 #ifdef USE_HDF5
@@ -66,6 +69,9 @@ public:
   virtual void computeMomentum( const VectorXs& v, VectorXs& p ) const override;
   virtual void computeAngularMomentum( const VectorXs& v, VectorXs& L ) const override;
 
+  virtual void clearSubstepConfigurations() override;
+  virtual void addSubstepConfiguration( const VectorXs& q ) override;
+
   // Inherited from ConstrainedSystem
   virtual void computeActiveSet( const VectorXs& q0, const VectorXs& qp, const VectorXs& v, std::vector<std::unique_ptr<Constraint>>& active_set ) override;
   virtual void computeImpactBases( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, MatrixXXsc& impact_bases ) const override;
@@ -75,9 +81,14 @@ public:
   virtual void getCachedConstraintImpulse( const Constraint& constraint, VectorXs& r ) const override;
   virtual bool constraintCacheEmpty() const override;
 
-  // Computes the number of collisions in the current state and the total amount of penetration
+  // Computes the number of collisions in the current state and the total amount of penetration; sleeping islands are
+  // left as they were, so this can be called between steps without changing the simulation
   void computeNumberOfCollisions( std::map<std::string,unsigned>& collision_counts, std::map<std::string,scalar>& collision_depths );
 
+  // Deepest penetration over the active constraints in the current state, or zero if nothing overlaps; leaves the
+  // simulation unchanged as computeNumberOfCollisions does
+  scalar computeMaxPenetrationDepth();
+
   // Flow using only an unconstrained map
   void flow( PythonScripting& call_back, const unsigned iteration, const Rational<std::intmax_t>& dt, UnconstrainedMap& umap );
 
@@ -87,31 +98,65 @@ public:
   // Flow using an unconstrained map, an impact-friction map
   void flow( PythonScripting& call_back, const unsigned iteration, const Rational<std::intmax_t>& dt, UnconstrainedMap& umap, const scalar& CoR, const scalar& mu, FrictionSolver& solver, ImpactFrictionMap& ifmap );
 
+  // Center, normal, and velocity of each static plane; scripts may change these every step
+  VectorXs staticGeometryState() const;
+  // 1 for each ball the simulation holds fixed, either because it is fixed or asleep
+  VectorXu kinematicallyScriptedFlags() const;
+
   #ifdef USE_HDF5
   void writeBinaryState( HDF5File& output_file ) const;
+  // Writes the data that does not change between frames to the given group
+  void writeStaticBinaryState( HDF5File& output_file, const std::string& group ) const;
   #endif
 
   void serialize( std::ostream& output_stream ) const;
   void deserialize( std::istream& input_stream );
 
+  void writeCheckpoint( CheckpointWriter& checkpoint ) const;
+  void readCheckpoint( const CheckpointReader& checkpoint );
+
 private:
 
   // TODO: Most of these methods don't need to be methods...
 
+  // Active set in the current state, restoring the sleeping islands it updates
+  void computeMeasurementActiveSet( std::vector<std::unique_ptr<Constraint>>& active_set );
+
   void updatePeriodicBoundaryConditionsStartOfStep( const unsigned next_iteration, const scalar& dt );
   void enforcePeriodicBoundaryConditions();
 
+  void updateSleepingIslandsStartOfStep();
+  void updateSleepingIslandsEndOfStep( const scalar& dt );
+  // True if a fixed ball has a nonzero velocity or moves between q0 and q1
+  bool scriptedBallMoves( const unsigned ball, const VectorXs& q0, const VectorXs& q1 ) const;
+  // Returns true if either ball is asleep, queueing a sleeping ball touched by a simulated or moving fixed ball for waking
+  bool sleepingPairSkipped( const unsigned ball0, const unsigned ball1, const VectorXs& q0, const VectorXs& q1, std::vector<unsigned>& balls_to_wake ) const;
+  // Queues sleeping balls whose bounding boxes touch static planes with a nonzero velocity
+  void sleepersTouchingMovingPlanes( const std::vector<AABB>& aabbs, std::vector<unsigned>& balls_to_wake ) const;
+
   void getTeleportedBallBallCenters( const VectorXs& q, const TeleportedCollision& teleported_collision, Vector2s& x0, Vector2s& x1 ) const;
   bool teleportedBallBallCollisionHappens( const VectorXs& q, const TeleportedCollision& teleported_collision ) const;
   void generateTeleportedBallBallCollision( const VectorXs& q0, const VectorXs& q1, const VectorXs& r, const TeleportedCollision& teleported_collision, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
 
-  void computeBallBallActiveSetSpatialGrid( const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
-  void computeBallDrumActiveSetAllPairs( const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
-  void computeBallPlaneActiveSetAllPairs( const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
+  // Bounds each ball from q0 through each intermediate substep to q1
+  void generateAABBs( const VectorXs& q0, const VectorXs& q1, std::vector<AABB>& aabbs ) const;
+
+  void computeBallBallActiveSetSpatialGrid( const VectorXs& q0, const VectorXs& q1, const std::vector<AABB>& ball_aabbs, std::vector<std::unique_ptr<Constraint>>& active_set, std::vector<unsigned>& balls_to_wake ) const;
+  // Static geometry is only tested against balls whose swept AABBs can reach it
+  void computeBallDrumActiveSet( const VectorXs& q0, const VectorXs& q1, const std::vector<AABB>& aabbs, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
+  void computeBallPlaneActiveSet( const VectorXs& q0, const VectorXs& q1, const std::vector<AABB>& aabbs, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
+
+  // Narrow phase checks over the whole step; ball-ball pairs are swept from q0 through each intermediate substep to q1
+  bool ballBallActiveDuringStep( const unsigned ball0, const unsigned ball1, const VectorXs& q0, const VectorXs& q1 ) const;
+  bool ballDrumActiveDuringStep( const unsigned ball_idx, const StaticDrum& drum, const VectorXs& q1 ) const;
+  bool ballPlaneActiveDuringStep( const unsigned ball_idx, const StaticPlane& plane, const VectorXs& q1 ) const;
 
   Ball2DState m_state;
   ConstraintCache m_constraint_cache;
 
+  // Configurations at the end of each intermediate substep of the most recent unconstrained flow
+  std::vector<VectorXs> m_substep_q;
+
 };
 
 #endif
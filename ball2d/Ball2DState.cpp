@@ -8,13 +8,16 @@
 #include "scisim/Math/MathUtilities.h"
 #include "scisim/Utilities.h"
 #include "scisim/StringUtilities.h"
+#include "scisim/Checkpoint.h"
 #include "Forces/Ball2DGravityForce.h"
+#include "Forces/PenaltyForce.h"
 
 #include "StaticGeometry/StaticDrum.h"
 #include "StaticGeometry/StaticPlane.h"
 #include "Portals/PlanarPortal.h"
 
 #include <iostream>
+#include <sstream>
 
 Ball2DState::Ball2DState( const Ball2DState& other )
 : m_q( other.m_q )
@@ -27,6 +30,8 @@ Ball2DState::Ball2DState( const Ball2DState& other )
 , m_static_planes( other.m_static_planes )
 , m_planar_portals( other.m_planar_portals )
 , m_forces( Utilities::clone( other.m_forces ) )
+, m_sleeping_islands( other.m_sleeping_islands )
+, m_neighbor_list( other.m_neighbor_list )
 {}
 
 Ball2DState& Ball2DState::operator=( const Ball2DState& other )
@@ -101,6 +106,11 @@ std::vector<bool>& Ball2DState::fixed()
   return m_fixed;
 }
 
+const std::vector<bool>& Ball2DState::fixed() const
+{
+  return m_fixed;
+}
+
 const VectorXs& Ball2DState::q() const
 {
   return m_q;
@@ -166,6 +176,32 @@ std::vector<std::unique_ptr<Ball2DForce>>& Ball2DState::forces()
   return m_forces;
 }
 
+SleepingIslands& Ball2DState::sleepingIslands()
+{
+  return m_sleeping_islands;
+}
+
+const SleepingIslands& Ball2DState::sleepingIslands() const
+{
+  return m_sleeping_islands;
+}
+
+bool Ball2DState::asleep( const unsigned ball_idx ) const
+{
+  assert( ball_idx < nballs() );
+  return m_sleeping_islands.enabled() && m_sleeping_islands.asleep( ball_idx );
+}
+
+NeighborList& Ball2DState::neighborList()
+{
+  return m_neighbor_list;
+}
+
+const NeighborList& Ball2DState::neighborList() const
+{
+  return m_neighbor_list;
+}
+
 scalar Ball2DState::computeKineticEnergy() const
 {
   return 0.5 * m_v.dot( m_M * m_v ) ;
@@ -176,7 +212,7 @@ scalar Ball2DState::computePotentialEnergy() const
   scalar U{ 0.0 };
   for( const std::unique_ptr<Ball2DForce>& force : m_forces )
   {
-    U += force->computePotential( m_q, m_M, m_r );
+    U += force->computePotential( m_q, m_M, m_r, m_neighbor_list );
   }
   return U;
 }
@@ -252,7 +288,7 @@ void Ball2DState::accumulateForce( const VectorXs& q, const VectorXs& v, VectorX
 {
   for( const std::unique_ptr<Ball2DForce>& force : m_forces )
   {
-    force->computeForce( q, v, m_M, m_r, force_accm );
+    force->computeForce( q, v, m_M, m_r, m_neighbor_list, force_accm );
   }
 }
 
@@ -269,6 +305,34 @@ void Ball2DState::serialize( std::ostream& output_stream ) const
   Utilities::serialize( m_static_planes, output_stream );
   Utilities::serialize( m_planar_portals, output_stream );
   Utilities::serialize( m_forces, output_stream );
+  m_sleeping_islands.serialize( output_stream );
+  Utilities::serialize( m_neighbor_list.skin(), output_stream );
+}
+
+// TODO: Pull this into a utility function along with some code in Ball2DForce
+static void deserializeForces( std::istream& input_stream, std::vector<std::unique_ptr<Ball2DForce>>& forces )
+{
+  std::vector<std::unique_ptr<Ball2DForce>>::size_type num_forces;
+  input_stream.read( (char*) &num_forces, sizeof(std::vector<std::unique_ptr<Ball2DForce>>::size_type) );
+  forces.resize( num_forces );
+  for( std::vector<std::unique_ptr<Ball2DForce>>::size_type force_idx = 0; force_idx < forces.size(); ++force_idx )
+  {
+    // Read in the force name
+    const std::string force_name{ StringUtilities::deserialize( input_stream ) };
+    if( "ball2d_gravity_force" == force_name )
+    {
+      forces[force_idx] = std::unique_ptr<Ball2DForce>{ new Ball2DGravityForce{ input_stream } };
+    }
+    else if( "hertzian_penalty" == force_name )
+    {
+      forces[force_idx] = std::unique_ptr<Ball2DForce>{ new PenaltyForce{ input_stream } };
+    }
+    else
+    {
+      std::cerr << "Unknown force in deserialize." << std::endl;
+      std::exit( EXIT_FAILURE );
+    }
+  }
 }
 
 void Ball2DState::deserialize( std::istream& input_stream )
@@ -288,25 +352,106 @@ void Ball2DState::deserialize( std::istream& input_stream )
   m_static_planes = Utilities::deserializeVector<StaticPlane>( input_stream );
   m_planar_portals = Utilities::deserializeVector<PlanarPortal>( input_stream );
 
-  // TODO: Pull this into a utility function along with some code in Ball2DForce
+  deserializeForces( input_stream, m_forces );
+
+  m_sleeping_islands = SleepingIslands{ input_stream };
+  assert( m_sleeping_islands.nbodies() == nballs() );
+
+  m_neighbor_list = NeighborList{ Utilities::deserialize<scalar>( input_stream ) };
+}
+
+void Ball2DState::writeCheckpoint( const std::string& prefix, CheckpointWriter& checkpoint ) const
+{
+  checkpoint.addArray( prefix + "q", m_q );
+  checkpoint.addArray( prefix + "v", m_v );
+  checkpoint.addArray( prefix + "r", m_r );
   {
-    std::vector<std::unique_ptr<Ball2DForce>>::size_type num_forces;
-    input_stream.read( (char*) &num_forces, sizeof(std::vector<std::unique_ptr<Ball2DForce>>::size_type) );
-    m_forces.resize( num_forces );
-    for( std::vector<std::unique_ptr<Ball2DForce>>::size_type force_idx = 0; force_idx < m_forces.size(); ++force_idx )
+    VectorXu fixed{ VectorXu::Zero( long( m_fixed.size() ) ) };
+    for( std::vector<bool>::size_type bdy_idx = 0; bdy_idx < m_fixed.size(); ++bdy_idx )
     {
-      // Read in the force name
-      const std::string force_name{ StringUtilities::deserialize( input_stream ) };
-      if( "ball2d_gravity_force" == force_name )
-      {
-        m_forces[force_idx] = std::unique_ptr<Ball2DForce>{ new Ball2DGravityForce{ input_stream } };
-      }
-      else
-      {
-        std::cerr << "Unknown force in deserialize." << std::endl;
-        std::exit( EXIT_FAILURE );
-      }
+      fixed( bdy_idx ) = m_fixed[bdy_idx] ? 1 : 0;
     }
+    checkpoint.addArray( prefix + "fixed", std::move( fixed ) );
+  }
+  checkpoint.addSparseMatrix( prefix + "M", m_M );
+  checkpoint.addSparseMatrix( prefix + "Minv", m_Minv );
+  // Objects are stored in separate sections so those that do not change can be shared with an anchor
+  {
+    std::ostringstream output_stream;
+    Utilities::serialize( m_static_drums, output_stream );
+    checkpoint.addSection( prefix + "static_drums", output_stream.str() );
+  }
+  {
+    std::ostringstream output_stream;
+    Utilities::serialize( m_static_planes, output_stream );
+    checkpoint.addSection( prefix + "static_planes", output_stream.str() );
+  }
+  {
+    std::ostringstream output_stream;
+    Utilities::serialize( m_planar_portals, output_stream );
+    checkpoint.addSection( prefix + "planar_portals", output_stream.str() );
+  }
+  {
+    std::ostringstream output_stream;
+    Utilities::serialize( m_forces, output_stream );
+    checkpoint.addSection( prefix + "forces", output_stream.str() );
+  }
+  {
+    std::ostringstream output_stream;
+    m_sleeping_islands.serialize( output_stream );
+    checkpoint.addSection( prefix + "sleeping_islands", output_stream.str() );
+  }
+  {
+    std::ostringstream output_stream;
+    Utilities::serialize( m_neighbor_list.skin(), output_stream );
+    checkpoint.addSection( prefix + "neighbor_list", output_stream.str() );
+  }
+}
+
+void Ball2DState::readCheckpoint( const std::string& prefix, const CheckpointReader& checkpoint )
+{
+  m_q = checkpoint.readArray<VectorXs>( prefix + "q" );
+  m_v = checkpoint.readArray<VectorXs>( prefix + "v" );
+  m_r = checkpoint.readArray<VectorXs>( prefix + "r" );
+  if( m_q.size() != 2 * m_r.size() || m_v.size() != m_q.size() )
+  {
+    throw std::string{ "Inconsistent ball state in checkpoint sections " } + prefix;
+  }
+  assert( ( m_r.array() > 0.0 ).all() );
+  {
+    const VectorXu fixed{ checkpoint.readArray<VectorXu>( prefix + "fixed" ) };
+    m_fixed.resize( std::vector<bool>::size_type( fixed.size() ) );
+    for( std::vector<bool>::size_type bdy_idx = 0; bdy_idx < m_fixed.size(); ++bdy_idx )
+    {
+      m_fixed[bdy_idx] = fixed( bdy_idx ) != 0;
+    }
+  }
+  checkpoint.readSparseMatrix( prefix + "M", m_M );
+  checkpoint.readSparseMatrix( prefix + "Minv", m_Minv );
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "static_drums" };
+    m_static_drums = Utilities::deserializeVector<StaticDrum>( input_stream );
+  }
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "static_planes" };
+    m_static_planes = Utilities::deserializeVector<StaticPlane>( input_stream );
+  }
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "planar_portals" };
+    m_planar_portals = Utilities::deserializeVector<PlanarPortal>( input_stream );
+  }
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "forces" };
+    deserializeForces( input_stream, m_forces );
+  }
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "sleeping_islands" };
+    m_sleeping_islands = SleepingIslands{ input_stream };
+  }
+  assert( m_sleeping_islands.nbodies() == nballs() );
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "neighbor_list" };
+    m_neighbor_list = NeighborList{ Utilities::deserialize<scalar>( input_stream ) };
   }
 }
 
@@ -326,6 +471,8 @@ void Ball2DState::pushBallBack( const Vector2s& q, const Vector2s& v, const scal
   m_r( original_num_balls ) = r;
   // Update fixed balls
   m_fixed.push_back( fixed );
+  // New balls start awake
+  m_sleeping_islands.resize( new_num_balls );
   // Update the mass matrix
   {
     SparseMatrixsc M( 2 * new_num_balls, 2 * new_num_balls );
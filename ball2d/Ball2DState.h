@@ -9,11 +9,16 @@
 #include <memory>
 
 #include "scisim/Math/MathDefines.h"
+#include "scisim/SleepingIslands.h"
+#include "NeighborList.h"
 #include "Forces/Ball2DForce.h"
 #include "StaticGeometry/StaticDrum.h"
 #include "StaticGeometry/StaticPlane.h"
 #include "Portals/PlanarPortal.h"
 
+class CheckpointWriter;
+class CheckpointReader;
+
 class Ball2DState final
 {
 
@@ -35,6 +40,7 @@ public:
   VectorXs& v();
   VectorXs& r();
   std::vector<bool>& fixed();
+  const std::vector<bool>& fixed() const;
   const VectorXs& q() const;
   const VectorXs& v() const;
   const VectorXs& r() const;
@@ -53,6 +59,15 @@ public:
 
   std::vector<std::unique_ptr<Ball2DForce>>& forces();
 
+  // Balls at rest that are excluded from integration and collision detection
+  SleepingIslands& sleepingIslands();
+  const SleepingIslands& sleepingIslands() const;
+  bool asleep( const unsigned ball_idx ) const;
+
+  // Nearby pairs of balls handed to the forces
+  NeighborList& neighborList();
+  const NeighborList& neighborList() const;
+
   // Energy, momentum, etc computations
   scalar computeKineticEnergy() const;
   scalar computePotentialEnergy() const;
@@ -70,6 +85,10 @@ public:
   void serialize( std::ostream& output_stream ) const;
   void deserialize( std::istream& input_stream );
 
+  // Stores q, v, and the other per body arrays under prefix; each remaining member is serialized to its own section
+  void writeCheckpoint( const std::string& prefix, CheckpointWriter& checkpoint ) const;
+  void readCheckpoint( const std::string& prefix, const CheckpointReader& checkpoint );
+
   // Inserts a new ball after all current balls
   // NOTE: This is currently quite slow...
   void pushBallBack( const Vector2s& q, const Vector2s& v, const scalar& r, const scalar& m, const bool fixed );
@@ -90,6 +109,11 @@ private:
 
   std::vector<std::unique_ptr<Ball2DForce>> m_forces;
 
+  SleepingIslands m_sleeping_islands;
+
+  // Cache of nearby pairs, reused across force evaluations
+  mutable NeighborList m_neighbor_list{ 0.0 };
+
 };
 
 #endif
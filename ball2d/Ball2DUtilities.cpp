@@ -7,8 +7,11 @@
 
 #include <cassert>
 #include "scisim/StringUtilities.h"
+#include "scisim/Utilities.h"
 #include "scisim/UnconstrainedMaps/UnconstrainedMap.h"
+#include "scisim/UnconstrainedMaps/SubsteppedMap.h"
 #include "ball2d/VerletMap.h"
+#include "ball2d/SymplecticEulerMap.h"
 
 #include <iostream>
 
@@ -38,6 +41,16 @@ std::unique_ptr<UnconstrainedMap> Ball2DUtilities::deserializeUnconstrainedMap(
   {
     unconstrained_map.reset( new VerletMap{ input_stream } );
   }
+  else if( "symplectic_euler" == integrator_name )
+  {
+    unconstrained_map.reset( new SymplecticEulerMap{ input_stream } );
+  }
+  else if( "substepped" == integrator_name )
+  {
+    const unsigned num_substeps{ Utilities::deserialize<unsigned>( input_stream ) };
+    std::unique_ptr<UnconstrainedMap> wrapped_map{ deserializeUnconstrainedMap( input_stream ) };
+    unconstrained_map.reset( new SubsteppedMap{ std::move( wrapped_map ), num_substeps } );
+  }
   else
   {
     std::cerr << "Deserialization not supported for: " << integrator_name << std::endl;
@@ -5,6 +5,8 @@
 
 #include "BallBallConstraint.h"
 
+#include "scisim/Math/MathUtilities.h"
+
 bool BallBallConstraint::isActive( const unsigned idx0, const unsigned idx1, const VectorXs& q, const VectorXs& r )
 {
   assert( q.size() % 2 == 0 ); assert( r.size() == q.size() / 2 );
@@ -19,6 +21,11 @@ bool BallBallConstraint::isActive( const Vector2s& x0, const Vector2s& x1, const
   return ( x0 - x1 ).squaredNorm() <= ( r0 + r1 ) * ( r0 + r1 );
 }
 
+scalar BallBallConstraint::timeOfImpact( const Vector2s& x0_start, const Vector2s& x1_start, const Vector2s& x0_end, const Vector2s& x1_end, const scalar& r0, const scalar& r1 )
+{
+  return MathUtilities::sphereSphereTimeOfImpact<2>( x0_start, x1_start, x0_end, x1_end, r0, r1 );
+}
+
 BallBallConstraint::BallBallConstraint( const unsigned idx0, const unsigned idx1, const VectorXs& q, const scalar& r0, const scalar& r1, const bool teleported )
 : BallBallConstraint( idx0, idx1, q.segment<2>( 2 * idx0 ), q.segment<2>( 2 * idx1 ), r0, r1, teleported )
 {}
@@ -17,6 +17,9 @@ public:
 
   static bool isActive( const unsigned idx0, const unsigned idx1, const VectorXs& q, const VectorXs& r );
   static bool isActive( const Vector2s& x0, const Vector2s& x1, const scalar& r0, const scalar& r1 );
+  // Fraction of the step at which two balls moving linearly from the start to the end positions first touch,
+  // 0 if they start in contact and infinity if they do not touch during the step
+  static scalar timeOfImpact( const Vector2s& x0_start, const Vector2s& x1_start, const Vector2s& x0_end, const Vector2s& x1_end, const scalar& r0, const scalar& r1 );
 
   BallBallConstraint( const unsigned idx0, const unsigned idx1, const VectorXs& q, const scalar& r0, const scalar& r1, const bool teleported );
   BallBallConstraint( const unsigned idx0, const unsigned idx1, const Vector2s& x0, const Vector2s& x1, const scalar& r0, const scalar& r1, const bool teleported );
@@ -10,6 +10,8 @@
 
 #include <memory>
 
+class NeighborList;
+
 class Ball2DForce
 {
 
@@ -17,10 +19,11 @@ public:
 
   virtual ~Ball2DForce() = 0;
 
-  virtual scalar computePotential( const VectorXs& q, const SparseMatrixsc& M, const VectorXs& r ) const = 0;
+  // Pair forces visit the nearby balls reported by the neighbor list shared by all forces of the state
+  virtual scalar computePotential( const VectorXs& q, const SparseMatrixsc& M, const VectorXs& r, NeighborList& neighbors ) const = 0;
 
   // result += Force
-  virtual void computeForce( const VectorXs& q, const VectorXs& v, const SparseMatrixsc& M, const VectorXs& r, VectorXs& result ) const = 0;
+  virtual void computeForce( const VectorXs& q, const VectorXs& v, const SparseMatrixsc& M, const VectorXs& r, NeighborList& neighbors, VectorXs& result ) const = 0;
 
   virtual std::unique_ptr<Ball2DForce> clone() const = 0;
 
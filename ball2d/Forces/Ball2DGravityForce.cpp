@@ -19,7 +19,7 @@ Ball2DGravityForce::Ball2DGravityForce( std::istream& input_stream )
 Ball2DGravityForce::~Ball2DGravityForce()
 {}
 
-scalar Ball2DGravityForce::computePotential( const VectorXs& q, const SparseMatrixsc& M, const VectorXs& r ) const
+scalar Ball2DGravityForce::computePotential( const VectorXs& q, const SparseMatrixsc& M, const VectorXs& r, NeighborList& neighbors ) const
 {
   assert( q.size() % 2 == 0 ); assert( q.size() == M.rows() ); assert( q.size() == M.cols() );
 
@@ -33,7 +33,7 @@ scalar Ball2DGravityForce::computePotential( const VectorXs& q, const SparseMatr
   return U;
 }
 
-void Ball2DGravityForce::computeForce( const VectorXs& q, const VectorXs& v, const SparseMatrixsc& M, const VectorXs& r, VectorXs& result ) const
+void Ball2DGravityForce::computeForce( const VectorXs& q, const VectorXs& v, const SparseMatrixsc& M, const VectorXs& r, NeighborList& neighbors, VectorXs& result ) const
 {
   assert( q.size() % 2 == 0 ); assert( q.size() == v.size() ); assert( q.size() == M.rows() );
   assert( q.size() == M.cols() ); assert( q.size() == result.size() );
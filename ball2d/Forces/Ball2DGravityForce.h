@@ -18,10 +18,10 @@ public:
 
   virtual ~Ball2DGravityForce() override;
 
-  virtual scalar computePotential( const VectorXs& q, const SparseMatrixsc& M, const VectorXs& r ) const override;
+  virtual scalar computePotential( const VectorXs& q, const SparseMatrixsc& M, const VectorXs& r, NeighborList& neighbors ) const override;
 
   // result += Force
-  virtual void computeForce( const VectorXs& q, const VectorXs& v, const SparseMatrixsc& M, const VectorXs& r, VectorXs& result ) const override;
+  virtual void computeForce( const VectorXs& q, const VectorXs& v, const SparseMatrixsc& M, const VectorXs& r, NeighborList& neighbors, VectorXs& result ) const override;
 
   virtual std::unique_ptr<Ball2DForce> clone() const override;
 
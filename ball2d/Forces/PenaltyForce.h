@@ -13,16 +13,16 @@ class PenaltyForce final : public Ball2DForce
 
 public:
 
-  explicit PenaltyForce( const scalar& k, const scalar& power );
+  PenaltyForce( const scalar& k, const scalar& power );
   explicit PenaltyForce( const PenaltyForce& other );
   explicit PenaltyForce( std::istream& input_stream );
 
   virtual ~PenaltyForce() override;
 
-  virtual scalar computePotential( const VectorXs& q, const SparseMatrixsc& M, const VectorXs& r ) const override;
+  virtual scalar computePotential( const VectorXs& q, const SparseMatrixsc& M, const VectorXs& r, NeighborList& neighbors ) const override;
 
   // result += Force
-  virtual void computeForce( const VectorXs& q, const VectorXs& v, const SparseMatrixsc& M, const VectorXs& r, VectorXs& result ) const override;
+  virtual void computeForce( const VectorXs& q, const VectorXs& v, const SparseMatrixsc& M, const VectorXs& r, NeighborList& neighbors, VectorXs& result ) const override;
 
   virtual std::unique_ptr<Ball2DForce> clone() const override;
 
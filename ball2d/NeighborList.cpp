@@ -0,0 +1,93 @@
+// NeighborList.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "NeighborList.h"
+
+#include "SpatialGridDetector.h"
+
+#include <algorithm>
+#include <set>
+
+NeighborList::NeighborList( const scalar& skin )
+: m_skin( skin )
+, m_q()
+, m_r()
+, m_pairs()
+{
+  assert( m_skin >= 0.0 );
+}
+
+const scalar& NeighborList::skin() const
+{
+  return m_skin;
+}
+
+const std::vector<std::pair<unsigned,unsigned>>& NeighborList::pairs( const VectorXs& q, const VectorXs& r )
+{
+  assert( q.size() % 2 == 0 ); assert( r.size() == q.size() / 2 );
+  if( rebuildNeeded( q, r ) )
+  {
+    rebuild( q, r );
+  }
+  return m_pairs;
+}
+
+bool NeighborList::rebuildNeeded( const VectorXs& q, const VectorXs& r ) const
+{
+  if( q.size() != m_q.size() || r.size() != m_r.size() || r.size() == 0 )
+  {
+    return true;
+  }
+  if( ( r.array() != m_r.array() ).any() )
+  {
+    return true;
+  }
+  // A pair can only come into contact once the balls together close the skin gap
+  const scalar max_displacement{ 0.5 * m_skin };
+  for( int ball_idx = 0; ball_idx < r.size(); ++ball_idx )
+  {
+    if( ( q.segment<2>( 2 * ball_idx ) - m_q.segment<2>( 2 * ball_idx ) ).squaredNorm() > max_displacement * max_displacement )
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void NeighborList::rebuild( const VectorXs& q, const VectorXs& r )
+{
+  m_q = q;
+  m_r = r;
+  m_pairs.clear();
+
+  const unsigned nballs{ unsigned( r.size() ) };
+  if( nballs < 2 )
+  {
+    return;
+  }
+
+  // Boxes grown by half the skin overlap whenever two surfaces are within the skin
+  std::vector<AABB> aabbs;
+  aabbs.reserve( nballs );
+  for( unsigned ball_idx = 0; ball_idx < nballs; ++ball_idx )
+  {
+    const scalar extent{ r( ball_idx ) + 0.5 * m_skin };
+    aabbs.emplace_back( q.segment<2>( 2 * ball_idx ).array() - extent, q.segment<2>( 2 * ball_idx ).array() + extent );
+  }
+  std::set<std::pair<unsigned,unsigned>> possible_overlaps;
+  SpatialGridDetector::getPotentialOverlaps( aabbs, possible_overlaps );
+
+  m_pairs.reserve( possible_overlaps.size() );
+  for( const std::pair<unsigned,unsigned>& possible_overlap : possible_overlaps )
+  {
+    const unsigned ball0{ std::min( possible_overlap.first, possible_overlap.second ) };
+    const unsigned ball1{ std::max( possible_overlap.first, possible_overlap.second ) };
+    const scalar cutoff{ r( ball0 ) + r( ball1 ) + m_skin };
+    if( ( q.segment<2>( 2 * ball1 ) - q.segment<2>( 2 * ball0 ) ).squaredNorm() <= cutoff * cutoff )
+    {
+      m_pairs.emplace_back( ball0, ball1 );
+    }
+  }
+}
@@ -0,0 +1,44 @@
+// NeighborList.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Verlet list of ball pairs whose surfaces are within a skin distance of each other, built
+// with the spatial grid. The list is reused until some ball moves more than half the skin
+// since the last build, so pair queries between rebuilds cost O(n).
+
+#ifndef NEIGHBOR_LIST_H
+#define NEIGHBOR_LIST_H
+
+#include "scisim/Math/MathDefines.h"
+
+#include <utility>
+#include <vector>
+
+class NeighborList final
+{
+
+public:
+
+  explicit NeighborList( const scalar& skin );
+
+  const scalar& skin() const;
+
+  // Pairs of balls, first index smaller, that may touch; rebuilt first if the balls moved too far or changed
+  const std::vector<std::pair<unsigned,unsigned>>& pairs( const VectorXs& q, const VectorXs& r );
+
+private:
+
+  bool rebuildNeeded( const VectorXs& q, const VectorXs& r ) const;
+  void rebuild( const VectorXs& q, const VectorXs& r );
+
+  scalar m_skin;
+
+  // Configuration and radii at the last build
+  VectorXs m_q;
+  VectorXs m_r;
+  std::vector<std::pair<unsigned,unsigned>> m_pairs;
+
+};
+
+#endif
@@ -8,11 +8,20 @@
 #ifdef USE_PYTHON
 #define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
 #include <numpy/arrayobject.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <typeinfo>
 #include "scisim/Math/Rational.h"
 #include "scisim/Constraints/Constraint.h"
 #include "Ball2DState.h"
 #include "scisim/PythonTools.h"
 #include "ball2d/StaticGeometry/StaticPlane.h"
+#include "ball2d/Constraints/BallBallConstraint.h"
+#include "ball2d/Constraints/BallStaticDrumConstraint.h"
+#include "ball2d/Constraints/BallStaticPlaneConstraint.h"
+#include "ball2d/Constraints/KinematicKickBallBallConstraint.h"
 #endif
 
 #include "scisim/StringUtilities.h"
@@ -25,6 +34,11 @@ static Ball2DState* s_ball_state;
 static VectorXs* s_mu;
 static VectorXs* s_cor;
 static const std::vector<std::unique_ptr<Constraint>>* s_active_set;
+static const VectorXs* s_q;
+
+// Version of the state layout viewed by the running callback. Versions are never reused, so a change of
+// scripting instance or an edit of the state from Python always invalidates the views.
+static unsigned s_state_version;
 #endif
 
 PythonScripting::PythonScripting()
@@ -38,6 +52,8 @@ PythonScripting::PythonScripting()
 , m_loaded_end_of_step_callback( nullptr )
 , m_loaded_friction_coefficient_callback( nullptr )
 , m_loaded_restitution_coefficient_callback( nullptr )
+, m_state_version( 0 )
+, m_state_layout()
 #endif
 {}
 
@@ -52,6 +68,8 @@ PythonScripting::PythonScripting( const std::string& path, const std::string& mo
 , m_loaded_end_of_step_callback( nullptr )
 , m_loaded_friction_coefficient_callback( nullptr )
 , m_loaded_restitution_coefficient_callback( nullptr )
+, m_state_version( 0 )
+, m_state_layout()
 #endif
 {
   intializePythonCallbacks();
@@ -68,6 +86,8 @@ PythonScripting::PythonScripting( std::istream& input_stream )
 , m_loaded_end_of_step_callback( nullptr )
 , m_loaded_friction_coefficient_callback( nullptr )
 , m_loaded_restitution_coefficient_callback( nullptr )
+, m_state_version( 0 )
+, m_state_layout()
 #endif
 {
   intializePythonCallbacks();
@@ -132,10 +152,38 @@ void swap( PythonScripting& first, PythonScripting& second )
   swap( first.m_loaded_end_of_step_callback, second.m_loaded_end_of_step_callback );
   swap( first.m_loaded_friction_coefficient_callback, second.m_loaded_friction_coefficient_callback );
   swap( first.m_loaded_restitution_coefficient_callback, second.m_loaded_restitution_coefficient_callback );
+  swap( first.m_state_version, second.m_state_version );
+  swap( first.m_state_layout, second.m_state_layout );
   #endif
 }
 
-void PythonScripting::restitutionCoefficient( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor )
+#ifdef USE_PYTHON
+// Arrays handed to Python view the state's storage directly, so they are only valid until that storage is
+// reallocated. The state version changes whenever any viewed buffer moves or is resized. Only called right
+// before a callback runs, so simulations without a loaded module never touch this instance's layout.
+void PythonScripting::updateStateVersion()
+{
+  if( s_ball_state != nullptr )
+  {
+    const std::vector<std::uintptr_t> layout{
+      std::uintptr_t( s_ball_state->q().data() ), std::uintptr_t( s_ball_state->q().size() ),
+      std::uintptr_t( s_ball_state->v().data() ), std::uintptr_t( s_ball_state->v().size() ),
+      std::uintptr_t( s_ball_state->r().data() ), std::uintptr_t( s_ball_state->r().size() ),
+      std::uintptr_t( s_ball_state->M().valuePtr() ), std::uintptr_t( s_ball_state->M().nonZeros() ),
+      std::uintptr_t( s_ball_state->staticPlanes().data() ), std::uintptr_t( s_ball_state->staticPlanes().size() ),
+      std::uintptr_t( s_ball_state->staticDrums().data() ), std::uintptr_t( s_ball_state->staticDrums().size() )
+    };
+    // Another instance's callback or an edit from Python may have published a newer version since this one
+    if( layout != m_state_layout || m_state_version != s_state_version )
+    {
+      m_state_layout = layout;
+      m_state_version = ++s_state_version;
+    }
+  }
+}
+#endif
+
+void PythonScripting::restitutionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor )
 {
   #ifdef USE_PYTHON
   assert( !m_module_name.empty() );
@@ -147,6 +195,8 @@ void PythonScripting::restitutionCoefficient( const std::vector<std::unique_ptr<
   // Get data ready for Python
   s_cor = &cor;
   s_active_set = &active_set;
+  s_q = &q;
+  updateStateVersion();
   // Make the function call
   const PythonObject value{ PyObject_CallObject( m_loaded_restitution_coefficient_callback, nullptr ) };
   if( value == nullptr )
@@ -157,6 +207,7 @@ void PythonScripting::restitutionCoefficient( const std::vector<std::unique_ptr<
   }
   s_cor = nullptr;
   s_active_set = nullptr;
+  s_q = nullptr;
   assert( PyErr_Occurred() == nullptr );
   #else
   std::cerr << "PythonScripting::restitutionCoefficient must be compiled with Python support, exiting." << std::endl;
@@ -164,7 +215,7 @@ void PythonScripting::restitutionCoefficient( const std::vector<std::unique_ptr<
   #endif
 }
 
-void PythonScripting::frictionCoefficient( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu )
+void PythonScripting::frictionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu )
 {
   #ifdef USE_PYTHON
   assert( !m_module_name.empty() );
@@ -176,6 +227,8 @@ void PythonScripting::frictionCoefficient( const std::vector<std::unique_ptr<Con
   // Get data ready for Python
   s_mu = &mu;
   s_active_set = &active_set;
+  s_q = &q;
+  updateStateVersion();
   // Make the function call
   const PythonObject value{ PyObject_CallObject( m_loaded_friction_coefficient_callback, nullptr ) };
   if( value == nullptr )
@@ -186,6 +239,7 @@ void PythonScripting::frictionCoefficient( const std::vector<std::unique_ptr<Con
   }
   s_mu = nullptr;
   s_active_set = nullptr;
+  s_q = nullptr;
   assert( PyErr_Occurred() == nullptr );
   #else
   std::cerr << "PythonScripting::frictionCoefficient must be compiled with Python support, exiting." << std::endl;
@@ -202,6 +256,7 @@ void PythonScripting::startOfSim()
   {
     return;
   }
+  updateStateVersion();
   // Make the function call
   const PythonObject value{ PyObject_CallObject( m_loaded_start_of_sim_callback, nullptr ) };
   if( value == nullptr )
@@ -226,6 +281,7 @@ void PythonScripting::endOfSim()
   {
     return;
   }
+  updateStateVersion();
   // Make the function call
   const PythonObject value{ PyObject_CallObject( m_loaded_end_of_sim_callback, nullptr ) };
   if( value == nullptr )
@@ -253,6 +309,7 @@ void PythonScripting::startOfStep( const unsigned next_iteration, const Rational
   // Get data ready for Python
   s_timestep = scalar( dt );
   s_next_iteration = next_iteration;
+  updateStateVersion();
   // Make the function call
   const PythonObject value{ PyObject_CallObject( m_loaded_start_of_step_callback, nullptr ) };
   if( value == nullptr )
@@ -282,6 +339,7 @@ void PythonScripting::endOfStep( const unsigned next_iteration, const Rational<s
   // Get data ready for Python
   s_timestep = scalar( dt );
   s_next_iteration = next_iteration;
+  updateStateVersion();
   // Make the function call
   const PythonObject value{ PyObject_CallObject( m_loaded_end_of_step_callback, nullptr ) };
   if( value == nullptr )
@@ -307,7 +365,11 @@ std::string PythonScripting::name() const
 void PythonScripting::setState( Ball2DState& state )
 {
   #ifdef USE_PYTHON
-  s_ball_state = &state;
+  // Simulations without a module may run concurrently, so they must not touch the shared pointers
+  if( m_loaded_module != nullptr )
+  {
+    s_ball_state = &state;
+  }
   #endif
   // No need to handle state cache if scripting is disabled
 }
@@ -315,7 +377,10 @@ void PythonScripting::setState( Ball2DState& state )
 void PythonScripting::forgetState()
 {
   #ifdef USE_PYTHON
-  s_ball_state = nullptr;
+  if( m_loaded_module != nullptr )
+  {
+    s_ball_state = nullptr;
+  }
   #endif
   // No need to handle state cache if scripting is disabled
 }
@@ -362,6 +427,72 @@ static PyObject* velocity( PyObject* self, PyObject* args )
   return PyArray_SimpleNewFromData( 1, dims, (is_same<scalar,double>::value ? NPY_DOUBLE : NPY_FLOAT), s_ball_state->v().data() );
 }
 
+// Wraps storage owned by the simulation in a NumPy array without copying. Rows are row_stride bytes apart,
+// so members of a vector of objects can be viewed in place.
+static PyObject* scalarView( const npy_intp rows, const npy_intp cols, const npy_intp row_stride, const scalar* data, const bool writable )
+{
+  using std::is_same;
+  static_assert( is_same<scalar,double>::value || is_same<scalar,float>::value, "Error, scalar type must be double or float for Python interface." );
+  npy_intp dims[2] = { rows, cols };
+  npy_intp strides[2] = { row_stride, sizeof( scalar ) };
+  return PyArray_New( &PyArray_Type, cols == 1 ? 1 : 2, dims, (is_same<scalar,double>::value ? NPY_DOUBLE : NPY_FLOAT), strides, const_cast<scalar*>( data ), 0, writable ? NPY_ARRAY_ALIGNED | NPY_ARRAY_WRITEABLE : NPY_ARRAY_ALIGNED, nullptr );
+}
+
+static PyObject* stateVersion( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_ball_state != nullptr );
+  return Py_BuildValue( "I", s_state_version );
+}
+
+static PyObject* radii( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_ball_state != nullptr );
+  return scalarView( s_ball_state->r().size(), 1, sizeof( scalar ), s_ball_state->r().data(), true );
+}
+
+// The mass matrix is diagonal, holding each ball's mass twice
+static PyObject* masses( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_ball_state != nullptr );
+  assert( s_ball_state->M().nonZeros() == 2 * s_ball_state->r().size() );
+  return scalarView( s_ball_state->r().size(), 1, 2 * sizeof( scalar ), s_ball_state->M().valuePtr(), false );
+}
+
+static PyObject* staticPlanePositions( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_ball_state != nullptr );
+  const npy_intp nplanes{ static_cast<npy_intp>( s_ball_state->staticPlanes().size() ) };
+  return scalarView( nplanes, 2, sizeof( StaticPlane ), nplanes != 0 ? s_ball_state->staticPlanes().front().x().data() : nullptr, true );
+}
+
+static PyObject* staticPlaneVelocities( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_ball_state != nullptr );
+  const npy_intp nplanes{ static_cast<npy_intp>( s_ball_state->staticPlanes().size() ) };
+  return scalarView( nplanes, 2, sizeof( StaticPlane ), nplanes != 0 ? s_ball_state->staticPlanes().front().v().data() : nullptr, true );
+}
+
+static PyObject* staticDrumPositions( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_ball_state != nullptr );
+  const npy_intp ndrums{ static_cast<npy_intp>( s_ball_state->staticDrums().size() ) };
+  return scalarView( ndrums, 2, sizeof( StaticDrum ), ndrums != 0 ? s_ball_state->staticDrums().front().x().data() : nullptr, false );
+}
+
+static PyObject* staticDrumRadii( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_ball_state != nullptr );
+  const npy_intp ndrums{ static_cast<npy_intp>( s_ball_state->staticDrums().size() ) };
+  return scalarView( ndrums, 1, sizeof( StaticDrum ), ndrums != 0 ? &s_ball_state->staticDrums().front().r() : nullptr, false );
+}
+
 static PyObject* insertBall( PyObject* self, PyObject* args )
 {
   Vector2s q;
@@ -395,6 +526,28 @@ static PyObject* insertBall( PyObject* self, PyObject* args )
   }
   assert( s_ball_state != nullptr );
   s_ball_state->pushBallBack( q, v, r, m, fixed );
+  // The state's buffers may have moved
+  ++s_state_version;
+  return Py_BuildValue( "" );
+}
+
+static PyObject* wakeBall( PyObject* self, PyObject* args )
+{
+  unsigned ball_idx;
+  assert( args != nullptr );
+  if( !PyArg_ParseTuple( args, "I", &ball_idx ) )
+  {
+    PyErr_Print();
+    std::cerr << "Failed to read parameters for wakeBall, parameters are: unsigned ball_idx. Exiting." << std::endl;
+    std::exit( EXIT_FAILURE );
+  }
+  assert( s_ball_state != nullptr );
+  if( ball_idx >= s_ball_state->nballs() )
+  {
+    std::cerr << "Invalid ball_idx parameter of " << ball_idx << " in wakeBall, ball_idx must be less than " << s_ball_state->nballs() << ". Exiting." << std::endl;
+    std::exit( EXIT_FAILURE );
+  }
+  s_ball_state->sleepingIslands().wakeIslands( { ball_idx } );
   return Py_BuildValue( "" );
 }
 
@@ -470,6 +623,7 @@ static PyObject* deleteStaticPlane( PyObject* self, PyObject* args )
     std::exit( EXIT_FAILURE );
   }
   s_ball_state->staticPlanes().erase( s_ball_state->staticPlanes().begin() + plane_idx );
+  ++s_state_version;
   return Py_BuildValue( "" );
 }
 
@@ -547,12 +701,186 @@ static PyObject* collisionIndices( PyObject* self, PyObject* args )
   return object;
 }
 
+// Collision types are reported to Python as fixed integer codes, their index in this table
+struct CollisionType final
+{
+  const std::type_info& type;
+  bool teleported;
+  const char* name;
+  // Whether the constraint implements getWorldSpaceContactPoint and getWorldSpaceContactNormal
+  bool reports_contact;
+};
+
+static const CollisionType s_collision_types[] = {
+  { typeid( BallBallConstraint ), false, "ball_ball", true },
+  { typeid( BallBallConstraint ), true, "teleported_ball_ball", true },
+  { typeid( KinematicKickBallBallConstraint ), false, "kinematic_kick_ball_ball", true },
+  { typeid( KinematicKickBallBallConstraint ), true, "teleported_kinematic_kick_ball_ball", true },
+  { typeid( StaticDrumConstraint ), false, "static_drum_constraint", true },
+  { typeid( StaticPlaneConstraint ), false, "static_plane_constraint", true }
+};
+
+static const int s_num_collision_types{ static_cast<int>( sizeof( s_collision_types ) / sizeof( s_collision_types[0] ) ) };
+
+// Returns -1 for constraints missing from the table
+static int collisionTypeCodeOf( const Constraint& constraint )
+{
+  const std::type_info& type{ typeid( constraint ) };
+  // Ball-ball constraints, kicked or not, share a class with their teleported variants
+  const bool teleported{ ( type == typeid( BallBallConstraint ) || type == typeid( KinematicKickBallBallConstraint ) ) && static_cast<const BallBallConstraint&>( constraint ).teleported() };
+  for( int code = 0; code < s_num_collision_types; ++code )
+  {
+    if( s_collision_types[code].type == type && s_collision_types[code].teleported == teleported )
+    {
+      return code;
+    }
+  }
+  return -1;
+}
+
+static int collisionTypeCodeForName( const char* const name )
+{
+  for( int code = 0; code < s_num_collision_types; ++code )
+  {
+    if( std::strcmp( s_collision_types[code].name, name ) == 0 )
+    {
+      return code;
+    }
+  }
+  return -1;
+}
+
+static bool reportsContact( const Constraint& constraint )
+{
+  const int code{ collisionTypeCodeOf( constraint ) };
+  return code >= 0 && s_collision_types[code].reports_contact;
+}
+
+static PyObject* collisionTypeCode( PyObject* self, PyObject* args )
+{
+  const char* type_name;
+  assert( args != nullptr );
+  if( !PyArg_ParseTuple( args, "s", &type_name ) )
+  {
+    PyErr_Print();
+    std::cerr << "Failed to read parameters for collisionTypeCode, parameters are: type_name. Exiting." << std::endl;
+    std::exit( EXIT_FAILURE );
+  }
+  return Py_BuildValue( "i", collisionTypeCodeForName( type_name ) );
+}
+
+static PyObject* collisionTypeCodes( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_active_set != nullptr );
+  npy_intp dims[1] = { static_cast<npy_intp>( s_active_set->size() ) };
+  PyObject* object = PyArray_SimpleNew( 1, dims, NPY_INT );
+  int* int_data = (int*)( PyArray_DATA( (PyArrayObject*)( object ) ) );
+  for( const std::unique_ptr<Constraint>& constraint : *s_active_set )
+  {
+    *int_data++ = collisionTypeCodeOf( *constraint );
+  }
+  return object;
+}
+
+static PyObject* allCollisionIndices( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_active_set != nullptr );
+  npy_intp dims[2] = { static_cast<npy_intp>( s_active_set->size() ), 2 };
+  PyObject* object = PyArray_SimpleNew( 2, dims, NPY_INT );
+  int* int_data = (int*)( PyArray_DATA( (PyArrayObject*)( object ) ) );
+  for( const std::unique_ptr<Constraint>& constraint : *s_active_set )
+  {
+    std::pair<int,int> body_indices;
+    constraint->getBodyIndices( body_indices );
+    *int_data++ = body_indices.first;
+    *int_data++ = body_indices.second;
+  }
+  return object;
+}
+
+static PyObject* collisionPoints( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_active_set != nullptr );
+  assert( s_q != nullptr );
+  using std::is_same;
+  static_assert( is_same<scalar,double>::value || is_same<scalar,float>::value, "Error, scalar type must be double or float for Python interface." );
+  npy_intp dims[2] = { static_cast<npy_intp>( s_active_set->size() ), 2 };
+  PyObject* object = PyArray_SimpleNew( 2, dims, (is_same<scalar,double>::value ? NPY_DOUBLE : NPY_FLOAT) );
+  scalar* scalar_data = (scalar*)( PyArray_DATA( (PyArrayObject*)( object ) ) );
+  VectorXs contact_point;
+  for( const std::unique_ptr<Constraint>& constraint : *s_active_set )
+  {
+    if( !reportsContact( *constraint ) )
+    {
+      scalar_data = std::fill_n( scalar_data, 2, std::numeric_limits<scalar>::quiet_NaN() );
+      continue;
+    }
+    constraint->getWorldSpaceContactPoint( *s_q, contact_point );
+    assert( contact_point.size() == 2 );
+    scalar_data = std::copy( contact_point.data(), contact_point.data() + 2, scalar_data );
+  }
+  return object;
+}
+
+static PyObject* collisionNormals( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_active_set != nullptr );
+  assert( s_q != nullptr );
+  using std::is_same;
+  static_assert( is_same<scalar,double>::value || is_same<scalar,float>::value, "Error, scalar type must be double or float for Python interface." );
+  npy_intp dims[2] = { static_cast<npy_intp>( s_active_set->size() ), 2 };
+  PyObject* object = PyArray_SimpleNew( 2, dims, (is_same<scalar,double>::value ? NPY_DOUBLE : NPY_FLOAT) );
+  scalar* scalar_data = (scalar*)( PyArray_DATA( (PyArrayObject*)( object ) ) );
+  VectorXs contact_normal;
+  for( const std::unique_ptr<Constraint>& constraint : *s_active_set )
+  {
+    if( !reportsContact( *constraint ) )
+    {
+      scalar_data = std::fill_n( scalar_data, 2, std::numeric_limits<scalar>::quiet_NaN() );
+      continue;
+    }
+    constraint->getWorldSpaceContactNormal( *s_q, contact_normal );
+    assert( contact_normal.size() == 2 );
+    scalar_data = std::copy( contact_normal.data(), contact_normal.data() + 2, scalar_data );
+  }
+  return object;
+}
+
+static PyObject* collisionPenetrationDepths( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_active_set != nullptr );
+  assert( s_q != nullptr );
+  using std::is_same;
+  static_assert( is_same<scalar,double>::value || is_same<scalar,float>::value, "Error, scalar type must be double or float for Python interface." );
+  npy_intp dims[1] = { static_cast<npy_intp>( s_active_set->size() ) };
+  PyObject* object = PyArray_SimpleNew( 1, dims, (is_same<scalar,double>::value ? NPY_DOUBLE : NPY_FLOAT) );
+  scalar* scalar_data = (scalar*)( PyArray_DATA( (PyArrayObject*)( object ) ) );
+  for( const std::unique_ptr<Constraint>& constraint : *s_active_set )
+  {
+    *scalar_data++ = constraint->penetrationDepth( *s_q );
+  }
+  return object;
+}
+
 static PyMethodDef Balls2DFunctions[] = {
   { "timestep", timestep, METH_NOARGS, "Returns the timestep." },
   { "nextIteration", nextIteration, METH_NOARGS, "Returns the end of step iteration." },
   { "configuration", configuration, METH_NOARGS, "Returns the system's configuration." },
   { "velocity", velocity, METH_NOARGS, "Returns the system's velocity." },
+  { "stateVersion", stateVersion, METH_NOARGS, "Returns a counter that changes whenever arrays returned by earlier calls are invalidated." },
+  { "radii", radii, METH_NOARGS, "Returns a view of the radius of each ball." },
+  { "masses", masses, METH_NOARGS, "Returns a read only view of the mass of each ball." },
+  { "staticPlanePositions", staticPlanePositions, METH_NOARGS, "Returns an Nx2 view of the positions of the static planes." },
+  { "staticPlaneVelocities", staticPlaneVelocities, METH_NOARGS, "Returns an Nx2 view of the velocities of the static planes." },
+  { "staticDrumPositions", staticDrumPositions, METH_NOARGS, "Returns a read only Nx2 view of the positions of the static drums." },
+  { "staticDrumRadii", staticDrumRadii, METH_NOARGS, "Returns a read only view of the radii of the static drums." },
   { "insertBall", insertBall, METH_VARARGS, "Adds a new ball to the system." },
+  { "wakeBall", wakeBall, METH_VARARGS, "Wakes a sleeping ball and the rest of its island." },
   { "numStaticPlanes", numStaticPlanes, METH_NOARGS, "Returns the number of static planes." },
   { "setStaticPlanePosition", setStaticPlanePosition, METH_VARARGS, "Sets the position of a static plane." },
   { "setStaticPlaneVelocity", setStaticPlaneVelocity, METH_VARARGS, "Sets the velocity of a static plane." },
@@ -562,6 +890,12 @@ static PyMethodDef Balls2DFunctions[] = {
   { "numCollisions", numCollisions, METH_NOARGS, "Returns the number of collisions." },
   { "collisionType", collisionType, METH_VARARGS, "Returns the type of a collision." },
   { "collisionIndices", collisionIndices, METH_VARARGS, "Returns the indices of bodies involved in a given collision." },
+  { "collisionTypeCode", collisionTypeCode, METH_VARARGS, "Returns the fixed integer code of a collision type name, -1 if the name is unknown." },
+  { "collisionTypeCodes", collisionTypeCodes, METH_NOARGS, "Returns the integer type codes of all collisions, -1 for unknown types." },
+  { "allCollisionIndices", allCollisionIndices, METH_NOARGS, "Returns an Nx2 array of the indices of bodies involved in all collisions." },
+  { "collisionPoints", collisionPoints, METH_NOARGS, "Returns an Nx2 array of the world space contact points of all collisions, nan where not available." },
+  { "collisionNormals", collisionNormals, METH_NOARGS, "Returns an Nx2 array of the world space contact normals of all collisions, nan where not available." },
+  { "collisionPenetrationDepths", collisionPenetrationDepths, METH_NOARGS, "Returns the penetration depths of all collisions, nan where not available." },
   { nullptr, nullptr, 0, nullptr }
 };
 
@@ -8,6 +8,8 @@
 
 #ifdef USE_PYTHON
 #include <Python.h>
+#include <cstdint>
+#include <vector>
 #include "scisim/PythonObject.h"
 #endif
 
@@ -41,9 +43,13 @@ private:
 
   void intializePythonCallbacks();
 
-  virtual void restitutionCoefficient( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor ) override;
+  #ifdef USE_PYTHON
+  void updateStateVersion();
+  #endif
+
+  virtual void restitutionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor ) override;
 
-  virtual void frictionCoefficient( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu ) override;
+  virtual void frictionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu ) override;
 
   virtual void startOfSim() override;
 
@@ -65,6 +71,9 @@ private:
   PythonObject m_loaded_end_of_step_callback;
   PythonObject m_loaded_friction_coefficient_callback;
   PythonObject m_loaded_restitution_coefficient_callback;
+  // Addresses and sizes of the buffers viewed by Python, and the version they were published under
+  unsigned m_state_version;
+  std::vector<std::uintptr_t> m_state_layout;
   #endif
 
 };
@@ -30,6 +30,21 @@ bool AABB::overlaps( const AABB& other ) const
   return true;
 }
 
+bool AABB::inFrontOfPlane( const Vector2s& x, const Vector2s& n ) const
+{
+  // Signed distance of the corner furthest behind the plane
+  const Array2s center{ 0.5 * ( m_min + m_max ) };
+  const Array2s half_extent{ 0.5 * ( m_max - m_min ) };
+  return n.dot( ( center - x.array() ).matrix() ) - ( n.array().abs() * half_extent ).sum() > 0.0;
+}
+
+bool AABB::insideCircle( const Vector2s& x, const scalar& r ) const
+{
+  // The corner furthest from the center decides
+  const Array2s furthest{ ( m_min - x.array() ).abs().max( ( m_max - x.array() ).abs() ) };
+  return furthest.matrix().squaredNorm() < r * r;
+}
+
 
 static void computeCellIndex( const Array2s& coord, const Array2s& min_coord, const scalar& h, Array2u& index )
 {
@@ -21,6 +21,12 @@ public:
 
   bool overlaps( const AABB& other ) const;
 
+  // True if the box lies entirely in the open half-space that n points into from the plane through x
+  bool inFrontOfPlane( const Vector2s& x, const Vector2s& n ) const;
+
+  // True if the box lies strictly inside the circle of radius r about x
+  bool insideCircle( const Vector2s& x, const scalar& r ) const;
+
   inline Array2s& min() { return m_min; }
   inline Array2s& max() { return m_max; }
 
@@ -9,6 +9,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include <fstream>
 #include <string>
 #include <cstdlib>
@@ -27,6 +28,9 @@
 #include "scisim/ConstrainedMaps/ImpactMaps/ImpactOperator.h"
 #include "scisim/ConstrainedMaps/FrictionSolver.h"
 #include "scisim/Utilities.h"
+#include "scisim/AsyncFileWriter.h"
+#include "scisim/Checkpoint.h"
+#include "scisim/TimestepController.h"
 #include "scisim/PythonTools.h"
 
 #include "ball2d/Ball2DUtilities.h"
@@ -37,6 +41,8 @@
 
 #ifdef USE_HDF5
 #include "scisim/HDF5File.h"
+#include "scisim/HDF5Trajectory.h"
+#include "scisim/HDF5ForceStream.h"
 #include "scisim/ConstrainedMaps/ImpactMaps/ImpactSolution.h"
 #endif
 
@@ -44,6 +50,9 @@ static Ball2DSim g_sim;
 static unsigned g_iteration{ 0 };
 static std::unique_ptr<UnconstrainedMap> g_unconstrained_map{ nullptr };
 static Rational<std::intmax_t> g_dt;
+static TimestepController g_timestep_controller;
+// Timestep of each step taken since the last saved frame
+static std::vector<scalar> g_dt_history;
 static scalar g_end_time{ SCALAR_NAN };
 static std::unique_ptr<ImpactOperator> g_impact_operator{ nullptr };
 static scalar g_CoR{ SCALAR_NAN };
@@ -56,6 +65,16 @@ static PythonScripting g_scripting;
 #ifdef USE_HDF5
 static std::string g_output_dir_name;
 static bool g_output_forces{ false };
+// Appends every frame to a single trajectory file instead of writing one file per frame
+static bool g_output_trajectory{ false };
+static bool g_output_single_precision{ false };
+static unsigned g_output_compression_level{ 0 };
+static HDF5Trajectory g_trajectory;
+// Appends the impulses of every saved step to a single forces.h5 instead of writing one file per step
+static bool g_stream_forces{ false };
+// Streamed impulses with a smaller magnitude are dropped
+static scalar g_force_threshold{ 0.0 };
+static HDF5ForceStream g_force_stream;
 #endif
 // Number of timesteps between saves
 static unsigned g_steps_per_save{ 0 };
@@ -67,8 +86,31 @@ static unsigned g_save_number_width{ 0 };
 static bool g_serialize_snapshots{ false };
 static bool g_overwrite_snapshots{ true };
 
-// Magic number to print in front of binary output to aid in debugging
+// Number of output files buffered for the background writer thread; if 0 files are written on the simulation thread
+static unsigned g_background_output_buffers{ 0 };
+static std::unique_ptr<AsyncFileWriter> g_async_writer{ nullptr };
+// Storage exchanged with the background writer for each file
+static std::vector<char> g_output_buffer;
+
+// Number of delta snapshots written between full anchor snapshots; if 0 every snapshot is complete
+static unsigned g_delta_snapshots{ 0 };
+// The last anchor, kept in memory to find the sections that changed since it was written
+static std::unique_ptr<CheckpointWriter> g_anchor_checkpoint{ nullptr };
+static std::string g_anchor_file_name;
+static unsigned g_snapshots_since_anchor{ 0 };
+
+// Adaptive timestep parameters: the timestep ranges over [dt / 2^refinements, dt * 2^coarsenings] and
+// coarsens after a run of steps with penetration below a fraction of the maximum
+static constexpr unsigned ADAPTIVE_MAX_REFINEMENTS{ 6 };
+static constexpr unsigned ADAPTIVE_MAX_COARSENINGS{ 4 };
+static constexpr scalar ADAPTIVE_CALM_FRACTION{ 0.25 };
+static constexpr unsigned ADAPTIVE_CALM_STEPS{ 10 };
+
+// Magic number at the front of serialized files written before checkpoints were introduced, which are rejected
 static const unsigned MAGIC_BINARY_NUMBER{ 8675309 };
+// Identifies checkpoints written by this program; the schema version is bumped whenever the contents of a section change
+static const std::string CHECKPOINT_KIND{ "ball2d" };
+static const std::uint32_t CHECKPOINT_SCHEMA_VERSION{ 3 };
 
 static std::string generateOutputConfigurationDataFileName( const std::string& prefix, const std::string& extension )
 {
@@ -158,10 +200,22 @@ static bool loadXMLScene( const std::string& xml_file_name )
 static std::string generateSimulationTimeString()
 {
   std::stringstream time_stream;
-  time_stream << std::fixed << std::setprecision( g_dt_string_precision ) << g_iteration * scalar( g_dt );
+  time_stream << std::fixed << std::setprecision( g_dt_string_precision ) << scalar( g_timestep_controller.time( g_dt ) );
   return time_stream.str();
 }
 
+// Hands the file contents in g_output_buffer to the background writer
+static int writeInBackground( const std::string& file_name )
+{
+  assert( g_async_writer != nullptr );
+  if( !g_async_writer->write( file_name, g_output_buffer ) )
+  {
+    std::cerr << g_async_writer->error() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
 #ifdef USE_HDF5
 static int saveState()
 {
@@ -175,59 +229,158 @@ static int saveState()
   // Save the simulation state
   try
   {
-    HDF5File output_file{ output_file_name, HDF5AccessType::READ_WRITE };
+    // With a background writer the file is assembled in memory
+    HDF5File output_file{ output_file_name, g_async_writer != nullptr ? HDF5AccessType::IN_MEMORY : HDF5AccessType::READ_WRITE };
     // Save the iteration and time step and time
-    output_file.write( "timestep", scalar( g_dt ) );
+    output_file.write( "timestep", scalar( g_timestep_controller.timestep( g_dt ) ) );
     output_file.write( "iteration", g_iteration );
-    output_file.write( "time", scalar( g_dt ) * g_iteration );
+    output_file.write( "time", scalar( g_timestep_controller.time( g_dt ) ) );
+    output_file.write( "timestep_history", Eigen::Map<const VectorXs>{ g_dt_history.data(), long( g_dt_history.size() ) } );
     // Save out the git hash
     output_file.write( "git_hash", CompileDefinitions::GitSHA1 );
     // Save the real time
     //output_file.writeString( "/run_stats", "real_time", TimeUtils::currentTime() );
     // Write out the simulation data
     g_sim.writeBinaryState( output_file );
+    if( g_async_writer != nullptr )
+    {
+      output_file.fileImage( g_output_buffer );
+    }
   }
   catch( const std::string& error )
   {
     std::cerr << error << std::endl;
     return EXIT_FAILURE;
   }
+  if( g_async_writer != nullptr )
+  {
+    return writeInBackground( output_file_name );
+  }
   return EXIT_SUCCESS;
 }
 #endif
 
-static int serializeSystem()
+#ifdef USE_HDF5
+static int saveTrajectoryFrame()
 {
-  // Generate a base filename
-  const std::string serialized_file_name{ g_overwrite_snapshots ? "serial.bin" : generateOutputConfigurationDataFileName( "serial", "bin" ) };
+  const std::string trajectory_file_name{ g_output_dir_name + "/trajectory.h5" };
 
-  // Print a message to the user that the state is being written
-  std::cout << "Serializing: " << generateSimulationTimeString() << " to " << serialized_file_name;
+  // Print a status message with the simulation time and output number
+  std::cout << "Saving state at time " << generateSimulationTimeString() << " to frame " << g_output_frame << " of " << trajectory_file_name;
   std::cout << "        " << TimeUtils::currentTime() << std::endl;
 
-  // Attempt to open the output file
-  std::ofstream serial_stream{ serialized_file_name, std::ios::binary };
-  if( !serial_stream.is_open() )
+  try
   {
-    std::cerr << "Failed to open serialization file: " << serialized_file_name << std::endl;
-    std::cerr << "Exiting." << std::endl;
+    // Open the trajectory on the first save, discarding any frames past a resumed snapshot
+    if( !g_trajectory.is_open() )
+    {
+      if( g_output_frame == 0 )
+      {
+        g_trajectory.create( trajectory_file_name, g_output_single_precision, g_output_compression_level );
+        g_trajectory.file().write( "git_hash", CompileDefinitions::GitSHA1 );
+      }
+      else
+      {
+        g_trajectory.reopen( trajectory_file_name, g_output_frame );
+      }
+    }
+    assert( g_trajectory.numFrames() == g_output_frame );
+    // Static data is only written when the number of degrees of freedom, static geometry entries, or bodies changes;
+    // scripts can move static geometry and fix bodies every step, so those are stored with each frame
+    const VectorXs static_geometry{ g_sim.staticGeometryState() };
+    const VectorXu kinematically_scripted{ g_sim.kinematicallyScriptedFlags() };
+    const unsigned ndof{ unsigned( g_sim.state().q().size() ) };
+    const unsigned nstatic{ unsigned( static_geometry.size() ) };
+    const unsigned nbodies{ unsigned( kinematically_scripted.size() ) };
+    if( g_trajectory.needsNewSegment( ndof, nstatic, nbodies ) )
+    {
+      g_sim.writeStaticBinaryState( g_trajectory.file(), g_trajectory.beginSegment( ndof, nstatic, nbodies ) );
+    }
+    g_trajectory.appendFrame( g_iteration, scalar( g_timestep_controller.time( g_dt ) ), scalar( g_timestep_controller.timestep( g_dt ) ), g_dt_history, g_sim.state().q(), g_sim.state().v(), static_geometry, kinematically_scripted );
+  }
+  catch( const std::string& error )
+  {
+    std::cerr << error << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+static int saveForceFrame( const scalar& timestep, const ImpactSolution& impact_solution )
+{
+  const std::string force_stream_file_name{ g_output_dir_name + "/forces.h5" };
+
+  try
+  {
+    // Open the force file on the first save, discarding any frames past a resumed snapshot
+    if( !g_force_stream.is_open() )
+    {
+      if( g_iteration == 0 )
+      {
+        g_force_stream.create( force_stream_file_name, 2, g_output_single_precision, g_output_compression_level, g_force_threshold );
+        g_force_stream.file().write( "git_hash", CompileDefinitions::GitSHA1 );
+      }
+      else
+      {
+        g_force_stream.reopen( force_stream_file_name, g_iteration );
+      }
+    }
+    std::cout << "Saving forces at time " << generateSimulationTimeString() << " to frame " << g_force_stream.numFrames() << " of " << force_stream_file_name << std::endl;
+    g_force_stream.appendFrame( g_iteration, scalar( g_timestep_controller.time( g_dt ) ), timestep, impact_solution );
+  }
+  catch( const std::string& error )
+  {
+    std::cerr << error << std::endl;
     return EXIT_FAILURE;
   }
+  return EXIT_SUCCESS;
+}
 
-  // Write the magic number
-  Utilities::serialize( MAGIC_BINARY_NUMBER, serial_stream );
+// Writes buffered frames of the streamed output files to disk
+static int flushOutputStreams()
+{
+  try
+  {
+    if( g_trajectory.is_open() )
+    {
+      g_trajectory.flush();
+    }
+    if( g_force_stream.is_open() )
+    {
+      g_force_stream.flush();
+    }
+  }
+  catch( const std::string& error )
+  {
+    std::cerr << error << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
 
-  // Write the git revision
+static int closeOutputStreams()
+{
+  try
   {
-    const std::string git_revision( CompileDefinitions::GitSHA1 );
-    StringUtilities::serialize( git_revision, serial_stream );
+    g_trajectory.close();
+    g_force_stream.close();
+  }
+  catch( const std::string& error )
+  {
+    std::cerr << error << std::endl;
+    return EXIT_FAILURE;
   }
+  return EXIT_SUCCESS;
+}
+#endif
 
-  // Write the actual state
-  g_sim.serialize( serial_stream );
+static void serializeSettings( std::ostream& serial_stream )
+{
   Utilities::serialize( g_iteration, serial_stream );
   Ball2DUtilities::serialize( g_unconstrained_map, serial_stream );
   Utilities::serialize( g_dt, serial_stream );
+  g_timestep_controller.serialize( serial_stream );
+  Utilities::serialize( g_dt_history, serial_stream );
   Utilities::serialize( g_end_time, serial_stream );
   ConstrainedMapUtilities::serialize( g_impact_operator, serial_stream );
   Utilities::serialize( g_CoR, serial_stream );
@@ -239,6 +392,11 @@ static int serializeSystem()
   #ifdef USE_HDF5
   StringUtilities::serialize( g_output_dir_name, serial_stream );
   Utilities::serialize( g_output_forces, serial_stream );
+  Utilities::serialize( g_output_trajectory, serial_stream );
+  Utilities::serialize( g_output_single_precision, serial_stream );
+  Utilities::serialize( g_output_compression_level, serial_stream );
+  Utilities::serialize( g_stream_forces, serial_stream );
+  Utilities::serialize( g_force_threshold, serial_stream );
   #endif
   Utilities::serialize( g_steps_per_save, serial_stream );
   Utilities::serialize( g_output_frame, serial_stream );
@@ -246,47 +404,17 @@ static int serializeSystem()
   Utilities::serialize( g_save_number_width, serial_stream );
   Utilities::serialize( g_serialize_snapshots, serial_stream );
   Utilities::serialize( g_overwrite_snapshots, serial_stream );
-
-  return EXIT_SUCCESS;
+  Utilities::serialize( g_background_output_buffers, serial_stream );
 }
 
-static int deserializeSystem( const std::string& file_name )
+static void deserializeSettings( std::istream& serial_stream )
 {
-  std::cout << "Loading serialized simulation state file: " << file_name << std::endl;
-
-  // Attempt to open the input file
-  std::ifstream serial_stream{ file_name, std::ios::binary };
-  if( !serial_stream.is_open() )
-  {
-    std::cerr << "Failed to open serialized state in file: " << file_name << std::endl;
-    std::cerr << "Exiting." << std::endl;
-    return EXIT_FAILURE;
-  }
-
-  // Verify the magic number
-  if( Utilities::deserialize<unsigned>( serial_stream ) != MAGIC_BINARY_NUMBER )
-  {
-    std::cerr << "File " << file_name << " does not appear to be a serialized 2D SCISim simulation. Exiting." << std::endl;
-    return EXIT_FAILURE;
-  }
-
-  // Read the git revision
-  {
-    const std::string git_revision = StringUtilities::deserialize( serial_stream );
-    if( CompileDefinitions::GitSHA1 != git_revision )
-    {
-      std::cerr << "Warning, resuming from data file for a different git revision." << std::endl;
-      std::cerr << "   Serialized Git Revision: " << git_revision << std::endl;
-      std::cerr << "      Current Git Revision: " << CompileDefinitions::GitSHA1 << std::endl;
-    }
-    std::cout << "Git Revision: " << git_revision << std::endl;
-  }
-
-  g_sim.deserialize( serial_stream );
   g_iteration = Utilities::deserialize<unsigned>( serial_stream );
   g_unconstrained_map = Ball2DUtilities::deserializeUnconstrainedMap( serial_stream );
   g_dt = Utilities::deserialize<Rational<std::intmax_t>>( serial_stream );
   assert( g_dt.positive() );
+  g_timestep_controller = TimestepController{ serial_stream };
+  g_dt_history = Utilities::deserializeVector<scalar>( serial_stream );
   g_end_time = Utilities::deserialize<scalar>( serial_stream );
   assert( g_end_time > 0.0 );
   g_impact_operator = ConstrainedMapUtilities::deserializeImpactOperator( serial_stream );
@@ -304,6 +432,13 @@ static int deserializeSystem( const std::string& file_name )
   #ifdef USE_HDF5
   g_output_dir_name = StringUtilities::deserialize( serial_stream );
   g_output_forces = Utilities::deserialize<bool>( serial_stream );
+  g_output_trajectory = Utilities::deserialize<bool>( serial_stream );
+  g_output_single_precision = Utilities::deserialize<bool>( serial_stream );
+  g_output_compression_level = Utilities::deserialize<unsigned>( serial_stream );
+  assert( g_output_compression_level <= 9 );
+  g_stream_forces = Utilities::deserialize<bool>( serial_stream );
+  g_force_threshold = Utilities::deserialize<scalar>( serial_stream );
+  assert( g_force_threshold >= 0.0 );
   #endif
   g_steps_per_save = Utilities::deserialize<unsigned>( serial_stream );
   g_output_frame = Utilities::deserialize<unsigned>( serial_stream );
@@ -311,19 +446,161 @@ static int deserializeSystem( const std::string& file_name )
   g_save_number_width = Utilities::deserialize<unsigned>( serial_stream );
   g_serialize_snapshots = Utilities::deserialize<bool>( serial_stream );
   g_overwrite_snapshots = Utilities::deserialize<bool>( serial_stream );
+  g_background_output_buffers = Utilities::deserialize<unsigned>( serial_stream );
+}
+
+static void checkGitRevision( const std::string& git_revision )
+{
+  if( CompileDefinitions::GitSHA1 != git_revision )
+  {
+    std::cerr << "Warning, resuming from data file for a different git revision." << std::endl;
+    std::cerr << "   Serialized Git Revision: " << git_revision << std::endl;
+    std::cerr << "      Current Git Revision: " << CompileDefinitions::GitSHA1 << std::endl;
+  }
+  std::cout << "Git Revision: " << git_revision << std::endl;
+}
+
+static void writeCheckpoint( CheckpointWriter& checkpoint )
+{
+  checkpoint.addSection( "git_revision", CompileDefinitions::GitSHA1 );
+  g_sim.writeCheckpoint( checkpoint );
+  std::ostringstream serial_stream{ std::ios::binary };
+  serializeSettings( serial_stream );
+  Utilities::serialize( g_delta_snapshots, serial_stream );
+  checkpoint.addSection( "settings", serial_stream.str() );
+}
+
+static int serializeSystem()
+{
+  // Generate a base filename
+  const std::string serialized_file_name{ g_overwrite_snapshots ? "serial.bin" : generateOutputConfigurationDataFileName( "serial", "bin" ) };
+
+  // Print a message to the user that the state is being written
+  std::cout << "Serializing: " << generateSimulationTimeString() << " to " << serialized_file_name;
+  std::cout << "        " << TimeUtils::currentTime() << std::endl;
+
+  #ifdef USE_HDF5
+  // A run resumed from this snapshot reopens the streamed output, which must hold every frame saved so far
+  if( flushOutputStreams() == EXIT_FAILURE )
+  {
+    return EXIT_FAILURE;
+  }
+  #endif
+
+  CheckpointWriter checkpoint{ CHECKPOINT_KIND, CHECKPOINT_SCHEMA_VERSION };
+  writeCheckpoint( checkpoint );
 
-  serial_stream.close();
+  // Between anchors only the sections that changed since the last anchor are written; a resumed
+  // simulation has no anchor in memory, so its first snapshot is always complete
+  const bool write_anchor{ g_delta_snapshots != 0 && ( g_anchor_checkpoint == nullptr || g_snapshots_since_anchor == g_delta_snapshots ) };
+  if( g_delta_snapshots != 0 && !write_anchor )
+  {
+    checkpoint.makeDelta( *g_anchor_checkpoint, g_anchor_file_name );
+    ++g_snapshots_since_anchor;
+  }
+
+  // The snapshot is captured now and written by the background writer
+  if( g_async_writer != nullptr )
+  {
+    checkpoint.writeImage( g_output_buffer );
+    if( writeInBackground( serialized_file_name ) == EXIT_FAILURE )
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  else if( !checkpoint.writeFile( serialized_file_name ) )
+  {
+    std::cerr << "Failed to write serialization file: " << serialized_file_name << std::endl;
+    std::cerr << "Exiting." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if( write_anchor )
+  {
+    // The checkpoint references the simulation's arrays, which change once the simulation advances
+    checkpoint.copyReferencedContents();
+    g_anchor_checkpoint.reset( new CheckpointWriter{ std::move( checkpoint ) } );
+    g_anchor_file_name = serialized_file_name.substr( serialized_file_name.rfind( '/' ) + 1 );
+    g_snapshots_since_anchor = 0;
+  }
 
   return EXIT_SUCCESS;
 }
 
+static int deserializeCheckpoint( const std::string& file_name )
+{
+  try
+  {
+    const CheckpointReader checkpoint{ file_name };
+    if( checkpoint.kind() != CHECKPOINT_KIND )
+    {
+      std::cerr << "File " << file_name << " does not appear to be a checkpoint of a 2D SCISim simulation. Exiting." << std::endl;
+      return EXIT_FAILURE;
+    }
+    if( checkpoint.schemaVersion() != CHECKPOINT_SCHEMA_VERSION )
+    {
+      std::cerr << "Checkpoint " << file_name << " has schema version " << checkpoint.schemaVersion() << " but version " << CHECKPOINT_SCHEMA_VERSION << " is required. Exiting." << std::endl;
+      return EXIT_FAILURE;
+    }
+    {
+      std::size_t git_revision_size;
+      const char* const git_revision{ checkpoint.sectionData( "git_revision", git_revision_size ) };
+      checkGitRevision( std::string( git_revision, git_revision_size ) );
+    }
+    g_sim.readCheckpoint( checkpoint );
+    CheckpointSectionStream serial_stream{ checkpoint, "settings" };
+    deserializeSettings( serial_stream );
+    g_delta_snapshots = Utilities::deserialize<unsigned>( serial_stream );
+  }
+  catch( const std::string& error )
+  {
+    std::cerr << error << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+static int deserializeSystem( const std::string& file_name )
+{
+  std::cout << "Loading serialized simulation state file: " << file_name << std::endl;
+
+  if( CheckpointReader::isCheckpoint( file_name ) )
+  {
+    return deserializeCheckpoint( file_name );
+  }
+
+  // Files written before checkpoints were introduced hold a single stream of serialized values whose layout
+  // predates state added since, so they can not be read reliably
+  std::ifstream serial_stream{ file_name, std::ios::binary };
+  if( !serial_stream.is_open() )
+  {
+    std::cerr << "Failed to open serialized state in file: " << file_name << std::endl;
+    std::cerr << "Exiting." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if( Utilities::deserialize<unsigned>( serial_stream ) == MAGIC_BINARY_NUMBER && serial_stream.good() )
+  {
+    std::cerr << "File " << file_name << " was serialized before checkpoints were introduced and can no longer be resumed. Rerun the scene to write a checkpoint. Exiting." << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cerr << "File " << file_name << " does not appear to be a serialized 2D SCISim simulation. Exiting." << std::endl;
+  return EXIT_FAILURE;
+}
+
 static int exportConfigurationData()
 {
   assert( g_steps_per_save != 0 );
-  if( g_iteration % g_steps_per_save == 0 )
+  if( g_timestep_controller.atMultipleOfBaseSteps( g_steps_per_save ) )
   {
     #ifdef USE_HDF5
-    if( !g_output_dir_name.empty() )
+    if( g_output_trajectory )
+    {
+      if( saveTrajectoryFrame() == EXIT_FAILURE )
+      {
+        return EXIT_FAILURE;
+      }
+    }
+    else if( !g_output_dir_name.empty() )
     {
       if( saveState() == EXIT_FAILURE )
       {
@@ -331,6 +608,7 @@ static int exportConfigurationData()
       }
     }
     #endif
+    g_dt_history.clear();
     if( g_serialize_snapshots )
     {
       if( serializeSystem() == EXIT_FAILURE )
@@ -355,93 +633,131 @@ static std::string generateOutputConstraintForceDataFileName()
 
 static int stepSystem()
 {
-  const unsigned next_iter = g_iteration + 1;
-
   #ifdef USE_HDF5
-  HDF5File force_file;
   assert( g_steps_per_save != 0 );
-  if( g_output_forces && g_iteration % g_steps_per_save == 0 )
+  // Retaking a step does not move its start time, so whether forces are saved is fixed for all attempts
+  const bool save_forces{ g_output_forces && g_timestep_controller.atMultipleOfBaseSteps( g_steps_per_save ) };
+  ImpactSolution impact_solution;
+  #endif
+
+  // With an adaptive timestep, steps that penetrate too deeply or fail to solve are retaken from a copy of the
+  // start of the step with a finer timestep
+  std::unique_ptr<const Ball2DSim> step_start;
+  if( g_timestep_controller.adaptive() )
+  {
+    step_start.reset( new Ball2DSim{ g_sim } );
+  }
+  Rational<std::intmax_t> dt;
+  scalar penetration_depth{ 0.0 };
+  bool solve_succeeded{ true };
+  while( true )
+  {
+    const unsigned next_iter{ g_timestep_controller.nextIteration() };
+    dt = g_timestep_controller.timestep( g_dt );
+
+    if( g_unconstrained_map == nullptr && g_impact_operator == nullptr && g_impact_map == nullptr && g_friction_solver == nullptr && g_impact_friction_map == nullptr )
+    {
+      // Nothing to do
+    }
+    else if( g_unconstrained_map != nullptr && g_impact_operator == nullptr && g_impact_map == nullptr && g_friction_solver == nullptr && g_impact_friction_map == nullptr )
+    {
+      g_sim.flow( g_scripting, next_iter, dt, *g_unconstrained_map );
+    }
+    else if( g_unconstrained_map != nullptr && g_impact_operator != nullptr && g_impact_map != nullptr && g_friction_solver == nullptr && g_impact_friction_map == nullptr )
+    {
+      assert( g_impact_map != nullptr );
+      #ifdef USE_HDF5
+      if( save_forces )
+      {
+        g_impact_map->exportForcesNextStep( impact_solution );
+      }
+      #endif
+      g_sim.flow( g_scripting, next_iter, dt, *g_unconstrained_map, *g_impact_operator, g_CoR, *g_impact_map );
+    }
+    else if( g_unconstrained_map != nullptr && g_impact_operator == nullptr && g_impact_map == nullptr && g_friction_solver != nullptr && g_impact_friction_map != nullptr )
+    {
+      #ifdef USE_HDF5
+      if( save_forces )
+      {
+        g_impact_friction_map->exportForcesNextStep( impact_solution );
+      }
+      #endif
+      g_sim.flow( g_scripting, next_iter, dt, *g_unconstrained_map, g_CoR, g_mu, *g_friction_solver, *g_impact_friction_map );
+    }
+    else
+    {
+      std::cerr << "Impossible code path hit in stepSystem. This is a bug. Exiting." << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Penetration is only measured when the timestep adapts, as it requires a full collision detection pass
+    penetration_depth = step_start != nullptr ? g_sim.computeMaxPenetrationDepth() : 0.0;
+    solve_succeeded = g_impact_friction_map == nullptr || g_impact_friction_map->lastSolveSucceeded();
+    if( !g_timestep_controller.rejectStep( penetration_depth, solve_succeeded ) )
+    {
+      break;
+    }
+    assert( step_start != nullptr );
+    g_sim = *step_start;
+  }
+
+  #ifdef USE_HDF5
+  if( save_forces && g_stream_forces )
+  {
+    if( saveForceFrame( scalar( dt ), impact_solution ) == EXIT_FAILURE )
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  else if( save_forces )
   {
     assert( !g_output_dir_name.empty() );
     const std::string constraint_force_file_name = generateOutputConstraintForceDataFileName();
     std::cout << "Saving forces at time " << generateSimulationTimeString() << " to " << constraint_force_file_name << std::endl;
     try
     {
-      force_file.open( constraint_force_file_name, HDF5AccessType::READ_WRITE );
+      HDF5File force_file{ constraint_force_file_name, g_async_writer != nullptr ? HDF5AccessType::IN_MEMORY : HDF5AccessType::READ_WRITE };
       // Save the iteration and time step and time
-      force_file.write( "timestep", scalar( g_dt ) );
+      force_file.write( "timestep", scalar( dt ) );
       force_file.write( "iteration", g_iteration );
-      force_file.write( "time", scalar( g_dt ) * g_iteration );
+      force_file.write( "time", scalar( g_timestep_controller.time( g_dt ) ) );
       // Save out the git hash
       force_file.write( "git_hash", CompileDefinitions::GitSHA1 );
       // Save the real time
       //force_file.writeString( "/run_stats", "real_time", TimeUtils::currentTime() );
+      impact_solution.writeSolution( force_file );
+      if( g_async_writer != nullptr )
+      {
+        force_file.fileImage( g_output_buffer );
+      }
     }
     catch( const std::string& error )
     {
       std::cerr << error << std::endl;
       return EXIT_FAILURE;
     }
-  }
-  #endif
-
-  if( g_unconstrained_map == nullptr && g_impact_operator == nullptr && g_impact_map == nullptr && g_friction_solver == nullptr && g_impact_friction_map == nullptr )
-  {
-    // Nothing to do
-  }
-  else if( g_unconstrained_map != nullptr && g_impact_operator == nullptr && g_impact_map == nullptr && g_friction_solver == nullptr && g_impact_friction_map == nullptr )
-  {
-    g_sim.flow( g_scripting, next_iter, g_dt, *g_unconstrained_map );
-  }
-  else if( g_unconstrained_map != nullptr && g_impact_operator != nullptr && g_impact_map != nullptr && g_friction_solver == nullptr && g_impact_friction_map == nullptr )
-  {
-    assert( g_impact_map != nullptr );
-    #ifdef USE_HDF5
-    ImpactSolution impact_solution;
-    if( force_file.is_open() )
-    {
-      g_impact_map->exportForcesNextStep( impact_solution );
-    }
-    #endif
-    g_sim.flow( g_scripting, next_iter, g_dt, *g_unconstrained_map, *g_impact_operator, g_CoR, *g_impact_map );
-    #ifdef USE_HDF5
-    if( force_file.is_open() )
-    {
-      try
-      {
-        impact_solution.writeSolution( force_file );
-      }
-      catch( const std::string& error )
-      {
-        std::cerr << error << std::endl;
-        return EXIT_FAILURE;
-      }
-    }
-    #endif
-  }
-  else if( g_unconstrained_map != nullptr && g_impact_operator == nullptr && g_impact_map == nullptr && g_friction_solver != nullptr && g_impact_friction_map != nullptr )
-  {
-    #ifdef USE_HDF5
-    if( force_file.is_open() )
+    if( g_async_writer != nullptr && writeInBackground( constraint_force_file_name ) == EXIT_FAILURE )
     {
-      g_impact_friction_map->exportForcesNextStep( force_file );
+      return EXIT_FAILURE;
     }
-    #endif
-    g_sim.flow( g_scripting, next_iter, g_dt, *g_unconstrained_map, g_CoR, g_mu, *g_friction_solver, *g_impact_friction_map );
-  }
-  else
-  {
-    std::cerr << "Impossible code path hit in stepSystem. This is a bug. Exiting." << std::endl;
-    return EXIT_FAILURE;
   }
+  #endif
 
   ++g_iteration;
+  g_dt_history.emplace_back( scalar( dt ) );
+
+  g_timestep_controller.stepTaken( penetration_depth, solve_succeeded, g_steps_per_save );
 
   return exportConfigurationData();
 }
 
 static int executeSimLoop()
 {
+  if( g_background_output_buffers != 0 )
+  {
+    g_async_writer.reset( new AsyncFileWriter{ g_background_output_buffers } );
+  }
+
   if( exportConfigurationData() == EXIT_FAILURE )
   {
     return EXIT_FAILURE;
@@ -450,7 +766,7 @@ static int executeSimLoop()
   while( true )
   {
     // N.B. this will ocassionaly not trigger at the *exact* equal time due to floating point errors
-    if( g_iteration * scalar( g_dt ) >= g_end_time )
+    if( scalar( g_timestep_controller.time( g_dt ) ) >= g_end_time )
     {
       #ifdef USE_HDF5
       // Take one final step to ensure we have force data for end time
@@ -466,7 +782,19 @@ static int executeSimLoop()
       g_scripting.setState( g_sim.state() );
       g_scripting.endOfSimCallback();
       g_scripting.forgetState();
-      std::cout << "Simulation complete at time " << g_iteration * scalar( g_dt ) << ". Exiting." << std::endl;
+      std::cout << "Simulation complete at time " << scalar( g_timestep_controller.time( g_dt ) ) << ". Exiting." << std::endl;
+      #ifdef USE_HDF5
+      if( closeOutputStreams() == EXIT_FAILURE )
+      {
+        return EXIT_FAILURE;
+      }
+      #endif
+      // Wait for the background writer to empty its buffers
+      if( g_async_writer != nullptr && !g_async_writer->flush() )
+      {
+        std::cerr << g_async_writer->error() << std::endl;
+        return EXIT_FAILURE;
+      }
       return EXIT_SUCCESS;
     }
 
@@ -487,12 +815,20 @@ static void printUsage( const std::string& executable_name )
   #ifdef USE_HDF5
   std::cout << "   -i/--impulses            : saves impulses in addition to configuration if an output directory is set" << std::endl;
   std::cout << "   -o/--output_dir dir      : saves simulation state to the given directory" << std::endl;
+  std::cout << "   -t/--trajectory          : saves all frames to a single trajectory.h5 in the output directory" << std::endl;
+  std::cout << "   -n/--stream_impulses     : saves impulses of all frames to a single forces.h5 in the output directory" << std::endl;
+  std::cout << "   -x/--impulse_threshold scalar : drops streamed impulses with a smaller magnitude than the given value" << std::endl;
+  std::cout << "   -p/--single_precision    : stores trajectory and streamed impulse data as 32 bit floats" << std::endl;
+  std::cout << "   -z/--compression integer : deflate level in [0,9] for trajectory and streamed impulse data" << std::endl;
   #endif
   std::cout << "   -f/--frequency integer   : rate at which to save simulation data, in Hz; ignored if no output directory specified" << std::endl;
+  std::cout << "   -b/--background_output integer : writes output files on a background thread, buffering up to the given number of files in memory" << std::endl;
+  std::cout << "   -d/--delta_snapshots integer : between full snapshots, saves the given number of snapshots holding only data that changed; requires -s 1" << std::endl;
+  std::cout << "   -a/--adaptive scalar     : adapts the timestep, halving it when the mean penetration depth exceeds the given value or the friction solve fails" << std::endl;
   std::cout << "   -s/--serialize_snapshots bool : save a bit identical, resumable snapshot; if 0 overwrites the snapshot each timestep, if 1 saves a new snapshot for each timestep" << std::endl;
 }
 
-static bool parseCommandLineOptions( int* argc, char*** argv, bool& help_mode_enabled, scalar& end_time_override, unsigned& output_frequency, std::string& serialized_file_name )
+static bool parseCommandLineOptions( int* argc, char*** argv, bool& help_mode_enabled, scalar& end_time_override, unsigned& output_frequency, std::string& serialized_file_name, scalar& max_penetration )
 {
   const struct option long_options[] =
   {
@@ -503,15 +839,23 @@ static bool parseCommandLineOptions( int* argc, char*** argv, bool& help_mode_en
     #ifdef USE_HDF5
     { "impulses", no_argument, nullptr, 'i' },
     { "output_dir", required_argument, nullptr, 'o' },
+    { "trajectory", no_argument, nullptr, 't' },
+    { "single_precision", no_argument, nullptr, 'p' },
+    { "compression", required_argument, nullptr, 'z' },
+    { "stream_impulses", no_argument, nullptr, 'n' },
+    { "impulse_threshold", required_argument, nullptr, 'x' },
     #endif
     { "frequency", required_argument, nullptr, 'f' },
+    { "background_output", required_argument, nullptr, 'b' },
+    { "delta_snapshots", required_argument, nullptr, 'd' },
+    { "adaptive", required_argument, nullptr, 'a' },
     { nullptr, 0, nullptr, 0 }
   };
 
   while( true )
   {
     int option_index = 0;
-    const int c = getopt_long( *argc, *argv, "his:r:e:o:f:", long_options, &option_index );
+    const int c = getopt_long( *argc, *argv, "hitpns:r:e:o:f:a:z:x:b:d:", long_options, &option_index );
     if( c == -1 ) { break; }
     switch( c )
     {
@@ -561,6 +905,39 @@ static bool parseCommandLineOptions( int* argc, char*** argv, bool& help_mode_en
         g_output_dir_name = optarg;
         break;
       }
+      case 't':
+      {
+        g_output_trajectory = true;
+        break;
+      }
+      case 'p':
+      {
+        g_output_single_precision = true;
+        break;
+      }
+      case 'z':
+      {
+        if( !StringUtilities::extractFromString( optarg, g_output_compression_level ) || g_output_compression_level > 9 )
+        {
+          std::cerr << "Failed to read value for argument for -z/--compression. Value must be an integer in [0,9]." << std::endl;
+          return false;
+        }
+        break;
+      }
+      case 'n':
+      {
+        g_stream_forces = true;
+        break;
+      }
+      case 'x':
+      {
+        if( !StringUtilities::extractFromString( optarg, g_force_threshold ) || g_force_threshold < 0.0 )
+        {
+          std::cerr << "Failed to read value for argument for -x/--impulse_threshold. Value must be a non-negative scalar." << std::endl;
+          return false;
+        }
+        break;
+      }
       #endif
       case 'f':
       {
@@ -571,6 +948,33 @@ static bool parseCommandLineOptions( int* argc, char*** argv, bool& help_mode_en
         }
         break;
       }
+      case 'b':
+      {
+        if( !StringUtilities::extractFromString( optarg, g_background_output_buffers ) || g_background_output_buffers == 0 )
+        {
+          std::cerr << "Failed to read value for argument for -b/--background_output. Value must be a positive integer." << std::endl;
+          return false;
+        }
+        break;
+      }
+      case 'd':
+      {
+        if( !StringUtilities::extractFromString( optarg, g_delta_snapshots ) )
+        {
+          std::cerr << "Failed to read value for argument for -d/--delta_snapshots. Value must be an unsigned integer." << std::endl;
+          return false;
+        }
+        break;
+      }
+      case 'a':
+      {
+        if( !StringUtilities::extractFromString( optarg, max_penetration ) || max_penetration <= 0.0 )
+        {
+          std::cerr << "Failed to read value for argument for -a/--adaptive. Value must be a positive scalar." << std::endl;
+          return false;
+        }
+        break;
+      }
       case '?':
       {
         return false;
@@ -600,9 +1004,10 @@ int main( int argc, char** argv )
   scalar end_time_override{ -1.0 };
   unsigned output_frequency{ 0 };
   std::string serialized_file_name;
+  scalar max_penetration{ -1.0 };
 
   // Attempt to load command line options
-  if( !parseCommandLineOptions( &argc, &argv, help_mode_enabled, end_time_override, output_frequency, serialized_file_name ) )
+  if( !parseCommandLineOptions( &argc, &argv, help_mode_enabled, end_time_override, output_frequency, serialized_file_name, max_penetration ) )
   {
     return EXIT_FAILURE;
   }
@@ -615,12 +1020,37 @@ int main( int argc, char** argv )
   }
 
   // Check for impossible combinations of options
+  if( g_delta_snapshots != 0 && ( !g_serialize_snapshots || g_overwrite_snapshots ) )
+  {
+    std::cerr << "Delta snapshots require a new file for each snapshot (-s 1)." << std::endl;
+    return EXIT_FAILURE;
+  }
   #ifdef USE_HDF5
   if( g_output_forces && g_output_dir_name.empty() )
   {
     std::cerr << "Impulse output requires an output directory." << std::endl;
     return EXIT_FAILURE;
   }
+  if( g_output_trajectory && g_output_dir_name.empty() )
+  {
+    std::cerr << "Trajectory output requires an output directory." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if( g_stream_forces && !g_output_forces )
+  {
+    std::cerr << "Streamed impulse output requires impulse output (-i)." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if( !g_stream_forces && g_force_threshold != 0.0 )
+  {
+    std::cerr << "An impulse threshold requires streamed impulse output." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if( !g_output_trajectory && !g_stream_forces && ( g_output_single_precision || g_output_compression_level != 0 ) )
+  {
+    std::cerr << "Single precision and compressed output require trajectory or streamed impulse output." << std::endl;
+    return EXIT_FAILURE;
+  }
   #endif
 
   #ifdef USE_PYTHON
@@ -691,6 +1121,15 @@ int main( int argc, char** argv )
   assert( g_end_time > 0.0 );
   g_save_number_width = MathUtilities::computeNumDigits( 1 + unsigned( ceil( g_end_time / scalar( g_dt ) ) ) / g_steps_per_save );
 
+  // Configure adaptive timestepping, if requested
+  if( max_penetration > 0.0 )
+  {
+    g_timestep_controller = TimestepController{ ADAPTIVE_MAX_REFINEMENTS, ADAPTIVE_MAX_COARSENINGS, max_penetration, ADAPTIVE_CALM_FRACTION * max_penetration, ADAPTIVE_CALM_STEPS };
+    // Each halving of the timestep can add a digit to the printed time
+    g_dt_string_precision += ADAPTIVE_MAX_REFINEMENTS;
+    std::cout << "Adaptive timestep enabled with maximum penetration depth " << max_penetration << std::endl;
+  }
+
   printCompileInfo( std::cout );
   std::cout << "Body count: " << g_sim.state().nballs() << std::endl;
 
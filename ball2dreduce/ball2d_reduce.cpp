@@ -0,0 +1,317 @@
+// ball2d_reduce.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+// Computes per-frame reductions (energies, momenta, collision statistics, ...) over the config_*.h5 files
+// written by ball2d_cli, processing frames in parallel, and writes them as a single table
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <getopt.h>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "scisim/FrameReduction.h"
+#include "scisim/HDF5File.h"
+#include "scisim/StringUtilities.h"
+#include "scisim/Math/Rational.h"
+#include "scisim/UnconstrainedMaps/UnconstrainedMap.h"
+#include "scisim/ConstrainedMaps/ImpactFrictionMap.h"
+#include "scisim/ConstrainedMaps/ImpactMaps/ImpactMap.h"
+#include "scisim/ConstrainedMaps/ImpactMaps/ImpactOperator.h"
+#include "scisim/ConstrainedMaps/FrictionSolver.h"
+#include "ball2d/Ball2DSim.h"
+#include "ball2dutils/Ball2DSceneParser.h"
+
+struct Reduction final
+{
+  std::string name;
+  std::vector<std::string> columns;
+  std::function<void(Ball2DSim&,std::vector<scalar>&)> compute;
+};
+
+static std::vector<Reduction> availableReductions()
+{
+  return
+  {
+    { "kinetic_energy", { "kinetic_energy" }, []( Ball2DSim& sim, std::vector<scalar>& row ) { row.emplace_back( sim.state().computeKineticEnergy() ); } },
+    { "potential_energy", { "potential_energy" }, []( Ball2DSim& sim, std::vector<scalar>& row ) { row.emplace_back( sim.state().computePotentialEnergy() ); } },
+    { "total_energy", { "total_energy" }, []( Ball2DSim& sim, std::vector<scalar>& row ) { row.emplace_back( sim.state().computeTotalEnergy() ); } },
+    { "momentum", { "momentum_x", "momentum_y" }, []( Ball2DSim& sim, std::vector<scalar>& row )
+      {
+        const Vector2s p{ sim.state().computeMomentum() };
+        row.emplace_back( p.x() );
+        row.emplace_back( p.y() );
+      }
+    },
+    { "angular_momentum", { "angular_momentum" }, []( Ball2DSim& sim, std::vector<scalar>& row ) { row.emplace_back( sim.state().computeAngularMomentum() ); } },
+    { "collisions", { "collisions", "penetration_depth" }, []( Ball2DSim& sim, std::vector<scalar>& row )
+      {
+        std::map<std::string,unsigned> collision_counts;
+        std::map<std::string,scalar> collision_depths;
+        sim.computeNumberOfCollisions( collision_counts, collision_depths );
+        // Total number of collisions and the largest mean penetration depth of any type of collision
+        unsigned num_collisions{ 0 };
+        scalar penetration_depth{ 0.0 };
+        for( const auto& count_pair : collision_counts )
+        {
+          num_collisions += count_pair.second;
+          const scalar& total_depth{ collision_depths[count_pair.first] };
+          // Depths are negative when bodies overlap and nan when not supported
+          if( !std::isnan( total_depth ) )
+          {
+            penetration_depth = std::max( penetration_depth, -total_depth / scalar( count_pair.second ) );
+          }
+        }
+        row.emplace_back( scalar( num_collisions ) );
+        row.emplace_back( penetration_depth );
+      }
+    },
+    { "packing_fraction", { "packing_fraction" }, []( Ball2DSim& sim, std::vector<scalar>& row )
+      {
+        // Area covered by balls relative to the area of their bounding box
+        const Ball2DState& state{ sim.state() };
+        if( state.nballs() == 0 )
+        {
+          row.emplace_back( 0.0 );
+          return;
+        }
+        Vector2s min{ Vector2s::Constant( SCALAR_INFINITY ) };
+        Vector2s max{ Vector2s::Constant( -SCALAR_INFINITY ) };
+        scalar ball_area{ 0.0 };
+        for( unsigned ball = 0; ball < state.nballs(); ++ball )
+        {
+          const scalar& r{ state.r()( ball ) };
+          min = min.cwiseMin( state.q().segment<2>( 2 * ball ) - Vector2s::Constant( r ) );
+          max = max.cwiseMax( state.q().segment<2>( 2 * ball ) + Vector2s::Constant( r ) );
+          ball_area += MathDefines::PI<scalar>() * r * r;
+        }
+        row.emplace_back( ball_area / ( max - min ).prod() );
+      }
+    }
+  };
+}
+
+static void readFrame( const std::string& file_name, Ball2DState& state, std::vector<scalar>& row )
+{
+  std::lock_guard<std::mutex> lock{ FrameReduction::hdf5Mutex() };
+  const HDF5File input_file{ file_name, HDF5AccessType::READ_ONLY };
+
+  row.emplace_back( scalar( input_file.read<unsigned>( "iteration" ) ) );
+  row.emplace_back( input_file.read<scalar>( "time" ) );
+
+  // Empty configurations are not written
+  const VectorXs q{ input_file.exists( "q" ) ? input_file.read<VectorXs>( "q" ) : VectorXs{} };
+  const VectorXs v{ input_file.exists( "v" ) ? input_file.read<VectorXs>( "v" ) : VectorXs{} };
+  if( q.size() != state.q().size() || v.size() != state.v().size() )
+  {
+    throw std::string{ "Frame " } + file_name + std::string{ " has a different number of balls than the scene; frames with inserted or deleted balls are not supported" };
+  }
+  state.q() = q;
+  state.v() = v;
+}
+
+static void printUsage( const std::string& executable_name )
+{
+  std::cout << "Usage: " << executable_name << " xml_scene_file_name output_dir [options]" << std::endl;
+  std::cout << "Computes reductions over the frames ball2d_cli saved to output_dir for the given scene." << std::endl;
+  std::cout << "Options are:" << std::endl;
+  std::cout << "   -h/--help                 : prints this help message and exits" << std::endl;
+  std::cout << "   -j/--threads integer      : number of threads to process frames with, defaults to the number of cores" << std::endl;
+  std::cout << "   -r/--reductions list      : comma separated reductions to compute, defaults to all of:" << std::endl;
+  std::cout << "                              ";
+  for( const Reduction& reduction : availableReductions() )
+  {
+    std::cout << ' ' << reduction.name;
+  }
+  std::cout << std::endl;
+  std::cout << "   -o/--output file          : writes the table to the given file instead of standard output" << std::endl;
+}
+
+static bool parseCommandLineOptions( int* argc, char*** argv, bool& help_mode_enabled, unsigned& num_threads, std::vector<std::string>& reduction_names, std::string& table_file_name )
+{
+  const struct option long_options[] =
+  {
+    { "help", no_argument, nullptr, 'h' },
+    { "threads", required_argument, nullptr, 'j' },
+    { "reductions", required_argument, nullptr, 'r' },
+    { "output", required_argument, nullptr, 'o' },
+    { nullptr, 0, nullptr, 0 }
+  };
+
+  while( true )
+  {
+    int option_index = 0;
+    const int c = getopt_long( *argc, *argv, "hj:r:o:", long_options, &option_index );
+    if( c == -1 ) { break; }
+    switch( c )
+    {
+      case 'h':
+      {
+        help_mode_enabled = true;
+        break;
+      }
+      case 'j':
+      {
+        if( !StringUtilities::extractFromString( optarg, num_threads ) || num_threads == 0 )
+        {
+          std::cerr << "Failed to read value for argument for -j/--threads. Value must be a positive integer." << std::endl;
+          return false;
+        }
+        break;
+      }
+      case 'r':
+      {
+        reduction_names = StringUtilities::tokenize( optarg, ',' );
+        break;
+      }
+      case 'o':
+      {
+        table_file_name = optarg;
+        break;
+      }
+      case '?':
+      {
+        return false;
+      }
+      default:
+      {
+        std::cerr << "This is a bug in the command line parser. Please file a report." << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+int main( int argc, char** argv )
+{
+  bool help_mode_enabled{ false };
+  unsigned num_threads{ std::max( 1u, std::thread::hardware_concurrency() ) };
+  std::vector<std::string> reduction_names;
+  std::string table_file_name;
+
+  if( !parseCommandLineOptions( &argc, &argv, help_mode_enabled, num_threads, reduction_names, table_file_name ) )
+  {
+    return EXIT_FAILURE;
+  }
+
+  if( help_mode_enabled )
+  {
+    printUsage( argv[0] );
+    return EXIT_SUCCESS;
+  }
+
+  if( argc != optind + 2 )
+  {
+    std::cerr << "Invalid arguments. Must provide an xml scene file name and an output directory." << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string xml_file_name{ argv[optind] };
+  const std::string output_dir_name{ argv[optind + 1] };
+
+  // Select the requested reductions, in the order requested
+  std::vector<Reduction> reductions;
+  {
+    std::vector<Reduction> available_reductions{ availableReductions() };
+    if( reduction_names.empty() )
+    {
+      reductions = std::move( available_reductions );
+    }
+    for( const std::string& name : reduction_names )
+    {
+      const auto reduction = std::find_if( available_reductions.begin(), available_reductions.end(), [&name]( const Reduction& r ) { return r.name == name; } );
+      if( reduction == available_reductions.end() )
+      {
+        std::cerr << "Unknown reduction: " << name << std::endl;
+        return EXIT_FAILURE;
+      }
+      reductions.emplace_back( *reduction );
+    }
+  }
+
+  // Static geometry, forces, and materials come from the scene
+  Ball2DSim scene_sim;
+  {
+    std::string scripting_callback_name;
+    std::unique_ptr<UnconstrainedMap> unconstrained_map;
+    std::string dt_string;
+    Rational<std::intmax_t> dt;
+    scalar end_time;
+    std::unique_ptr<ImpactOperator> impact_operator;
+    std::unique_ptr<ImpactMap> impact_map;
+    scalar CoR;
+    std::unique_ptr<FrictionSolver> friction_solver;
+    scalar mu;
+    std::unique_ptr<ImpactFrictionMap> impact_friction_map;
+    if( !Ball2DSceneParser::parseXMLSceneFile( xml_file_name, scripting_callback_name, scene_sim.state(), unconstrained_map, dt_string, dt, end_time, impact_operator, impact_map, CoR, friction_solver, mu, impact_friction_map ) )
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::vector<std::string> columns{ "iteration", "time" };
+  for( const Reduction& reduction : reductions )
+  {
+    columns.insert( columns.end(), reduction.columns.begin(), reduction.columns.end() );
+  }
+
+  // Runs saved with -t/--trajectory store every frame in one file, which is not read here
+  if( std::ifstream{ output_dir_name + "/trajectory.h5" }.is_open() )
+  {
+    std::cerr << "Output directory " << output_dir_name << " holds a single-file trajectory.h5, which is not supported. Rerun ball2d_cli without -t/--trajectory to write per-frame config files." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  try
+  {
+    const std::vector<std::string> frame_names{ FrameReduction::listFiles( output_dir_name, "config_", ".h5" ) };
+    std::vector<std::vector<scalar>> rows( frame_names.size() );
+
+    // Each thread reduces frames with its own copy of the simulation
+    num_threads = std::min( num_threads, std::max( 1u, unsigned( frame_names.size() ) ) );
+    std::vector<Ball2DSim> thread_sims( num_threads, scene_sim );
+    FrameReduction::parallelFor( unsigned( frame_names.size() ), num_threads, [&]( const unsigned thread, const unsigned frame )
+      {
+        Ball2DSim& sim{ thread_sims[thread] };
+        std::vector<scalar>& row{ rows[frame] };
+        row.reserve( columns.size() );
+        readFrame( output_dir_name + "/" + frame_names[frame], sim.state(), row );
+        for( const Reduction& reduction : reductions )
+        {
+          reduction.compute( sim, row );
+        }
+      }
+    );
+
+    if( table_file_name.empty() )
+    {
+      FrameReduction::writeTable( columns, frame_names, rows, std::cout );
+    }
+    else
+    {
+      std::ofstream table_stream{ table_file_name };
+      if( !table_stream.is_open() )
+      {
+        std::cerr << "Failed to open table file: " << table_file_name << std::endl;
+        return EXIT_FAILURE;
+      }
+      FrameReduction::writeTable( columns, frame_names, rows, table_stream );
+    }
+  }
+  catch( const std::string& error )
+  {
+    std::cerr << error << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,188 @@
+// neighbor_list_tests.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include <iostream>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ball2d/NeighborList.h"
+
+using PairSet = std::set<std::pair<unsigned,unsigned>>;
+
+static void generateBalls( const unsigned nballs, const unsigned seed, VectorXs& q, VectorXs& r )
+{
+  std::mt19937_64 mt{ seed };
+  std::uniform_real_distribution<scalar> position_gen{ -10.0, 10.0 };
+  std::uniform_real_distribution<scalar> radius_gen{ 0.1, 0.6 };
+  q.resize( 2 * nballs );
+  r.resize( nballs );
+  for( unsigned ball_idx = 0; ball_idx < nballs; ++ball_idx )
+  {
+    q( 2 * ball_idx ) = position_gen( mt );
+    q( 2 * ball_idx + 1 ) = position_gen( mt );
+    r( ball_idx ) = radius_gen( mt );
+  }
+}
+
+// Pairs of balls whose surfaces are within the given distance, first index smaller
+static PairSet bruteForcePairs( const VectorXs& q, const VectorXs& r, const scalar& distance )
+{
+  PairSet pairs;
+  for( unsigned ball0 = 0; ball0 < r.size(); ++ball0 )
+  {
+    for( unsigned ball1 = ball0 + 1; ball1 < r.size(); ++ball1 )
+    {
+      const scalar cutoff{ r( ball0 ) + r( ball1 ) + distance };
+      if( ( q.segment<2>( 2 * ball1 ) - q.segment<2>( 2 * ball0 ) ).squaredNorm() <= cutoff * cutoff )
+      {
+        pairs.emplace( ball0, ball1 );
+      }
+    }
+  }
+  return pairs;
+}
+
+static PairSet listedPairs( NeighborList& neighbor_list, const VectorXs& q, const VectorXs& r )
+{
+  const std::vector<std::pair<unsigned,unsigned>>& pairs{ neighbor_list.pairs( q, r ) };
+  return PairSet{ pairs.begin(), pairs.end() };
+}
+
+// Every pair of touching balls must be listed
+static bool containsContacts( const PairSet& listed, const VectorXs& q, const VectorXs& r )
+{
+  for( const std::pair<unsigned,unsigned>& contact : bruteForcePairs( q, r, 0.0 ) )
+  {
+    if( listed.count( contact ) == 0 )
+    {
+      std::cerr << "Touching balls " << contact.first << " and " << contact.second << " are missing from the neighbor list." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// A fresh list holds exactly the pairs within the skin
+static int testBuild( const scalar& skin )
+{
+  VectorXs q;
+  VectorXs r;
+  generateBalls( 400, 1234, q, r );
+  NeighborList neighbor_list{ skin };
+  const PairSet listed{ listedPairs( neighbor_list, q, r ) };
+  if( listed.size() != neighbor_list.pairs( q, r ).size() )
+  {
+    std::cerr << "Neighbor list contains duplicate pairs." << std::endl;
+    return EXIT_FAILURE;
+  }
+  for( const std::pair<unsigned,unsigned>& pair : listed )
+  {
+    if( pair.first >= pair.second )
+    {
+      std::cerr << "Neighbor list pair " << pair.first << " " << pair.second << " is not ordered." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  if( listed != bruteForcePairs( q, r, skin ) )
+  {
+    std::cerr << "Neighbor list has " << listed.size() << " pairs, brute force found " << bruteForcePairs( q, r, skin ).size() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return containsContacts( listed, q, r ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Small motions reuse the list, which must still hold every contact; motions past half the skin force a rebuild
+static int testRebuild()
+{
+  const scalar skin{ 0.5 };
+  VectorXs q;
+  VectorXs r;
+  generateBalls( 400, 5678, q, r );
+  NeighborList neighbor_list{ skin };
+  const PairSet initial{ listedPairs( neighbor_list, q, r ) };
+
+  // Drift every ball by just under half the skin, so no new contact can form outside the list
+  std::mt19937_64 mt{ 91011 };
+  std::uniform_real_distribution<scalar> angle_gen{ 0.0, 2.0 * MathDefines::PI<scalar>() };
+  VectorXs q_drifted{ q };
+  for( int ball_idx = 0; ball_idx < r.size(); ++ball_idx )
+  {
+    const scalar angle{ angle_gen( mt ) };
+    q_drifted.segment<2>( 2 * ball_idx ) += 0.49 * skin * Vector2s{ cos( angle ), sin( angle ) };
+  }
+  const PairSet drifted{ listedPairs( neighbor_list, q_drifted, r ) };
+  if( drifted != initial )
+  {
+    std::cerr << "Neighbor list was rebuilt for motions within half the skin." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if( !containsContacts( drifted, q_drifted, r ) )
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Move a ball onto another that was not a neighbor, well past the skin
+  unsigned ball0{ 0 };
+  unsigned ball1{ 1 };
+  while( initial.count( std::make_pair( ball0, ball1 ) ) != 0 )
+  {
+    ++ball1;
+  }
+  VectorXs q_moved{ q_drifted };
+  q_moved.segment<2>( 2 * ball0 ) = q_drifted.segment<2>( 2 * ball1 ) + Vector2s{ r( ball0 ) + r( ball1 ) - 0.01, 0.0 };
+  const PairSet moved{ listedPairs( neighbor_list, q_moved, r ) };
+  if( moved.count( std::make_pair( ball0, ball1 ) ) == 0 )
+  {
+    std::cerr << "Neighbor list was not rebuilt after a ball moved past the skin." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if( moved != bruteForcePairs( q_moved, r, skin ) )
+  {
+    std::cerr << "Rebuilt neighbor list does not match brute force." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Changing a radius also rebuilds the list
+  VectorXs r_grown{ r };
+  r_grown( ball0 ) += 2.0 * skin;
+  if( listedPairs( neighbor_list, q_moved, r_grown ) != bruteForcePairs( q_moved, r_grown, skin ) )
+  {
+    std::cerr << "Neighbor list was not rebuilt after a radius changed." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+int main( int argc, char** argv )
+{
+  if( argc != 2 )
+  {
+    std::cerr << "Usage: " << argv[0] << " test_name" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string test_name{ argv[1] };
+
+  if( test_name == "build_no_skin" )
+  {
+    return testBuild( 0.0 );
+  }
+  else if( test_name == "build_skin" )
+  {
+    return testBuild( 0.3 );
+  }
+  else if( test_name == "rebuild" )
+  {
+    return testRebuild();
+  }
+
+  std::cerr << "Invalid test specified: " << test_name << std::endl;
+  return EXIT_FAILURE;
+}
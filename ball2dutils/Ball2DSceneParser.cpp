@@ -7,6 +7,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 
 #include "Ball2D.h"
 
@@ -21,8 +22,10 @@
 #include "ball2d/SymplecticEulerMap.h"
 
 #include "scisim/StringUtilities.h"
+#include "scisim/SleepingIslands.h"
 #include "scisim/Math/Rational.h"
 #include "scisim/UnconstrainedMaps/UnconstrainedMap.h"
+#include "scisim/UnconstrainedMaps/SubsteppedMap.h"
 #include "scisim/ConstrainedMaps/ImpactMaps/ImpactMap.h"
 #include "scisim/ConstrainedMaps/GeometricImpactFrictionMap.h"
 #include "scisim/ConstrainedMaps/StabilizedImpactFrictionMap.h"
@@ -634,6 +637,24 @@ static bool loadIntegrator( const rapidxml::xml_node<>& node, std::unique_ptr<Un
     }
   }
 
+  // Attempt to load an optional number of free flight substeps per step
+  {
+    const rapidxml::xml_attribute<>* substepsnd{ nd->first_attribute( "substeps" ) };
+    if( substepsnd != nullptr )
+    {
+      int substeps;
+      if( !StringUtilities::extractFromString( std::string( substepsnd->value() ), substeps ) || substeps <= 0 )
+      {
+        std::cerr << "Failed to load substeps attribute for integrator. Must provide a positive integer." << std::endl;
+        return false;
+      }
+      if( substeps > 1 )
+      {
+        integrator.reset( new SubsteppedMap{ std::move( integrator ), static_cast<unsigned>( substeps ) } );
+      }
+    }
+  }
+
   return true;
 }
 
@@ -1364,7 +1385,7 @@ static bool loadGravityForce( const rapidxml::xml_node<>& node, std::vector<std:
   return true;
 }
 
-static bool loadPenaltyForce( const rapidxml::xml_node<>& node, std::vector<std::unique_ptr<Ball2DForce>>& forces )
+static bool loadPenaltyForce( const rapidxml::xml_node<>& node, std::vector<std::unique_ptr<Ball2DForce>>& forces, scalar& skin )
 {
   for( rapidxml::xml_node<>* nd = node.first_node( "penalty" ); nd; nd = nd->next_sibling( "penalty" ) )
   {
@@ -1398,12 +1419,80 @@ static bool loadPenaltyForce( const rapidxml::xml_node<>& node, std::vector<std:
       }
     }
 
+    // Optional distance beyond contact at which pairs are kept in the neighbor list; the list shared by all
+    // forces uses the largest requested
+    {
+      const rapidxml::xml_attribute<>* skin_attrib{ nd->first_attribute( "skin" ) };
+      if( skin_attrib != nullptr )
+      {
+        scalar penalty_skin;
+        if( !StringUtilities::extractFromString( skin_attrib->value(), penalty_skin ) || penalty_skin < 0.0 )
+        {
+          std::cerr << "Failed to load skin attribute for penalty. Value must be a non-negative scalar." << std::endl;
+          return false;
+        }
+        skin = std::max( skin, penalty_skin );
+      }
+    }
+
     forces.emplace_back( new PenaltyForce{ stiffness, potential_power } );
   }
   
   return true;
 }
 
+static bool loadSleeping( const rapidxml::xml_node<>& node, SleepingIslands& sleeping_islands )
+{
+  scalar linear_velocity;
+  {
+    const rapidxml::xml_attribute<>* attrib{ node.first_attribute( "linear_velocity" ) };
+    if( !attrib )
+    {
+      std::cerr << "Failed to locate linear_velocity attribute for sleeping." << std::endl;
+      return false;
+    }
+    if( !StringUtilities::extractFromString( attrib->value(), linear_velocity ) || linear_velocity < 0.0 )
+    {
+      std::cerr << "Failed to load linear_velocity attribute for sleeping. Value must be a non-negative scalar." << std::endl;
+      return false;
+    }
+  }
+
+  scalar kinetic_energy;
+  {
+    const rapidxml::xml_attribute<>* attrib{ node.first_attribute( "kinetic_energy" ) };
+    if( !attrib )
+    {
+      std::cerr << "Failed to locate kinetic_energy attribute for sleeping." << std::endl;
+      return false;
+    }
+    if( !StringUtilities::extractFromString( attrib->value(), kinetic_energy ) || kinetic_energy < 0.0 )
+    {
+      std::cerr << "Failed to load kinetic_energy attribute for sleeping. Value must be a non-negative scalar." << std::endl;
+      return false;
+    }
+  }
+
+  scalar time_to_sleep;
+  {
+    const rapidxml::xml_attribute<>* attrib{ node.first_attribute( "time_to_sleep" ) };
+    if( !attrib )
+    {
+      std::cerr << "Failed to locate time_to_sleep attribute for sleeping." << std::endl;
+      return false;
+    }
+    if( !StringUtilities::extractFromString( attrib->value(), time_to_sleep ) || time_to_sleep <= 0.0 )
+    {
+      std::cerr << "Failed to load time_to_sleep attribute for sleeping. Value must be a positive scalar." << std::endl;
+      return false;
+    }
+  }
+
+  sleeping_islands = SleepingIslands{ linear_velocity, kinetic_energy, time_to_sleep };
+
+  return true;
+}
+
 static bool loadSimulationState( const rapidxml::xml_node<>& root_node, const std::string& file_name, std::string& scripting_callback_name, Ball2DState& state, std::unique_ptr<UnconstrainedMap>& integrator, std::string& dt_string, Rational<std::intmax_t>& dt, scalar& end_time, std::unique_ptr<ImpactOperator>& impact_operator, std::unique_ptr<ImpactMap>& impact_map, scalar& CoR, std::unique_ptr<FrictionSolver>& friction_solver, scalar& mu, std::unique_ptr<ImpactFrictionMap>& if_map )
 {
   std::vector<Ball2D> balls;
@@ -1438,12 +1527,24 @@ static bool loadSimulationState( const rapidxml::xml_node<>& root_node, const st
   }
 
   // Attempt to load a hertzian penalty force
-  if( !loadPenaltyForce( root_node, forces ) )
+  scalar neighbor_skin{ 0.0 };
+  if( !loadPenaltyForce( root_node, forces, neighbor_skin ) )
   {
     std::cerr << "Failed to load penalty force: " << file_name << std::endl;
     return false;
   }
 
+  // Attempt to load sleeping settings, if present
+  SleepingIslands sleeping_islands;
+  if( root_node.first_node( "sleeping" ) != nullptr )
+  {
+    if( !loadSleeping( *root_node.first_node( "sleeping" ), sleeping_islands ) )
+    {
+      std::cerr << "Failed to parse sleeping node: " << file_name << std::endl;
+      return false;
+    }
+  }
+
   // Attempt to load the unconstrained integrator
   if( !loadIntegrator( root_node, integrator, dt_string, dt ) )
   {
@@ -1567,6 +1668,9 @@ static bool loadSimulationState( const rapidxml::xml_node<>& root_node, const st
   swap( planes, state.staticPlanes() );
   swap( planar_portals, state.planarPortals() );
   swap( forces, state.forces() );
+  state.neighborList() = NeighborList{ neighbor_skin };
+  sleeping_islands.resize( state.nballs() );
+  swap( sleeping_islands, state.sleepingIslands() );
 
   return true;
 }
@@ -0,0 +1,63 @@
+// checkpoint_compact.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+// Folds delta checkpoints into complete checkpoints, after which their anchors are no longer needed
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "scisim/Checkpoint.h"
+
+static void printUsage( const std::string& executable_name )
+{
+  std::cout << "Usage: " << executable_name << " checkpoint_file [output_file]" << std::endl;
+  std::cout << "   Writes a complete copy of checkpoint_file to output_file, or replaces checkpoint_file if no output file is given" << std::endl;
+}
+
+int main( int argc, char** argv )
+{
+  if( argc != 2 && argc != 3 )
+  {
+    printUsage( argv[0] );
+    return EXIT_FAILURE;
+  }
+  const std::string input_file_name{ argv[1] };
+  const std::string output_file_name{ argc == 3 ? argv[2] : argv[1] };
+
+  // Write to a temporary file so the input is intact if anything fails
+  const std::string temporary_file_name{ output_file_name + ".compacting" };
+  try
+  {
+    const CheckpointReader checkpoint{ input_file_name };
+    if( !checkpoint.isDelta() && output_file_name == input_file_name )
+    {
+      std::cout << input_file_name << " is already a complete checkpoint." << std::endl;
+      return EXIT_SUCCESS;
+    }
+    const CheckpointWriter compacted{ checkpoint };
+    if( !compacted.writeFile( temporary_file_name ) )
+    {
+      std::cerr << "Failed to write checkpoint file: " << temporary_file_name << std::endl;
+      std::remove( temporary_file_name.c_str() );
+      return EXIT_FAILURE;
+    }
+  }
+  catch( const std::string& error )
+  {
+    std::cerr << error << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if( std::rename( temporary_file_name.c_str(), output_file_name.c_str() ) != 0 )
+  {
+    std::cerr << "Failed to move " << temporary_file_name << " to " << output_file_name << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Wrote complete checkpoint " << output_file_name << std::endl;
+
+  return EXIT_SUCCESS;
+}
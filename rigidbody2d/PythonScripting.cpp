@@ -135,7 +135,7 @@ void swap( PythonScripting& first, PythonScripting& second )
   #endif
 }
 
-void PythonScripting::restitutionCoefficient( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor )
+void PythonScripting::restitutionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor )
 {
   #ifdef USE_PYTHON
   assert( !m_module_name.empty() );
@@ -167,7 +167,7 @@ void PythonScripting::restitutionCoefficient( const std::vector<std::unique_ptr<
   #endif
 }
 
-void PythonScripting::frictionCoefficient( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu )
+void PythonScripting::frictionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu )
 {
   #ifdef USE_PYTHON
   assert( !m_module_name.empty() );
@@ -574,6 +574,26 @@ static PyObject* deleteBodies( PyObject* self, PyObject* args )
   return Py_BuildValue( "" );
 }
 
+static PyObject* wakeBody( PyObject* self, PyObject* args )
+{
+  unsigned body_idx;
+  assert( args != nullptr );
+  if( !PyArg_ParseTuple( args, "I", &body_idx ) )
+  {
+    PyErr_Print();
+    std::cerr << "Failed to read parameters for wakeBody, parameters are: unsigned body_idx. Exiting." << std::endl;
+    std::exit( EXIT_FAILURE );
+  }
+  assert( s_state != nullptr );
+  if( body_idx >= s_state->nbodies() )
+  {
+    std::cerr << "Invalid body_idx parameter of " << body_idx << " in wakeBody, body_idx must be less than " << s_state->nbodies() << ". Exiting." << std::endl;
+    std::exit( EXIT_FAILURE );
+  }
+  s_state->sleepingIslands().wakeIslands( { body_idx } );
+  return Py_BuildValue( "" );
+}
+
 static PyObject* deleteGeometry( PyObject* self, PyObject* args )
 {
   PyArrayObject* geo_list;
@@ -637,6 +657,7 @@ static PyMethodDef RigidBody2DFunctions[] = {
   { "addCircleGeometry", addCircleGeometry, METH_VARARGS, "Adds a new circle geometry instance to the system." },
   { "addBody", addBody, METH_VARARGS, "Adds a new rigid body to the system." },
   { "delete_bodies", deleteBodies, METH_VARARGS, "Deletes the given bodies from the system." },
+  { "wakeBody", wakeBody, METH_VARARGS, "Wakes a sleeping body and the rest of its island." },
   { "delete_geometry", deleteGeometry, METH_VARARGS, "Deletes the given geometry instances from the system." },
   { "num_bodies", numBodies, METH_NOARGS, "Returns the number of bodies in the system." },
   { "num_geometry", numGeometry, METH_NOARGS, "Returns the number of geometry instances in the system." },
@@ -41,9 +41,9 @@ private:
 
   void intializePythonCallbacks();
 
-  virtual void restitutionCoefficient( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor ) override;
+  virtual void restitutionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor ) override;
 
-  virtual void frictionCoefficient( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu ) override;
+  virtual void frictionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu ) override;
 
   virtual void startOfSim() override;
 
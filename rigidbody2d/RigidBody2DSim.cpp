@@ -11,6 +11,7 @@
 #include "scisim/ConstrainedMaps/ImpactMaps/ImpactMap.h"
 #include "scisim/ConstrainedMaps/ImpactFrictionMap.h"
 #include "scisim/Utilities.h"
+#include "scisim/Checkpoint.h"
 
 #include "CircleBoxTools.h"
 #include "BoxBoxTools.h"
@@ -32,6 +33,7 @@
 #endif
 
 #include <iostream>
+#include <sstream>
 
 RigidBody2DState& RigidBody2DSim::state()
 {
@@ -102,7 +104,8 @@ unsigned RigidBody2DSim::ambientSpaceDimensions() const
 
 bool RigidBody2DSim::isKinematicallyScripted( const int i ) const
 {
-  return m_state.fixed( i );
+  // Sleeping bodies are held in place until woken
+  return m_state.fixed( i ) || m_state.asleep( i );
 }
 
 void RigidBody2DSim::computeForce( const VectorXs& q, const VectorXs& v, const scalar& t, VectorXs& F )
@@ -670,10 +673,31 @@ void RigidBody2DSim::computeActiveSet( const VectorXs& q0, const VectorXs& q1, c
   active_set.clear();
 
   // Detect body-body collisions
-  computeBodyBodyActiveSetSpatialGrid( q0, q1, v, active_set );
+  std::vector<unsigned> bodies_to_wake;
+  computeBodyBodyActiveSetSpatialGrid( q0, q1, v, active_set, bodies_to_wake );
+  // Sleeping bodies skip the static plane pass, so moving planes have to wake them here
+  if( m_state.sleepingIslands().enabled() )
+  {
+    sleepersTouchingMovingPlanes( q1, bodies_to_wake );
+  }
+
+  // Awake bodies that touch a sleeping island wake the whole island. The woken bodies can in turn
+  // touch other sleeping islands, so detection restarts until no further islands wake.
+  if( !bodies_to_wake.empty() )
+  {
+    m_state.sleepingIslands().wakeIslands( bodies_to_wake );
+    computeActiveSet( q0, q1, v, active_set );
+    return;
+  }
 
   // Check all body-plane pairs
   computeBodyPlaneActiveSetAllPairs( q0, q1, active_set );
+
+  // Record which bodies touch for building sleeping islands at the end of the step
+  if( m_state.sleepingIslands().enabled() )
+  {
+    m_state.sleepingIslands().addContacts( active_set );
+  }
 }
 
 void RigidBody2DSim::computeImpactBases( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, MatrixXXsc& impact_bases ) const
@@ -729,6 +753,7 @@ void RigidBody2DSim::flow( PythonScripting& call_back, const unsigned iteration,
   call_back.setState( m_state );
   call_back.startOfStepCallback( iteration, dt );
   call_back.forgetState();
+  updateSleepingIslandsStartOfStep();
 
   VectorXs q1{ m_state.q().size() };
   VectorXs v1{ m_state.v().size() };
@@ -741,6 +766,7 @@ void RigidBody2DSim::flow( PythonScripting& call_back, const unsigned iteration,
   v1.swap( m_state.v() );
 
   enforcePeriodicBoundaryConditions( m_state.q(), m_state.v() );
+  updateSleepingIslandsEndOfStep( scalar(dt) );
 
   call_back.setState( m_state );
   call_back.endOfStepCallback( iteration, dt );
@@ -752,6 +778,7 @@ void RigidBody2DSim::flow( PythonScripting& call_back, const unsigned iteration,
   call_back.setState( m_state );
   call_back.startOfStepCallback( iteration, dt );
   call_back.forgetState();
+  updateSleepingIslandsStartOfStep();
 
   VectorXs q1{ m_state.q().size() };
   VectorXs v1{ m_state.v().size() };
@@ -764,6 +791,7 @@ void RigidBody2DSim::flow( PythonScripting& call_back, const unsigned iteration,
   v1.swap( m_state.v() );
 
   enforcePeriodicBoundaryConditions( m_state.q(), m_state.v() );
+  updateSleepingIslandsEndOfStep( scalar(dt) );
 
   call_back.setState( m_state );
   call_back.endOfStepCallback( iteration, dt );
@@ -775,6 +803,7 @@ void RigidBody2DSim::flow( PythonScripting& call_back, const unsigned iteration,
   call_back.setState( m_state );
   call_back.startOfStepCallback( iteration, dt );
   call_back.forgetState();
+  updateSleepingIslandsStartOfStep();
 
   VectorXs q1{ m_state.q().size() };
   VectorXs v1{ m_state.v().size() };
@@ -787,6 +816,7 @@ void RigidBody2DSim::flow( PythonScripting& call_back, const unsigned iteration,
   v1.swap( m_state.v() );
 
   enforcePeriodicBoundaryConditions( m_state.q(), m_state.v() );
+  updateSleepingIslandsEndOfStep( scalar(dt) );
 
   call_back.setState( m_state );
   call_back.endOfStepCallback( iteration, dt );
@@ -837,7 +867,115 @@ void RigidBody2DSim::enforcePeriodicBoundaryConditions( VectorXs& q, VectorXs& v
   }
 }
 
-void RigidBody2DSim::computeBodyBodyActiveSetSpatialGrid( const VectorXs& q0, const VectorXs& q1, const VectorXs& v, std::vector<std::unique_ptr<Constraint>>& active_set ) const
+void RigidBody2DSim::updateSleepingIslandsStartOfStep()
+{
+  SleepingIslands& sleeping_islands{ m_state.sleepingIslands() };
+  if( !sleeping_islands.enabled() )
+  {
+    return;
+  }
+
+  sleeping_islands.clearContacts();
+
+  // Wake any sleeping body that a script set in motion
+  std::vector<unsigned> bodies_to_wake;
+  for( unsigned bdy_idx = 0; bdy_idx < m_state.nbodies(); ++bdy_idx )
+  {
+    if( m_state.asleep( bdy_idx ) && ( m_state.v().segment<3>( 3 * bdy_idx ).array() != 0.0 ).any() )
+    {
+      bodies_to_wake.emplace_back( bdy_idx );
+    }
+  }
+  sleeping_islands.wakeIslands( bodies_to_wake );
+}
+
+void RigidBody2DSim::updateSleepingIslandsEndOfStep( const scalar& dt )
+{
+  SleepingIslands& sleeping_islands{ m_state.sleepingIslands() };
+  if( !sleeping_islands.enabled() )
+  {
+    return;
+  }
+
+  const unsigned nbodies{ m_state.nbodies() };
+  VectorXs speeds{ nbodies };
+  VectorXs kinetic_energies{ nbodies };
+  for( unsigned bdy_idx = 0; bdy_idx < nbodies; ++bdy_idx )
+  {
+    const Vector2s v{ m_state.v().segment<2>( 3 * bdy_idx ) };
+    const scalar& omega{ m_state.v()( 3 * bdy_idx + 2 ) };
+    speeds( bdy_idx ) = v.norm();
+    kinetic_energies( bdy_idx ) = 0.5 * m_state.m( bdy_idx ) * v.squaredNorm() + 0.5 * m_state.I( bdy_idx ) * omega * omega;
+  }
+
+  // Bodies in newly sleeping islands come to a complete stop
+  if( sleeping_islands.update( dt, speeds, kinetic_energies, m_state.fixed() ) != 0 )
+  {
+    for( unsigned bdy_idx = 0; bdy_idx < nbodies; ++bdy_idx )
+    {
+      if( m_state.asleep( bdy_idx ) )
+      {
+        m_state.v().segment<3>( 3 * bdy_idx ).setZero();
+      }
+    }
+  }
+}
+
+bool RigidBody2DSim::scriptedBodyMoves( const unsigned bdy_idx, const VectorXs& q0, const VectorXs& q1 ) const
+{
+  return ( m_state.v().segment<3>( 3 * bdy_idx ).array() != 0.0 ).any() || q0.segment<3>( 3 * bdy_idx ) != q1.segment<3>( 3 * bdy_idx );
+}
+
+bool RigidBody2DSim::sleepingPairSkipped( const unsigned bdy_idx_0, const unsigned bdy_idx_1, const VectorXs& q0, const VectorXs& q1, std::vector<unsigned>& bodies_to_wake ) const
+{
+  const bool asleep0{ m_state.asleep( bdy_idx_0 ) };
+  const bool asleep1{ m_state.asleep( bdy_idx_1 ) };
+  if( !asleep0 && !asleep1 )
+  {
+    return false;
+  }
+  // An awake body wakes the island of the sleeping body it touches, unless it is a fixed body at rest
+  if( asleep0 && !asleep1 && ( !m_state.fixed( bdy_idx_1 ) || scriptedBodyMoves( bdy_idx_1, q0, q1 ) ) )
+  {
+    bodies_to_wake.emplace_back( bdy_idx_0 );
+  }
+  else if( asleep1 && !asleep0 && ( !m_state.fixed( bdy_idx_0 ) || scriptedBodyMoves( bdy_idx_0, q0, q1 ) ) )
+  {
+    bodies_to_wake.emplace_back( bdy_idx_1 );
+  }
+  return true;
+}
+
+void RigidBody2DSim::sleepersTouchingMovingPlanes( const VectorXs& q1, std::vector<unsigned>& bodies_to_wake ) const
+{
+  const unsigned nbodies{ static_cast<unsigned>( q1.size() / 3 ) };
+  for( const RigidBody2DStaticPlane& plane : m_state.planes() )
+  {
+    if( ( plane.v().array() == 0.0 ).all() && plane.omega() == 0.0 )
+    {
+      continue;
+    }
+    for( unsigned bdy_idx = 0; bdy_idx < nbodies; ++bdy_idx )
+    {
+      if( !m_state.asleep( bdy_idx ) )
+      {
+        continue;
+      }
+      Array2s min;
+      Array2s max;
+      m_state.bodyGeometry( bdy_idx )->computeAABB( q1.segment<2>( 3 * bdy_idx ), q1( 3 * bdy_idx + 2 ), min, max );
+      // Signed distance of the box corner deepest along the plane's normal
+      const Array2s center{ 0.5 * ( min + max ) };
+      const Array2s extents{ 0.5 * ( max - min ) };
+      if( plane.n().dot( center.matrix() - plane.x() ) - ( plane.n().array().abs() * extents ).sum() <= 0.0 )
+      {
+        bodies_to_wake.emplace_back( bdy_idx );
+      }
+    }
+  }
+}
+
+void RigidBody2DSim::computeBodyBodyActiveSetSpatialGrid( const VectorXs& q0, const VectorXs& q1, const VectorXs& v, std::vector<std::unique_ptr<Constraint>>& active_set, std::vector<unsigned>& bodies_to_wake ) const
 {
   assert( q0.size() % 3 == 0 ); assert( q0.size() == q1.size() );
 
@@ -906,6 +1044,11 @@ void RigidBody2DSim::computeBodyBodyActiveSetSpatialGrid( const VectorXs& q0, co
     // If neither body in the current collision was teleported
     if( !first_teleported && !second_teleported )
     {
+      // Sleeping bodies are not tested against each other
+      if( sleepingPairSkipped( possible_overlap_pair.first, possible_overlap_pair.second, q0, q1, bodies_to_wake ) )
+      {
+        continue;
+      }
       // We can run standard narrow phase
       dispatchNarrowPhaseCollision( possible_overlap_pair.first, possible_overlap_pair.second, q0, q1, v, active_set );
     }
@@ -942,6 +1085,11 @@ void RigidBody2DSim::computeBodyBodyActiveSetSpatialGrid( const VectorXs& q0, co
         prtl_plane_1 = map_itr->second.planeIndex();
       }
 
+      if( sleepingPairSkipped( bdy_idx_0, bdy_idx_1, q0, q1, bodies_to_wake ) )
+      {
+        continue;
+      }
+
       // Check if the collision will be detected in the unteleported state
       if( first_teleported && second_teleported )
       {
@@ -1034,36 +1182,58 @@ void RigidBody2DSim::writeBinaryState( HDF5File& output_file ) const
   output_file.write( "q", m_state.q() );
   // Output the velocity
   output_file.write( "v", m_state.v() );
+  writeStaticBinaryState( output_file, "" );
+}
+
+void RigidBody2DSim::writeStaticBinaryState( HDF5File& output_file, const std::string& group ) const
+{
   // Output the mass
   {
     // Assemble the mass into a single flat vector like q, v, and r
     assert( unsigned(m_state.M().nonZeros()) == 3 * m_state.nbodies() );
     const VectorXs m{ Eigen::Map<const VectorXs>{ &m_state.M().data().value(0), m_state.q().size() } };
-    output_file.write( "m", m );
-  }
-  {
-    VectorXu fixed{ numBodies() };
-    for( int body_index = 0; body_index < fixed.size(); ++body_index )
-    {
-      fixed( body_index ) = isKinematicallyScripted( body_index ) ? 1 : 0;
-    }
-    output_file.write( "kinematically_scripted", fixed );
+    output_file.write( group + "/m", m );
   }
+  output_file.write( group + "/kinematically_scripted", kinematicallyScriptedFlags() );
   // Output the simulated geometry
-  RigidBody2DStateOutput::writeGeometryIndices( m_state.geometry(), m_state.geometryIndices(), "geometry", output_file );
-  RigidBody2DStateOutput::writeGeometry( m_state.geometry(), "geometry", output_file );
+  RigidBody2DStateOutput::writeGeometryIndices( m_state.geometry(), m_state.geometryIndices(), group + "/geometry", output_file );
+  RigidBody2DStateOutput::writeGeometry( m_state.geometry(), group + "/geometry", output_file );
   // Output the static geometry
   if( !m_state.planes().empty() )
   {
-    RigidBody2DStateOutput::writeStaticPlanes( m_state.planes(), "static_geometry", output_file );
+    RigidBody2DStateOutput::writeStaticPlanes( m_state.planes(), group + "/static_geometry", output_file );
   }
   if( !m_state.planarPortals().empty() )
   {
-    RigidBody2DStateOutput::writePlanarPortals( m_state.planarPortals(), "static_geometry", output_file );
+    RigidBody2DStateOutput::writePlanarPortals( m_state.planarPortals(), group + "/static_geometry", output_file );
   }
 }
 #endif
 
+VectorXs RigidBody2DSim::staticGeometryState() const
+{
+  VectorXs state{ 7 * m_state.planes().size() };
+  for( std::vector<RigidBody2DStaticPlane>::size_type pln_idx = 0; pln_idx < m_state.planes().size(); ++pln_idx )
+  {
+    const RigidBody2DStaticPlane& plane{ m_state.planes()[pln_idx] };
+    state.segment<2>( 7 * pln_idx ) = plane.x();
+    state.segment<2>( 7 * pln_idx + 2 ) = plane.n();
+    state.segment<2>( 7 * pln_idx + 4 ) = plane.v();
+    state( 7 * pln_idx + 6 ) = plane.omega();
+  }
+  return state;
+}
+
+VectorXu RigidBody2DSim::kinematicallyScriptedFlags() const
+{
+  VectorXu fixed{ numBodies() };
+  for( unsigned body_index = 0; body_index < numBodies(); ++body_index )
+  {
+    fixed( body_index ) = isKinematicallyScripted( int( body_index ) ) ? 1 : 0;
+  }
+  return fixed;
+}
+
 void RigidBody2DSim::serialize( std::ostream& output_stream ) const
 {
   assert( output_stream.good() );
@@ -1078,6 +1248,21 @@ void RigidBody2DSim::deserialize( std::istream& input_stream )
   m_constraint_cache.deserialize( input_stream );
 }
 
+void RigidBody2DSim::writeCheckpoint( CheckpointWriter& checkpoint ) const
+{
+  m_state.writeCheckpoint( "state/", checkpoint );
+  std::ostringstream output_stream;
+  m_constraint_cache.serialize( output_stream );
+  checkpoint.addSection( "constraint_cache", output_stream.str() );
+}
+
+void RigidBody2DSim::readCheckpoint( const CheckpointReader& checkpoint )
+{
+  m_state.readCheckpoint( "state/", checkpoint );
+  CheckpointSectionStream input_stream{ checkpoint, "constraint_cache" };
+  m_constraint_cache.deserialize( input_stream );
+}
+
 void RigidBody2DSim::computeContactPoints( std::vector<Vector2s>& points, std::vector<Vector2s>& normals )
 {
   points.clear();
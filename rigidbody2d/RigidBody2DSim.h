@@ -20,6 +20,8 @@ class FrictionSolver;
 class CircleGeometry;
 class BoxGeometry;
 class PythonScripting;
+class CheckpointWriter;
+class CheckpointReader;
 template<typename T> class Rational;
 
 #ifdef USE_HDF5
@@ -87,13 +89,23 @@ public:
   // Flow using an unconstrained map, an impact-friction map
   void flow( PythonScripting& call_back, const unsigned iteration, const Rational<std::intmax_t>& dt, UnconstrainedMap& umap, const scalar& CoR, const scalar& mu, FrictionSolver& solver, ImpactFrictionMap& ifmap );
 
+  // Center, normal, velocity, and angular velocity of each static plane; scripts may change these every step
+  VectorXs staticGeometryState() const;
+  // 1 for each body the simulation holds fixed, either because it is fixed or asleep
+  VectorXu kinematicallyScriptedFlags() const;
+
   #ifdef USE_HDF5
   void writeBinaryState( HDF5File& output_file ) const;
+  // Writes the data that does not change between frames to the given group
+  void writeStaticBinaryState( HDF5File& output_file, const std::string& group ) const;
   #endif
 
   void serialize( std::ostream& output_stream ) const;
   void deserialize( std::istream& input_stream );
 
+  void writeCheckpoint( CheckpointWriter& checkpoint ) const;
+  void readCheckpoint( const CheckpointReader& checkpoint );
+
   void enforcePeriodicBoundaryConditions( VectorXs& q, VectorXs& v );
 
   void computeContactPoints( std::vector<Vector2s>& points, std::vector<Vector2s>& normals );
@@ -104,12 +116,21 @@ private:
 
   void updatePeriodicBoundaryConditionsStartOfStep( const unsigned next_iteration, const scalar& dt );
 
+  void updateSleepingIslandsStartOfStep();
+  void updateSleepingIslandsEndOfStep( const scalar& dt );
+  // True if a fixed body has a nonzero velocity or moves between q0 and q1
+  bool scriptedBodyMoves( const unsigned bdy_idx, const VectorXs& q0, const VectorXs& q1 ) const;
+  // Returns true if either body is asleep, queueing a sleeping body touched by a simulated or moving fixed body for waking
+  bool sleepingPairSkipped( const unsigned bdy_idx_0, const unsigned bdy_idx_1, const VectorXs& q0, const VectorXs& q1, std::vector<unsigned>& bodies_to_wake ) const;
+  // Queues sleeping bodies whose bounding boxes at q1 touch static planes with a nonzero velocity
+  void sleepersTouchingMovingPlanes( const VectorXs& q1, std::vector<unsigned>& bodies_to_wake ) const;
+
   void getTeleportedCollisionCenter( const unsigned portal_index, const bool portal_plane, Vector2s& x ) const;
   void getTeleportedCollisionCenters( const VectorXs& q, const TeleportedCollision& teleported_collision, Vector2s& x0, Vector2s& x1 ) const;
   void dispatchTeleportedNarrowPhaseCollision( const TeleportedCollision& teleported_collision, const std::unique_ptr<RigidBody2DGeometry>& geo0, const std::unique_ptr<RigidBody2DGeometry>& geo1, const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
   bool teleportedCollisionIsActive( const TeleportedCollision& teleported_collision, const std::unique_ptr<RigidBody2DGeometry>& geo0, const std::unique_ptr<RigidBody2DGeometry>& geo1, const VectorXs& q ) const;
 
-  void computeBodyBodyActiveSetSpatialGrid( const VectorXs& q0, const VectorXs& q1, const VectorXs& v, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
+  void computeBodyBodyActiveSetSpatialGrid( const VectorXs& q0, const VectorXs& q1, const VectorXs& v, std::vector<std::unique_ptr<Constraint>>& active_set, std::vector<unsigned>& bodies_to_wake ) const;
   void computeBodyPlaneActiveSetAllPairs( const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
 
   void boxBoxNarrowPhaseCollision( const unsigned idx0, const unsigned idx1, const BoxGeometry& box0, const BoxGeometry& box1, const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
@@ -8,11 +8,14 @@
 #include "scisim/Utilities.h"
 #include "scisim/Math/MathUtilities.h"
 #include "scisim/StringUtilities.h"
+#include "scisim/Checkpoint.h"
 
 #include "BoxGeometry.h"
 #include "CircleGeometry.h"
 #include "NearEarthGravityForce.h"
 
+#include <sstream>
+
 static SparseMatrixsc generateM( const VectorXs& m )
 {
   SparseMatrixsc M{ SparseMatrixsc::Index( m.size() ), SparseMatrixsc::Index( m.size() ) };
@@ -90,7 +93,9 @@ RigidBody2DState::RigidBody2DState( const VectorXs& q, const VectorXs& v, const
 , m_forces( Utilities::clone( forces ) )
 , m_planes( planes )
 , m_planar_portals( planar_portals )
+, m_sleeping_islands()
 {
+  m_sleeping_islands.resize( nbodies() );
   #ifndef NDEBUG
   checkStateConsistency();
   #endif
@@ -107,6 +112,7 @@ RigidBody2DState::RigidBody2DState( const RigidBody2DState& rhs )
 , m_forces( Utilities::clone( rhs.m_forces ) )
 , m_planes( rhs.m_planes )
 , m_planar_portals( rhs.m_planar_portals )
+, m_sleeping_islands( rhs.m_sleeping_islands )
 {
   #ifndef NDEBUG
   checkStateConsistency();
@@ -184,6 +190,27 @@ bool RigidBody2DState::fixed( const int idx ) const
   return m_fixed[idx];
 }
 
+const std::vector<bool>& RigidBody2DState::fixed() const
+{
+  return m_fixed;
+}
+
+SleepingIslands& RigidBody2DState::sleepingIslands()
+{
+  return m_sleeping_islands;
+}
+
+const SleepingIslands& RigidBody2DState::sleepingIslands() const
+{
+  return m_sleeping_islands;
+}
+
+bool RigidBody2DState::asleep( const unsigned bdy_idx ) const
+{
+  assert( bdy_idx < nbodies() );
+  return m_sleeping_islands.enabled() && m_sleeping_islands.asleep( bdy_idx );
+}
+
 void RigidBody2DState::addBody( const Vector2s& x, const scalar& theta, const Vector2s& v, const scalar& omega, const scalar& rho, const unsigned geo_idx, const bool fixed )
 {
   assert( rho > 0.0 );
@@ -208,6 +235,9 @@ void RigidBody2DState::addBody( const Vector2s& x, const scalar& theta, const Ve
   // Update fixed body tags
   m_fixed.push_back( fixed );
 
+  // New bodies start awake
+  m_sleeping_islands.resize( new_num_bodies );
+
   scalar m;
   scalar I;
   m_geometry[geo_idx]->computeMassAndInertia( rho, m, I );
@@ -309,6 +339,7 @@ void RigidBody2DState::removeBodies( const Eigen::Ref<const VectorXu>& indices )
   m_fixed.resize( copy_to );
   m_fixed.shrink_to_fit();
   m_geometry_indices.conservativeResize( copy_to );
+  m_sleeping_islands.removeBodies( indices );
 
   // Note: Conservative resize on sparse matrix seems to cause issues...
   // Update the mass matrix
@@ -495,6 +526,7 @@ void RigidBody2DState::serialize( std::ostream& output_stream ) const
   Utilities::serialize( m_forces, output_stream );
   Utilities::serialize( m_planes, output_stream );
   Utilities::serialize( m_planar_portals, output_stream );
+  m_sleeping_islands.serialize( output_stream );
 }
 
 static void deserializeGeo( std::istream& input_stream, std::vector<std::unique_ptr<RigidBody2DGeometry>>& geo )
@@ -553,4 +585,91 @@ void RigidBody2DState::deserialize( std::istream& input_stream )
   deserializeForces( input_stream, m_forces );
   m_planes = Utilities::deserializeVector<RigidBody2DStaticPlane>( input_stream );
   m_planar_portals = Utilities::deserializeVector<PlanarPortal>( input_stream );
+  m_sleeping_islands = SleepingIslands{ input_stream };
+  assert( m_sleeping_islands.nbodies() == nbodies() );
+}
+
+void RigidBody2DState::writeCheckpoint( const std::string& prefix, CheckpointWriter& checkpoint ) const
+{
+  checkpoint.addArray( prefix + "q", m_q );
+  checkpoint.addArray( prefix + "v", m_v );
+  checkpoint.addSparseMatrix( prefix + "M", m_M );
+  checkpoint.addSparseMatrix( prefix + "Minv", m_Minv );
+  {
+    VectorXu fixed{ VectorXu::Zero( long( m_fixed.size() ) ) };
+    for( std::vector<bool>::size_type bdy_idx = 0; bdy_idx < m_fixed.size(); ++bdy_idx )
+    {
+      fixed( bdy_idx ) = m_fixed[bdy_idx] ? 1 : 0;
+    }
+    checkpoint.addArray( prefix + "fixed", std::move( fixed ) );
+  }
+  checkpoint.addArray( prefix + "geometry_indices", m_geometry_indices );
+  // Objects are stored in separate sections so those that do not change can be shared with an anchor
+  {
+    std::ostringstream output_stream;
+    Utilities::serialize( m_geometry, output_stream );
+    checkpoint.addSection( prefix + "geometry", output_stream.str() );
+  }
+  {
+    std::ostringstream output_stream;
+    Utilities::serialize( m_forces, output_stream );
+    checkpoint.addSection( prefix + "forces", output_stream.str() );
+  }
+  {
+    std::ostringstream output_stream;
+    Utilities::serialize( m_planes, output_stream );
+    checkpoint.addSection( prefix + "planes", output_stream.str() );
+  }
+  {
+    std::ostringstream output_stream;
+    Utilities::serialize( m_planar_portals, output_stream );
+    checkpoint.addSection( prefix + "planar_portals", output_stream.str() );
+  }
+  {
+    std::ostringstream output_stream;
+    m_sleeping_islands.serialize( output_stream );
+    checkpoint.addSection( prefix + "sleeping_islands", output_stream.str() );
+  }
+}
+
+void RigidBody2DState::readCheckpoint( const std::string& prefix, const CheckpointReader& checkpoint )
+{
+  m_q = checkpoint.readArray<VectorXs>( prefix + "q" );
+  m_v = checkpoint.readArray<VectorXs>( prefix + "v" );
+  checkpoint.readSparseMatrix( prefix + "M", m_M );
+  checkpoint.readSparseMatrix( prefix + "Minv", m_Minv );
+  {
+    const VectorXu fixed{ checkpoint.readArray<VectorXu>( prefix + "fixed" ) };
+    m_fixed.resize( std::vector<bool>::size_type( fixed.size() ) );
+    for( std::vector<bool>::size_type bdy_idx = 0; bdy_idx < m_fixed.size(); ++bdy_idx )
+    {
+      m_fixed[bdy_idx] = fixed( bdy_idx ) != 0;
+    }
+  }
+  m_geometry_indices = checkpoint.readArray<VectorXu>( prefix + "geometry_indices" );
+  if( m_q.size() % 3 != 0 || m_v.size() != m_q.size() || m_geometry_indices.size() != m_q.size() / 3 || long( m_fixed.size() ) != m_geometry_indices.size() )
+  {
+    throw std::string{ "Inconsistent rigid body state in checkpoint sections " } + prefix;
+  }
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "geometry" };
+    deserializeGeo( input_stream, m_geometry );
+  }
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "forces" };
+    deserializeForces( input_stream, m_forces );
+  }
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "planes" };
+    m_planes = Utilities::deserializeVector<RigidBody2DStaticPlane>( input_stream );
+  }
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "planar_portals" };
+    m_planar_portals = Utilities::deserializeVector<PlanarPortal>( input_stream );
+  }
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "sleeping_islands" };
+    m_sleeping_islands = SleepingIslands{ input_stream };
+  }
+  assert( m_sleeping_islands.nbodies() == nbodies() );
 }
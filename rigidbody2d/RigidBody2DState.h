@@ -11,6 +11,10 @@
 #include "RigidBody2DForce.h"
 #include "RigidBody2DStaticPlane.h"
 #include "PlanarPortal.h"
+#include "scisim/SleepingIslands.h"
+
+class CheckpointWriter;
+class CheckpointReader;
 
 class RigidBody2DState final
 {
@@ -43,6 +47,12 @@ public:
   const scalar& I( const unsigned bdy_idx ) const;
 
   bool fixed( const int idx ) const;
+  const std::vector<bool>& fixed() const;
+
+  // Sleeping bodies are held in place by the simulation until woken
+  SleepingIslands& sleepingIslands();
+  const SleepingIslands& sleepingIslands() const;
+  bool asleep( const unsigned bdy_idx ) const;
 
   // Adds a new body at the end of the state vector
   void addBody( const Vector2s& x, const scalar& theta, const Vector2s& v, const scalar& omega, const scalar& rho, const unsigned geo_idx, const bool fixed );
@@ -81,6 +91,10 @@ public:
   void serialize( std::ostream& output_stream ) const;
   void deserialize( std::istream& input_stream );
 
+  // Stores q, v, and the other per body arrays under prefix; each remaining member is serialized to its own section
+  void writeCheckpoint( const std::string& prefix, CheckpointWriter& checkpoint ) const;
+  void readCheckpoint( const std::string& prefix, const CheckpointReader& checkpoint );
+
 private:
 
   #ifndef NDEBUG
@@ -99,6 +113,7 @@ private:
   std::vector<std::unique_ptr<RigidBody2DForce>> m_forces;
   std::vector<RigidBody2DStaticPlane> m_planes;
   std::vector<PlanarPortal> m_planar_portals;
+  SleepingIslands m_sleeping_islands;
 
 };
 
@@ -22,6 +22,7 @@
 #include "rigidbody2d/PlanarPortal.h"
 
 #include "scisim/Math/Rational.h"
+#include "scisim/SleepingIslands.h"
 #include "scisim/ConstrainedMaps/ImpactMaps/ImpactMap.h"
 #include "scisim/ConstrainedMaps/GeometricImpactFrictionMap.h"
 #include "scisim/ConstrainedMaps/StabilizedImpactFrictionMap.h"
@@ -211,6 +212,66 @@ static bool loadEndTime( const rapidxml::xml_node<>& node, scalar& end_time )
   return true;
 }
 
+static bool loadSleeping( const rapidxml::xml_node<>& node, SleepingIslands& sleeping_islands )
+{
+  // If sleeping is not specified, leave it disabled
+  const rapidxml::xml_node<>* sleeping_node{ node.first_node( "sleeping" ) };
+  if( sleeping_node == nullptr )
+  {
+    sleeping_islands = SleepingIslands{};
+    return true;
+  }
+
+  scalar linear_velocity;
+  {
+    const rapidxml::xml_attribute<>* attrib{ sleeping_node->first_attribute( "linear_velocity" ) };
+    if( attrib == nullptr )
+    {
+      std::cerr << "Failed to locate linear_velocity attribute for sleeping." << std::endl;
+      return false;
+    }
+    if( !StringUtilities::extractFromString( attrib->value(), linear_velocity ) || linear_velocity < 0.0 )
+    {
+      std::cerr << "Failed to load linear_velocity attribute for sleeping. Value must be a non-negative scalar." << std::endl;
+      return false;
+    }
+  }
+
+  scalar kinetic_energy;
+  {
+    const rapidxml::xml_attribute<>* attrib{ sleeping_node->first_attribute( "kinetic_energy" ) };
+    if( attrib == nullptr )
+    {
+      std::cerr << "Failed to locate kinetic_energy attribute for sleeping." << std::endl;
+      return false;
+    }
+    if( !StringUtilities::extractFromString( attrib->value(), kinetic_energy ) || kinetic_energy < 0.0 )
+    {
+      std::cerr << "Failed to load kinetic_energy attribute for sleeping. Value must be a non-negative scalar." << std::endl;
+      return false;
+    }
+  }
+
+  scalar time_to_sleep;
+  {
+    const rapidxml::xml_attribute<>* attrib{ sleeping_node->first_attribute( "time_to_sleep" ) };
+    if( attrib == nullptr )
+    {
+      std::cerr << "Failed to locate time_to_sleep attribute for sleeping." << std::endl;
+      return false;
+    }
+    if( !StringUtilities::extractFromString( attrib->value(), time_to_sleep ) || time_to_sleep <= 0.0 )
+    {
+      std::cerr << "Failed to load time_to_sleep attribute for sleeping. Value must be a positive scalar." << std::endl;
+      return false;
+    }
+  }
+
+  sleeping_islands = SleepingIslands{ linear_velocity, kinetic_energy, time_to_sleep };
+
+  return true;
+}
+
 static bool loadScriptingSetup( const rapidxml::xml_node<>& node, std::string& scripting_callback )
 {
   assert( scripting_callback.empty() );
@@ -556,6 +617,13 @@ static bool loadIntegrator( const rapidxml::xml_node<>& node, std::unique_ptr<Un
     }
   }
 
+  // Collision detection does not sweep over intermediate substeps of rigid bodies, so substepping is not supported
+  if( nd->first_attribute( "substeps" ) != nullptr )
+  {
+    std::cerr << "Integrator substeps are not supported for rigid bodies, remove the substeps attribute from the integrator node." << std::endl;
+    return false;
+  }
+
   return true;
 }
 
@@ -1536,6 +1604,13 @@ bool RigidBody2DSceneParser::parseXMLSceneFile( const std::string& file_name, st
     return false;
   }
 
+  // Attempt to load the optional sleeping settings, if present
+  SleepingIslands sleeping_islands;
+  if( !loadSleeping( root_node, sleeping_islands ) )
+  {
+    return false;
+  }
+
   // Attempt to load the optional camera settings, if present
   if( !loadCameraSettings( root_node, camera_settings ) )
   {
@@ -1651,6 +1726,9 @@ bool RigidBody2DSceneParser::parseXMLSceneFile( const std::string& file_name, st
   }
 
   sim_state = RigidBody2DState{ q, v, m, fixed, indices, geometry, forces, planes, planar_portals };
+  sleeping_islands.resize( sim_state.nbodies() );
+  using std::swap;
+  swap( sleeping_islands, sim_state.sleepingIslands() );
 
   return true;
 }
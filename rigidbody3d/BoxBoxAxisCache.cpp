@@ -0,0 +1,96 @@
+// BoxBoxAxisCache.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "BoxBoxAxisCache.h"
+
+#include "scisim/Math/MathDefines.h"
+#include "scisim/Utilities.h"
+#include "scisim/Checkpoint.h"
+
+int BoxBoxAxisCache::previousAxis( const unsigned idx0, const unsigned idx1 ) const
+{
+  const auto map_iterator = m_previous_axes.find( std::make_pair( idx0, idx1 ) );
+  return map_iterator != m_previous_axes.cend() ? map_iterator->second : 0;
+}
+
+void BoxBoxAxisCache::recordAxis( const unsigned idx0, const unsigned idx1, const int axis_code )
+{
+  assert( axis_code >= 0 ); assert( axis_code <= 15 );
+  if( axis_code != 0 )
+  {
+    m_current_axes[ std::make_pair( idx0, idx1 ) ] = axis_code;
+  }
+}
+
+void BoxBoxAxisCache::endPass()
+{
+  m_previous_axes.swap( m_current_axes );
+  m_current_axes.clear();
+}
+
+void BoxBoxAxisCache::clear()
+{
+  m_previous_axes.clear();
+  m_current_axes.clear();
+}
+
+void BoxBoxAxisCache::serialize( std::ostream& output_stream ) const
+{
+  assert( output_stream.good() );
+  Utilities::serialize( m_previous_axes.size(), output_stream );
+  for( auto iterator = m_previous_axes.cbegin(); iterator != m_previous_axes.cend(); ++iterator )
+  {
+    Utilities::serialize( iterator->first.first, output_stream );
+    Utilities::serialize( iterator->first.second, output_stream );
+    Utilities::serialize( iterator->second, output_stream );
+  }
+}
+
+void BoxBoxAxisCache::deserialize( std::istream& input_stream )
+{
+  assert( input_stream.good() );
+  clear();
+  const std::map<std::pair<unsigned,unsigned>,int>::size_type naxes{ Utilities::deserialize<std::map<std::pair<unsigned,unsigned>,int>::size_type>( input_stream ) };
+  for( std::map<std::pair<unsigned,unsigned>,int>::size_type axis_num = 0; axis_num < naxes; ++axis_num )
+  {
+    const unsigned first_index{ Utilities::deserialize<unsigned>( input_stream ) };
+    const unsigned second_index{ Utilities::deserialize<unsigned>( input_stream ) };
+    const int axis_code{ Utilities::deserialize<int>( input_stream ) };
+    m_previous_axes.insert( std::make_pair( std::make_pair( first_index, second_index ), axis_code ) );
+  }
+}
+
+void BoxBoxAxisCache::writeCheckpoint( const std::string& prefix, CheckpointWriter& checkpoint ) const
+{
+  Eigen::Matrix<unsigned,3,Eigen::Dynamic> axes{ 3, m_previous_axes.size() };
+  unsigned axis_num{ 0 };
+  for( auto iterator = m_previous_axes.cbegin(); iterator != m_previous_axes.cend(); ++iterator )
+  {
+    axes( 0, axis_num ) = iterator->first.first;
+    axes( 1, axis_num ) = iterator->first.second;
+    axes( 2, axis_num ) = unsigned( iterator->second );
+    ++axis_num;
+  }
+  checkpoint.addArray( prefix + "axes", std::move( axes ) );
+}
+
+void BoxBoxAxisCache::readCheckpoint( const std::string& prefix, const CheckpointReader& checkpoint )
+{
+  clear();
+  // Checkpoints written before the cache existed start with every pair untested
+  if( !checkpoint.hasSection( prefix + "axes" ) )
+  {
+    return;
+  }
+  const Eigen::Matrix<unsigned,3,Eigen::Dynamic> axes{ checkpoint.readArray<Eigen::Matrix<unsigned,3,Eigen::Dynamic>>( prefix + "axes" ) };
+  for( int axis_num = 0; axis_num < axes.cols(); ++axis_num )
+  {
+    if( axes( 2, axis_num ) < 1 || axes( 2, axis_num ) > 15 )
+    {
+      throw std::string{ "Invalid axis code in checkpoint section " } + prefix + std::string{ "axes" };
+    }
+    m_previous_axes.insert( std::make_pair( std::make_pair( axes( 0, axis_num ), axes( 1, axis_num ) ), int( axes( 2, axis_num ) ) ) );
+  }
+}
@@ -0,0 +1,50 @@
+// BoxBoxAxisCache.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Separating axis codes (see BoxBoxUtilities) found for each box pair during the previous collision detection
+// pass. The next pass tests the cached axis first, so separated pairs usually exit after a single axis test
+// and resting pairs keep the same reference face from step to step. Pairs not tested during a pass are dropped.
+
+#ifndef BOX_BOX_AXIS_CACHE_H
+#define BOX_BOX_AXIS_CACHE_H
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+
+class CheckpointWriter;
+class CheckpointReader;
+
+class BoxBoxAxisCache final
+{
+
+public:
+
+  // Axis code found for the pair during the previous pass, or 0 if the pair was not tested
+  int previousAxis( const unsigned idx0, const unsigned idx1 ) const;
+
+  void recordAxis( const unsigned idx0, const unsigned idx1, const int axis_code );
+
+  // Makes the axes recorded since the last call the previous axes
+  void endPass();
+
+  void clear();
+
+  void serialize( std::ostream& output_stream ) const;
+  void deserialize( std::istream& input_stream );
+
+  // Stores the previous axes as a 3 x n array of index pairs and axis codes
+  void writeCheckpoint( const std::string& prefix, CheckpointWriter& checkpoint ) const;
+  void readCheckpoint( const std::string& prefix, const CheckpointReader& checkpoint );
+
+private:
+
+  std::map<std::pair<unsigned,unsigned>,int> m_previous_axes;
+  std::map<std::pair<unsigned,unsigned>,int> m_current_axes;
+
+};
+
+#endif
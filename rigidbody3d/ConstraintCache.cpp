@@ -10,6 +10,7 @@
 #include "scisim/Math/MathUtilities.h"
 #include "scisim/Constraints/Constraint.h"
 #include "scisim/Utilities.h"
+#include "scisim/Checkpoint.h"
 
 #include "Constraints/SphereSphereConstraint.h"
 #include "Constraints/StaticPlaneSphereConstraint.h"
@@ -173,3 +174,71 @@ void ConstraintCache::deserialize( std::istream& input_stream )
   m_static_cylinder_sphere_constraint_cache.clear();
   deserializeCache( m_static_cylinder_sphere_constraint_cache, input_stream );
 }
+
+static void writeCacheCheckpoint( const std::map<std::pair<unsigned,unsigned>,VectorXs>& constraint_cache, const std::string& name, CheckpointWriter& checkpoint )
+{
+  Eigen::Matrix<unsigned,2,Eigen::Dynamic> indices{ 2, constraint_cache.size() };
+  VectorXu sizes{ constraint_cache.size() };
+  unsigned total_size{ 0 };
+  {
+    unsigned con_num{ 0 };
+    for( auto iterator = constraint_cache.cbegin(); iterator != constraint_cache.cend(); ++iterator )
+    {
+      indices( 0, con_num ) = iterator->first.first;
+      indices( 1, con_num ) = iterator->first.second;
+      sizes( con_num ) = unsigned( iterator->second.size() );
+      total_size += sizes( con_num );
+      ++con_num;
+    }
+  }
+  VectorXs impulses{ total_size };
+  {
+    unsigned offset{ 0 };
+    for( auto iterator = constraint_cache.cbegin(); iterator != constraint_cache.cend(); ++iterator )
+    {
+      impulses.segment( offset, iterator->second.size() ) = iterator->second;
+      offset += unsigned( iterator->second.size() );
+    }
+  }
+  checkpoint.addArray( name + "/indices", std::move( indices ) );
+  checkpoint.addArray( name + "/sizes", std::move( sizes ) );
+  checkpoint.addArray( name + "/impulses", std::move( impulses ) );
+}
+
+void ConstraintCache::writeCheckpoint( const std::string& prefix, CheckpointWriter& checkpoint ) const
+{
+  writeCacheCheckpoint( m_sphere_sphere_constraint_cache, prefix + "sphere_sphere", checkpoint );
+  writeCacheCheckpoint( m_box_sphere_constraint_cache, prefix + "box_sphere", checkpoint );
+  writeCacheCheckpoint( m_static_plane_sphere_constraint_cache, prefix + "static_plane_sphere", checkpoint );
+  writeCacheCheckpoint( m_static_cylinder_sphere_constraint_cache, prefix + "static_cylinder_sphere", checkpoint );
+}
+
+static void readCacheCheckpoint( const std::string& name, const CheckpointReader& checkpoint, std::map<std::pair<unsigned,unsigned>,VectorXs>& constraint_cache )
+{
+  const Eigen::Matrix<unsigned,2,Eigen::Dynamic> indices{ checkpoint.readArray<Eigen::Matrix<unsigned,2,Eigen::Dynamic>>( name + "/indices" ) };
+  const VectorXu sizes{ checkpoint.readArray<VectorXu>( name + "/sizes" ) };
+  const VectorXs impulses{ checkpoint.readArray<VectorXs>( name + "/impulses" ) };
+  if( sizes.size() != indices.cols() || sizes.sum() != impulses.size() )
+  {
+    throw std::string{ "Inconsistent constraint cache in checkpoint section " } + name;
+  }
+  constraint_cache.clear();
+  unsigned offset{ 0 };
+  for( unsigned con_num = 0; con_num < sizes.size(); ++con_num )
+  {
+    #ifndef NDEBUG
+    const auto insert_return =
+    #endif
+    constraint_cache.insert( std::make_pair( std::make_pair( indices( 0, con_num ), indices( 1, con_num ) ), VectorXs{ impulses.segment( offset, sizes( con_num ) ) } ) );
+    assert( insert_return.second ); // Should not re-encounter constraints
+    offset += sizes( con_num );
+  }
+}
+
+void ConstraintCache::readCheckpoint( const std::string& prefix, const CheckpointReader& checkpoint )
+{
+  readCacheCheckpoint( prefix + "sphere_sphere", checkpoint, m_sphere_sphere_constraint_cache );
+  readCacheCheckpoint( prefix + "box_sphere", checkpoint, m_box_sphere_constraint_cache );
+  readCacheCheckpoint( prefix + "static_plane_sphere", checkpoint, m_static_plane_sphere_constraint_cache );
+  readCacheCheckpoint( prefix + "static_cylinder_sphere", checkpoint, m_static_cylinder_sphere_constraint_cache );
+}
@@ -9,6 +9,8 @@
 #include "scisim/Math/MathDefines.h"
 
 class Constraint;
+class CheckpointWriter;
+class CheckpointReader;
 
 class ConstraintCache final
 {
@@ -23,6 +25,10 @@ public:
   void serialize( std::ostream& output_stream ) const;
   void deserialize( std::istream& input_stream );
 
+  // Stores each cache as a 2 x n array of index pairs, the length of each impulse, and the concatenated impulses
+  void writeCheckpoint( const std::string& prefix, CheckpointWriter& checkpoint ) const;
+  void readCheckpoint( const std::string& prefix, const CheckpointReader& checkpoint );
+
 private:
 
   std::map<std::pair<unsigned,unsigned>,VectorXs> m_sphere_sphere_constraint_cache;
@@ -112,6 +112,7 @@ static bool axisAlignedSeperatingTest( const scalar& projected_center_dist, cons
   const scalar pen_depth{ fabs(projected_center_dist) - projected_aabb_widths };
   if( pen_depth > 0 )
   {
+    code = crnt_code;
     return true;
   }
   assert( smallest_pen_depth <= 0.0 );
@@ -129,6 +130,7 @@ static bool edgeEdgeSeparatingTest( const scalar& projected_center_dist, const s
   scalar s2{ fabs(projected_center_dist) - projected_aabb_widths };
   if( s2 > 0 )
   {
+    code = crnt_code;
     return true;
   }
   const scalar l{ sqrt( n1 * n1 + n2 * n2 + n3 * n3 ) };
@@ -149,6 +151,38 @@ static bool edgeEdgeSeparatingTest( const scalar& projected_center_dist, const s
   return false;
 }
 
+// A cached axis is kept over the deepest axis while its penetration is within this factor of the smallest
+static constexpr scalar CACHED_AXIS_TOLERANCE{ 1.05 };
+
+// Separation of the boxes along the axis with the given code, with the axis expressed in box 1's frame. Face
+// axes (codes 1..6) are unit length, edge-edge axes (codes 7..15) are cross products of box axes. Returns
+// false for an edge-edge axis between parallel edges, which has no direction.
+static bool axisSeparation( const int code, const Vector3s& pp, const Matrix33sr& R, const Vector3s& side1, const Vector3s& side2, Vector3s& axis, scalar& separation )
+{
+  assert( code >= 1 ); assert( code <= 15 );
+  if( code <= 3 )
+  {
+    axis = Vector3s::Unit( code - 1 );
+  }
+  else if( code <= 6 )
+  {
+    axis = R.col( code - 4 );
+  }
+  else
+  {
+    axis = Vector3s::Unit( ( code - 7 ) / 3 ).cross( R.col( ( code - 7 ) % 3 ) );
+  }
+  const scalar length{ axis.norm() };
+  if( length <= 1.0e-12 )
+  {
+    return false;
+  }
+  const scalar projected_widths{ side1.dot( axis.cwiseAbs() ) + side2.dot( ( R.transpose() * axis ).cwiseAbs() ) };
+  separation = ( fabs( pp.dot( axis ) ) - projected_widths ) / length;
+  axis /= length;
+  return true;
+}
+
 // given two boxes (p1,R1,side1) and (p2,R2,side2), collide them together and
 // generate contact points. this returns 0 if there is no contact otherwise
 // it returns the number of contacts generated.
@@ -164,7 +198,10 @@ static bool edgeEdgeSeparatingTest( const scalar& projected_center_dist, const s
 // `contact' and `skip' are the contact array information provided to the
 // collision functions. this function only fills in the position and depth
 // fields.
-static void boxBox( const Vector3s& p1, const Matrix33sr& R1, const Vector3s& side1, const Vector3s& p2, const Matrix33sr& R2, const Vector3s& side2, Vector3s& normal, scalar& depth, int& code, std::vector<Vector3s>& contact_points, std::vector<scalar>& depths )
+// `cached_code' is the axis code from the previous step, or 0. It is tested
+// first, and if it separates the boxes no other axis is tested. When the
+// boxes are separated, `code' returns the separating axis.
+static void boxBox( const Vector3s& p1, const Matrix33sr& R1, const Vector3s& side1, const Vector3s& p2, const Matrix33sr& R2, const Vector3s& side2, const int cached_code, Vector3s& normal, scalar& depth, int& code, std::vector<Vector3s>& contact_points, std::vector<scalar>& depths )
 {
   // Relative displacement vector from center of box 1 to box 2, relative to box 1
   const Vector3s p{ p2 - p1 };
@@ -175,6 +212,16 @@ static void boxBox( const Vector3s& p1, const Matrix33sr& R1, const Vector3s& si
   const Matrix33sr R{ R1.transpose() * R2 };
   const Matrix33sr Q{ R.array().abs().matrix() };
 
+  // Try the axis from the previous step first
+  Vector3s cached_axis;
+  scalar cached_separation;
+  const bool cached_axis_valid{ cached_code != 0 && axisSeparation( cached_code, pp, R, side1, side2, cached_axis, cached_separation ) };
+  if( cached_axis_valid && cached_separation > 0.0 )
+  {
+    code = cached_code;
+    return;
+  }
+
   // For all 15 possible separating axes:
   //   * See if the axis separates the boxes. If so, return 0.
   //   * Find the depth of the penetration along the separating axis (s2).
@@ -330,6 +377,16 @@ static void boxBox( const Vector3s& p1, const Matrix33sr& R1, const Vector3s& si
 
   assert( code != 0 );
 
+  // Keep the previous step's axis while it is nearly as shallow as the best, so the reference face and
+  // contact points of resting boxes do not flip between nearly equivalent axes
+  if( cached_axis_valid && cached_code != code && cached_separation >= CACHED_AXIS_TOLERANCE * depth )
+  {
+    code = cached_code;
+    depth = cached_separation;
+    invert_normal = pp.dot( cached_axis ) < 0.0;
+    normalC = cached_axis;
+  }
+
   // If we get to this point, the boxes interpenetrate. Compute the normal in global coordinates.
   if( code <= 6 )
   {
@@ -614,12 +671,13 @@ static void boxBox( const Vector3s& p1, const Matrix33sr& R1, const Vector3s& si
   }
 }
 
-void BoxBoxUtilities::isActive( const Vector3s& cm0, const Matrix33sr& R0, const Vector3s& side0, const Vector3s& cm1, const Matrix33sr& R1, const Vector3s& side1, Vector3s& n, std::vector<Vector3s>& points )
+void BoxBoxUtilities::isActive( const Vector3s& cm0, const Matrix33sr& R0, const Vector3s& side0, const Vector3s& cm1, const Matrix33sr& R1, const Vector3s& side1, int& axis_code, Vector3s& n, std::vector<Vector3s>& points )
 {
+  assert( axis_code >= 0 ); assert( axis_code <= 15 );
   scalar max_depth;
   std::vector<scalar> depths;
-  int return_code;
-  boxBox( cm0, R0, side0, cm1, R1, side1, n, max_depth, return_code, points, depths );
+  const int cached_code{ axis_code };
+  boxBox( cm0, R0, side0, cm1, R1, side1, cached_code, n, max_depth, axis_code, points, depths );
   assert( points.size() == depths.size() );
   // Invert the normal so it points from the second body to the first body
   n *= -1.0;
@@ -13,7 +13,10 @@
 namespace BoxBoxUtilities
 {
 
-void isActive( const Vector3s& cm0, const Matrix33sr& R0, const Vector3s& side0, const Vector3s& cm1, const Matrix33sr& R1, const Vector3s& side1, Vector3s& n, std::vector<Vector3s>& points );
+// axis_code: (in) separating axis code from the previous step, or 0 if unknown
+//            (out) axis the boxes are separated along, or the axis contacts were generated from
+//            Codes 1..3 are faces of box 0, 4..6 are faces of box 1, and 7..15 are edge-edge axes
+void isActive( const Vector3s& cm0, const Matrix33sr& R0, const Vector3s& side0, const Vector3s& cm1, const Matrix33sr& R1, const Vector3s& side1, int& axis_code, Vector3s& n, std::vector<Vector3s>& points );
 
 }
 
@@ -0,0 +1,87 @@
+// ClumpUtilities.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "ClumpUtilities.h"
+
+#include "rigidbody3d/Geometry/RigidBodyClump.h"
+
+void ClumpUtilities::computeCenters( const Vector3s& cm, const Matrix33sr& R, const RigidBodyClump& clump, SphereCenters& centers )
+{
+  centers.noalias() = R * clump.centers();
+  centers.colwise() += cm;
+}
+
+void ClumpUtilities::computeOverlappingSpheres( const SphereCenters& x0, const VectorXs& r0, const SphereCenters& x1, const VectorXs& r1, std::vector<std::pair<unsigned,unsigned>>& pairs )
+{
+  assert( x0.cols() == r0.size() );
+  assert( x1.cols() == r1.size() );
+
+  // Bounds of the second set, so spheres of the first set far from all of it skip the distance tests
+  const Array3s min1{ ( x1.array().rowwise() - r1.array().transpose() ).rowwise().minCoeff() };
+  const Array3s max1{ ( x1.array().rowwise() + r1.array().transpose() ).rowwise().maxCoeff() };
+
+  Eigen::Array<scalar,1,Eigen::Dynamic> squared_distances{ x1.cols() };
+  Eigen::Array<bool,1,Eigen::Dynamic> overlaps{ x1.cols() };
+  for( int i = 0; i < x0.cols(); ++i )
+  {
+    if( ( x0.col( i ).array() + r0( i ) < min1 ).any() || ( x0.col( i ).array() - r0( i ) > max1 ).any() )
+    {
+      continue;
+    }
+    // Same test as SphereSphereConstraint::isActive, against every sphere of the second set at once
+    squared_distances = ( x1.row( 0 ).array() - x0( 0, i ) ).square() + ( x1.row( 1 ).array() - x0( 1, i ) ).square() + ( x1.row( 2 ).array() - x0( 2, i ) ).square();
+    overlaps = squared_distances <= ( r1.array().transpose() + r0( i ) ).square();
+    if( !overlaps.any() )
+    {
+      continue;
+    }
+    for( int j = 0; j < x1.cols(); ++j )
+    {
+      if( overlaps( j ) )
+      {
+        pairs.emplace_back( unsigned( i ), unsigned( j ) );
+      }
+    }
+  }
+}
+
+void ClumpUtilities::computeHalfPlaneActiveSet( const SphereCenters& x, const VectorXs& r, const Vector3s& x0, const Vector3s& n, std::vector<unsigned>& spheres )
+{
+  assert( x.cols() == r.size() );
+  assert( fabs( n.norm() - 1.0 ) <= 1.0e-6 );
+
+  // Same test as StaticPlaneSphereConstraint::isActive
+  const Eigen::Array<scalar,1,Eigen::Dynamic> distances{ n.x() * ( x.row( 0 ).array() - x0.x() ) + n.y() * ( x.row( 1 ).array() - x0.y() ) + n.z() * ( x.row( 2 ).array() - x0.z() ) };
+  const Eigen::Array<bool,1,Eigen::Dynamic> active{ distances <= r.array().transpose() };
+  for( int i = 0; i < x.cols(); ++i )
+  {
+    if( active( i ) )
+    {
+      spheres.emplace_back( unsigned( i ) );
+    }
+  }
+}
+
+void ClumpUtilities::computeCylinderActiveSet( const SphereCenters& x, const VectorXs& r, const Vector3s& x0, const Vector3s& axis, const scalar& R, std::vector<unsigned>& spheres )
+{
+  assert( x.cols() == r.size() );
+  assert( fabs( axis.norm() - 1.0 ) <= 1.0e-6 );
+  assert( R > 0.0 );
+
+  // Same test as StaticCylinderSphereConstraint::isActive: the component of each center orthogonal to the axis
+  const Eigen::Array<scalar,1,Eigen::Dynamic> dx{ x.row( 0 ).array() - x0.x() };
+  const Eigen::Array<scalar,1,Eigen::Dynamic> dy{ x.row( 1 ).array() - x0.y() };
+  const Eigen::Array<scalar,1,Eigen::Dynamic> dz{ x.row( 2 ).array() - x0.z() };
+  const Eigen::Array<scalar,1,Eigen::Dynamic> along{ axis.x() * dx + axis.y() * dy + axis.z() * dz };
+  const Eigen::Array<scalar,1,Eigen::Dynamic> squared_radial{ ( dx - along * axis.x() ).square() + ( dy - along * axis.y() ).square() + ( dz - along * axis.z() ).square() };
+  const Eigen::Array<bool,1,Eigen::Dynamic> active{ squared_radial >= ( R - r.array().transpose() ).square() };
+  for( int i = 0; i < x.cols(); ++i )
+  {
+    if( active( i ) )
+    {
+      spheres.emplace_back( unsigned( i ) );
+    }
+  }
+}
@@ -0,0 +1,37 @@
+// ClumpUtilities.h
+//
+// agent
+// Last updated: 10/19/2026
+
+#ifndef CLUMP_UTILITIES_H
+#define CLUMP_UTILITIES_H
+
+#include "scisim/Math/MathDefines.h"
+
+#include <utility>
+#include <vector>
+
+class RigidBodyClump;
+
+// Collision detection between the member spheres of clumps. Sphere centers are stored one coordinate per row so the
+// distance tests against all spheres of the other body run over contiguous arrays.
+namespace ClumpUtilities
+{
+
+using SphereCenters = Eigen::Matrix<scalar,3,Eigen::Dynamic,Eigen::RowMajor>;
+
+// World space centers of the spheres of a clump with center of mass cm and orientation R
+void computeCenters( const Vector3s& cm, const Matrix33sr& R, const RigidBodyClump& clump, SphereCenters& centers );
+
+// Index pairs of overlapping spheres, the first index from the first set and the second from the second set
+void computeOverlappingSpheres( const SphereCenters& x0, const VectorXs& r0, const SphereCenters& x1, const VectorXs& r1, std::vector<std::pair<unsigned,unsigned>>& pairs );
+
+// Indices of the spheres that intersect the given half plane
+void computeHalfPlaneActiveSet( const SphereCenters& x, const VectorXs& r, const Vector3s& x0, const Vector3s& n, std::vector<unsigned>& spheres );
+
+// Indices of the spheres that touch the wall of the given cylinder
+void computeCylinderActiveSet( const SphereCenters& x, const VectorXs& r, const Vector3s& x0, const Vector3s& axis, const scalar& R, std::vector<unsigned>& spheres );
+
+}
+
+#endif
@@ -0,0 +1,461 @@
+// CompoundUtilities.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "CompoundUtilities.h"
+
+#include "BoxBoxUtilities.h"
+#include "CollisionUtilities.h"
+
+#include "rigidbody3d/Geometry/RigidBodyBox.h"
+#include "rigidbody3d/Geometry/RigidBodyCapsule.h"
+#include "rigidbody3d/Geometry/RigidBodyCompound.h"
+#include "rigidbody3d/Geometry/RigidBodySphere.h"
+
+#include <algorithm>
+
+static constexpr unsigned GOLDEN_SECTION_ITERATIONS{ 40 };
+// Squared sine of the angle below which two capsules are treated as parallel
+static constexpr scalar PARALLEL_TOLERANCE{ 1.0e-4 };
+
+// A sphere, capsule or box with a pose
+struct PlacedPrimitive final
+{
+  const RigidBodyGeometry* geometry;
+  Vector3s x;
+  Matrix33sr R;
+  Array3s min;
+  Array3s max;
+};
+
+static void placePrimitives( const Vector3s& cm, const Matrix33sr& R, const RigidBodyGeometry& geometry, std::vector<PlacedPrimitive>& primitives )
+{
+  primitives.clear();
+  if( geometry.getType() == RigidBodyGeometryType::COMPOUND )
+  {
+    const RigidBodyCompound& compound{ static_cast<const RigidBodyCompound&>( geometry ) };
+    primitives.resize( compound.numChildren() );
+    for( unsigned child_idx = 0; child_idx < compound.numChildren(); ++child_idx )
+    {
+      PlacedPrimitive& primitive{ primitives[child_idx] };
+      primitive.geometry = &compound.child( child_idx );
+      compound.childPose( child_idx, cm, R, primitive.x, primitive.R );
+    }
+  }
+  else
+  {
+    primitives.resize( 1 );
+    primitives[0].geometry = &geometry;
+    primitives[0].x = cm;
+    primitives[0].R = R;
+  }
+  for( PlacedPrimitive& primitive : primitives )
+  {
+    primitive.geometry->computeAABB( primitive.x, primitive.R, primitive.min, primitive.max );
+  }
+}
+
+// Spheres and capsules are both a radius about a segment, which is degenerate for spheres
+static void segmentOf( const PlacedPrimitive& primitive, Vector3s& a, Vector3s& b, scalar& r )
+{
+  if( primitive.geometry->getType() == RigidBodyGeometryType::SPHERE )
+  {
+    a = primitive.x;
+    b = primitive.x;
+    r = static_cast<const RigidBodySphere*>( primitive.geometry )->r();
+  }
+  else
+  {
+    assert( primitive.geometry->getType() == RigidBodyGeometryType::CAPSULE );
+    const RigidBodyCapsule& capsule{ *static_cast<const RigidBodyCapsule*>( primitive.geometry ) };
+    a = primitive.x - capsule.halfLength() * primitive.R.col( 0 );
+    b = primitive.x + capsule.halfLength() * primitive.R.col( 0 );
+    r = capsule.r();
+  }
+}
+
+// Unit normal for segments whose skeletons touch, pointing from the second segment toward the first
+static Vector3s fallbackNormal( const Vector3s& d0, const Vector3s& d1, const Vector3s& dx )
+{
+  Vector3s n{ d0.cross( d1 ) };
+  if( n.squaredNorm() <= 1.0e-12 * ( 1.0 + d0.squaredNorm() * d1.squaredNorm() ) )
+  {
+    n = dx;
+  }
+  if( n.squaredNorm() <= 1.0e-24 )
+  {
+    // Coincident skeletons, any direction perpendicular to the segment separates them
+    n = d0.squaredNorm() > d1.squaredNorm() ? d0.unitOrthogonal() : ( d1.squaredNorm() > 0.0 ? d1.unitOrthogonal() : Vector3s::UnitZ() );
+  }
+  if( n.dot( dx ) < 0.0 )
+  {
+    n *= -1.0;
+  }
+  return n.normalized();
+}
+
+// Adds a contact between the closest points c0 and c1 of two skeletons if the radii overlap. The contact point is
+// half way between the two surfaces.
+static void addSkeletonContact( const Vector3s& c0, const scalar& r0, const Vector3s& c1, const scalar& r1, const Vector3s& fallback_n, std::vector<Vector3s>& points, std::vector<Vector3s>& normals )
+{
+  const scalar dist_squared{ ( c0 - c1 ).squaredNorm() };
+  if( dist_squared >= ( r0 + r1 ) * ( r0 + r1 ) )
+  {
+    return;
+  }
+  const scalar dist{ sqrt( dist_squared ) };
+  const Vector3s n{ dist > 1.0e-12 * ( r0 + r1 ) ? Vector3s{ ( c0 - c1 ) / dist } : fallback_n };
+  const Vector3s p{ 0.5 * ( c0 - r0 * n + c1 + r1 * n ) };
+  // Parallel segments can report the same pair of points from either end
+  if( std::any_of( points.cbegin(), points.cend(), [&p, &r0, &r1]( const Vector3s& other ) { return ( other - p ).squaredNorm() <= 1.0e-12 * ( r0 + r1 ) * ( r0 + r1 ); } ) )
+  {
+    return;
+  }
+  points.emplace_back( p );
+  normals.emplace_back( n );
+}
+
+// Sphere and capsule pairs. Crossing skeletons touch at their closest points, while nearly parallel skeletons
+// touch at both ends of their overlap so resting capsules do not rock about a single point.
+static void segmentSegmentContacts( const Vector3s& a0, const Vector3s& b0, const scalar& r0, const Vector3s& a1, const Vector3s& b1, const scalar& r1, std::vector<Vector3s>& points, std::vector<Vector3s>& normals )
+{
+  const Vector3s d0{ b0 - a0 };
+  const Vector3s d1{ b1 - a1 };
+  const Vector3s fallback_n{ fallbackNormal( d0, d1, 0.5 * ( a0 + b0 - a1 - b1 ) ) };
+
+  scalar s;
+  scalar t;
+  Vector3s c0;
+  Vector3s c1;
+
+  const bool parallel{ d0.squaredNorm() > 0.0 && d1.squaredNorm() > 0.0 && d0.cross( d1 ).squaredNorm() <= PARALLEL_TOLERANCE * d0.squaredNorm() * d1.squaredNorm() };
+  if( !parallel )
+  {
+    CollisionUtilities::closestPointSegmentSegment( a0, b0, a1, b1, s, t, c0, c1 );
+    addSkeletonContact( c0, r0, c1, r1, fallback_n, points, normals );
+    return;
+  }
+
+  // Each end of each skeleton against the other skeleton
+  CollisionUtilities::closestPointSegmentSegment( a0, a0, a1, b1, s, t, c0, c1 );
+  addSkeletonContact( c0, r0, c1, r1, fallback_n, points, normals );
+  CollisionUtilities::closestPointSegmentSegment( b0, b0, a1, b1, s, t, c0, c1 );
+  addSkeletonContact( c0, r0, c1, r1, fallback_n, points, normals );
+  CollisionUtilities::closestPointSegmentSegment( a0, b0, a1, a1, s, t, c0, c1 );
+  addSkeletonContact( c0, r0, c1, r1, fallback_n, points, normals );
+  CollisionUtilities::closestPointSegmentSegment( a0, b0, b1, b1, s, t, c0, c1 );
+  addSkeletonContact( c0, r0, c1, r1, fallback_n, points, normals );
+}
+
+// Signed distance from a point to a box centered at the origin with half widths h, along with the closest point
+// on the surface of the box and the outward normal there
+static scalar boxSignedDistance( const Vector3s& p, const Vector3s& h, Vector3s& surface_point, Vector3s& n )
+{
+  surface_point = p.cwiseMax( -h ).cwiseMin( h );
+  const Vector3s delta{ p - surface_point };
+  const scalar dist_squared{ delta.squaredNorm() };
+  if( dist_squared > 0.0 )
+  {
+    const scalar dist{ sqrt( dist_squared ) };
+    n = delta / dist;
+    return dist;
+  }
+  // Inside the box, push out through the nearest face
+  int axis;
+  ( h - p.cwiseAbs() ).minCoeff( &axis );
+  const scalar sign{ p( axis ) < 0.0 ? -1.0 : 1.0 };
+  n = sign * Vector3s::Unit( axis );
+  surface_point( axis ) = sign * h( axis );
+  return fabs( p( axis ) ) - h( axis );
+}
+
+// Sphere and capsule against a box. The signed distance from the box is convex along the skeleton, so the deepest
+// point is found with a golden section search; the ends of a capsule are also tested so a capsule lying on a face
+// is supported at both ends. Normals point from the box toward the skeleton.
+static void boxSegmentContacts( const Vector3s& xb, const Matrix33sr& Rb, const Vector3s& hb, const Vector3s& a, const Vector3s& b, const scalar& r, std::vector<Vector3s>& points, std::vector<Vector3s>& normals )
+{
+  const Vector3s a_local{ Rb.transpose() * ( a - xb ) };
+  const Vector3s b_local{ Rb.transpose() * ( b - xb ) };
+
+  const auto add_contact = [&]( const Vector3s& p_local )
+  {
+    Vector3s surface_point;
+    Vector3s n;
+    if( boxSignedDistance( p_local, hb, surface_point, n ) >= r )
+    {
+      return;
+    }
+    const Vector3s n_world{ Rb * n };
+    const Vector3s p{ 0.5 * ( xb + Rb * surface_point + xb + Rb * p_local - r * n_world ) };
+    points.emplace_back( p );
+    normals.emplace_back( n_world );
+  };
+
+  Vector3s surface_point;
+  Vector3s n;
+  if( a_local == b_local )
+  {
+    add_contact( a_local );
+    return;
+  }
+
+  // Golden section search for the deepest point along the skeleton
+  const scalar inv_phi{ 0.5 * ( sqrt( 5.0 ) - 1.0 ) };
+  scalar t0{ 0.0 };
+  scalar t1{ 1.0 };
+  scalar tl{ t1 - inv_phi * ( t1 - t0 ) };
+  scalar tr{ t0 + inv_phi * ( t1 - t0 ) };
+  scalar fl{ boxSignedDistance( a_local + tl * ( b_local - a_local ), hb, surface_point, n ) };
+  scalar fr{ boxSignedDistance( a_local + tr * ( b_local - a_local ), hb, surface_point, n ) };
+  for( unsigned itr = 0; itr < GOLDEN_SECTION_ITERATIONS; ++itr )
+  {
+    if( fl < fr )
+    {
+      t1 = tr;
+      tr = tl;
+      fr = fl;
+      tl = t1 - inv_phi * ( t1 - t0 );
+      fl = boxSignedDistance( a_local + tl * ( b_local - a_local ), hb, surface_point, n );
+    }
+    else
+    {
+      t0 = tl;
+      tl = tr;
+      fl = fr;
+      tr = t0 + inv_phi * ( t1 - t0 );
+      fr = boxSignedDistance( a_local + tr * ( b_local - a_local ), hb, surface_point, n );
+    }
+  }
+  const scalar t_min{ 0.5 * ( t0 + t1 ) };
+  const Vector3s p_min{ a_local + t_min * ( b_local - a_local ) };
+  const scalar f_min{ boxSignedDistance( p_min, hb, surface_point, n ) };
+  const scalar f_a{ boxSignedDistance( a_local, hb, surface_point, n ) };
+  const scalar f_b{ boxSignedDistance( b_local, hb, surface_point, n ) };
+
+  add_contact( a_local );
+  add_contact( b_local );
+  // Only add the interior point if it is deeper than both ends, otherwise the ends already support the capsule
+  if( f_min < std::min( f_a, f_b ) - 1.0e-9 * r )
+  {
+    add_contact( p_min );
+  }
+}
+
+static void primitiveContacts( const PlacedPrimitive& primitive0, const PlacedPrimitive& primitive1, std::vector<Vector3s>& points, std::vector<Vector3s>& normals )
+{
+  const bool box0{ primitive0.geometry->getType() == RigidBodyGeometryType::BOX };
+  const bool box1{ primitive1.geometry->getType() == RigidBodyGeometryType::BOX };
+
+  if( box0 && box1 )
+  {
+    const RigidBodyBox& box_geo0{ *static_cast<const RigidBodyBox*>( primitive0.geometry ) };
+    const RigidBodyBox& box_geo1{ *static_cast<const RigidBodyBox*>( primitive1.geometry ) };
+    int axis_code{ 0 };
+    Vector3s n;
+    std::vector<Vector3s> box_points;
+    BoxBoxUtilities::isActive( primitive0.x, primitive0.R, box_geo0.halfWidths(), primitive1.x, primitive1.R, box_geo1.halfWidths(), axis_code, n, box_points );
+    for( const Vector3s& point : box_points )
+    {
+      points.emplace_back( point );
+      normals.emplace_back( n );
+    }
+  }
+  else if( box0 )
+  {
+    Vector3s a;
+    Vector3s b;
+    scalar r;
+    segmentOf( primitive1, a, b, r );
+    const std::vector<Vector3s>::size_type first_new{ normals.size() };
+    boxSegmentContacts( primitive0.x, primitive0.R, static_cast<const RigidBodyBox*>( primitive0.geometry )->halfWidths(), a, b, r, points, normals );
+    // Normals must point toward the first primitive
+    for( std::vector<Vector3s>::size_type idx = first_new; idx < normals.size(); ++idx )
+    {
+      normals[idx] *= -1.0;
+    }
+  }
+  else if( box1 )
+  {
+    Vector3s a;
+    Vector3s b;
+    scalar r;
+    segmentOf( primitive0, a, b, r );
+    boxSegmentContacts( primitive1.x, primitive1.R, static_cast<const RigidBodyBox*>( primitive1.geometry )->halfWidths(), a, b, r, points, normals );
+  }
+  else
+  {
+    Vector3s a0;
+    Vector3s b0;
+    scalar r0;
+    segmentOf( primitive0, a0, b0, r0 );
+    Vector3s a1;
+    Vector3s b1;
+    scalar r1;
+    segmentOf( primitive1, a1, b1, r1 );
+    segmentSegmentContacts( a0, b0, r0, a1, b1, r1, points, normals );
+  }
+}
+
+// Children of a body with their poses in the body's principal frame
+static void bodySpaceChildren( const RigidBodyGeometry& geometry, std::vector<PlacedPrimitive>& primitives )
+{
+  placePrimitives( Vector3s::Zero(), Matrix33sr::Identity(), geometry, primitives );
+}
+
+bool CompoundUtilities::isPrimitiveOrCompound( const RigidBodyGeometry& geometry )
+{
+  switch( geometry.getType() )
+  {
+    case RigidBodyGeometryType::BOX:
+    case RigidBodyGeometryType::SPHERE:
+    case RigidBodyGeometryType::CAPSULE:
+    case RigidBodyGeometryType::COMPOUND:
+      return true;
+    case RigidBodyGeometryType::STAPLE:
+    case RigidBodyGeometryType::TRIANGLE_MESH:
+    case RigidBodyGeometryType::CONVEX_POLYHEDRON:
+    case RigidBodyGeometryType::CLUMP:
+      return false;
+  }
+  return false;
+}
+
+void CompoundUtilities::computeActiveSet( const Vector3s& cm0, const Matrix33sr& R0, const RigidBodyGeometry& geo0,
+                                          const Vector3s& cm1, const Matrix33sr& R1, const RigidBodyGeometry& geo1,
+                                          std::vector<Vector3s>& points, std::vector<Vector3s>& normals )
+{
+  assert( isPrimitiveOrCompound( geo0 ) );
+  assert( isPrimitiveOrCompound( geo1 ) );
+
+  std::vector<PlacedPrimitive> primitives0;
+  placePrimitives( cm0, R0, geo0, primitives0 );
+  std::vector<PlacedPrimitive> primitives1;
+  placePrimitives( cm1, R1, geo1, primitives1 );
+
+  for( const PlacedPrimitive& primitive0 : primitives0 )
+  {
+    for( const PlacedPrimitive& primitive1 : primitives1 )
+    {
+      // Second level of the broad phase, the bodies' AABBs overlap but these children's might not
+      if( ( primitive0.max < primitive1.min ).any() || ( primitive1.max < primitive0.min ).any() )
+      {
+        continue;
+      }
+      primitiveContacts( primitive0, primitive1, points, normals );
+    }
+  }
+  assert( points.size() == normals.size() );
+}
+
+void CompoundUtilities::computeHalfPlaneActiveSet( const Vector3s& cm, const Matrix33sr& R, const RigidBodyGeometry& geometry,
+                                                   const Vector3s& x0, const Vector3s& n, std::vector<Vector3s>& body_points )
+{
+  assert( fabs( n.norm() - 1.0 ) <= 1.0e-6 );
+
+  Matrix3Xsc sphere_centers;
+  VectorXs sphere_radii;
+  Matrix3Xsc corners;
+  computeMeshSamples( geometry, sphere_centers, sphere_radii, corners );
+
+  // Plane normal in body space
+  const Vector3s n_body{ R.transpose() * n };
+  for( int sphere_idx = 0; sphere_idx < sphere_centers.cols(); ++sphere_idx )
+  {
+    if( n.dot( cm + R * sphere_centers.col( sphere_idx ) - x0 ) <= sphere_radii( sphere_idx ) )
+    {
+      body_points.emplace_back( sphere_centers.col( sphere_idx ) - sphere_radii( sphere_idx ) * n_body );
+    }
+  }
+  for( int corner_idx = 0; corner_idx < corners.cols(); ++corner_idx )
+  {
+    if( n.dot( cm + R * corners.col( corner_idx ) - x0 ) <= 0.0 )
+    {
+      body_points.emplace_back( corners.col( corner_idx ) );
+    }
+  }
+}
+
+void CompoundUtilities::computeCylinderActiveSet( const Vector3s& cm, const Matrix33sr& R, const RigidBodyGeometry& geometry,
+                                                  const Vector3s& x0, const Vector3s& axis, const scalar& r, std::vector<Vector3s>& body_points )
+{
+  assert( fabs( axis.norm() - 1.0 ) <= 1.0e-6 );
+  assert( r > 0.0 );
+
+  Matrix3Xsc sphere_centers;
+  VectorXs sphere_radii;
+  Matrix3Xsc corners;
+  computeMeshSamples( geometry, sphere_centers, sphere_radii, corners );
+
+  for( int sphere_idx = 0; sphere_idx < sphere_centers.cols(); ++sphere_idx )
+  {
+    const Vector3s c{ cm + R * sphere_centers.col( sphere_idx ) };
+    // Vector along the horizontal extent of the cylinder
+    const Vector3s d{ c - x0 - axis.dot( c - x0 ) * axis };
+    const scalar d_norm{ d.norm() };
+    if( d_norm > 0.0 && d_norm >= r - sphere_radii( sphere_idx ) )
+    {
+      body_points.emplace_back( sphere_centers.col( sphere_idx ) + ( sphere_radii( sphere_idx ) / d_norm ) * R.transpose() * d );
+    }
+  }
+  for( int corner_idx = 0; corner_idx < corners.cols(); ++corner_idx )
+  {
+    const Vector3s v{ cm + R * corners.col( corner_idx ) };
+    const Vector3s d{ v - x0 - axis.dot( v - x0 ) * axis };
+    if( d.squaredNorm() >= r * r )
+    {
+      body_points.emplace_back( corners.col( corner_idx ) );
+    }
+  }
+}
+
+void CompoundUtilities::computeMeshSamples( const RigidBodyGeometry& geometry, Matrix3Xsc& sphere_centers, VectorXs& sphere_radii, Matrix3Xsc& points )
+{
+  assert( isPrimitiveOrCompound( geometry ) );
+
+  std::vector<PlacedPrimitive> primitives;
+  bodySpaceChildren( geometry, primitives );
+
+  std::vector<Vector3s> centers;
+  std::vector<scalar> radii;
+  std::vector<Vector3s> corners;
+  for( const PlacedPrimitive& primitive : primitives )
+  {
+    if( primitive.geometry->getType() == RigidBodyGeometryType::BOX )
+    {
+      const Vector3s& h{ static_cast<const RigidBodyBox*>( primitive.geometry )->halfWidths() };
+      for( int corner = 0; corner < 8; ++corner )
+      {
+        const Vector3s local_corner{ ( corner & 1 ? 1.0 : -1.0 ) * h.x(), ( corner & 2 ? 1.0 : -1.0 ) * h.y(), ( corner & 4 ? 1.0 : -1.0 ) * h.z() };
+        corners.emplace_back( primitive.x + primitive.R * local_corner );
+      }
+    }
+    else
+    {
+      Vector3s a;
+      Vector3s b;
+      scalar r;
+      segmentOf( primitive, a, b, r );
+      centers.emplace_back( a );
+      radii.emplace_back( r );
+      if( a != b )
+      {
+        centers.emplace_back( b );
+        radii.emplace_back( r );
+      }
+    }
+  }
+
+  sphere_centers.resize( 3, centers.size() );
+  sphere_radii.resize( radii.size() );
+  for( std::vector<Vector3s>::size_type sphere_idx = 0; sphere_idx < centers.size(); ++sphere_idx )
+  {
+    sphere_centers.col( sphere_idx ) = centers[sphere_idx];
+    sphere_radii( sphere_idx ) = radii[sphere_idx];
+  }
+  points.resize( 3, corners.size() );
+  for( std::vector<Vector3s>::size_type corner_idx = 0; corner_idx < corners.size(); ++corner_idx )
+  {
+    points.col( corner_idx ) = corners[corner_idx];
+  }
+}
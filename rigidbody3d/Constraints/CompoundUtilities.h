@@ -0,0 +1,41 @@
+// CompoundUtilities.h
+//
+// agent
+// Last updated: 10/19/2026
+
+#ifndef COMPOUND_UTILITIES_H
+#define COMPOUND_UTILITIES_H
+
+#include "scisim/Math/MathDefines.h"
+
+class RigidBodyGeometry;
+
+// Collision detection for bodies built from spheres, capsules and boxes. Each body is either a single capsule or
+// a compound of these primitives; the other body may also be a lone sphere or box.
+namespace CompoundUtilities
+{
+
+// True if the geometry is handled by these functions
+bool isPrimitiveOrCompound( const RigidBodyGeometry& geometry );
+
+// Contacts between two bodies. Pairs of children whose world space AABBs overlap are tested with the narrow phase
+// of the two primitives. Normals point from the second body toward the first.
+void computeActiveSet( const Vector3s& cm0, const Matrix33sr& R0, const RigidBodyGeometry& geo0,
+                       const Vector3s& cm1, const Matrix33sr& R1, const RigidBodyGeometry& geo1,
+                       std::vector<Vector3s>& points, std::vector<Vector3s>& normals );
+
+// Body space contact points (in the principal frame, relative to the center of mass) that intersect the given half plane
+void computeHalfPlaneActiveSet( const Vector3s& cm, const Matrix33sr& R, const RigidBodyGeometry& geometry,
+                                const Vector3s& x0, const Vector3s& n, std::vector<Vector3s>& body_points );
+
+// Body space contact points that intersect the wall of the given cylinder
+void computeCylinderActiveSet( const Vector3s& cm, const Matrix33sr& R, const RigidBodyGeometry& geometry,
+                               const Vector3s& x0, const Vector3s& axis, const scalar& r, std::vector<Vector3s>& body_points );
+
+// Body space spheres and points standing in for the body against static meshes: sphere children and the end caps
+// of capsules as spheres, and the corners of boxes as points
+void computeMeshSamples( const RigidBodyGeometry& geometry, Matrix3Xsc& sphere_centers, VectorXs& sphere_radii, Matrix3Xsc& points );
+
+}
+
+#endif
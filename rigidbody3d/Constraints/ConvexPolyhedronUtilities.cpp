@@ -0,0 +1,486 @@
+// ConvexPolyhedronUtilities.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "ConvexPolyhedronUtilities.h"
+
+#include "rigidbody3d/Geometry/RigidBodyConvexPolyhedron.h"
+
+#include <algorithm>
+#include <utility>
+
+static constexpr unsigned MAX_GJK_ITERATIONS{ 64 };
+static constexpr unsigned MAX_EPA_ITERATIONS{ 64 };
+static constexpr unsigned MAX_MANIFOLD_POINTS{ 4 };
+
+// Point of the Minkowski difference of the two polyhedra along with the vertices that produced it
+struct SupportPoint final
+{
+  Vector3s w;
+  Vector3s p0;
+  Vector3s p1;
+};
+
+struct EPAFace final
+{
+  unsigned a;
+  unsigned b;
+  unsigned c;
+  Vector3s n;
+  // Distance from the origin to the plane of the face
+  scalar d;
+};
+
+static Vector3s supportVertex( const Matrix3Xsc& vertices, const Vector3s& d )
+{
+  Eigen::Index idx;
+  ( d.transpose() * vertices ).maxCoeff( &idx );
+  return vertices.col( idx );
+}
+
+static SupportPoint support( const Matrix3Xsc& vertices0, const Matrix3Xsc& vertices1, const Vector3s& d )
+{
+  SupportPoint point;
+  point.p0 = supportVertex( vertices0, d );
+  point.p1 = supportVertex( vertices1, -d );
+  point.w = point.p0 - point.p1;
+  return point;
+}
+
+static Vector3s anyPerpendicular( const Vector3s& v )
+{
+  const Vector3s candidate{ fabs( v.x() ) < fabs( v.y() ) ? Vector3s::UnitX() : Vector3s::UnitY() };
+  return v.cross( candidate );
+}
+
+// Direction toward the origin from the segment, when the origin lies in the segment's Voronoi region
+static Vector3s segmentSearchDirection( const Vector3s& ab, const Vector3s& ao )
+{
+  const Vector3s d{ ab.cross( ao ).cross( ab ) };
+  // The origin lies on the segment, any direction perpendicular to it grows the simplex
+  if( d.squaredNorm() <= 1.0e-24 * ab.squaredNorm() * ab.squaredNorm() )
+  {
+    return anyPerpendicular( ab );
+  }
+  return d;
+}
+
+// Simplex updates from Casey Muratori's formulation of GJK. The newest point is last. Returns true if the
+// simplex is a tetrahedron that contains the origin.
+static bool updateLine( std::vector<SupportPoint>& simplex, Vector3s& d )
+{
+  assert( simplex.size() == 2 );
+  const Vector3s ab{ simplex[0].w - simplex[1].w };
+  const Vector3s ao{ -simplex[1].w };
+  if( ab.dot( ao ) > 0.0 )
+  {
+    d = segmentSearchDirection( ab, ao );
+  }
+  else
+  {
+    simplex.erase( simplex.begin() );
+    d = ao;
+  }
+  return false;
+}
+
+static bool updateTriangle( std::vector<SupportPoint>& simplex, Vector3s& d )
+{
+  assert( simplex.size() == 3 );
+  const Vector3s& a{ simplex[2].w };
+  const Vector3s ab{ simplex[1].w - a };
+  const Vector3s ac{ simplex[0].w - a };
+  const Vector3s ao{ -a };
+  const Vector3s abc{ ab.cross( ac ) };
+
+  // Collinear points add nothing over the newest edge
+  if( abc.squaredNorm() <= 1.0e-24 * ab.squaredNorm() * ac.squaredNorm() )
+  {
+    simplex.erase( simplex.begin() );
+    return updateLine( simplex, d );
+  }
+
+  if( abc.cross( ac ).dot( ao ) > 0.0 )
+  {
+    if( ac.dot( ao ) > 0.0 )
+    {
+      simplex.erase( simplex.begin() + 1 );
+      d = segmentSearchDirection( ac, ao );
+      return false;
+    }
+    simplex.erase( simplex.begin() );
+    return updateLine( simplex, d );
+  }
+  if( ab.cross( abc ).dot( ao ) > 0.0 )
+  {
+    simplex.erase( simplex.begin() );
+    return updateLine( simplex, d );
+  }
+  if( abc.dot( ao ) > 0.0 )
+  {
+    d = abc;
+  }
+  else
+  {
+    std::swap( simplex[0], simplex[1] );
+    d = -abc;
+  }
+  return false;
+}
+
+static bool updateTetrahedron( std::vector<SupportPoint>& simplex, Vector3s& d )
+{
+  assert( simplex.size() == 4 );
+  const Vector3s& a{ simplex[3].w };
+  const Vector3s ab{ simplex[2].w - a };
+  const Vector3s ac{ simplex[1].w - a };
+  const Vector3s ad{ simplex[0].w - a };
+  const Vector3s ao{ -a };
+
+  // A flat tetrahedron can not enclose the origin, keep the face with the newest point
+  if( fabs( ab.cross( ac ).dot( ad ) ) <= 1.0e-12 * ab.norm() * ac.norm() * ad.norm() )
+  {
+    simplex.erase( simplex.begin() );
+    return updateTriangle( simplex, d );
+  }
+
+  // Normals of the three faces through the newest point, oriented away from the remaining vertex
+  Vector3s abc{ ab.cross( ac ) };
+  if( abc.dot( ad ) > 0.0 )
+  {
+    abc = -abc;
+  }
+  if( abc.dot( ao ) > 0.0 )
+  {
+    simplex.erase( simplex.begin() );
+    return updateTriangle( simplex, d );
+  }
+  Vector3s acd{ ac.cross( ad ) };
+  if( acd.dot( ab ) > 0.0 )
+  {
+    acd = -acd;
+  }
+  if( acd.dot( ao ) > 0.0 )
+  {
+    simplex.erase( simplex.begin() + 2 );
+    return updateTriangle( simplex, d );
+  }
+  Vector3s adb{ ad.cross( ab ) };
+  if( adb.dot( ac ) > 0.0 )
+  {
+    adb = -adb;
+  }
+  if( adb.dot( ao ) > 0.0 )
+  {
+    simplex.erase( simplex.begin() + 1 );
+    return updateTriangle( simplex, d );
+  }
+  return true;
+}
+
+static bool updateSimplex( std::vector<SupportPoint>& simplex, Vector3s& d )
+{
+  switch( simplex.size() )
+  {
+    case 2:
+      return updateLine( simplex, d );
+    case 3:
+      return updateTriangle( simplex, d );
+    case 4:
+      return updateTetrahedron( simplex, d );
+    default:
+      assert( false );
+      return false;
+  }
+}
+
+// On success, simplex is a tetrahedron of the Minkowski difference that contains the origin
+static bool gjkOverlap( const Matrix3Xsc& vertices0, const Matrix3Xsc& vertices1, std::vector<SupportPoint>& simplex )
+{
+  Vector3s d{ vertices0.rowwise().mean() - vertices1.rowwise().mean() };
+  if( d.squaredNorm() == 0.0 )
+  {
+    d = Vector3s::UnitX();
+  }
+  simplex.clear();
+  simplex.emplace_back( support( vertices0, vertices1, d ) );
+  d = -simplex.back().w;
+  for( unsigned itr = 0; itr < MAX_GJK_ITERATIONS; ++itr )
+  {
+    // Shapes that only touch are treated as separated
+    if( d.squaredNorm() == 0.0 )
+    {
+      return false;
+    }
+    simplex.emplace_back( support( vertices0, vertices1, d ) );
+    if( simplex.back().w.dot( d ) <= 0.0 )
+    {
+      return false;
+    }
+    if( updateSimplex( simplex, d ) )
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+static EPAFace makeFace( const std::vector<SupportPoint>& polytope, const unsigned a, const unsigned b, const unsigned c )
+{
+  EPAFace face;
+  face.a = a;
+  face.b = b;
+  face.c = c;
+  face.n = ( polytope[b].w - polytope[a].w ).cross( polytope[c].w - polytope[a].w );
+  const scalar length{ face.n.norm() };
+  if( length <= 1.0e-12 * ( polytope[b].w - polytope[a].w ).norm() * ( polytope[c].w - polytope[a].w ).norm() || length == 0.0 )
+  {
+    // Sliver faces give no usable normal and are never expanded
+    face.n.setZero();
+    face.d = SCALAR_INFINITY;
+    return face;
+  }
+  face.n /= length;
+  face.d = face.n.dot( polytope[a].w );
+  return face;
+}
+
+static void addHorizonEdge( const unsigned a, const unsigned b, std::vector<std::pair<unsigned,unsigned>>& edges )
+{
+  // An edge shared by two removed faces appears once in each direction and is interior to the hole
+  const auto reversed = std::find( edges.begin(), edges.end(), std::make_pair( b, a ) );
+  if( reversed != edges.end() )
+  {
+    edges.erase( reversed );
+  }
+  else
+  {
+    edges.emplace_back( a, b );
+  }
+}
+
+// Expands the GJK tetrahedron until its face nearest the origin lies on the boundary of the Minkowski difference.
+// n is the outward normal of that face, d its distance from the origin, and p0, p1 the corresponding witness
+// points on each polyhedron.
+static bool epaPenetration( const Matrix3Xsc& vertices0, const Matrix3Xsc& vertices1, const std::vector<SupportPoint>& simplex, Vector3s& n, scalar& d, Vector3s& p0, Vector3s& p1 )
+{
+  assert( simplex.size() == 4 );
+  std::vector<SupportPoint> polytope{ simplex };
+  std::vector<EPAFace> faces;
+  {
+    const Vector3s centroid{ 0.25 * ( polytope[0].w + polytope[1].w + polytope[2].w + polytope[3].w ) };
+    const unsigned tet_faces[4][3]{ { 0, 1, 2 }, { 0, 3, 1 }, { 0, 2, 3 }, { 1, 3, 2 } };
+    for( const auto& tet_face : tet_faces )
+    {
+      EPAFace face{ makeFace( polytope, tet_face[0], tet_face[1], tet_face[2] ) };
+      if( face.n.dot( polytope[face.a].w - centroid ) < 0.0 )
+      {
+        face = makeFace( polytope, tet_face[0], tet_face[2], tet_face[1] );
+      }
+      faces.emplace_back( face );
+    }
+  }
+
+  std::vector<std::pair<unsigned,unsigned>> horizon;
+  std::vector<EPAFace>::size_type closest{ 0 };
+  for( unsigned itr = 0; itr < MAX_EPA_ITERATIONS; ++itr )
+  {
+    closest = std::min_element( faces.begin(), faces.end(), []( const EPAFace& f0, const EPAFace& f1 ) { return f0.d < f1.d; } ) - faces.begin();
+    if( faces[closest].d == SCALAR_INFINITY )
+    {
+      return false;
+    }
+
+    const SupportPoint point{ support( vertices0, vertices1, faces[closest].n ) };
+    // The polytope can not grow past the Minkowski difference, whose vertices are finite in number
+    if( point.w.dot( faces[closest].n ) - faces[closest].d <= 1.0e-9 * ( 1.0 + fabs( faces[closest].d ) ) )
+    {
+      break;
+    }
+
+    const unsigned new_idx{ unsigned( polytope.size() ) };
+    polytope.emplace_back( point );
+
+    // Remove every face the new point can see and stitch the hole's boundary to the new point
+    horizon.clear();
+    for( std::vector<EPAFace>::size_type fce = 0; fce < faces.size(); )
+    {
+      if( faces[fce].d != SCALAR_INFINITY && faces[fce].n.dot( point.w - polytope[faces[fce].a].w ) > 0.0 )
+      {
+        addHorizonEdge( faces[fce].a, faces[fce].b, horizon );
+        addHorizonEdge( faces[fce].b, faces[fce].c, horizon );
+        addHorizonEdge( faces[fce].c, faces[fce].a, horizon );
+        faces[fce] = faces.back();
+        faces.pop_back();
+      }
+      else
+      {
+        ++fce;
+      }
+    }
+    for( const std::pair<unsigned,unsigned>& edge : horizon )
+    {
+      faces.emplace_back( makeFace( polytope, edge.first, edge.second, new_idx ) );
+    }
+    if( faces.empty() )
+    {
+      return false;
+    }
+  }
+
+  closest = std::min_element( faces.begin(), faces.end(), []( const EPAFace& f0, const EPAFace& f1 ) { return f0.d < f1.d; } ) - faces.begin();
+  const EPAFace& face{ faces[closest] };
+  if( face.d == SCALAR_INFINITY )
+  {
+    return false;
+  }
+  n = face.n;
+  d = face.d;
+
+  // Barycentric coordinates of the origin's projection onto the face give the witness points
+  const Vector3s& a{ polytope[face.a].w };
+  const Vector3s v0{ polytope[face.b].w - a };
+  const Vector3s v1{ polytope[face.c].w - a };
+  const Vector3s v2{ face.d * face.n - a };
+  const scalar d00{ v0.dot( v0 ) };
+  const scalar d01{ v0.dot( v1 ) };
+  const scalar d11{ v1.dot( v1 ) };
+  const scalar d20{ v2.dot( v0 ) };
+  const scalar d21{ v2.dot( v1 ) };
+  const scalar denom{ d00 * d11 - d01 * d01 };
+  assert( denom > 0.0 );
+  const scalar beta{ ( d11 * d20 - d01 * d21 ) / denom };
+  const scalar gamma{ ( d00 * d21 - d01 * d20 ) / denom };
+  const scalar alpha{ 1.0 - beta - gamma };
+  p0 = alpha * polytope[face.a].p0 + beta * polytope[face.b].p0 + gamma * polytope[face.c].p0;
+  p1 = alpha * polytope[face.a].p1 + beta * polytope[face.b].p1 + gamma * polytope[face.c].p1;
+  return true;
+}
+
+static void appendVerticesInside( const Matrix3Xsc& vertices, const Matrix3Xsc& normals, const VectorXs& offsets, std::vector<Vector3s>& points )
+{
+  const MatrixXXsc plane_distances{ ( normals.transpose() * vertices ).colwise() - offsets };
+  for( int vrt = 0; vrt < vertices.cols(); ++vrt )
+  {
+    if( plane_distances.col( vrt ).maxCoeff() <= 0.0 )
+    {
+      points.emplace_back( vertices.col( vrt ) );
+    }
+  }
+}
+
+// Keeps the points extremal along two directions in the contact plane
+static void reduceManifold( const Vector3s& n, std::vector<Vector3s>& points )
+{
+  if( points.size() <= MAX_MANIFOLD_POINTS )
+  {
+    return;
+  }
+  const Vector3s t0{ anyPerpendicular( n ).normalized() };
+  const Vector3s t1{ n.cross( t0 ) };
+  const Vector3s directions[MAX_MANIFOLD_POINTS]{ t0, -t0, t1, -t1 };
+  std::vector<Vector3s> reduced;
+  for( const Vector3s& direction : directions )
+  {
+    const Vector3s& extreme{ *std::max_element( points.begin(), points.end(), [&direction]( const Vector3s& x0, const Vector3s& x1 ) { return direction.dot( x0 ) < direction.dot( x1 ); } ) };
+    if( std::find( reduced.begin(), reduced.end(), extreme ) == reduced.end() )
+    {
+      reduced.emplace_back( extreme );
+    }
+  }
+  points.swap( reduced );
+}
+
+void ConvexPolyhedronUtilities::transformPolyhedron( const Vector3s& cm, const Matrix33sr& R, const RigidBodyConvexPolyhedron& polyhedron, Matrix3Xsc& vertices, Matrix3Xsc& normals, VectorXs& offsets )
+{
+  vertices = ( R * polyhedron.vertices() ).colwise() + cm;
+  normals = R * polyhedron.faceNormals();
+  offsets = polyhedron.faceOffsets() + normals.transpose() * cm;
+}
+
+void ConvexPolyhedronUtilities::boxAsPolyhedron( const Vector3s& cm, const Matrix33sr& R, const Vector3s& half_widths, Matrix3Xsc& vertices, Matrix3Xsc& normals, VectorXs& offsets )
+{
+  vertices.resize( 3, 8 );
+  for( int corner = 0; corner < 8; ++corner )
+  {
+    const Vector3s local{ ( corner & 1 ? 1.0 : -1.0 ) * half_widths.x(), ( corner & 2 ? 1.0 : -1.0 ) * half_widths.y(), ( corner & 4 ? 1.0 : -1.0 ) * half_widths.z() };
+    vertices.col( corner ) = cm + R * local;
+  }
+  normals.resize( 3, 6 );
+  offsets.resize( 6 );
+  for( int axis = 0; axis < 3; ++axis )
+  {
+    normals.col( 2 * axis ) = R.col( axis );
+    normals.col( 2 * axis + 1 ) = -R.col( axis );
+    offsets( 2 * axis ) = R.col( axis ).dot( cm ) + half_widths( axis );
+    offsets( 2 * axis + 1 ) = -R.col( axis ).dot( cm ) + half_widths( axis );
+  }
+}
+
+bool ConvexPolyhedronUtilities::computeActiveSet( const Matrix3Xsc& vertices0, const Matrix3Xsc& normals0, const VectorXs& offsets0,
+                                                  const Matrix3Xsc& vertices1, const Matrix3Xsc& normals1, const VectorXs& offsets1,
+                                                  Vector3s& n, scalar& depth, std::vector<Vector3s>& points )
+{
+  assert( normals0.cols() == offsets0.size() );
+  assert( normals1.cols() == offsets1.size() );
+
+  std::vector<SupportPoint> simplex;
+  if( !gjkOverlap( vertices0, vertices1, simplex ) )
+  {
+    return false;
+  }
+
+  Vector3s witness0;
+  Vector3s witness1;
+  if( !epaPenetration( vertices0, vertices1, simplex, n, depth, witness0, witness1 ) )
+  {
+    return false;
+  }
+  // The nearest face of the Minkowski difference faces away from the first polyhedron's escape direction
+  n = -n;
+
+  points.clear();
+  appendVerticesInside( vertices0, normals1, offsets1, points );
+  appendVerticesInside( vertices1, normals0, offsets0, points );
+  if( points.empty() )
+  {
+    points.emplace_back( 0.5 * ( witness0 + witness1 ) );
+  }
+  reduceManifold( n, points );
+  return true;
+}
+
+void ConvexPolyhedronUtilities::computeHalfPlaneActiveSet( const Vector3s& cm, const Matrix33sr& R, const RigidBodyConvexPolyhedron& polyhedron,
+                                                           const Vector3s& x0, const Vector3s& n, std::vector<unsigned>& vertices )
+{
+  assert( ( R * R.transpose() - Matrix33sr::Identity() ).lpNorm<Eigen::Infinity>() <= 1.0e-6 );
+  assert( fabs( R.determinant() - 1.0 ) <= 1.0e-6 );
+
+  for( unsigned vrt_idx = 0; vrt_idx < unsigned( polyhedron.vertices().cols() ); ++vrt_idx )
+  {
+    const Vector3s v{ R * polyhedron.vertices().col( vrt_idx ) + cm };
+    if( n.dot( v - x0 ) <= 0.0 )
+    {
+      vertices.emplace_back( vrt_idx );
+    }
+  }
+}
+
+void ConvexPolyhedronUtilities::computeCylinderActiveSet( const Vector3s& cm, const Matrix33sr& R, const RigidBodyConvexPolyhedron& polyhedron,
+                                                          const Vector3s& x0, const Vector3s& axis, const scalar& r, std::vector<unsigned>& vertices )
+{
+  assert( fabs( axis.norm() - 1.0 ) <= 1.0e-6 );
+  assert( r > 0.0 );
+
+  for( unsigned vrt_idx = 0; vrt_idx < unsigned( polyhedron.vertices().cols() ); ++vrt_idx )
+  {
+    const Vector3s v{ R * polyhedron.vertices().col( vrt_idx ) + cm };
+    // Vector along the horizontal extent of the cylinder
+    const Vector3s d{ v - x0 - axis.dot( v - x0 ) * axis };
+    if( d.squaredNorm() >= r * r )
+    {
+      vertices.emplace_back( vrt_idx );
+    }
+  }
+}
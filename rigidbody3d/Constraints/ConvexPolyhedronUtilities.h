@@ -0,0 +1,41 @@
+// ConvexPolyhedronUtilities.h
+//
+// agent
+// Last updated: 10/19/2026
+
+#ifndef CONVEX_POLYHEDRON_UTILITIES_H
+#define CONVEX_POLYHEDRON_UTILITIES_H
+
+#include "scisim/Math/MathDefines.h"
+
+class RigidBodyConvexPolyhedron;
+
+namespace ConvexPolyhedronUtilities
+{
+
+// World-space vertices and outward face planes ( normals.col( i ).dot( x ) <= offsets( i ) inside ) of a placed polyhedron
+void transformPolyhedron( const Vector3s& cm, const Matrix33sr& R, const RigidBodyConvexPolyhedron& polyhedron, Matrix3Xsc& vertices, Matrix3Xsc& normals, VectorXs& offsets );
+
+// The same representation for a box, so boxes can collide with polyhedra
+void boxAsPolyhedron( const Vector3s& cm, const Matrix33sr& R, const Vector3s& half_widths, Matrix3Xsc& vertices, Matrix3Xsc& normals, VectorXs& offsets );
+
+// Tests two overlapping convex polyhedra with GJK and finds the penetration normal with EPA. The contact manifold
+// holds the vertices of each polyhedron inside the other, reduced to at most four points, or the EPA witness
+// point if no vertex penetrates (as in edge-edge contact). Returns false if the polyhedra are separated, otherwise
+// n is the unit normal pointing from the second polyhedron toward the first and depth is the distance the first
+// must move along n to separate them.
+bool computeActiveSet( const Matrix3Xsc& vertices0, const Matrix3Xsc& normals0, const VectorXs& offsets0,
+                       const Matrix3Xsc& vertices1, const Matrix3Xsc& normals1, const VectorXs& offsets1,
+                       Vector3s& n, scalar& depth, std::vector<Vector3s>& points );
+
+// Returns a list of vertices that intersect the given half plane
+void computeHalfPlaneActiveSet( const Vector3s& cm, const Matrix33sr& R, const RigidBodyConvexPolyhedron& polyhedron,
+                                const Vector3s& x0, const Vector3s& n, std::vector<unsigned>& vertices );
+
+// Returns a list of vertices that intersect the given cylinder
+void computeCylinderActiveSet( const Vector3s& cm, const Matrix33sr& R, const RigidBodyConvexPolyhedron& polyhedron,
+                               const Vector3s& x0, const Vector3s& axis, const scalar& r, std::vector<unsigned>& vertices );
+
+}
+
+#endif
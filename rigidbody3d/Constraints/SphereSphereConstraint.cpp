@@ -6,16 +6,18 @@
 #include "SphereSphereConstraint.h"
 
 #include "FrictionUtilities.h"
-
-#ifndef NDEBUG
 #include "scisim/Math/MathUtilities.h"
-#endif
 
 bool SphereSphereConstraint::isActive( const Vector3s& x0, const Vector3s& x1, const scalar& r0, const scalar& r1 )
 {
   return ( x0 - x1 ).squaredNorm() <= ( r0 + r1 ) * ( r0 + r1 );
 }
 
+scalar SphereSphereConstraint::timeOfImpact( const Vector3s& x0_start, const Vector3s& x1_start, const Vector3s& x0_end, const Vector3s& x1_end, const scalar& r0, const scalar& r1 )
+{
+  return MathUtilities::sphereSphereTimeOfImpact<3>( x0_start, x1_start, x0_end, x1_end, r0, r1 );
+}
+
 SphereSphereConstraint::SphereSphereConstraint( const unsigned sphere_idx0, const unsigned sphere_idx1, const Vector3s& n, const Vector3s& p, const scalar& r0, const scalar& r1 )
 : m_idx0( sphere_idx0 )
 , m_idx1( sphere_idx1 )
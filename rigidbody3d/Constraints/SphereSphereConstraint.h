@@ -14,6 +14,9 @@ class SphereSphereConstraint final : public Constraint
 public:
 
   static bool isActive( const Vector3s& x0, const Vector3s& x1, const scalar& r0, const scalar& r1 );
+  // Fraction of the step at which two spheres moving linearly from the start to the end positions first touch,
+  // 0 if they start in contact and infinity if they do not touch during the step
+  static scalar timeOfImpact( const Vector3s& x0_start, const Vector3s& x1_start, const Vector3s& x0_end, const Vector3s& x1_end, const scalar& r0, const scalar& r1 );
 
   SphereSphereConstraint( const unsigned sphere_idx0, const unsigned sphere_idx1, const Vector3s& n, const Vector3s& p, const scalar& r0, const scalar& r1 );
   virtual ~SphereSphereConstraint() override;
@@ -5,11 +5,20 @@
 
 #include "MomentTools.h"
 
+#include <algorithm>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include <Eigen/Eigenvalues>
 
-static void diagonalizeInertiaTensor( const Matrix3s& I, Matrix3s& R0, Vector3s& I0 )
+// Number of columns along each of x and y used to integrate over the overlap of solids
+static constexpr unsigned OVERLAP_INTEGRATION_RESOLUTION{ 256 };
+
+namespace MomentTools
+{
+
+void diagonalizeInertiaTensor( const Matrix3s& I, Matrix3s& R0, Vector3s& I0 )
 {
   // Inertia tensor should by symmetric
   assert( ( I - I.transpose() ).lpNorm<Eigen::Infinity>() <= 1.0e-6 );
@@ -49,9 +58,6 @@ static void diagonalizeInertiaTensor( const Matrix3s& I, Matrix3s& R0, Vector3s&
   }
 }
 
-namespace MomentTools
-{
-
 // TODO: most of this function can be vectorized
 void computeMoments( const Matrix3Xsc& vertices, const Matrix3Xuc& indices, scalar& mass, Vector3s& I, Vector3s& center, Matrix3s& R )
 {
@@ -174,4 +180,100 @@ void computeMoments( const Matrix3Xsc& vertices, const Matrix3Xuc& indices, scal
   assert( fabs( R.determinant() - 1.0 ) <= 1.0e-6 );
 }
 
+void integrateOverlap( const Matrix3Xsc& min, const Matrix3Xsc& max, const std::function<bool(unsigned,const scalar&,const scalar&,scalar&,scalar&)>& interval, scalar& volume, Vector3s& first_moments, Matrix3s& second_moments )
+{
+  assert( min.cols() == max.cols() );
+
+  volume = 0.0;
+  first_moments.setZero();
+  second_moments.setZero();
+
+  // Only integrate over the bounds of the pairwise intersections of the solids' bounding boxes
+  Array3s overlap_min{ Array3s::Constant( SCALAR_INFINITY ) };
+  Array3s overlap_max{ Array3s::Constant( -SCALAR_INFINITY ) };
+  for( int i = 0; i < min.cols(); ++i )
+  {
+    for( int j = i + 1; j < min.cols(); ++j )
+    {
+      const Array3s pair_min{ min.col( i ).array().max( min.col( j ).array() ) };
+      const Array3s pair_max{ max.col( i ).array().min( max.col( j ).array() ) };
+      if( ( pair_min < pair_max ).all() )
+      {
+        overlap_min = overlap_min.min( pair_min );
+        overlap_max = overlap_max.max( pair_max );
+      }
+    }
+  }
+  if( !( overlap_min < overlap_max ).all() )
+  {
+    return;
+  }
+
+  const scalar dx{ ( overlap_max.x() - overlap_min.x() ) / scalar( OVERLAP_INTEGRATION_RESOLUTION ) };
+  const scalar dy{ ( overlap_max.y() - overlap_min.y() ) / scalar( OVERLAP_INTEGRATION_RESOLUTION ) };
+  const scalar dA{ dx * dy };
+
+  std::vector<std::pair<scalar,scalar>> intervals;
+  for( unsigned x_idx = 0; x_idx < OVERLAP_INTEGRATION_RESOLUTION; ++x_idx )
+  {
+    const scalar x{ overlap_min.x() + ( scalar( x_idx ) + 0.5 ) * dx };
+    for( unsigned y_idx = 0; y_idx < OVERLAP_INTEGRATION_RESOLUTION; ++y_idx )
+    {
+      const scalar y{ overlap_min.y() + ( scalar( y_idx ) + 0.5 ) * dy };
+
+      // Intervals along z covered by each solid
+      intervals.clear();
+      for( int solid_idx = 0; solid_idx < min.cols(); ++solid_idx )
+      {
+        if( x < min( 0, solid_idx ) || x > max( 0, solid_idx ) || y < min( 1, solid_idx ) || y > max( 1, solid_idx ) )
+        {
+          continue;
+        }
+        scalar z0;
+        scalar z1;
+        if( interval( unsigned( solid_idx ), x, y, z0, z1 ) && z0 < z1 )
+        {
+          intervals.emplace_back( z0, z1 );
+        }
+      }
+      if( intervals.size() < 2 )
+      {
+        continue;
+      }
+      std::sort( intervals.begin(), intervals.end() );
+
+      // With the intervals sorted by start, the part of each interval already covered by earlier intervals runs
+      // from its start to the furthest end seen so far
+      scalar L{ 0.0 };
+      scalar Z1{ 0.0 };
+      scalar Z2{ 0.0 };
+      scalar reach{ intervals.front().second };
+      for( std::vector<std::pair<scalar,scalar>>::size_type interval_idx = 1; interval_idx < intervals.size(); ++interval_idx )
+      {
+        const scalar a{ intervals[interval_idx].first };
+        const scalar b{ std::min( intervals[interval_idx].second, reach ) };
+        if( a < b )
+        {
+          L += b - a;
+          Z1 += 0.5 * ( b * b - a * a );
+          Z2 += ( b * b * b - a * a * a ) / 3.0;
+        }
+        reach = std::max( reach, intervals[interval_idx].second );
+      }
+
+      volume += dA * L;
+      first_moments += dA * Vector3s{ x * L, y * L, Z1 };
+      second_moments( 0, 0 ) += dA * x * x * L;
+      second_moments( 1, 1 ) += dA * y * y * L;
+      second_moments( 2, 2 ) += dA * Z2;
+      second_moments( 0, 1 ) += dA * x * y * L;
+      second_moments( 0, 2 ) += dA * x * Z1;
+      second_moments( 1, 2 ) += dA * y * Z1;
+    }
+  }
+  second_moments( 1, 0 ) = second_moments( 0, 1 );
+  second_moments( 2, 0 ) = second_moments( 0, 2 );
+  second_moments( 2, 1 ) = second_moments( 1, 2 );
+}
+
 }
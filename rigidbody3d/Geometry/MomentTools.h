@@ -8,6 +8,8 @@
 
 #include "scisim/Math/MathDefines.h"
 
+#include <functional>
+
 namespace MomentTools
 {
 
@@ -15,6 +17,17 @@ namespace MomentTools
   // *** Caller must rescale mass and I by density ***
   void computeMoments( const Matrix3Xsc& vertices, const Matrix3Xuc& indices, scalar& mass, Vector3s& I, Vector3s& center, Matrix3s& R );
 
+  // Principal moments I0 (ascending) and orientation preserving principal axes R0 of a symmetric, positive definite inertia tensor I
+  void diagonalizeInertiaTensor( const Matrix3s& I, Matrix3s& R0, Vector3s& I0 );
+
+  // Volume, first moments, and second moments (about the origin) per unit density of the region covered by more than
+  // one of a set of convex solids, counted once for each solid beyond the first. Subtracting these from the summed
+  // moments of the solids gives the moments of their union. Columns i of min and max bound solid i, and
+  // interval( i, x, y, z0, z1 ) returns whether the line along z through (x, y) crosses solid i, setting the
+  // crossed interval [z0, z1] if so. Intervals are integrated exactly, so only the boundary of the overlap in x and y
+  // is approximated, and solids that do not overlap contribute exactly nothing.
+  void integrateOverlap( const Matrix3Xsc& min, const Matrix3Xsc& max, const std::function<bool(unsigned,const scalar&,const scalar&,scalar&,scalar&)>& interval, scalar& volume, Vector3s& first_moments, Matrix3s& second_moments );
+
 }
 
 #endif
@@ -0,0 +1,91 @@
+// RigidBodyCapsule.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "RigidBodyCapsule.h"
+
+#include "scisim/Utilities.h"
+
+void RigidBodyCapsule::computeMassAndInertia( const scalar& density, scalar& M, Vector3s& CM, Vector3s& I, Matrix33sr& R ) const
+{
+  assert( density > 0.0 );
+
+  // Mass of the cylindrical section and of the two hemispherical caps
+  const scalar Mc{ density * MathDefines::PI<scalar>() * m_r * m_r * 2.0 * m_h };
+  const scalar Ms{ density * 4.0 * MathDefines::PI<scalar>() * m_r * m_r * m_r / 3.0 };
+  M = Mc + Ms;
+
+  I.x() = 0.5 * Mc * m_r * m_r + 0.4 * Ms * m_r * m_r;
+  // Caps are offset from the center of mass by the half length plus the distance to their own centers of mass
+  I.y() = Mc * ( 0.25 * m_r * m_r + m_h * m_h / 3.0 ) + Ms * ( 0.4 * m_r * m_r + m_h * m_h + 0.75 * m_h * m_r );
+  I.z() = I.y();
+
+  CM.setZero();
+  R.setIdentity();
+}
+
+RigidBodyCapsule::RigidBodyCapsule( const scalar& r, const scalar& h )
+: m_r( r )
+, m_h( h )
+{
+  assert( m_r > 0.0 );
+  assert( m_h > 0.0 );
+}
+
+RigidBodyCapsule::RigidBodyCapsule( std::istream& input_stream )
+: m_r( Utilities::deserialize<scalar>( input_stream ) )
+, m_h( Utilities::deserialize<scalar>( input_stream ) )
+{
+  assert( m_r > 0.0 );
+  assert( m_h > 0.0 );
+}
+
+RigidBodyCapsule::~RigidBodyCapsule()
+{}
+
+RigidBodyGeometryType RigidBodyCapsule::getType() const
+{
+  return RigidBodyGeometryType::CAPSULE;
+}
+
+std::unique_ptr<RigidBodyGeometry> RigidBodyCapsule::clone() const
+{
+  return std::unique_ptr<RigidBodyGeometry>{ new RigidBodyCapsule{ m_r, m_h } };
+}
+
+void RigidBodyCapsule::computeAABB( const Vector3s& cm, const Matrix33sr& R, Array3s& min, Array3s& max ) const
+{
+  const Array3s extents{ m_h * R.col( 0 ).array().abs() + m_r };
+  min = cm.array() - extents;
+  max = cm.array() + extents;
+  assert( ( min < max ).all() );
+}
+
+std::string RigidBodyCapsule::name() const
+{
+  return "capsule";
+}
+
+void RigidBodyCapsule::serialize( std::ostream& output_stream ) const
+{
+  assert( output_stream.good() );
+  Utilities::serialize( RigidBodyGeometryType::CAPSULE, output_stream );
+  Utilities::serialize( m_r, output_stream );
+  Utilities::serialize( m_h, output_stream );
+}
+
+scalar RigidBodyCapsule::volume() const
+{
+  return MathDefines::PI<scalar>() * m_r * m_r * ( 2.0 * m_h + 4.0 * m_r / 3.0 );
+}
+
+const scalar& RigidBodyCapsule::r() const
+{
+  return m_r;
+}
+
+const scalar& RigidBodyCapsule::halfLength() const
+{
+  return m_h;
+}
@@ -0,0 +1,49 @@
+// RigidBodyCapsule.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Capsule of radius r swept along a segment of half length h on the body's x axis.
+
+#ifndef RIGID_BODY_CAPSULE_H
+#define RIGID_BODY_CAPSULE_H
+
+#include "RigidBodyGeometry.h"
+
+class RigidBodyCapsule final : public RigidBodyGeometry
+{
+
+public:
+
+  // r: radius of the capsule
+  // h: half length of the capsule's skeleton along the x axis
+  RigidBodyCapsule( const scalar& r, const scalar& h );
+  explicit RigidBodyCapsule( std::istream& input_stream );
+  virtual ~RigidBodyCapsule() override;
+
+  virtual RigidBodyGeometryType getType() const override;
+
+  virtual std::unique_ptr<RigidBodyGeometry> clone() const override;
+
+  virtual void computeAABB( const Vector3s& cm, const Matrix33sr& R, Array3s& min, Array3s& max ) const override;
+
+  virtual void computeMassAndInertia( const scalar& density, scalar& M, Vector3s& CM, Vector3s& I, Matrix33sr& R ) const override;
+
+  virtual std::string name() const override;
+
+  virtual void serialize( std::ostream& output_stream ) const override;
+
+  virtual scalar volume() const override;
+
+  const scalar& r() const;
+
+  const scalar& halfLength() const;
+
+private:
+
+  const scalar m_r;
+  const scalar m_h;
+
+};
+
+#endif
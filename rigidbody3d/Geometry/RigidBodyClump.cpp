@@ -0,0 +1,145 @@
+// RigidBodyClump.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "RigidBodyClump.h"
+
+#include "MomentTools.h"
+
+#include "scisim/Math/MathUtilities.h"
+#include "scisim/Utilities.h"
+
+RigidBodyClump::RigidBodyClump( const Matrix3Xsc& centers, const VectorXs& radii )
+: m_centers()
+, m_radii( radii )
+, m_volume()
+, m_I_on_rho()
+, m_center_of_mass()
+, m_R()
+{
+  assert( centers.cols() > 0 );
+  assert( centers.cols() == radii.size() );
+  assert( ( radii.array() > 0.0 ).all() );
+
+  // Exact moments of the spheres about the origin, counting the volume where spheres overlap once per sphere
+  const VectorXs volumes{ 4.0 * MathDefines::PI<scalar>() * radii.array().cube() / 3.0 };
+  m_volume = volumes.sum();
+  Vector3s first_moments{ centers * volumes };
+  Matrix3s second_moments{ centers * volumes.asDiagonal() * centers.transpose() };
+  second_moments.diagonal().array() += 0.2 * volumes.dot( radii.cwiseAbs2() );
+
+  // Remove the overlapping volume counted more than once
+  {
+    const Matrix3Xsc min{ centers.array().rowwise() - radii.array().transpose() };
+    const Matrix3Xsc max{ centers.array().rowwise() + radii.array().transpose() };
+    scalar overlap_volume;
+    Vector3s overlap_first_moments;
+    Matrix3s overlap_second_moments;
+    MomentTools::integrateOverlap( min, max, [&centers, &radii]( const unsigned sphere_idx, const scalar& x, const scalar& y, scalar& z0, scalar& z1 )
+      {
+        const scalar h2{ radii( sphere_idx ) * radii( sphere_idx ) - ( x - centers( 0, sphere_idx ) ) * ( x - centers( 0, sphere_idx ) ) - ( y - centers( 1, sphere_idx ) ) * ( y - centers( 1, sphere_idx ) ) };
+        if( h2 <= 0.0 )
+        {
+          return false;
+        }
+        const scalar h{ sqrt( h2 ) };
+        z0 = centers( 2, sphere_idx ) - h;
+        z1 = centers( 2, sphere_idx ) + h;
+        return true;
+      }, overlap_volume, overlap_first_moments, overlap_second_moments );
+    m_volume -= overlap_volume;
+    first_moments -= overlap_first_moments;
+    second_moments -= overlap_second_moments;
+  }
+  assert( m_volume > 0.0 );
+  m_center_of_mass = first_moments / m_volume;
+
+  // Second moments about the center of mass give the inertia tensor
+  const Matrix3s C{ second_moments - m_volume * m_center_of_mass * m_center_of_mass.transpose() };
+  const Matrix3s I{ C.trace() * Matrix3s::Identity() - C };
+  MomentTools::diagonalizeInertiaTensor( I, m_R, m_I_on_rho );
+
+  // Express the spheres in the principal frame
+  m_centers = m_R.transpose() * ( centers.colwise() - m_center_of_mass );
+}
+
+RigidBodyClump::RigidBodyClump( std::istream& input_stream )
+: m_centers( MathUtilities::deserialize<Matrix3Xsc>( input_stream ) )
+, m_radii( MathUtilities::deserialize<VectorXs>( input_stream ) )
+, m_volume( Utilities::deserialize<scalar>( input_stream ) )
+, m_I_on_rho( MathUtilities::deserialize<Vector3s>( input_stream ) )
+, m_center_of_mass( MathUtilities::deserialize<Vector3s>( input_stream ) )
+, m_R( MathUtilities::deserialize<Matrix3s>( input_stream ) )
+{
+  assert( m_centers.cols() > 0 );
+  assert( m_centers.cols() == m_radii.size() );
+  assert( m_volume > 0.0 );
+}
+
+RigidBodyClump::~RigidBodyClump()
+{}
+
+RigidBodyGeometryType RigidBodyClump::getType() const
+{
+  return RigidBodyGeometryType::CLUMP;
+}
+
+std::unique_ptr<RigidBodyGeometry> RigidBodyClump::clone() const
+{
+  return std::unique_ptr<RigidBodyGeometry>{ new RigidBodyClump{ *this } };
+}
+
+void RigidBodyClump::computeAABB( const Vector3s& cm, const Matrix33sr& R, Array3s& min, Array3s& max ) const
+{
+  const Matrix3Xsc x{ ( R * m_centers ).colwise() + cm };
+  min = ( x.array().rowwise() - m_radii.array().transpose() ).rowwise().minCoeff();
+  max = ( x.array().rowwise() + m_radii.array().transpose() ).rowwise().maxCoeff();
+  assert( ( min < max ).all() );
+}
+
+void RigidBodyClump::computeMassAndInertia( const scalar& density, scalar& M, Vector3s& CM, Vector3s& I, Matrix33sr& R ) const
+{
+  assert( density > 0.0 );
+  M = density * m_volume;
+  CM = m_center_of_mass;
+  I = density * m_I_on_rho;
+  R = m_R;
+}
+
+std::string RigidBodyClump::name() const
+{
+  return "clump";
+}
+
+void RigidBodyClump::serialize( std::ostream& output_stream ) const
+{
+  assert( output_stream.good() );
+  Utilities::serialize( RigidBodyGeometryType::CLUMP, output_stream );
+  MathUtilities::serialize( m_centers, output_stream );
+  MathUtilities::serialize( m_radii, output_stream );
+  Utilities::serialize( m_volume, output_stream );
+  MathUtilities::serialize( m_I_on_rho, output_stream );
+  MathUtilities::serialize( m_center_of_mass, output_stream );
+  MathUtilities::serialize( m_R, output_stream );
+}
+
+scalar RigidBodyClump::volume() const
+{
+  return m_volume;
+}
+
+unsigned RigidBodyClump::numSpheres() const
+{
+  return unsigned( m_radii.size() );
+}
+
+const Matrix3Xsc& RigidBodyClump::centers() const
+{
+  return m_centers;
+}
+
+const VectorXs& RigidBodyClump::radii() const
+{
+  return m_radii;
+}
@@ -0,0 +1,59 @@
+// RigidBodyClump.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Rigid clump of possibly overlapping spheres, the usual stand in for non-spherical grains. Contacts are found
+// between member spheres, so clumps avoid the signed distance fields of triangle meshes. Mass properties are
+// integrated over the union of the spheres, so overlapping volume counts once.
+
+#ifndef RIGID_BODY_CLUMP_H
+#define RIGID_BODY_CLUMP_H
+
+#include "RigidBodyGeometry.h"
+
+class RigidBodyClump final : public RigidBodyGeometry
+{
+
+public:
+
+  // centers: center of each sphere in the input frame
+  // radii: radius of each sphere
+  RigidBodyClump( const Matrix3Xsc& centers, const VectorXs& radii );
+  explicit RigidBodyClump( std::istream& input_stream );
+  virtual ~RigidBodyClump() override;
+
+  virtual RigidBodyGeometryType getType() const override;
+
+  virtual std::unique_ptr<RigidBodyGeometry> clone() const override;
+
+  virtual void computeAABB( const Vector3s& cm, const Matrix33sr& R, Array3s& min, Array3s& max ) const override;
+
+  virtual void computeMassAndInertia( const scalar& density, scalar& M, Vector3s& CM, Vector3s& I, Matrix33sr& R ) const override;
+
+  virtual std::string name() const override;
+
+  virtual void serialize( std::ostream& output_stream ) const override;
+
+  virtual scalar volume() const override;
+
+  unsigned numSpheres() const;
+
+  // Centers of the spheres in the principal frame of the body
+  const Matrix3Xsc& centers() const;
+
+  const VectorXs& radii() const;
+
+private:
+
+  Matrix3Xsc m_centers;
+  VectorXs m_radii;
+
+  scalar m_volume;
+  Vector3s m_I_on_rho;
+  Vector3s m_center_of_mass;
+  Matrix3s m_R;
+
+};
+
+#endif
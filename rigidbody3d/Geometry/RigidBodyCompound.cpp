@@ -0,0 +1,369 @@
+// RigidBodyCompound.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "RigidBodyCompound.h"
+
+#include "MomentTools.h"
+#include "RigidBodyBox.h"
+#include "RigidBodyCapsule.h"
+#include "RigidBodySphere.h"
+
+#include "scisim/Math/MathUtilities.h"
+#include "scisim/Utilities.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#ifndef NDEBUG
+static bool isCompoundChildType( const RigidBodyGeometryType type )
+{
+  return type == RigidBodyGeometryType::SPHERE || type == RigidBodyGeometryType::CAPSULE || type == RigidBodyGeometryType::BOX;
+}
+#endif
+
+static std::unique_ptr<RigidBodyGeometry> deserializeChild( std::istream& input_stream )
+{
+  const RigidBodyGeometryType geo_type{ Utilities::deserialize<RigidBodyGeometryType>( input_stream ) };
+  switch( geo_type )
+  {
+    case RigidBodyGeometryType::BOX:
+      return std::unique_ptr<RigidBodyGeometry>{ new RigidBodyBox{ input_stream } };
+    case RigidBodyGeometryType::SPHERE:
+      return std::unique_ptr<RigidBodyGeometry>{ new RigidBodySphere{ input_stream } };
+    case RigidBodyGeometryType::CAPSULE:
+      return std::unique_ptr<RigidBodyGeometry>{ new RigidBodyCapsule{ input_stream } };
+    case RigidBodyGeometryType::STAPLE:
+    case RigidBodyGeometryType::TRIANGLE_MESH:
+    case RigidBodyGeometryType::CONVEX_POLYHEDRON:
+    case RigidBodyGeometryType::COMPOUND:
+    case RigidBodyGeometryType::CLUMP:
+      break;
+  }
+  std::cerr << "Invalid child geometry type in RigidBodyCompound deserialization. Exiting." << std::endl;
+  std::exit( EXIT_FAILURE );
+}
+
+// Interval [z0, z1] of the line along z through (x, y) inside a child centered at c with orientation R
+static bool sphereInterval( const scalar& r, const Vector3s& c, const scalar& x, const scalar& y, scalar& z0, scalar& z1 )
+{
+  const scalar h2{ r * r - ( x - c.x() ) * ( x - c.x() ) - ( y - c.y() ) * ( y - c.y() ) };
+  if( h2 <= 0.0 )
+  {
+    return false;
+  }
+  const scalar h{ sqrt( h2 ) };
+  z0 = c.z() - h;
+  z1 = c.z() + h;
+  return true;
+}
+
+static bool boxInterval( const Vector3s& half_widths, const Vector3s& c, const Matrix33sr& R, const scalar& x, const scalar& y, scalar& z0, scalar& z1 )
+{
+  // The line in the frame of the box, clipped against each pair of faces
+  const Vector3s origin{ R.transpose() * Vector3s{ x - c.x(), y - c.y(), -c.z() } };
+  const Vector3s direction{ R.row( 2 ).transpose() };
+  z0 = -SCALAR_INFINITY;
+  z1 = SCALAR_INFINITY;
+  for( unsigned axis = 0; axis < 3; ++axis )
+  {
+    if( fabs( direction( axis ) ) <= 1.0e-12 )
+    {
+      if( fabs( origin( axis ) ) > half_widths( axis ) )
+      {
+        return false;
+      }
+      continue;
+    }
+    const scalar t0{ ( -half_widths( axis ) - origin( axis ) ) / direction( axis ) };
+    const scalar t1{ ( half_widths( axis ) - origin( axis ) ) / direction( axis ) };
+    z0 = std::max( z0, std::min( t0, t1 ) );
+    z1 = std::min( z1, std::max( t0, t1 ) );
+  }
+  return z0 < z1;
+}
+
+static bool capsuleInterval( const scalar& r, const scalar& h, const Vector3s& c, const Matrix33sr& R, const scalar& x, const scalar& y, scalar& z0, scalar& z1 )
+{
+  // A capsule is convex, so the line crosses it in the hull of the intervals crossing its caps and its cylinder
+  const Vector3s axis{ R.col( 0 ) };
+  z0 = SCALAR_INFINITY;
+  z1 = -SCALAR_INFINITY;
+  scalar cap_z0;
+  scalar cap_z1;
+  for( const scalar& side : { -1.0, 1.0 } )
+  {
+    if( sphereInterval( r, c + side * h * axis, x, y, cap_z0, cap_z1 ) )
+    {
+      z0 = std::min( z0, cap_z0 );
+      z1 = std::max( z1, cap_z1 );
+    }
+  }
+
+  // Within the cylinder, the part of the line orthogonal to the axis is within r of it
+  const Vector3s origin{ x - c.x(), y - c.y(), -c.z() };
+  const scalar origin_along{ origin.dot( axis ) };
+  const Vector3s origin_radial{ origin - origin_along * axis };
+  const Vector3s direction_radial{ Vector3s::UnitZ() - axis.z() * axis };
+  const scalar A{ direction_radial.squaredNorm() };
+  const scalar B{ origin_radial.dot( direction_radial ) };
+  const scalar C{ origin_radial.squaredNorm() - r * r };
+  // A line parallel to the axis passes through the caps wherever it crosses the cylinder
+  if( A > 1.0e-12 && B * B - A * C > 0.0 )
+  {
+    const scalar root{ sqrt( B * B - A * C ) };
+    scalar t0{ ( -B - root ) / A };
+    scalar t1{ ( -B + root ) / A };
+    // Clip to the extent of the cylinder along the axis
+    if( fabs( axis.z() ) > 1.0e-12 )
+    {
+      const scalar s0{ ( -h - origin_along ) / axis.z() };
+      const scalar s1{ ( h - origin_along ) / axis.z() };
+      t0 = std::max( t0, std::min( s0, s1 ) );
+      t1 = std::min( t1, std::max( s0, s1 ) );
+    }
+    else if( fabs( origin_along ) > h )
+    {
+      t1 = t0;
+    }
+    if( t0 < t1 )
+    {
+      z0 = std::min( z0, t0 );
+      z1 = std::max( z1, t1 );
+    }
+  }
+  return z0 < z1;
+}
+
+static bool childInterval( const RigidBodyGeometry& child, const Vector3s& c, const Matrix33sr& R, const scalar& x, const scalar& y, scalar& z0, scalar& z1 )
+{
+  switch( child.getType() )
+  {
+    case RigidBodyGeometryType::SPHERE:
+      return sphereInterval( static_cast<const RigidBodySphere&>( child ).r(), c, x, y, z0, z1 );
+    case RigidBodyGeometryType::BOX:
+      return boxInterval( static_cast<const RigidBodyBox&>( child ).halfWidths(), c, R, x, y, z0, z1 );
+    case RigidBodyGeometryType::CAPSULE:
+      return capsuleInterval( static_cast<const RigidBodyCapsule&>( child ).r(), static_cast<const RigidBodyCapsule&>( child ).halfLength(), c, R, x, y, z0, z1 );
+    case RigidBodyGeometryType::STAPLE:
+    case RigidBodyGeometryType::TRIANGLE_MESH:
+    case RigidBodyGeometryType::CONVEX_POLYHEDRON:
+    case RigidBodyGeometryType::COMPOUND:
+    case RigidBodyGeometryType::CLUMP:
+      break;
+  }
+  std::cerr << "Invalid child geometry type in RigidBodyCompound. Exiting." << std::endl;
+  std::exit( EXIT_FAILURE );
+}
+
+RigidBodyCompound::RigidBodyCompound( std::vector<std::unique_ptr<RigidBodyGeometry>> children, const Matrix3Xsc& positions, const std::vector<Matrix33sr>& orientations )
+: m_children( std::move( children ) )
+, m_child_positions()
+, m_child_orientations()
+, m_volume( 0.0 )
+, m_I_on_rho()
+, m_center_of_mass( Vector3s::Zero() )
+, m_R()
+{
+  assert( !m_children.empty() );
+  assert( positions.cols() == int( m_children.size() ) );
+  assert( orientations.size() == m_children.size() );
+
+  // Exact moments of the children about the origin per unit density, counting the volume where children overlap
+  // once per child
+  Vector3s first_moments{ Vector3s::Zero() };
+  Matrix3s second_moments{ Matrix3s::Zero() };
+  Matrix3Xsc child_min{ 3, static_cast<Matrix3Xsc::Index>( m_children.size() ) };
+  Matrix3Xsc child_max{ 3, static_cast<Matrix3Xsc::Index>( m_children.size() ) };
+  for( std::vector<std::unique_ptr<RigidBodyGeometry>>::size_type child_idx = 0; child_idx < m_children.size(); ++child_idx )
+  {
+    assert( isCompoundChildType( m_children[child_idx]->getType() ) );
+    scalar M;
+    Vector3s CM;
+    Vector3s I;
+    Matrix33sr R;
+    m_children[child_idx]->computeMassAndInertia( 1.0, M, CM, I, R );
+    const Matrix33sr R_child{ orientations[child_idx] * R };
+    const Vector3s center{ positions.col( child_idx ) + orientations[child_idx] * CM };
+    // Second moments of the child about its own center of mass, from its principal moments of inertia
+    const Vector3s principal_second_moments{ 0.5 * I.sum() * Vector3s::Ones() - I };
+    m_volume += M;
+    first_moments += M * center;
+    second_moments += R_child * principal_second_moments.asDiagonal() * R_child.transpose() + M * center * center.transpose();
+
+    Array3s min;
+    Array3s max;
+    m_children[child_idx]->computeAABB( positions.col( child_idx ), orientations[child_idx], min, max );
+    child_min.col( child_idx ) = min;
+    child_max.col( child_idx ) = max;
+  }
+
+  // Remove the overlapping volume counted more than once
+  {
+    scalar overlap_volume;
+    Vector3s overlap_first_moments;
+    Matrix3s overlap_second_moments;
+    MomentTools::integrateOverlap( child_min, child_max, [this, &positions, &orientations]( const unsigned child_idx, const scalar& x, const scalar& y, scalar& z0, scalar& z1 )
+      {
+        return childInterval( *m_children[child_idx], positions.col( child_idx ), orientations[child_idx], x, y, z0, z1 );
+      }, overlap_volume, overlap_first_moments, overlap_second_moments );
+    m_volume -= overlap_volume;
+    first_moments -= overlap_first_moments;
+    second_moments -= overlap_second_moments;
+  }
+  assert( m_volume > 0.0 );
+  m_center_of_mass = first_moments / m_volume;
+
+  // Second moments about the center of mass give the inertia tensor
+  const Matrix3s C{ second_moments - m_volume * m_center_of_mass * m_center_of_mass.transpose() };
+  const Matrix3s I_total{ C.trace() * Matrix3s::Identity() - C };
+  MomentTools::diagonalizeInertiaTensor( I_total, m_R, m_I_on_rho );
+
+  // Express the children in the principal frame
+  m_child_positions = m_R.transpose() * ( positions.colwise() - m_center_of_mass );
+  m_child_orientations.resize( orientations.size() );
+  for( std::vector<Matrix33sr>::size_type child_idx = 0; child_idx < orientations.size(); ++child_idx )
+  {
+    m_child_orientations[child_idx] = m_R.transpose() * orientations[child_idx];
+  }
+}
+
+RigidBodyCompound::RigidBodyCompound( std::istream& input_stream )
+: m_children()
+, m_child_positions()
+, m_child_orientations()
+, m_volume()
+, m_I_on_rho()
+, m_center_of_mass()
+, m_R()
+{
+  const std::vector<std::unique_ptr<RigidBodyGeometry>>::size_type nchildren{ Utilities::deserialize<std::vector<std::unique_ptr<RigidBodyGeometry>>::size_type>( input_stream ) };
+  m_child_positions.resize( 3, nchildren );
+  m_child_orientations.resize( nchildren );
+  for( std::vector<std::unique_ptr<RigidBodyGeometry>>::size_type child_idx = 0; child_idx < nchildren; ++child_idx )
+  {
+    m_child_positions.col( child_idx ) = MathUtilities::deserialize<Vector3s>( input_stream );
+    m_child_orientations[child_idx] = MathUtilities::deserialize<Matrix33sr>( input_stream );
+    m_children.emplace_back( deserializeChild( input_stream ) );
+  }
+  m_volume = Utilities::deserialize<scalar>( input_stream );
+  m_I_on_rho = MathUtilities::deserialize<Vector3s>( input_stream );
+  m_center_of_mass = MathUtilities::deserialize<Vector3s>( input_stream );
+  m_R = MathUtilities::deserialize<Matrix3s>( input_stream );
+  assert( !m_children.empty() );
+  assert( m_volume > 0.0 );
+}
+
+RigidBodyCompound::RigidBodyCompound( const RigidBodyCompound& other )
+: m_children()
+, m_child_positions( other.m_child_positions )
+, m_child_orientations( other.m_child_orientations )
+, m_volume( other.m_volume )
+, m_I_on_rho( other.m_I_on_rho )
+, m_center_of_mass( other.m_center_of_mass )
+, m_R( other.m_R )
+{
+  for( const std::unique_ptr<RigidBodyGeometry>& child : other.m_children )
+  {
+    m_children.emplace_back( child->clone() );
+  }
+}
+
+RigidBodyCompound::~RigidBodyCompound()
+{}
+
+RigidBodyGeometryType RigidBodyCompound::getType() const
+{
+  return RigidBodyGeometryType::COMPOUND;
+}
+
+std::unique_ptr<RigidBodyGeometry> RigidBodyCompound::clone() const
+{
+  return std::unique_ptr<RigidBodyGeometry>{ new RigidBodyCompound{ *this } };
+}
+
+void RigidBodyCompound::computeAABB( const Vector3s& cm, const Matrix33sr& R, Array3s& min, Array3s& max ) const
+{
+  min.setConstant( SCALAR_INFINITY );
+  max.setConstant( -SCALAR_INFINITY );
+  for( unsigned child_idx = 0; child_idx < numChildren(); ++child_idx )
+  {
+    Vector3s x;
+    Matrix33sr Rc;
+    childPose( child_idx, cm, R, x, Rc );
+    Array3s child_min;
+    Array3s child_max;
+    m_children[child_idx]->computeAABB( x, Rc, child_min, child_max );
+    min = min.min( child_min );
+    max = max.max( child_max );
+  }
+  assert( ( min < max ).all() );
+}
+
+void RigidBodyCompound::computeMassAndInertia( const scalar& density, scalar& M, Vector3s& CM, Vector3s& I, Matrix33sr& R ) const
+{
+  assert( density > 0.0 );
+  M = density * m_volume;
+  CM = m_center_of_mass;
+  I = density * m_I_on_rho;
+  R = m_R;
+}
+
+std::string RigidBodyCompound::name() const
+{
+  return "compound";
+}
+
+void RigidBodyCompound::serialize( std::ostream& output_stream ) const
+{
+  assert( output_stream.good() );
+  Utilities::serialize( RigidBodyGeometryType::COMPOUND, output_stream );
+  Utilities::serialize( m_children.size(), output_stream );
+  for( std::vector<std::unique_ptr<RigidBodyGeometry>>::size_type child_idx = 0; child_idx < m_children.size(); ++child_idx )
+  {
+    MathUtilities::serialize( m_child_positions.col( child_idx ), output_stream );
+    MathUtilities::serialize( m_child_orientations[child_idx], output_stream );
+    m_children[child_idx]->serialize( output_stream );
+  }
+  Utilities::serialize( m_volume, output_stream );
+  MathUtilities::serialize( m_I_on_rho, output_stream );
+  MathUtilities::serialize( m_center_of_mass, output_stream );
+  MathUtilities::serialize( m_R, output_stream );
+}
+
+scalar RigidBodyCompound::volume() const
+{
+  return m_volume;
+}
+
+unsigned RigidBodyCompound::numChildren() const
+{
+  return unsigned( m_children.size() );
+}
+
+const RigidBodyGeometry& RigidBodyCompound::child( const unsigned child_idx ) const
+{
+  assert( child_idx < m_children.size() );
+  return *m_children[child_idx];
+}
+
+Vector3s RigidBodyCompound::childPosition( const unsigned child_idx ) const
+{
+  assert( child_idx < m_children.size() );
+  return m_child_positions.col( child_idx );
+}
+
+const Matrix33sr& RigidBodyCompound::childOrientation( const unsigned child_idx ) const
+{
+  assert( child_idx < m_children.size() );
+  return m_child_orientations[child_idx];
+}
+
+void RigidBodyCompound::childPose( const unsigned child_idx, const Vector3s& cm, const Matrix33sr& R, Vector3s& x, Matrix33sr& Rc ) const
+{
+  assert( child_idx < m_children.size() );
+  x = cm + R * m_child_positions.col( child_idx );
+  Rc = R * m_child_orientations[child_idx];
+}
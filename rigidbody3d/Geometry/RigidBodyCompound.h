@@ -0,0 +1,69 @@
+// RigidBodyCompound.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Rigid union of spheres, capsules and boxes. Each child keeps its own geometry and a pose in the principal frame
+// of the compound, so collision detection can cull pairs of children with their own bounding boxes and then reuse
+// the narrow phase of the primitives. Mass properties sum those of the children less the volume where children
+// overlap, integrated as for clumps, so overlapping volume counts once.
+
+#ifndef RIGID_BODY_COMPOUND_H
+#define RIGID_BODY_COMPOUND_H
+
+#include "RigidBodyGeometry.h"
+
+#include <vector>
+
+class RigidBodyCompound final : public RigidBodyGeometry
+{
+
+public:
+
+  // children: spheres, capsules and boxes
+  // positions: center of each child in the input frame
+  // orientations: rotation of each child in the input frame
+  RigidBodyCompound( std::vector<std::unique_ptr<RigidBodyGeometry>> children, const Matrix3Xsc& positions, const std::vector<Matrix33sr>& orientations );
+  explicit RigidBodyCompound( std::istream& input_stream );
+  RigidBodyCompound( const RigidBodyCompound& other );
+  virtual ~RigidBodyCompound() override;
+
+  virtual RigidBodyGeometryType getType() const override;
+
+  virtual std::unique_ptr<RigidBodyGeometry> clone() const override;
+
+  virtual void computeAABB( const Vector3s& cm, const Matrix33sr& R, Array3s& min, Array3s& max ) const override;
+
+  virtual void computeMassAndInertia( const scalar& density, scalar& M, Vector3s& CM, Vector3s& I, Matrix33sr& R ) const override;
+
+  virtual std::string name() const override;
+
+  virtual void serialize( std::ostream& output_stream ) const override;
+
+  virtual scalar volume() const override;
+
+  unsigned numChildren() const;
+
+  const RigidBodyGeometry& child( const unsigned child_idx ) const;
+
+  // Pose of a child in the principal frame of the body
+  Vector3s childPosition( const unsigned child_idx ) const;
+  const Matrix33sr& childOrientation( const unsigned child_idx ) const;
+
+  // Pose of a child for a body at center of mass cm with orientation R
+  void childPose( const unsigned child_idx, const Vector3s& cm, const Matrix33sr& R, Vector3s& x, Matrix33sr& Rc ) const;
+
+private:
+
+  std::vector<std::unique_ptr<RigidBodyGeometry>> m_children;
+  Matrix3Xsc m_child_positions;
+  std::vector<Matrix33sr> m_child_orientations;
+
+  scalar m_volume;
+  Vector3s m_I_on_rho;
+  Vector3s m_center_of_mass;
+  Matrix3s m_R;
+
+};
+
+#endif
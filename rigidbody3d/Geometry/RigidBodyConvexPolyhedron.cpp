@@ -0,0 +1,181 @@
+// RigidBodyConvexPolyhedron.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "RigidBodyConvexPolyhedron.h"
+
+#include "MomentTools.h"
+
+#include "scisim/Math/MathUtilities.h"
+#include "scisim/Utilities.h"
+
+#include <string>
+
+// Distance, relative to the size of the hull, that a vertex may lie in front of a face plane
+static constexpr scalar HULL_TOLERANCE{ 1.0e-6 };
+
+RigidBodyConvexPolyhedron::RigidBodyConvexPolyhedron( const Matrix3Xsc& vertices, const Matrix3Xuc& faces )
+: m_vertices()
+, m_faces( faces )
+, m_volume()
+, m_I_on_rho()
+, m_center_of_mass()
+, m_R()
+, m_face_normals()
+, m_face_offsets()
+{
+  assert( validateHull( vertices, m_faces ).empty() );
+
+  MomentTools::computeMoments( vertices, m_faces, m_volume, m_I_on_rho, m_center_of_mass, m_R );
+  assert( m_volume > 0.0 );
+
+  // Express the vertices in the principal frame
+  m_vertices = m_R.transpose() * ( vertices.colwise() - m_center_of_mass );
+
+  computeFacePlanes();
+}
+
+RigidBodyConvexPolyhedron::RigidBodyConvexPolyhedron( std::istream& input_stream )
+: m_vertices( MathUtilities::deserialize<Matrix3Xsc>( input_stream ) )
+, m_faces( MathUtilities::deserialize<Matrix3Xuc>( input_stream ) )
+, m_volume( Utilities::deserialize<scalar>( input_stream ) )
+, m_I_on_rho( MathUtilities::deserialize<Vector3s>( input_stream ) )
+, m_center_of_mass( MathUtilities::deserialize<Vector3s>( input_stream ) )
+, m_R( MathUtilities::deserialize<Matrix3s>( input_stream ) )
+, m_face_normals()
+, m_face_offsets()
+{
+  assert( ( m_faces.array() < unsigned( m_vertices.cols() ) ).all() );
+  assert( m_volume > 0.0 );
+  computeFacePlanes();
+}
+
+RigidBodyConvexPolyhedron::~RigidBodyConvexPolyhedron()
+{}
+
+RigidBodyGeometryType RigidBodyConvexPolyhedron::getType() const
+{
+  return RigidBodyGeometryType::CONVEX_POLYHEDRON;
+}
+
+std::unique_ptr<RigidBodyGeometry> RigidBodyConvexPolyhedron::clone() const
+{
+  return std::unique_ptr<RigidBodyGeometry>{ new RigidBodyConvexPolyhedron{ *this } };
+}
+
+void RigidBodyConvexPolyhedron::computeAABB( const Vector3s& cm, const Matrix33sr& R, Array3s& min, Array3s& max ) const
+{
+  const Matrix3Xsc transformed_vertices{ ( R * m_vertices ).colwise() + cm };
+  min = transformed_vertices.rowwise().minCoeff().array();
+  max = transformed_vertices.rowwise().maxCoeff().array();
+  assert( ( min <= max ).all() );
+}
+
+void RigidBodyConvexPolyhedron::computeMassAndInertia( const scalar& density, scalar& M, Vector3s& CM, Vector3s& I, Matrix33sr& R ) const
+{
+  assert( density > 0.0 );
+  M = density * m_volume;
+  CM = m_center_of_mass;
+  I = density * m_I_on_rho;
+  R = m_R;
+}
+
+std::string RigidBodyConvexPolyhedron::name() const
+{
+  return "convex_polyhedron";
+}
+
+void RigidBodyConvexPolyhedron::serialize( std::ostream& output_stream ) const
+{
+  assert( output_stream.good() );
+  Utilities::serialize( RigidBodyGeometryType::CONVEX_POLYHEDRON, output_stream );
+  MathUtilities::serialize( m_vertices, output_stream );
+  MathUtilities::serialize( m_faces, output_stream );
+  Utilities::serialize( m_volume, output_stream );
+  MathUtilities::serialize( m_I_on_rho, output_stream );
+  MathUtilities::serialize( m_center_of_mass, output_stream );
+  MathUtilities::serialize( m_R, output_stream );
+}
+
+scalar RigidBodyConvexPolyhedron::volume() const
+{
+  return m_volume;
+}
+
+std::string RigidBodyConvexPolyhedron::validateHull( const Matrix3Xsc& vertices, const Matrix3Xuc& faces )
+{
+  if( vertices.cols() < 4 || faces.cols() < 4 )
+  {
+    return "a closed hull needs at least four vertices and four faces";
+  }
+  if( !( faces.array() < unsigned( vertices.cols() ) ).all() )
+  {
+    return "faces index vertices that do not exist";
+  }
+
+  // Divergence theorem; faces wound clockwise enclose a negative volume
+  scalar volume{ 0.0 };
+  for( int fce = 0; fce < faces.cols(); ++fce )
+  {
+    volume += vertices.col( faces( 0, fce ) ).dot( vertices.col( faces( 1, fce ) ).cross( vertices.col( faces( 2, fce ) ) ) ) / 6.0;
+  }
+  if( !( volume > 0.0 ) )
+  {
+    return "faces enclose no volume, faces must be wound counter-clockwise about the outward normal";
+  }
+
+  const scalar tolerance{ HULL_TOLERANCE * ( 1.0 + vertices.lpNorm<Eigen::Infinity>() ) };
+  for( int fce = 0; fce < faces.cols(); ++fce )
+  {
+    const Vector3s v0{ vertices.col( faces( 0, fce ) ) };
+    const Vector3s normal{ ( vertices.col( faces( 1, fce ) ) - v0 ).cross( vertices.col( faces( 2, fce ) ) - v0 ) };
+    if( !( normal.norm() > 0.0 ) )
+    {
+      return "face " + std::to_string( fce ) + " has no area";
+    }
+    const Vector3s n{ normal.normalized() };
+    if( ( ( n.transpose() * vertices ).array() - n.dot( v0 ) ).maxCoeff() > tolerance )
+    {
+      return "vertices lie in front of face " + std::to_string( fce ) + ", the hull must be convex";
+    }
+  }
+
+  return {};
+}
+
+const Matrix3Xsc& RigidBodyConvexPolyhedron::vertices() const
+{
+  return m_vertices;
+}
+
+const Matrix3Xuc& RigidBodyConvexPolyhedron::faces() const
+{
+  return m_faces;
+}
+
+const Matrix3Xsc& RigidBodyConvexPolyhedron::faceNormals() const
+{
+  return m_face_normals;
+}
+
+const VectorXs& RigidBodyConvexPolyhedron::faceOffsets() const
+{
+  return m_face_offsets;
+}
+
+void RigidBodyConvexPolyhedron::computeFacePlanes()
+{
+  m_face_normals.resize( 3, m_faces.cols() );
+  m_face_offsets.resize( m_faces.cols() );
+  for( int fce = 0; fce < m_faces.cols(); ++fce )
+  {
+    const Vector3s v0{ m_vertices.col( m_faces( 0, fce ) ) };
+    const Vector3s v1{ m_vertices.col( m_faces( 1, fce ) ) };
+    const Vector3s v2{ m_vertices.col( m_faces( 2, fce ) ) };
+    m_face_normals.col( fce ) = ( v1 - v0 ).cross( v2 - v0 ).normalized();
+    m_face_offsets( fce ) = m_face_normals.col( fce ).dot( v0 );
+  }
+  // Every vertex should lie on or behind every face plane
+  assert( ( ( m_face_normals.transpose() * m_vertices ).colwise() - m_face_offsets ).maxCoeff() <= HULL_TOLERANCE * ( 1.0 + m_vertices.lpNorm<Eigen::Infinity>() ) );
+}
@@ -0,0 +1,70 @@
+// RigidBodyConvexPolyhedron.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Convex polyhedron given by a closed triangle mesh of its hull. Vertices are stored in the body's principal
+// frame along with the outward plane of each face, so contact generation only needs the support mapping of
+// the vertices and a point-in-polyhedron test against the face planes.
+
+#ifndef RIGID_BODY_CONVEX_POLYHEDRON_H
+#define RIGID_BODY_CONVEX_POLYHEDRON_H
+
+#include "RigidBodyGeometry.h"
+
+class RigidBodyConvexPolyhedron final : public RigidBodyGeometry
+{
+
+public:
+
+  // Faces must be wound counter-clockwise about the outward normal
+  RigidBodyConvexPolyhedron( const Matrix3Xsc& vertices, const Matrix3Xuc& faces );
+  explicit RigidBodyConvexPolyhedron( std::istream& input_stream );
+  virtual ~RigidBodyConvexPolyhedron() override;
+
+  virtual RigidBodyGeometryType getType() const override;
+
+  virtual std::unique_ptr<RigidBodyGeometry> clone() const override;
+
+  virtual void computeAABB( const Vector3s& cm, const Matrix33sr& R, Array3s& min, Array3s& max ) const override;
+
+  virtual void computeMassAndInertia( const scalar& density, scalar& M, Vector3s& CM, Vector3s& I, Matrix33sr& R ) const override;
+
+  virtual std::string name() const override;
+
+  virtual void serialize( std::ostream& output_stream ) const override;
+
+  virtual scalar volume() const override;
+
+  // Checks that faces index existing vertices, enclose a positive volume, and that every vertex lies on or
+  // behind every face plane. Returns a description of the first problem found, or an empty string.
+  static std::string validateHull( const Matrix3Xsc& vertices, const Matrix3Xuc& faces );
+
+  // Vertices in the principal frame of the body
+  const Matrix3Xsc& vertices() const;
+
+  const Matrix3Xuc& faces() const;
+
+  // Face planes in the principal frame, points x inside the polyhedron satisfy faceNormals().col( i ).dot( x ) <= faceOffsets()( i )
+  const Matrix3Xsc& faceNormals() const;
+  const VectorXs& faceOffsets() const;
+
+private:
+
+  void computeFacePlanes();
+
+  Matrix3Xsc m_vertices;
+  Matrix3Xuc m_faces;
+
+  scalar m_volume;
+  Vector3s m_I_on_rho;
+  Vector3s m_center_of_mass;
+  Matrix3s m_R;
+
+  // Derived from the vertices and faces and not serialized
+  Matrix3Xsc m_face_normals;
+  VectorXs m_face_offsets;
+
+};
+
+#endif
@@ -15,7 +15,11 @@ enum class RigidBodyGeometryType : std::uint8_t
   BOX,
   SPHERE,
   STAPLE,
-  TRIANGLE_MESH
+  TRIANGLE_MESH,
+  CONVEX_POLYHEDRON,
+  CAPSULE,
+  COMPOUND,
+  CLUMP
 };
 
 class RigidBodyGeometry
@@ -0,0 +1,143 @@
+// NativeScripting.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "NativeScripting.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <iostream>
+
+#include "scisim/StringUtilities.h"
+#include "scisim/Utilities.h"
+
+// Looks up an optional function exported by the plugin
+template<typename Function>
+static Function loadFunction( void* library, const char* function_name )
+{
+  assert( library != nullptr );
+  return reinterpret_cast<Function>( dlsym( library, function_name ) );
+}
+
+NativeScripting::NativeScripting( const std::string& path, const std::string& library_name )
+: m_path( path )
+, m_library_name( library_name )
+, m_library( nullptr )
+, m_start_of_sim( nullptr )
+, m_end_of_sim( nullptr )
+, m_start_of_step( nullptr )
+, m_end_of_step( nullptr )
+, m_restitution_coefficient( nullptr )
+, m_friction_coefficient( nullptr )
+, m_state( nullptr )
+, m_initial_iterate( nullptr )
+{
+  assert( !m_library_name.empty() );
+
+  // A name without a slash would be searched for on the library path rather than next to the scene
+  const std::string library_file_name{ m_library_name.front() == '/' ? m_library_name : ( m_path.empty() ? "." : m_path ) + "/" + m_library_name };
+  m_library = dlopen( library_file_name.c_str(), RTLD_NOW | RTLD_LOCAL );
+  if( m_library == nullptr )
+  {
+    std::cerr << "Failed to load scripting plugin " << library_file_name << ": " << dlerror() << ". Exiting." << std::endl;
+    std::exit( EXIT_FAILURE );
+  }
+
+  m_start_of_sim = loadFunction<StartOfSimFunction>( m_library, "startOfSim" );
+  m_end_of_sim = loadFunction<EndOfSimFunction>( m_library, "endOfSim" );
+  m_start_of_step = loadFunction<StepFunction>( m_library, "startOfStep" );
+  m_end_of_step = loadFunction<StepFunction>( m_library, "endOfStep" );
+  m_restitution_coefficient = loadFunction<CoefficientFunction>( m_library, "restitutionCoefficient" );
+  m_friction_coefficient = loadFunction<CoefficientFunction>( m_library, "frictionCoefficient" );
+}
+
+NativeScripting::~NativeScripting()
+{
+  if( m_library != nullptr )
+  {
+    dlclose( m_library );
+  }
+}
+
+void NativeScripting::setState( RigidBody3DState& state )
+{
+  m_state = &state;
+}
+
+void NativeScripting::setInitialIterate( unsigned& initial_iterate )
+{
+  m_initial_iterate = &initial_iterate;
+}
+
+void NativeScripting::forgetState()
+{
+  m_state = nullptr;
+  m_initial_iterate = nullptr;
+}
+
+void NativeScripting::serialize( std::ostream& output_stream )
+{
+  Utilities::serialize( RigidBody3DScriptingCallbackType::NATIVE_PLUGIN, output_stream );
+  StringUtilities::serialize( m_path, output_stream );
+  StringUtilities::serialize( m_library_name, output_stream );
+}
+
+void NativeScripting::restitutionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor )
+{
+  if( m_restitution_coefficient != nullptr )
+  {
+    m_restitution_coefficient( q, active_set, cor );
+  }
+}
+
+void NativeScripting::frictionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu )
+{
+  if( m_friction_coefficient != nullptr )
+  {
+    m_friction_coefficient( q, active_set, mu );
+  }
+}
+
+void NativeScripting::startOfSim()
+{
+  if( m_start_of_sim != nullptr )
+  {
+    assert( m_state != nullptr );
+    assert( m_initial_iterate != nullptr );
+    m_start_of_sim( *m_state, *m_initial_iterate );
+  }
+}
+
+void NativeScripting::endOfSim()
+{
+  if( m_end_of_sim != nullptr )
+  {
+    assert( m_state != nullptr );
+    m_end_of_sim( *m_state );
+  }
+}
+
+void NativeScripting::startOfStep( const unsigned next_iteration, const Rational<std::intmax_t>& dt )
+{
+  if( m_start_of_step != nullptr )
+  {
+    assert( m_state != nullptr );
+    m_start_of_step( *m_state, next_iteration, dt );
+  }
+}
+
+void NativeScripting::endOfStep( const unsigned next_iteration, const Rational<std::intmax_t>& dt )
+{
+  if( m_end_of_step != nullptr )
+  {
+    assert( m_state != nullptr );
+    m_end_of_step( *m_state, next_iteration, dt );
+  }
+}
+
+std::string NativeScripting::name() const
+{
+  return m_library_name;
+}
@@ -0,0 +1,77 @@
+// NativeScripting.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Scripting callbacks compiled into a shared library, for boundary conditions and emitters that must run
+// at native speed. The library is built against this tree's headers and may export any of the following
+// functions with C linkage; missing functions are skipped, as with Python callbacks:
+//
+//   void startOfSim( RigidBody3DState& state, unsigned& initial_iterate );
+//   void endOfSim( RigidBody3DState& state );
+//   void startOfStep( RigidBody3DState& state, const unsigned next_iteration, const Rational<std::intmax_t>& dt );
+//   void endOfStep( RigidBody3DState& state, const unsigned next_iteration, const Rational<std::intmax_t>& dt );
+//   void restitutionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor );
+//   void frictionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu );
+//
+// Only the library name is serialized, so any state a plugin keeps between calls is lost on resume.
+
+#ifndef NATIVE_SCRIPTING_H
+#define NATIVE_SCRIPTING_H
+
+#include "RigidBody3DScriptingCallback.h"
+
+#include <cstdint>
+
+class NativeScripting final : public RigidBody3DScriptingCallback
+{
+
+public:
+
+  using StartOfSimFunction = void (*)( RigidBody3DState&, unsigned& );
+  using EndOfSimFunction = void (*)( RigidBody3DState& );
+  using StepFunction = void (*)( RigidBody3DState&, const unsigned, const Rational<std::intmax_t>& );
+  using CoefficientFunction = void (*)( const VectorXs&, const std::vector<std::unique_ptr<Constraint>>&, VectorXs& );
+
+  // Loads library_name from path, unless library_name is an absolute path
+  NativeScripting( const std::string& path, const std::string& library_name );
+
+  virtual ~NativeScripting() override;
+
+  virtual void setState( RigidBody3DState& state ) override;
+  virtual void setInitialIterate( unsigned& initial_iterate ) override;
+  virtual void forgetState() override;
+
+  virtual void serialize( std::ostream& output_stream ) override;
+
+private:
+
+  virtual void restitutionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor ) override;
+
+  virtual void frictionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu ) override;
+
+  virtual void startOfSim() override;
+
+  virtual void endOfSim() override;
+
+  virtual void startOfStep( const unsigned next_iteration, const Rational<std::intmax_t>& dt ) override;
+
+  virtual void endOfStep( const unsigned next_iteration, const Rational<std::intmax_t>& dt ) override;
+
+  virtual std::string name() const override;
+
+  std::string m_path;
+  std::string m_library_name;
+  void* m_library;
+  StartOfSimFunction m_start_of_sim;
+  EndOfSimFunction m_end_of_sim;
+  StepFunction m_start_of_step;
+  StepFunction m_end_of_step;
+  CoefficientFunction m_restitution_coefficient;
+  CoefficientFunction m_friction_coefficient;
+  RigidBody3DState* m_state;
+  unsigned* m_initial_iterate;
+
+};
+
+#endif
@@ -8,11 +8,28 @@
 #ifdef USE_PYTHON
 #define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
 #include <numpy/arrayobject.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <typeinfo>
 #include "scisim/Math/Rational.h"
 #include "scisim/Constraints/Constraint.h"
 #include "scisim/PythonTools.h"
 #include "rigidbody3d/RigidBody3DState.h"
 #include "rigidbody3d/Forces/NearEarthGravityForce.h"
+#include "rigidbody3d/Constraints/BodyBodyConstraint.h"
+#include "rigidbody3d/Constraints/KinematicObjectBodyConstraint.h"
+#include "rigidbody3d/Constraints/KinematicObjectSphereConstraint.h"
+#include "rigidbody3d/Constraints/SphereBodyConstraint.h"
+#include "rigidbody3d/Constraints/SphereSphereConstraint.h"
+#include "rigidbody3d/Constraints/StaticCylinderBodyConstraint.h"
+#include "rigidbody3d/Constraints/StaticCylinderSphereConstraint.h"
+#include "rigidbody3d/Constraints/StaticMeshBodyConstraint.h"
+#include "rigidbody3d/Constraints/StaticPlaneBodyConstraint.h"
+#include "rigidbody3d/Constraints/StaticPlaneBoxConstraint.h"
+#include "rigidbody3d/Constraints/StaticPlaneSphereConstraint.h"
+#include "rigidbody3d/Constraints/TeleportedSphereSphereConstraint.h"
 #include "scisim/Utilities.h"
 #include "StaticGeometry/StaticCylinder.h"
 #include "StaticGeometry/StaticPlane.h"
@@ -29,6 +46,11 @@ static unsigned* s_initial_iterate;
 static VectorXs* s_mu;
 static VectorXs* s_cor;
 static const std::vector<std::unique_ptr<Constraint>>* s_active_set;
+static const VectorXs* s_q;
+
+// Version of the state layout viewed by the running callback. Versions are never reused, so a change of
+// scripting instance always invalidates the views.
+static unsigned s_state_version;
 #endif
 
 PythonScripting::PythonScripting()
@@ -42,6 +64,8 @@ PythonScripting::PythonScripting()
 , m_loaded_end_of_step_callback( nullptr )
 , m_loaded_friction_coefficient_callback( nullptr )
 , m_loaded_restitution_coefficient_callback( nullptr )
+, m_state_version( 0 )
+, m_state_layout()
 #endif
 {}
 
@@ -56,6 +80,8 @@ PythonScripting::PythonScripting( const std::string& path, const std::string& mo
 , m_loaded_end_of_step_callback( nullptr )
 , m_loaded_friction_coefficient_callback( nullptr )
 , m_loaded_restitution_coefficient_callback( nullptr )
+, m_state_version( 0 )
+, m_state_layout()
 #endif
 {
   intializePythonCallbacks();
@@ -72,6 +98,8 @@ PythonScripting::PythonScripting( std::istream& input_stream )
 , m_loaded_end_of_step_callback( nullptr )
 , m_loaded_friction_coefficient_callback( nullptr )
 , m_loaded_restitution_coefficient_callback( nullptr )
+, m_state_version( 0 )
+, m_state_layout()
 #endif
 {
   intializePythonCallbacks();
@@ -136,10 +164,38 @@ void swap( PythonScripting& first, PythonScripting& second )
   swap( first.m_loaded_end_of_step_callback, second.m_loaded_end_of_step_callback );
   swap( first.m_loaded_friction_coefficient_callback, second.m_loaded_friction_coefficient_callback );
   swap( first.m_loaded_restitution_coefficient_callback, second.m_loaded_restitution_coefficient_callback );
+  swap( first.m_state_version, second.m_state_version );
+  swap( first.m_state_layout, second.m_state_layout );
   #endif
 }
 
-void PythonScripting::restitutionCoefficient( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor )
+#ifdef USE_PYTHON
+// Arrays handed to Python view the state's storage directly, so they are only valid until that storage is
+// reallocated. The state version changes whenever any viewed buffer moves or is resized. Only called right
+// before a callback runs, so simulations without a loaded module never touch this instance's layout.
+void PythonScripting::updateStateVersion()
+{
+  if( s_sim_state != nullptr )
+  {
+    const std::vector<std::uintptr_t> layout{
+      std::uintptr_t( s_sim_state->q().data() ), std::uintptr_t( s_sim_state->q().size() ),
+      std::uintptr_t( s_sim_state->v().data() ), std::uintptr_t( s_sim_state->v().size() ),
+      std::uintptr_t( s_sim_state->M0().valuePtr() ), std::uintptr_t( s_sim_state->M0().nonZeros() ),
+      std::uintptr_t( s_sim_state->indices().data() ), std::uintptr_t( s_sim_state->indices().size() ),
+      std::uintptr_t( s_sim_state->staticPlanes().data() ), std::uintptr_t( s_sim_state->staticPlanes().size() ),
+      std::uintptr_t( s_sim_state->staticCylinders().data() ), std::uintptr_t( s_sim_state->staticCylinders().size() )
+    };
+    // Another instance's callback may have published a newer version since this one
+    if( layout != m_state_layout || m_state_version != s_state_version )
+    {
+      m_state_layout = layout;
+      m_state_version = ++s_state_version;
+    }
+  }
+}
+#endif
+
+void PythonScripting::restitutionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor )
 {
   #ifdef USE_PYTHON
   assert( !m_module_name.empty() );
@@ -151,6 +207,8 @@ void PythonScripting::restitutionCoefficient( const std::vector<std::unique_ptr<
   // Get data ready for Python
   s_cor = &cor;
   s_active_set = &active_set;
+  s_q = &q;
+  updateStateVersion();
   // Make the function call
   const PythonObject value{ PyObject_CallObject( m_loaded_restitution_coefficient_callback, nullptr ) };
   if( value == nullptr )
@@ -161,6 +219,7 @@ void PythonScripting::restitutionCoefficient( const std::vector<std::unique_ptr<
   }
   s_cor = nullptr;
   s_active_set = nullptr;
+  s_q = nullptr;
   assert( PyErr_Occurred() == nullptr );
   #else
   std::cerr << "PythonScripting::restitutionCoefficient must be compiled with Python support, exiting." << std::endl;
@@ -168,7 +227,7 @@ void PythonScripting::restitutionCoefficient( const std::vector<std::unique_ptr<
   #endif
 }
 
-void PythonScripting::frictionCoefficient( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu )
+void PythonScripting::frictionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu )
 {
   #ifdef USE_PYTHON
   assert( !m_module_name.empty() );
@@ -180,6 +239,8 @@ void PythonScripting::frictionCoefficient( const std::vector<std::unique_ptr<Con
   // Get data ready for Python
   s_mu = &mu;
   s_active_set = &active_set;
+  s_q = &q;
+  updateStateVersion();
   // Make the function call
   const PythonObject value{ PyObject_CallObject( m_loaded_friction_coefficient_callback, nullptr ) };
   if( value == nullptr )
@@ -190,6 +251,7 @@ void PythonScripting::frictionCoefficient( const std::vector<std::unique_ptr<Con
   }
   s_mu = nullptr;
   s_active_set = nullptr;
+  s_q = nullptr;
   assert( PyErr_Occurred() == nullptr );
   #else
   std::cerr << "PythonScripting::frictionCoefficient must be compiled with Python support, exiting." << std::endl;
@@ -206,6 +268,7 @@ void PythonScripting::startOfSim()
   {
     return;
   }
+  updateStateVersion();
   // Make the function call
   const PythonObject value{ PyObject_CallObject( m_loaded_start_of_sim_callback, nullptr ) };
   if( value == nullptr )
@@ -230,6 +293,7 @@ void PythonScripting::endOfSim()
   {
     return;
   }
+  updateStateVersion();
   // Make the function call
   const PythonObject value{ PyObject_CallObject( m_loaded_end_of_sim_callback, nullptr ) };
   if( value == nullptr )
@@ -257,6 +321,7 @@ void PythonScripting::startOfStep( const unsigned next_iteration, const Rational
   // Get data ready for Python
   s_timestep = scalar( dt );
   s_next_iteration = next_iteration;
+  updateStateVersion();
   // Make the function call
   const PythonObject value{ PyObject_CallObject( m_loaded_start_of_step_callback, nullptr ) };
   if( value == nullptr )
@@ -286,6 +351,7 @@ void PythonScripting::endOfStep( const unsigned next_iteration, const Rational<s
   // Get data ready for Python
   s_timestep = scalar( dt );
   s_next_iteration = next_iteration;
+  updateStateVersion();
   // Make the function call
   const PythonObject value{ PyObject_CallObject( m_loaded_end_of_step_callback, nullptr ) };
   if( value == nullptr )
@@ -311,7 +377,11 @@ std::string PythonScripting::name() const
 void PythonScripting::setState( RigidBody3DState& state )
 {
   #ifdef USE_PYTHON
-  s_sim_state = &state;
+  // Simulations without a module may run concurrently (e.g. sweeps), so they must not touch the shared pointers
+  if( m_loaded_module != nullptr )
+  {
+    s_sim_state = &state;
+  }
   #endif
   // No need to handle state cache if scripting is disabled
 }
@@ -319,7 +389,10 @@ void PythonScripting::setState( RigidBody3DState& state )
 void PythonScripting::setInitialIterate( unsigned& initial_iterate )
 {
   #ifdef USE_PYTHON
-  s_initial_iterate = &initial_iterate;
+  if( m_loaded_module != nullptr )
+  {
+    s_initial_iterate = &initial_iterate;
+  }
   #endif
   // No need to handle state cache if scripting is disabled
 }
@@ -327,14 +400,18 @@ void PythonScripting::setInitialIterate( unsigned& initial_iterate )
 void PythonScripting::forgetState()
 {
   #ifdef USE_PYTHON
-  s_sim_state = nullptr;
-  s_initial_iterate = nullptr;
+  if( m_loaded_module != nullptr )
+  {
+    s_sim_state = nullptr;
+    s_initial_iterate = nullptr;
+  }
   #endif
   // No need to handle state cache if scripting is disabled
 }
 
 void PythonScripting::serialize( std::ostream& output_stream )
 {
+  Utilities::serialize( RigidBody3DScriptingCallbackType::PYTHON, output_stream );
   StringUtilities::serialize( m_path, output_stream );
   StringUtilities::serialize( m_module_name, output_stream );
   // Python variables are re-initialized on deserializaiton, so no action needed here
@@ -375,6 +452,117 @@ static PyObject* velocity( PyObject* self, PyObject* args )
   return PyArray_SimpleNewFromData( 1, dims, (is_same<scalar,double>::value ? NPY_DOUBLE : NPY_FLOAT), s_sim_state->v().data() );
 }
 
+// Wraps storage owned by the simulation in a NumPy array without copying. Rows are row_stride bytes apart,
+// so members of a vector of objects can be viewed in place.
+static PyObject* scalarView( const npy_intp rows, const npy_intp cols, const npy_intp row_stride, const scalar* data, const bool writable )
+{
+  using std::is_same;
+  static_assert( is_same<scalar,double>::value || is_same<scalar,float>::value, "Error, scalar type must be double or float for Python interface." );
+  npy_intp dims[2] = { rows, cols };
+  npy_intp strides[2] = { row_stride, sizeof( scalar ) };
+  return PyArray_New( &PyArray_Type, cols == 1 ? 1 : 2, dims, (is_same<scalar,double>::value ? NPY_DOUBLE : NPY_FLOAT), strides, const_cast<scalar*>( data ), 0, writable ? NPY_ARRAY_ALIGNED | NPY_ARRAY_WRITEABLE : NPY_ARRAY_ALIGNED, nullptr );
+}
+
+static PyObject* stateVersion( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_sim_state != nullptr );
+  return Py_BuildValue( "I", s_state_version );
+}
+
+static PyObject* geometryIndices( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_sim_state != nullptr );
+  npy_intp dims[1] = { static_cast<npy_intp>( s_sim_state->indices().size() ) };
+  return PyArray_New( &PyArray_Type, 1, dims, NPY_UINT, nullptr, const_cast<unsigned*>( s_sim_state->indices().data() ), 0, NPY_ARRAY_CARRAY_RO, nullptr );
+}
+
+// The body space mass matrix is diagonal, holding each body's mass three times followed by its principal inertia
+static PyObject* masses( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_sim_state != nullptr );
+  assert( s_sim_state->M0().nonZeros() == 6 * s_sim_state->nbodies() );
+  return scalarView( s_sim_state->nbodies(), 1, 3 * sizeof( scalar ), s_sim_state->M0().valuePtr(), false );
+}
+
+static PyObject* inertias( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_sim_state != nullptr );
+  assert( s_sim_state->M0().nonZeros() == 6 * s_sim_state->nbodies() );
+  return scalarView( s_sim_state->nbodies(), 3, 3 * sizeof( scalar ), s_sim_state->M0().valuePtr() + 3 * s_sim_state->nbodies(), false );
+}
+
+static PyObject* staticPlanePositions( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_sim_state != nullptr );
+  const npy_intp nplanes{ static_cast<npy_intp>( s_sim_state->numStaticPlanes() ) };
+  return scalarView( nplanes, 3, sizeof( StaticPlane ), nplanes != 0 ? s_sim_state->staticPlane( 0 ).x().data() : nullptr, true );
+}
+
+static PyObject* staticPlaneVelocities( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_sim_state != nullptr );
+  const npy_intp nplanes{ static_cast<npy_intp>( s_sim_state->numStaticPlanes() ) };
+  return scalarView( nplanes, 3, sizeof( StaticPlane ), nplanes != 0 ? s_sim_state->staticPlane( 0 ).v().data() : nullptr, true );
+}
+
+static PyObject* staticPlaneAngularVelocities( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_sim_state != nullptr );
+  const npy_intp nplanes{ static_cast<npy_intp>( s_sim_state->numStaticPlanes() ) };
+  return scalarView( nplanes, 3, sizeof( StaticPlane ), nplanes != 0 ? s_sim_state->staticPlane( 0 ).omega().data() : nullptr, true );
+}
+
+static PyObject* staticCylinderPositions( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_sim_state != nullptr );
+  const npy_intp ncylinders{ static_cast<npy_intp>( s_sim_state->numStaticCylinders() ) };
+  return scalarView( ncylinders, 3, sizeof( StaticCylinder ), ncylinders != 0 ? s_sim_state->staticCylinder( 0 ).x().data() : nullptr, false );
+}
+
+static PyObject* staticCylinderAngularVelocities( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_sim_state != nullptr );
+  const npy_intp ncylinders{ static_cast<npy_intp>( s_sim_state->numStaticCylinders() ) };
+  return scalarView( ncylinders, 3, sizeof( StaticCylinder ), ncylinders != 0 ? s_sim_state->staticCylinder( 0 ).omega().data() : nullptr, true );
+}
+
+static PyObject* staticCylinderRadii( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_sim_state != nullptr );
+  const npy_intp ncylinders{ static_cast<npy_intp>( s_sim_state->numStaticCylinders() ) };
+  return scalarView( ncylinders, 1, sizeof( StaticCylinder ), ncylinders != 0 ? &s_sim_state->staticCylinder( 0 ).r() : nullptr, false );
+}
+
+static PyObject* wakeBody( PyObject* self, PyObject* args )
+{
+  unsigned body_idx;
+  assert( args != nullptr );
+  if( !PyArg_ParseTuple( args, "I", &body_idx ) )
+  {
+    PyErr_Print();
+    std::cerr << "Failed to read parameters for wakeBody, parameters are: unsigned body_idx. Exiting." << std::endl;
+    std::exit( EXIT_FAILURE );
+  }
+  assert( s_sim_state != nullptr );
+  if( body_idx >= s_sim_state->nbodies() )
+  {
+    std::cerr << "Invalid body_idx parameter of " << body_idx << " in wakeBody, body_idx must be less than " << s_sim_state->nbodies() << ". Exiting." << std::endl;
+    std::exit( EXIT_FAILURE );
+  }
+  s_sim_state->sleepingIslands().wakeIslands( { body_idx } );
+  return Py_BuildValue( "" );
+}
+
 static PyObject* numStaticPlanes( PyObject* self, PyObject* args )
 {
   assert( args == nullptr );
@@ -556,6 +744,175 @@ static PyObject* collisionIndices( PyObject* self, PyObject* args )
   return object;
 }
 
+// Collision types are reported to Python as fixed integer codes, their index in this table
+struct CollisionType final
+{
+  const std::type_info& type;
+  const char* name;
+  // Whether the constraint implements getWorldSpaceContactPoint and getWorldSpaceContactNormal
+  bool reports_contact;
+};
+
+static const CollisionType s_collision_types[] = {
+  { typeid( BodyBodyConstraint ), "body_body", true },
+  { typeid( KinematicObjectBodyConstraint ), "kinematic_object_body", true },
+  { typeid( KinematicObjectSphereConstraint ), "kinematic_object_sphere", true },
+  { typeid( SphereBodyConstraint ), "sphere_body", false },
+  { typeid( SphereSphereConstraint ), "sphere_sphere", true },
+  { typeid( StaticCylinderBodyConstraint ), "static_cylinder_body", true },
+  { typeid( StaticCylinderSphereConstraint ), "static_cylinder_sphere", true },
+  { typeid( StaticMeshBodyConstraint ), "static_mesh_body", true },
+  { typeid( StaticPlaneBodyConstraint ), "static_plane_body", true },
+  { typeid( StaticPlaneBoxConstraint ), "static_plane_box", true },
+  { typeid( StaticPlaneSphereConstraint ), "static_plane_sphere", true },
+  { typeid( TeleportedSphereSphereConstraint ), "teleported_sphere_sphere", true }
+};
+
+static const int s_num_collision_types{ static_cast<int>( sizeof( s_collision_types ) / sizeof( s_collision_types[0] ) ) };
+
+// Returns -1 for constraints missing from the table
+static int collisionTypeCodeOf( const Constraint& constraint )
+{
+  const std::type_info& type{ typeid( constraint ) };
+  for( int code = 0; code < s_num_collision_types; ++code )
+  {
+    if( s_collision_types[code].type == type )
+    {
+      return code;
+    }
+  }
+  return -1;
+}
+
+static int collisionTypeCodeForName( const char* const name )
+{
+  for( int code = 0; code < s_num_collision_types; ++code )
+  {
+    if( std::strcmp( s_collision_types[code].name, name ) == 0 )
+    {
+      return code;
+    }
+  }
+  return -1;
+}
+
+static bool reportsContact( const Constraint& constraint )
+{
+  const int code{ collisionTypeCodeOf( constraint ) };
+  return code >= 0 && s_collision_types[code].reports_contact;
+}
+
+static PyObject* collisionTypeCode( PyObject* self, PyObject* args )
+{
+  const char* type_name;
+  assert( args != nullptr );
+  if( !PyArg_ParseTuple( args, "s", &type_name ) )
+  {
+    PyErr_Print();
+    std::cerr << "Failed to read parameters for collisionTypeCode, parameters are: type_name. Exiting." << std::endl;
+    std::exit( EXIT_FAILURE );
+  }
+  return Py_BuildValue( "i", collisionTypeCodeForName( type_name ) );
+}
+
+static PyObject* collisionTypeCodes( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_active_set != nullptr );
+  npy_intp dims[1] = { static_cast<npy_intp>( s_active_set->size() ) };
+  PyObject* object = PyArray_SimpleNew( 1, dims, NPY_INT );
+  int* int_data = (int*)( PyArray_DATA( (PyArrayObject*)( object ) ) );
+  for( const std::unique_ptr<Constraint>& constraint : *s_active_set )
+  {
+    *int_data++ = collisionTypeCodeOf( *constraint );
+  }
+  return object;
+}
+
+static PyObject* allCollisionIndices( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_active_set != nullptr );
+  npy_intp dims[2] = { static_cast<npy_intp>( s_active_set->size() ), 2 };
+  PyObject* object = PyArray_SimpleNew( 2, dims, NPY_INT );
+  int* int_data = (int*)( PyArray_DATA( (PyArrayObject*)( object ) ) );
+  for( const std::unique_ptr<Constraint>& constraint : *s_active_set )
+  {
+    std::pair<int,int> body_indices;
+    constraint->getBodyIndices( body_indices );
+    *int_data++ = body_indices.first;
+    *int_data++ = body_indices.second;
+  }
+  return object;
+}
+
+static PyObject* collisionPoints( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_active_set != nullptr );
+  assert( s_q != nullptr );
+  using std::is_same;
+  static_assert( is_same<scalar,double>::value || is_same<scalar,float>::value, "Error, scalar type must be double or float for Python interface." );
+  npy_intp dims[2] = { static_cast<npy_intp>( s_active_set->size() ), 3 };
+  PyObject* object = PyArray_SimpleNew( 2, dims, (is_same<scalar,double>::value ? NPY_DOUBLE : NPY_FLOAT) );
+  scalar* scalar_data = (scalar*)( PyArray_DATA( (PyArrayObject*)( object ) ) );
+  VectorXs contact_point;
+  for( const std::unique_ptr<Constraint>& constraint : *s_active_set )
+  {
+    if( !reportsContact( *constraint ) )
+    {
+      scalar_data = std::fill_n( scalar_data, 3, std::numeric_limits<scalar>::quiet_NaN() );
+      continue;
+    }
+    constraint->getWorldSpaceContactPoint( *s_q, contact_point );
+    assert( contact_point.size() == 3 );
+    scalar_data = std::copy( contact_point.data(), contact_point.data() + 3, scalar_data );
+  }
+  return object;
+}
+
+static PyObject* collisionNormals( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_active_set != nullptr );
+  assert( s_q != nullptr );
+  using std::is_same;
+  static_assert( is_same<scalar,double>::value || is_same<scalar,float>::value, "Error, scalar type must be double or float for Python interface." );
+  npy_intp dims[2] = { static_cast<npy_intp>( s_active_set->size() ), 3 };
+  PyObject* object = PyArray_SimpleNew( 2, dims, (is_same<scalar,double>::value ? NPY_DOUBLE : NPY_FLOAT) );
+  scalar* scalar_data = (scalar*)( PyArray_DATA( (PyArrayObject*)( object ) ) );
+  VectorXs contact_normal;
+  for( const std::unique_ptr<Constraint>& constraint : *s_active_set )
+  {
+    if( !reportsContact( *constraint ) )
+    {
+      scalar_data = std::fill_n( scalar_data, 3, std::numeric_limits<scalar>::quiet_NaN() );
+      continue;
+    }
+    constraint->getWorldSpaceContactNormal( *s_q, contact_normal );
+    assert( contact_normal.size() == 3 );
+    scalar_data = std::copy( contact_normal.data(), contact_normal.data() + 3, scalar_data );
+  }
+  return object;
+}
+
+static PyObject* collisionPenetrationDepths( PyObject* self, PyObject* args )
+{
+  assert( args == nullptr );
+  assert( s_active_set != nullptr );
+  assert( s_q != nullptr );
+  using std::is_same;
+  static_assert( is_same<scalar,double>::value || is_same<scalar,float>::value, "Error, scalar type must be double or float for Python interface." );
+  npy_intp dims[1] = { static_cast<npy_intp>( s_active_set->size() ) };
+  PyObject* object = PyArray_SimpleNew( 1, dims, (is_same<scalar,double>::value ? NPY_DOUBLE : NPY_FLOAT) );
+  scalar* scalar_data = (scalar*)( PyArray_DATA( (PyArrayObject*)( object ) ) );
+  for( const std::unique_ptr<Constraint>& constraint : *s_active_set )
+  {
+    *scalar_data++ = constraint->penetrationDepth( *s_q );
+  }
+  return object;
+}
+
 static PyObject* numForces( PyObject* self, PyObject* args )
 {
   assert( args == nullptr );
@@ -626,6 +983,17 @@ static PyMethodDef RigidBody3DFunctions[] = {
   { "nextIteration", nextIteration, METH_NOARGS, "Returns the end of step iteration." },
   { "configuration", configuration, METH_NOARGS, "Returns the system's configuration." },
   { "velocity", velocity, METH_NOARGS, "Returns the system's velocity." },
+  { "stateVersion", stateVersion, METH_NOARGS, "Returns a counter that changes whenever arrays returned by earlier calls are invalidated." },
+  { "geometryIndices", geometryIndices, METH_NOARGS, "Returns a read only view of the geometry index of each body." },
+  { "masses", masses, METH_NOARGS, "Returns a read only view of the mass of each body." },
+  { "inertias", inertias, METH_NOARGS, "Returns a read only Nx3 view of the principal moments of inertia of each body." },
+  { "staticPlanePositions", staticPlanePositions, METH_NOARGS, "Returns an Nx3 view of the positions of the static planes." },
+  { "staticPlaneVelocities", staticPlaneVelocities, METH_NOARGS, "Returns an Nx3 view of the velocities of the static planes." },
+  { "staticPlaneAngularVelocities", staticPlaneAngularVelocities, METH_NOARGS, "Returns an Nx3 view of the angular velocities of the static planes." },
+  { "staticCylinderPositions", staticCylinderPositions, METH_NOARGS, "Returns a read only Nx3 view of the positions of the static cylinders." },
+  { "staticCylinderAngularVelocities", staticCylinderAngularVelocities, METH_NOARGS, "Returns an Nx3 view of the angular velocities of the static cylinders." },
+  { "staticCylinderRadii", staticCylinderRadii, METH_NOARGS, "Returns a read only view of the radii of the static cylinders." },
+  { "wakeBody", wakeBody, METH_VARARGS, "Wakes a sleeping body and the rest of its island." },
   { "numStaticPlanes", numStaticPlanes, METH_NOARGS, "Returns the number of static planes." },
   { "setStaticPlanePosition", setStaticPlanePosition, METH_VARARGS, "Sets the position of a static plane." },
   { "setStaticPlaneVelocity", setStaticPlaneVelocity, METH_VARARGS, "Sets the velocity of a static plane." },
@@ -637,6 +1005,12 @@ static PyMethodDef RigidBody3DFunctions[] = {
   { "numCollisions", numCollisions, METH_NOARGS, "Returns the number of collisions." },
   { "collisionType", collisionType, METH_VARARGS, "Returns the type of a collision." },
   { "collisionIndices", collisionIndices, METH_VARARGS, "Returns the indices of bodies involved in a given collision." },
+  { "collisionTypeCode", collisionTypeCode, METH_VARARGS, "Returns the fixed integer code of a collision type name, -1 if the name is unknown." },
+  { "collisionTypeCodes", collisionTypeCodes, METH_NOARGS, "Returns the integer type codes of all collisions, -1 for unknown types." },
+  { "allCollisionIndices", allCollisionIndices, METH_NOARGS, "Returns an Nx2 array of the indices of bodies involved in all collisions." },
+  { "collisionPoints", collisionPoints, METH_NOARGS, "Returns an Nx3 array of the world space contact points of all collisions, nan where not available." },
+  { "collisionNormals", collisionNormals, METH_NOARGS, "Returns an Nx3 array of the world space contact normals of all collisions, nan where not available." },
+  { "collisionPenetrationDepths", collisionPenetrationDepths, METH_NOARGS, "Returns the penetration depths of all collisions, nan where not available." },
   { "numForces", numForces, METH_NOARGS, "Returns the number of forces." },
   { "forceType", forceType, METH_VARARGS, "Returns the type of a force." },
   { "setGravityForce", setGravityForce, METH_VARARGS, "Sets a gravity force." },
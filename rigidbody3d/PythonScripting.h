@@ -8,20 +8,21 @@
 
 #ifdef USE_PYTHON
 #include <Python.h>
+#include <cstdint>
+#include <vector>
 #include "scisim/PythonObject.h"
 #endif
 
-#include "scisim/ScriptingCallback.h"
+#include "RigidBody3DScriptingCallback.h"
 
-class RigidBody3DState;
-
-class PythonScripting final : public ScriptingCallback
+class PythonScripting final : public RigidBody3DScriptingCallback
 {
 
 public:
 
   PythonScripting();
   PythonScripting( const std::string& path, const std::string& module_name );
+  // Reads the path and module name that serialize writes after the callback type
   explicit PythonScripting( std::istream& input_stream );
 
   virtual ~PythonScripting() override = default;
@@ -32,19 +33,23 @@ public:
   static void initializeCallbacks();
   #endif
 
-  void setState( RigidBody3DState& state );
-  void setInitialIterate( unsigned& initial_iterate );
-  void forgetState();
+  virtual void setState( RigidBody3DState& state ) override;
+  virtual void setInitialIterate( unsigned& initial_iterate ) override;
+  virtual void forgetState() override;
 
-  void serialize( std::ostream& output_stream );
+  virtual void serialize( std::ostream& output_stream ) override;
 
 private:
 
   void intializePythonCallbacks();
 
-  virtual void restitutionCoefficient( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor ) override;
+  #ifdef USE_PYTHON
+  void updateStateVersion();
+  #endif
+
+  virtual void restitutionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor ) override;
 
-  virtual void frictionCoefficient( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu ) override;
+  virtual void frictionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu ) override;
 
   virtual void startOfSim() override;
 
@@ -66,6 +71,9 @@ private:
   PythonObject m_loaded_end_of_step_callback;
   PythonObject m_loaded_friction_coefficient_callback;
   PythonObject m_loaded_restitution_coefficient_callback;
+  // Addresses and sizes of the buffers viewed by Python, and the version they were published under
+  unsigned m_state_version;
+  std::vector<std::uintptr_t> m_state_layout;
   #endif
 
 };
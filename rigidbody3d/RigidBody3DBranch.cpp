@@ -0,0 +1,125 @@
+// RigidBody3DBranch.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "RigidBody3DBranch.h"
+
+#include <cassert>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "scisim/UnconstrainedMaps/UnconstrainedMap.h"
+#include "scisim/ConstrainedMaps/ConstrainedMapUtilities.h"
+#include "scisim/ConstrainedMaps/FrictionSolver.h"
+#include "scisim/ConstrainedMaps/ImpactFrictionMap.h"
+#include "scisim/ConstrainedMaps/ImpactMaps/ImpactOperator.h"
+#include "scisim/Math/Rational.h"
+
+#include "RigidBody3DUtilities.h"
+
+RigidBody3DBranch::RigidBody3DBranch( const RigidBody3DSim& sim, std::unique_ptr<UnconstrainedMap> unconstrained_map, std::unique_ptr<ImpactOperator> impact_operator, const scalar& CoR, std::unique_ptr<FrictionSolver> friction_solver, const scalar& mu, std::unique_ptr<ImpactFrictionMap> impact_friction_map, const unsigned iteration )
+: m_sim( sim )
+, m_unconstrained_map( std::move( unconstrained_map ) )
+, m_impact_operator( std::move( impact_operator ) )
+, m_CoR( CoR )
+, m_friction_solver( std::move( friction_solver ) )
+, m_mu( mu )
+, m_impact_friction_map( std::move( impact_friction_map ) )
+, m_iteration( iteration )
+{
+  assert( ( m_friction_solver == nullptr ) == ( m_impact_friction_map == nullptr ) );
+  assert( m_impact_operator == nullptr || m_friction_solver == nullptr );
+}
+
+// Only impact operators can be cloned directly, so the remaining maps, which may hold warm start data, are
+// copied with a round trip through their serialized form
+RigidBody3DBranch::RigidBody3DBranch( const RigidBody3DBranch& other )
+: m_sim( other.m_sim )
+, m_unconstrained_map()
+, m_impact_operator( other.m_impact_operator != nullptr ? other.m_impact_operator->clone() : nullptr )
+, m_CoR( other.m_CoR )
+, m_friction_solver()
+, m_mu( other.m_mu )
+, m_impact_friction_map()
+, m_iteration( other.m_iteration )
+{
+  std::stringstream serial_stream;
+  RigidBody3DUtilities::serialize( other.m_unconstrained_map, serial_stream );
+  ConstrainedMapUtilities::serialize( other.m_friction_solver, serial_stream );
+  ConstrainedMapUtilities::serialize( other.m_impact_friction_map, serial_stream );
+  m_unconstrained_map = RigidBody3DUtilities::deserializeUnconstrainedMap( serial_stream );
+  m_friction_solver = ConstrainedMapUtilities::deserializeFrictionSolver( serial_stream );
+  m_impact_friction_map = ConstrainedMapUtilities::deserializeImpactFrictionMap( serial_stream );
+}
+
+RigidBody3DBranch::RigidBody3DBranch( RigidBody3DBranch&& other ) = default;
+
+RigidBody3DBranch& RigidBody3DBranch::operator=( const RigidBody3DBranch& other )
+{
+  RigidBody3DBranch copy{ other };
+  *this = std::move( copy );
+  return *this;
+}
+
+RigidBody3DBranch& RigidBody3DBranch::operator=( RigidBody3DBranch&& other ) = default;
+
+RigidBody3DBranch::~RigidBody3DBranch() = default;
+
+RigidBody3DSim& RigidBody3DBranch::sim()
+{
+  return m_sim;
+}
+
+const RigidBody3DSim& RigidBody3DBranch::sim() const
+{
+  return m_sim;
+}
+
+unsigned RigidBody3DBranch::iteration() const
+{
+  return m_iteration;
+}
+
+scalar& RigidBody3DBranch::CoR()
+{
+  return m_CoR;
+}
+
+const scalar& RigidBody3DBranch::CoR() const
+{
+  return m_CoR;
+}
+
+scalar& RigidBody3DBranch::mu()
+{
+  return m_mu;
+}
+
+const scalar& RigidBody3DBranch::mu() const
+{
+  return m_mu;
+}
+
+void RigidBody3DBranch::step( RigidBody3DScriptingCallback& call_back, const Rational<std::intmax_t>& dt )
+{
+  const unsigned next_iter{ m_iteration + 1 };
+  if( m_unconstrained_map == nullptr )
+  {
+    // Nothing to do
+  }
+  else if( m_impact_operator == nullptr && m_friction_solver == nullptr )
+  {
+    m_sim.flow( call_back, next_iter, dt, *m_unconstrained_map );
+  }
+  else if( m_impact_operator != nullptr )
+  {
+    m_sim.flow( call_back, next_iter, dt, *m_unconstrained_map, *m_impact_operator, m_CoR );
+  }
+  else
+  {
+    m_sim.flow( call_back, next_iter, dt, *m_unconstrained_map, m_CoR, m_mu, *m_friction_solver, *m_impact_friction_map );
+  }
+  m_iteration = next_iter;
+}
@@ -0,0 +1,67 @@
+// RigidBody3DBranch.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// A simulation together with the integrator and solvers that advance it. Copying a branch snapshots the
+// state, the constraint cache, and every map in memory, so many ensemble members can continue from a
+// common prefix, with perturbed coefficients, each on its own thread.
+
+#ifndef RIGID_BODY_3D_BRANCH_H
+#define RIGID_BODY_3D_BRANCH_H
+
+#include <cstdint>
+#include <memory>
+
+#include "RigidBody3DSim.h"
+
+class UnconstrainedMap;
+class ImpactOperator;
+class FrictionSolver;
+class ImpactFrictionMap;
+
+class RigidBody3DBranch final
+{
+
+public:
+
+  // Friction requires both a friction solver and an impact friction map, which exclude an impact operator
+  RigidBody3DBranch( const RigidBody3DSim& sim, std::unique_ptr<UnconstrainedMap> unconstrained_map, std::unique_ptr<ImpactOperator> impact_operator, const scalar& CoR, std::unique_ptr<FrictionSolver> friction_solver, const scalar& mu, std::unique_ptr<ImpactFrictionMap> impact_friction_map, const unsigned iteration );
+
+  RigidBody3DBranch( const RigidBody3DBranch& other );
+  RigidBody3DBranch( RigidBody3DBranch&& other );
+
+  RigidBody3DBranch& operator=( const RigidBody3DBranch& other );
+  RigidBody3DBranch& operator=( RigidBody3DBranch&& other );
+
+  ~RigidBody3DBranch();
+
+  RigidBody3DSim& sim();
+  const RigidBody3DSim& sim() const;
+
+  // Number of steps taken since the start of the simulation, including those taken before branching
+  unsigned iteration() const;
+
+  scalar& CoR();
+  const scalar& CoR() const;
+
+  scalar& mu();
+  const scalar& mu() const;
+
+  // Advances the simulation by one step of size dt
+  void step( RigidBody3DScriptingCallback& call_back, const Rational<std::intmax_t>& dt );
+
+private:
+
+  RigidBody3DSim m_sim;
+  std::unique_ptr<UnconstrainedMap> m_unconstrained_map;
+  std::unique_ptr<ImpactOperator> m_impact_operator;
+  scalar m_CoR;
+  std::unique_ptr<FrictionSolver> m_friction_solver;
+  scalar m_mu;
+  std::unique_ptr<ImpactFrictionMap> m_impact_friction_map;
+  unsigned m_iteration;
+
+};
+
+#endif
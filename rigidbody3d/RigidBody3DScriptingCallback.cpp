@@ -0,0 +1,48 @@
+// RigidBody3DScriptingCallback.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "RigidBody3DScriptingCallback.h"
+
+#include <cstdlib>
+#include <iostream>
+
+#include "scisim/StringUtilities.h"
+#include "scisim/Utilities.h"
+
+#include "NativeScripting.h"
+#include "PythonScripting.h"
+
+RigidBody3DScriptingCallback::~RigidBody3DScriptingCallback() = default;
+
+static bool endsWith( const std::string& value, const std::string& suffix )
+{
+  return value.size() >= suffix.size() && value.compare( value.size() - suffix.size(), suffix.size(), suffix ) == 0;
+}
+
+bool RigidBody3DScriptingCallback::isNativePluginName( const std::string& callback_name )
+{
+  return endsWith( callback_name, ".so" ) || endsWith( callback_name, ".dylib" );
+}
+
+std::unique_ptr<RigidBody3DScriptingCallback> RigidBody3DScriptingCallback::create( const RigidBody3DScriptingCallbackType type, const std::string& path, const std::string& callback_name )
+{
+  switch( type )
+  {
+    case RigidBody3DScriptingCallbackType::PYTHON:
+      return std::unique_ptr<RigidBody3DScriptingCallback>{ new PythonScripting{ path, callback_name } };
+    case RigidBody3DScriptingCallbackType::NATIVE_PLUGIN:
+      return std::unique_ptr<RigidBody3DScriptingCallback>{ new NativeScripting{ path, callback_name } };
+  }
+  std::cerr << "Invalid scripting callback type encountered in RigidBody3DScriptingCallback::create. This is a bug. Exiting." << std::endl;
+  std::exit( EXIT_FAILURE );
+}
+
+std::unique_ptr<RigidBody3DScriptingCallback> RigidBody3DScriptingCallback::deserialize( std::istream& input_stream )
+{
+  const RigidBody3DScriptingCallbackType type{ Utilities::deserialize<RigidBody3DScriptingCallbackType>( input_stream ) };
+  const std::string path{ StringUtilities::deserialize( input_stream ) };
+  const std::string callback_name{ StringUtilities::deserialize( input_stream ) };
+  return create( type, path, callback_name );
+}
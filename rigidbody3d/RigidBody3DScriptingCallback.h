@@ -0,0 +1,55 @@
+// RigidBody3DScriptingCallback.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Scripting callbacks with access to a rigid body state. Implemented by Python modules and by native
+// plugins loaded from shared libraries.
+
+#ifndef RIGID_BODY_3D_SCRIPTING_CALLBACK_H
+#define RIGID_BODY_3D_SCRIPTING_CALLBACK_H
+
+#include "scisim/ScriptingCallback.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+class RigidBody3DState;
+
+enum class RigidBody3DScriptingCallbackType : std::uint8_t
+{
+  PYTHON,
+  NATIVE_PLUGIN
+};
+
+class RigidBody3DScriptingCallback : public ScriptingCallback
+{
+
+public:
+
+  virtual ~RigidBody3DScriptingCallback() override = 0;
+
+  // Callbacks may modify the state and initial iterate between a set and the following forget
+  virtual void setState( RigidBody3DState& state ) = 0;
+  virtual void setInitialIterate( unsigned& initial_iterate ) = 0;
+  virtual void forgetState() = 0;
+
+  // Writes the callback type, path, and callback name, from which deserialize recreates the callback
+  virtual void serialize( std::ostream& output_stream ) = 0;
+
+  // Native plugins are named by their shared library file name, Python callbacks by their module name
+  static bool isNativePluginName( const std::string& callback_name );
+
+  // An empty callback name gives a callback that does nothing. path is the directory scripts are loaded from.
+  static std::unique_ptr<RigidBody3DScriptingCallback> create( const RigidBody3DScriptingCallbackType type, const std::string& path, const std::string& callback_name );
+  static std::unique_ptr<RigidBody3DScriptingCallback> deserialize( std::istream& input_stream );
+
+protected:
+
+  RigidBody3DScriptingCallback() = default;
+
+};
+
+#endif
@@ -5,20 +5,29 @@
 
 #include "RigidBody3DSim.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 #include "scisim/UnconstrainedMaps/UnconstrainedMap.h"
 #include "scisim/ConstrainedMaps/ImpactFrictionMap.h"
 #include "scisim/Utilities.h"
+#include "scisim/Checkpoint.h"
 #include "scisim/Math/Rational.h"
 #include "Forces/Force.h"
 #include "Geometry/RigidBodyBox.h"
 #include "Geometry/RigidBodySphere.h"
 #include "Geometry/RigidBodyStaple.h"
 #include "Geometry/RigidBodyTriangleMesh.h"
+#include "Geometry/RigidBodyConvexPolyhedron.h"
+#include "Geometry/RigidBodyCapsule.h"
+#include "Geometry/RigidBodyClump.h"
 #include "Constraints/BoxBoxUtilities.h"
 #include "Constraints/StapleStapleUtilities.h"
 #include "Constraints/MeshMeshUtilities.h"
+#include "Constraints/ConvexPolyhedronUtilities.h"
+#include "Constraints/CompoundUtilities.h"
+#include "Constraints/ClumpUtilities.h"
 #include "Constraints/SphereSphereConstraint.h"
 #include "Constraints/TeleportedSphereSphereConstraint.h"
 #include "Constraints/BodyBodyConstraint.h"
@@ -27,15 +36,17 @@
 #include "Constraints/StaticPlaneSphereConstraint.h"
 #include "Constraints/StaticCylinderSphereConstraint.h"
 #include "Constraints/StaticCylinderBodyConstraint.h"
+#include "Constraints/StaticMeshBodyConstraint.h"
 #include "Constraints/KinematicObjectSphereConstraint.h"
 #include "Constraints/KinematicObjectBodyConstraint.h"
 #include "Constraints/CollisionUtilities.h"
 #include "StaticGeometry/StaticCylinder.h"
+#include "StaticGeometry/StaticTriangleMesh.h"
 #include "UnconstrainedMaps/IntegrationTools.h"
 #include "SpatialGridDetector.h"
 #include "Portals/PlanarPortal.h"
 #include "StateOutput.h"
-#include "PythonScripting.h"
+#include "RigidBody3DScriptingCallback.h"
 
 #ifdef USE_HDF5
 #include "scisim/HDF5File.h"
@@ -168,7 +179,8 @@ unsigned RigidBody3DSim::ambientSpaceDimensions() const
 bool RigidBody3DSim::isKinematicallyScripted( const int i ) const
 {
   assert( i >= 0 ); assert( nvdofs() % 3 == 0 ); assert( i < nvdofs() / 3 );
-  return m_sim_state.isKinematicallyScripted( i );
+  // Sleeping bodies are held in place until woken
+  return m_sim_state.isKinematicallyScripted( i ) || m_sim_state.asleep( i );
 }
 
 void RigidBody3DSim::computeForce( const VectorXs& q, const VectorXs& v, const scalar& t, VectorXs& F )
@@ -183,6 +195,20 @@ void RigidBody3DSim::computeForce( const VectorXs& q, const VectorXs& v, const s
   {
     m_sim_state.forces()[frc_idx]->computeForce( m_sim_state.q(), m_sim_state.v(), m_sim_state.M(), F );
   }
+
+  // Sleeping bodies are not integrated
+  if( m_sim_state.sleepingIslands().enabled() )
+  {
+    const unsigned nbodies{ m_sim_state.nbodies() };
+    for( unsigned bdy_idx = 0; bdy_idx < nbodies; ++bdy_idx )
+    {
+      if( m_sim_state.asleep( bdy_idx ) )
+      {
+        F.segment<3>( 3 * bdy_idx ).setZero();
+        F.segment<3>( 3 * nbodies + 3 * bdy_idx ).setZero();
+      }
+    }
+  }
 }
 
 void RigidBody3DSim::linearInertialConfigurationUpdate( const VectorXs& q0, const VectorXs& v0, const scalar& dt, VectorXs& q1 ) const
@@ -239,13 +265,42 @@ void RigidBody3DSim::computeActiveSet( const VectorXs& q0, const VectorXs& qp, c
   assert( q0.size() == qp.size() );
   assert( active_set.empty() );
 
+  // Bound each body over the step, shared by the body-body and static geometry passes
+  std::vector<AABB> aabbs;
+  generateAABBs( aabbs, q0, qp );
+  assert( aabbs.size() == m_sim_state.nbodies() );
+
   // Detect body-body collisions
-  computeActiveSetBodyBodySpatialGrid( q0, qp, active_set );
+  std::vector<unsigned> bodies_to_wake;
+  computeActiveSetBodyBodySpatialGrid( q0, qp, aabbs, active_set, bodies_to_wake );
+  // Sleeping bodies skip the static geometry passes, so moving static geometry has to wake them here
+  if( m_sim_state.sleepingIslands().enabled() )
+  {
+    sleepersTouchingMovingStaticGeometry( aabbs, bodies_to_wake );
+  }
+
+  // Awake bodies that touch a sleeping island wake the whole island. The woken bodies can in turn
+  // touch other sleeping islands, so detection restarts until no further islands wake.
+  if( !bodies_to_wake.empty() )
+  {
+    m_sim_state.sleepingIslands().wakeIslands( bodies_to_wake );
+    active_set.clear();
+    computeActiveSet( q0, qp, v, active_set );
+    return;
+  }
 
   // Detect body-plane collisions
-  computeBodyPlaneActiveSetAllPairs( q0, qp, active_set );
+  computeBodyPlaneActiveSet( q0, qp, aabbs, active_set );
   // Detect body-cylinder collisions
-  computeBodyCylinderActiveSetAllPairs( q0, qp, active_set );
+  computeBodyCylinderActiveSet( q0, qp, aabbs, active_set );
+  // Detect body-mesh collisions
+  computeBodyMeshActiveSet( q0, qp, aabbs, active_set );
+
+  // Record which bodies touch for building sleeping islands at the end of the step
+  if( m_sim_state.sleepingIslands().enabled() )
+  {
+    m_sim_state.sleepingIslands().addContacts( active_set );
+  }
 }
 
 void RigidBody3DSim::computeImpactBases( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, MatrixXXsc& impact_bases ) const
@@ -296,13 +351,23 @@ bool RigidBody3DSim::constraintCacheEmpty() const
   return m_constraint_cache.empty();
 }
 
+void RigidBody3DSim::computeRestitutionCoefficients( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& CoR ) const
+{
+  m_sim_state.materials().restitutionCoefficients( active_set, CoR );
+}
+
+void RigidBody3DSim::computeFrictionCoefficients( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu ) const
+{
+  m_sim_state.materials().frictionCoefficients( active_set, mu );
+}
+
 void RigidBody3DSim::computeNumberOfCollisions( std::map<std::string,unsigned>& collision_counts, std::map<std::string,scalar>& collision_depths, std::map<std::string,scalar>& overlap_volumes )
 {
   collision_counts.clear();
   collision_depths.clear();
   overlap_volumes.clear();
   std::vector<std::unique_ptr<Constraint>> active_set;
-  computeActiveSet( m_sim_state.q(), m_sim_state.q(), m_sim_state.v(), active_set );
+  computeMeasurementActiveSet( active_set );
   for( const std::unique_ptr<Constraint>& constraint : active_set )
   {
     const std::string constraint_name{ constraint->name() };
@@ -348,11 +413,40 @@ void RigidBody3DSim::computeNumberOfCollisions( std::map<std::string,unsigned>&
   }
 }
 
-void RigidBody3DSim::flow( PythonScripting& call_back, const unsigned iteration, const Rational<std::intmax_t>& dt, UnconstrainedMap& umap )
+scalar RigidBody3DSim::computeMaxPenetrationDepth()
+{
+  std::vector<std::unique_ptr<Constraint>> active_set;
+  computeMeasurementActiveSet( active_set );
+  scalar max_depth{ 0.0 };
+  for( const std::unique_ptr<Constraint>& constraint : active_set )
+  {
+    // Depths are negative when bodies overlap and nan when not supported
+    const scalar depth{ constraint->penetrationDepth( m_sim_state.q() ) };
+    if( !std::isnan( depth ) )
+    {
+      max_depth = std::max( max_depth, -depth );
+    }
+  }
+  return max_depth;
+}
+
+void RigidBody3DSim::computeMeasurementActiveSet( std::vector<std::unique_ptr<Constraint>>& active_set )
+{
+  // Collision detection wakes sleeping islands, records sleeping contacts, and advances the box-box
+  // axis cache; restore them so measuring between steps does not change the next step
+  const SleepingIslands sleeping_islands{ m_sim_state.sleepingIslands() };
+  const BoxBoxAxisCache box_box_axes{ m_box_box_axes };
+  computeActiveSet( m_sim_state.q(), m_sim_state.q(), m_sim_state.v(), active_set );
+  m_sim_state.sleepingIslands() = sleeping_islands;
+  m_box_box_axes = box_box_axes;
+}
+
+void RigidBody3DSim::flow( RigidBody3DScriptingCallback& call_back, const unsigned iteration, const Rational<std::intmax_t>& dt, UnconstrainedMap& umap )
 {
   call_back.setState( m_sim_state );
   call_back.startOfStepCallback( iteration, dt );
   call_back.forgetState();
+  updateSleepingIslandsStartOfStep();
 
   // Ensure that fixed bodies do not move
   #ifndef NDEBUG
@@ -415,17 +509,19 @@ void RigidBody3DSim::flow( PythonScripting& call_back, const unsigned iteration,
   #endif
 
   enforcePeriodicBoundaryConditions();
+  updateSleepingIslandsEndOfStep( scalar( dt ) );
 
   call_back.setState( m_sim_state );
   call_back.endOfStepCallback( iteration, dt );
   call_back.forgetState();
 }
 
-void RigidBody3DSim::flow( PythonScripting& call_back, const unsigned iteration, const Rational<std::intmax_t>& dt, UnconstrainedMap& umap, ImpactOperator& imap, const scalar& CoR )
+void RigidBody3DSim::flow( RigidBody3DScriptingCallback& call_back, const unsigned iteration, const Rational<std::intmax_t>& dt, UnconstrainedMap& umap, ImpactOperator& imap, const scalar& CoR )
 {
   call_back.setState( m_sim_state );
   call_back.startOfStepCallback( iteration, dt );
   call_back.forgetState();
+  updateSleepingIslandsStartOfStep();
 
   // Ensure that fixed bodies do not move
   #ifndef NDEBUG
@@ -488,17 +584,19 @@ void RigidBody3DSim::flow( PythonScripting& call_back, const unsigned iteration,
   #endif
 
   enforcePeriodicBoundaryConditions();
+  updateSleepingIslandsEndOfStep( scalar( dt ) );
 
   call_back.setState( m_sim_state );
   call_back.endOfStepCallback( iteration, dt );
   call_back.forgetState();
 }
 
-void RigidBody3DSim::flow( PythonScripting& call_back, const unsigned iteration, const Rational<std::intmax_t>& dt, UnconstrainedMap& umap, const scalar& CoR, const scalar& mu, FrictionSolver& solver, ImpactFrictionMap& ifmap )
+void RigidBody3DSim::flow( RigidBody3DScriptingCallback& call_back, const unsigned iteration, const Rational<std::intmax_t>& dt, UnconstrainedMap& umap, const scalar& CoR, const scalar& mu, FrictionSolver& solver, ImpactFrictionMap& ifmap )
 {
   call_back.setState( m_sim_state );
   call_back.startOfStepCallback( iteration, dt );
   call_back.forgetState();
+  updateSleepingIslandsStartOfStep();
 
   // Ensure that fixed bodies do not move
   #ifndef NDEBUG
@@ -561,6 +659,7 @@ void RigidBody3DSim::flow( PythonScripting& call_back, const unsigned iteration,
   #endif
 
   enforcePeriodicBoundaryConditions();
+  updateSleepingIslandsEndOfStep( scalar( dt ) );
 
   call_back.setState( m_sim_state );
   call_back.endOfStepCallback( iteration, dt );
@@ -600,7 +699,7 @@ void RigidBody3DSim::enforcePeriodicBoundaryConditions()
   }
 }
 
-void RigidBody3DSim::boxBoxNarrowPhaseCollision( const unsigned first_body, const unsigned second_body, const RigidBodyBox& box0, const RigidBodyBox& box1, const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const
+void RigidBody3DSim::boxBoxNarrowPhaseCollision( const unsigned first_body, const unsigned second_body, const RigidBodyBox& box0, const RigidBodyBox& box1, const VectorXs& q0, const VectorXs& q1, int& axis_code, std::vector<std::unique_ptr<Constraint>>& active_set ) const
 {
   assert( !isKinematicallyScripted( first_body ) ); // Kinematic rigid body should be listed second
 
@@ -612,7 +711,7 @@ void RigidBody3DSim::boxBoxNarrowPhaseCollision( const unsigned first_body, cons
   std::vector<Vector3s> points;
   BoxBoxUtilities::isActive( q1.segment<3>( 3 * first_body ), R0, box0.halfWidths(),
                              q1.segment<3>( 3 * second_body ), R1, box1.halfWidths(),
-                             n, points );
+                             axis_code, n, points );
 
   if( !isKinematicallyScripted( second_body ) )
   {
@@ -731,8 +830,8 @@ void RigidBody3DSim::sphereSphereNarrowPhaseCollision( const unsigned first_body
 {
   assert( !isKinematicallyScripted( first_body ) ); // Kinematic rigid body should be listed second
 
-  // Evaluation of active set at q1
-  if( SphereSphereConstraint::isActive( q1.segment<3>( 3 * first_body ), q1.segment<3>( 3 * second_body ), sphere0.r(), sphere1.r() ) )
+  // Evaluation of active set over the step from q0 to q1
+  if( SphereSphereConstraint::timeOfImpact( q0.segment<3>( 3 * first_body ), q0.segment<3>( 3 * second_body ), q1.segment<3>( 3 * first_body ), q1.segment<3>( 3 * second_body ), sphere0.r(), sphere1.r() ) != SCALAR_INFINITY )
   {
     // Creation of constraints at q0 to preserve angular momentum
     const Vector3s n{ ( q0.segment<3>( 3 * first_body ) - q0.segment<3>( 3 * second_body ) ).normalized() };
@@ -800,8 +899,167 @@ void RigidBody3DSim::meshMeshNarrowPhaseCollision( const unsigned first_body, co
   }
 }
 
+// Vertices and face planes of a box or convex polyhedron placed at the given configuration
+static void placedPolyhedron( const RigidBodyGeometry& geometry, const Vector3s& cm, const Matrix33sr& R, Matrix3Xsc& vertices, Matrix3Xsc& normals, VectorXs& offsets )
+{
+  if( geometry.getType() == RigidBodyGeometryType::BOX )
+  {
+    ConvexPolyhedronUtilities::boxAsPolyhedron( cm, R, static_cast<const RigidBodyBox&>( geometry ).halfWidths(), vertices, normals, offsets );
+  }
+  else
+  {
+    assert( geometry.getType() == RigidBodyGeometryType::CONVEX_POLYHEDRON );
+    ConvexPolyhedronUtilities::transformPolyhedron( cm, R, static_cast<const RigidBodyConvexPolyhedron&>( geometry ), vertices, normals, offsets );
+  }
+}
+
+void RigidBody3DSim::convexPolyhedronNarrowPhaseCollision( const unsigned first_body, const unsigned second_body, const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const
+{
+  assert( !isKinematicallyScripted( first_body ) ); // Kinematic rigid body should be listed second
+
+  Matrix3Xsc vertices0;
+  Matrix3Xsc normals0;
+  VectorXs offsets0;
+  {
+    const Matrix33sr R0{ Eigen::Map<const Matrix33sr>{ q1.segment<9>( 3 * m_sim_state.nbodies() + 9 * first_body ).data() } };
+    placedPolyhedron( m_sim_state.getGeometryOfBody( first_body ), q1.segment<3>( 3 * first_body ), R0, vertices0, normals0, offsets0 );
+  }
+  Matrix3Xsc vertices1;
+  Matrix3Xsc normals1;
+  VectorXs offsets1;
+  {
+    const Matrix33sr R1{ Eigen::Map<const Matrix33sr>{ q1.segment<9>( 3 * m_sim_state.nbodies() + 9 * second_body ).data() } };
+    placedPolyhedron( m_sim_state.getGeometryOfBody( second_body ), q1.segment<3>( 3 * second_body ), R1, vertices1, normals1, offsets1 );
+  }
+
+  Vector3s n;
+  scalar depth;
+  std::vector<Vector3s> points;
+  if( !ConvexPolyhedronUtilities::computeActiveSet( vertices0, normals0, offsets0, vertices1, normals1, offsets1, n, depth, points ) )
+  {
+    return;
+  }
+
+  if( !isKinematicallyScripted( second_body ) )
+  {
+    for( const Vector3s& point : points )
+    {
+      active_set.emplace_back( new BodyBodyConstraint{ first_body, second_body, point, n, q0 } );
+    }
+  }
+  else
+  {
+    for( const Vector3s& point : points )
+    {
+      active_set.emplace_back( new KinematicObjectBodyConstraint{ first_body, second_body, point, n, q0 } );
+    }
+  }
+}
+
+void RigidBody3DSim::compoundNarrowPhaseCollision( const unsigned first_body, const unsigned second_body, const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const
+{
+  assert( !isKinematicallyScripted( first_body ) ); // Kinematic rigid body should be listed second
+
+  const Matrix33sr R0{ Eigen::Map<const Matrix33sr>{ q1.segment<9>( 3 * m_sim_state.nbodies() + 9 * first_body ).data() } };
+  const Matrix33sr R1{ Eigen::Map<const Matrix33sr>{ q1.segment<9>( 3 * m_sim_state.nbodies() + 9 * second_body ).data() } };
+
+  std::vector<Vector3s> points;
+  std::vector<Vector3s> normals;
+  CompoundUtilities::computeActiveSet( q1.segment<3>( 3 * first_body ), R0, m_sim_state.getGeometryOfBody( first_body ),
+                                       q1.segment<3>( 3 * second_body ), R1, m_sim_state.getGeometryOfBody( second_body ),
+                                       points, normals );
+  assert( points.size() == normals.size() );
+
+  if( !isKinematicallyScripted( second_body ) )
+  {
+    for( std::vector<Vector3s>::size_type i = 0; i < points.size(); ++i )
+    {
+      active_set.emplace_back( new BodyBodyConstraint{ first_body, second_body, points[i], normals[i], q0 } );
+    }
+  }
+  else
+  {
+    for( std::vector<Vector3s>::size_type i = 0; i < points.size(); ++i )
+    {
+      active_set.emplace_back( new KinematicObjectBodyConstraint{ first_body, second_body, points[i], normals[i], q0 } );
+    }
+  }
+}
+
+// Spheres of a clump or of a lone sphere at center of mass cm with orientation R
+static void computeBodySpheres( const RigidBodyGeometry& geometry, const Vector3s& cm, const Matrix33sr& R, ClumpUtilities::SphereCenters& centers, VectorXs& radii )
+{
+  if( geometry.getType() == RigidBodyGeometryType::CLUMP )
+  {
+    const RigidBodyClump& clump{ static_cast<const RigidBodyClump&>( geometry ) };
+    ClumpUtilities::computeCenters( cm, R, clump, centers );
+    radii = clump.radii();
+  }
+  else
+  {
+    assert( geometry.getType() == RigidBodyGeometryType::SPHERE );
+    centers = cm;
+    radii = VectorXs::Constant( 1, static_cast<const RigidBodySphere&>( geometry ).r() );
+  }
+}
+
+void RigidBody3DSim::clumpNarrowPhaseCollision( const unsigned first_body, const unsigned second_body, const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const
+{
+  assert( !isKinematicallyScripted( first_body ) ); // Kinematic rigid body should be listed second
+
+  const RigidBodyGeometry& geo0{ m_sim_state.getGeometryOfBody( first_body ) };
+  const RigidBodyGeometry& geo1{ m_sim_state.getGeometryOfBody( second_body ) };
+  ClumpUtilities::SphereCenters x0;
+  VectorXs r0;
+  ClumpUtilities::SphereCenters x1;
+  VectorXs r1;
+
+  // Evaluation of active set at q1
+  std::vector<std::pair<unsigned,unsigned>> pairs;
+  {
+    const Matrix33sr R0{ Eigen::Map<const Matrix33sr>{ q1.segment<9>( 3 * m_sim_state.nbodies() + 9 * first_body ).data() } };
+    const Matrix33sr R1{ Eigen::Map<const Matrix33sr>{ q1.segment<9>( 3 * m_sim_state.nbodies() + 9 * second_body ).data() } };
+    computeBodySpheres( geo0, q1.segment<3>( 3 * first_body ), R0, x0, r0 );
+    computeBodySpheres( geo1, q1.segment<3>( 3 * second_body ), R1, x1, r1 );
+    ClumpUtilities::computeOverlappingSpheres( x0, r0, x1, r1, pairs );
+  }
+  if( pairs.empty() )
+  {
+    return;
+  }
+
+  // As with lone spheres, creation of constraints between the sphere centers at q0 to preserve angular momentum
+  {
+    const Matrix33sr R0{ Eigen::Map<const Matrix33sr>{ q0.segment<9>( 3 * m_sim_state.nbodies() + 9 * first_body ).data() } };
+    const Matrix33sr R1{ Eigen::Map<const Matrix33sr>{ q0.segment<9>( 3 * m_sim_state.nbodies() + 9 * second_body ).data() } };
+    computeBodySpheres( geo0, q0.segment<3>( 3 * first_body ), R0, x0, r0 );
+    computeBodySpheres( geo1, q0.segment<3>( 3 * second_body ), R1, x1, r1 );
+  }
+  for( const std::pair<unsigned,unsigned>& pair : pairs )
+  {
+    const Vector3s c0{ x0.col( pair.first ) };
+    const Vector3s c1{ x1.col( pair.second ) };
+    const Vector3s n{ ( c0 - c1 ).normalized() };
+    assert( fabs( n.norm() - 1.0 ) <= 1.0e-6 );
+    const Vector3s p{ c0 + ( r0( pair.first ) / ( r0( pair.first ) + r1( pair.second ) ) ) * ( c1 - c0 ) };
+    if( !isKinematicallyScripted( second_body ) )
+    {
+      active_set.emplace_back( new BodyBodyConstraint{ first_body, second_body, p, n, q0 } );
+    }
+    else
+    {
+      active_set.emplace_back( new KinematicObjectBodyConstraint{ first_body, second_body, p, n, q0 } );
+    }
+  }
+}
+
+static bool isCapsuleOrCompound( const RigidBodyGeometry& geometry )
+{
+  return geometry.getType() == RigidBodyGeometryType::CAPSULE || geometry.getType() == RigidBodyGeometryType::COMPOUND;
+}
+
 // TODO: clean up this implementation like with the portal system
-void RigidBody3DSim::dispatchNarrowPhaseCollision( const unsigned first_body, const unsigned second_body, const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const
+void RigidBody3DSim::dispatchNarrowPhaseCollision( const unsigned first_body, const unsigned second_body, const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set )
 {
   // Ignore kinematic-kinematic collisions
   if( isKinematicallyScripted( first_body ) && isKinematicallyScripted( second_body ) )
@@ -824,7 +1082,21 @@ void RigidBody3DSim::dispatchNarrowPhaseCollision( const unsigned first_body, co
     {
       const RigidBodyBox& body_geo0{ static_cast<const RigidBodyBox&>( m_sim_state.getGeometryOfBody( body0 ) ) };
       const RigidBodyBox& body_geo1{ static_cast<const RigidBodyBox&>( m_sim_state.getGeometryOfBody( body1 ) ) };
-      boxBoxNarrowPhaseCollision( body0, body1, body_geo0, body_geo1, q0, q1, active_set );
+      int axis_code{ m_box_box_axes.previousAxis( body0, body1 ) };
+      boxBoxNarrowPhaseCollision( body0, body1, body_geo0, body_geo1, q0, q1, axis_code, active_set );
+      m_box_box_axes.recordAxis( body0, body1, axis_code );
+      return;
+    }
+    // Box-polyhedron
+    else if( m_sim_state.getGeometryOfBody( body1 ).getType() == RigidBodyGeometryType::CONVEX_POLYHEDRON )
+    {
+      convexPolyhedronNarrowPhaseCollision( body0, body1, q0, q1, active_set );
+      return;
+    }
+    // Box-capsule and box-compound
+    else if( isCapsuleOrCompound( m_sim_state.getGeometryOfBody( body1 ) ) )
+    {
+      compoundNarrowPhaseCollision( body0, body1, q0, q1, active_set );
       return;
     }
     // Box-sphere
@@ -848,6 +1120,18 @@ void RigidBody3DSim::dispatchNarrowPhaseCollision( const unsigned first_body, co
       sphereSphereNarrowPhaseCollision( body0, body1, body_geo0, body_geo1, q0, q1, active_set );
       return;
     }
+    // Sphere-capsule and sphere-compound
+    else if( isCapsuleOrCompound( m_sim_state.getGeometryOfBody( body1 ) ) )
+    {
+      compoundNarrowPhaseCollision( body0, body1, q0, q1, active_set );
+      return;
+    }
+    // Sphere-clump
+    else if( m_sim_state.getGeometryOfBody( body1 ).getType() == RigidBodyGeometryType::CLUMP )
+    {
+      clumpNarrowPhaseCollision( body0, body1, q0, q1, active_set );
+      return;
+    }
     // Sphere-Box
     else if( m_sim_state.getGeometryOfBody( body1 ).getType() == RigidBodyGeometryType::BOX )
     {
@@ -881,6 +1165,33 @@ void RigidBody3DSim::dispatchNarrowPhaseCollision( const unsigned first_body, co
       return;
     }
   }
+  else if( m_sim_state.getGeometryOfBody( body0 ).getType() == RigidBodyGeometryType::CONVEX_POLYHEDRON )
+  {
+    // Polyhedron-polyhedron and polyhedron-box
+    if( m_sim_state.getGeometryOfBody( body1 ).getType() == RigidBodyGeometryType::CONVEX_POLYHEDRON || m_sim_state.getGeometryOfBody( body1 ).getType() == RigidBodyGeometryType::BOX )
+    {
+      convexPolyhedronNarrowPhaseCollision( body0, body1, q0, q1, active_set );
+      return;
+    }
+  }
+  else if( isCapsuleOrCompound( m_sim_state.getGeometryOfBody( body0 ) ) )
+  {
+    // Capsules and compounds against spheres, boxes, capsules and compounds
+    if( CompoundUtilities::isPrimitiveOrCompound( m_sim_state.getGeometryOfBody( body1 ) ) )
+    {
+      compoundNarrowPhaseCollision( body0, body1, q0, q1, active_set );
+      return;
+    }
+  }
+  else if( m_sim_state.getGeometryOfBody( body0 ).getType() == RigidBodyGeometryType::CLUMP )
+  {
+    // Clump-clump and clump-sphere
+    if( m_sim_state.getGeometryOfBody( body1 ).getType() == RigidBodyGeometryType::CLUMP || m_sim_state.getGeometryOfBody( body1 ).getType() == RigidBodyGeometryType::SPHERE )
+    {
+      clumpNarrowPhaseCollision( body0, body1, q0, q1, active_set );
+      return;
+    }
+  }
 
   std::cerr << "Collision between " << m_sim_state.getGeometryOfBody(body0).name() << " and " << m_sim_state.getGeometryOfBody(second_body).name() << " not supported. Exiting." << std::endl;
   std::exit(EXIT_FAILURE);
@@ -911,7 +1222,22 @@ bool RigidBody3DSim::collisionIsActive( const unsigned first_body, const unsigne
       const RigidBodyBox& body_geo0{ static_cast<const RigidBodyBox&>( m_sim_state.getGeometryOfBody( body0 ) ) };
       const RigidBodyBox& body_geo1{ static_cast<const RigidBodyBox&>( m_sim_state.getGeometryOfBody( body1 ) ) };
       std::vector<std::unique_ptr<Constraint>> temp_active_set;
-      boxBoxNarrowPhaseCollision( body0, body1, body_geo0, body_geo1, q0, q1, temp_active_set );
+      int axis_code{ m_box_box_axes.previousAxis( body0, body1 ) };
+      boxBoxNarrowPhaseCollision( body0, body1, body_geo0, body_geo1, q0, q1, axis_code, temp_active_set );
+      return !temp_active_set.empty();
+    }
+    // Box-polyhedron
+    else if( m_sim_state.getGeometryOfBody( body1 ).getType() == RigidBodyGeometryType::CONVEX_POLYHEDRON )
+    {
+      std::vector<std::unique_ptr<Constraint>> temp_active_set;
+      convexPolyhedronNarrowPhaseCollision( body0, body1, q0, q1, temp_active_set );
+      return !temp_active_set.empty();
+    }
+    // Box-capsule and box-compound
+    else if( isCapsuleOrCompound( m_sim_state.getGeometryOfBody( body1 ) ) )
+    {
+      std::vector<std::unique_ptr<Constraint>> temp_active_set;
+      compoundNarrowPhaseCollision( body0, body1, q0, q1, temp_active_set );
       return !temp_active_set.empty();
     }
     // Box-sphere
@@ -937,6 +1263,20 @@ bool RigidBody3DSim::collisionIsActive( const unsigned first_body, const unsigne
       sphereSphereNarrowPhaseCollision( body0, body1, body_geo0, body_geo1, q0, q1, temp_active_set );
       return !temp_active_set.empty();
     }
+    // Sphere-capsule and sphere-compound
+    else if( isCapsuleOrCompound( m_sim_state.getGeometryOfBody( body1 ) ) )
+    {
+      std::vector<std::unique_ptr<Constraint>> temp_active_set;
+      compoundNarrowPhaseCollision( body0, body1, q0, q1, temp_active_set );
+      return !temp_active_set.empty();
+    }
+    // Sphere-clump
+    else if( m_sim_state.getGeometryOfBody( body1 ).getType() == RigidBodyGeometryType::CLUMP )
+    {
+      std::vector<std::unique_ptr<Constraint>> temp_active_set;
+      clumpNarrowPhaseCollision( body0, body1, q0, q1, temp_active_set );
+      return !temp_active_set.empty();
+    }
     // Sphere-Box
     else if( m_sim_state.getGeometryOfBody( body1 ).getType() == RigidBodyGeometryType::BOX )
     {
@@ -973,28 +1313,191 @@ bool RigidBody3DSim::collisionIsActive( const unsigned first_body, const unsigne
       return !temp_active_set.empty();
     }
   }
+  else if( m_sim_state.getGeometryOfBody( body0 ).getType() == RigidBodyGeometryType::CONVEX_POLYHEDRON )
+  {
+    // Polyhedron-polyhedron and polyhedron-box
+    if( m_sim_state.getGeometryOfBody( body1 ).getType() == RigidBodyGeometryType::CONVEX_POLYHEDRON || m_sim_state.getGeometryOfBody( body1 ).getType() == RigidBodyGeometryType::BOX )
+    {
+      std::vector<std::unique_ptr<Constraint>> temp_active_set;
+      convexPolyhedronNarrowPhaseCollision( body0, body1, q0, q1, temp_active_set );
+      return !temp_active_set.empty();
+    }
+  }
+  else if( isCapsuleOrCompound( m_sim_state.getGeometryOfBody( body0 ) ) )
+  {
+    // Capsules and compounds against spheres, boxes, capsules and compounds
+    if( CompoundUtilities::isPrimitiveOrCompound( m_sim_state.getGeometryOfBody( body1 ) ) )
+    {
+      std::vector<std::unique_ptr<Constraint>> temp_active_set;
+      compoundNarrowPhaseCollision( body0, body1, q0, q1, temp_active_set );
+      return !temp_active_set.empty();
+    }
+  }
+  else if( m_sim_state.getGeometryOfBody( body0 ).getType() == RigidBodyGeometryType::CLUMP )
+  {
+    // Clump-clump and clump-sphere
+    if( m_sim_state.getGeometryOfBody( body1 ).getType() == RigidBodyGeometryType::CLUMP || m_sim_state.getGeometryOfBody( body1 ).getType() == RigidBodyGeometryType::SPHERE )
+    {
+      std::vector<std::unique_ptr<Constraint>> temp_active_set;
+      clumpNarrowPhaseCollision( body0, body1, q0, q1, temp_active_set );
+      return !temp_active_set.empty();
+    }
+  }
 
   std::cerr << "Collision between " << m_sim_state.getGeometryOfBody(body0).name() << " and " << m_sim_state.getGeometryOfBody(second_body).name() << " not supported. Exiting." << std::endl;
   std::exit( EXIT_FAILURE );
 }
 
 
-void RigidBody3DSim::generateAABBs( std::vector<AABB>& aabbs, const VectorXs& q )
+void RigidBody3DSim::generateAABBs( std::vector<AABB>& aabbs, const VectorXs& q0, const VectorXs& q1 )
 {
+  assert( q0.size() == q1.size() );
   aabbs.resize( m_sim_state.nbodies() );
   for( unsigned body = 0; body < m_sim_state.nbodies(); ++body )
   {
-    const Vector3s cm{ q.segment<3>( 3 * body ) };
-    const Matrix33sr R{ Eigen::Map<const Matrix33sr>{ q.segment<9>( 3 * m_sim_state.nbodies() + 9 * body ).data() } };
-    assert( ( R * R.transpose() - Matrix33sr::Identity() ).lpNorm<Eigen::Infinity>() <= 1.0e-6 );
-    assert( fabs( R.determinant() - 1.0 ) <= 1.0e-6 );
-    m_sim_state.getGeometryOfBody( body ).computeAABB( cm, R, aabbs[body].min(), aabbs[body].max() );
+    const Vector3s cm1{ q1.segment<3>( 3 * body ) };
+    const Matrix33sr R1{ Eigen::Map<const Matrix33sr>{ q1.segment<9>( 3 * m_sim_state.nbodies() + 9 * body ).data() } };
+    assert( ( R1 * R1.transpose() - Matrix33sr::Identity() ).lpNorm<Eigen::Infinity>() <= 1.0e-6 );
+    assert( fabs( R1.determinant() - 1.0 ) <= 1.0e-6 );
+    m_sim_state.getGeometryOfBody( body ).computeAABB( cm1, R1, aabbs[body].min(), aabbs[body].max() );
     assert( ( aabbs[body].min() < aabbs[body].max() ).all() );
+
+    // Sweep the box back to the start of the step so fast bodies can not tunnel through each other
+    const Vector3s cm0{ q0.segment<3>( 3 * body ) };
+    const Matrix33sr R0{ Eigen::Map<const Matrix33sr>{ q0.segment<9>( 3 * m_sim_state.nbodies() + 9 * body ).data() } };
+    Array3s min0;
+    Array3s max0;
+    m_sim_state.getGeometryOfBody( body ).computeAABB( cm0, R0, min0, max0 );
+    aabbs[body].min() = aabbs[body].min().min( min0 );
+    aabbs[body].max() = aabbs[body].max().max( max0 );
+  }
+}
+
+void RigidBody3DSim::updateSleepingIslandsStartOfStep()
+{
+  SleepingIslands& sleeping_islands{ m_sim_state.sleepingIslands() };
+  if( !sleeping_islands.enabled() )
+  {
+    return;
+  }
+
+  sleeping_islands.clearContacts();
+
+  // Wake any sleeping body that a script set in motion
+  const unsigned nbodies{ m_sim_state.nbodies() };
+  std::vector<unsigned> bodies_to_wake;
+  for( unsigned bdy_idx = 0; bdy_idx < nbodies; ++bdy_idx )
+  {
+    if( !m_sim_state.asleep( bdy_idx ) )
+    {
+      continue;
+    }
+    if( ( m_sim_state.v().segment<3>( 3 * bdy_idx ).array() != 0.0 ).any() || ( m_sim_state.v().segment<3>( 3 * nbodies + 3 * bdy_idx ).array() != 0.0 ).any() )
+    {
+      bodies_to_wake.emplace_back( bdy_idx );
+    }
+  }
+  sleeping_islands.wakeIslands( bodies_to_wake );
+}
+
+void RigidBody3DSim::updateSleepingIslandsEndOfStep( const scalar& dt )
+{
+  SleepingIslands& sleeping_islands{ m_sim_state.sleepingIslands() };
+  if( !sleeping_islands.enabled() )
+  {
+    return;
+  }
+
+  const unsigned nbodies{ m_sim_state.nbodies() };
+  VectorXs speeds{ nbodies };
+  VectorXs kinetic_energies{ nbodies };
+  for( unsigned bdy_idx = 0; bdy_idx < nbodies; ++bdy_idx )
+  {
+    const Vector3s v{ m_sim_state.v().segment<3>( 3 * bdy_idx ) };
+    const Vector3s omega{ m_sim_state.v().segment<3>( 3 * nbodies + 3 * bdy_idx ) };
+    speeds( bdy_idx ) = v.norm();
+    kinetic_energies( bdy_idx ) = 0.5 * m_sim_state.getTotalMass( bdy_idx ) * v.squaredNorm() + 0.5 * omega.dot( m_sim_state.getInertia( bdy_idx ) * omega );
+  }
+
+  // Bodies in newly sleeping islands come to a complete stop
+  if( sleeping_islands.update( dt, speeds, kinetic_energies, m_sim_state.fixed() ) != 0 )
+  {
+    for( unsigned bdy_idx = 0; bdy_idx < nbodies; ++bdy_idx )
+    {
+      if( m_sim_state.asleep( bdy_idx ) )
+      {
+        m_sim_state.v().segment<3>( 3 * bdy_idx ).setZero();
+        m_sim_state.v().segment<3>( 3 * nbodies + 3 * bdy_idx ).setZero();
+      }
+    }
+  }
+}
+
+bool RigidBody3DSim::scriptedBodyMoves( const unsigned bdy_idx, const VectorXs& q0, const VectorXs& q1 ) const
+{
+  const unsigned nbodies{ m_sim_state.nbodies() };
+  if( ( m_sim_state.v().segment<3>( 3 * bdy_idx ).array() != 0.0 ).any() || ( m_sim_state.v().segment<3>( 3 * nbodies + 3 * bdy_idx ).array() != 0.0 ).any() )
+  {
+    return true;
+  }
+  return q0.segment<3>( 3 * bdy_idx ) != q1.segment<3>( 3 * bdy_idx ) || q0.segment<9>( 3 * nbodies + 9 * bdy_idx ) != q1.segment<9>( 3 * nbodies + 9 * bdy_idx );
+}
+
+bool RigidBody3DSim::sleepingPairSkipped( const unsigned bdy_idx_0, const unsigned bdy_idx_1, const VectorXs& q0, const VectorXs& q1, std::vector<unsigned>& bodies_to_wake ) const
+{
+  const bool asleep0{ m_sim_state.asleep( bdy_idx_0 ) };
+  const bool asleep1{ m_sim_state.asleep( bdy_idx_1 ) };
+  if( !asleep0 && !asleep1 )
+  {
+    return false;
+  }
+  // An awake body wakes the island of the sleeping body it touches, unless it is a scripted body at rest
+  if( asleep0 && !asleep1 && ( !m_sim_state.isKinematicallyScripted( bdy_idx_1 ) || scriptedBodyMoves( bdy_idx_1, q0, q1 ) ) )
+  {
+    bodies_to_wake.emplace_back( bdy_idx_0 );
+  }
+  else if( asleep1 && !asleep0 && ( !m_sim_state.isKinematicallyScripted( bdy_idx_0 ) || scriptedBodyMoves( bdy_idx_0, q0, q1 ) ) )
+  {
+    bodies_to_wake.emplace_back( bdy_idx_1 );
+  }
+  return true;
+}
+
+void RigidBody3DSim::sleepersTouchingMovingStaticGeometry( const std::vector<AABB>& aabbs, std::vector<unsigned>& bodies_to_wake ) const
+{
+  assert( aabbs.size() == m_sim_state.nbodies() );
+  for( const StaticPlane& plane : m_sim_state.staticPlanes() )
+  {
+    if( ( plane.v().array() == 0.0 ).all() && ( plane.omega().array() == 0.0 ).all() )
+    {
+      continue;
+    }
+    for( unsigned bdy_idx = 0; bdy_idx < m_sim_state.nbodies(); ++bdy_idx )
+    {
+      if( m_sim_state.asleep( bdy_idx ) && !aabbs[bdy_idx].inFrontOfPlane( plane.x(), plane.n() ) )
+      {
+        bodies_to_wake.emplace_back( bdy_idx );
+      }
+    }
+  }
+  for( const StaticCylinder& cylinder : m_sim_state.staticCylinders() )
+  {
+    if( ( cylinder.v().array() == 0.0 ).all() && ( cylinder.omega().array() == 0.0 ).all() )
+    {
+      continue;
+    }
+    for( unsigned bdy_idx = 0; bdy_idx < m_sim_state.nbodies(); ++bdy_idx )
+    {
+      if( m_sim_state.asleep( bdy_idx ) && !aabbs[bdy_idx].insideCylinder( cylinder.x(), cylinder.axis(), cylinder.r() ) )
+      {
+        bodies_to_wake.emplace_back( bdy_idx );
+      }
+    }
   }
 }
 
 // TODO: Move as much of this code into helper methods as possible
-void RigidBody3DSim::computeActiveSetBodyBodySpatialGrid( const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set )
+void RigidBody3DSim::computeActiveSetBodyBodySpatialGrid( const VectorXs& q0, const VectorXs& q1, const std::vector<AABB>& body_aabbs, std::vector<std::unique_ptr<Constraint>>& active_set, std::vector<unsigned>& bodies_to_wake )
 {
   assert( q0.size() == 12 * m_sim_state.nbodies() );
   assert( q0.size() == q1.size() );
@@ -1006,9 +1509,8 @@ void RigidBody3DSim::computeActiveSetBodyBodySpatialGrid( const VectorXs& q0, co
   // Map from teleported AABB indices and body and portal indices
   std::map<unsigned,TeleportedBody> teleported_aabb_body_indices;
   {
-    // Compute an AABB for each body
-    std::vector<AABB> aabbs;
-    generateAABBs( aabbs, q1 );
+    // Teleported bodies are appended after the AABB of each body
+    std::vector<AABB> aabbs{ body_aabbs };
     assert( aabbs.size() == nbodies );
 
     // Compute an AABB for each teleported particle
@@ -1058,6 +1560,11 @@ void RigidBody3DSim::computeActiveSetBodyBodySpatialGrid( const VectorXs& q0, co
     // If neither ball in the current collision was teleported
     if( !first_teleported && !second_teleported )
     {
+      // Sleeping bodies are not tested against each other
+      if( sleepingPairSkipped( possible_overlap_pair.first, possible_overlap_pair.second, q0, q1, bodies_to_wake ) )
+      {
+        continue;
+      }
       if( isKinematicallyScripted( possible_overlap_pair.first ) && isKinematicallyScripted( possible_overlap_pair.second ) )
       {
         continue;
@@ -1097,6 +1604,11 @@ void RigidBody3DSim::computeActiveSetBodyBodySpatialGrid( const VectorXs& q0, co
         prtl_plane_1 = map_itr->second.planeIndex();
       }
 
+      if( sleepingPairSkipped( bdy_idx_0, bdy_idx_1, q0, q1, bodies_to_wake ) )
+      {
+        continue;
+      }
+
       // Check if the collision will be detected in the unteleported state
       if( first_teleported && second_teleported )
       {
@@ -1182,6 +1694,9 @@ void RigidBody3DSim::computeActiveSetBodyBodySpatialGrid( const VectorXs& q0, co
   //  }
   //}
   //#endif
+
+  // Box pairs not tested during this pass are forgotten
+  m_box_box_axes.endPass();
 }
 
 bool RigidBody3DSim::teleportedCollisionHappens( const VectorXs& q, const TeleportedCollision& teleported_collision ) const
@@ -1336,12 +1851,12 @@ void RigidBody3DSim::generateTeleportedCollision( const VectorXs& q, const Telep
 //}
 
 // TODO: Move all of the ugly code bits in here into their own functions
-void RigidBody3DSim::computeBodyPlaneActiveSetAllPairs( const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const
+void RigidBody3DSim::computeBodyPlaneActiveSet( const VectorXs& q0, const VectorXs& q1, const std::vector<AABB>& aabbs, std::vector<std::unique_ptr<Constraint>>& active_set ) const
 {
   assert( q0.size() == q1.size() );
   assert( q0.size() == 12 * m_sim_state.nbodies() );
+  assert( aabbs.size() == m_sim_state.nbodies() );
 
-  // Check all plane-body pairs
   for( std::vector<StaticPlane>::size_type plane = 0; plane < m_sim_state.staticPlanes().size(); ++plane )
   {
     for( unsigned body = 0; body < m_sim_state.nbodies(); ++body )
@@ -1351,6 +1866,11 @@ void RigidBody3DSim::computeBodyPlaneActiveSetAllPairs( const VectorXs& q0, cons
       {
         continue;
       }
+      // Bodies entirely in front of the plane over the whole step can not touch it
+      if( aabbs[body].inFrontOfPlane( m_sim_state.staticPlanes()[plane].x(), m_sim_state.staticPlanes()[plane].n() ) )
+      {
+        continue;
+      }
 
       if( m_sim_state.getGeometryOfBody(body).getType() == RigidBodyGeometryType::BOX )
       {
@@ -1417,6 +1937,72 @@ void RigidBody3DSim::computeBodyPlaneActiveSetAllPairs( const VectorXs& q0, cons
           }
         }
       }
+      else if( m_sim_state.getGeometryOfBody(body).getType() == RigidBodyGeometryType::CONVEX_POLYHEDRON )
+      {
+        const RigidBodyConvexPolyhedron& polyhedron{ static_cast<const RigidBodyConvexPolyhedron&>( m_sim_state.getGeometryOfBody( body ) ) };
+        // Determine which vertices of the polyhedron collide with the half plane
+        std::vector<unsigned> colliding_vertices;
+        {
+          const Vector3s cm1{ q1.segment<3>( 3 * body ) };
+          const Matrix33sr R1{ Eigen::Map<const Matrix33sr>{ q1.segment<9>( 3 * m_sim_state.nbodies() + 9 * body ).data() } };
+          ConvexPolyhedronUtilities::computeHalfPlaneActiveSet( cm1, R1, polyhedron, m_sim_state.staticPlanes()[plane].x(), m_sim_state.staticPlanes()[plane].n(), colliding_vertices );
+        }
+        // Create constraints for each vertex
+        {
+          const Vector3s cm0{ q0.segment<3>( 3 * body ) };
+          const Matrix33sr R0{ Eigen::Map<const Matrix33sr>{ q0.segment<9>( 3 * m_sim_state.nbodies() + 9 * body ).data() } };
+          for( const unsigned vrt_idx : colliding_vertices )
+          {
+            const Vector3s point{ cm0 + R0 * polyhedron.vertices().col( vrt_idx ) };
+            active_set.emplace_back( new StaticPlaneBodyConstraint{ body, point, m_sim_state.staticPlane(plane).n(), q0, static_cast<unsigned>( plane ) } );
+          }
+        }
+      }
+      else if( isCapsuleOrCompound( m_sim_state.getGeometryOfBody( body ) ) )
+      {
+        // Determine which parts of the body collide with the half plane
+        std::vector<Vector3s> body_points;
+        {
+          const Vector3s cm1{ q1.segment<3>( 3 * body ) };
+          const Matrix33sr R1{ Eigen::Map<const Matrix33sr>{ q1.segment<9>( 3 * m_sim_state.nbodies() + 9 * body ).data() } };
+          CompoundUtilities::computeHalfPlaneActiveSet( cm1, R1, m_sim_state.getGeometryOfBody( body ), m_sim_state.staticPlanes()[plane].x(), m_sim_state.staticPlanes()[plane].n(), body_points );
+        }
+        // Create constraints for each contact point
+        {
+          const Vector3s cm0{ q0.segment<3>( 3 * body ) };
+          const Matrix33sr R0{ Eigen::Map<const Matrix33sr>{ q0.segment<9>( 3 * m_sim_state.nbodies() + 9 * body ).data() } };
+          for( const Vector3s& body_point : body_points )
+          {
+            active_set.emplace_back( new StaticPlaneBodyConstraint{ body, cm0 + R0 * body_point, m_sim_state.staticPlane(plane).n(), q0, static_cast<unsigned>( plane ) } );
+          }
+        }
+      }
+      else if( m_sim_state.getGeometryOfBody( body ).getType() == RigidBodyGeometryType::CLUMP )
+      {
+        const RigidBodyClump& clump{ static_cast<const RigidBodyClump&>( m_sim_state.getGeometryOfBody( body ) ) };
+        ClumpUtilities::SphereCenters centers;
+        // Determine which spheres of the clump collide with the half plane
+        std::vector<unsigned> colliding_spheres;
+        {
+          const Matrix33sr R1{ Eigen::Map<const Matrix33sr>{ q1.segment<9>( 3 * m_sim_state.nbodies() + 9 * body ).data() } };
+          ClumpUtilities::computeCenters( q1.segment<3>( 3 * body ), R1, clump, centers );
+          ClumpUtilities::computeHalfPlaneActiveSet( centers, clump.radii(), m_sim_state.staticPlanes()[plane].x(), m_sim_state.staticPlanes()[plane].n(), colliding_spheres );
+        }
+        if( colliding_spheres.empty() )
+        {
+          continue;
+        }
+        // Create constraints at the deepest point of each sphere
+        {
+          const Matrix33sr R0{ Eigen::Map<const Matrix33sr>{ q0.segment<9>( 3 * m_sim_state.nbodies() + 9 * body ).data() } };
+          ClumpUtilities::computeCenters( q0.segment<3>( 3 * body ), R0, clump, centers );
+          for( const unsigned sphere_idx : colliding_spheres )
+          {
+            const Vector3s point{ centers.col( sphere_idx ) - clump.radii()( sphere_idx ) * m_sim_state.staticPlanes()[plane].n() };
+            active_set.emplace_back( new StaticPlaneBodyConstraint{ body, point, m_sim_state.staticPlane(plane).n(), q0, static_cast<unsigned>( plane ) } );
+          }
+        }
+      }
       else
       {
         std::cerr << "Collision between static planes and " << m_sim_state.getGeometryOfBody(body).name() << " not supported. Exiting." << std::endl;
@@ -1426,14 +2012,15 @@ void RigidBody3DSim::computeBodyPlaneActiveSetAllPairs( const VectorXs& q0, cons
   }
 }
 
-void RigidBody3DSim::computeBodyCylinderActiveSetAllPairs( const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const
+void RigidBody3DSim::computeBodyCylinderActiveSet( const VectorXs& q0, const VectorXs& q1, const std::vector<AABB>& aabbs, std::vector<std::unique_ptr<Constraint>>& active_set ) const
 {
   assert( q0.size() == q1.size() );
   assert( q0.size() == 12 * m_sim_state.nbodies() );
+  assert( aabbs.size() == m_sim_state.nbodies() );
 
-  // Check all cylinder-body pairs
   for( std::vector<StaticCylinder>::size_type cyl = 0; cyl < m_sim_state.staticCylinders().size(); ++cyl )
   {
+    const Vector3s axis{ m_sim_state.staticCylinder( cyl ).axis() };
     for( unsigned body = 0; body < m_sim_state.nbodies(); ++body )
     {
       // Skip kinematically scripted bodies
@@ -1441,6 +2028,11 @@ void RigidBody3DSim::computeBodyCylinderActiveSetAllPairs( const VectorXs& q0, c
       {
         continue;
       }
+      // Bodies held away from the wall over the whole step can not touch it
+      if( aabbs[body].insideCylinder( m_sim_state.staticCylinder( cyl ).x(), axis, m_sim_state.staticCylinder( cyl ).r() ) )
+      {
+        continue;
+      }
 
       if( m_sim_state.getGeometryOfBody(body).getType() == RigidBodyGeometryType::SPHERE )
       {
@@ -1472,6 +2064,78 @@ void RigidBody3DSim::computeBodyCylinderActiveSetAllPairs( const VectorXs& q0, c
           }
         }
       }
+      else if( m_sim_state.getGeometryOfBody(body).getType() == RigidBodyGeometryType::CONVEX_POLYHEDRON )
+      {
+        const RigidBodyConvexPolyhedron& polyhedron{ static_cast<const RigidBodyConvexPolyhedron&>( m_sim_state.getGeometryOfBody( body ) ) };
+        // Determine which vertices of the polyhedron collide with the cylinder
+        std::vector<unsigned> colliding_vertices;
+        {
+          const Vector3s cm1{ q1.segment<3>( 3 * body ) };
+          const Matrix33sr R1{ Eigen::Map<const Matrix33sr>{ q1.segment<9>( 3 * m_sim_state.nbodies() + 9 * body ).data() } };
+          ConvexPolyhedronUtilities::computeCylinderActiveSet( cm1, R1, polyhedron, m_sim_state.staticCylinder(cyl).x(), m_sim_state.staticCylinder(cyl).axis(), m_sim_state.staticCylinder(cyl).r(), colliding_vertices );
+        }
+        // Create constraints for each vertex
+        {
+          const Vector3s cm0{ q0.segment<3>( 3 * body ) };
+          const Matrix33sr R0{ Eigen::Map<const Matrix33sr>{ q0.segment<9>( 3 * m_sim_state.nbodies() + 9 * body ).data() } };
+          for( const unsigned vrt_idx : colliding_vertices )
+          {
+            const Vector3s point{ cm0 + R0 * polyhedron.vertices().col( vrt_idx ) };
+            active_set.emplace_back( new StaticCylinderBodyConstraint{ body, point, m_sim_state.staticCylinder(cyl), static_cast<unsigned>( cyl ), q0 } );
+          }
+        }
+      }
+      else if( isCapsuleOrCompound( m_sim_state.getGeometryOfBody( body ) ) )
+      {
+        // Determine which parts of the body collide with the cylinder
+        std::vector<Vector3s> body_points;
+        {
+          const Vector3s cm1{ q1.segment<3>( 3 * body ) };
+          const Matrix33sr R1{ Eigen::Map<const Matrix33sr>{ q1.segment<9>( 3 * m_sim_state.nbodies() + 9 * body ).data() } };
+          CompoundUtilities::computeCylinderActiveSet( cm1, R1, m_sim_state.getGeometryOfBody( body ), m_sim_state.staticCylinder(cyl).x(), m_sim_state.staticCylinder(cyl).axis(), m_sim_state.staticCylinder(cyl).r(), body_points );
+        }
+        // Create constraints for each contact point
+        {
+          const Vector3s cm0{ q0.segment<3>( 3 * body ) };
+          const Matrix33sr R0{ Eigen::Map<const Matrix33sr>{ q0.segment<9>( 3 * m_sim_state.nbodies() + 9 * body ).data() } };
+          for( const Vector3s& body_point : body_points )
+          {
+            active_set.emplace_back( new StaticCylinderBodyConstraint{ body, cm0 + R0 * body_point, m_sim_state.staticCylinder(cyl), static_cast<unsigned>( cyl ), q0 } );
+          }
+        }
+      }
+      else if( m_sim_state.getGeometryOfBody( body ).getType() == RigidBodyGeometryType::CLUMP )
+      {
+        const RigidBodyClump& clump{ static_cast<const RigidBodyClump&>( m_sim_state.getGeometryOfBody( body ) ) };
+        ClumpUtilities::SphereCenters centers;
+        // Determine which spheres of the clump collide with the cylinder
+        std::vector<unsigned> colliding_spheres;
+        {
+          const Matrix33sr R1{ Eigen::Map<const Matrix33sr>{ q1.segment<9>( 3 * m_sim_state.nbodies() + 9 * body ).data() } };
+          ClumpUtilities::computeCenters( q1.segment<3>( 3 * body ), R1, clump, centers );
+          ClumpUtilities::computeCylinderActiveSet( centers, clump.radii(), m_sim_state.staticCylinder(cyl).x(), axis, m_sim_state.staticCylinder(cyl).r(), colliding_spheres );
+        }
+        if( colliding_spheres.empty() )
+        {
+          continue;
+        }
+        // Create constraints at the point of each sphere furthest from the axis
+        {
+          const Matrix33sr R0{ Eigen::Map<const Matrix33sr>{ q0.segment<9>( 3 * m_sim_state.nbodies() + 9 * body ).data() } };
+          ClumpUtilities::computeCenters( q0.segment<3>( 3 * body ), R0, clump, centers );
+          for( const unsigned sphere_idx : colliding_spheres )
+          {
+            const Vector3s c{ centers.col( sphere_idx ) };
+            const Vector3s d{ c - m_sim_state.staticCylinder(cyl).x() - axis.dot( c - m_sim_state.staticCylinder(cyl).x() ) * axis };
+            const scalar d_norm{ d.norm() };
+            if( d_norm == 0.0 )
+            {
+              continue;
+            }
+            active_set.emplace_back( new StaticCylinderBodyConstraint{ body, c + ( clump.radii()( sphere_idx ) / d_norm ) * d, m_sim_state.staticCylinder(cyl), static_cast<unsigned>( cyl ), q0 } );
+          }
+        }
+      }
       else
       {
         std::cerr << "Collision between static cylinders and " << m_sim_state.getGeometryOfBody(body).name() << " not supported. Exiting." << std::endl;
@@ -1481,35 +2145,239 @@ void RigidBody3DSim::computeBodyCylinderActiveSetAllPairs( const VectorXs& q0, c
   }
 }
 
+// Contacts between a sphere and the faces of a static mesh. The closest point on each nearby face is tested,
+// so spheres resting on an edge or vertex shared by several faces produce a single contact.
+static void computeSphereMeshActiveSet( const unsigned body, const scalar& r, const Vector3s& c0, const Vector3s& c1, const StaticTriangleMesh& mesh, const unsigned mesh_idx, const std::vector<unsigned>& faces, const VectorXs& q0, std::vector<std::unique_ptr<Constraint>>& active_set )
+{
+  std::vector<Vector3s> closest_points;
+  for( const unsigned face : faces )
+  {
+    const Vector3s closest_point{ mesh.closestPointOnFace( face, c1 ) };
+    const Vector3s delta{ c1 - closest_point };
+    if( delta.squaredNorm() > r * r )
+    {
+      continue;
+    }
+    // Spheres whose centers are well behind a face are on the far side of the surface
+    const Vector3s face_normal{ mesh.faceNormal( face ) };
+    const scalar signed_distance{ face_normal.dot( delta ) };
+    if( signed_distance < -mesh.thickness() )
+    {
+      continue;
+    }
+    if( std::any_of( closest_points.cbegin(), closest_points.cend(), [&closest_point, &r]( const Vector3s& other ) { return ( other - closest_point ).squaredNorm() <= 1.0e-12 * r * r; } ) )
+    {
+      continue;
+    }
+    closest_points.emplace_back( closest_point );
+    // Spheres that reach a face's interior, or have passed through it, are pushed along the face normal
+    const Vector3s n{ signed_distance > 0.0 && delta.squaredNorm() > 1.0e-12 * r * r ? Vector3s{ delta.normalized() } : face_normal };
+    active_set.emplace_back( new StaticMeshBodyConstraint{ body, c0 - r * n, n, q0, mesh_idx } );
+  }
+}
+
+// Contacts between body space samples of a body and the faces of a static mesh. A sample collides with a face
+// if it ends the step behind the face, did not start the step further than the mesh's thickness behind it,
+// and crosses or lands within the face.
+static void computeSampleMeshActiveSet( const unsigned body, const Matrix3Xsc& samples, const Vector3s& cm0, const Matrix33sr& R0, const Vector3s& cm1, const Matrix33sr& R1, const StaticTriangleMesh& mesh, const unsigned mesh_idx, const std::vector<unsigned>& faces, const VectorXs& q0, std::vector<std::unique_ptr<Constraint>>& active_set )
+{
+  std::vector<Vector3s> sample_normals;
+  for( int sample_idx = 0; sample_idx < samples.cols(); ++sample_idx )
+  {
+    const Vector3s x0{ cm0 + R0 * samples.col( sample_idx ) };
+    const Vector3s x1{ cm1 + R1 * samples.col( sample_idx ) };
+    sample_normals.clear();
+    for( const unsigned face : faces )
+    {
+      const Vector3s n{ mesh.faceNormal( face ) };
+      const Vector3s a{ mesh.vertices().col( mesh.faces()( 0, face ) ) };
+      const scalar d1{ n.dot( x1 - a ) };
+      if( d1 > 0.0 )
+      {
+        continue;
+      }
+      const scalar d0{ n.dot( x0 - a ) };
+      if( d0 < -mesh.thickness() )
+      {
+        continue;
+      }
+      const Vector3s crossing_point{ d0 > 0.0 ? Vector3s{ x0 + ( d0 / ( d0 - d1 ) ) * ( x1 - x0 ) } : x1 };
+      if( !mesh.projectsOntoFace( face, crossing_point ) )
+      {
+        continue;
+      }
+      // Samples over an edge between coplanar faces land in both
+      if( std::any_of( sample_normals.cbegin(), sample_normals.cend(), [&n]( const Vector3s& other ) { return other.dot( n ) >= 1.0 - 1.0e-9; } ) )
+      {
+        continue;
+      }
+      sample_normals.emplace_back( n );
+      active_set.emplace_back( new StaticMeshBodyConstraint{ body, x0, n, q0, mesh_idx } );
+    }
+  }
+}
+
+void RigidBody3DSim::computeBodyMeshActiveSet( const VectorXs& q0, const VectorXs& q1, const std::vector<AABB>& aabbs, std::vector<std::unique_ptr<Constraint>>& active_set ) const
+{
+  assert( q0.size() == q1.size() );
+  assert( q0.size() == 12 * m_sim_state.nbodies() );
+  assert( aabbs.size() == m_sim_state.nbodies() );
+
+  std::vector<unsigned> faces;
+  for( std::vector<std::shared_ptr<const StaticTriangleMesh>>::size_type mesh_idx = 0; mesh_idx < m_sim_state.numStaticMeshes(); ++mesh_idx )
+  {
+    const StaticTriangleMesh& mesh{ m_sim_state.staticMesh( mesh_idx ) };
+    for( unsigned body = 0; body < m_sim_state.nbodies(); ++body )
+    {
+      // Skip kinematically scripted bodies
+      if( isKinematicallyScripted( body ) )
+      {
+        continue;
+      }
+
+      const RigidBodyGeometry& geometry{ m_sim_state.getGeometryOfBody( body ) };
+      if( geometry.getType() == RigidBodyGeometryType::STAPLE )
+      {
+        std::cerr << "Collision between static meshes and " << geometry.name() << " not supported. Exiting." << std::endl;
+        std::exit( EXIT_FAILURE );
+      }
+
+      const Vector3s cm0{ q0.segment<3>( 3 * body ) };
+      const Matrix33sr R0{ Eigen::Map<const Matrix33sr>{ q0.segment<9>( 3 * m_sim_state.nbodies() + 9 * body ).data() } };
+      const Vector3s cm1{ q1.segment<3>( 3 * body ) };
+      const Matrix33sr R1{ Eigen::Map<const Matrix33sr>{ q1.segment<9>( 3 * m_sim_state.nbodies() + 9 * body ).data() } };
+
+      // Gather the faces near the body over the whole step, padded so faces the body starts just behind are included
+      faces.clear();
+      mesh.facesOverlappingBox( aabbs[body].min() - mesh.thickness(), aabbs[body].max() + mesh.thickness(), faces );
+      if( faces.empty() )
+      {
+        continue;
+      }
+
+      switch( geometry.getType() )
+      {
+        case RigidBodyGeometryType::SPHERE:
+        {
+          const RigidBodySphere& sphere{ static_cast<const RigidBodySphere&>( geometry ) };
+          computeSphereMeshActiveSet( body, sphere.r(), cm0, cm1, mesh, unsigned( mesh_idx ), faces, q0, active_set );
+          break;
+        }
+        case RigidBodyGeometryType::BOX:
+        {
+          const RigidBodyBox& box{ static_cast<const RigidBodyBox&>( geometry ) };
+          Matrix3Xsc corners{ 3, 8 };
+          for( int corner = 0; corner < 8; ++corner )
+          {
+            corners.col( corner ) << ( corner & 1 ? 1.0 : -1.0 ) * box.halfWidths().x(), ( corner & 2 ? 1.0 : -1.0 ) * box.halfWidths().y(), ( corner & 4 ? 1.0 : -1.0 ) * box.halfWidths().z();
+          }
+          computeSampleMeshActiveSet( body, corners, cm0, R0, cm1, R1, mesh, unsigned( mesh_idx ), faces, q0, active_set );
+          break;
+        }
+        case RigidBodyGeometryType::TRIANGLE_MESH:
+        {
+          const RigidBodyTriangleMesh& body_mesh{ static_cast<const RigidBodyTriangleMesh&>( geometry ) };
+          computeSampleMeshActiveSet( body, body_mesh.samples(), cm0, R0, cm1, R1, mesh, unsigned( mesh_idx ), faces, q0, active_set );
+          break;
+        }
+        case RigidBodyGeometryType::CONVEX_POLYHEDRON:
+        {
+          const RigidBodyConvexPolyhedron& polyhedron{ static_cast<const RigidBodyConvexPolyhedron&>( geometry ) };
+          computeSampleMeshActiveSet( body, polyhedron.vertices(), cm0, R0, cm1, R1, mesh, unsigned( mesh_idx ), faces, q0, active_set );
+          break;
+        }
+        case RigidBodyGeometryType::CAPSULE:
+        case RigidBodyGeometryType::COMPOUND:
+        {
+          Matrix3Xsc sphere_centers;
+          VectorXs sphere_radii;
+          Matrix3Xsc corners;
+          CompoundUtilities::computeMeshSamples( geometry, sphere_centers, sphere_radii, corners );
+          for( int sphere_idx = 0; sphere_idx < sphere_centers.cols(); ++sphere_idx )
+          {
+            computeSphereMeshActiveSet( body, sphere_radii( sphere_idx ), cm0 + R0 * sphere_centers.col( sphere_idx ), cm1 + R1 * sphere_centers.col( sphere_idx ), mesh, unsigned( mesh_idx ), faces, q0, active_set );
+          }
+          computeSampleMeshActiveSet( body, corners, cm0, R0, cm1, R1, mesh, unsigned( mesh_idx ), faces, q0, active_set );
+          break;
+        }
+        case RigidBodyGeometryType::CLUMP:
+        {
+          const RigidBodyClump& clump{ static_cast<const RigidBodyClump&>( geometry ) };
+          for( unsigned sphere_idx = 0; sphere_idx < clump.numSpheres(); ++sphere_idx )
+          {
+            computeSphereMeshActiveSet( body, clump.radii()( sphere_idx ), cm0 + R0 * clump.centers().col( sphere_idx ), cm1 + R1 * clump.centers().col( sphere_idx ), mesh, unsigned( mesh_idx ), faces, q0, active_set );
+          }
+          break;
+        }
+        case RigidBodyGeometryType::STAPLE:
+          break;
+      }
+    }
+  }
+}
+
 #ifdef USE_HDF5
 void RigidBody3DSim::writeBinaryState( HDF5File& output_file ) const
+{
+  writeStaticBinaryState( output_file, "" );
+  // Write out the state of each body
+  output_file.write( "state/q", m_sim_state.q() );
+  output_file.write( "state/v", m_sim_state.v() );
+}
+
+void RigidBody3DSim::writeStaticBinaryState( HDF5File& output_file, const std::string& group ) const
 {
   // Output the simulated geometry
-  StateOutput::writeGeometryIndices( m_sim_state.geometry(), m_sim_state.indices(), "geometry", output_file );
-  StateOutput::writeGeometry( m_sim_state.geometry(), "geometry", output_file );
+  StateOutput::writeGeometryIndices( m_sim_state.geometry(), m_sim_state.indices(), group + "/geometry", output_file );
+  StateOutput::writeGeometry( m_sim_state.geometry(), group + "/geometry", output_file );
   // Output the static geometry
   if( !m_sim_state.staticPlanes().empty() )
   {
-    StateOutput::writeStaticPlanes( m_sim_state.staticPlanes(), "static_geometry", output_file );
+    StateOutput::writeStaticPlanes( m_sim_state.staticPlanes(), group + "/static_geometry", output_file );
   }
   if( !m_sim_state.staticCylinders().empty() )
   {
-    StateOutput::writeStaticCylinders( m_sim_state.staticCylinders(), "static_geometry", output_file );
+    StateOutput::writeStaticCylinders( m_sim_state.staticCylinders(), group + "/static_geometry", output_file );
   }
-  // Write out the state of each body
-  output_file.write( "state/q", m_sim_state.q() );
-  output_file.write( "state/v", m_sim_state.v() );
-  output_file.write( "state/M0", m_sim_state.M0() );
+  output_file.write( group + "/state/M0", m_sim_state.M0() );
+  output_file.write( group + "/state/kinematically_scripted", kinematicallyScriptedFlags() );
+}
+#endif
+
+VectorXs RigidBody3DSim::staticGeometryState() const
+{
+  VectorXs state{ 13 * m_sim_state.numStaticPlanes() + 14 * m_sim_state.numStaticCylinders() };
+  int offset{ 0 };
+  for( const StaticPlane& plane : m_sim_state.staticPlanes() )
   {
-    VectorXu fixed{ m_sim_state.nbodies() };
-    for( unsigned body_index = 0; body_index < m_sim_state.nbodies(); ++body_index )
-    {
-      fixed( body_index ) = m_sim_state.isKinematicallyScripted( body_index ) ? 1 : 0;
-    }
-    output_file.write( "state/kinematically_scripted", fixed );
+    state.segment<3>( offset ) = plane.x();
+    state.segment<4>( offset + 3 ) = plane.R().coeffs();
+    state.segment<3>( offset + 7 ) = plane.v();
+    state.segment<3>( offset + 10 ) = plane.omega();
+    offset += 13;
   }
+  for( const StaticCylinder& cylinder : m_sim_state.staticCylinders() )
+  {
+    state.segment<3>( offset ) = cylinder.x();
+    state.segment<4>( offset + 3 ) = cylinder.R().coeffs();
+    state.segment<3>( offset + 7 ) = cylinder.v();
+    state.segment<3>( offset + 10 ) = cylinder.omega();
+    state( offset + 13 ) = cylinder.r();
+    offset += 14;
+  }
+  assert( offset == state.size() );
+  return state;
+}
+
+VectorXu RigidBody3DSim::kinematicallyScriptedFlags() const
+{
+  VectorXu fixed{ m_sim_state.nbodies() };
+  for( unsigned body_index = 0; body_index < m_sim_state.nbodies(); ++body_index )
+  {
+    fixed( body_index ) = m_sim_state.isKinematicallyScripted( body_index ) ? 1 : 0;
+  }
+  return fixed;
 }
-#endif
 
 void RigidBody3DSim::serialize( std::ostream& output_stream ) const
 {
@@ -1517,6 +2385,7 @@ void RigidBody3DSim::serialize( std::ostream& output_stream ) const
   m_sim_state.serialize( output_stream );
   // Nothing to serialize for m_impact_map
   m_constraint_cache.serialize( output_stream );
+  m_box_box_axes.serialize( output_stream );
 }
 
 void RigidBody3DSim::deserialize( std::istream& input_stream )
@@ -1525,6 +2394,23 @@ void RigidBody3DSim::deserialize( std::istream& input_stream )
   m_sim_state.deserialize( input_stream );
   // Nothing to deserialize for m_impact_map
   m_constraint_cache.deserialize( input_stream );
+  m_box_box_axes.deserialize( input_stream );
+}
+
+void RigidBody3DSim::writeCheckpoint( CheckpointWriter& checkpoint ) const
+{
+  m_sim_state.writeCheckpoint( "state/", checkpoint );
+  // Nothing to checkpoint for m_impact_map
+  m_constraint_cache.writeCheckpoint( "constraint_cache/", checkpoint );
+  m_box_box_axes.writeCheckpoint( "box_box_axes/", checkpoint );
+}
+
+void RigidBody3DSim::readCheckpoint( const CheckpointReader& checkpoint )
+{
+  m_sim_state.readCheckpoint( "state/", checkpoint );
+  // Nothing to restore for m_impact_map
+  m_constraint_cache.readCheckpoint( "constraint_cache/", checkpoint );
+  m_box_box_axes.readCheckpoint( "box_box_axes/", checkpoint );
 }
 
 ImpactMap& RigidBody3DSim::impactMap()
@@ -18,6 +18,7 @@
 
 #include "RigidBody3DState.h"
 #include "ConstraintCache.h"
+#include "BoxBoxAxisCache.h"
 
 class UnconstrainedMap;
 class ImpactOperator;
@@ -28,8 +29,10 @@ class RigidBodyStaple;
 class RigidBodyTriangleMesh;
 class AABB;
 class TeleportedCollision;
+class CheckpointWriter;
+class CheckpointReader;
 class FrictionSolver;
-class PythonScripting;
+class RigidBody3DScriptingCallback;
 template<typename T> class Rational;
 
 #ifdef USE_HDF5
@@ -95,59 +98,99 @@ public:
   virtual void cacheConstraint( const Constraint& constraint, const VectorXs& r ) override;
   virtual void getCachedConstraintImpulse( const Constraint& constraint, VectorXs& r ) const override;
   virtual bool constraintCacheEmpty() const override;
+  virtual void computeRestitutionCoefficients( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& CoR ) const override;
+  virtual void computeFrictionCoefficients( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu ) const override;
 
-  // Computes the number of collisions in the current state and the total amount of penetration
+  // Computes the number of collisions in the current state and the total amount of penetration; sleeping islands and
+  // cached separating axes are left as they were, so this can be called between steps without changing the simulation
   void computeNumberOfCollisions( std::map<std::string,unsigned>& collision_counts, std::map<std::string,scalar>& collision_depths, std::map<std::string,scalar>& overlap_volumes );
 
+  // Deepest penetration over the active constraints in the current state, or zero if nothing overlaps; leaves the
+  // simulation unchanged as computeNumberOfCollisions does
+  scalar computeMaxPenetrationDepth();
+
   // Flow using only an unconstrained map
-  void flow( PythonScripting& call_back, const unsigned iteration, const Rational<std::intmax_t>& dt, UnconstrainedMap& umap );
+  void flow( RigidBody3DScriptingCallback& call_back, const unsigned iteration, const Rational<std::intmax_t>& dt, UnconstrainedMap& umap );
 
   // Flow using an unconstrained map and an impact map
-  void flow( PythonScripting& call_back, const unsigned iteration, const Rational<std::intmax_t>& dt, UnconstrainedMap& umap, ImpactOperator& imap, const scalar& CoR );
+  void flow( RigidBody3DScriptingCallback& call_back, const unsigned iteration, const Rational<std::intmax_t>& dt, UnconstrainedMap& umap, ImpactOperator& imap, const scalar& CoR );
 
   // Flow using an unconstrained map, an impact map, and a friction map
-  void flow( PythonScripting& call_back, const unsigned iteration, const Rational<std::intmax_t>& dt, UnconstrainedMap& umap, const scalar& CoR, const scalar& mu, FrictionSolver& solver, ImpactFrictionMap& ifmap );
+  void flow( RigidBody3DScriptingCallback& call_back, const unsigned iteration, const Rational<std::intmax_t>& dt, UnconstrainedMap& umap, const scalar& CoR, const scalar& mu, FrictionSolver& solver, ImpactFrictionMap& ifmap );
 
   const RigidBody3DState& state() const;
 
   RigidBody3DState& state();
 
+  // Position, orientation (as an x, y, z, w quaternion), velocity, and angular velocity of each static plane,
+  // followed by the same and the radius of each static cylinder; scripts may change these every step
+  VectorXs staticGeometryState() const;
+  // 1 for each body the simulation holds fixed, either because it is scripted or asleep
+  VectorXu kinematicallyScriptedFlags() const;
+
   #ifdef USE_HDF5
   void writeBinaryState( HDF5File& output_file ) const;
+  // Writes the data that does not change between frames to the given group
+  void writeStaticBinaryState( HDF5File& output_file, const std::string& group ) const;
   #endif
 
   void serialize( std::ostream& output_stream ) const;
   void deserialize( std::istream& input_stream );
 
+  void writeCheckpoint( CheckpointWriter& checkpoint ) const;
+  void readCheckpoint( const CheckpointReader& checkpoint );
+
   ImpactMap& impactMap();
 
 private:
 
   void enforcePeriodicBoundaryConditions();
 
-  void boxBoxNarrowPhaseCollision( const unsigned first_body, const unsigned second_body, const RigidBodyBox& box0, const RigidBodyBox& box1, const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
+  // Active set in the current state, restoring the sleeping islands and separating axis cache it updates
+  void computeMeasurementActiveSet( std::vector<std::unique_ptr<Constraint>>& active_set );
+
+  void updateSleepingIslandsStartOfStep();
+  void updateSleepingIslandsEndOfStep( const scalar& dt );
+  // True if a kinematically scripted body has a nonzero velocity or moves between q0 and q1
+  bool scriptedBodyMoves( const unsigned bdy_idx, const VectorXs& q0, const VectorXs& q1 ) const;
+  // Returns true if either body is asleep, queueing a sleeping body touched by a simulated or moving scripted body for waking
+  bool sleepingPairSkipped( const unsigned bdy_idx_0, const unsigned bdy_idx_1, const VectorXs& q0, const VectorXs& q1, std::vector<unsigned>& bodies_to_wake ) const;
+  // Queues sleeping bodies whose bounding boxes touch static planes or cylinders with a nonzero velocity
+  void sleepersTouchingMovingStaticGeometry( const std::vector<AABB>& aabbs, std::vector<unsigned>& bodies_to_wake ) const;
+
+  // axis_code: separating axis from the previous step on input, axis found this step on output
+  void boxBoxNarrowPhaseCollision( const unsigned first_body, const unsigned second_body, const RigidBodyBox& box0, const RigidBodyBox& box1, const VectorXs& q0, const VectorXs& q1, int& axis_code, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
   [[noreturn]] void boxSphereNarrowPhaseCollision( const unsigned first_body, const unsigned second_body, const RigidBodyBox& box, const RigidBodySphere& sphere, const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
   void sphereSphereNarrowPhaseCollision( const unsigned first_body, const unsigned second_body, const RigidBodySphere& sphere0, const RigidBodySphere& sphere1, const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
   void stapleStapleNarrowPhaseCollision( const unsigned first_body, const unsigned second_body, const RigidBodyStaple& staple0, const RigidBodyStaple& staple1, const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
   void meshMeshNarrowPhaseCollision( const unsigned first_body, const unsigned second_body, const RigidBodyTriangleMesh& mesh0, const RigidBodyTriangleMesh& mesh1, const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
-  void dispatchNarrowPhaseCollision( const unsigned first_body, const unsigned second_body, const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
+  // Collisions between pairs of convex polyhedra and boxes
+  void convexPolyhedronNarrowPhaseCollision( const unsigned first_body, const unsigned second_body, const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
+  // Collisions where either body is a capsule or compound, and the other is a sphere, box, capsule or compound
+  void compoundNarrowPhaseCollision( const unsigned first_body, const unsigned second_body, const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
+  void clumpNarrowPhaseCollision( const unsigned first_body, const unsigned second_body, const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
+  void dispatchNarrowPhaseCollision( const unsigned first_body, const unsigned second_body, const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set );
   bool collisionIsActive( const unsigned first_body, const unsigned second_body, const VectorXs& q0, const VectorXs& q1 ) const;
 
-  void generateAABBs( std::vector<AABB>& aabbs, const VectorXs& q );
+  // Bounding boxes swept over the step from q0 to q1
+  void generateAABBs( std::vector<AABB>& aabbs, const VectorXs& q0, const VectorXs& q1 );
 
   bool teleportedCollisionHappens( const VectorXs& q, const TeleportedCollision& teleported_collision ) const;
   void getTeleportedCollisionCenters( const VectorXs& q, const TeleportedCollision& teleported_collision, Vector3s& x0, Vector3s& x1 ) const;
   void generateTeleportedCollision( const VectorXs& q, const TeleportedCollision& teleported_collision, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
 
-  void computeActiveSetBodyBodySpatialGrid( const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set );
+  void computeActiveSetBodyBodySpatialGrid( const VectorXs& q0, const VectorXs& q1, const std::vector<AABB>& body_aabbs, std::vector<std::unique_ptr<Constraint>>& active_set, std::vector<unsigned>& bodies_to_wake );
   //void computeActiveSetBodyBodyAllPairs( const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
 
-  void computeBodyPlaneActiveSetAllPairs( const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
-  void computeBodyCylinderActiveSetAllPairs( const VectorXs& q0, const VectorXs& q1, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
+  // Static geometry is only tested against bodies whose swept AABBs can reach it
+  void computeBodyPlaneActiveSet( const VectorXs& q0, const VectorXs& q1, const std::vector<AABB>& aabbs, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
+  void computeBodyCylinderActiveSet( const VectorXs& q0, const VectorXs& q1, const std::vector<AABB>& aabbs, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
+  void computeBodyMeshActiveSet( const VectorXs& q0, const VectorXs& q1, const std::vector<AABB>& aabbs, std::vector<std::unique_ptr<Constraint>>& active_set ) const;
 
   RigidBody3DState m_sim_state;
   ImpactMap m_impact_map;
   ConstraintCache m_constraint_cache;
+  BoxBoxAxisCache m_box_box_axes;
 
 };
 
@@ -8,16 +8,22 @@
 #include "scisim/Math/MathUtilities.h"
 #include "scisim/StringUtilities.h"
 #include "scisim/Utilities.h"
+#include "scisim/Checkpoint.h"
 
 #include "Geometry/RigidBodyBox.h"
 #include "Geometry/RigidBodySphere.h"
 #include "Geometry/RigidBodyTriangleMesh.h"
+#include "Geometry/RigidBodyConvexPolyhedron.h"
+#include "Geometry/RigidBodyCapsule.h"
+#include "Geometry/RigidBodyCompound.h"
+#include "Geometry/RigidBodyClump.h"
 
 #include "Forces/NearEarthGravityForce.h"
 
 #include "StaticGeometry/StaticPlane.h"
 
 #include <iostream>
+#include <sstream>
 
 RigidBody3DState::RigidBody3DState()
 : m_nbodies( 0 )
@@ -33,7 +39,10 @@ RigidBody3DState::RigidBody3DState()
 , m_forces()
 , m_static_planes()
 , m_static_cylinders()
+, m_static_meshes()
 , m_planar_portals()
+, m_sleeping_islands()
+, m_materials()
 {}
 
 RigidBody3DState::RigidBody3DState( const RigidBody3DState& other )
@@ -45,12 +54,15 @@ RigidBody3DState::RigidBody3DState( const RigidBody3DState& other )
 , m_M( other.m_M )
 , m_Minv( other.m_Minv )
 , m_fixed( other.m_fixed )
-, m_geometry( Utilities::clone( other.m_geometry ) )
+, m_geometry( other.m_geometry )
 , m_geometry_indices( other.m_geometry_indices )
 , m_forces( Utilities::clone( other.m_forces ) )
 , m_static_planes( other.m_static_planes )
 , m_static_cylinders( other.m_static_cylinders )
+, m_static_meshes( other.m_static_meshes )
 , m_planar_portals( other.m_planar_portals )
+, m_sleeping_islands( other.m_sleeping_islands )
+, m_materials( other.m_materials )
 {}
 
 RigidBody3DState& RigidBody3DState::operator=( const RigidBody3DState& other )
@@ -233,7 +245,7 @@ static SparseMatrixsc formWorldSpaceInverseMassMatrix( const std::vector<scalar>
   return Mbody;
 }
 
-void RigidBody3DState::setState( const std::vector<Vector3s>& X, const std::vector<Vector3s>& V, const std::vector<scalar>& M, const std::vector<VectorXs>& R, const std::vector<Vector3s>& omega, const std::vector<Vector3s>& I0, const std::vector<bool>& fixed, const std::vector<unsigned>& geom_indices, const std::vector<std::unique_ptr<RigidBodyGeometry>>& geometry )
+void RigidBody3DState::setState( const std::vector<Vector3s>& X, const std::vector<Vector3s>& V, const std::vector<scalar>& M, const std::vector<VectorXs>& R, const std::vector<Vector3s>& omega, const std::vector<Vector3s>& I0, const std::vector<bool>& fixed, const std::vector<unsigned>& geom_indices, std::vector<std::unique_ptr<RigidBodyGeometry>> geometry )
 {
   assert( X.size() == V.size() );
   assert( X.size() == M.size() );
@@ -294,9 +306,11 @@ void RigidBody3DState::setState( const std::vector<Vector3s>& X, const std::vect
 
   m_fixed = fixed;
   m_geometry_indices = geom_indices;
+  m_sleeping_islands.resize( m_nbodies );
+  m_materials.resize( m_nbodies );
 
-  // Load the geometry
-  m_geometry = Utilities::clone( geometry );
+  // Take ownership of the geometry
+  m_geometry.assign( std::make_move_iterator( geometry.begin() ), std::make_move_iterator( geometry.end() ) );
   assert( std::all_of( m_geometry.cbegin(), m_geometry.cend(), []( const auto& geo ) { return geo != nullptr; } ) );
   assert( std::all_of( m_geometry_indices.cbegin(), m_geometry_indices.cend(), [this]( const auto idx ) { return idx < m_geometry.size(); } ) );
 }
@@ -377,7 +391,38 @@ bool RigidBody3DState::isKinematicallyScripted( const unsigned bdy_idx ) const
   return m_fixed[bdy_idx];
 }
 
-const std::vector<std::unique_ptr<RigidBodyGeometry>>& RigidBody3DState::geometry() const
+const std::vector<bool>& RigidBody3DState::fixed() const
+{
+  return m_fixed;
+}
+
+SleepingIslands& RigidBody3DState::sleepingIslands()
+{
+  return m_sleeping_islands;
+}
+
+const SleepingIslands& RigidBody3DState::sleepingIslands() const
+{
+  return m_sleeping_islands;
+}
+
+bool RigidBody3DState::asleep( const unsigned bdy_idx ) const
+{
+  assert( bdy_idx < m_nbodies );
+  return m_sleeping_islands.enabled() && m_sleeping_islands.asleep( bdy_idx );
+}
+
+MaterialTable& RigidBody3DState::materials()
+{
+  return m_materials;
+}
+
+const MaterialTable& RigidBody3DState::materials() const
+{
+  return m_materials;
+}
+
+const std::vector<std::shared_ptr<const RigidBodyGeometry>>& RigidBody3DState::geometry() const
 {
   return m_geometry;
 }
@@ -523,6 +568,22 @@ std::vector<StaticCylinder>::size_type RigidBody3DState::numStaticCylinders() co
   return m_static_cylinders.size();
 }
 
+void RigidBody3DState::addStaticMesh( const StaticTriangleMesh& new_mesh )
+{
+  m_static_meshes.emplace_back( std::make_shared<const StaticTriangleMesh>( new_mesh ) );
+}
+
+const StaticTriangleMesh& RigidBody3DState::staticMesh( const std::vector<std::shared_ptr<const StaticTriangleMesh>>::size_type mesh_index ) const
+{
+  assert( mesh_index < m_static_meshes.size() );
+  return *m_static_meshes[mesh_index];
+}
+
+std::vector<std::shared_ptr<const StaticTriangleMesh>>::size_type RigidBody3DState::numStaticMeshes() const
+{
+  return m_static_meshes.size();
+}
+
 void RigidBody3DState::addPlanarPortal( const PlanarPortal& planar_portal )
 {
   m_planar_portals.emplace_back( planar_portal );
@@ -556,15 +617,18 @@ void RigidBody3DState::serialize( std::ostream& output_stream ) const
   Utilities::serialize( m_forces, output_stream );
   Utilities::serialize( m_static_planes, output_stream );
   Utilities::serialize( m_static_cylinders, output_stream );
+  Utilities::serialize( m_static_meshes, output_stream );
   Utilities::serialize( m_planar_portals, output_stream );
+  m_sleeping_islands.serialize( output_stream );
+  m_materials.serialize( output_stream );
 }
 
-static std::vector<std::unique_ptr<RigidBodyGeometry>> deserializeGeometry( std::istream& input_stream )
+static std::vector<std::shared_ptr<const RigidBodyGeometry>> deserializeGeometry( std::istream& input_stream )
 {
-  const std::vector<std::unique_ptr<RigidBodyGeometry>>::size_type ngeo{ Utilities::deserialize<std::vector<std::unique_ptr<RigidBodyGeometry>>::size_type>( input_stream ) };
-  std::vector<std::unique_ptr<RigidBodyGeometry>> geometry( ngeo );
+  const std::vector<std::shared_ptr<const RigidBodyGeometry>>::size_type ngeo{ Utilities::deserialize<std::vector<std::shared_ptr<const RigidBodyGeometry>>::size_type>( input_stream ) };
+  std::vector<std::shared_ptr<const RigidBodyGeometry>> geometry( ngeo );
   assert( geometry.size() == ngeo );
-  for( std::vector<std::unique_ptr<RigidBodyGeometry>>::size_type geo_idx = 0; geo_idx < geometry.size(); ++geo_idx )
+  for( std::vector<std::shared_ptr<const RigidBodyGeometry>>::size_type geo_idx = 0; geo_idx < geometry.size(); ++geo_idx )
   {
     // Read in the geometry type
     const RigidBodyGeometryType geo_type{ Utilities::deserialize<RigidBodyGeometryType>( input_stream ) };
@@ -583,11 +647,34 @@ static std::vector<std::unique_ptr<RigidBodyGeometry>> deserializeGeometry( std:
       case RigidBodyGeometryType::TRIANGLE_MESH:
         geometry[geo_idx].reset( new RigidBodyTriangleMesh{ input_stream } );
         break;
+      case RigidBodyGeometryType::CONVEX_POLYHEDRON:
+        geometry[geo_idx].reset( new RigidBodyConvexPolyhedron{ input_stream } );
+        break;
+      case RigidBodyGeometryType::CAPSULE:
+        geometry[geo_idx].reset( new RigidBodyCapsule{ input_stream } );
+        break;
+      case RigidBodyGeometryType::COMPOUND:
+        geometry[geo_idx].reset( new RigidBodyCompound{ input_stream } );
+        break;
+      case RigidBodyGeometryType::CLUMP:
+        geometry[geo_idx].reset( new RigidBodyClump{ input_stream } );
+        break;
     }
   }
   return geometry;
 }
 
+static std::vector<std::shared_ptr<const StaticTriangleMesh>> deserializeStaticMeshes( std::istream& input_stream )
+{
+  const std::vector<std::shared_ptr<const StaticTriangleMesh>>::size_type nmeshes{ Utilities::deserialize<std::vector<std::shared_ptr<const StaticTriangleMesh>>::size_type>( input_stream ) };
+  std::vector<std::shared_ptr<const StaticTriangleMesh>> meshes( nmeshes );
+  for( std::vector<std::shared_ptr<const StaticTriangleMesh>>::size_type mesh_idx = 0; mesh_idx < meshes.size(); ++mesh_idx )
+  {
+    meshes[mesh_idx] = std::make_shared<const StaticTriangleMesh>( input_stream );
+  }
+  return meshes;
+}
+
 static std::vector<std::unique_ptr<Force>> deserializeForces( std::istream& input_stream )
 {
   const std::vector<std::unique_ptr<Force>>::size_type nforces{ Utilities::deserialize<std::vector<std::unique_ptr<Force>>::size_type>( input_stream ) };
@@ -626,5 +713,158 @@ void RigidBody3DState::deserialize( std::istream& input_stream )
   m_forces = deserializeForces( input_stream );
   m_static_planes = Utilities::deserializeVector<StaticPlane>( input_stream );
   m_static_cylinders = Utilities::deserializeVector<StaticCylinder>( input_stream );
+  m_static_meshes = deserializeStaticMeshes( input_stream );
   m_planar_portals = Utilities::deserializeVector<PlanarPortal>( input_stream );
+  m_sleeping_islands = SleepingIslands{ input_stream };
+  assert( m_sleeping_islands.nbodies() == m_nbodies );
+  m_materials = MaterialTable{ input_stream };
+  assert( m_materials.nbodies() == m_nbodies );
+}
+
+void RigidBody3DState::writeCheckpoint( const std::string& prefix, CheckpointWriter& checkpoint ) const
+{
+  checkpoint.addArray( prefix + "q", m_q );
+  checkpoint.addArray( prefix + "v", m_v );
+  checkpoint.addSparseMatrix( prefix + "M0", m_M0 );
+  checkpoint.addSparseMatrix( prefix + "Minv0", m_Minv0 );
+  checkpoint.addSparseMatrix( prefix + "M", m_M );
+  checkpoint.addSparseMatrix( prefix + "Minv", m_Minv );
+  {
+    VectorXu fixed{ m_nbodies };
+    for( unsigned bdy_idx = 0; bdy_idx < m_nbodies; ++bdy_idx )
+    {
+      fixed( bdy_idx ) = m_fixed[bdy_idx] ? 1 : 0;
+    }
+    checkpoint.addArray( prefix + "fixed", std::move( fixed ) );
+  }
+  checkpoint.addArray( prefix + "geometry_indices", Eigen::Map<const VectorXu>{ m_geometry_indices.data(), long( m_geometry_indices.size() ) } );
+
+  // Objects are stored in separate sections so those that do not change can be shared with an anchor
+  {
+    std::ostringstream output_stream;
+    Utilities::serialize( m_geometry, output_stream );
+    checkpoint.addSection( prefix + "geometry", output_stream.str() );
+  }
+  {
+    std::ostringstream output_stream;
+    Utilities::serialize( m_forces, output_stream );
+    checkpoint.addSection( prefix + "forces", output_stream.str() );
+  }
+  {
+    std::ostringstream output_stream;
+    Utilities::serialize( m_static_planes, output_stream );
+    checkpoint.addSection( prefix + "static_planes", output_stream.str() );
+  }
+  {
+    std::ostringstream output_stream;
+    Utilities::serialize( m_static_cylinders, output_stream );
+    checkpoint.addSection( prefix + "static_cylinders", output_stream.str() );
+  }
+  {
+    std::ostringstream output_stream;
+    Utilities::serialize( m_static_meshes, output_stream );
+    checkpoint.addSection( prefix + "static_meshes", output_stream.str() );
+  }
+  {
+    std::ostringstream output_stream;
+    Utilities::serialize( m_planar_portals, output_stream );
+    checkpoint.addSection( prefix + "planar_portals", output_stream.str() );
+  }
+  {
+    std::ostringstream output_stream;
+    m_sleeping_islands.serialize( output_stream );
+    checkpoint.addSection( prefix + "sleeping_islands", output_stream.str() );
+  }
+  {
+    std::ostringstream output_stream;
+    m_materials.serialize( output_stream );
+    checkpoint.addSection( prefix + "materials", output_stream.str() );
+  }
+}
+
+void RigidBody3DState::readCheckpoint( const std::string& prefix, const CheckpointReader& checkpoint )
+{
+  m_q = checkpoint.readArray<VectorXs>( prefix + "q" );
+  m_v = checkpoint.readArray<VectorXs>( prefix + "v" );
+  assert( m_q.size() % 12 == 0 );
+  assert( m_v.size() == m_q.size() / 2 );
+  m_nbodies = unsigned( m_q.size() / 12 );
+  checkpoint.readSparseMatrix( prefix + "M0", m_M0 );
+  checkpoint.readSparseMatrix( prefix + "Minv0", m_Minv0 );
+  checkpoint.readSparseMatrix( prefix + "M", m_M );
+  checkpoint.readSparseMatrix( prefix + "Minv", m_Minv );
+  {
+    const VectorXu fixed{ checkpoint.readArray<VectorXu>( prefix + "fixed" ) };
+    if( fixed.size() != m_nbodies )
+    {
+      throw std::string{ "Checkpoint section " } + prefix + std::string{ "fixed has the wrong number of bodies" };
+    }
+    m_fixed.resize( m_nbodies );
+    for( unsigned bdy_idx = 0; bdy_idx < m_nbodies; ++bdy_idx )
+    {
+      m_fixed[bdy_idx] = fixed( bdy_idx ) != 0;
+    }
+  }
+  {
+    const VectorXu geometry_indices{ checkpoint.readArray<VectorXu>( prefix + "geometry_indices" ) };
+    m_geometry_indices.assign( geometry_indices.data(), geometry_indices.data() + geometry_indices.size() );
+  }
+
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "geometry" };
+    m_geometry = deserializeGeometry( input_stream );
+  }
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "forces" };
+    m_forces = deserializeForces( input_stream );
+  }
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "static_planes" };
+    m_static_planes = Utilities::deserializeVector<StaticPlane>( input_stream );
+  }
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "static_cylinders" };
+    m_static_cylinders = Utilities::deserializeVector<StaticCylinder>( input_stream );
+  }
+  // Checkpoints written before static meshes were added have none
+  if( checkpoint.hasSection( prefix + "static_meshes" ) )
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "static_meshes" };
+    m_static_meshes = deserializeStaticMeshes( input_stream );
+  }
+  else
+  {
+    m_static_meshes.clear();
+  }
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "planar_portals" };
+    m_planar_portals = Utilities::deserializeVector<PlanarPortal>( input_stream );
+  }
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "sleeping_islands" };
+    m_sleeping_islands = SleepingIslands{ input_stream };
+  }
+  assert( m_sleeping_islands.nbodies() == m_nbodies );
+  // Checkpoints written before materials were added have none
+  if( checkpoint.hasSection( prefix + "materials" ) )
+  {
+    CheckpointSectionStream input_stream{ checkpoint, prefix + "materials" };
+    m_materials = MaterialTable{ input_stream };
+    if( m_materials.nbodies() != m_nbodies )
+    {
+      throw std::string{ "Checkpoint section " } + prefix + std::string{ "materials has the wrong number of bodies" };
+    }
+  }
+  else
+  {
+    m_materials = MaterialTable{};
+    m_materials.resize( m_nbodies );
+  }
+  for( const unsigned geo_idx : m_geometry_indices )
+  {
+    if( geo_idx >= m_geometry.size() )
+    {
+      throw std::string{ "Checkpoint section " } + prefix + std::string{ "geometry_indices references missing geometry" };
+    }
+  }
 }
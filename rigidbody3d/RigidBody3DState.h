@@ -13,10 +13,15 @@
 #include "scisim/Math/MathDefines.h"
 #include "Portals/PlanarPortal.h"
 #include "StaticGeometry/StaticCylinder.h"
+#include "StaticGeometry/StaticTriangleMesh.h"
 #include "Forces/Force.h"
 #include "Geometry/RigidBodyGeometry.h"
+#include "scisim/SleepingIslands.h"
+#include "scisim/Constraints/MaterialTable.h"
 
 class StaticPlane;
+class CheckpointWriter;
+class CheckpointReader;
 
 class RigidBody3DState final
 {
@@ -33,7 +38,7 @@ public:
   RigidBody3DState& operator=( const RigidBody3DState& other );
   RigidBody3DState& operator=( RigidBody3DState&& ) = default;
 
-  void setState( const std::vector<Vector3s>& X, const std::vector<Vector3s>& V, const std::vector<scalar>& M, const std::vector<VectorXs>& R, const std::vector<Vector3s>& omega, const std::vector<Vector3s>& I0, const std::vector<bool>& fixed, const std::vector<unsigned>& geom_indices, const std::vector<std::unique_ptr<RigidBodyGeometry>>& geometry );
+  void setState( const std::vector<Vector3s>& X, const std::vector<Vector3s>& V, const std::vector<scalar>& M, const std::vector<VectorXs>& R, const std::vector<Vector3s>& omega, const std::vector<Vector3s>& I0, const std::vector<bool>& fixed, const std::vector<unsigned>& geom_indices, std::vector<std::unique_ptr<RigidBodyGeometry>> geometry );
 
   unsigned nbodies() const;
   unsigned ngeo() const;
@@ -57,8 +62,19 @@ public:
   const SparseMatrixsc& Minv() const;
 
   bool isKinematicallyScripted( const unsigned bdy_idx ) const;
+  const std::vector<bool>& fixed() const;
 
-  const std::vector<std::unique_ptr<RigidBodyGeometry>>& geometry() const;
+  // Sleeping bodies are held in place by the simulation until woken
+  SleepingIslands& sleepingIslands();
+  const SleepingIslands& sleepingIslands() const;
+  bool asleep( const unsigned bdy_idx ) const;
+
+  // Material of each body and coefficients for pairs of materials
+  MaterialTable& materials();
+  const MaterialTable& materials() const;
+
+  // Geometry is immutable and shared between copies of a state; it is only ever replaced, never modified
+  const std::vector<std::shared_ptr<const RigidBodyGeometry>>& geometry() const;
 
   const std::vector<unsigned>& indices() const;
 
@@ -93,6 +109,11 @@ public:
   const std::vector<StaticCylinder>& staticCylinders() const;
   std::vector<StaticCylinder>::size_type numStaticCylinders() const;
 
+  // Static triangle meshes, which are immutable and shared between copies of the state
+  void addStaticMesh( const StaticTriangleMesh& new_mesh );
+  const StaticTriangleMesh& staticMesh( const std::vector<std::shared_ptr<const StaticTriangleMesh>>::size_type mesh_index ) const;
+  std::vector<std::shared_ptr<const StaticTriangleMesh>>::size_type numStaticMeshes() const;
+
   void addPlanarPortal( const PlanarPortal& planar_portal );
   std::vector<PlanarPortal>::size_type numPlanarPortals() const;
   const PlanarPortal& planarPortal( const std::vector<PlanarPortal>::size_type portal_index ) const;
@@ -100,6 +121,10 @@ public:
   void serialize( std::ostream& output_stream ) const;
   void deserialize( std::istream& input_stream );
 
+  // Stores q, v, the mass matrices, and the body flags as arrays under prefix; each remaining member is serialized to its own section
+  void writeCheckpoint( const std::string& prefix, CheckpointWriter& checkpoint ) const;
+  void readCheckpoint( const std::string& prefix, const CheckpointReader& checkpoint );
+
 private:
 
   unsigned m_nbodies;
@@ -110,12 +135,15 @@ private:
   SparseMatrixsc m_M;
   SparseMatrixsc m_Minv;
   std::vector<bool> m_fixed;
-  std::vector<std::unique_ptr<RigidBodyGeometry>> m_geometry;
+  std::vector<std::shared_ptr<const RigidBodyGeometry>> m_geometry;
   std::vector<unsigned> m_geometry_indices;
   std::vector<std::unique_ptr<Force>> m_forces;
   std::vector<StaticPlane> m_static_planes;
   std::vector<StaticCylinder> m_static_cylinders;
+  std::vector<std::shared_ptr<const StaticTriangleMesh>> m_static_meshes;
   std::vector<PlanarPortal> m_planar_portals;
+  SleepingIslands m_sleeping_islands;
+  MaterialTable m_materials;
 
 };
 
@@ -24,6 +24,30 @@ bool AABB::overlaps( const AABB& other ) const
   return true;
 }
 
+bool AABB::inFrontOfPlane( const Vector3s& x, const Vector3s& n ) const
+{
+  // Signed distance of the corner furthest behind the plane
+  const Array3s center{ 0.5 * ( m_min + m_max ) };
+  const Array3s half_extent{ 0.5 * ( m_max - m_min ) };
+  return n.dot( ( center - x.array() ).matrix() ) - ( n.array().abs() * half_extent ).sum() > 0.0;
+}
+
+bool AABB::insideCylinder( const Vector3s& x, const Vector3s& axis, const scalar& r ) const
+{
+  assert( fabs( axis.norm() - 1.0 ) <= 1.0e-6 );
+  // The inside of the cylinder is convex, so the box is inside if every corner is
+  for( unsigned corner = 0; corner < 8; ++corner )
+  {
+    const Vector3s p{ corner & 1 ? m_max.x() : m_min.x(), corner & 2 ? m_max.y() : m_min.y(), corner & 4 ? m_max.z() : m_min.z() };
+    const Vector3s d{ p - x - axis.dot( p - x ) * axis };
+    if( d.squaredNorm() >= r * r )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 
 
 static void computeCellIndex( const Array3s& coord, const Array3s& min_coord, const scalar& h, Array3u& index )
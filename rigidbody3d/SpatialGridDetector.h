@@ -18,6 +18,12 @@ public:
 
   bool overlaps( const AABB& other ) const;
 
+  // True if the box lies entirely in the open half-space that n points into from the plane through x
+  bool inFrontOfPlane( const Vector3s& x, const Vector3s& n ) const;
+
+  // True if the box lies strictly inside the infinite cylinder of radius r about the line through x along axis
+  bool insideCylinder( const Vector3s& x, const Vector3s& axis, const scalar& r ) const;
+
   // TODO: Remove non-const accessors, replace with constructor
   inline Array3s& min() { return m_min; }
   inline Array3s& max() { return m_max; }
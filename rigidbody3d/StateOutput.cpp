@@ -11,6 +11,10 @@
 #include "Geometry/RigidBodyBox.h"
 #include "Geometry/RigidBodySphere.h"
 #include "Geometry/RigidBodyTriangleMesh.h"
+#include "Geometry/RigidBodyConvexPolyhedron.h"
+#include "Geometry/RigidBodyCapsule.h"
+#include "Geometry/RigidBodyCompound.h"
+#include "Geometry/RigidBodyClump.h"
 #include "StaticGeometry/StaticPlane.h"
 #include "StaticGeometry/StaticCylinder.h"
 
@@ -22,14 +26,15 @@ using HDFTID = HDFID<H5Tclose>;
 using HDFSID = HDFID<H5Sclose>;
 using HDFDID = HDFID<H5Dclose>;
 
-void StateOutput::writeGeometryIndices( const std::vector<std::unique_ptr<RigidBodyGeometry>>& geometry, const std::vector<unsigned>& indices, const std::string& group, HDF5File& output_file )
+void StateOutput::writeGeometryIndices( const std::vector<std::shared_ptr<const RigidBodyGeometry>>& geometry, const std::vector<unsigned>& indices, const std::string& group, HDF5File& output_file )
 {
   // Map global indices to 'local' indices; that is, given a global index, gives the index into the particular type (e.g. global index 10 could be sphere number 3)
   VectorXu global_local_geo_mapping{ static_cast<VectorXu::Index>( geometry.size() ) };
   {
     unsigned current_geo_idx{ 0 };
-    Vector4u geo_type_local_indices{ Vector4u::Zero() };
-    for( const std::unique_ptr<RigidBodyGeometry>& current_geo : geometry )
+    // One counter per geometry type
+    VectorXu geo_type_local_indices{ VectorXu::Zero( 8 ) };
+    for( const std::shared_ptr<const RigidBodyGeometry>& current_geo : geometry )
     {
       global_local_geo_mapping( current_geo_idx++ ) = geo_type_local_indices( static_cast<int>( current_geo->getType() ) )++;
     }
@@ -78,7 +83,7 @@ void StateOutput::writeGeometryIndices( const std::vector<std::unique_ptr<RigidB
   assert( current_geo == indices.size() );
 }
 
-static void writeBoxGeometry( const std::vector<std::unique_ptr<RigidBodyGeometry>>& geometry, const unsigned box_count, const std::string& group, HDF5File& output_file )
+static void writeBoxGeometry( const std::vector<std::shared_ptr<const RigidBodyGeometry>>& geometry, const unsigned box_count, const std::string& group, HDF5File& output_file )
 {
   struct LocalBoxData
   {
@@ -129,7 +134,7 @@ static void writeBoxGeometry( const std::vector<std::unique_ptr<RigidBodyGeometr
   // Insert the box geometry one by one
   unsigned current_box{ 0 };
   LocalBoxData local_data;
-  for( const std::unique_ptr<RigidBodyGeometry>& geometry_instance : geometry )
+  for( const std::shared_ptr<const RigidBodyGeometry>& geometry_instance : geometry )
   {
     if( geometry_instance->getType() == RigidBodyGeometryType::BOX )
     {
@@ -149,7 +154,7 @@ static void writeBoxGeometry( const std::vector<std::unique_ptr<RigidBodyGeometr
   assert( current_box == box_count );
 }
 
-static void writeSphereGeometry( const std::vector<std::unique_ptr<RigidBodyGeometry>>& geometry, const unsigned sphere_count, const std::string& group, HDF5File& output_file )
+static void writeSphereGeometry( const std::vector<std::shared_ptr<const RigidBodyGeometry>>& geometry, const unsigned sphere_count, const std::string& group, HDF5File& output_file )
 {
   struct SphereData
   {
@@ -196,7 +201,7 @@ static void writeSphereGeometry( const std::vector<std::unique_ptr<RigidBodyGeom
   // Insert the spheres one by one
   unsigned current_sphere{ 0 };
   SphereData data;
-  for( const std::unique_ptr<RigidBodyGeometry>& geometry_instance : geometry )
+  for( const std::shared_ptr<const RigidBodyGeometry>& geometry_instance : geometry )
   {
     if( geometry_instance->getType() == RigidBodyGeometryType::SPHERE )
     {
@@ -216,7 +221,7 @@ static void writeSphereGeometry( const std::vector<std::unique_ptr<RigidBodyGeom
   assert( current_sphere == sphere_count );
 }
 
-static void writeMeshGeometry( const std::vector<std::unique_ptr<RigidBodyGeometry>>& geometry, const unsigned mesh_count, const std::string& group, HDF5File& output_file )
+static void writeMeshGeometry( const std::vector<std::shared_ptr<const RigidBodyGeometry>>& geometry, const unsigned mesh_count, const std::string& group, HDF5File& output_file )
 {
   struct LocalMeshData
   {
@@ -269,7 +274,7 @@ static void writeMeshGeometry( const std::vector<std::unique_ptr<RigidBodyGeomet
 
   // Insert the mesh geometry one by one
   unsigned current_mesh{ 0 };
-  for( const std::unique_ptr<RigidBodyGeometry>& geometry_instance : geometry )
+  for( const std::shared_ptr<const RigidBodyGeometry>& geometry_instance : geometry )
   {
     if( geometry_instance->getType() == RigidBodyGeometryType::TRIANGLE_MESH )
     {
@@ -289,10 +294,114 @@ static void writeMeshGeometry( const std::vector<std::unique_ptr<RigidBodyGeomet
   assert( current_mesh == mesh_count );
 }
 
-void StateOutput::writeGeometry( const std::vector<std::unique_ptr<RigidBodyGeometry>>& geometry, const std::string& group, HDF5File& output_file )
+// Polyhedra have varying numbers of vertices and faces, so each is written to its own group
+static void writeConvexPolyhedronGeometry( const std::vector<std::shared_ptr<const RigidBodyGeometry>>& geometry, const unsigned polyhedron_count, const std::string& group, HDF5File& output_file )
 {
-  Vector4u body_count{ Vector4u::Zero() };
-  for( const std::unique_ptr<RigidBodyGeometry>& geometry_instance : geometry )
+  unsigned current_polyhedron{ 0 };
+  for( const std::shared_ptr<const RigidBodyGeometry>& geometry_instance : geometry )
+  {
+    if( geometry_instance->getType() == RigidBodyGeometryType::CONVEX_POLYHEDRON )
+    {
+      const RigidBodyConvexPolyhedron& polyhedron{ static_cast<const RigidBodyConvexPolyhedron&>( *geometry_instance ) };
+      const std::string polyhedron_group{ group + "/convex_polyhedra/" + std::to_string( current_polyhedron++ ) };
+      output_file.write( polyhedron_group + "/vertices", polyhedron.vertices() );
+      output_file.write( polyhedron_group + "/faces", polyhedron.faces() );
+    }
+  }
+  assert( current_polyhedron == polyhedron_count );
+}
+
+// Radius and half length of each capsule
+static void writeCapsuleGeometry( const std::vector<std::shared_ptr<const RigidBodyGeometry>>& geometry, const unsigned capsule_count, const std::string& group, HDF5File& output_file )
+{
+  Eigen::Matrix<scalar,2,Eigen::Dynamic> capsules{ 2, capsule_count };
+  unsigned current_capsule{ 0 };
+  for( const std::shared_ptr<const RigidBodyGeometry>& geometry_instance : geometry )
+  {
+    if( geometry_instance->getType() == RigidBodyGeometryType::CAPSULE )
+    {
+      const RigidBodyCapsule& capsule{ static_cast<const RigidBodyCapsule&>( *geometry_instance ) };
+      capsules.col( current_capsule++ ) << capsule.r(), capsule.halfLength();
+    }
+  }
+  assert( current_capsule == capsule_count );
+  output_file.write( group + "/capsules", capsules );
+}
+
+// Compounds have varying numbers of children, so each is written to its own group. Each child has a geometry
+// type, a pose in the body's principal frame, and parameters: the radius for spheres, the radius and half
+// length for capsules, and the half widths for boxes.
+static void writeCompoundGeometry( const std::vector<std::shared_ptr<const RigidBodyGeometry>>& geometry, const unsigned compound_count, const std::string& group, HDF5File& output_file )
+{
+  unsigned current_compound{ 0 };
+  for( const std::shared_ptr<const RigidBodyGeometry>& geometry_instance : geometry )
+  {
+    if( geometry_instance->getType() == RigidBodyGeometryType::COMPOUND )
+    {
+      const RigidBodyCompound& compound{ static_cast<const RigidBodyCompound&>( *geometry_instance ) };
+      VectorXu types{ compound.numChildren() };
+      Matrix3Xsc positions{ 3, compound.numChildren() };
+      Eigen::Matrix<scalar,9,Eigen::Dynamic> orientations{ 9, compound.numChildren() };
+      Matrix3Xsc parameters{ Matrix3Xsc::Zero( 3, compound.numChildren() ) };
+      for( unsigned child_idx = 0; child_idx < compound.numChildren(); ++child_idx )
+      {
+        const RigidBodyGeometry& child{ compound.child( child_idx ) };
+        types( child_idx ) = unsigned( child.getType() );
+        positions.col( child_idx ) = compound.childPosition( child_idx );
+        orientations.col( child_idx ) = Eigen::Map<const Eigen::Matrix<scalar,9,1>>{ compound.childOrientation( child_idx ).data() };
+        switch( child.getType() )
+        {
+          case RigidBodyGeometryType::SPHERE:
+            parameters( 0, child_idx ) = static_cast<const RigidBodySphere&>( child ).r();
+            break;
+          case RigidBodyGeometryType::CAPSULE:
+            parameters( 0, child_idx ) = static_cast<const RigidBodyCapsule&>( child ).r();
+            parameters( 1, child_idx ) = static_cast<const RigidBodyCapsule&>( child ).halfLength();
+            break;
+          case RigidBodyGeometryType::BOX:
+            parameters.col( child_idx ) = static_cast<const RigidBodyBox&>( child ).halfWidths();
+            break;
+          case RigidBodyGeometryType::STAPLE:
+          case RigidBodyGeometryType::TRIANGLE_MESH:
+          case RigidBodyGeometryType::CONVEX_POLYHEDRON:
+          case RigidBodyGeometryType::COMPOUND:
+          case RigidBodyGeometryType::CLUMP:
+            throw std::string{ "Invalid child geometry in compound geometry" };
+        }
+      }
+      const std::string compound_group{ group + "/compounds/" + std::to_string( current_compound++ ) };
+      output_file.write( compound_group + "/types", types );
+      output_file.write( compound_group + "/positions", positions );
+      output_file.write( compound_group + "/orientations", orientations );
+      output_file.write( compound_group + "/parameters", parameters );
+    }
+  }
+  assert( current_compound == compound_count );
+}
+
+// Clumps have varying numbers of spheres, so each is written to its own group with the sphere centers in the
+// body's principal frame and the sphere radii
+static void writeClumpGeometry( const std::vector<std::shared_ptr<const RigidBodyGeometry>>& geometry, const unsigned clump_count, const std::string& group, HDF5File& output_file )
+{
+  unsigned current_clump{ 0 };
+  for( const std::shared_ptr<const RigidBodyGeometry>& geometry_instance : geometry )
+  {
+    if( geometry_instance->getType() == RigidBodyGeometryType::CLUMP )
+    {
+      const RigidBodyClump& clump{ static_cast<const RigidBodyClump&>( *geometry_instance ) };
+      const std::string clump_group{ group + "/clumps/" + std::to_string( current_clump++ ) };
+      output_file.write( clump_group + "/centers", clump.centers() );
+      output_file.write( clump_group + "/radii", clump.radii() );
+    }
+  }
+  assert( current_clump == clump_count );
+}
+
+void StateOutput::writeGeometry( const std::vector<std::shared_ptr<const RigidBodyGeometry>>& geometry, const std::string& group, HDF5File& output_file )
+{
+  // One count per geometry type
+  VectorXu body_count{ VectorXu::Zero( 8 ) };
+  for( const std::shared_ptr<const RigidBodyGeometry>& geometry_instance : geometry )
   {
     const RigidBodyGeometryType geo_type{ geometry_instance->getType() };
     switch( geo_type )
@@ -309,6 +418,18 @@ void StateOutput::writeGeometry( const std::vector<std::unique_ptr<RigidBodyGeom
       case RigidBodyGeometryType::TRIANGLE_MESH:
         ++body_count( 3 );
         break;
+      case RigidBodyGeometryType::CONVEX_POLYHEDRON:
+        ++body_count( 4 );
+        break;
+      case RigidBodyGeometryType::CAPSULE:
+        ++body_count( 5 );
+        break;
+      case RigidBodyGeometryType::COMPOUND:
+        ++body_count( 6 );
+        break;
+      case RigidBodyGeometryType::CLUMP:
+        ++body_count( 7 );
+        break;
     }
   }
   assert( body_count.sum() == geometry.size() );
@@ -330,6 +451,22 @@ void StateOutput::writeGeometry( const std::vector<std::unique_ptr<RigidBodyGeom
   {
     writeMeshGeometry( geometry, body_count( 3 ), group, output_file );
   }
+  if( body_count( 4 ) != 0 )
+  {
+    writeConvexPolyhedronGeometry( geometry, body_count( 4 ), group, output_file );
+  }
+  if( body_count( 5 ) != 0 )
+  {
+    writeCapsuleGeometry( geometry, body_count( 5 ), group, output_file );
+  }
+  if( body_count( 6 ) != 0 )
+  {
+    writeCompoundGeometry( geometry, body_count( 6 ), group, output_file );
+  }
+  if( body_count( 7 ) != 0 )
+  {
+    writeClumpGeometry( geometry, body_count( 7 ), group, output_file );
+  }
 }
 
 void StateOutput::writeStaticPlanes( const std::vector<StaticPlane>& static_planes, const std::string& group, HDF5File& output_file )
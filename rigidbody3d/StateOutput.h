@@ -20,9 +20,9 @@ class StaticCylinder;
 namespace StateOutput
 {
 
-  void writeGeometryIndices( const std::vector<std::unique_ptr<RigidBodyGeometry>>& geometry, const std::vector<unsigned>& indices, const std::string& group, HDF5File& output_file );
+  void writeGeometryIndices( const std::vector<std::shared_ptr<const RigidBodyGeometry>>& geometry, const std::vector<unsigned>& indices, const std::string& group, HDF5File& output_file );
 
-  void writeGeometry( const std::vector<std::unique_ptr<RigidBodyGeometry>>& geometry, const std::string& group, HDF5File& output_file );
+  void writeGeometry( const std::vector<std::shared_ptr<const RigidBodyGeometry>>& geometry, const std::string& group, HDF5File& output_file );
 
   void writeStaticPlanes( const std::vector<StaticPlane>& static_planes, const std::string& group, HDF5File& output_file );
 
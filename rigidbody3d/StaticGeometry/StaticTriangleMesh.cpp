@@ -0,0 +1,245 @@
+// StaticTriangleMesh.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "StaticTriangleMesh.h"
+
+#include "scisim/Utilities.h"
+#include "scisim/Math/MathUtilities.h"
+
+#include <algorithm>
+#include <numeric>
+
+// Maximum number of faces stored in a leaf of the hierarchy
+static constexpr unsigned MAX_LEAF_FACES{ 4 };
+
+StaticTriangleMesh::StaticTriangleMesh( const Matrix3Xsc& vertices, const Matrix3Xuc& faces, const scalar& thickness )
+: m_vertices( vertices )
+, m_faces( faces )
+, m_thickness( thickness )
+, m_bvh_nodes()
+, m_bvh_faces()
+{
+  assert( m_faces.cols() > 0 );
+  assert( ( m_faces.array() < unsigned( m_vertices.cols() ) ).all() );
+  assert( m_thickness > 0.0 );
+  buildBVH();
+}
+
+StaticTriangleMesh::StaticTriangleMesh( std::istream& input_stream )
+: m_vertices( MathUtilities::deserialize<Matrix3Xsc>( input_stream ) )
+, m_faces( MathUtilities::deserialize<Matrix3Xuc>( input_stream ) )
+, m_thickness( Utilities::deserialize<scalar>( input_stream ) )
+, m_bvh_nodes()
+, m_bvh_faces()
+{
+  assert( ( m_faces.array() < unsigned( m_vertices.cols() ) ).all() );
+  assert( m_thickness > 0.0 );
+  buildBVH();
+}
+
+const Matrix3Xsc& StaticTriangleMesh::vertices() const
+{
+  return m_vertices;
+}
+
+const Matrix3Xuc& StaticTriangleMesh::faces() const
+{
+  return m_faces;
+}
+
+const scalar& StaticTriangleMesh::thickness() const
+{
+  return m_thickness;
+}
+
+Vector3s StaticTriangleMesh::faceNormal( const unsigned face ) const
+{
+  assert( face < m_faces.cols() );
+  const Vector3s v0{ m_vertices.col( m_faces( 0, face ) ) };
+  const Vector3s v1{ m_vertices.col( m_faces( 1, face ) ) };
+  const Vector3s v2{ m_vertices.col( m_faces( 2, face ) ) };
+  return ( v1 - v0 ).cross( v2 - v0 ).normalized();
+}
+
+void StaticTriangleMesh::facesOverlappingBox( const Array3s& min, const Array3s& max, std::vector<unsigned>& faces ) const
+{
+  assert( ( min <= max ).all() );
+  if( m_bvh_nodes.empty() )
+  {
+    return;
+  }
+  std::vector<unsigned> stack{ 0 };
+  while( !stack.empty() )
+  {
+    const BVHNode& node{ m_bvh_nodes[stack.back()] };
+    stack.pop_back();
+    if( ( node.max < min ).any() || ( node.min > max ).any() )
+    {
+      continue;
+    }
+    if( node.count == 0 )
+    {
+      stack.emplace_back( node.first );
+      stack.emplace_back( node.first + 1 );
+      continue;
+    }
+    for( unsigned entry = node.first; entry < node.first + node.count; ++entry )
+    {
+      const unsigned face{ m_bvh_faces[entry] };
+      const Array3s v0{ m_vertices.col( m_faces( 0, face ) ).array() };
+      const Array3s v1{ m_vertices.col( m_faces( 1, face ) ).array() };
+      const Array3s v2{ m_vertices.col( m_faces( 2, face ) ).array() };
+      if( ( v0.max( v1 ).max( v2 ) >= min ).all() && ( v0.min( v1 ).min( v2 ) <= max ).all() )
+      {
+        faces.emplace_back( face );
+      }
+    }
+  }
+}
+
+// Real-Time Collision Detection, Christer Ericson, Section 5.1.5
+Vector3s StaticTriangleMesh::closestPointOnFace( const unsigned face, const Vector3s& x ) const
+{
+  assert( face < m_faces.cols() );
+  const Vector3s a{ m_vertices.col( m_faces( 0, face ) ) };
+  const Vector3s b{ m_vertices.col( m_faces( 1, face ) ) };
+  const Vector3s c{ m_vertices.col( m_faces( 2, face ) ) };
+
+  const Vector3s ab{ b - a };
+  const Vector3s ac{ c - a };
+  const Vector3s ax{ x - a };
+  const scalar d1{ ab.dot( ax ) };
+  const scalar d2{ ac.dot( ax ) };
+  if( d1 <= 0.0 && d2 <= 0.0 )
+  {
+    return a;
+  }
+
+  const Vector3s bx{ x - b };
+  const scalar d3{ ab.dot( bx ) };
+  const scalar d4{ ac.dot( bx ) };
+  if( d3 >= 0.0 && d4 <= d3 )
+  {
+    return b;
+  }
+
+  const scalar vc{ d1 * d4 - d3 * d2 };
+  if( vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0 )
+  {
+    return a + ( d1 / ( d1 - d3 ) ) * ab;
+  }
+
+  const Vector3s cx{ x - c };
+  const scalar d5{ ab.dot( cx ) };
+  const scalar d6{ ac.dot( cx ) };
+  if( d6 >= 0.0 && d5 <= d6 )
+  {
+    return c;
+  }
+
+  const scalar vb{ d5 * d2 - d1 * d6 };
+  if( vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0 )
+  {
+    return a + ( d2 / ( d2 - d6 ) ) * ac;
+  }
+
+  const scalar va{ d3 * d6 - d5 * d4 };
+  if( va <= 0.0 && ( d4 - d3 ) >= 0.0 && ( d5 - d6 ) >= 0.0 )
+  {
+    return b + ( ( d4 - d3 ) / ( ( d4 - d3 ) + ( d5 - d6 ) ) ) * ( c - b );
+  }
+
+  const scalar denom{ 1.0 / ( va + vb + vc ) };
+  return a + ab * ( vb * denom ) + ac * ( vc * denom );
+}
+
+bool StaticTriangleMesh::projectsOntoFace( const unsigned face, const Vector3s& x ) const
+{
+  assert( face < m_faces.cols() );
+  const Vector3s a{ m_vertices.col( m_faces( 0, face ) ) };
+  const Vector3s b{ m_vertices.col( m_faces( 1, face ) ) };
+  const Vector3s c{ m_vertices.col( m_faces( 2, face ) ) };
+  const Vector3s n{ ( b - a ).cross( c - a ) };
+  // Each edge must see x on the same side as the interior of the face
+  return n.dot( ( b - a ).cross( x - a ) ) >= 0.0 && n.dot( ( c - b ).cross( x - b ) ) >= 0.0 && n.dot( ( a - c ).cross( x - c ) ) >= 0.0;
+}
+
+void StaticTriangleMesh::serialize( std::ostream& output_stream ) const
+{
+  assert( output_stream.good() );
+  MathUtilities::serialize( m_vertices, output_stream );
+  MathUtilities::serialize( m_faces, output_stream );
+  Utilities::serialize( m_thickness, output_stream );
+}
+
+void StaticTriangleMesh::buildBVH()
+{
+  m_bvh_nodes.clear();
+  m_bvh_faces.resize( m_faces.cols() );
+  std::iota( m_bvh_faces.begin(), m_bvh_faces.end(), 0 );
+  if( m_bvh_faces.empty() )
+  {
+    return;
+  }
+
+  std::vector<Vector3s> centroids( m_faces.cols() );
+  for( unsigned face = 0; face < m_faces.cols(); ++face )
+  {
+    centroids[face] = ( m_vertices.col( m_faces( 0, face ) ) + m_vertices.col( m_faces( 1, face ) ) + m_vertices.col( m_faces( 2, face ) ) ) / 3.0;
+  }
+
+  // A binary tree with leaves of at least one face has fewer than twice as many nodes as faces
+  m_bvh_nodes.reserve( 2 * m_bvh_faces.size() );
+  m_bvh_nodes.emplace_back();
+  buildBVHNode( 0, 0, unsigned( m_bvh_faces.size() ), centroids );
+}
+
+// Fills in a node with faces [begin, end) of m_bvh_faces, splitting at the median centroid along the longest
+// axis of the centroids' bounds
+void StaticTriangleMesh::buildBVHNode( const unsigned node_idx, const unsigned begin, const unsigned end, const std::vector<Vector3s>& centroids )
+{
+  assert( node_idx < m_bvh_nodes.size() );
+  assert( begin < end );
+
+  Array3s min{ Array3s::Constant( SCALAR_INFINITY ) };
+  Array3s max{ Array3s::Constant( -SCALAR_INFINITY ) };
+  Array3s centroid_min{ Array3s::Constant( SCALAR_INFINITY ) };
+  Array3s centroid_max{ Array3s::Constant( -SCALAR_INFINITY ) };
+  for( unsigned entry = begin; entry < end; ++entry )
+  {
+    const unsigned face{ m_bvh_faces[entry] };
+    for( unsigned vrt = 0; vrt < 3; ++vrt )
+    {
+      min = min.min( m_vertices.col( m_faces( vrt, face ) ).array() );
+      max = max.max( m_vertices.col( m_faces( vrt, face ) ).array() );
+    }
+    centroid_min = centroid_min.min( centroids[face].array() );
+    centroid_max = centroid_max.max( centroids[face].array() );
+  }
+  m_bvh_nodes[node_idx].min = min;
+  m_bvh_nodes[node_idx].max = max;
+
+  if( end - begin <= MAX_LEAF_FACES )
+  {
+    m_bvh_nodes[node_idx].first = begin;
+    m_bvh_nodes[node_idx].count = end - begin;
+    return;
+  }
+
+  int axis;
+  ( centroid_max - centroid_min ).maxCoeff( &axis );
+  const unsigned middle{ begin + ( end - begin ) / 2 };
+  std::nth_element( m_bvh_faces.begin() + begin, m_bvh_faces.begin() + middle, m_bvh_faces.begin() + end,
+                    [&centroids, axis]( const unsigned face0, const unsigned face1 ) { return centroids[face0]( axis ) < centroids[face1]( axis ); } );
+
+  // Children are stored next to each other so a node only needs the index of the first
+  const unsigned first_child{ unsigned( m_bvh_nodes.size() ) };
+  m_bvh_nodes[node_idx].first = first_child;
+  m_bvh_nodes[node_idx].count = 0;
+  m_bvh_nodes.emplace_back();
+  m_bvh_nodes.emplace_back();
+  buildBVHNode( first_child, begin, middle, centroids );
+  buildBVHNode( first_child + 1, middle, end, centroids );
+}
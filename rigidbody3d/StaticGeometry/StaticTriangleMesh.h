@@ -0,0 +1,71 @@
+// StaticTriangleMesh.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Immovable triangle mesh for boundary geometry such as hoppers, chutes, and mixers. Faces are one sided,
+// with counter-clockwise winding about the outward normal, and bodies collide with the side the normal points
+// to. Candidate faces are found with a bounding volume hierarchy over the faces, so the cost of a query grows
+// with the number of nearby faces rather than with the size of the mesh.
+
+#ifndef STATIC_TRIANGLE_MESH_H
+#define STATIC_TRIANGLE_MESH_H
+
+#include "scisim/Math/MathDefines.h"
+
+#include <vector>
+
+class StaticTriangleMesh final
+{
+
+public:
+
+  StaticTriangleMesh( const Matrix3Xsc& vertices, const Matrix3Xuc& faces, const scalar& thickness );
+  explicit StaticTriangleMesh( std::istream& input_stream );
+
+  const Matrix3Xsc& vertices() const;
+  const Matrix3Xuc& faces() const;
+
+  // Depth behind a face beyond which points are treated as being on the far side of the surface
+  const scalar& thickness() const;
+
+  // Unit outward normal of a face
+  Vector3s faceNormal( const unsigned face ) const;
+
+  // Appends the faces whose bounding boxes overlap the given box
+  void facesOverlappingBox( const Array3s& min, const Array3s& max, std::vector<unsigned>& faces ) const;
+
+  // Closest point to x on a face
+  Vector3s closestPointOnFace( const unsigned face, const Vector3s& x ) const;
+
+  // True if the projection of x along the face normal lands within the face
+  bool projectsOntoFace( const unsigned face, const Vector3s& x ) const;
+
+  void serialize( std::ostream& output_stream ) const;
+
+private:
+
+  struct BVHNode final
+  {
+    Array3s min;
+    Array3s max;
+    // Index of the first child for internal nodes, index of the first entry in m_bvh_faces for leaves
+    unsigned first;
+    // Number of faces in a leaf, zero for internal nodes whose children are at first and first + 1
+    unsigned count;
+  };
+
+  void buildBVH();
+  void buildBVHNode( const unsigned node_idx, const unsigned begin, const unsigned end, const std::vector<Vector3s>& centroids );
+
+  Matrix3Xsc m_vertices;
+  Matrix3Xuc m_faces;
+  scalar m_thickness;
+
+  // Derived from the faces and not serialized
+  std::vector<BVHNode> m_bvh_nodes;
+  std::vector<unsigned> m_bvh_faces;
+
+};
+
+#endif
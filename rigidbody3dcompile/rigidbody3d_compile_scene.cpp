@@ -0,0 +1,32 @@
+// rigidbody3d_compile_scene.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+// Compiles an xml scene to a binary scene that rigidbody3d_cli loads without parsing xml, loading mesh
+// files, or recomputing mass properties and signed distance fields
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "rigidbody3dutils/RigidBody3DBinaryScene.h"
+
+int main( int argc, char** argv )
+{
+  if( argc != 3 )
+  {
+    std::cerr << "Usage: " << argv[0] << " xml_scene_file_name binary_scene_file_name" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string xml_file_name{ argv[1] };
+  const std::string binary_file_name{ argv[2] };
+  if( !RigidBody3DBinaryScene::compileSceneFile( xml_file_name, binary_file_name ) )
+  {
+    return EXIT_FAILURE;
+  }
+  std::cout << "Compiled " << xml_file_name << " to " << binary_file_name << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -16,11 +16,14 @@
 #include "scisim/UnconstrainedMaps/UnconstrainedMap.h"
 #include "scisim/ConstrainedMaps/FrictionSolver.h"
 
-#include "rigidbody3d/PythonScripting.h"
 #include "rigidbody3d/Geometry/RigidBodyBox.h"
 #include "rigidbody3d/Geometry/RigidBodySphere.h"
 #include "rigidbody3d/Geometry/RigidBodyTriangleMesh.h"
+#include "rigidbody3d/Geometry/RigidBodyConvexPolyhedron.h"
 #include "rigidbody3d/Geometry/RigidBodyStaple.h"
+#include "rigidbody3d/Geometry/RigidBodyCapsule.h"
+#include "rigidbody3d/Geometry/RigidBodyCompound.h"
+#include "rigidbody3d/Geometry/RigidBodyClump.h"
 #include "rigidbody3d/StaticGeometry/StaticPlane.h"
 #include "rigidbody3d/StaticGeometry/StaticCylinder.h"
 
@@ -92,7 +95,7 @@ GLWidget::GLWidget( QWidget* parent )
 , m_impact_operator( nullptr )
 , m_friction_solver( nullptr )
 , m_impact_friction_map( nullptr )
-, m_scripting()
+, m_scripting( RigidBody3DScriptingCallback::create( RigidBody3DScriptingCallbackType::PYTHON, "", "" ) )
 , m_iteration( 0 )
 , m_dt( 0, 1 )
 , m_end_time( SCALAR_INFINITY )
@@ -150,6 +153,7 @@ bool GLWidget::openScene( const QString& xml_scene_file_name, const bool& render
 
   std::string dt_string{ "" };
   std::string scripting_callback_name{ "" };
+  RigidBody3DScriptingCallbackType scripting_callback_type;
   RigidBody3DState new_state;
   Rational<std::intmax_t> dt;
   scalar end_time;
@@ -157,7 +161,7 @@ bool GLWidget::openScene( const QString& xml_scene_file_name, const bool& render
   scalar mu;
   RenderingState new_render_state;
 
-  const bool loaded_successfully{ RigidBody3DSceneParser::parseXMLSceneFile( xml_scene_file_name.toStdString(), scripting_callback_name, new_state, new_unconstrained_map, dt_string, dt, end_time, new_impact_operator, CoR, new_friction_solver, mu, new_impact_friction_map, new_render_state ) };
+  const bool loaded_successfully{ RigidBody3DSceneParser::parseXMLSceneFile( xml_scene_file_name.toStdString(), scripting_callback_name, scripting_callback_type, new_state, new_unconstrained_map, dt_string, dt, end_time, new_impact_operator, CoR, new_friction_solver, mu, new_impact_friction_map, new_render_state ) };
 
   if( !loaded_successfully )
   {
@@ -175,8 +179,7 @@ bool GLWidget::openScene( const QString& xml_scene_file_name, const bool& render
       using std::swap;
       swap( path, file_name );
     }
-    PythonScripting new_scripting{ path, scripting_callback_name };
-    swap( m_scripting, new_scripting );
+    m_scripting = RigidBody3DScriptingCallback::create( scripting_callback_type, path, scripting_callback_name );
   }
 
   m_CoR = CoR;
@@ -315,10 +318,10 @@ bool GLWidget::openScene( const QString& xml_scene_file_name, const bool& render
   lock_camera = new_render_state.locked();
 
   // User-provided start of simulation python callback
-  m_scripting.setState( m_sim.getState() );
-  m_scripting.setInitialIterate( m_iteration );
-  m_scripting.startOfSimCallback();
-  m_scripting.forgetState();
+  m_scripting->setState( m_sim.getState() );
+  m_scripting->setInitialIterate( m_iteration );
+  m_scripting->startOfSimCallback();
+  m_scripting->forgetState();
 
   if( render_on_load )
   {
@@ -418,9 +421,9 @@ void GLWidget::stepSystem()
   {
     std::cout << "Simulation complete. Exiting." << std::endl;
     // User-provided end of simulation python callback
-    m_scripting.setState( m_sim.getState() );
-    m_scripting.endOfSimCallback();
-    m_scripting.forgetState();
+    m_scripting->setState( m_sim.getState() );
+    m_scripting->endOfSimCallback();
+    m_scripting->forgetState();
     std::exit( EXIT_SUCCESS );
   }
 
@@ -432,15 +435,15 @@ void GLWidget::stepSystem()
   }
   else if( m_unconstrained_map != nullptr && m_impact_operator == nullptr && m_friction_solver == nullptr )
   {
-    m_sim.flow( m_scripting, next_iter, m_dt, *m_unconstrained_map );
+    m_sim.flow( *m_scripting, next_iter, m_dt, *m_unconstrained_map );
   }
   else if( m_unconstrained_map != nullptr && m_impact_operator != nullptr && m_friction_solver == nullptr )
   {
-    m_sim.flow( m_scripting, next_iter, m_dt, *m_unconstrained_map, *m_impact_operator, m_CoR );
+    m_sim.flow( *m_scripting, next_iter, m_dt, *m_unconstrained_map, *m_impact_operator, m_CoR );
   }
   else if( m_unconstrained_map != nullptr && m_impact_operator == nullptr && m_friction_solver != nullptr && m_impact_friction_map != nullptr )
   {
-    m_sim.flow( m_scripting, next_iter, m_dt, *m_unconstrained_map, m_CoR, m_mu, *m_friction_solver, *m_impact_friction_map );
+    m_sim.flow( *m_scripting, next_iter, m_dt, *m_unconstrained_map, m_CoR, m_mu, *m_friction_solver, *m_impact_friction_map );
   }
   else
   {
@@ -495,10 +498,10 @@ void GLWidget::resetSystem()
   m_delta_L0 = Vector3s::Zero();
 
   // User-provided start of simulation python callback
-  m_scripting.setState( m_sim.getState() );
-  m_scripting.setInitialIterate( m_iteration );
-  m_scripting.startOfSimCallback();
-  m_scripting.forgetState();
+  m_scripting->setState( m_sim.getState() );
+  m_scripting->setInitialIterate( m_iteration );
+  m_scripting->startOfSimCallback();
+  m_scripting->forgetState();
 
   updateGL();
 }
@@ -1108,15 +1111,44 @@ void GLWidget::paintBox( const RigidBodyBox& box, const Vector3s& color ) const
   glEnd();
 }
 
-void GLWidget::paintTriangleMesh( const RigidBodyTriangleMesh& mesh, const Vector3s& color ) const
+void GLWidget::paintCapsule( const RigidBodyCapsule& capsule, const Vector3s& color ) const
 {
+  // End caps
+  for( const scalar side : { -1.0, 1.0 } )
+  {
+    glPushMatrix();
+    glTranslated( side * capsule.halfLength(), 0.0, 0.0 );
+    glScaled( capsule.r(), capsule.r(), capsule.r() );
+    assert( m_sphere_renderer != nullptr );
+    m_sphere_renderer->drawVertexArray( color.cast<GLfloat>(), Eigen::Matrix<GLfloat,3,1>{ 1.0, 1.0, 1.0 } );
+    glPopMatrix();
+  }
+
+  // Tube along the x axis
   GLfloat mcolorambient[] = { (GLfloat) (0.8 * color.x()), (GLfloat) (0.8 * color.y()), (GLfloat) (0.8 * color.z()), (GLfloat) 1.0 };
   glMaterialfv( GL_FRONT_AND_BACK, GL_AMBIENT, mcolorambient );
   GLfloat mcolordiffuse[] = { (GLfloat) (0.9 * color.x()), (GLfloat) (0.9 * color.y()), (GLfloat) (0.9 * color.z()), (GLfloat) 1.0 };
   glMaterialfv( GL_FRONT_AND_BACK, GL_DIFFUSE, mcolordiffuse );
+  const unsigned num_slices{ 32 };
+  glBegin( GL_QUAD_STRIP );
+  for( unsigned slice = 0; slice <= num_slices; ++slice )
+  {
+    const scalar theta{ 2.0 * MathDefines::PI<scalar>() * scalar( slice ) / scalar( num_slices ) };
+    const scalar c{ cos( theta ) };
+    const scalar s{ sin( theta ) };
+    glNormal3d( (GLdouble) 0.0, (GLdouble) c, (GLdouble) s );
+    glVertex3d( (GLdouble) -capsule.halfLength(), (GLdouble) ( capsule.r() * c ), (GLdouble) ( capsule.r() * s ) );
+    glVertex3d( (GLdouble) capsule.halfLength(), (GLdouble) ( capsule.r() * c ), (GLdouble) ( capsule.r() * s ) );
+  }
+  glEnd();
+}
 
-  const Matrix3Xsc& vertices{ mesh.vertices() };
-  const Matrix3Xuc& faces{ mesh.faces() };
+void GLWidget::paintTriangleMesh( const Matrix3Xsc& vertices, const Matrix3Xuc& faces, const Vector3s& color ) const
+{
+  GLfloat mcolorambient[] = { (GLfloat) (0.8 * color.x()), (GLfloat) (0.8 * color.y()), (GLfloat) (0.8 * color.z()), (GLfloat) 1.0 };
+  glMaterialfv( GL_FRONT_AND_BACK, GL_AMBIENT, mcolorambient );
+  GLfloat mcolordiffuse[] = { (GLfloat) (0.9 * color.x()), (GLfloat) (0.9 * color.y()), (GLfloat) (0.9 * color.z()), (GLfloat) 1.0 };
+  glMaterialfv( GL_FRONT_AND_BACK, GL_DIFFUSE, mcolordiffuse );
 
   glBegin( GL_TRIANGLES );
   for( int i = 0; i < faces.cols(); ++i )
@@ -1155,7 +1187,45 @@ void GLWidget::paintBody( const int geo_idx, const RigidBodyGeometry& geometry,
   else if( geometry.getType() == RigidBodyGeometryType::TRIANGLE_MESH )
   {
     const RigidBodyTriangleMesh& triangle_geom{ static_cast<const RigidBodyTriangleMesh&>( geometry ) };
-    paintTriangleMesh( triangle_geom, color );
+    paintTriangleMesh( triangle_geom.vertices(), triangle_geom.faces(), color );
+  }
+  else if( geometry.getType() == RigidBodyGeometryType::CONVEX_POLYHEDRON )
+  {
+    const RigidBodyConvexPolyhedron& polyhedron_geom{ static_cast<const RigidBodyConvexPolyhedron&>( geometry ) };
+    paintTriangleMesh( polyhedron_geom.vertices(), polyhedron_geom.faces(), color );
+  }
+  else if( geometry.getType() == RigidBodyGeometryType::CAPSULE )
+  {
+    const RigidBodyCapsule& capsule_geom{ static_cast<const RigidBodyCapsule&>( geometry ) };
+    paintCapsule( capsule_geom, color );
+  }
+  else if( geometry.getType() == RigidBodyGeometryType::COMPOUND )
+  {
+    const RigidBodyCompound& compound_geom{ static_cast<const RigidBodyCompound&>( geometry ) };
+    for( unsigned child_idx = 0; child_idx < compound_geom.numChildren(); ++child_idx )
+    {
+      glPushMatrix();
+      glTranslated( compound_geom.childPosition( child_idx ).x(), compound_geom.childPosition( child_idx ).y(), compound_geom.childPosition( child_idx ).z() );
+      Eigen::Matrix<GLdouble,4,4,Eigen::ColMajor> gl_rot_mat;
+      gl_rot_mat.setZero();
+      gl_rot_mat.block<3,3>(0,0) = compound_geom.childOrientation( child_idx );
+      gl_rot_mat(3,3) = 1.0;
+      glMultMatrixd( gl_rot_mat.data() );
+      // Children are primitives, so no per geometry renderer is needed
+      paintBody( -1, compound_geom.child( child_idx ), color );
+      glPopMatrix();
+    }
+  }
+  else if( geometry.getType() == RigidBodyGeometryType::CLUMP )
+  {
+    const RigidBodyClump& clump_geom{ static_cast<const RigidBodyClump&>( geometry ) };
+    for( unsigned sphere_idx = 0; sphere_idx < clump_geom.numSpheres(); ++sphere_idx )
+    {
+      glPushMatrix();
+      glTranslated( clump_geom.centers()( 0, sphere_idx ), clump_geom.centers()( 1, sphere_idx ), clump_geom.centers()( 2, sphere_idx ) );
+      paintSphere( RigidBodySphere{ clump_geom.radii()( sphere_idx ) }, color );
+      glPopMatrix();
+    }
   }
   else
   {
@@ -9,7 +9,7 @@
 #include "scisim/Math/Rational.h"
 
 #include "rigidbody3d/RigidBody3DSim.h"
-#include "rigidbody3d/PythonScripting.h"
+#include "rigidbody3d/RigidBody3DScriptingCallback.h"
 
 #include "PerspectiveCameraController.h"
 #include "OrthographicCameraController.h"
@@ -21,6 +21,7 @@
 class OpenGL3DSphereRenderer;
 class BodyGeometryRenderer;
 class RenderingState;
+class RigidBodyCapsule;
 
 class GLWidget : public QGLWidget
 {
@@ -88,7 +89,8 @@ private:
 
   void paintSphere( const RigidBodySphere& sphere, const Vector3s& color ) const;
   void paintBox( const RigidBodyBox& box, const Vector3s& color ) const;
-  void paintTriangleMesh( const RigidBodyTriangleMesh& mesh, const Vector3s& color ) const;
+  void paintCapsule( const RigidBodyCapsule& capsule, const Vector3s& color ) const;
+  void paintTriangleMesh( const Matrix3Xsc& vertices, const Matrix3Xuc& faces, const Vector3s& color ) const;
   void paintBody( const int geo_idx, const RigidBodyGeometry& geometry, const Vector3s& color ) const;
   void paintSystem() const;
 
@@ -132,7 +134,7 @@ private:
   std::unique_ptr<ImpactOperator> m_impact_operator;
   std::unique_ptr<FrictionSolver> m_friction_solver;
   std::unique_ptr<ImpactFrictionMap> m_impact_friction_map;
-  PythonScripting m_scripting;
+  std::unique_ptr<RigidBody3DScriptingCallback> m_scripting;
 
   // Current iteration of the solver
   unsigned m_iteration;
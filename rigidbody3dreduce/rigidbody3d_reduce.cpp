@@ -0,0 +1,420 @@
+// rigidbody3d_reduce.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+// Computes per-frame reductions (energies, momenta, collision statistics, ...) over the config_*.h5 files
+// written by rigidbody3d_cli, processing frames in parallel, and writes them as a single table
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <getopt.h>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "scisim/FrameReduction.h"
+#include "scisim/HDF5File.h"
+#include "scisim/StringUtilities.h"
+#include "scisim/Math/Rational.h"
+#include "scisim/UnconstrainedMaps/UnconstrainedMap.h"
+#include "scisim/ConstrainedMaps/ImpactFrictionMap.h"
+#include "scisim/ConstrainedMaps/ImpactMaps/ImpactOperator.h"
+#include "scisim/ConstrainedMaps/FrictionSolver.h"
+#include "rigidbody3d/RigidBody3DSim.h"
+#include "rigidbody3d/StaticGeometry/StaticPlane.h"
+#include "rigidbody3d/StaticGeometry/StaticCylinder.h"
+#include "rigidbody3dutils/RigidBody3DSceneParser.h"
+#include "rigidbody3dutils/RenderingState.h"
+
+struct Reduction final
+{
+  std::string name;
+  std::vector<std::string> columns;
+  std::function<void(RigidBody3DSim&,std::vector<scalar>&)> compute;
+};
+
+static std::vector<Reduction> availableReductions()
+{
+  return
+  {
+    { "kinetic_energy", { "kinetic_energy" }, []( RigidBody3DSim& sim, std::vector<scalar>& row ) { row.emplace_back( sim.computeKineticEnergy() ); } },
+    { "potential_energy", { "potential_energy" }, []( RigidBody3DSim& sim, std::vector<scalar>& row ) { row.emplace_back( sim.computePotentialEnergy() ); } },
+    { "total_energy", { "total_energy" }, []( RigidBody3DSim& sim, std::vector<scalar>& row ) { row.emplace_back( sim.computeTotalEnergy() ); } },
+    { "momentum", { "momentum_x", "momentum_y", "momentum_z" }, []( RigidBody3DSim& sim, std::vector<scalar>& row )
+      {
+        const Vector3s p{ sim.computeTotalMomentum() };
+        row.insert( row.end(), p.data(), p.data() + 3 );
+      }
+    },
+    { "angular_momentum", { "angular_momentum_x", "angular_momentum_y", "angular_momentum_z" }, []( RigidBody3DSim& sim, std::vector<scalar>& row )
+      {
+        const Vector3s L{ sim.computeTotalAngularMomentum() };
+        row.insert( row.end(), L.data(), L.data() + 3 );
+      }
+    },
+    { "collisions", { "collisions", "penetration_depth", "overlap_volume" }, []( RigidBody3DSim& sim, std::vector<scalar>& row )
+      {
+        std::map<std::string,unsigned> collision_counts;
+        std::map<std::string,scalar> collision_depths;
+        std::map<std::string,scalar> overlap_volumes;
+        sim.computeNumberOfCollisions( collision_counts, collision_depths, overlap_volumes );
+        // Total number of collisions, the largest mean penetration depth of any type of collision, and the
+        // total overlap volume
+        unsigned num_collisions{ 0 };
+        scalar penetration_depth{ 0.0 };
+        scalar overlap_volume{ 0.0 };
+        for( const auto& count_pair : collision_counts )
+        {
+          num_collisions += count_pair.second;
+          // Depths and volumes are nan when not supported
+          const scalar& total_depth{ collision_depths[count_pair.first] };
+          if( !std::isnan( total_depth ) )
+          {
+            penetration_depth = std::max( penetration_depth, -total_depth / scalar( count_pair.second ) );
+          }
+          const scalar& volume{ overlap_volumes[count_pair.first] };
+          if( !std::isnan( volume ) )
+          {
+            overlap_volume += volume;
+          }
+        }
+        row.emplace_back( scalar( num_collisions ) );
+        row.emplace_back( penetration_depth );
+        row.emplace_back( overlap_volume );
+      }
+    }
+  };
+}
+
+using HDFGID = HDFID<H5Gclose>;
+using HDFTID = HDFID<H5Tclose>;
+using HDFSID = HDFID<H5Sclose>;
+using HDFDID = HDFID<H5Dclose>;
+
+// Members of the static geometry structs written by StateOutput that scripting can change. HDF5 matches
+// members by name, so members left out here are skipped when reading.
+struct StaticPlaneData final
+{
+  scalar x[3];
+  scalar R[4];
+  scalar v[3];
+  scalar omega[3];
+};
+
+struct StaticCylinderData final
+{
+  scalar R[4];
+  scalar omega[3];
+};
+
+static void insertArrayMember( const HDFTID& struct_tid, const char* name, const std::size_t offset, const hsize_t size )
+{
+  const hsize_t array_dim[]{ size };
+  const HDFTID array_tid{ H5Tarray_create2( HDF5File::computeHDFType<scalar>(), 1, array_dim ) };
+  if( array_tid < 0 || H5Tinsert( struct_tid, name, offset, array_tid ) < 0 )
+  {
+    throw std::string{ "Failed to create HDF struct member " } + name;
+  }
+}
+
+template<typename Data>
+static std::vector<Data> readStaticGeometryStructs( const HDF5File& input_file, const std::string& file_name, const std::string& data_set_name, const HDFTID& struct_tid )
+{
+  const HDFGID grp_id{ input_file.findGroup( "static_geometry" ) };
+  const HDFDID data_set{ H5Dopen2( grp_id, data_set_name.c_str(), H5P_DEFAULT ) };
+  if( data_set < 0 )
+  {
+    throw std::string{ "Failed to open static_geometry/" } + data_set_name + std::string{ " in " } + file_name;
+  }
+  const HDFSID data_space{ H5Dget_space( data_set ) };
+  const hssize_t num_elements{ data_space < 0 ? -1 : H5Sget_simple_extent_npoints( data_space ) };
+  if( num_elements < 0 )
+  {
+    throw std::string{ "Failed to read the size of static_geometry/" } + data_set_name + std::string{ " in " } + file_name;
+  }
+  std::vector<Data> data( static_cast<typename std::vector<Data>::size_type>( num_elements ) );
+  if( !data.empty() && H5Dread( data_set, struct_tid, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data() ) < 0 )
+  {
+    throw std::string{ "Failed to read static_geometry/" } + data_set_name + std::string{ " in " } + file_name;
+  }
+  return data;
+}
+
+// Planes and cylinders can be scripted to move, so their state comes from the frame rather than the scene
+static void readStaticGeometry( const HDF5File& input_file, const std::string& file_name, RigidBody3DState& state )
+{
+  if( state.numStaticPlanes() != 0 )
+  {
+    const HDFTID struct_tid{ H5Tcreate( H5T_COMPOUND, sizeof( StaticPlaneData ) ) };
+    if( struct_tid < 0 )
+    {
+      throw std::string{ "Failed to create HDF struct for static planes" };
+    }
+    insertArrayMember( struct_tid, "x", HOFFSET( StaticPlaneData, x ), 3 );
+    insertArrayMember( struct_tid, "R", HOFFSET( StaticPlaneData, R ), 4 );
+    insertArrayMember( struct_tid, "v", HOFFSET( StaticPlaneData, v ), 3 );
+    insertArrayMember( struct_tid, "omega", HOFFSET( StaticPlaneData, omega ), 3 );
+    const std::vector<StaticPlaneData> planes{ readStaticGeometryStructs<StaticPlaneData>( input_file, file_name, "static_planes", struct_tid ) };
+    if( planes.size() != state.numStaticPlanes() )
+    {
+      throw std::string{ "Frame " } + file_name + std::string{ " has a different number of static planes than the scene" };
+    }
+    for( std::vector<StaticPlaneData>::size_type plane_idx = 0; plane_idx < planes.size(); ++plane_idx )
+    {
+      StaticPlane& plane{ state.staticPlane( plane_idx ) };
+      plane.x() = Eigen::Map<const Vector3s>{ planes[plane_idx].x };
+      // Stored as x, y, z, w
+      plane.R() = Quaternions{ planes[plane_idx].R[3], planes[plane_idx].R[0], planes[plane_idx].R[1], planes[plane_idx].R[2] };
+      plane.v() = Eigen::Map<const Vector3s>{ planes[plane_idx].v };
+      plane.omega() = Eigen::Map<const Vector3s>{ planes[plane_idx].omega };
+    }
+  }
+  if( state.numStaticCylinders() != 0 )
+  {
+    const HDFTID struct_tid{ H5Tcreate( H5T_COMPOUND, sizeof( StaticCylinderData ) ) };
+    if( struct_tid < 0 )
+    {
+      throw std::string{ "Failed to create HDF struct for static cylinders" };
+    }
+    insertArrayMember( struct_tid, "R", HOFFSET( StaticCylinderData, R ), 4 );
+    insertArrayMember( struct_tid, "omega", HOFFSET( StaticCylinderData, omega ), 3 );
+    const std::vector<StaticCylinderData> cylinders{ readStaticGeometryStructs<StaticCylinderData>( input_file, file_name, "static_cylinders", struct_tid ) };
+    if( cylinders.size() != state.numStaticCylinders() )
+    {
+      throw std::string{ "Frame " } + file_name + std::string{ " has a different number of static cylinders than the scene" };
+    }
+    for( std::vector<StaticCylinderData>::size_type cylinder_idx = 0; cylinder_idx < cylinders.size(); ++cylinder_idx )
+    {
+      StaticCylinder& cylinder{ state.staticCylinder( cylinder_idx ) };
+      cylinder.R() = Quaternions{ cylinders[cylinder_idx].R[3], cylinders[cylinder_idx].R[0], cylinders[cylinder_idx].R[1], cylinders[cylinder_idx].R[2] };
+      cylinder.omega() = Eigen::Map<const Vector3s>{ cylinders[cylinder_idx].omega };
+    }
+  }
+}
+
+static void readFrame( const std::string& file_name, RigidBody3DState& state, std::vector<scalar>& row )
+{
+  std::lock_guard<std::mutex> lock{ FrameReduction::hdf5Mutex() };
+  const HDF5File input_file{ file_name, HDF5AccessType::READ_ONLY };
+
+  row.emplace_back( scalar( input_file.read<unsigned>( "iteration" ) ) );
+  row.emplace_back( input_file.read<scalar>( "time" ) );
+
+  const VectorXs q{ input_file.read<VectorXs>( "state/q" ) };
+  const VectorXs v{ input_file.read<VectorXs>( "state/v" ) };
+  if( q.size() != state.q().size() || v.size() != state.v().size() )
+  {
+    throw std::string{ "Frame " } + file_name + std::string{ " has a different number of bodies than the scene; frames with inserted or deleted bodies are not supported" };
+  }
+  state.q() = q;
+  state.v() = v;
+  readStaticGeometry( input_file, file_name, state );
+  // The world space inertia depends on the orientation of each body
+  state.updateMandMinv();
+}
+
+static void printUsage( const std::string& executable_name )
+{
+  std::cout << "Usage: " << executable_name << " xml_scene_file_name output_dir [options]" << std::endl;
+  std::cout << "Computes reductions over the frames rigidbody3d_cli saved to output_dir for the given scene." << std::endl;
+  std::cout << "Options are:" << std::endl;
+  std::cout << "   -h/--help                 : prints this help message and exits" << std::endl;
+  std::cout << "   -j/--threads integer      : number of threads to process frames with, defaults to the number of cores" << std::endl;
+  std::cout << "   -r/--reductions list      : comma separated reductions to compute, defaults to all of:" << std::endl;
+  std::cout << "                              ";
+  for( const Reduction& reduction : availableReductions() )
+  {
+    std::cout << ' ' << reduction.name;
+  }
+  std::cout << std::endl;
+  std::cout << "   -o/--output file          : writes the table to the given file instead of standard output" << std::endl;
+}
+
+static bool parseCommandLineOptions( int* argc, char*** argv, bool& help_mode_enabled, unsigned& num_threads, std::vector<std::string>& reduction_names, std::string& table_file_name )
+{
+  const struct option long_options[] =
+  {
+    { "help", no_argument, nullptr, 'h' },
+    { "threads", required_argument, nullptr, 'j' },
+    { "reductions", required_argument, nullptr, 'r' },
+    { "output", required_argument, nullptr, 'o' },
+    { nullptr, 0, nullptr, 0 }
+  };
+
+  while( true )
+  {
+    int option_index = 0;
+    const int c = getopt_long( *argc, *argv, "hj:r:o:", long_options, &option_index );
+    if( c == -1 ) { break; }
+    switch( c )
+    {
+      case 'h':
+      {
+        help_mode_enabled = true;
+        break;
+      }
+      case 'j':
+      {
+        if( !StringUtilities::extractFromString( optarg, num_threads ) || num_threads == 0 )
+        {
+          std::cerr << "Failed to read value for argument for -j/--threads. Value must be a positive integer." << std::endl;
+          return false;
+        }
+        break;
+      }
+      case 'r':
+      {
+        reduction_names = StringUtilities::tokenize( optarg, ',' );
+        break;
+      }
+      case 'o':
+      {
+        table_file_name = optarg;
+        break;
+      }
+      case '?':
+      {
+        return false;
+      }
+      default:
+      {
+        std::cerr << "This is a bug in the command line parser. Please file a report." << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+int main( int argc, char** argv )
+{
+  bool help_mode_enabled{ false };
+  unsigned num_threads{ std::max( 1u, std::thread::hardware_concurrency() ) };
+  std::vector<std::string> reduction_names;
+  std::string table_file_name;
+
+  if( !parseCommandLineOptions( &argc, &argv, help_mode_enabled, num_threads, reduction_names, table_file_name ) )
+  {
+    return EXIT_FAILURE;
+  }
+
+  if( help_mode_enabled )
+  {
+    printUsage( argv[0] );
+    return EXIT_SUCCESS;
+  }
+
+  if( argc != optind + 2 )
+  {
+    std::cerr << "Invalid arguments. Must provide an xml scene file name and an output directory." << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string xml_file_name{ argv[optind] };
+  const std::string output_dir_name{ argv[optind + 1] };
+
+  // Select the requested reductions, in the order requested
+  std::vector<Reduction> reductions;
+  {
+    std::vector<Reduction> available_reductions{ availableReductions() };
+    if( reduction_names.empty() )
+    {
+      reductions = std::move( available_reductions );
+    }
+    for( const std::string& name : reduction_names )
+    {
+      const auto reduction = std::find_if( available_reductions.begin(), available_reductions.end(), [&name]( const Reduction& r ) { return r.name == name; } );
+      if( reduction == available_reductions.end() )
+      {
+        std::cerr << "Unknown reduction: " << name << std::endl;
+        return EXIT_FAILURE;
+      }
+      reductions.emplace_back( *reduction );
+    }
+  }
+
+  // Geometry, forces, and static geometry come from the scene
+  RigidBody3DSim scene_sim;
+  {
+    std::string scripting_callback_name;
+    RigidBody3DScriptingCallbackType scripting_callback_type;
+    std::unique_ptr<UnconstrainedMap> unconstrained_map;
+    std::string dt_string;
+    Rational<std::intmax_t> dt;
+    scalar end_time;
+    std::unique_ptr<ImpactOperator> impact_operator;
+    scalar CoR;
+    std::unique_ptr<FrictionSolver> friction_solver;
+    scalar mu;
+    std::unique_ptr<ImpactFrictionMap> impact_friction_map;
+    RenderingState rendering_state;
+    if( !RigidBody3DSceneParser::parseXMLSceneFile( xml_file_name, scripting_callback_name, scripting_callback_type, scene_sim.state(), unconstrained_map, dt_string, dt, end_time, impact_operator, CoR, friction_solver, mu, impact_friction_map, rendering_state ) )
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::vector<std::string> columns{ "iteration", "time" };
+  for( const Reduction& reduction : reductions )
+  {
+    columns.insert( columns.end(), reduction.columns.begin(), reduction.columns.end() );
+  }
+
+  // Runs saved with -t/--trajectory store every frame in one file, which is not read here
+  if( std::ifstream{ output_dir_name + "/trajectory.h5" }.is_open() )
+  {
+    std::cerr << "Output directory " << output_dir_name << " holds a single-file trajectory.h5, which is not supported. Rerun rigidbody3d_cli without -t/--trajectory to write per-frame config files." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  try
+  {
+    const std::vector<std::string> frame_names{ FrameReduction::listFiles( output_dir_name, "config_", ".h5" ) };
+    std::vector<std::vector<scalar>> rows( frame_names.size() );
+
+    // Each thread reduces frames with its own copy of the simulation
+    num_threads = std::min( num_threads, std::max( 1u, unsigned( frame_names.size() ) ) );
+    std::vector<RigidBody3DSim> thread_sims( num_threads, scene_sim );
+    FrameReduction::parallelFor( unsigned( frame_names.size() ), num_threads, [&]( const unsigned thread, const unsigned frame )
+      {
+        RigidBody3DSim& sim{ thread_sims[thread] };
+        std::vector<scalar>& row{ rows[frame] };
+        row.reserve( columns.size() );
+        readFrame( output_dir_name + "/" + frame_names[frame], sim.state(), row );
+        for( const Reduction& reduction : reductions )
+        {
+          reduction.compute( sim, row );
+        }
+      }
+    );
+
+    if( table_file_name.empty() )
+    {
+      FrameReduction::writeTable( columns, frame_names, rows, std::cout );
+    }
+    else
+    {
+      std::ofstream table_stream{ table_file_name };
+      if( !table_stream.is_open() )
+      {
+        std::cerr << "Failed to open table file: " << table_file_name << std::endl;
+        return EXIT_FAILURE;
+      }
+      FrameReduction::writeTable( columns, frame_names, rows, table_stream );
+    }
+  }
+  catch( const std::string& error )
+  {
+    std::cerr << error << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
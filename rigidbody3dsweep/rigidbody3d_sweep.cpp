@@ -0,0 +1,439 @@
+// rigidbody3d_sweep.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+// Runs many independent simulations of one scene with different coefficients of restitution, friction
+// coefficients, and timesteps. The scene is parsed once and every run starts from a copy of the parsed
+// simulation, which shares its immutable geometry, so expensive geometry such as triangle mesh signed
+// distance fields is neither recomputed nor duplicated. Runs execute concurrently and save config_*.h5
+// files to their own run_* directory. Runs can also branch from a common prefix that is simulated once.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+#include <fstream>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+#include "scisim/CompileDefinitions.h"
+#include "scisim/FrameReduction.h"
+#include "scisim/HDF5File.h"
+#include "scisim/StringUtilities.h"
+#include "scisim/Math/MathUtilities.h"
+#include "scisim/Math/Rational.h"
+#include "scisim/UnconstrainedMaps/UnconstrainedMap.h"
+#include "scisim/ConstrainedMaps/ImpactFrictionMap.h"
+#include "scisim/ConstrainedMaps/ImpactMaps/ImpactOperator.h"
+#include "scisim/ConstrainedMaps/FrictionSolver.h"
+#include "rigidbody3d/PythonScripting.h"
+#include "rigidbody3d/RigidBody3DBranch.h"
+#include "rigidbody3d/RigidBody3DSim.h"
+#include "rigidbody3dutils/RigidBody3DBinaryScene.h"
+
+// Settings of a single run of the sweep
+struct RunParameters final
+{
+  scalar CoR;
+  scalar mu;
+  Rational<std::intmax_t> dt;
+  unsigned steps_per_save;
+};
+
+static std::mutex& consoleMutex()
+{
+  static std::mutex console_mutex;
+  return console_mutex;
+}
+
+static void makeDirectory( const std::string& directory_name )
+{
+  if( mkdir( directory_name.c_str(), 0755 ) != 0 && errno != EEXIST )
+  {
+    throw std::string{ "Failed to create directory: " } + directory_name;
+  }
+}
+
+static void saveState( const std::string& dir_name, const unsigned save_number_width, const unsigned output_frame, const unsigned iteration, const Rational<std::intmax_t>& dt, const RigidBody3DSim& sim )
+{
+  std::stringstream file_name_stream;
+  file_name_stream << dir_name << "/config_" << std::setfill( '0' ) << std::setw( save_number_width ) << output_frame << ".h5";
+
+  std::lock_guard<std::mutex> lock{ FrameReduction::hdf5Mutex() };
+  HDF5File output_file{ file_name_stream.str(), HDF5AccessType::READ_WRITE };
+  output_file.write( "timestep", scalar( dt ) );
+  output_file.write( "iteration", iteration );
+  output_file.write( "time", scalar( std::intmax_t( iteration ) * dt ) );
+  output_file.write( "git_hash", CompileDefinitions::GitSHA1 );
+  sim.writeBinaryState( output_file );
+}
+
+static unsigned saveNumberWidth( const scalar& end_time, const Rational<std::intmax_t>& dt, const unsigned steps_per_save )
+{
+  return MathUtilities::computeNumDigits( 1 + unsigned( ceil( end_time / scalar( dt ) ) ) / steps_per_save );
+}
+
+// Steps branch until stop_time, saving every steps_per_save steps, including the starting configuration
+static void simulate( RigidBody3DBranch& branch, const Rational<std::intmax_t>& dt, const unsigned steps_per_save, const unsigned save_number_width, const scalar& stop_time, const std::string& dir_name )
+{
+  makeDirectory( dir_name );
+
+  // Scenes with callbacks are rejected, so this never calls into the interpreter
+  PythonScripting scripting;
+
+  // Frames are numbered from the start of the simulation, so branches continue the prefix's numbering
+  saveState( dir_name, save_number_width, branch.iteration() / steps_per_save, branch.iteration(), dt, branch.sim() );
+
+  // N.B. this will ocassionaly not trigger at the *exact* equal time due to floating point errors
+  while( scalar( std::intmax_t( branch.iteration() ) * dt ) < stop_time )
+  {
+    branch.step( scripting, dt );
+    if( branch.iteration() % steps_per_save == 0 )
+    {
+      saveState( dir_name, save_number_width, branch.iteration() / steps_per_save, branch.iteration(), dt, branch.sim() );
+    }
+  }
+}
+
+static bool parseScalarList( const std::string& list, std::vector<scalar>& values )
+{
+  values.clear();
+  for( const std::string& token : StringUtilities::tokenize( list, ',' ) )
+  {
+    scalar value;
+    if( !StringUtilities::extractFromString( token, value ) )
+    {
+      return false;
+    }
+    values.emplace_back( value );
+  }
+  return !values.empty();
+}
+
+static bool parseTimestepList( const std::string& list, std::vector<Rational<std::intmax_t>>& values )
+{
+  values.clear();
+  for( const std::string& token : StringUtilities::tokenize( list, ',' ) )
+  {
+    Rational<std::intmax_t> value;
+    if( !extractFromString( token, value ) || !value.positive() )
+    {
+      return false;
+    }
+    values.emplace_back( value );
+  }
+  return !values.empty();
+}
+
+static void printUsage( const std::string& executable_name )
+{
+  std::cout << "Usage: " << executable_name << " scene_file_name output_dir [options]" << std::endl;
+  std::cout << "Runs the scene once for every combination of the given parameters, saving run i to output_dir/run_i." << std::endl;
+  std::cout << "Parameters that are not swept take their values from the scene." << std::endl;
+  std::cout << "Options are:" << std::endl;
+  std::cout << "   -h/--help                 : prints this help message and exits" << std::endl;
+  std::cout << "   -c/--CoR list             : comma separated coefficients of restitution to sweep over" << std::endl;
+  std::cout << "   -m/--mu list              : comma separated coefficients of friction to sweep over" << std::endl;
+  std::cout << "   -t/--timestep list        : comma separated timesteps to sweep over, as rationals or decimals" << std::endl;
+  std::cout << "   -e/--end scalar           : overrides the end time specified in the scene file" << std::endl;
+  std::cout << "   -p/--prefix scalar        : simulates the scene once to the given time, saving to output_dir/prefix, and" << std::endl;
+  std::cout << "                               branches every run from the result; requires a single timestep" << std::endl;
+  std::cout << "   -f/--frequency integer    : rate at which to save simulation data, in Hz; defaults to every step" << std::endl;
+  std::cout << "   -j/--threads integer      : number of runs to execute at once, defaults to the number of cores" << std::endl;
+}
+
+static bool parseCommandLineOptions( int* argc, char*** argv, bool& help_mode_enabled, std::vector<scalar>& CoRs, std::vector<scalar>& mus, std::vector<Rational<std::intmax_t>>& timesteps, scalar& end_time_override, scalar& prefix_time, unsigned& output_frequency, unsigned& num_threads )
+{
+  const struct option long_options[] =
+  {
+    { "help", no_argument, nullptr, 'h' },
+    { "CoR", required_argument, nullptr, 'c' },
+    { "mu", required_argument, nullptr, 'm' },
+    { "timestep", required_argument, nullptr, 't' },
+    { "end", required_argument, nullptr, 'e' },
+    { "prefix", required_argument, nullptr, 'p' },
+    { "frequency", required_argument, nullptr, 'f' },
+    { "threads", required_argument, nullptr, 'j' },
+    { nullptr, 0, nullptr, 0 }
+  };
+
+  while( true )
+  {
+    int option_index = 0;
+    const int c = getopt_long( *argc, *argv, "hc:m:t:e:p:f:j:", long_options, &option_index );
+    if( c == -1 ) { break; }
+    switch( c )
+    {
+      case 'h':
+      {
+        help_mode_enabled = true;
+        break;
+      }
+      case 'c':
+      {
+        if( !parseScalarList( optarg, CoRs ) || std::any_of( CoRs.begin(), CoRs.end(), []( const scalar& CoR ) { return CoR < 0.0 || CoR > 1.0; } ) )
+        {
+          std::cerr << "Failed to read value for argument for -c/--CoR. Value must be a comma separated list of scalars in [0,1]." << std::endl;
+          return false;
+        }
+        break;
+      }
+      case 'm':
+      {
+        if( !parseScalarList( optarg, mus ) || std::any_of( mus.begin(), mus.end(), []( const scalar& mu ) { return mu < 0.0; } ) )
+        {
+          std::cerr << "Failed to read value for argument for -m/--mu. Value must be a comma separated list of non-negative scalars." << std::endl;
+          return false;
+        }
+        break;
+      }
+      case 't':
+      {
+        if( !parseTimestepList( optarg, timesteps ) )
+        {
+          std::cerr << "Failed to read value for argument for -t/--timestep. Value must be a comma separated list of positive rationals." << std::endl;
+          return false;
+        }
+        break;
+      }
+      case 'e':
+      {
+        if( !StringUtilities::extractFromString( optarg, end_time_override ) || end_time_override <= 0.0 )
+        {
+          std::cerr << "Failed to read value for argument for -e/--end. Value must be a positive scalar." << std::endl;
+          return false;
+        }
+        break;
+      }
+      case 'p':
+      {
+        if( !StringUtilities::extractFromString( optarg, prefix_time ) || prefix_time <= 0.0 )
+        {
+          std::cerr << "Failed to read value for argument for -p/--prefix. Value must be a positive scalar." << std::endl;
+          return false;
+        }
+        break;
+      }
+      case 'f':
+      {
+        if( !StringUtilities::extractFromString( optarg, output_frequency ) || output_frequency == 0 )
+        {
+          std::cerr << "Failed to read value for argument for -f/--frequency. Value must be a positive integer." << std::endl;
+          return false;
+        }
+        break;
+      }
+      case 'j':
+      {
+        if( !StringUtilities::extractFromString( optarg, num_threads ) || num_threads == 0 )
+        {
+          std::cerr << "Failed to read value for argument for -j/--threads. Value must be a positive integer." << std::endl;
+          return false;
+        }
+        break;
+      }
+      case '?':
+      {
+        return false;
+      }
+      default:
+      {
+        std::cerr << "This is a bug in the command line parser. Please file a report." << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+int main( int argc, char** argv )
+{
+  bool help_mode_enabled{ false };
+  std::vector<scalar> CoRs;
+  std::vector<scalar> mus;
+  std::vector<Rational<std::intmax_t>> timesteps;
+  scalar end_time_override{ -1.0 };
+  scalar prefix_time{ 0.0 };
+  unsigned output_frequency{ 0 };
+  unsigned num_threads{ std::max( 1u, std::thread::hardware_concurrency() ) };
+
+  if( !parseCommandLineOptions( &argc, &argv, help_mode_enabled, CoRs, mus, timesteps, end_time_override, prefix_time, output_frequency, num_threads ) )
+  {
+    return EXIT_FAILURE;
+  }
+
+  if( help_mode_enabled )
+  {
+    printUsage( argv[0] );
+    return EXIT_SUCCESS;
+  }
+
+  if( argc != optind + 2 )
+  {
+    std::cerr << "Invalid arguments. Must provide a scene file name and an output directory." << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string scene_file_name{ argv[optind] };
+  const std::string output_dir_name{ argv[optind + 1] };
+
+  // Parse the scene once; all runs branch from the result
+  std::unique_ptr<RigidBody3DBranch> scene;
+  Rational<std::intmax_t> scene_dt;
+  scalar end_time;
+  {
+    RigidBody3DSim sim;
+    std::string scripting_callback_name;
+    RigidBody3DScriptingCallbackType scripting_callback_type;
+    std::unique_ptr<UnconstrainedMap> unconstrained_map;
+    std::string dt_string;
+    std::unique_ptr<ImpactOperator> impact_operator;
+    scalar CoR;
+    std::unique_ptr<FrictionSolver> friction_solver;
+    scalar mu;
+    std::unique_ptr<ImpactFrictionMap> impact_friction_map;
+    if( !RigidBody3DBinaryScene::loadSceneFile( scene_file_name, false, scripting_callback_name, scripting_callback_type, sim.getState(), unconstrained_map, dt_string, scene_dt, end_time, impact_operator, CoR, friction_solver, mu, impact_friction_map ) )
+    {
+      return EXIT_FAILURE;
+    }
+    // The embedded interpreter can not run callbacks for several simulations at once
+    if( !scripting_callback_name.empty() )
+    {
+      std::cerr << "Scenes with a scripting callback can not be swept." << std::endl;
+      return EXIT_FAILURE;
+    }
+    if( !CoRs.empty() && impact_operator == nullptr && impact_friction_map == nullptr )
+    {
+      std::cerr << "Sweeping the coefficient of restitution requires a scene with an impact operator or friction solver." << std::endl;
+      return EXIT_FAILURE;
+    }
+    if( !mus.empty() && impact_friction_map == nullptr )
+    {
+      std::cerr << "Sweeping the coefficient of friction requires a scene with a friction solver." << std::endl;
+      return EXIT_FAILURE;
+    }
+    scene.reset( new RigidBody3DBranch{ sim, std::move( unconstrained_map ), std::move( impact_operator ), CoR, std::move( friction_solver ), mu, std::move( impact_friction_map ), 0 } );
+  }
+
+  if( end_time_override > 0.0 )
+  {
+    end_time = end_time_override;
+  }
+  if( CoRs.empty() )
+  {
+    CoRs.emplace_back( scene->CoR() );
+  }
+  if( mus.empty() )
+  {
+    mus.emplace_back( scene->mu() );
+  }
+  if( timesteps.empty() )
+  {
+    timesteps.emplace_back( scene_dt );
+  }
+  if( prefix_time > 0.0 )
+  {
+    if( timesteps.size() != 1 )
+    {
+      std::cerr << "Branching from a common prefix requires a single timestep." << std::endl;
+      return EXIT_FAILURE;
+    }
+    if( prefix_time >= end_time )
+    {
+      std::cerr << "The prefix must end before the end time." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Enumerate every combination of the swept parameters
+  std::vector<RunParameters> runs;
+  for( const Rational<std::intmax_t>& dt : timesteps )
+  {
+    unsigned steps_per_save{ 1 };
+    if( output_frequency != 0 )
+    {
+      const Rational<std::intmax_t> potential_steps_per_frame{ std::intmax_t( 1 ) / ( dt * std::intmax_t( output_frequency ) ) };
+      if( !potential_steps_per_frame.isInteger() )
+      {
+        std::cerr << "Timestep " << dt << " and output frequency do not yield an integer number of timesteps for data output. Exiting." << std::endl;
+        return EXIT_FAILURE;
+      }
+      steps_per_save = unsigned( potential_steps_per_frame.numerator() );
+    }
+    for( const scalar& CoR : CoRs )
+    {
+      for( const scalar& mu : mus )
+      {
+        runs.emplace_back( RunParameters{ CoR, mu, dt, steps_per_save } );
+      }
+    }
+  }
+
+  const unsigned run_number_width{ MathUtilities::computeNumDigits( unsigned( runs.size() ) ) };
+  const auto run_dir_name = [&]( const unsigned run )
+  {
+    std::stringstream ss;
+    ss << output_dir_name << "/run_" << std::setfill( '0' ) << std::setw( run_number_width ) << run;
+    return ss.str();
+  };
+
+  try
+  {
+    makeDirectory( output_dir_name );
+
+    // Record the parameters of each run
+    {
+      const std::string manifest_file_name{ output_dir_name + "/runs.txt" };
+      std::ofstream manifest{ manifest_file_name };
+      if( !manifest.is_open() )
+      {
+        throw std::string{ "Failed to open manifest file: " } + manifest_file_name;
+      }
+      manifest << "# run CoR mu timestep\n";
+      manifest << std::setprecision( std::numeric_limits<scalar>::max_digits10 );
+      for( std::vector<RunParameters>::size_type run = 0; run < runs.size(); ++run )
+      {
+        manifest << run_dir_name( unsigned( run ) ) << ' ' << runs[run].CoR << ' ' << runs[run].mu << ' ' << runs[run].dt << '\n';
+      }
+    }
+
+    // Simulate the common prefix once with the scene's coefficients
+    if( prefix_time > 0.0 )
+    {
+      std::cout << "Simulating the common prefix to time " << prefix_time << std::endl;
+      const RunParameters& parameters{ runs.front() };
+      simulate( *scene, parameters.dt, parameters.steps_per_save, saveNumberWidth( end_time, parameters.dt, parameters.steps_per_save ), prefix_time, output_dir_name + "/prefix" );
+    }
+
+    std::cout << "Executing " << runs.size() << " runs on " << std::min( num_threads, unsigned( runs.size() ) ) << " threads" << std::endl;
+    FrameReduction::parallelFor( unsigned( runs.size() ), num_threads, [&]( const unsigned, const unsigned run )
+      {
+        const RunParameters& parameters{ runs[run] };
+        RigidBody3DBranch branch{ *scene };
+        branch.CoR() = parameters.CoR;
+        branch.mu() = parameters.mu;
+        simulate( branch, parameters.dt, parameters.steps_per_save, saveNumberWidth( end_time, parameters.dt, parameters.steps_per_save ), end_time, run_dir_name( run ) );
+        std::lock_guard<std::mutex> lock{ consoleMutex() };
+        std::cout << "Completed " << run_dir_name( run ) << std::endl;
+      }
+    );
+  }
+  catch( const std::string& error )
+  {
+    std::cerr << error << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
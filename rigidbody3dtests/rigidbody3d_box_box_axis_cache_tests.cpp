@@ -0,0 +1,331 @@
+// rigidbody3d_box_box_axis_cache_tests.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "scisim/Checkpoint.h"
+#include "scisim/Math/MathDefines.h"
+#include "rigidbody3d/BoxBoxAxisCache.h"
+#include "rigidbody3d/Constraints/BoxBoxUtilities.h"
+
+struct PlacedBox final
+{
+  Vector3s cm;
+  Matrix33sr R;
+  Vector3s half_widths;
+};
+
+struct BoxBoxContact final
+{
+  int axis_code;
+  Vector3s n;
+  std::vector<Vector3s> points;
+};
+
+static Matrix33sr rotation( const scalar& angle, const Vector3s& axis )
+{
+  return Matrix33sr{ Eigen::AngleAxis<scalar>{ angle, axis.normalized() }.toRotationMatrix() };
+}
+
+static BoxBoxContact collide( const PlacedBox& box0, const PlacedBox& box1, const int cached_code )
+{
+  BoxBoxContact contact;
+  contact.axis_code = cached_code;
+  BoxBoxUtilities::isActive( box0.cm, box0.R, box0.half_widths, box1.cm, box1.R, box1.half_widths, contact.axis_code, contact.n, contact.points );
+  return contact;
+}
+
+// Penetration of the boxes along a unit axis, from their projected half widths
+static scalar depthAlong( const PlacedBox& box0, const PlacedBox& box1, const Vector3s& n )
+{
+  const scalar projected_widths{ box0.half_widths.dot( ( box0.R.transpose() * n ).cwiseAbs() ) + box1.half_widths.dot( ( box1.R.transpose() * n ).cwiseAbs() ) };
+  return projected_widths - fabs( ( box1.cm - box0.cm ).dot( n ) );
+}
+
+// Penetration along the shallowest face axis of either box
+static scalar minimumFaceDepth( const PlacedBox& box0, const PlacedBox& box1 )
+{
+  scalar depth{ SCALAR_INFINITY };
+  for( int axis_num = 0; axis_num < 3; ++axis_num )
+  {
+    depth = std::min( depth, depthAlong( box0, box1, box0.R.col( axis_num ) ) );
+    depth = std::min( depth, depthAlong( box0, box1, box1.R.col( axis_num ) ) );
+  }
+  return depth;
+}
+
+// Boxes of random size, yaw, tilt, and offset stacked along z, each sinking slightly into the one below
+static std::vector<PlacedBox> restingStack( const unsigned nboxes, const unsigned seed )
+{
+  std::mt19937_64 mt{ seed };
+  std::uniform_real_distribution<scalar> width_gen{ 0.3, 0.6 };
+  std::uniform_real_distribution<scalar> yaw_gen{ -0.3, 0.3 };
+  std::uniform_real_distribution<scalar> tilt_gen{ -0.0005, 0.0005 };
+  std::uniform_real_distribution<scalar> offset_gen{ -0.1, 0.1 };
+  std::vector<PlacedBox> boxes;
+  scalar top{ 0.0 };
+  for( unsigned box_idx = 0; box_idx < nboxes; ++box_idx )
+  {
+    const Vector3s half_widths{ width_gen( mt ), width_gen( mt ), 0.5 * width_gen( mt ) };
+    const Matrix33sr R{ rotation( tilt_gen( mt ), Vector3s::UnitX() ) * rotation( tilt_gen( mt ), Vector3s::UnitY() ) * rotation( yaw_gen( mt ), Vector3s::UnitZ() ) };
+    const Vector3s cm{ offset_gen( mt ), offset_gen( mt ), top + half_widths.z() - 1.0e-3 };
+    boxes.emplace_back( PlacedBox{ cm, R, half_widths } );
+    top = cm.z() + half_widths.z();
+  }
+  return boxes;
+}
+
+static bool sameContact( const BoxBoxContact& cached, const BoxBoxContact& uncached, const PlacedBox& box0, const PlacedBox& box1 )
+{
+  if( cached.axis_code != uncached.axis_code )
+  {
+    std::cerr << "Cached axis code is " << cached.axis_code << ", uncached axis code is " << uncached.axis_code << std::endl;
+    return false;
+  }
+  if( ( cached.n - uncached.n ).norm() > 1.0e-12 )
+  {
+    std::cerr << "Cached normal is " << cached.n.transpose() << ", uncached normal is " << uncached.n.transpose() << std::endl;
+    return false;
+  }
+  const scalar cached_depth{ depthAlong( box0, box1, cached.n ) };
+  const scalar uncached_depth{ depthAlong( box0, box1, uncached.n ) };
+  if( fabs( cached_depth - uncached_depth ) > 1.0e-12 )
+  {
+    std::cerr << "Cached depth is " << cached_depth << ", uncached depth is " << uncached_depth << std::endl;
+    return false;
+  }
+  if( cached.points.size() != uncached.points.size() )
+  {
+    std::cerr << "Cached contact has " << cached.points.size() << " points, uncached contact has " << uncached.points.size() << std::endl;
+    return false;
+  }
+  for( std::vector<Vector3s>::size_type point_idx = 0; point_idx < cached.points.size(); ++point_idx )
+  {
+    if( ( cached.points[point_idx] - uncached.points[point_idx] ).norm() > 1.0e-12 )
+    {
+      std::cerr << "Cached contact point " << cached.points[point_idx].transpose() << " differs from uncached point " << uncached.points[point_idx].transpose() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Resting boxes keep the axis found on the previous step, which must be the same shallowest face axis that
+// the uncached test finds, with the same contact points
+static int testRestingStack()
+{
+  std::vector<PlacedBox> boxes{ restingStack( 8, 1357 ) };
+  std::mt19937_64 mt{ 2468 };
+  std::uniform_real_distribution<scalar> jitter_gen{ -1.0e-4, 1.0e-4 };
+  std::vector<int> previous_codes( boxes.size() - 1, 0 );
+  for( unsigned step = 0; step < 20; ++step )
+  {
+    for( std::vector<PlacedBox>::size_type box_idx = 0; box_idx + 1 < boxes.size(); ++box_idx )
+    {
+      const PlacedBox& lower{ boxes[box_idx] };
+      const PlacedBox& upper{ boxes[box_idx + 1] };
+      const BoxBoxContact uncached{ collide( upper, lower, 0 ) };
+      if( uncached.points.empty() )
+      {
+        std::cerr << "Boxes " << box_idx << " and " << box_idx + 1 << " of the stack are not in contact." << std::endl;
+        return EXIT_FAILURE;
+      }
+      const scalar min_depth{ minimumFaceDepth( upper, lower ) };
+      if( fabs( depthAlong( upper, lower, uncached.n ) - min_depth ) > 1.0e-12 )
+      {
+        std::cerr << "Uncached depth is " << depthAlong( upper, lower, uncached.n ) << ", expected the shallowest face depth " << min_depth << std::endl;
+        return EXIT_FAILURE;
+      }
+      // The first step has nothing cached
+      if( previous_codes[box_idx] != 0 && !sameContact( collide( upper, lower, previous_codes[box_idx] ), uncached, upper, lower ) )
+      {
+        std::cerr << "Cached and uncached contacts differ for boxes " << box_idx << " and " << box_idx + 1 << " on step " << step << std::endl;
+        return EXIT_FAILURE;
+      }
+      previous_codes[box_idx] = uncached.axis_code;
+    }
+    // Settle the stack a little between steps
+    for( PlacedBox& box : boxes )
+    {
+      box.cm += Vector3s{ jitter_gen( mt ), jitter_gen( mt ), 0.1 * jitter_gen( mt ) };
+      box.R = rotation( jitter_gen( mt ), Vector3s::UnitZ() ) * box.R;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+// An axis cached before a box tipped over is far deeper than the shallowest axis and must be dropped
+static int testStaleAxis()
+{
+  const PlacedBox lower{ Vector3s::Zero(), Matrix33sr::Identity(), Vector3s{ 2.0, 2.0, 0.5 } };
+  const PlacedBox upper{ Vector3s{ 0.3, -0.2, 0.99 }, rotation( 0.4, Vector3s::UnitZ() ), Vector3s{ 0.5, 0.5, 0.5 } };
+  const BoxBoxContact uncached{ collide( upper, lower, 0 ) };
+  for( int cached_code = 1; cached_code <= 15; ++cached_code )
+  {
+    if( cached_code == uncached.axis_code )
+    {
+      continue;
+    }
+    const BoxBoxContact cached{ collide( upper, lower, cached_code ) };
+    if( depthAlong( upper, lower, cached.n ) > 1.05 * depthAlong( upper, lower, uncached.n ) + 1.0e-12 )
+    {
+      std::cerr << "Cached axis " << cached_code << " was kept with depth " << depthAlong( upper, lower, cached.n ) << ", shallowest depth is " << depthAlong( upper, lower, uncached.n ) << std::endl;
+      return EXIT_FAILURE;
+    }
+    if( cached.points.empty() )
+    {
+      std::cerr << "Cached axis " << cached_code << " lost the contact." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  // A side face of the upper box penetrates far deeper than the resting face, so the cached axis is dropped
+  const BoxBoxContact side_cached{ collide( upper, lower, 1 ) };
+  if( !sameContact( side_cached, uncached, upper, lower ) )
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+// A cached separating axis ends the test immediately, and any separating axis found is recorded
+static int testSeparated()
+{
+  const PlacedBox lower{ Vector3s::Zero(), Matrix33sr::Identity(), Vector3s::Constant( 0.5 ) };
+  const PlacedBox upper{ Vector3s{ 0.1, 0.0, 1.01 }, rotation( 0.3, Vector3s::UnitZ() ), Vector3s::Constant( 0.5 ) };
+  const BoxBoxContact uncached{ collide( upper, lower, 0 ) };
+  if( !uncached.points.empty() || uncached.axis_code == 0 )
+  {
+    std::cerr << "Separated boxes produced " << uncached.points.size() << " contact points and axis code " << uncached.axis_code << std::endl;
+    return EXIT_FAILURE;
+  }
+  const BoxBoxContact cached{ collide( upper, lower, uncached.axis_code ) };
+  if( !cached.points.empty() || cached.axis_code != uncached.axis_code )
+  {
+    std::cerr << "Cached separating axis produced " << cached.points.size() << " contact points and axis code " << cached.axis_code << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+// Axes recorded for the pairs (0,1), (0,3), and (2,5), and a pending axis for (1,4) from an unfinished pass
+static BoxBoxAxisCache testCache()
+{
+  BoxBoxAxisCache cache;
+  cache.recordAxis( 0, 1, 3 );
+  cache.recordAxis( 0, 3, 6 );
+  cache.recordAxis( 2, 5, 11 );
+  cache.endPass();
+  cache.recordAxis( 1, 4, 2 );
+  return cache;
+}
+
+static bool checkCache( const BoxBoxAxisCache& cache )
+{
+  const std::vector<std::pair<std::pair<unsigned,unsigned>,int>> expected{
+    { { 0, 1 }, 3 }, { { 0, 3 }, 6 }, { { 2, 5 }, 11 }, { { 1, 0 }, 0 }, { { 1, 4 }, 0 }, { { 3, 4 }, 0 }
+  };
+  for( const std::pair<std::pair<unsigned,unsigned>,int>& entry : expected )
+  {
+    const int axis_code{ cache.previousAxis( entry.first.first, entry.first.second ) };
+    if( axis_code != entry.second )
+    {
+      std::cerr << "Pair " << entry.first.first << " " << entry.first.second << " has axis " << axis_code << ", expected " << entry.second << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+static int testSerialization()
+{
+  const BoxBoxAxisCache cache{ testCache() };
+  if( !checkCache( cache ) )
+  {
+    return EXIT_FAILURE;
+  }
+  std::stringstream serial_stream;
+  cache.serialize( serial_stream );
+  BoxBoxAxisCache deserialized;
+  deserialized.recordAxis( 7, 8, 4 );
+  deserialized.endPass();
+  deserialized.deserialize( serial_stream );
+  return checkCache( deserialized ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int testCheckpoint()
+{
+  const BoxBoxAxisCache cache{ testCache() };
+  const std::string file_name{ "box_box_axis_cache_checkpoint.bin" };
+  CheckpointWriter writer{ "box_box_axis_cache_test", 1 };
+  cache.writeCheckpoint( "box_box_axes/", writer );
+  if( !writer.writeFile( file_name ) )
+  {
+    std::cerr << "Failed to write checkpoint " << file_name << std::endl;
+    return EXIT_FAILURE;
+  }
+  BoxBoxAxisCache restored;
+  BoxBoxAxisCache missing{ testCache() };
+  try
+  {
+    const CheckpointReader checkpoint{ file_name };
+    restored.readCheckpoint( "box_box_axes/", checkpoint );
+    // Checkpoints without the section leave every pair untested
+    missing.readCheckpoint( "other_axes/", checkpoint );
+  }
+  catch( const std::string& error )
+  {
+    std::cerr << "Failed to read checkpoint: " << error << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::remove( file_name.c_str() );
+  if( missing.previousAxis( 0, 1 ) != 0 || missing.previousAxis( 2, 5 ) != 0 )
+  {
+    std::cerr << "Reading a checkpoint without cached axes kept the old axes." << std::endl;
+    return EXIT_FAILURE;
+  }
+  return checkCache( restored ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main( int argc, char** argv )
+{
+  if( argc != 2 )
+  {
+    std::cerr << "Usage: " << argv[0] << " test_name" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string test_name{ argv[1] };
+
+  if( test_name == "resting_stack" )
+  {
+    return testRestingStack();
+  }
+  else if( test_name == "stale_axis" )
+  {
+    return testStaleAxis();
+  }
+  else if( test_name == "separated" )
+  {
+    return testSeparated();
+  }
+  else if( test_name == "serialization" )
+  {
+    return testSerialization();
+  }
+  else if( test_name == "checkpoint" )
+  {
+    return testCheckpoint();
+  }
+
+  std::cerr << "Invalid test specified: " << test_name << std::endl;
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,259 @@
+// rigidbody3d_convex_polyhedron_tests.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <vector>
+
+#include "scisim/Math/MathDefines.h"
+#include "rigidbody3d/Geometry/RigidBodyConvexPolyhedron.h"
+#include "rigidbody3d/Constraints/ConvexPolyhedronUtilities.h"
+
+// Placed polyhedron in the representation used by the narrow phase
+struct PlacedPolyhedron final
+{
+  Matrix3Xsc vertices;
+  Matrix3Xsc normals;
+  VectorXs offsets;
+};
+
+static Matrix33sr rotation( const scalar& angle, const Vector3s& axis )
+{
+  return Matrix33sr{ Eigen::AngleAxis<scalar>{ angle, axis.normalized() }.toRotationMatrix() };
+}
+
+static PlacedPolyhedron placeBox( const Vector3s& cm, const Matrix33sr& R, const Vector3s& half_widths )
+{
+  PlacedPolyhedron box;
+  ConvexPolyhedronUtilities::boxAsPolyhedron( cm, R, half_widths, box.vertices, box.normals, box.offsets );
+  return box;
+}
+
+// Octahedron with vertices at unit distance along each axis
+static void octahedron( Matrix3Xsc& vertices, Matrix3Xuc& faces )
+{
+  vertices.resize( 3, 6 );
+  vertices << 1.0, -1.0, 0.0,  0.0, 0.0,  0.0,
+              0.0,  0.0, 1.0, -1.0, 0.0,  0.0,
+              0.0,  0.0, 0.0,  0.0, 1.0, -1.0;
+  faces.resize( 3, 8 );
+  faces << 0, 2, 1, 3, 2, 0, 3, 1,
+           2, 1, 3, 0, 0, 3, 1, 2,
+           4, 4, 4, 4, 5, 5, 5, 5;
+}
+
+static bool checkContact( const PlacedPolyhedron& body0, const PlacedPolyhedron& body1, const Vector3s& expected_n, const scalar& expected_depth, const scalar& tolerance )
+{
+  Vector3s n;
+  scalar depth;
+  std::vector<Vector3s> points;
+  if( !ConvexPolyhedronUtilities::computeActiveSet( body0.vertices, body0.normals, body0.offsets, body1.vertices, body1.normals, body1.offsets, n, depth, points ) )
+  {
+    std::cerr << "Overlapping polyhedra were not detected." << std::endl;
+    return false;
+  }
+  if( ( n - expected_n ).norm() > tolerance )
+  {
+    std::cerr << "Contact normal is " << n.transpose() << ", expected " << expected_n.transpose() << std::endl;
+    return false;
+  }
+  if( fabs( depth - expected_depth ) > tolerance )
+  {
+    std::cerr << "Penetration depth is " << depth << ", expected " << expected_depth << std::endl;
+    return false;
+  }
+  if( points.empty() || points.size() > 4 )
+  {
+    std::cerr << "Contact manifold has " << points.size() << " points, expected between one and four." << std::endl;
+    return false;
+  }
+  // Every contact point lies within both polyhedra, up to the depth of penetration
+  for( const Vector3s& point : points )
+  {
+    if( ( body0.normals.transpose() * point - body0.offsets ).maxCoeff() > depth + tolerance || ( body1.normals.transpose() * point - body1.offsets ).maxCoeff() > depth + tolerance )
+    {
+      std::cerr << "Contact point " << point.transpose() << " lies outside of the overlap." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+static int testFaceFace()
+{
+  // A unit cube sinking 0.1 into a wide slab
+  const PlacedPolyhedron cube{ placeBox( Vector3s{ 0.2, -0.1, 0.4 }, Matrix33sr::Identity(), Vector3s::Constant( 0.5 ) ) };
+  const PlacedPolyhedron slab{ placeBox( Vector3s{ 0.0, 0.0, -0.5 }, Matrix33sr::Identity(), Vector3s{ 5.0, 5.0, 0.5 } ) };
+  if( !checkContact( cube, slab, Vector3s::UnitZ(), 0.1, 1.0e-9 ) )
+  {
+    return EXIT_FAILURE;
+  }
+  // Swapping the bodies flips the normal
+  if( !checkContact( slab, cube, -Vector3s::UnitZ(), 0.1, 1.0e-9 ) )
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+static int testRotatedFace()
+{
+  // A cube spun about the vertical and tilted wall, pushed 0.05 into a slab whose top is tilted the same way
+  const Matrix33sr tilt{ rotation( 0.3, Vector3s{ 1.0, 2.0, 0.0 } ) };
+  const Matrix33sr R{ tilt * rotation( 0.7, Vector3s::UnitZ() ) };
+  const Vector3s up{ tilt * Vector3s::UnitZ() };
+  const PlacedPolyhedron cube{ placeBox( 0.45 * up, R, Vector3s::Constant( 0.5 ) ) };
+  const PlacedPolyhedron slab{ placeBox( -1.0 * up, tilt, Vector3s{ 5.0, 5.0, 1.0 } ) };
+  return checkContact( cube, slab, up, 0.05, 1.0e-9 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int testEdgeEdge()
+{
+  // A cube rolled 45 degrees about x rests an edge along x across the edge along y of a cube rolled 45 degrees
+  // about y, penetrating 0.05; no vertex of either lies inside the other
+  const scalar half_diagonal{ 0.5 * sqrt( 2.0 ) };
+  const PlacedPolyhedron upper{ placeBox( Vector3s{ 0.0, 0.0, 2.0 * half_diagonal - 0.05 }, rotation( 0.25 * MathDefines::PI<scalar>(), Vector3s::UnitX() ), Vector3s::Constant( 0.5 ) ) };
+  const PlacedPolyhedron lower{ placeBox( Vector3s::Zero(), rotation( 0.25 * MathDefines::PI<scalar>(), Vector3s::UnitY() ), Vector3s::Constant( 0.5 ) ) };
+  if( !checkContact( upper, lower, Vector3s::UnitZ(), 0.05, 1.0e-9 ) )
+  {
+    return EXIT_FAILURE;
+  }
+
+  // The single witness point sits between the crossing edges
+  Vector3s n;
+  scalar depth;
+  std::vector<Vector3s> points;
+  ConvexPolyhedronUtilities::computeActiveSet( upper.vertices, upper.normals, upper.offsets, lower.vertices, lower.normals, lower.offsets, n, depth, points );
+  if( points.size() != 1 || ( points.front() - Vector3s{ 0.0, 0.0, half_diagonal - 0.025 } ).norm() > 1.0e-9 )
+  {
+    std::cerr << "Edge-edge contact did not produce the witness point between the edges." << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+static int testPolyhedronVertex()
+{
+  // An octahedron standing on a vertex that sinks 0.05 into a slab
+  Matrix3Xsc vertices;
+  Matrix3Xuc faces;
+  octahedron( vertices, faces );
+  const RigidBodyConvexPolyhedron polyhedron{ vertices, faces };
+  PlacedPolyhedron placed;
+  ConvexPolyhedronUtilities::transformPolyhedron( Vector3s{ 0.3, 0.3, 0.95 }, Matrix33sr::Identity(), polyhedron, placed.vertices, placed.normals, placed.offsets );
+  const PlacedPolyhedron slab{ placeBox( Vector3s{ 0.0, 0.0, -0.5 }, Matrix33sr::Identity(), Vector3s{ 5.0, 5.0, 0.5 } ) };
+  if( !checkContact( placed, slab, Vector3s::UnitZ(), 0.05, 1.0e-9 ) )
+  {
+    return EXIT_FAILURE;
+  }
+
+  Vector3s n;
+  scalar depth;
+  std::vector<Vector3s> points;
+  ConvexPolyhedronUtilities::computeActiveSet( placed.vertices, placed.normals, placed.offsets, slab.vertices, slab.normals, slab.offsets, n, depth, points );
+  if( points.size() != 1 || ( points.front() - Vector3s{ 0.3, 0.3, -0.05 } ).norm() > 1.0e-9 )
+  {
+    std::cerr << "Contact point is not the penetrating vertex." << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+static int testSeparated()
+{
+  const PlacedPolyhedron cube{ placeBox( Vector3s{ 0.0, 0.0, 0.51 }, rotation( 0.2, Vector3s::UnitZ() ), Vector3s::Constant( 0.5 ) ) };
+  const PlacedPolyhedron slab{ placeBox( Vector3s{ 0.0, 0.0, -0.5 }, Matrix33sr::Identity(), Vector3s{ 5.0, 5.0, 0.5 } ) };
+  Vector3s n;
+  scalar depth;
+  std::vector<Vector3s> points;
+  if( ConvexPolyhedronUtilities::computeActiveSet( cube.vertices, cube.normals, cube.offsets, slab.vertices, slab.normals, slab.offsets, n, depth, points ) )
+  {
+    std::cerr << "Separated polyhedra were reported as overlapping." << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+static int testHullValidation()
+{
+  Matrix3Xsc vertices;
+  Matrix3Xuc faces;
+  octahedron( vertices, faces );
+  if( !RigidBodyConvexPolyhedron::validateHull( vertices, faces ).empty() )
+  {
+    std::cerr << "Valid octahedron was rejected: " << RigidBodyConvexPolyhedron::validateHull( vertices, faces ) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Reversing the winding turns every normal inward
+  Matrix3Xuc inverted_faces{ faces };
+  inverted_faces.row( 1 ).swap( inverted_faces.row( 2 ) );
+  if( RigidBodyConvexPolyhedron::validateHull( vertices, inverted_faces ).empty() )
+  {
+    std::cerr << "Hull wound clockwise was accepted." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Pushing the top vertex down into the body leaves the hull closed but not convex
+  Matrix3Xsc dented_vertices{ vertices };
+  dented_vertices( 2, 4 ) = -0.5;
+  if( RigidBodyConvexPolyhedron::validateHull( dented_vertices, faces ).empty() )
+  {
+    std::cerr << "Non-convex hull was accepted." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Faces that reference missing vertices
+  Matrix3Xuc bad_faces{ faces };
+  bad_faces( 0, 0 ) = 6;
+  if( RigidBodyConvexPolyhedron::validateHull( vertices, bad_faces ).empty() )
+  {
+    std::cerr << "Hull indexing a missing vertex was accepted." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+int main( int argc, char** argv )
+{
+  if( argc != 2 )
+  {
+    std::cerr << "Usage: " << argv[0] << " test_name" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string test_name{ argv[1] };
+
+  if( test_name == "face_face" )
+  {
+    return testFaceFace();
+  }
+  else if( test_name == "rotated_face" )
+  {
+    return testRotatedFace();
+  }
+  else if( test_name == "edge_edge" )
+  {
+    return testEdgeEdge();
+  }
+  else if( test_name == "polyhedron_vertex" )
+  {
+    return testPolyhedronVertex();
+  }
+  else if( test_name == "separated" )
+  {
+    return testSeparated();
+  }
+  else if( test_name == "hull_validation" )
+  {
+    return testHullValidation();
+  }
+
+  std::cerr << "Invalid test specified: " << test_name << std::endl;
+  return EXIT_FAILURE;
+}
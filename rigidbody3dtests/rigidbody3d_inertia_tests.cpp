@@ -5,9 +5,13 @@
 
 #include <iostream>
 #include <cstdlib>
+#include <vector>
 
 #include "rigidbody3d/Geometry/RigidBodySphere.h"
 #include "rigidbody3d/Geometry/RigidBodyBox.h"
+#include "rigidbody3d/Geometry/RigidBodyCapsule.h"
+#include "rigidbody3d/Geometry/RigidBodyCompound.h"
+#include "rigidbody3d/Geometry/RigidBodyClump.h"
 //#include "rigidbody3d/Geometry/RigidBodyTriangleMesh.h"
 
 // TODO: For meshes, check that vertices are in correct transformed positions
@@ -167,6 +171,360 @@ static int testBoxElongatedTwo()
 
 
 
+// CAPSULE TESTS
+
+static int testCapsuleBasic()
+{
+  // Radius of 1, half length of 2
+  const RigidBodyCapsule capsule{ 1.0, 2.0 };
+
+  scalar M;
+  Vector3s CM;
+  Vector3s I;
+  Matrix33sr R;
+
+  // Density of 3
+  capsule.computeMassAndInertia( 3.0, M, CM, I, R );
+
+  // Check the solution against hand-computed values: a cylinder of mass 12 pi and two hemispheres of mass 2 pi,
+  // each with moment 83/320 M r^2 about its own center of mass 3/8 r beyond the end of the cylinder
+  if( fabs( M - 16.0 * MathDefines::PI<scalar>() ) > 1.0e-6 )
+  {
+    return EXIT_FAILURE;
+  }
+  if( fabs( M - 3.0 * capsule.volume() ) > 1.0e-6 )
+  {
+    return EXIT_FAILURE;
+  }
+  if( ( I - MathDefines::PI<scalar>() * Vector3s{ 7.6, 42.6, 42.6 } ).lpNorm<Eigen::Infinity>() > 1.0e-6 )
+  {
+    return EXIT_FAILURE;
+  }
+  // By default capsules are centered at the origin
+  if( CM.lpNorm<Eigen::Infinity>() > 1.0e-6 )
+  {
+    return EXIT_FAILURE;
+  }
+  // By default orientation is set to the identity
+  if( ( R - Matrix33sr::Identity() ).lpNorm<Eigen::Infinity>() > 1.0e-6 )
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+
+// COMPOUND TESTS
+
+static RigidBodyCompound buildCompound( const RigidBodyGeometry& child0, const Vector3s& x0, const Matrix33sr& R0, const RigidBodyGeometry& child1, const Vector3s& x1, const Matrix33sr& R1 )
+{
+  std::vector<std::unique_ptr<RigidBodyGeometry>> children;
+  children.emplace_back( child0.clone() );
+  children.emplace_back( child1.clone() );
+  Matrix3Xsc positions{ 3, 2 };
+  positions << x0, x1;
+  return RigidBodyCompound{ std::move( children ), positions, { R0, R1 } };
+}
+
+// Checks mass, center of mass, and principal moments against expected values
+static int checkCompound( const RigidBodyCompound& compound, const scalar& expected_M, const Vector3s& expected_CM, const Vector3s& expected_I, const scalar& tolerance )
+{
+  scalar M;
+  Vector3s CM;
+  Vector3s I;
+  Matrix33sr R;
+  compound.computeMassAndInertia( 1.0, M, CM, I, R );
+
+  if( fabs( M - expected_M ) > tolerance * expected_M || fabs( compound.volume() - expected_M ) > tolerance * expected_M )
+  {
+    std::cerr << "Compound mass is " << M << ", expected " << expected_M << std::endl;
+    return EXIT_FAILURE;
+  }
+  if( ( CM - expected_CM ).lpNorm<Eigen::Infinity>() > tolerance * cbrt( expected_M ) )
+  {
+    std::cerr << "Compound center of mass is " << CM.transpose() << ", expected " << expected_CM.transpose() << std::endl;
+    return EXIT_FAILURE;
+  }
+  if( ( I - expected_I ).lpNorm<Eigen::Infinity>() > tolerance * expected_I.maxCoeff() )
+  {
+    std::cerr << "Compound principal moments are " << I.transpose() << ", expected " << expected_I.transpose() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+// Checks the principal axes against expected axes, up to sign
+static int checkCompoundAxes( const RigidBodyCompound& compound, const Matrix33sr& expected_R )
+{
+  scalar M;
+  Vector3s CM;
+  Vector3s I;
+  Matrix33sr R;
+  compound.computeMassAndInertia( 1.0, M, CM, I, R );
+  if( ( ( R.transpose() * expected_R ).cwiseAbs() - Matrix33sr::Identity() ).lpNorm<Eigen::Infinity>() > 1.0e-6 )
+  {
+    std::cerr << "Compound principal axes are not the expected axes" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+// Separate children sum exactly, with parallel axis shifts
+static int testCompoundDisjoint()
+{
+  const RigidBodySphere sphere{ 1.0 };
+  const RigidBodyCompound compound{ buildCompound( sphere, Vector3s{ -2.0, 1.0, 0.5 }, Matrix33sr::Identity(), sphere, Vector3s{ 2.0, 1.0, 0.5 }, Matrix33sr::Identity() ) };
+  const scalar sphere_M{ 4.0 * MathDefines::PI<scalar>() / 3.0 };
+  const Vector3s expected_I{ 0.8 * sphere_M, 0.8 * sphere_M + 8.0 * sphere_M, 0.8 * sphere_M + 8.0 * sphere_M };
+  if( checkCompound( compound, 2.0 * sphere_M, Vector3s{ 0.0, 1.0, 0.5 }, expected_I, 1.0e-12 ) != EXIT_SUCCESS )
+  {
+    return EXIT_FAILURE;
+  }
+  return checkCompoundAxes( compound, Matrix33sr::Identity() );
+}
+
+// Overlapping spheres count the lens they share once
+static int testCompoundOverlappingSpheres()
+{
+  const RigidBodySphere sphere{ 1.0 };
+  const RigidBodyCompound compound{ buildCompound( sphere, Vector3s{ -0.5, 0.0, 0.0 }, Matrix33sr::Identity(), sphere, Vector3s{ 0.5, 0.0, 0.0 }, Matrix33sr::Identity() ) };
+
+  // Two unit spheres a unit apart share a lens of volume 5 pi / 12
+  const scalar expected_M{ 8.0 * MathDefines::PI<scalar>() / 3.0 - 5.0 * MathDefines::PI<scalar>() / 12.0 };
+
+  scalar M;
+  Vector3s CM;
+  Vector3s I;
+  Matrix33sr R;
+  compound.computeMassAndInertia( 1.0, M, CM, I, R );
+  if( fabs( M - expected_M ) > 1.0e-4 * expected_M )
+  {
+    std::cerr << "Compound mass is " << M << ", expected " << expected_M << std::endl;
+    return EXIT_FAILURE;
+  }
+  if( CM.lpNorm<Eigen::Infinity>() > 1.0e-6 )
+  {
+    std::cerr << "Compound center of mass is " << CM.transpose() << ", expected the origin" << std::endl;
+    return EXIT_FAILURE;
+  }
+  // Symmetric about the line between the centers
+  if( fabs( I.y() - I.z() ) > 1.0e-4 * I.z() || I.x() >= I.y() )
+  {
+    std::cerr << "Compound principal moments " << I.transpose() << " are not those of a body elongated along the line between the spheres" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+// A capsule tilted inside a box adds nothing to the box
+static int testCompoundCapsuleInBox()
+{
+  const RigidBodyBox box{ Vector3s{ 2.0, 1.5, 1.0 } };
+  const RigidBodyCapsule capsule{ 0.4, 0.5 };
+  const Matrix33sr tilt{ Eigen::AngleAxis<scalar>{ 0.6, Vector3s{ 1.0, 1.0, 1.0 }.normalized() }.toRotationMatrix() };
+  const RigidBodyCompound compound{ buildCompound( box, Vector3s{ 1.0, 2.0, 3.0 }, Matrix33sr::Identity(), capsule, Vector3s{ 1.3, 2.2, 2.9 }, tilt ) };
+
+  scalar M;
+  Vector3s CM;
+  Vector3s I;
+  Matrix33sr R;
+  box.computeMassAndInertia( 1.0, M, CM, I, R );
+  if( checkCompound( compound, M, Vector3s{ 1.0, 2.0, 3.0 }, I, 1.0e-4 ) != EXIT_SUCCESS )
+  {
+    return EXIT_FAILURE;
+  }
+  return checkCompoundAxes( compound, R );
+}
+
+// A box tilted inside a sphere adds nothing to the sphere
+static int testCompoundBoxInSphere()
+{
+  const RigidBodySphere sphere{ 2.0 };
+  const RigidBodyBox box{ Vector3s{ 1.0, 0.6, 0.3 } };
+  const Matrix33sr tilt{ Eigen::AngleAxis<scalar>{ 1.1, Vector3s{ 0.3, -1.0, 2.0 }.normalized() }.toRotationMatrix() };
+  const RigidBodyCompound compound{ buildCompound( sphere, Vector3s{ -1.0, 0.0, 1.0 }, Matrix33sr::Identity(), box, Vector3s{ -1.2, 0.1, 1.0 }, tilt ) };
+
+  scalar M;
+  Vector3s CM;
+  Vector3s I;
+  Matrix33sr R;
+  sphere.computeMassAndInertia( 1.0, M, CM, I, R );
+  // The principal axes of a sphere are arbitrary, so only compare moments
+  return checkCompound( compound, M, Vector3s{ -1.0, 0.0, 1.0 }, I, 1.0e-4 );
+}
+
+
+
+// CLUMP TESTS
+
+// A clump of one sphere is that sphere, moved to its center
+static int testClumpSingleSphere()
+{
+  Matrix3Xsc centers{ 3, 1 };
+  centers << 1.0, 2.0, 3.0;
+  const RigidBodyClump clump{ centers, VectorXs::Constant( 1, 2.8575 ) };
+
+  scalar M;
+  Vector3s CM;
+  Vector3s I;
+  Matrix33sr R;
+  clump.computeMassAndInertia( 1.74040, M, CM, I, R );
+
+  // Same values as the pool ball
+  if( fabs( M - 170.096900946 ) > 1.0e-6 )
+  {
+    return EXIT_FAILURE;
+  }
+  if( ( I - Vector3s::Constant( 555.557315361 ) ).lpNorm<Eigen::Infinity>() > 1.0e-6 )
+  {
+    return EXIT_FAILURE;
+  }
+  if( ( CM - Vector3s{ 1.0, 2.0, 3.0 } ).lpNorm<Eigen::Infinity>() > 1.0e-12 )
+  {
+    return EXIT_FAILURE;
+  }
+  // The sphere sits at the center of mass
+  if( clump.centers().lpNorm<Eigen::Infinity>() > 1.0e-12 )
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+// Separate spheres sum exactly, with parallel axis shifts
+static int testClumpDisjoint()
+{
+  Matrix3Xsc centers{ 3, 2 };
+  centers << 0.0, 0.0,
+             -1.0, 2.0,
+             0.0, 0.0;
+  const RigidBodyClump clump{ centers, Vector2s{ 1.0, 0.5 } };
+
+  scalar M;
+  Vector3s CM;
+  Vector3s I;
+  Matrix33sr R;
+  clump.computeMassAndInertia( 1.0, M, CM, I, R );
+
+  const scalar M0{ 4.0 * MathDefines::PI<scalar>() / 3.0 };
+  const scalar M1{ M0 / 8.0 };
+  // The center of mass divides the unit separation in the ratio of the masses
+  const scalar y0{ -3.0 * M1 / ( M0 + M1 ) };
+  const scalar y1{ 3.0 * M0 / ( M0 + M1 ) };
+  const scalar I_self{ 0.4 * M0 + 0.4 * M1 * 0.25 };
+  const scalar I_shift{ M0 * y0 * y0 + M1 * y1 * y1 };
+  if( fabs( M - ( M0 + M1 ) ) > 1.0e-12 )
+  {
+    return EXIT_FAILURE;
+  }
+  if( ( CM - Vector3s{ 0.0, -1.0 - y0, 0.0 } ).lpNorm<Eigen::Infinity>() > 1.0e-12 )
+  {
+    return EXIT_FAILURE;
+  }
+  if( ( I - Vector3s{ I_self, I_self + I_shift, I_self + I_shift } ).lpNorm<Eigen::Infinity>() > 1.0e-12 )
+  {
+    return EXIT_FAILURE;
+  }
+  // The smallest moment is about the line between the centers
+  if( fabs( fabs( R.col( 0 ).y() ) - 1.0 ) > 1.0e-12 )
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+// Overlapping spheres of different radii count the two spherical caps they share once
+static int testClumpOverlappingPair()
+{
+  const scalar r0{ 1.0 };
+  const scalar r1{ 0.5 };
+  const scalar d{ 1.0 };
+  Matrix3Xsc centers{ 3, 2 };
+  centers << 0.0, d,
+             0.0, 0.0,
+             0.0, 0.0;
+  const RigidBodyClump clump{ centers, Vector2s{ r0, r1 } };
+
+  scalar M;
+  Vector3s CM;
+  Vector3s I;
+  Matrix33sr R;
+  clump.computeMassAndInertia( 1.0, M, CM, I, R );
+
+  // The spheres meet in the plane at x_p, which cuts a cap of height h0 from the first and h1 from the second
+  const scalar x_p{ ( d * d + r0 * r0 - r1 * r1 ) / ( 2.0 * d ) };
+  const scalar h0{ r0 - x_p };
+  const scalar h1{ x_p - ( d - r1 ) };
+  const scalar V0{ MathDefines::PI<scalar>() * h0 * h0 * ( 3.0 * r0 - h0 ) / 3.0 };
+  const scalar V1{ MathDefines::PI<scalar>() * h1 * h1 * ( 3.0 * r1 - h1 ) / 3.0 };
+  const scalar c0{ 3.0 * ( 2.0 * r0 - h0 ) * ( 2.0 * r0 - h0 ) / ( 4.0 * ( 3.0 * r0 - h0 ) ) };
+  const scalar c1{ d - 3.0 * ( 2.0 * r1 - h1 ) * ( 2.0 * r1 - h1 ) / ( 4.0 * ( 3.0 * r1 - h1 ) ) };
+  const scalar sphere_M0{ 4.0 * MathDefines::PI<scalar>() * r0 * r0 * r0 / 3.0 };
+  const scalar sphere_M1{ 4.0 * MathDefines::PI<scalar>() * r1 * r1 * r1 / 3.0 };
+  const scalar expected_M{ sphere_M0 + sphere_M1 - V0 - V1 };
+  const scalar expected_x{ ( sphere_M1 * d - V0 * c0 - V1 * c1 ) / expected_M };
+
+  if( fabs( M - expected_M ) > 1.0e-4 * expected_M )
+  {
+    std::cerr << "Clump mass is " << M << ", expected " << expected_M << std::endl;
+    return EXIT_FAILURE;
+  }
+  if( ( CM - Vector3s{ expected_x, 0.0, 0.0 } ).lpNorm<Eigen::Infinity>() > 1.0e-4 )
+  {
+    std::cerr << "Clump center of mass is " << CM.transpose() << ", expected " << expected_x << " 0 0" << std::endl;
+    return EXIT_FAILURE;
+  }
+  // Symmetric about the line between the centers
+  if( fabs( I.y() - I.z() ) > 1.0e-4 * I.z() || I.x() >= I.y() )
+  {
+    std::cerr << "Clump principal moments " << I.transpose() << " are not those of a body elongated along the line between the spheres" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+// A sphere inside another adds nothing to it
+static int testClumpContained()
+{
+  Matrix3Xsc centers{ 3, 2 };
+  centers << 0.0, 0.4,
+             0.0, -0.3,
+             0.0, 0.5;
+  const RigidBodyClump clump{ centers, Vector2s{ 2.0, 1.0 } };
+
+  scalar M;
+  Vector3s CM;
+  Vector3s I;
+  Matrix33sr R;
+  clump.computeMassAndInertia( 1.0, M, CM, I, R );
+
+  const scalar expected_M{ 32.0 * MathDefines::PI<scalar>() / 3.0 };
+  if( fabs( M - expected_M ) > 1.0e-4 * expected_M )
+  {
+    std::cerr << "Clump mass is " << M << ", expected " << expected_M << std::endl;
+    return EXIT_FAILURE;
+  }
+  if( CM.lpNorm<Eigen::Infinity>() > 1.0e-4 )
+  {
+    std::cerr << "Clump center of mass is " << CM.transpose() << ", expected the origin" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if( ( I - Vector3s::Constant( 1.6 * expected_M ) ).lpNorm<Eigen::Infinity>() > 1.0e-4 * 1.6 * expected_M )
+  {
+    std::cerr << "Clump principal moments are " << I.transpose() << ", expected those of the outer sphere" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+
 // MESH TESTS
 
 // Compute the inertia of a box represented as a triangle mesh
@@ -330,6 +688,51 @@ int main( int argc, char** argv )
       return testBoxElongatedTwo();
     }
   }
+  else if( body_type == "capsule" )
+  {
+    if( test_name == "basic" )
+    {
+      return testCapsuleBasic();
+    }
+  }
+  else if( body_type == "compound" )
+  {
+    if( test_name == "disjoint" )
+    {
+      return testCompoundDisjoint();
+    }
+    else if( test_name == "overlapping_spheres" )
+    {
+      return testCompoundOverlappingSpheres();
+    }
+    else if( test_name == "capsule_in_box" )
+    {
+      return testCompoundCapsuleInBox();
+    }
+    else if( test_name == "box_in_sphere" )
+    {
+      return testCompoundBoxInSphere();
+    }
+  }
+  else if( body_type == "clump" )
+  {
+    if( test_name == "single_sphere" )
+    {
+      return testClumpSingleSphere();
+    }
+    else if( test_name == "disjoint" )
+    {
+      return testClumpDisjoint();
+    }
+    else if( test_name == "overlapping_pair" )
+    {
+      return testClumpOverlappingPair();
+    }
+    else if( test_name == "contained" )
+    {
+      return testClumpContained();
+    }
+  }
 //  else if( body_type == "mesh" )
 //  {
 //    if( test_name == "box00" )
@@ -0,0 +1,280 @@
+// rigidbody3d_material_table_tests.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "scisim/Checkpoint.h"
+#include "scisim/Constraints/MaterialTable.h"
+#include "rigidbody3d/RigidBody3DState.h"
+#include "rigidbody3d/Geometry/RigidBodySphere.h"
+#include "rigidbody3d/Constraints/SphereSphereConstraint.h"
+#include "rigidbody3d/Constraints/StaticPlaneSphereConstraint.h"
+#include "rigidbody3d/StaticGeometry/StaticPlane.h"
+
+// Layout of a checkpoint section table entry: a 64 byte name followed by 40 bytes of offsets, sizes, and flags
+static constexpr std::size_t TABLE_ENTRY_SIZE{ 104 };
+
+// Bodies 0, 1, and 2 of materials 1, 2, and 5 and a table with entries for the pairs (1,2) and (0,1)
+static MaterialTable testTable()
+{
+  MaterialTable table;
+  table.resize( 3 );
+  table.setMaterial( 0, 1 );
+  table.setMaterial( 1, 2 );
+  table.setMaterial( 2, 5 );
+  table.setPairCoefficients( 2, 1, 0.3, 0.7 );
+  // Only friction is given for contacts of material 1 with static geometry
+  table.setPairCoefficients( 0, 1, SCALAR_NAN, 0.1 );
+  return table;
+}
+
+// Contacts between bodies 0 and 1, bodies 1 and 2, and body 0 and the ground plane
+static std::vector<std::unique_ptr<Constraint>> testActiveSet()
+{
+  std::vector<std::unique_ptr<Constraint>> active_set;
+  active_set.emplace_back( new SphereSphereConstraint{ 0, 1, Vector3s::UnitX(), Vector3s::Zero(), 1.0, 1.0 } );
+  active_set.emplace_back( new SphereSphereConstraint{ 1, 2, Vector3s::UnitX(), Vector3s::Zero(), 1.0, 1.0 } );
+  active_set.emplace_back( new StaticPlaneSphereConstraint{ 0, 1.0, StaticPlane{ Vector3s::Zero(), Vector3s::UnitZ() }, 0 } );
+  return active_set;
+}
+
+static bool checkCoefficients( const MaterialTable& table )
+{
+  const std::vector<std::unique_ptr<Constraint>> active_set{ testActiveSet() };
+  VectorXs CoR{ VectorXs::Constant( 3, 0.5 ) };
+  table.restitutionCoefficients( active_set, CoR );
+  VectorXs mu{ VectorXs::Constant( 3, 0.5 ) };
+  table.frictionCoefficients( active_set, mu );
+
+  // The pair (1,2) has both entries; material 5 has none; static geometry with material 1 only overrides friction
+  const VectorXs expected_CoR{ ( VectorXs( 3 ) << 0.3, 0.5, 0.5 ).finished() };
+  const VectorXs expected_mu{ ( VectorXs( 3 ) << 0.7, 0.5, 0.1 ).finished() };
+  if( CoR != expected_CoR )
+  {
+    std::cerr << "Coefficients of restitution are " << CoR.transpose() << ", expected " << expected_CoR.transpose() << std::endl;
+    return false;
+  }
+  if( mu != expected_mu )
+  {
+    std::cerr << "Coefficients of friction are " << mu.transpose() << ", expected " << expected_mu.transpose() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+static int testCoefficients()
+{
+  const MaterialTable table{ testTable() };
+  if( table.empty() || table.numMaterials() != 3 )
+  {
+    std::cerr << "Table has " << table.numMaterials() << " materials, expected 3." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if( !checkCoefficients( table ) )
+  {
+    return EXIT_FAILURE;
+  }
+
+  // An empty table leaves every coefficient alone
+  MaterialTable empty_table;
+  empty_table.resize( 3 );
+  const std::vector<std::unique_ptr<Constraint>> active_set{ testActiveSet() };
+  VectorXs CoR{ VectorXs::Constant( 3, 0.5 ) };
+  empty_table.restitutionCoefficients( active_set, CoR );
+  if( !empty_table.empty() || CoR != VectorXs::Constant( 3, 0.5 ) )
+  {
+    std::cerr << "Empty table changed the scene wide coefficients." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Growing the table keeps the existing entries
+  MaterialTable grown_table{ testTable() };
+  grown_table.setPairCoefficients( 7, 7, 0.9, 0.9 );
+  if( grown_table.numMaterials() != 8 || !checkCoefficients( grown_table ) )
+  {
+    std::cerr << "Growing the table lost existing entries." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+static int testSerialization()
+{
+  const MaterialTable table{ testTable() };
+  std::stringstream serial_stream;
+  table.serialize( serial_stream );
+  const MaterialTable deserialized{ serial_stream };
+  if( deserialized.nbodies() != table.nbodies() || deserialized.numMaterials() != table.numMaterials() )
+  {
+    std::cerr << "Deserialized table has " << deserialized.nbodies() << " bodies and " << deserialized.numMaterials() << " materials, expected " << table.nbodies() << " and " << table.numMaterials() << std::endl;
+    return EXIT_FAILURE;
+  }
+  for( unsigned bdy_idx = 0; bdy_idx < table.nbodies(); ++bdy_idx )
+  {
+    if( deserialized.material( bdy_idx ) != table.material( bdy_idx ) )
+    {
+      std::cerr << "Deserialized material of body " << bdy_idx << " is " << deserialized.material( bdy_idx ) << ", expected " << table.material( bdy_idx ) << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return checkCoefficients( deserialized ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Three unit spheres carrying the test table
+static RigidBody3DState testState()
+{
+  const std::vector<Vector3s> X{ Vector3s{ 0.0, 0.0, 1.0 }, Vector3s{ 2.0, 0.0, 1.0 }, Vector3s{ 4.0, 0.0, 1.0 } };
+  const std::vector<Vector3s> V( 3, Vector3s::Zero() );
+  const std::vector<scalar> M( 3, 1.0 );
+  const Matrix33sr identity{ Matrix33sr::Identity() };
+  const std::vector<VectorXs> R( 3, Eigen::Map<const VectorXs>{ identity.data(), 9 } );
+  const std::vector<Vector3s> omega( 3, Vector3s::Zero() );
+  const std::vector<Vector3s> I0( 3, Vector3s::Constant( 0.4 ) );
+  const std::vector<bool> fixed( 3, false );
+  const std::vector<unsigned> geom_indices( 3, 0 );
+  std::vector<std::unique_ptr<RigidBodyGeometry>> geometry;
+  geometry.emplace_back( new RigidBodySphere{ 1.0 } );
+
+  RigidBody3DState state;
+  state.setState( X, V, M, R, omega, I0, fixed, geom_indices, std::move( geometry ) );
+  state.materials() = testTable();
+  return state;
+}
+
+// Writes the checkpoint of a state to a file, optionally renaming the materials section so readers do not find it
+static bool writeStateCheckpoint( const RigidBody3DState& state, const bool drop_materials, const std::string& file_name )
+{
+  CheckpointWriter checkpoint{ "material_table_test", 1 };
+  state.writeCheckpoint( "", checkpoint );
+  std::vector<char> image;
+  checkpoint.writeImage( image );
+  if( drop_materials )
+  {
+    bool found{ false };
+    for( std::size_t entry_start = image.size() - TABLE_ENTRY_SIZE; entry_start >= TABLE_ENTRY_SIZE; entry_start -= TABLE_ENTRY_SIZE )
+    {
+      if( std::strncmp( image.data() + entry_start, "materials", 64 ) == 0 )
+      {
+        std::strncpy( image.data() + entry_start, "unused", 64 );
+        found = true;
+        break;
+      }
+    }
+    if( !found )
+    {
+      std::cerr << "Checkpoint has no materials section." << std::endl;
+      return false;
+    }
+  }
+  std::ofstream output_stream{ file_name, std::ios::binary };
+  output_stream.write( image.data(), std::streamsize( image.size() ) );
+  return bool( output_stream );
+}
+
+static int testCheckpoint()
+{
+  const RigidBody3DState state{ testState() };
+  const std::string file_name{ "material_table_checkpoint.bin" };
+  if( !writeStateCheckpoint( state, false, file_name ) )
+  {
+    return EXIT_FAILURE;
+  }
+  RigidBody3DState restored;
+  try
+  {
+    const CheckpointReader checkpoint{ file_name };
+    restored.readCheckpoint( "", checkpoint );
+  }
+  catch( const std::string& error )
+  {
+    std::cerr << "Failed to read checkpoint: " << error << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::remove( file_name.c_str() );
+  if( restored.materials().nbodies() != 3 || restored.materials().material( 2 ) != 5 )
+  {
+    std::cerr << "Checkpoint did not restore the body materials." << std::endl;
+    return EXIT_FAILURE;
+  }
+  return checkCoefficients( restored.materials() ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Checkpoints written before materials were added give every body material 0 and an empty table
+static int testMissingCheckpointSection()
+{
+  const RigidBody3DState state{ testState() };
+  const std::string file_name{ "material_table_missing_section.bin" };
+  if( !writeStateCheckpoint( state, true, file_name ) )
+  {
+    return EXIT_FAILURE;
+  }
+  RigidBody3DState restored{ testState() };
+  try
+  {
+    const CheckpointReader checkpoint{ file_name };
+    restored.readCheckpoint( "", checkpoint );
+  }
+  catch( const std::string& error )
+  {
+    std::cerr << "Failed to read checkpoint without materials: " << error << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::remove( file_name.c_str() );
+  const MaterialTable& materials{ restored.materials() };
+  if( !materials.empty() || materials.nbodies() != 3 )
+  {
+    std::cerr << "Checkpoint without materials left " << materials.numMaterials() << " materials for " << materials.nbodies() << " bodies, expected none for 3." << std::endl;
+    return EXIT_FAILURE;
+  }
+  for( unsigned bdy_idx = 0; bdy_idx < materials.nbodies(); ++bdy_idx )
+  {
+    if( materials.material( bdy_idx ) != 0 )
+    {
+      std::cerr << "Body " << bdy_idx << " has material " << materials.material( bdy_idx ) << " after reading a checkpoint without materials." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+int main( int argc, char** argv )
+{
+  if( argc != 2 )
+  {
+    std::cerr << "Usage: " << argv[0] << " test_name" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string test_name{ argv[1] };
+
+  if( test_name == "coefficients" )
+  {
+    return testCoefficients();
+  }
+  else if( test_name == "serialization" )
+  {
+    return testSerialization();
+  }
+  else if( test_name == "checkpoint" )
+  {
+    return testCheckpoint();
+  }
+  else if( test_name == "missing_checkpoint_section" )
+  {
+    return testMissingCheckpointSection();
+  }
+
+  std::cerr << "Invalid test specified: " << test_name << std::endl;
+  return EXIT_FAILURE;
+}
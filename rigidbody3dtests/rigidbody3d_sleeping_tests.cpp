@@ -0,0 +1,194 @@
+// rigidbody3d_sleeping_tests.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <cstdlib>
+
+#include "rigidbody3d/RigidBody3DSim.h"
+#include "rigidbody3d/Geometry/RigidBodySphere.h"
+#include "rigidbody3d/StaticGeometry/StaticPlane.h"
+#include "scisim/Constraints/Constraint.h"
+
+// A stack of two unit spheres resting on the ground plane and a fixed, scripted sphere beside the stack
+static void buildStack( RigidBody3DSim& sim )
+{
+  const std::vector<Vector3s> X{ Vector3s{ 0.0, 0.0, 1.0 }, Vector3s{ 0.0, 0.0, 3.0 }, Vector3s{ 5.0, 0.0, 1.0 } };
+  const std::vector<Vector3s> V( 3, Vector3s::Zero() );
+  const std::vector<scalar> M( 3, 1.0 );
+  const Matrix33sr identity{ Matrix33sr::Identity() };
+  const std::vector<VectorXs> R( 3, Eigen::Map<const VectorXs>{ identity.data(), 9 } );
+  const std::vector<Vector3s> omega( 3, Vector3s::Zero() );
+  const std::vector<Vector3s> I0( 3, Vector3s::Constant( 0.4 ) );
+  const std::vector<bool> fixed{ false, false, true };
+  const std::vector<unsigned> geom_indices( 3, 0 );
+  std::vector<std::unique_ptr<RigidBodyGeometry>> geometry;
+  geometry.emplace_back( new RigidBodySphere{ 1.0 } );
+
+  RigidBody3DState& state{ sim.getState() };
+  state.setState( X, V, M, R, omega, I0, fixed, geom_indices, std::move( geometry ) );
+  state.addStaticPlane( StaticPlane{ Vector3s::Zero(), Vector3s::UnitZ() } );
+  state.sleepingIslands() = SleepingIslands{ 1.0e-3, 1.0e-3, 0.1 };
+  state.sleepingIslands().resize( state.nbodies() );
+}
+
+// Records the contacts of the stack at rest and puts it to sleep
+static bool putStackToSleep( RigidBody3DSim& sim )
+{
+  RigidBody3DState& state{ sim.getState() };
+  std::vector<std::unique_ptr<Constraint>> active_set;
+  sim.computeActiveSet( state.q(), state.q(), state.v(), active_set );
+  state.sleepingIslands().update( 1.0, VectorXs::Zero( state.nbodies() ), VectorXs::Zero( state.nbodies() ), state.fixed() );
+  return state.asleep( 0 ) && state.asleep( 1 ) && !state.asleep( 2 );
+}
+
+// Moves the scripted sphere from x0 to x1 over the step with velocity vx
+static void scriptSphere( RigidBody3DSim& sim, const scalar& x0, const scalar& x1, const scalar& vx, VectorXs& q0, VectorXs& q1 )
+{
+  RigidBody3DState& state{ sim.getState() };
+  q0 = state.q();
+  q0( 6 ) = x0;
+  q1 = state.q();
+  q1( 6 ) = x1;
+  state.q() = q1;
+  state.v()( 6 ) = vx;
+}
+
+static int testScriptedBodyAtRest()
+{
+  RigidBody3DSim sim;
+  buildStack( sim );
+  if( !putStackToSleep( sim ) )
+  {
+    std::cerr << "Failed to put the stack to sleep." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // A scripted body at rest touching the stack leaves it asleep
+  VectorXs q0;
+  VectorXs q1;
+  scriptSphere( sim, 1.9, 1.9, 0.0, q0, q1 );
+  std::vector<std::unique_ptr<Constraint>> active_set;
+  sim.computeActiveSet( q0, q1, sim.getState().v(), active_set );
+  if( !sim.getState().asleep( 0 ) || !sim.getState().asleep( 1 ) )
+  {
+    std::cerr << "A resting scripted body woke the stack." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+static int testScriptedBodyPushes()
+{
+  RigidBody3DSim sim;
+  buildStack( sim );
+  if( !putStackToSleep( sim ) )
+  {
+    std::cerr << "Failed to put the stack to sleep." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // The scripted body moves into the bottom sphere, which wakes the whole stack
+  VectorXs q0;
+  VectorXs q1;
+  scriptSphere( sim, 2.1, 1.9, -2.0, q0, q1 );
+  std::vector<std::unique_ptr<Constraint>> active_set;
+  sim.computeActiveSet( q0, q1, sim.getState().v(), active_set );
+  if( sim.getState().asleep( 0 ) || sim.getState().asleep( 1 ) )
+  {
+    std::cerr << "A moving scripted body failed to wake the stack." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if( active_set.empty() )
+  {
+    std::cerr << "No contacts detected after the stack woke." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+static int testMovingPlane()
+{
+  RigidBody3DSim sim;
+  buildStack( sim );
+  if( !putStackToSleep( sim ) )
+  {
+    std::cerr << "Failed to put the stack to sleep." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Scripting the ground to move wakes the stack resting on it
+  sim.getState().staticPlane( 0 ).v() = Vector3s{ 0.0, 0.0, 1.0 };
+  std::vector<std::unique_ptr<Constraint>> active_set;
+  sim.computeActiveSet( sim.getState().q(), sim.getState().q(), sim.getState().v(), active_set );
+  if( sim.getState().asleep( 0 ) || sim.getState().asleep( 1 ) )
+  {
+    std::cerr << "A moving static plane failed to wake the stack." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+static int testMeasurementKeepsSleepers()
+{
+  RigidBody3DSim sim;
+  buildStack( sim );
+  if( !putStackToSleep( sim ) )
+  {
+    std::cerr << "Failed to put the stack to sleep." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Counting collisions between steps sees the moving scripted body but must not wake the stack
+  VectorXs q0;
+  VectorXs q1;
+  scriptSphere( sim, 2.1, 1.9, -2.0, q0, q1 );
+  std::map<std::string,unsigned> collision_counts;
+  std::map<std::string,scalar> collision_depths;
+  std::map<std::string,scalar> overlap_volumes;
+  sim.computeNumberOfCollisions( collision_counts, collision_depths, overlap_volumes );
+  if( !sim.getState().asleep( 0 ) || !sim.getState().asleep( 1 ) )
+  {
+    std::cerr << "Counting collisions woke the stack." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+int main( int argc, char** argv )
+{
+  if( argc != 2 )
+  {
+    std::cerr << "Usage: " << argv[0] << " test_name" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string test_name{ argv[1] };
+
+  if( test_name == "scripted_at_rest" )
+  {
+    return testScriptedBodyAtRest();
+  }
+  else if( test_name == "scripted_pushes" )
+  {
+    return testScriptedBodyPushes();
+  }
+  else if( test_name == "moving_plane" )
+  {
+    return testMovingPlane();
+  }
+  else if( test_name == "measurement_keeps_sleepers" )
+  {
+    return testMeasurementKeepsSleepers();
+  }
+
+  std::cerr << "Invalid test specified: " << test_name << std::endl;
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,271 @@
+// rigidbody3d_static_mesh_tests.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <vector>
+
+#include "scisim/Math/MathDefines.h"
+#include "rigidbody3d/StaticGeometry/StaticTriangleMesh.h"
+
+// A bumpy height field over [0,n]x[0,n] with two counter-clockwise triangles per unit square
+static StaticTriangleMesh buildTerrain( const unsigned n )
+{
+  Matrix3Xsc vertices{ 3, ( n + 1 ) * ( n + 1 ) };
+  for( unsigned j = 0; j <= n; ++j )
+  {
+    for( unsigned i = 0; i <= n; ++i )
+    {
+      vertices.col( j * ( n + 1 ) + i ) << scalar( i ), scalar( j ), 0.25 * sin( 0.7 * scalar( i ) ) * cos( 0.4 * scalar( j ) );
+    }
+  }
+  Matrix3Xuc faces{ 3, 2 * n * n };
+  for( unsigned j = 0; j < n; ++j )
+  {
+    for( unsigned i = 0; i < n; ++i )
+    {
+      const unsigned v00{ j * ( n + 1 ) + i };
+      const unsigned v10{ v00 + 1 };
+      const unsigned v01{ v00 + n + 1 };
+      const unsigned v11{ v01 + 1 };
+      faces.col( 2 * ( j * n + i ) ) << v00, v10, v11;
+      faces.col( 2 * ( j * n + i ) + 1 ) << v00, v11, v01;
+    }
+  }
+  return StaticTriangleMesh{ vertices, faces, 0.5 };
+}
+
+static StaticTriangleMesh buildTriangle()
+{
+  Matrix3Xsc vertices{ 3, 3 };
+  vertices << 0.0, 1.0, 0.0,
+              0.0, 0.0, 1.0,
+              0.0, 0.0, 0.0;
+  Matrix3Xuc faces{ 3, 1 };
+  faces << 0, 1, 2;
+  return StaticTriangleMesh{ vertices, faces, 0.1 };
+}
+
+// Faces whose bounding boxes overlap the given box, found by testing every face
+static std::vector<unsigned> bruteForceFaces( const StaticTriangleMesh& mesh, const Array3s& min, const Array3s& max )
+{
+  std::vector<unsigned> faces;
+  for( unsigned face = 0; face < unsigned( mesh.faces().cols() ); ++face )
+  {
+    Array3s face_min{ mesh.vertices().col( mesh.faces()( 0, face ) ).array() };
+    Array3s face_max{ face_min };
+    for( unsigned vrt = 1; vrt < 3; ++vrt )
+    {
+      face_min = face_min.min( mesh.vertices().col( mesh.faces()( vrt, face ) ).array() );
+      face_max = face_max.max( mesh.vertices().col( mesh.faces()( vrt, face ) ).array() );
+    }
+    if( ( face_max >= min ).all() && ( face_min <= max ).all() )
+    {
+      faces.emplace_back( face );
+    }
+  }
+  return faces;
+}
+
+static bool queriesMatchBruteForce( const StaticTriangleMesh& mesh, const unsigned num_queries )
+{
+  std::mt19937_64 generator{ 1234 };
+  std::uniform_real_distribution<scalar> center_dist{ -1.0, scalar( mesh.vertices().row( 0 ).maxCoeff() ) + 1.0 };
+  std::uniform_real_distribution<scalar> height_dist{ -0.5, 0.5 };
+  std::uniform_real_distribution<scalar> extent_dist{ 0.01, 2.0 };
+  unsigned num_nonempty{ 0 };
+  for( unsigned query = 0; query < num_queries; ++query )
+  {
+    const Array3s center{ center_dist( generator ), center_dist( generator ), height_dist( generator ) };
+    const Array3s extent{ extent_dist( generator ), extent_dist( generator ), extent_dist( generator ) };
+    std::vector<unsigned> faces;
+    mesh.facesOverlappingBox( center - extent, center + extent, faces );
+    std::sort( faces.begin(), faces.end() );
+    if( faces != bruteForceFaces( mesh, center - extent, center + extent ) )
+    {
+      std::cerr << "BVH query " << query << " returned different faces than testing every face." << std::endl;
+      return false;
+    }
+    num_nonempty += faces.empty() ? 0 : 1;
+  }
+  // Most boxes lie over the mesh; make sure the comparison is not between empty sets
+  if( num_nonempty < num_queries / 2 )
+  {
+    std::cerr << "Too few BVH queries found faces." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+static int testBoxQueries()
+{
+  const StaticTriangleMesh mesh{ buildTerrain( 24 ) };
+  return queriesMatchBruteForce( mesh, 500 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int testBoxQueryEdges()
+{
+  const StaticTriangleMesh mesh{ buildTerrain( 8 ) };
+
+  // A box touching the mesh only at a corner vertex
+  std::vector<unsigned> faces;
+  mesh.facesOverlappingBox( Array3s{ -1.0, -1.0, -1.0 }, Array3s{ 0.0, 0.0, 1.0 }, faces );
+  std::sort( faces.begin(), faces.end() );
+  if( faces != std::vector<unsigned>{ 0, 1 } )
+  {
+    std::cerr << "Box touching a corner of the mesh did not find exactly the two faces at the corner." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // A box beside the mesh
+  faces.clear();
+  mesh.facesOverlappingBox( Array3s{ 9.0, 0.0, -1.0 }, Array3s{ 10.0, 8.0, 1.0 }, faces );
+  if( !faces.empty() )
+  {
+    std::cerr << "Box beside the mesh found faces." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // A box around the whole mesh finds every face exactly once
+  faces.clear();
+  mesh.facesOverlappingBox( Array3s::Constant( -20.0 ), Array3s::Constant( 20.0 ), faces );
+  std::sort( faces.begin(), faces.end() );
+  if( faces.size() != unsigned( mesh.faces().cols() ) || std::adjacent_find( faces.begin(), faces.end() ) != faces.end() )
+  {
+    std::cerr << "Box around the mesh did not find every face exactly once." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+static int testSerialization()
+{
+  const StaticTriangleMesh mesh{ buildTerrain( 16 ) };
+  std::stringstream stream;
+  mesh.serialize( stream );
+  const StaticTriangleMesh copy{ stream };
+  if( copy.vertices() != mesh.vertices() || copy.faces() != mesh.faces() || copy.thickness() != mesh.thickness() )
+  {
+    std::cerr << "Deserialized mesh differs from the original." << std::endl;
+    return EXIT_FAILURE;
+  }
+  // The hierarchy is rebuilt rather than stored
+  return queriesMatchBruteForce( copy, 100 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int testClosestPoint()
+{
+  const StaticTriangleMesh mesh{ buildTriangle() };
+
+  const std::vector<std::pair<Vector3s,Vector3s>> cases{
+    // Above the interior, the projection onto the face
+    { Vector3s{ 0.2, 0.3, 1.0 }, Vector3s{ 0.2, 0.3, 0.0 } },
+    // Below the interior
+    { Vector3s{ 0.25, 0.25, -2.0 }, Vector3s{ 0.25, 0.25, 0.0 } },
+    // Vertex regions
+    { Vector3s{ -1.0, -1.0, 3.0 }, Vector3s{ 0.0, 0.0, 0.0 } },
+    { Vector3s{ 2.0, -1.0, 0.5 }, Vector3s{ 1.0, 0.0, 0.0 } },
+    { Vector3s{ -0.5, 3.0, 0.0 }, Vector3s{ 0.0, 1.0, 0.0 } },
+    // Edge regions
+    { Vector3s{ 0.5, -1.0, 0.0 }, Vector3s{ 0.5, 0.0, 0.0 } },
+    { Vector3s{ -2.0, 0.4, 1.0 }, Vector3s{ 0.0, 0.4, 0.0 } },
+    { Vector3s{ 1.0, 1.0, -1.0 }, Vector3s{ 0.5, 0.5, 0.0 } }
+  };
+  for( const std::pair<Vector3s,Vector3s>& test_case : cases )
+  {
+    const Vector3s closest{ mesh.closestPointOnFace( 0, test_case.first ) };
+    if( ( closest - test_case.second ).lpNorm<Eigen::Infinity>() > 1.0e-12 )
+    {
+      std::cerr << "Closest point to " << test_case.first.transpose() << " is " << closest.transpose() << ", expected " << test_case.second.transpose() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The closest point is no farther than any sampled point of the face
+  std::mt19937_64 generator{ 5678 };
+  std::uniform_real_distribution<scalar> point_dist{ -2.0, 2.0 };
+  std::uniform_real_distribution<scalar> barycentric_dist{ 0.0, 1.0 };
+  for( unsigned sample = 0; sample < 1000; ++sample )
+  {
+    const Vector3s x{ point_dist( generator ), point_dist( generator ), point_dist( generator ) };
+    const scalar distance{ ( mesh.closestPointOnFace( 0, x ) - x ).norm() };
+    scalar u{ barycentric_dist( generator ) };
+    scalar v{ barycentric_dist( generator ) };
+    if( u + v > 1.0 )
+    {
+      u = 1.0 - u;
+      v = 1.0 - v;
+    }
+    if( ( Vector3s{ u, v, 0.0 } - x ).norm() < distance - 1.0e-12 )
+    {
+      std::cerr << "Closest point to " << x.transpose() << " is farther than another point of the face." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+static int testProjection()
+{
+  const StaticTriangleMesh mesh{ buildTriangle() };
+  if( ( mesh.faceNormal( 0 ) - Vector3s::UnitZ() ).norm() > 1.0e-12 )
+  {
+    std::cerr << "Counter-clockwise face does not have an upward normal." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if( !mesh.projectsOntoFace( 0, Vector3s{ 0.2, 0.3, 5.0 } ) || !mesh.projectsOntoFace( 0, Vector3s{ 0.2, 0.3, -5.0 } ) )
+  {
+    std::cerr << "Point over the interior does not project onto the face." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if( mesh.projectsOntoFace( 0, Vector3s{ 0.8, 0.8, 1.0 } ) || mesh.projectsOntoFace( 0, Vector3s{ -0.1, 0.5, 1.0 } ) || mesh.projectsOntoFace( 0, Vector3s{ 0.5, -0.1, 1.0 } ) )
+  {
+    std::cerr << "Point beside the face projects onto it." << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+int main( int argc, char** argv )
+{
+  if( argc != 2 )
+  {
+    std::cerr << "Usage: " << argv[0] << " test_name" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string test_name{ argv[1] };
+
+  if( test_name == "box_queries" )
+  {
+    return testBoxQueries();
+  }
+  else if( test_name == "box_query_edges" )
+  {
+    return testBoxQueryEdges();
+  }
+  else if( test_name == "serialization" )
+  {
+    return testSerialization();
+  }
+  else if( test_name == "closest_point" )
+  {
+    return testClosestPoint();
+  }
+  else if( test_name == "projection" )
+  {
+    return testProjection();
+  }
+
+  std::cerr << "Invalid test specified: " << test_name << std::endl;
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,328 @@
+// RigidBody3DBinaryScene.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "RigidBody3DBinaryScene.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+#include "scisim/Checkpoint.h"
+#include "scisim/CompileDefinitions.h"
+#include "scisim/StringUtilities.h"
+#include "scisim/Utilities.h"
+#include "scisim/Math/Rational.h"
+#include "scisim/UnconstrainedMaps/UnconstrainedMap.h"
+#include "scisim/ConstrainedMaps/ConstrainedMapUtilities.h"
+#include "scisim/ConstrainedMaps/FrictionSolver.h"
+#include "scisim/ConstrainedMaps/ImpactFrictionMap.h"
+#include "scisim/ConstrainedMaps/ImpactMaps/ImpactOperator.h"
+#include "rigidbody3d/RigidBody3DState.h"
+#include "rigidbody3d/RigidBody3DUtilities.h"
+#include "rigidbody3d/RigidBody3DScriptingCallback.h"
+
+#include "RigidBody3DSceneParser.h"
+#include "RenderingState.h"
+
+static const std::string BINARY_SCENE_KIND{ "rigidbody3d_scene" };
+static const std::uint32_t BINARY_SCENE_SCHEMA_VERSION{ 3 };
+
+static std::string readStringSection( const CheckpointReader& checkpoint, const std::string& name )
+{
+  std::size_t size;
+  const char* const data{ checkpoint.sectionData( name, size ) };
+  return std::string( data, size );
+}
+
+static std::string hashString( const std::uint64_t hash )
+{
+  std::ostringstream hash_stream;
+  hash_stream << std::hex << hash;
+  return hash_stream.str();
+}
+
+bool RigidBody3DBinaryScene::isBinarySceneFile( const std::string& file_name )
+{
+  if( !CheckpointReader::isCheckpoint( file_name ) )
+  {
+    return false;
+  }
+  try
+  {
+    return CheckpointReader{ file_name }.kind() == BINARY_SCENE_KIND;
+  }
+  catch( const std::string& )
+  {
+    return false;
+  }
+}
+
+// Continues a 64 bit FNV-1a hash over the given bytes
+static void hashBytes( const char* const bytes, const std::streamsize size, std::uint64_t& hash )
+{
+  for( std::streamsize idx = 0; idx < size; ++idx )
+  {
+    hash ^= std::uint64_t( static_cast<unsigned char>( bytes[idx] ) );
+    hash *= 1099511628211ULL;
+  }
+}
+
+static bool hashFileContents( const std::string& file_name, std::uint64_t& hash )
+{
+  std::ifstream input_stream{ file_name, std::ios::binary };
+  if( !input_stream.is_open() )
+  {
+    return false;
+  }
+  char buffer[65536];
+  while( input_stream.read( buffer, sizeof( buffer ) ) || input_stream.gcount() > 0 )
+  {
+    hashBytes( buffer, input_stream.gcount(), hash );
+  }
+  return input_stream.eof();
+}
+
+bool RigidBody3DBinaryScene::hashSceneFile( const std::string& file_name, const std::vector<std::string>& referenced_files, std::uint64_t& hash )
+{
+  hash = 14695981039346656037ULL;
+  if( !hashFileContents( file_name, hash ) )
+  {
+    return false;
+  }
+  // Names are hashed with the contents so renaming or reordering the referenced files changes the hash
+  for( const std::string& referenced_file : referenced_files )
+  {
+    hashBytes( referenced_file.c_str(), std::streamsize( referenced_file.size() + 1 ), hash );
+    if( !hashFileContents( referenced_file, hash ) )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static std::string serializeFileNames( const std::vector<std::string>& file_names )
+{
+  std::ostringstream serial_stream{ std::ios::binary };
+  Utilities::serialize( file_names.size(), serial_stream );
+  for( const std::string& file_name : file_names )
+  {
+    StringUtilities::serialize( file_name, serial_stream );
+  }
+  return serial_stream.str();
+}
+
+static std::vector<std::string> deserializeFileNames( const CheckpointReader& checkpoint, const std::string& name )
+{
+  CheckpointSectionStream serial_stream{ checkpoint, name };
+  std::vector<std::string> file_names( Utilities::deserialize<std::vector<std::string>::size_type>( serial_stream ) );
+  for( std::string& file_name : file_names )
+  {
+    file_name = StringUtilities::deserialize( serial_stream );
+  }
+  return file_names;
+}
+
+bool RigidBody3DBinaryScene::writeBinarySceneFile( const std::string& file_name, const std::uint64_t source_hash, const std::vector<std::string>& referenced_files, const std::string& scripting_callback, const RigidBody3DScriptingCallbackType scripting_callback_type, const RigidBody3DState& sim_state, const std::unique_ptr<UnconstrainedMap>& unconstrained_map, const std::string& dt_string, const Rational<std::intmax_t>& dt, const scalar& end_time, const std::unique_ptr<ImpactOperator>& impact_operator, const scalar& CoR, const std::unique_ptr<FrictionSolver>& friction_solver, const scalar& mu, const std::unique_ptr<ImpactFrictionMap>& if_map )
+{
+  CheckpointWriter checkpoint{ BINARY_SCENE_KIND, BINARY_SCENE_SCHEMA_VERSION };
+  checkpoint.addSection( "git_revision", CompileDefinitions::GitSHA1 );
+  checkpoint.addSection( "source_hash", hashString( source_hash ) );
+  checkpoint.addSection( "referenced_files", serializeFileNames( referenced_files ) );
+  sim_state.writeCheckpoint( "state/", checkpoint );
+  {
+    std::ostringstream serial_stream{ std::ios::binary };
+    StringUtilities::serialize( scripting_callback, serial_stream );
+    Utilities::serialize( scripting_callback_type, serial_stream );
+    RigidBody3DUtilities::serialize( unconstrained_map, serial_stream );
+    StringUtilities::serialize( dt_string, serial_stream );
+    Utilities::serialize( dt, serial_stream );
+    Utilities::serialize( end_time, serial_stream );
+    ConstrainedMapUtilities::serialize( impact_operator, serial_stream );
+    Utilities::serialize( CoR, serial_stream );
+    ConstrainedMapUtilities::serialize( friction_solver, serial_stream );
+    Utilities::serialize( mu, serial_stream );
+    ConstrainedMapUtilities::serialize( if_map, serial_stream );
+    checkpoint.addSection( "settings", serial_stream.str() );
+  }
+  if( !checkpoint.writeFile( file_name ) )
+  {
+    std::cerr << "Failed to write binary scene file: " << file_name << std::endl;
+    return false;
+  }
+  return true;
+}
+
+static void readBinaryScene( const CheckpointReader& checkpoint, std::string& scripting_callback, RigidBody3DScriptingCallbackType& scripting_callback_type, RigidBody3DState& sim_state, std::unique_ptr<UnconstrainedMap>& unconstrained_map, std::string& dt_string, Rational<std::intmax_t>& dt, scalar& end_time, std::unique_ptr<ImpactOperator>& impact_operator, scalar& CoR, std::unique_ptr<FrictionSolver>& friction_solver, scalar& mu, std::unique_ptr<ImpactFrictionMap>& if_map )
+{
+  sim_state.readCheckpoint( "state/", checkpoint );
+  CheckpointSectionStream serial_stream{ checkpoint, "settings" };
+  scripting_callback = StringUtilities::deserialize( serial_stream );
+  scripting_callback_type = Utilities::deserialize<RigidBody3DScriptingCallbackType>( serial_stream );
+  unconstrained_map = RigidBody3DUtilities::deserializeUnconstrainedMap( serial_stream );
+  dt_string = StringUtilities::deserialize( serial_stream );
+  dt = Utilities::deserialize<Rational<std::intmax_t>>( serial_stream );
+  end_time = Utilities::deserialize<scalar>( serial_stream );
+  impact_operator = ConstrainedMapUtilities::deserializeImpactOperator( serial_stream );
+  CoR = Utilities::deserialize<scalar>( serial_stream );
+  friction_solver = ConstrainedMapUtilities::deserializeFrictionSolver( serial_stream );
+  mu = Utilities::deserialize<scalar>( serial_stream );
+  if_map = ConstrainedMapUtilities::deserializeImpactFrictionMap( serial_stream );
+}
+
+bool RigidBody3DBinaryScene::parseBinarySceneFile( const std::string& file_name, std::string& scripting_callback, RigidBody3DScriptingCallbackType& scripting_callback_type, RigidBody3DState& sim_state, std::unique_ptr<UnconstrainedMap>& unconstrained_map, std::string& dt_string, Rational<std::intmax_t>& dt, scalar& end_time, std::unique_ptr<ImpactOperator>& impact_operator, scalar& CoR, std::unique_ptr<FrictionSolver>& friction_solver, scalar& mu, std::unique_ptr<ImpactFrictionMap>& if_map )
+{
+  try
+  {
+    const CheckpointReader checkpoint{ file_name };
+    if( checkpoint.kind() != BINARY_SCENE_KIND )
+    {
+      std::cerr << "File " << file_name << " is not a binary 3D SCISim scene." << std::endl;
+      return false;
+    }
+    if( checkpoint.schemaVersion() != BINARY_SCENE_SCHEMA_VERSION )
+    {
+      std::cerr << "Binary scene " << file_name << " has schema version " << checkpoint.schemaVersion() << " but version " << BINARY_SCENE_SCHEMA_VERSION << " is required. Recompile it from the xml scene." << std::endl;
+      return false;
+    }
+    const std::string git_revision{ readStringSection( checkpoint, "git_revision" ) };
+    if( git_revision != CompileDefinitions::GitSHA1 )
+    {
+      std::cerr << "Warning, binary scene " << file_name << " was compiled by revision " << git_revision << " but this is revision " << CompileDefinitions::GitSHA1 << std::endl;
+    }
+    readBinaryScene( checkpoint, scripting_callback, scripting_callback_type, sim_state, unconstrained_map, dt_string, dt, end_time, impact_operator, CoR, friction_solver, mu, if_map );
+  }
+  catch( const std::string& error )
+  {
+    std::cerr << error << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool RigidBody3DBinaryScene::compileSceneFile( const std::string& xml_file_name, const std::string& binary_file_name )
+{
+  std::string scripting_callback;
+  RigidBody3DScriptingCallbackType scripting_callback_type;
+  RigidBody3DState sim_state;
+  std::unique_ptr<UnconstrainedMap> unconstrained_map;
+  std::string dt_string;
+  Rational<std::intmax_t> dt;
+  scalar end_time;
+  std::unique_ptr<ImpactOperator> impact_operator;
+  scalar CoR;
+  std::unique_ptr<FrictionSolver> friction_solver;
+  scalar mu;
+  std::unique_ptr<ImpactFrictionMap> if_map;
+  RenderingState UNUSED_rendering_state_UNUSED;
+  std::vector<std::string> referenced_files;
+  if( !RigidBody3DSceneParser::parseXMLSceneFile( xml_file_name, scripting_callback, scripting_callback_type, sim_state, unconstrained_map, dt_string, dt, end_time, impact_operator, CoR, friction_solver, mu, if_map, UNUSED_rendering_state_UNUSED, referenced_files ) )
+  {
+    return false;
+  }
+
+  std::uint64_t source_hash;
+  if( !hashSceneFile( xml_file_name, referenced_files, source_hash ) )
+  {
+    std::cerr << "Failed to read xml scene file " << xml_file_name << " or a file it references" << std::endl;
+    return false;
+  }
+
+  return writeBinarySceneFile( binary_file_name, source_hash, referenced_files, scripting_callback, scripting_callback_type, sim_state, unconstrained_map, dt_string, dt, end_time, impact_operator, CoR, friction_solver, mu, if_map );
+}
+
+// Loads a cached compiled scene of the given xml scene; returns false if there is no usable cache
+static bool loadCachedScene( const std::string& cache_file_name, const std::string& xml_file_name, std::string& scripting_callback, RigidBody3DScriptingCallbackType& scripting_callback_type, RigidBody3DState& sim_state, std::unique_ptr<UnconstrainedMap>& unconstrained_map, std::string& dt_string, Rational<std::intmax_t>& dt, scalar& end_time, std::unique_ptr<ImpactOperator>& impact_operator, scalar& CoR, std::unique_ptr<FrictionSolver>& friction_solver, scalar& mu, std::unique_ptr<ImpactFrictionMap>& if_map )
+{
+  if( !CheckpointReader::isCheckpoint( cache_file_name ) )
+  {
+    return false;
+  }
+  try
+  {
+    const CheckpointReader checkpoint{ cache_file_name };
+    if( checkpoint.kind() != BINARY_SCENE_KIND || checkpoint.schemaVersion() != BINARY_SCENE_SCHEMA_VERSION )
+    {
+      return false;
+    }
+    if( readStringSection( checkpoint, "git_revision" ) != CompileDefinitions::GitSHA1 )
+    {
+      return false;
+    }
+    // The cache was compiled from the files it lists, so it is current if they and the xml are unchanged
+    std::uint64_t source_hash;
+    if( !RigidBody3DBinaryScene::hashSceneFile( xml_file_name, deserializeFileNames( checkpoint, "referenced_files" ), source_hash ) || readStringSection( checkpoint, "source_hash" ) != hashString( source_hash ) )
+    {
+      return false;
+    }
+    // Read into temporaries so a damaged cache leaves the outputs untouched for the xml parser
+    std::string cached_scripting_callback;
+    RigidBody3DScriptingCallbackType cached_scripting_callback_type;
+    RigidBody3DState cached_sim_state;
+    std::unique_ptr<UnconstrainedMap> cached_unconstrained_map;
+    std::string cached_dt_string;
+    Rational<std::intmax_t> cached_dt;
+    scalar cached_end_time;
+    std::unique_ptr<ImpactOperator> cached_impact_operator;
+    scalar cached_CoR;
+    std::unique_ptr<FrictionSolver> cached_friction_solver;
+    scalar cached_mu;
+    std::unique_ptr<ImpactFrictionMap> cached_if_map;
+    readBinaryScene( checkpoint, cached_scripting_callback, cached_scripting_callback_type, cached_sim_state, cached_unconstrained_map, cached_dt_string, cached_dt, cached_end_time, cached_impact_operator, cached_CoR, cached_friction_solver, cached_mu, cached_if_map );
+    scripting_callback = std::move( cached_scripting_callback );
+    scripting_callback_type = cached_scripting_callback_type;
+    sim_state = std::move( cached_sim_state );
+    unconstrained_map = std::move( cached_unconstrained_map );
+    dt_string = std::move( cached_dt_string );
+    dt = cached_dt;
+    end_time = cached_end_time;
+    impact_operator = std::move( cached_impact_operator );
+    CoR = cached_CoR;
+    friction_solver = std::move( cached_friction_solver );
+    mu = cached_mu;
+    if_map = std::move( cached_if_map );
+  }
+  catch( const std::string& error )
+  {
+    std::cerr << "Ignoring scene cache " << cache_file_name << ": " << error << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool RigidBody3DBinaryScene::loadSceneFile( const std::string& file_name, const bool use_cache, std::string& scripting_callback, RigidBody3DScriptingCallbackType& scripting_callback_type, RigidBody3DState& sim_state, std::unique_ptr<UnconstrainedMap>& unconstrained_map, std::string& dt_string, Rational<std::intmax_t>& dt, scalar& end_time, std::unique_ptr<ImpactOperator>& impact_operator, scalar& CoR, std::unique_ptr<FrictionSolver>& friction_solver, scalar& mu, std::unique_ptr<ImpactFrictionMap>& if_map )
+{
+  if( isBinarySceneFile( file_name ) )
+  {
+    return parseBinarySceneFile( file_name, scripting_callback, scripting_callback_type, sim_state, unconstrained_map, dt_string, dt, end_time, impact_operator, CoR, friction_solver, mu, if_map );
+  }
+
+  RenderingState UNUSED_rendering_state_UNUSED;
+  if( !use_cache )
+  {
+    return RigidBody3DSceneParser::parseXMLSceneFile( file_name, scripting_callback, scripting_callback_type, sim_state, unconstrained_map, dt_string, dt, end_time, impact_operator, CoR, friction_solver, mu, if_map, UNUSED_rendering_state_UNUSED );
+  }
+
+  const std::string cache_file_name{ file_name + ".bin" };
+  if( loadCachedScene( cache_file_name, file_name, scripting_callback, scripting_callback_type, sim_state, unconstrained_map, dt_string, dt, end_time, impact_operator, CoR, friction_solver, mu, if_map ) )
+  {
+    std::cout << "Loaded cached scene " << cache_file_name << std::endl;
+    return true;
+  }
+
+  std::vector<std::string> referenced_files;
+  if( !RigidBody3DSceneParser::parseXMLSceneFile( file_name, scripting_callback, scripting_callback_type, sim_state, unconstrained_map, dt_string, dt, end_time, impact_operator, CoR, friction_solver, mu, if_map, UNUSED_rendering_state_UNUSED, referenced_files ) )
+  {
+    return false;
+  }
+  // A failure to hash the sources or write the cache only costs time on the next run
+  std::uint64_t source_hash;
+  if( hashSceneFile( file_name, referenced_files, source_hash ) && writeBinarySceneFile( cache_file_name, source_hash, referenced_files, scripting_callback, scripting_callback_type, sim_state, unconstrained_map, dt_string, dt, end_time, impact_operator, CoR, friction_solver, mu, if_map ) )
+  {
+    std::cout << "Cached scene to " << cache_file_name << std::endl;
+  }
+  return true;
+}
@@ -0,0 +1,53 @@
+// RigidBody3DBinaryScene.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Compiled scenes: the result of parsing an xml scene, including the mass properties, triangle meshes, and
+// signed distance fields computed while parsing, stored in a checkpoint file so it can be loaded with a
+// few bulk reads. A compiled scene records the revision of the code that compiled it and a hash of the xml
+// together with every file the xml references, such as meshes and hulls, so a cached copy saved next to the
+// xml can be checked for staleness.
+
+#ifndef RIGID_BODY_3D_BINARY_SCENE_H
+#define RIGID_BODY_3D_BINARY_SCENE_H
+
+#include "scisim/Math/MathDefines.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class RigidBody3DState;
+class UnconstrainedMap;
+class ImpactOperator;
+class FrictionSolver;
+class ImpactFrictionMap;
+enum class RigidBody3DScriptingCallbackType : std::uint8_t;
+template<typename T> class Rational;
+
+namespace RigidBody3DBinaryScene
+{
+
+  // True if the file is a compiled scene
+  bool isBinarySceneFile( const std::string& file_name );
+
+  // Hash of the contents of an xml scene file followed by the files it references; returns false if any file
+  // can not be read
+  bool hashSceneFile( const std::string& file_name, const std::vector<std::string>& referenced_files, std::uint64_t& hash );
+
+  bool writeBinarySceneFile( const std::string& file_name, const std::uint64_t source_hash, const std::vector<std::string>& referenced_files, const std::string& scripting_callback, const RigidBody3DScriptingCallbackType scripting_callback_type, const RigidBody3DState& sim_state, const std::unique_ptr<UnconstrainedMap>& unconstrained_map, const std::string& dt_string, const Rational<std::intmax_t>& dt, const scalar& end_time, const std::unique_ptr<ImpactOperator>& impact_operator, const scalar& CoR, const std::unique_ptr<FrictionSolver>& friction_solver, const scalar& mu, const std::unique_ptr<ImpactFrictionMap>& if_map );
+
+  bool parseBinarySceneFile( const std::string& file_name, std::string& scripting_callback, RigidBody3DScriptingCallbackType& scripting_callback_type, RigidBody3DState& sim_state, std::unique_ptr<UnconstrainedMap>& unconstrained_map, std::string& dt_string, Rational<std::intmax_t>& dt, scalar& end_time, std::unique_ptr<ImpactOperator>& impact_operator, scalar& CoR, std::unique_ptr<FrictionSolver>& friction_solver, scalar& mu, std::unique_ptr<ImpactFrictionMap>& if_map );
+
+  // Compiles an xml scene file to a binary scene file
+  bool compileSceneFile( const std::string& xml_file_name, const std::string& binary_file_name );
+
+  // Loads either an xml or a compiled scene. If use_cache is set, an xml scene is loaded from its compiled
+  // copy, xml_file_name.bin, when that was compiled from the same xml and referenced files by the same
+  // revision of the code; otherwise the xml is parsed and the compiled copy rewritten.
+  bool loadSceneFile( const std::string& file_name, const bool use_cache, std::string& scripting_callback, RigidBody3DScriptingCallbackType& scripting_callback_type, RigidBody3DState& sim_state, std::unique_ptr<UnconstrainedMap>& unconstrained_map, std::string& dt_string, Rational<std::intmax_t>& dt, scalar& end_time, std::unique_ptr<ImpactOperator>& impact_operator, scalar& CoR, std::unique_ptr<FrictionSolver>& friction_solver, scalar& mu, std::unique_ptr<ImpactFrictionMap>& if_map );
+
+}
+
+#endif
@@ -10,6 +10,8 @@
 #include <algorithm>
 
 #include "scisim/StringUtilities.h"
+#include "scisim/SleepingIslands.h"
+#include "scisim/Constraints/MaterialTable.h"
 #include "scisim/Math/Rational.h"
 #include "scisim/ConstrainedMaps/ImpactMaps/ImpactOperator.h"
 #include "scisim/ConstrainedMaps/ImpactMaps/GaussSeidelOperator.h"
@@ -34,18 +36,28 @@
 #include "scisim/ConstrainedMaps/ImpactMaps/LCPOperatorQLVP.h"
 #endif
 
+#ifdef USE_HDF5
+#include "scisim/HDF5File.h"
+#endif
+
 #include "rigidbody3d/Geometry/RigidBodyGeometry.h"
 #include "rigidbody3d/Geometry/RigidBodyBox.h"
 #include "rigidbody3d/Geometry/RigidBodySphere.h"
 #include "rigidbody3d/Geometry/RigidBodyStaple.h"
 #include "rigidbody3d/Geometry/RigidBodyTriangleMesh.h"
+#include "rigidbody3d/Geometry/RigidBodyConvexPolyhedron.h"
+#include "rigidbody3d/Geometry/RigidBodyCapsule.h"
+#include "rigidbody3d/Geometry/RigidBodyCompound.h"
+#include "rigidbody3d/Geometry/RigidBodyClump.h"
 #include "rigidbody3d/RigidBody3DState.h"
+#include "rigidbody3d/RigidBody3DScriptingCallback.h"
 #include "rigidbody3d/Forces/NearEarthGravityForce.h"
 #include "rigidbody3d/UnconstrainedMaps/SplitHamMap.h"
 #include "rigidbody3d/UnconstrainedMaps/DMVMap.h"
 #include "rigidbody3d/UnconstrainedMaps/ExponentialEulerMap.h"
 #include "rigidbody3d/StaticGeometry/StaticPlane.h"
 #include "rigidbody3d/StaticGeometry/StaticCylinder.h"
+#include "rigidbody3d/StaticGeometry/StaticTriangleMesh.h"
 #include "rigidbody3d/Portals/PlanarPortal.h"
 
 #include "RenderingState.h"
@@ -99,30 +111,220 @@ static bool loadXMLFile( const std::string& filename, std::vector<char>& xmlchar
   return true;
 }
 
-static bool loadScriptingSetup( const rapidxml::xml_node<>& node, std::string& scripting_callback )
+static bool loadScriptingSetup( const rapidxml::xml_node<>& node, std::string& scripting_callback, RigidBody3DScriptingCallbackType& scripting_callback_type )
 {
   assert( scripting_callback.empty() );
 
+  // Without a scripting node, an empty Python callback that does nothing
+  scripting_callback_type = RigidBody3DScriptingCallbackType::PYTHON;
   const rapidxml::xml_node<>* scripting_node{ node.first_node( "scripting" ) };
   if( !scripting_node )
   {
     return true;
   }
 
+  // Either a Python module or a native plugin, named by its shared library file
   const rapidxml::xml_attribute<>* name_node{ scripting_node->first_attribute( "callback" ) };
-  if( name_node )
+  const rapidxml::xml_attribute<>* plugin_node{ scripting_node->first_attribute( "plugin" ) };
+  if( name_node && !plugin_node )
   {
     scripting_callback = name_node->value();
+    if( RigidBody3DScriptingCallback::isNativePluginName( scripting_callback ) )
+    {
+      std::cerr << "Scripting callback " << scripting_callback << " names a shared library, use the plugin attribute instead." << std::endl;
+      return false;
+    }
+  }
+  else if( plugin_node && !name_node )
+  {
+    scripting_callback = plugin_node->value();
+    scripting_callback_type = RigidBody3DScriptingCallbackType::NATIVE_PLUGIN;
+    if( !RigidBody3DScriptingCallback::isNativePluginName( scripting_callback ) )
+    {
+      std::cerr << "Scripting plugin " << scripting_callback << " must name a shared library ending in .so or .dylib." << std::endl;
+      return false;
+    }
   }
   else
   {
+    std::cerr << "Scripting node requires exactly one of the callback and plugin attributes." << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+static bool loadCapsuleRadiusAndHalfLength( const rapidxml::xml_node<>& node, scalar& r, scalar& h )
+{
+  {
+    const rapidxml::xml_attribute<>* const attrib{ node.first_attribute( "r" ) };
+    if( !attrib )
+    {
+      std::cerr << "Failed to locate r attribute for capsule geometry" << std::endl;
+      return false;
+    }
+    const bool parsed{ StringUtilities::extractFromString( attrib->value(), r ) };
+    if( !parsed || r <= 0.0 )
+    {
+      std::cerr << "Failed to parse r attribute for capsule geometry, must provide a positive scalar." << std::endl;
+      return false;
+    }
+  }
+  {
+    const rapidxml::xml_attribute<>* const attrib{ node.first_attribute( "h" ) };
+    if( !attrib )
+    {
+      std::cerr << "Failed to locate h attribute for capsule geometry" << std::endl;
+      return false;
+    }
+    const bool parsed{ StringUtilities::extractFromString( attrib->value(), h ) };
+    if( !parsed || h <= 0.0 )
+    {
+      std::cerr << "Failed to parse h attribute for capsule geometry, must provide a positive scalar." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Children of compound geometry: sphere, capsule, and box nodes with the geometry's parameters, an optional
+// position x, and an optional orientation R given as a rotation vector
+static bool loadCompoundChildren( const rapidxml::xml_node<>& node, std::vector<std::unique_ptr<RigidBodyGeometry>>& children, Matrix3Xsc& positions, std::vector<Matrix33sr>& orientations )
+{
+  std::vector<Vector3s> child_positions;
+  for( rapidxml::xml_node<>* nd = node.first_node(); nd; nd = nd->next_sibling() )
+  {
+    const std::string child_type{ nd->name() };
+    if( child_type == "sphere" )
+    {
+      const rapidxml::xml_attribute<>* const attrib{ nd->first_attribute( "r" ) };
+      scalar r;
+      if( !attrib || !StringUtilities::extractFromString( attrib->value(), r ) || r <= 0.0 )
+      {
+        std::cerr << "Failed to parse r attribute for compound sphere, must provide a positive scalar." << std::endl;
+        return false;
+      }
+      children.emplace_back( new RigidBodySphere{ r } );
+    }
+    else if( child_type == "capsule" )
+    {
+      scalar r;
+      scalar h;
+      if( !loadCapsuleRadiusAndHalfLength( *nd, r, h ) )
+      {
+        return false;
+      }
+      children.emplace_back( new RigidBodyCapsule{ r, h } );
+    }
+    else if( child_type == "box" )
+    {
+      const rapidxml::xml_attribute<>* const attrib{ nd->first_attribute( "r" ) };
+      VectorXs r;
+      if( !attrib || !StringUtilities::readScalarList( attrib->value(), 3, ' ', r ) || ( r.array() <= 0.0 ).any() )
+      {
+        std::cerr << "Failed to load r attribute for compound box, must provide 3 positive scalars" << std::endl;
+        return false;
+      }
+      children.emplace_back( new RigidBodyBox{ r } );
+    }
+    else
+    {
+      std::cerr << "Invalid compound child type: " << child_type << ", must be sphere, capsule, or box" << std::endl;
+      return false;
+    }
+
+    Vector3s x{ Vector3s::Zero() };
+    {
+      const rapidxml::xml_attribute<>* const attrib{ nd->first_attribute( "x" ) };
+      if( attrib )
+      {
+        VectorXs position;
+        if( !StringUtilities::readScalarList( attrib->value(), 3, ' ', position ) )
+        {
+          std::cerr << "Failed to load x attribute for compound child, must provide 3 scalars" << std::endl;
+          return false;
+        }
+        x = position;
+      }
+    }
+    child_positions.emplace_back( x );
+
+    Matrix33sr R{ Matrix33sr::Identity() };
+    {
+      const rapidxml::xml_attribute<>* const attrib{ nd->first_attribute( "R" ) };
+      if( attrib )
+      {
+        VectorXs rotation_vector;
+        if( !StringUtilities::readScalarList( attrib->value(), 3, ' ', rotation_vector ) )
+        {
+          std::cerr << "Failed to load R attribute for compound child, must provide 3 scalars" << std::endl;
+          return false;
+        }
+        if( rotation_vector.norm() != 0.0 )
+        {
+          R = Eigen::AngleAxis<scalar>( rotation_vector.norm(), rotation_vector.normalized() ).matrix();
+        }
+      }
+    }
+    orientations.emplace_back( R );
+  }
+  if( children.empty() )
+  {
+    std::cerr << "Compound geometry must have at least one child" << std::endl;
     return false;
   }
+  positions.resize( 3, child_positions.size() );
+  for( std::vector<Vector3s>::size_type child_idx = 0; child_idx < child_positions.size(); ++child_idx )
+  {
+    positions.col( child_idx ) = child_positions[child_idx];
+  }
+  return true;
+}
 
+// Spheres of clump geometry: sphere nodes with a radius r and a center x
+static bool loadClumpSpheres( const rapidxml::xml_node<>& node, Matrix3Xsc& centers, VectorXs& radii )
+{
+  std::vector<Vector3s> sphere_centers;
+  std::vector<scalar> sphere_radii;
+  for( rapidxml::xml_node<>* nd = node.first_node( "sphere" ); nd; nd = nd->next_sibling( "sphere" ) )
+  {
+    {
+      const rapidxml::xml_attribute<>* const attrib{ nd->first_attribute( "r" ) };
+      scalar r;
+      if( !attrib || !StringUtilities::extractFromString( attrib->value(), r ) || r <= 0.0 )
+      {
+        std::cerr << "Failed to parse r attribute for clump sphere, must provide a positive scalar." << std::endl;
+        return false;
+      }
+      sphere_radii.emplace_back( r );
+    }
+    {
+      const rapidxml::xml_attribute<>* const attrib{ nd->first_attribute( "x" ) };
+      VectorXs x;
+      if( !attrib || !StringUtilities::readScalarList( attrib->value(), 3, ' ', x ) )
+      {
+        std::cerr << "Failed to load x attribute for clump sphere, must provide 3 scalars" << std::endl;
+        return false;
+      }
+      sphere_centers.emplace_back( x );
+    }
+  }
+  if( sphere_radii.empty() )
+  {
+    std::cerr << "Clump geometry must have at least one sphere" << std::endl;
+    return false;
+  }
+  centers.resize( 3, sphere_centers.size() );
+  radii.resize( sphere_radii.size() );
+  for( std::vector<Vector3s>::size_type sphere_idx = 0; sphere_idx < sphere_centers.size(); ++sphere_idx )
+  {
+    centers.col( sphere_idx ) = sphere_centers[sphere_idx];
+    radii( sphere_idx ) = sphere_radii[sphere_idx];
+  }
   return true;
 }
 
-static bool loadSimState( const rapidxml::xml_node<>& node, RigidBody3DState& sim_state )
+static bool loadSimState( const rapidxml::xml_node<>& node, RigidBody3DState& sim_state, std::vector<std::string>& referenced_files )
 {
   std::vector<std::unique_ptr<RigidBodyGeometry>> geometry;
   for( rapidxml::xml_node<>* nd = node.first_node( "geometry" ); nd; nd = nd->next_sibling( "geometry" ) )
@@ -242,6 +444,38 @@ static bool loadSimState( const rapidxml::xml_node<>& node, RigidBody3DState& si
       }
       geometry.emplace_back( std::unique_ptr<RigidBodyGeometry>{ new RigidBodyStaple{ w, l, D } } );
     }
+    else if( geom_type == "capsule" )
+    {
+      // Parse the radius r and the half length h of the axis along x
+      scalar r;
+      scalar h;
+      if( !loadCapsuleRadiusAndHalfLength( *nd, r, h ) )
+      {
+        return false;
+      }
+      geometry.emplace_back( new RigidBodyCapsule{ r, h } );
+    }
+    else if( geom_type == "compound" )
+    {
+      std::vector<std::unique_ptr<RigidBodyGeometry>> children;
+      Matrix3Xsc positions;
+      std::vector<Matrix33sr> orientations;
+      if( !loadCompoundChildren( *nd, children, positions, orientations ) )
+      {
+        return false;
+      }
+      geometry.emplace_back( new RigidBodyCompound{ std::move( children ), positions, orientations } );
+    }
+    else if( geom_type == "clump" )
+    {
+      Matrix3Xsc centers;
+      VectorXs radii;
+      if( !loadClumpSpheres( *nd, centers, radii ) )
+      {
+        return false;
+      }
+      geometry.emplace_back( new RigidBodyClump{ centers, radii } );
+    }
     else if( geom_type == "mesh" )
     {
       // Read the name of the obj file with the mesh
@@ -254,6 +488,7 @@ static bool loadSimState( const rapidxml::xml_node<>& node, RigidBody3DState& si
         }
         mesh_file_name = attrib->value();
       }
+      referenced_files.emplace_back( mesh_file_name );
       try
       {
         geometry.emplace_back( new RigidBodyTriangleMesh{ mesh_file_name } );
@@ -264,6 +499,46 @@ static bool loadSimState( const rapidxml::xml_node<>& node, RigidBody3DState& si
         return false;
       }
     }
+    else if( geom_type == "convex" )
+    {
+      // Read the name of the file with the polyhedron's hull, stored in the same format as triangle meshes
+      std::string hull_file_name;
+      {
+        const rapidxml::xml_attribute<>* const attrib{ nd->first_attribute( "filename" ) };
+        if( !attrib )
+        {
+          std::cerr << "Failed to locate the filename attribute for convex geometry" << std::endl;
+          return false;
+        }
+        hull_file_name = attrib->value();
+      }
+      referenced_files.emplace_back( hull_file_name );
+      #ifdef USE_HDF5
+      Matrix3Xsc vertices;
+      Matrix3Xuc faces;
+      try
+      {
+        const HDF5File hull_file{ hull_file_name, HDF5AccessType::READ_ONLY };
+        vertices = hull_file.read<Matrix3Xsc>( "mesh/vertices" );
+        faces = hull_file.read<Matrix3Xuc>( "mesh/faces" );
+      }
+      catch( const std::string& error )
+      {
+        std::cerr << "Failed to load convex polyhedron " << hull_file_name << ": " << error << std::endl;
+        return false;
+      }
+      const std::string hull_error{ RigidBodyConvexPolyhedron::validateHull( vertices, faces ) };
+      if( !hull_error.empty() )
+      {
+        std::cerr << "Failed to load convex polyhedron " << hull_file_name << ": " << hull_error << std::endl;
+        return false;
+      }
+      geometry.emplace_back( new RigidBodyConvexPolyhedron{ vertices, faces } );
+      #else
+      std::cerr << "Error, loading convex polyhedra requires HDF5 support. Please recompile with USE_HDF5=ON." << std::endl;
+      return false;
+      #endif
+    }
     else
     {
       std::cerr << "Invalid geometry type: " << geom_type << std::endl;
@@ -279,6 +554,7 @@ static bool loadSimState( const rapidxml::xml_node<>& node, RigidBody3DState& si
   std::vector<Vector3s> I0s;
   std::vector<bool> fixeds;
   std::vector<unsigned> geometry_indices;
+  std::vector<unsigned> materials;
 
   for( rapidxml::xml_node<>* nd = node.first_node( "rigid_body_with_density" ); nd; nd = nd->next_sibling( "rigid_body_with_density" ) )
   {
@@ -395,6 +671,17 @@ static bool loadSimState( const rapidxml::xml_node<>& node, RigidBody3DState& si
       }
     }
     fixeds.push_back( fixed );
+    // Load an optional material, defaulting to material 0
+    unsigned material{ 0 };
+    {
+      const rapidxml::xml_attribute<>* const attrib{ nd->first_attribute( "material" ) };
+      if( attrib != nullptr && ( !StringUtilities::extractFromString( attrib->value(), material ) || material >= MaterialTable::MAX_MATERIALS ) )
+      {
+        std::cerr << "Failed to load material attribute for rigid_body_with_density, must provide a non-negative integer less than " << MaterialTable::MAX_MATERIALS << std::endl;
+        return false;
+      }
+    }
+    materials.push_back( material );
     // Load the index of this body's geometry
     int geometry_index;
     {
@@ -461,7 +748,72 @@ static bool loadSimState( const rapidxml::xml_node<>& node, RigidBody3DState& si
   }
 
   // TODO: Replace with a swap?
-  sim_state.setState( xs, vs, Ms, Rs, omegas, I0s, fixeds, geometry_indices, geometry );
+  sim_state.setState( xs, vs, Ms, Rs, omegas, I0s, fixeds, geometry_indices, std::move( geometry ) );
+  for( std::vector<unsigned>::size_type bdy_idx = 0; bdy_idx < materials.size(); ++bdy_idx )
+  {
+    sim_state.materials().setMaterial( unsigned( bdy_idx ), materials[bdy_idx] );
+  }
+
+  return true;
+}
+
+static bool loadMaterialPairs( const rapidxml::xml_node<>& node, MaterialTable& materials )
+{
+  for( rapidxml::xml_node<>* nd = node.first_node( "material_pair" ); nd; nd = nd->next_sibling( "material_pair" ) )
+  {
+    unsigned material0;
+    {
+      const rapidxml::xml_attribute<>* const attrib{ nd->first_attribute( "material0" ) };
+      if( !attrib )
+      {
+        std::cerr << "Failed to locate material0 attribute for material_pair." << std::endl;
+        return false;
+      }
+      if( !StringUtilities::extractFromString( attrib->value(), material0 ) || material0 >= MaterialTable::MAX_MATERIALS )
+      {
+        std::cerr << "Failed to load material0 attribute for material_pair. Value must be a non-negative integer less than " << MaterialTable::MAX_MATERIALS << "." << std::endl;
+        return false;
+      }
+    }
+
+    unsigned material1;
+    {
+      const rapidxml::xml_attribute<>* const attrib{ nd->first_attribute( "material1" ) };
+      if( !attrib )
+      {
+        std::cerr << "Failed to locate material1 attribute for material_pair." << std::endl;
+        return false;
+      }
+      if( !StringUtilities::extractFromString( attrib->value(), material1 ) || material1 >= MaterialTable::MAX_MATERIALS )
+      {
+        std::cerr << "Failed to load material1 attribute for material_pair. Value must be a non-negative integer less than " << MaterialTable::MAX_MATERIALS << "." << std::endl;
+        return false;
+      }
+    }
+
+    // Either coefficient may be omitted, in which case the scene wide coefficient is used for the pair
+    scalar CoR{ SCALAR_NAN };
+    {
+      const rapidxml::xml_attribute<>* const attrib{ nd->first_attribute( "CoR" ) };
+      if( attrib != nullptr && ( !StringUtilities::extractFromString( attrib->value(), CoR ) || CoR < 0.0 || CoR > 1.0 ) )
+      {
+        std::cerr << "Failed to load CoR attribute for material_pair. Value must be a scalar between 0 and 1." << std::endl;
+        return false;
+      }
+    }
+
+    scalar mu{ SCALAR_NAN };
+    {
+      const rapidxml::xml_attribute<>* const attrib{ nd->first_attribute( "mu" ) };
+      if( attrib != nullptr && ( !StringUtilities::extractFromString( attrib->value(), mu ) || mu < 0.0 ) )
+      {
+        std::cerr << "Failed to load mu attribute for material_pair. Value must be a non-negative scalar." << std::endl;
+        return false;
+      }
+    }
+
+    materials.setPairCoefficients( material0, material1, CoR, mu );
+  }
 
   return true;
 }
@@ -779,6 +1131,79 @@ static bool loadStaticCylinders( const rapidxml::xml_node<>& node, RigidBody3DSt
   return true;
 }
 
+static bool loadStaticMeshes( const rapidxml::xml_node<>& node, RigidBody3DState& sim, std::vector<std::string>& referenced_files )
+{
+  for( rapidxml::xml_node<>* nd = node.first_node( "static_mesh" ); nd; nd = nd->next_sibling( "static_mesh" ) )
+  {
+    // Read the name of the file with the mesh
+    std::string mesh_file_name;
+    {
+      const rapidxml::xml_attribute<>* const attrib{ nd->first_attribute( "filename" ) };
+      if( !attrib )
+      {
+        std::cerr << "Failed to locate filename attribute for static_mesh." << std::endl;
+        return false;
+      }
+      mesh_file_name = attrib->value();
+    }
+    referenced_files.emplace_back( mesh_file_name );
+    // Read the depth behind each face that is still treated as colliding with it
+    scalar thickness;
+    {
+      const rapidxml::xml_attribute<>* const attrib{ nd->first_attribute( "thickness" ) };
+      if( !attrib )
+      {
+        std::cerr << "Failed to locate thickness attribute for static_mesh." << std::endl;
+        return false;
+      }
+      if( !StringUtilities::extractFromString( attrib->value(), thickness ) || thickness <= 0.0 )
+      {
+        std::cerr << "Failed to load thickness attribute for static_mesh. Must provide a positive scalar." << std::endl;
+        return false;
+      }
+    }
+    // Read the optional translation of the mesh
+    VectorXs x{ VectorXs::Zero( 3 ) };
+    {
+      const rapidxml::xml_attribute<>* const attrib{ nd->first_attribute( "x" ) };
+      if( attrib && !StringUtilities::readScalarList( attrib->value(), 3, ' ', x ) )
+      {
+        std::cerr << "Failed to load x attribute for static_mesh, must provide 3 scalars." << std::endl;
+        return false;
+      }
+      assert( x.size() == 3 );
+    }
+    // Load the mesh, stored in the same format as rigid body meshes
+    #ifdef USE_HDF5
+    Matrix3Xsc vertices;
+    Matrix3Xuc faces;
+    try
+    {
+      const HDF5File mesh_file{ mesh_file_name, HDF5AccessType::READ_ONLY };
+      vertices = mesh_file.read<Matrix3Xsc>( "mesh/vertices" );
+      faces = mesh_file.read<Matrix3Xuc>( "mesh/faces" );
+    }
+    catch( const std::string& error )
+    {
+      std::cerr << "Failed to load static mesh " << mesh_file_name << ": " << error << std::endl;
+      return false;
+    }
+    if( faces.cols() == 0 || !( faces.array() < unsigned( vertices.cols() ) ).all() )
+    {
+      std::cerr << "Failed to load static mesh " << mesh_file_name << ", faces must index existing vertices." << std::endl;
+      return false;
+    }
+    vertices.colwise() += Eigen::Map<const Vector3s>{ x.data() };
+    sim.addStaticMesh( StaticTriangleMesh{ vertices, faces, thickness } );
+    #else
+    std::cerr << "Error, loading static meshes requires HDF5 support. Please recompile with USE_HDF5=ON." << std::endl;
+    return false;
+    #endif
+  }
+
+  return true;
+}
+
 static bool loadStaticPlaneRenderers( const rapidxml::xml_node<>& node, const std::vector<StaticPlane>& planes, RenderingState& rendering_state )
 {
   for( rapidxml::xml_node<>* nd = node.first_node( "static_plane_renderer" ); nd; nd = nd->next_sibling( "static_plane_renderer" ) )
@@ -1190,6 +1615,13 @@ static bool loadUnconstrainedMap( const rapidxml::xml_node<>& node, std::unique_
     }
   }
 
+  // Collision detection does not sweep over intermediate substeps of rigid bodies, so substepping is not supported
+  if( nd->first_attribute( "substeps" ) != nullptr )
+  {
+    std::cerr << "Integrator substeps are not supported for rigid bodies, remove the substeps attribute from the integrator node." << std::endl;
+    return false;
+  }
+
   return true;
 }
 
@@ -2034,10 +2466,70 @@ static bool loadEndTime( const rapidxml::xml_node<>& node, scalar& end_time )
   return true;
 }
 
+static bool loadSleeping( const rapidxml::xml_node<>& node, SleepingIslands& sleeping_islands )
+{
+  scalar linear_velocity;
+  {
+    const rapidxml::xml_attribute<>* attrib{ node.first_attribute( "linear_velocity" ) };
+    if( !attrib )
+    {
+      std::cerr << "Failed to locate linear_velocity attribute for sleeping." << std::endl;
+      return false;
+    }
+    if( !StringUtilities::extractFromString( attrib->value(), linear_velocity ) || linear_velocity < 0.0 )
+    {
+      std::cerr << "Failed to load linear_velocity attribute for sleeping. Value must be a non-negative scalar." << std::endl;
+      return false;
+    }
+  }
+
+  scalar kinetic_energy;
+  {
+    const rapidxml::xml_attribute<>* attrib{ node.first_attribute( "kinetic_energy" ) };
+    if( !attrib )
+    {
+      std::cerr << "Failed to locate kinetic_energy attribute for sleeping." << std::endl;
+      return false;
+    }
+    if( !StringUtilities::extractFromString( attrib->value(), kinetic_energy ) || kinetic_energy < 0.0 )
+    {
+      std::cerr << "Failed to load kinetic_energy attribute for sleeping. Value must be a non-negative scalar." << std::endl;
+      return false;
+    }
+  }
+
+  scalar time_to_sleep;
+  {
+    const rapidxml::xml_attribute<>* attrib{ node.first_attribute( "time_to_sleep" ) };
+    if( !attrib )
+    {
+      std::cerr << "Failed to locate time_to_sleep attribute for sleeping." << std::endl;
+      return false;
+    }
+    if( !StringUtilities::extractFromString( attrib->value(), time_to_sleep ) || time_to_sleep <= 0.0 )
+    {
+      std::cerr << "Failed to load time_to_sleep attribute for sleeping. Value must be a positive scalar." << std::endl;
+      return false;
+    }
+  }
+
+  sleeping_islands = SleepingIslands{ linear_velocity, kinetic_energy, time_to_sleep };
+
+  return true;
+}
+
 // TODO: Do some kind of boost-optional thing to grab const refs to nodes, but not have to do first_node twice
 
-bool RigidBody3DSceneParser::parseXMLSceneFile( const std::string& file_name, std::string& scripting_callback, RigidBody3DState& sim_state, std::unique_ptr<UnconstrainedMap>& unconstrained_map, std::string& dt_string, Rational<std::intmax_t>& dt, scalar& end_time, std::unique_ptr<ImpactOperator>& impact_operator, scalar& CoR, std::unique_ptr<FrictionSolver>& friction_solver, scalar& mu, std::unique_ptr<ImpactFrictionMap>& if_map, RenderingState& rendering_state )
+bool RigidBody3DSceneParser::parseXMLSceneFile( const std::string& file_name, std::string& scripting_callback, RigidBody3DScriptingCallbackType& scripting_callback_type, RigidBody3DState& sim_state, std::unique_ptr<UnconstrainedMap>& unconstrained_map, std::string& dt_string, Rational<std::intmax_t>& dt, scalar& end_time, std::unique_ptr<ImpactOperator>& impact_operator, scalar& CoR, std::unique_ptr<FrictionSolver>& friction_solver, scalar& mu, std::unique_ptr<ImpactFrictionMap>& if_map, RenderingState& rendering_state )
 {
+  std::vector<std::string> referenced_files;
+  return parseXMLSceneFile( file_name, scripting_callback, scripting_callback_type, sim_state, unconstrained_map, dt_string, dt, end_time, impact_operator, CoR, friction_solver, mu, if_map, rendering_state, referenced_files );
+}
+
+bool RigidBody3DSceneParser::parseXMLSceneFile( const std::string& file_name, std::string& scripting_callback, RigidBody3DScriptingCallbackType& scripting_callback_type, RigidBody3DState& sim_state, std::unique_ptr<UnconstrainedMap>& unconstrained_map, std::string& dt_string, Rational<std::intmax_t>& dt, scalar& end_time, std::unique_ptr<ImpactOperator>& impact_operator, scalar& CoR, std::unique_ptr<FrictionSolver>& friction_solver, scalar& mu, std::unique_ptr<ImpactFrictionMap>& if_map, RenderingState& rendering_state, std::vector<std::string>& referenced_files )
+{
+  referenced_files.clear();
+
   // Attempt to load the xml document
   std::vector<char> xmlchars;
   rapidxml::xml_document<> doc;
@@ -2055,7 +2547,7 @@ bool RigidBody3DSceneParser::parseXMLSceneFile( const std::string& file_name, st
   const rapidxml::xml_node<>& root_node{ *doc.first_node( "rigidbody3d_scene" ) };
 
   // Attempt to determine if scirpting is enabled and if so, the coresponding callback
-  if( !loadScriptingSetup( root_node, scripting_callback ) )
+  if( !loadScriptingSetup( root_node, scripting_callback, scripting_callback_type ) )
   {
     std::cerr << "Failed to parse scripting node in xml scene file: " << file_name << std::endl;
     return false;
@@ -2072,6 +2564,16 @@ bool RigidBody3DSceneParser::parseXMLSceneFile( const std::string& file_name, st
     }
   }
 
+  // Attempt to load sleeping settings, if present
+  if( root_node.first_node( "sleeping" ) != nullptr )
+  {
+    if( !loadSleeping( *root_node.first_node( "sleeping" ), sim_state.sleepingIslands() ) )
+    {
+      std::cerr << "Failed to parse sleeping node: " << file_name << std::endl;
+      return false;
+    }
+  }
+
   // Attempt to load forces
   if( !loadNearEarthGravityForce( root_node, sim_state ) )
   {
@@ -2199,6 +2701,13 @@ bool RigidBody3DSceneParser::parseXMLSceneFile( const std::string& file_name, st
     return false;
   }
 
+  // Attempt to load static meshes
+  if( !loadStaticMeshes( root_node, sim_state, referenced_files ) )
+  {
+    std::cerr << "Failed to load static_mesh in xml scene file: " << file_name << std::endl;
+    return false;
+  }
+
   // Attempt to load static plane renderers
   if( !loadStaticPlaneRenderers( root_node, sim_state.staticPlanes(), rendering_state ) )
   {
@@ -2221,11 +2730,18 @@ bool RigidBody3DSceneParser::parseXMLSceneFile( const std::string& file_name, st
   }
 
   // Attempt to load all rigid bodies
-  if( !loadSimState( root_node, sim_state ) )
+  if( !loadSimState( root_node, sim_state, referenced_files ) )
   {
     std::cerr << "Failed to load rigid bodies in xml scene file: " << file_name << std::endl;
     return false;
   }
 
+  // Attempt to load per material coefficients
+  if( !loadMaterialPairs( root_node, sim_state.materials() ) )
+  {
+    std::cerr << "Failed to load material_pair in xml scene file: " << file_name << std::endl;
+    return false;
+  }
+
   return true;
 }
@@ -7,8 +7,11 @@
 #define RIGID_BODY_3D_SCENE_PARSER_H
 
 #include "scisim/Math/MathDefines.h"
+#include <cstdint>
 #include <iosfwd>
 #include <memory>
+#include <string>
+#include <vector>
 
 class RigidBody3DState;
 class UnconstrainedMap;
@@ -16,12 +19,16 @@ class ImpactOperator;
 class FrictionSolver;
 class ImpactFrictionMap;
 class RenderingState;
+enum class RigidBody3DScriptingCallbackType : std::uint8_t;
 template<typename T> class Rational;
 
 namespace RigidBody3DSceneParser
 {
 
-  bool parseXMLSceneFile( const std::string& file_name, std::string& scripting_callback, RigidBody3DState& sim_state, std::unique_ptr<UnconstrainedMap>& unconstrained_map, std::string& dt_string, Rational<std::intmax_t>& dt, scalar& end_time, std::unique_ptr<ImpactOperator>& impact_operator, scalar& CoR, std::unique_ptr<FrictionSolver>& friction_solver, scalar& mu, std::unique_ptr<ImpactFrictionMap>& if_map, RenderingState& rendering_state );
+  bool parseXMLSceneFile( const std::string& file_name, std::string& scripting_callback, RigidBody3DScriptingCallbackType& scripting_callback_type, RigidBody3DState& sim_state, std::unique_ptr<UnconstrainedMap>& unconstrained_map, std::string& dt_string, Rational<std::intmax_t>& dt, scalar& end_time, std::unique_ptr<ImpactOperator>& impact_operator, scalar& CoR, std::unique_ptr<FrictionSolver>& friction_solver, scalar& mu, std::unique_ptr<ImpactFrictionMap>& if_map, RenderingState& rendering_state );
+
+  // As above, also listing the files other than the xml that the scene reads, such as meshes and hulls
+  bool parseXMLSceneFile( const std::string& file_name, std::string& scripting_callback, RigidBody3DScriptingCallbackType& scripting_callback_type, RigidBody3DState& sim_state, std::unique_ptr<UnconstrainedMap>& unconstrained_map, std::string& dt_string, Rational<std::intmax_t>& dt, scalar& end_time, std::unique_ptr<ImpactOperator>& impact_operator, scalar& CoR, std::unique_ptr<FrictionSolver>& friction_solver, scalar& mu, std::unique_ptr<ImpactFrictionMap>& if_map, RenderingState& rendering_state, std::vector<std::string>& referenced_files );
 
 }
 
@@ -0,0 +1,102 @@
+// AsyncFileWriter.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "AsyncFileWriter.h"
+
+#include <cassert>
+#include <fstream>
+
+AsyncFileWriter::AsyncFileWriter( const unsigned max_pending_files )
+: m_mutex()
+, m_file_written()
+, m_file_queued()
+, m_file_names( max_pending_files )
+, m_contents( max_pending_files )
+, m_first_pending( 0 )
+, m_num_pending( 0 )
+, m_stop( false )
+, m_error()
+, m_writer_thread( &AsyncFileWriter::writePendingFiles, this )
+{
+  assert( max_pending_files > 0 );
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_stop = true;
+  }
+  m_file_queued.notify_one();
+  m_writer_thread.join();
+}
+
+bool AsyncFileWriter::write( const std::string& file_name, std::vector<char>& contents )
+{
+  std::unique_lock<std::mutex> lock{ m_mutex };
+  // Apply back pressure when the writer thread falls behind
+  m_file_written.wait( lock, [this]{ return m_num_pending < m_contents.size() || !m_error.empty(); } );
+  if( !m_error.empty() )
+  {
+    return false;
+  }
+  const unsigned slot{ unsigned( ( m_first_pending + m_num_pending ) % m_contents.size() ) };
+  m_file_names[slot] = file_name;
+  using std::swap;
+  swap( m_contents[slot], contents );
+  ++m_num_pending;
+  lock.unlock();
+  m_file_queued.notify_one();
+  return true;
+}
+
+bool AsyncFileWriter::flush()
+{
+  std::unique_lock<std::mutex> lock{ m_mutex };
+  m_file_written.wait( lock, [this]{ return m_num_pending == 0; } );
+  return m_error.empty();
+}
+
+std::string AsyncFileWriter::error()
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  return m_error;
+}
+
+void AsyncFileWriter::writePendingFiles()
+{
+  std::unique_lock<std::mutex> lock{ m_mutex };
+  while( true )
+  {
+    m_file_queued.wait( lock, [this]{ return m_num_pending != 0 || m_stop; } );
+    // Pending files are written even when stopping
+    if( m_num_pending == 0 )
+    {
+      return;
+    }
+
+    // The front slot is not touched by callers until it leaves the pending range, so write it unlocked
+    const unsigned slot{ m_first_pending };
+    lock.unlock();
+    bool succeeded{ false };
+    {
+      std::ofstream output_stream{ m_file_names[slot], std::ios::binary };
+      if( output_stream.is_open() )
+      {
+        output_stream.write( m_contents[slot].data(), std::streamsize( m_contents[slot].size() ) );
+        succeeded = bool( output_stream );
+      }
+    }
+    lock.lock();
+
+    if( !succeeded && m_error.empty() )
+    {
+      m_error = "Failed to write file: " + m_file_names[slot];
+    }
+    m_first_pending = unsigned( ( m_first_pending + 1 ) % m_contents.size() );
+    --m_num_pending;
+    m_file_written.notify_all();
+  }
+}
@@ -0,0 +1,64 @@
+// AsyncFileWriter.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Writes files on a background thread so the simulation does not wait on the file system. Pending files
+// are held in a fixed size ring of buffers; callers block when the ring is full. Buffers are swapped
+// rather than copied, so after warm up each buffer's storage is reused for later files.
+
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class AsyncFileWriter final
+{
+
+public:
+
+  explicit AsyncFileWriter( const unsigned max_pending_files );
+  // Writes all pending files before returning
+  ~AsyncFileWriter();
+  AsyncFileWriter( const AsyncFileWriter& ) = delete;
+  AsyncFileWriter& operator=( const AsyncFileWriter& ) = delete;
+
+  // Queues contents to be written to file_name, blocking while the ring is full. On return contents holds
+  // the storage of a previously written file. Returns false if an earlier write failed.
+  bool write( const std::string& file_name, std::vector<char>& contents );
+
+  // Blocks until all pending files are written. Returns false if any write failed.
+  bool flush();
+
+  // Description of the first failed write, if any
+  std::string error();
+
+private:
+
+  void writePendingFiles();
+
+  std::mutex m_mutex;
+  // Signaled when the writer thread finishes a file or stops
+  std::condition_variable m_file_written;
+  // Signaled when a file is queued or the writer thread should stop
+  std::condition_variable m_file_queued;
+
+  // Ring of pending files; slots outside the pending range hold spare storage
+  std::vector<std::string> m_file_names;
+  std::vector<std::vector<char>> m_contents;
+  unsigned m_first_pending;
+  unsigned m_num_pending;
+
+  bool m_stop;
+  std::string m_error;
+
+  // Started last, once the ring is initialized
+  std::thread m_writer_thread;
+
+};
+
+#endif
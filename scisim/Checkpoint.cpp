@@ -0,0 +1,478 @@
+// Checkpoint.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "Checkpoint.h"
+
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static constexpr char CHECKPOINT_MAGIC[8]{ 'S', 'C', 'I', 'S', 'I', 'M', 'C', 'K' };
+// Version of the container layout, independent of the schema of the contents
+static constexpr std::uint32_t CHECKPOINT_FORMAT_VERSION{ 1 };
+// Sections start on cache line boundaries so mapped arrays are aligned for vectorized copies
+static constexpr std::uint64_t CHECKPOINT_ALIGNMENT{ 64 };
+// Section of a delta checkpoint holding the file name of its anchor
+static const std::string ANCHOR_SECTION{ "checkpoint/anchor" };
+
+namespace
+{
+  struct CheckpointHeader final
+  {
+    char magic[8];
+    std::uint32_t format_version;
+    std::uint32_t schema_version;
+    char kind[32];
+    std::uint64_t num_sections;
+    std::uint64_t table_offset;
+  };
+  static_assert( sizeof( CheckpointHeader ) % 8 == 0, "Error, checkpoint header must be padded to 8 bytes" );
+}
+
+constexpr std::uint32_t CheckpointReader::INHERITED_SECTION;
+
+static std::uint64_t alignUp( const std::uint64_t offset )
+{
+  return ( ( offset + CHECKPOINT_ALIGNMENT - 1 ) / CHECKPOINT_ALIGNMENT ) * CHECKPOINT_ALIGNMENT;
+}
+
+CheckpointWriter::CheckpointWriter( const std::string& kind, const std::uint32_t schema_version )
+: m_kind( kind )
+, m_schema_version( schema_version )
+, m_sections()
+, m_is_delta( false )
+{
+  assert( m_kind.size() < sizeof( CheckpointHeader::kind ) );
+}
+
+CheckpointWriter::CheckpointWriter( const CheckpointReader& checkpoint )
+: m_kind( checkpoint.kind() )
+, m_schema_version( checkpoint.schemaVersion() )
+, m_sections()
+, m_is_delta( false )
+{
+  for( std::uint64_t section_idx = 0; section_idx < checkpoint.m_num_sections; ++section_idx )
+  {
+    const std::string name{ checkpoint.m_table[section_idx].name, strnlen( checkpoint.m_table[section_idx].name, sizeof( CheckpointReader::TableEntry::name ) ) };
+    if( name == ANCHOR_SECTION )
+    {
+      continue;
+    }
+    const char* data;
+    const CheckpointReader::TableEntry& entry{ checkpoint.findSection( name, data ) };
+    addSection( name, nullptr, data, std::size_t( entry.size ), entry.rows, entry.cols, entry.scalar_size );
+  }
+}
+
+void CheckpointWriter::addSection( const std::string& name, std::string contents )
+{
+  const std::shared_ptr<const std::string> owner{ std::make_shared<const std::string>( std::move( contents ) ) };
+  addSection( name, owner, owner->data(), owner->size(), 0, 0, 0 );
+}
+
+void CheckpointWriter::addSection( const std::string& name, std::shared_ptr<const void> owner, const char* data, const std::size_t size, const std::uint64_t rows, const std::uint64_t cols, const std::uint32_t scalar_size )
+{
+  // Names are stored in fixed size table entries and must be null terminated
+  assert( name.size() < 64 );
+  #ifndef NDEBUG
+  for( const Section& section : m_sections )
+  {
+    assert( section.name != name );
+  }
+  #endif
+  // Empty arrays may have a null data pointer
+  m_sections.emplace_back( Section{ name, std::move( owner ), size != 0 ? data : nullptr, size, rows, cols, scalar_size, false } );
+}
+
+void CheckpointWriter::makeDelta( const CheckpointWriter& anchor, const std::string& anchor_file_name )
+{
+  assert( !m_is_delta );
+  assert( !anchor.m_is_delta );
+  assert( anchor.m_kind == m_kind ); assert( anchor.m_schema_version == m_schema_version );
+  // The anchor is located relative to the delta, so only a file name is stored
+  assert( anchor_file_name.find( '/' ) == std::string::npos );
+
+  for( Section& section : m_sections )
+  {
+    for( const Section& anchor_section : anchor.m_sections )
+    {
+      if( anchor_section.name == section.name )
+      {
+        if( anchor_section.rows == section.rows && anchor_section.cols == section.cols && anchor_section.scalar_size == section.scalar_size && anchor_section.size == section.size && ( section.size == 0 || std::memcmp( anchor_section.data, section.data, section.size ) == 0 ) )
+        {
+          section.owner.reset();
+          section.data = nullptr;
+          section.size = 0;
+          section.inherited = true;
+        }
+        break;
+      }
+    }
+  }
+  addSection( ANCHOR_SECTION, anchor_file_name );
+  m_is_delta = true;
+}
+
+bool CheckpointWriter::isDelta() const
+{
+  return m_is_delta;
+}
+
+void CheckpointWriter::copyReferencedContents()
+{
+  for( Section& section : m_sections )
+  {
+    if( section.owner == nullptr && section.size != 0 )
+    {
+      const std::shared_ptr<const std::string> contents{ std::make_shared<const std::string>( section.data, section.size ) };
+      section.data = contents->data();
+      section.owner = contents;
+    }
+  }
+}
+
+std::uint64_t CheckpointWriter::contentBytes() const
+{
+  std::uint64_t content_bytes{ 0 };
+  for( const Section& section : m_sections )
+  {
+    content_bytes += section.size;
+  }
+  return content_bytes;
+}
+
+void CheckpointWriter::addSparseMatrix( const std::string& name, const SparseMatrixsc& A )
+{
+  assert( A.isCompressed() );
+  addArray( name + "/col_ptr", Eigen::Map<const VectorXi>{ A.outerIndexPtr(), A.outerSize() + 1 } );
+  addArray( name + "/row_ind", Eigen::Map<const VectorXi>{ A.innerIndexPtr(), A.nonZeros() } );
+  // The row count cannot be recovered from the compressed arrays, so store it with the values
+  addArray( name + "/val", Eigen::Map<const VectorXs>{ A.valuePtr(), A.nonZeros() } );
+  addArray( name + "/shape", Eigen::Vector2i{ int( A.rows() ), int( A.cols() ) } );
+}
+
+std::vector<std::uint64_t> CheckpointWriter::layout( std::uint64_t& file_size ) const
+{
+  std::vector<std::uint64_t> offsets( m_sections.size() );
+  std::uint64_t offset{ alignUp( sizeof( CheckpointHeader ) ) };
+  for( std::vector<Section>::size_type section_idx = 0; section_idx < m_sections.size(); ++section_idx )
+  {
+    offsets[section_idx] = offset;
+    offset = alignUp( offset + m_sections[section_idx].size );
+  }
+  // The table follows the last section
+  file_size = offset + m_sections.size() * sizeof( CheckpointReader::TableEntry );
+  return offsets;
+}
+
+std::string CheckpointWriter::headerBytes() const
+{
+  CheckpointHeader header;
+  std::memset( &header, 0, sizeof( header ) );
+  std::memcpy( header.magic, CHECKPOINT_MAGIC, sizeof( header.magic ) );
+  header.format_version = CHECKPOINT_FORMAT_VERSION;
+  header.schema_version = m_schema_version;
+  std::memcpy( header.kind, m_kind.data(), m_kind.size() );
+  header.num_sections = m_sections.size();
+  std::uint64_t file_size;
+  layout( file_size );
+  header.table_offset = file_size - m_sections.size() * sizeof( CheckpointReader::TableEntry );
+  return std::string( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+}
+
+std::string CheckpointWriter::tableBytes( const std::vector<std::uint64_t>& offsets ) const
+{
+  assert( offsets.size() == m_sections.size() );
+  std::vector<CheckpointReader::TableEntry> table( m_sections.size() );
+  for( std::vector<Section>::size_type section_idx = 0; section_idx < m_sections.size(); ++section_idx )
+  {
+    CheckpointReader::TableEntry& entry{ table[section_idx] };
+    std::memset( &entry, 0, sizeof( entry ) );
+    std::memcpy( entry.name, m_sections[section_idx].name.data(), m_sections[section_idx].name.size() );
+    entry.offset = m_sections[section_idx].inherited ? 0 : offsets[section_idx];
+    entry.size = m_sections[section_idx].size;
+    entry.rows = m_sections[section_idx].rows;
+    entry.cols = m_sections[section_idx].cols;
+    entry.scalar_size = m_sections[section_idx].scalar_size;
+    entry.flags = m_sections[section_idx].inherited ? CheckpointReader::INHERITED_SECTION : 0;
+  }
+  return std::string( reinterpret_cast<const char*>( table.data() ), table.size() * sizeof( CheckpointReader::TableEntry ) );
+}
+
+bool CheckpointWriter::writeFile( const std::string& file_name ) const
+{
+  std::ofstream output_stream{ file_name, std::ios::binary };
+  if( !output_stream.is_open() )
+  {
+    return false;
+  }
+
+  std::uint64_t file_size;
+  const std::vector<std::uint64_t> offsets{ layout( file_size ) };
+  const std::string padding( CHECKPOINT_ALIGNMENT, '\0' );
+
+  const std::string header{ headerBytes() };
+  output_stream.write( header.data(), std::streamsize( header.size() ) );
+  std::uint64_t position{ header.size() };
+  for( std::vector<Section>::size_type section_idx = 0; section_idx < m_sections.size(); ++section_idx )
+  {
+    assert( offsets[section_idx] >= position ); assert( offsets[section_idx] - position < CHECKPOINT_ALIGNMENT );
+    output_stream.write( padding.data(), std::streamsize( offsets[section_idx] - position ) );
+    if( m_sections[section_idx].size != 0 )
+    {
+      output_stream.write( m_sections[section_idx].data, std::streamsize( m_sections[section_idx].size ) );
+    }
+    position = offsets[section_idx] + m_sections[section_idx].size;
+  }
+  const std::string table{ tableBytes( offsets ) };
+  output_stream.write( padding.data(), std::streamsize( file_size - table.size() - position ) );
+  output_stream.write( table.data(), std::streamsize( table.size() ) );
+
+  return bool( output_stream );
+}
+
+void CheckpointWriter::writeImage( std::vector<char>& image ) const
+{
+  std::uint64_t file_size;
+  const std::vector<std::uint64_t> offsets{ layout( file_size ) };
+  image.assign( file_size, '\0' );
+
+  const std::string header{ headerBytes() };
+  std::memcpy( image.data(), header.data(), header.size() );
+  for( std::vector<Section>::size_type section_idx = 0; section_idx < m_sections.size(); ++section_idx )
+  {
+    if( m_sections[section_idx].size != 0 )
+    {
+      std::memcpy( image.data() + offsets[section_idx], m_sections[section_idx].data, m_sections[section_idx].size );
+    }
+  }
+  const std::string table{ tableBytes( offsets ) };
+  std::memcpy( image.data() + file_size - table.size(), table.data(), table.size() );
+}
+
+CheckpointReader::CheckpointReader( const std::string& file_name )
+: m_data( nullptr )
+, m_size( 0 )
+, m_kind()
+, m_schema_version( 0 )
+, m_table( nullptr )
+, m_num_sections( 0 )
+, m_anchor( nullptr )
+{
+  const int file_descriptor{ open( file_name.c_str(), O_RDONLY ) };
+  if( file_descriptor < 0 )
+  {
+    throw std::string{ "Failed to open checkpoint file: " } + file_name;
+  }
+  struct stat file_status;
+  if( fstat( file_descriptor, &file_status ) != 0 || std::size_t( file_status.st_size ) < sizeof( CheckpointHeader ) )
+  {
+    close( file_descriptor );
+    throw std::string{ "Checkpoint file is truncated: " } + file_name;
+  }
+  m_size = std::size_t( file_status.st_size );
+  void* const mapped_data{ mmap( nullptr, m_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0 ) };
+  // The mapping remains valid after the descriptor is closed
+  close( file_descriptor );
+  if( mapped_data == MAP_FAILED )
+  {
+    m_size = 0;
+    throw std::string{ "Failed to map checkpoint file: " } + file_name;
+  }
+  m_data = static_cast<const char*>( mapped_data );
+
+  // The destructor does not run if construction fails, so release the mapping here
+  try
+  {
+    CheckpointHeader header;
+    std::memcpy( &header, m_data, sizeof( header ) );
+    if( std::memcmp( header.magic, CHECKPOINT_MAGIC, sizeof( header.magic ) ) != 0 )
+    {
+      throw std::string{ "File is not a checkpoint: " } + file_name;
+    }
+    if( header.format_version != CHECKPOINT_FORMAT_VERSION )
+    {
+      throw std::string{ "Unsupported checkpoint format version in: " } + file_name;
+    }
+    if( header.table_offset > m_size || ( m_size - header.table_offset ) / sizeof( TableEntry ) < header.num_sections || header.table_offset % alignof( TableEntry ) != 0 )
+    {
+      throw std::string{ "Checkpoint section table is truncated: " } + file_name;
+    }
+    m_kind = std::string( header.kind, strnlen( header.kind, sizeof( header.kind ) ) );
+    m_schema_version = header.schema_version;
+    m_table = reinterpret_cast<const TableEntry*>( m_data + header.table_offset );
+    m_num_sections = header.num_sections;
+    for( std::uint64_t section_idx = 0; section_idx < m_num_sections; ++section_idx )
+    {
+      if( m_table[section_idx].offset > m_size || m_table[section_idx].size > m_size - m_table[section_idx].offset )
+      {
+        throw std::string{ "Checkpoint section extends past the end of: " } + file_name;
+      }
+    }
+
+    // Open the anchor if any sections are inherited from it
+    bool has_inherited_sections{ false };
+    for( std::uint64_t section_idx = 0; section_idx < m_num_sections; ++section_idx )
+    {
+      has_inherited_sections = has_inherited_sections || ( m_table[section_idx].flags & INHERITED_SECTION ) != 0;
+    }
+    if( has_inherited_sections )
+    {
+      std::size_t anchor_name_size;
+      const char* const anchor_name{ sectionData( ANCHOR_SECTION, anchor_name_size ) };
+      const std::string::size_type directory_end{ file_name.rfind( '/' ) };
+      const std::string directory{ directory_end == std::string::npos ? std::string{} : file_name.substr( 0, directory_end + 1 ) };
+      m_anchor.reset( new CheckpointReader{ directory + std::string( anchor_name, anchor_name_size ) } );
+      if( m_anchor->isDelta() || m_anchor->kind() != m_kind || m_anchor->schemaVersion() != m_schema_version )
+      {
+        throw std::string{ "Checkpoint " } + file_name + std::string{ " does not match its anchor" };
+      }
+    }
+  }
+  catch( ... )
+  {
+    munmap( mapped_data, m_size );
+    throw;
+  }
+}
+
+CheckpointReader::~CheckpointReader()
+{
+  if( m_data != nullptr )
+  {
+    munmap( const_cast<char*>( m_data ), m_size );
+  }
+}
+
+bool CheckpointReader::isCheckpoint( const std::string& file_name )
+{
+  std::ifstream input_stream{ file_name, std::ios::binary };
+  char magic[sizeof( CHECKPOINT_MAGIC )];
+  if( !input_stream.read( magic, sizeof( magic ) ) )
+  {
+    return false;
+  }
+  return std::memcmp( magic, CHECKPOINT_MAGIC, sizeof( magic ) ) == 0;
+}
+
+const std::string& CheckpointReader::kind() const
+{
+  return m_kind;
+}
+
+std::uint32_t CheckpointReader::schemaVersion() const
+{
+  return m_schema_version;
+}
+
+bool CheckpointReader::isDelta() const
+{
+  return m_anchor != nullptr;
+}
+
+bool CheckpointReader::hasSection( const std::string& name ) const
+{
+  for( std::uint64_t section_idx = 0; section_idx < m_num_sections; ++section_idx )
+  {
+    if( std::strncmp( m_table[section_idx].name, name.c_str(), sizeof( TableEntry::name ) ) == 0 )
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+const char* CheckpointReader::sectionData( const std::string& name, std::size_t& size ) const
+{
+  const char* data;
+  const TableEntry& entry{ findSection( name, data ) };
+  size = std::size_t( entry.size );
+  return data;
+}
+
+void CheckpointReader::readSparseMatrix( const std::string& name, SparseMatrixsc& A ) const
+{
+  const Eigen::Vector2i shape{ readArray<Eigen::Vector2i>( name + "/shape" ) };
+  const VectorXi col_ptr{ readArray<VectorXi>( name + "/col_ptr" ) };
+  const VectorXi row_ind{ readArray<VectorXi>( name + "/row_ind" ) };
+  const VectorXs val{ readArray<VectorXs>( name + "/val" ) };
+  if( shape.x() < 0 || shape.y() < 0 || col_ptr.size() != shape.y() + 1 || row_ind.size() != val.size() || col_ptr( 0 ) != 0 || col_ptr( shape.y() ) != val.size() )
+  {
+    throw std::string{ "Inconsistent sparse matrix in checkpoint section " } + name;
+  }
+  // Every index must land inside the value array and the matrix
+  for( int col = 0; col < shape.y(); ++col )
+  {
+    if( col_ptr( col ) > col_ptr( col + 1 ) )
+    {
+      throw std::string{ "Inconsistent sparse matrix in checkpoint section " } + name;
+    }
+  }
+  if( row_ind.size() != 0 && ( row_ind.minCoeff() < 0 || row_ind.maxCoeff() >= shape.x() ) )
+  {
+    throw std::string{ "Inconsistent sparse matrix in checkpoint section " } + name;
+  }
+  A = Eigen::Map<const SparseMatrixsc>{ shape.x(), shape.y(), int( val.size() ), col_ptr.data(), row_ind.data(), val.data() };
+}
+
+void CheckpointReader::checkArraySize( const std::string& name, const TableEntry& entry )
+{
+  assert( entry.scalar_size != 0 );
+  // Each product is checked against the bytes stored before it is formed, so corrupt shapes cannot overflow
+  const std::uint64_t max_index{ std::uint64_t( std::numeric_limits<Eigen::Index>::max() ) };
+  if( entry.rows > max_index || entry.cols > max_index || ( entry.rows != 0 && entry.cols > entry.size / entry.rows ) )
+  {
+    throw std::string{ "Checkpoint section " } + name + std::string{ " is smaller than its dimensions" };
+  }
+  const std::uint64_t num_scalars{ entry.rows * entry.cols };
+  if( num_scalars != 0 && entry.scalar_size > entry.size / num_scalars )
+  {
+    throw std::string{ "Checkpoint section " } + name + std::string{ " is smaller than its dimensions" };
+  }
+}
+
+const CheckpointReader::TableEntry& CheckpointReader::findSection( const std::string& name, const char*& data ) const
+{
+  for( std::uint64_t section_idx = 0; section_idx < m_num_sections; ++section_idx )
+  {
+    if( std::strncmp( m_table[section_idx].name, name.c_str(), sizeof( TableEntry::name ) ) == 0 )
+    {
+      if( ( m_table[section_idx].flags & INHERITED_SECTION ) != 0 )
+      {
+        assert( m_anchor != nullptr );
+        const TableEntry& anchor_entry{ m_anchor->findSection( name, data ) };
+        if( anchor_entry.rows != m_table[section_idx].rows || anchor_entry.cols != m_table[section_idx].cols || anchor_entry.scalar_size != m_table[section_idx].scalar_size )
+        {
+          throw std::string{ "Checkpoint section " } + name + std::string{ " does not match the anchor's" };
+        }
+        return anchor_entry;
+      }
+      data = m_data + m_table[section_idx].offset;
+      return m_table[section_idx];
+    }
+  }
+  throw std::string{ "Checkpoint is missing section " } + name;
+}
+
+CheckpointSectionStream::SectionBuffer::SectionBuffer( const CheckpointReader& checkpoint, const std::string& name )
+{
+  std::size_t size;
+  // The get area is never written through, so casting away const is safe
+  char* const data{ const_cast<char*>( checkpoint.sectionData( name, size ) ) };
+  setg( data, data, data + size );
+}
+
+CheckpointSectionStream::CheckpointSectionStream( const CheckpointReader& checkpoint, const std::string& name )
+: std::istream( nullptr )
+, m_buffer( checkpoint, name )
+{
+  rdbuf( &m_buffer );
+}
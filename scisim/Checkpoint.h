@@ -0,0 +1,215 @@
+// Checkpoint.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Sectioned checkpoint files. A file starts with a header naming the kind of simulation and the schema
+// version of its contents, followed by the sections, each aligned to CHECKPOINT_ALIGNMENT bytes, and
+// ends with a table giving the name, location, and shape of every section. Bulk arrays are stored in
+// their own sections in Eigen's column major layout so they can be copied directly out of a memory map;
+// everything else is stored in sections written with the usual serialize methods.
+//
+// A delta checkpoint names a full anchor checkpoint in the same directory and stores only the sections
+// that differ from it; the table still lists every section, and unchanged ones are read from the anchor.
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "scisim/Math/MathDefines.h"
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+class CheckpointReader;
+
+class CheckpointWriter final
+{
+
+public:
+
+  CheckpointWriter( const std::string& kind, const std::uint32_t schema_version );
+
+  // Lists every section of a checkpoint, resolving sections inherited from an anchor. The sections
+  // reference the mapped file, so checkpoint must outlive the writer.
+  explicit CheckpointWriter( const CheckpointReader& checkpoint );
+
+  // Stores bytes, e.g. the contents of a stream written with serialize methods
+  void addSection( const std::string& name, std::string contents );
+
+  // References the array without copying it; the array must not change or go away until the checkpoint is written
+  template<typename Derived>
+  void addArray( const std::string& name, const Eigen::DenseBase<Derived>& array )
+  {
+    static_assert( !Derived::IsRowMajor || Derived::RowsAtCompileTime == 1, "Error, checkpoint arrays must be stored column major" );
+    addSection( name, nullptr, reinterpret_cast<const char*>( array.derived().data() ), std::size_t( array.size() ) * sizeof( typename Derived::Scalar ), std::uint64_t( array.rows() ), std::uint64_t( array.cols() ), sizeof( typename Derived::Scalar ) );
+  }
+
+  // Takes ownership of a temporary array, e.g. one assembled just for the checkpoint
+  template<typename Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+  void addArray( const std::string& name, Eigen::Matrix<Scalar,Rows,Cols,Options,MaxRows,MaxCols>&& array )
+  {
+    using Array = Eigen::Matrix<Scalar,Rows,Cols,Options,MaxRows,MaxCols>;
+    static_assert( !Array::IsRowMajor || Rows == 1, "Error, checkpoint arrays must be stored column major" );
+    // Allocated with new so fixed size arrays get Eigen's aligned operator new
+    const std::shared_ptr<const Array> owner{ new Array{ std::move( array ) } };
+    addSection( name, owner, reinterpret_cast<const char*>( owner->data() ), std::size_t( owner->size() ) * sizeof( Scalar ), std::uint64_t( owner->rows() ), std::uint64_t( owner->cols() ), sizeof( Scalar ) );
+  }
+
+  // Stores the compressed column arrays of A in the sections name/col_ptr, name/row_ind, and name/val
+  void addSparseMatrix( const std::string& name, const SparseMatrixsc& A );
+
+  // Drops the contents of sections identical to those of anchor, which must be a full checkpoint
+  // saved as anchor_file_name in the directory this checkpoint will be written to
+  void makeDelta( const CheckpointWriter& anchor, const std::string& anchor_file_name );
+
+  bool isDelta() const;
+
+  // Copies the contents of sections that reference data owned elsewhere, so the checkpoint can be kept
+  // (e.g. as the anchor of later deltas) after that data changes
+  void copyReferencedContents();
+
+  // Total bytes of section contents that will be written
+  std::uint64_t contentBytes() const;
+
+  // Writes the header, sections, and table with one write per section
+  bool writeFile( const std::string& file_name ) const;
+
+  // Assembles the contents of the file in memory
+  void writeImage( std::vector<char>& image ) const;
+
+private:
+
+  struct Section final
+  {
+    std::string name;
+    // Holds the contents if the checkpoint owns them; null if they are referenced
+    std::shared_ptr<const void> owner;
+    const char* data;
+    std::size_t size;
+    std::uint64_t rows;
+    std::uint64_t cols;
+    std::uint32_t scalar_size;
+    bool inherited;
+  };
+
+  void addSection( const std::string& name, std::shared_ptr<const void> owner, const char* data, const std::size_t size, const std::uint64_t rows, const std::uint64_t cols, const std::uint32_t scalar_size );
+
+  // Computes the offset of each section and the total file size
+  std::vector<std::uint64_t> layout( std::uint64_t& file_size ) const;
+
+  std::string headerBytes() const;
+  std::string tableBytes( const std::vector<std::uint64_t>& offsets ) const;
+
+  std::string m_kind;
+  std::uint32_t m_schema_version;
+  std::vector<Section> m_sections;
+  bool m_is_delta;
+
+};
+
+class CheckpointReader final
+{
+
+public:
+
+  // Maps the file into memory; throws a std::string describing the problem if the file is not a valid checkpoint
+  explicit CheckpointReader( const std::string& file_name );
+  ~CheckpointReader();
+  CheckpointReader( const CheckpointReader& ) = delete;
+  CheckpointReader& operator=( const CheckpointReader& ) = delete;
+
+  // True if the file begins with the checkpoint magic number
+  static bool isCheckpoint( const std::string& file_name );
+
+  const std::string& kind() const;
+  std::uint32_t schemaVersion() const;
+
+  bool hasSection( const std::string& name ) const;
+
+  // True if some sections are read from an anchor checkpoint
+  bool isDelta() const;
+
+  // Returns the start and size of a section's bytes within the mapped file
+  const char* sectionData( const std::string& name, std::size_t& size ) const;
+
+  template<typename Derived>
+  Derived readArray( const std::string& name ) const
+  {
+    using Scalar = typename Derived::Scalar;
+    const char* data;
+    const TableEntry& entry{ findSection( name, data ) };
+    if( entry.scalar_size != sizeof( Scalar ) )
+    {
+      throw std::string{ "Checkpoint section " } + name + std::string{ " has an unexpected scalar type" };
+    }
+    if( ( Derived::RowsAtCompileTime != Eigen::Dynamic && entry.rows != std::uint64_t( Derived::RowsAtCompileTime ) ) || ( Derived::ColsAtCompileTime != Eigen::Dynamic && entry.cols != std::uint64_t( Derived::ColsAtCompileTime ) ) )
+    {
+      throw std::string{ "Checkpoint section " } + name + std::string{ " has unexpected dimensions" };
+    }
+    checkArraySize( name, entry );
+    return Eigen::Map<const Derived>{ reinterpret_cast<const Scalar*>( data ), Eigen::Index( entry.rows ), Eigen::Index( entry.cols ) };
+  }
+
+  void readSparseMatrix( const std::string& name, SparseMatrixsc& A ) const;
+
+private:
+
+  struct TableEntry final
+  {
+    char name[64];
+    std::uint64_t offset;
+    std::uint64_t size;
+    std::uint64_t rows;
+    std::uint64_t cols;
+    std::uint32_t scalar_size;
+    std::uint32_t flags;
+  };
+
+  // Set on sections whose contents are stored in the anchor
+  static constexpr std::uint32_t INHERITED_SECTION{ 1 };
+
+  // Throws if the shape of an array section does not fit in its bytes
+  static void checkArraySize( const std::string& name, const TableEntry& entry );
+
+  // Returns the entry for a section and the start of its contents, which may lie in the anchor
+  const TableEntry& findSection( const std::string& name, const char*& data ) const;
+
+  const char* m_data;
+  std::size_t m_size;
+  std::string m_kind;
+  std::uint32_t m_schema_version;
+  const TableEntry* m_table;
+  std::uint64_t m_num_sections;
+  std::unique_ptr<CheckpointReader> m_anchor;
+
+  // The writer lays out the table with the same entries
+  friend class CheckpointWriter;
+
+};
+
+// Reads a section with the usual deserialize methods
+class CheckpointSectionStream final : public std::istream
+{
+
+public:
+
+  CheckpointSectionStream( const CheckpointReader& checkpoint, const std::string& name );
+
+private:
+
+  class SectionBuffer final : public std::streambuf
+  {
+  public:
+    SectionBuffer( const CheckpointReader& checkpoint, const std::string& name );
+  };
+
+  SectionBuffer m_buffer;
+
+};
+
+#endif
@@ -17,6 +17,10 @@
 #include "scisim/UnconstrainedMaps/FlowableSystem.h"
 #include "scisim/Utilities.h"
 
+#ifdef USE_HDF5
+#include "scisim/ConstrainedMaps/ImpactMaps/ImpactSolution.h"
+#endif
+
 GeometricImpactFrictionMap::GeometricImpactFrictionMap( const scalar& abs_tol, const unsigned max_iters, const ImpulsesToCache impulses_to_cache )
 : m_f( VectorXs::Zero( 0 ) )
 , m_abs_tol( abs_tol )
@@ -24,7 +28,7 @@ GeometricImpactFrictionMap::GeometricImpactFrictionMap( const scalar& abs_tol, c
 , m_impulses_to_cache( impulses_to_cache )
 #ifdef USE_HDF5
 , m_write_constraint_forces( false )
-, m_constraint_force_stream( nullptr )
+, m_impact_solution( nullptr )
 #endif
 {
   assert( m_abs_tol >= 0.0 );
@@ -37,7 +41,7 @@ GeometricImpactFrictionMap::GeometricImpactFrictionMap( std::istream& input_stre
 , m_impulses_to_cache( Utilities::deserialize<ImpulsesToCache>( input_stream ) )
 #ifdef USE_HDF5
 , m_write_constraint_forces( false )
-, m_constraint_force_stream( nullptr )
+, m_impact_solution( nullptr )
 #endif
 {
   assert( m_abs_tol >= 0.0 );
@@ -274,6 +278,7 @@ void GeometricImpactFrictionMap::flow( ScriptingCallback& call_back, FlowableSys
   {
     m_f = VectorXs::Zero( v0.size() );
   }
+  recordSolveOutcome( true, 0.0 );
 
   // Compute an unconstrained predictor step
   umap.flow( q0, v0, fsys, iteration, dt, q1, v1 );
@@ -292,7 +297,7 @@ void GeometricImpactFrictionMap::flow( ScriptingCallback& call_back, FlowableSys
       exportConstraintForcesToBinary( q0, active_set, MatrixXXsc{ fsys.ambientSpaceDimensions(), 0 }, VectorXs::Zero(0), VectorXs::Zero(0), dt );
     }
     m_write_constraint_forces = false;
-    m_constraint_force_stream = nullptr;
+    m_impact_solution = nullptr;
     #endif
     return;
   }
@@ -307,14 +312,18 @@ void GeometricImpactFrictionMap::flow( ScriptingCallback& call_back, FlowableSys
 
   // Set the coefficients of friction to the default
   VectorXs mu{ VectorXs::Constant( ncollisions, mu_default ) };
+  // Apply per material coefficients, if any
+  csys.computeFrictionCoefficients( active_set, mu );
   // If scripting is enabled, use the scripted version
-  call_back.frictionCoefficientCallback( active_set, mu );
+  call_back.frictionCoefficientCallback( q0, active_set, mu );
   assert( ( mu.array() >= 0.0 ).all() );
 
   // Coefficients of restitution
   VectorXs CoR{ VectorXs::Constant( ncollisions, CoR_default ) };
+  // Apply per material coefficients, if any
+  csys.computeRestitutionCoefficients( active_set, CoR );
   // If scripting is enabled, use the scripted version
-  call_back.restitutionCoefficientCallback( active_set, CoR );
+  call_back.restitutionCoefficientCallback( q0, active_set, CoR );
   assert( ( CoR.array() >= 0.0 ).all() ); assert( ( CoR.array() <= 1.0 ).all() );
 
   // Normal impulse magnitudes
@@ -341,6 +350,7 @@ void GeometricImpactFrictionMap::flow( ScriptingCallback& call_back, FlowableSys
     bool solve_succeeded;
     friction_solver.solve( iteration, dt, fsys, fsys.M(), fsys.Minv(), CoR, mu, q0, v0, active_set, contact_bases, m_max_iters, m_abs_tol, m_f, alpha, beta, v2, solve_succeeded, error );
     assert( error >= 0.0 );
+    recordSolveOutcome( solve_succeeded, error );
     if( !solve_succeeded )
     {
       std::cerr << "Warning, coupled impact/friction solve exceeded max iterations " << m_max_iters;
@@ -432,7 +442,7 @@ void GeometricImpactFrictionMap::flow( ScriptingCallback& call_back, FlowableSys
     exportConstraintForcesToBinary( q0, active_set, contact_bases, alpha, beta, dt );
   }
   m_write_constraint_forces = false;
-  m_constraint_force_stream = nullptr;
+  m_impact_solution = nullptr;
   #endif
 
   // Using the initial configuration and the new velocity, compute the final state
@@ -448,8 +458,8 @@ void GeometricImpactFrictionMap::resetCachedData()
 void GeometricImpactFrictionMap::exportConstraintForcesToBinary( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& constraints, const MatrixXXsc& contact_bases, const VectorXs& alpha, const VectorXs& beta, const scalar& dt )
 {
   assert( m_write_constraint_forces );
-  assert( m_constraint_force_stream != nullptr );
-  ImpactFrictionMap::exportConstraintForcesToBinaryFile( q, constraints, contact_bases, alpha, beta, dt, *m_constraint_force_stream );
+  assert( m_impact_solution != nullptr );
+  m_impact_solution->setSolution( q, constraints, contact_bases, alpha, beta, dt );
 }
 #endif
 
@@ -462,7 +472,7 @@ void GeometricImpactFrictionMap::serialize( std::ostream& output_stream ) const
   Utilities::serialize( m_impulses_to_cache, output_stream );
   #ifdef USE_HDF5
   assert( m_write_constraint_forces == false );
-  assert( m_constraint_force_stream == nullptr );
+  assert( m_impact_solution == nullptr );
   #endif
 }
 
@@ -472,9 +482,9 @@ std::string GeometricImpactFrictionMap::name() const
 }
 
 #ifdef USE_HDF5
-void GeometricImpactFrictionMap::exportForcesNextStep( HDF5File& output_file )
+void GeometricImpactFrictionMap::exportForcesNextStep( ImpactSolution& impact_solution )
 {
   m_write_constraint_forces = true;
-  m_constraint_force_stream = &output_file;
+  m_impact_solution = &impact_solution;
 }
 #endif
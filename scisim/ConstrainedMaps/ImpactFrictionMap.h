@@ -18,7 +18,7 @@ class FrictionSolver;
 class Constraint;
 
 #ifdef USE_HDF5
-class HDF5File;
+class ImpactSolution;
 #endif
 
 class ImpactFrictionMap
@@ -43,23 +43,31 @@ public:
   virtual std::string name() const = 0;
 
   #ifdef USE_HDF5
-  virtual void exportForcesNextStep( HDF5File& output_file ) = 0;
+  // Records the contact forces of the next step in impact_solution
+  virtual void exportForcesNextStep( ImpactSolution& impact_solution ) = 0;
   #endif
 
+  // Outcome of the friction solve in the most recent step; steps without contacts report success with zero error
+  bool lastSolveSucceeded() const;
+  const scalar& lastSolveError() const;
+
 protected:
 
-  ImpactFrictionMap() = default;
+  ImpactFrictionMap();
+
+  void recordSolveOutcome( const bool solve_succeeded, const scalar& error );
 
   // TODO: Move these shared routines out of here
   // Support routines shared by various ImpactFrictionMap implementations
   //static bool noImpulsesToKinematicGeometry( const FlowableSystem& fsys, const SparseMatrixsc& N, const VectorXs& alpha, const SparseMatrixsc& D, const VectorXs& beta, const VectorXs& v0 );
-  #ifdef USE_HDF5
-  static void exportConstraintForcesToBinaryFile( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& constraints, const MatrixXXsc& contact_bases, const VectorXs& alpha, const VectorXs& beta, const scalar& dt, HDF5File& output_file );
-  #endif
-
   static bool constraintSetShouldConserveMomentum( const std::vector<std::unique_ptr<Constraint>>& cons );
   static bool constraintSetShouldConserveAngularMomentum( const std::vector<std::unique_ptr<Constraint>>& cons );
 
+private:
+
+  bool m_last_solve_succeeded;
+  scalar m_last_solve_error;
+
 };
 
 #endif
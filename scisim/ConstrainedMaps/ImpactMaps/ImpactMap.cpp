@@ -99,8 +99,10 @@ void ImpactMap::flow( ScriptingCallback& call_back, FlowableSystem& fsys, Constr
 
   // Coefficients of restitution
   VectorXs CoR{ VectorXs::Constant( ncollisions, CoR_default ) };
+  // Apply per material coefficients, if any
+  csys.computeRestitutionCoefficients( active_set, CoR );
   // If scripting is enabled, use the scripted version
-  call_back.restitutionCoefficientCallback( active_set, CoR );
+  call_back.restitutionCoefficientCallback( q0, active_set, CoR );
 
   // Generalized normal basis
   SparseMatrixsc N{ fsys.Minv().cols(), SparseMatrixsc::Index( ncollisions ) };
@@ -22,10 +22,23 @@ public:
 
   void setSolution( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& constraints, const MatrixXXsc& impact_bases, const VectorXs& alpha, const scalar& dt );
 
+  // Frictional variant; contact_bases holds each contact's normal followed by its friction directions
+  void setSolution( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& constraints, const MatrixXXsc& contact_bases, const VectorXs& alpha, const VectorXs& beta, const scalar& dt );
+
   void writeSolution( HDF5File& output_file );
 
+  unsigned numContacts() const;
+  // Body indices of each contact; static objects are encoded as -index - 2
+  const Matrix2Xic& indices() const;
+  const MatrixXXsc& points() const;
+  const MatrixXXsc& normals() const;
+  const MatrixXXsc& forces() const;
+
 private:
 
+  // Stores the indices and world space points of each contact
+  void setContacts( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& constraints, const unsigned ambient_space_dims );
+
   Matrix2Xic m_indices;
   MatrixXXsc m_points;
   MatrixXXsc m_normals;
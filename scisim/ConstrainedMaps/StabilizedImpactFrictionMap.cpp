@@ -17,6 +17,10 @@
 #include "scisim/UnconstrainedMaps/FlowableSystem.h"
 #include "scisim/Utilities.h"
 
+#ifdef USE_HDF5
+#include "scisim/ConstrainedMaps/ImpactMaps/ImpactSolution.h"
+#endif
+
 StabilizedImpactFrictionMap::StabilizedImpactFrictionMap( const scalar& abs_tol, const unsigned max_iters, const bool external_warm_start_alpha, const bool external_warm_start_beta )
 : m_f( VectorXs::Zero( 0 ) )
 , m_abs_tol( abs_tol )
@@ -25,7 +29,7 @@ StabilizedImpactFrictionMap::StabilizedImpactFrictionMap( const scalar& abs_tol,
 , m_external_warm_start_beta( external_warm_start_beta )
 #ifdef USE_HDF5
 , m_write_constraint_forces( false )
-, m_constraint_force_stream( nullptr )
+, m_impact_solution( nullptr )
 #endif
 {
   assert( m_abs_tol >= 0.0 );
@@ -39,7 +43,7 @@ StabilizedImpactFrictionMap::StabilizedImpactFrictionMap( std::istream& input_st
 , m_external_warm_start_beta( Utilities::deserialize<bool>( input_stream ) )
 #ifdef USE_HDF5
 , m_write_constraint_forces( false )
-, m_constraint_force_stream( nullptr )
+, m_impact_solution( nullptr )
 #endif
 {
   assert( m_abs_tol >= 0.0 );
@@ -55,6 +59,7 @@ void StabilizedImpactFrictionMap::flow( ScriptingCallback& call_back, FlowableSy
   {
     m_f = VectorXs::Zero( v0.size() );
   }
+  recordSolveOutcome( true, 0.0 );
 
   // Compute an unconstrained predictor step
   umap.flow( q0, v0, fsys, iteration, dt, q1, v1 );
@@ -72,7 +77,7 @@ void StabilizedImpactFrictionMap::flow( ScriptingCallback& call_back, FlowableSy
       exportConstraintForcesToBinary( q0, active_set, MatrixXXsc{ fsys.ambientSpaceDimensions(), 0 }, VectorXs::Zero(0), VectorXs::Zero(0), dt );
     }
     m_write_constraint_forces = false;
-    m_constraint_force_stream = nullptr;
+    m_impact_solution = nullptr;
     #endif
     return;
   }
@@ -88,14 +93,18 @@ void StabilizedImpactFrictionMap::flow( ScriptingCallback& call_back, FlowableSy
 
   // Set the coefficients of friction to the default
   VectorXs mu{ VectorXs::Constant( ncollisions, mu_default ) };
+  // Apply per material coefficients, if any
+  csys.computeFrictionCoefficients( active_set, mu );
   // If scripting is enabled, use the scripted version
-  call_back.frictionCoefficientCallback( active_set, mu );
+  call_back.frictionCoefficientCallback( q0, active_set, mu );
   assert( ( mu.array() >= 0.0 ).all() );
 
   // Coefficients of restitution
   VectorXs CoR{ VectorXs::Constant( ncollisions, CoR_default ) };
+  // Apply per material coefficients, if any
+  csys.computeRestitutionCoefficients( active_set, CoR );
   // If scripting is enabled, use the scripted version
-  call_back.restitutionCoefficientCallback( active_set, CoR );
+  call_back.restitutionCoefficientCallback( q0, active_set, CoR );
   assert( ( CoR.array() >= 0.0 ).all() ); assert( ( CoR.array() <= 1.0 ).all() );
 
   // Normal impulse magnitudes
@@ -126,6 +135,7 @@ void StabilizedImpactFrictionMap::flow( ScriptingCallback& call_back, FlowableSy
     //std::cout << "alpha: " << alpha.transpose() << std::endl;
     //std::cout << "beta: " << beta.transpose() << std::endl;
     assert( error >= 0.0 );
+    recordSolveOutcome( solve_succeeded, error );
     if( !solve_succeeded )
     {
       std::cerr << "Warning, coupled impact/friction solve exceeded max iterations " << m_max_iters;
@@ -172,7 +182,7 @@ void StabilizedImpactFrictionMap::flow( ScriptingCallback& call_back, FlowableSy
     exportConstraintForcesToBinary( q0, active_set, contact_bases, alpha, beta, dt );
   }
   m_write_constraint_forces = false;
-  m_constraint_force_stream = nullptr;
+  m_impact_solution = nullptr;
   #endif
 
   active_set.clear();
@@ -189,8 +199,8 @@ void StabilizedImpactFrictionMap::resetCachedData()
 void StabilizedImpactFrictionMap::exportConstraintForcesToBinary( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& constraints, const MatrixXXsc& contact_bases, const VectorXs& alpha, const VectorXs& beta, const scalar& dt )
 {
   assert( m_write_constraint_forces );
-  assert( m_constraint_force_stream != nullptr );
-  ImpactFrictionMap::exportConstraintForcesToBinaryFile( q, constraints, contact_bases, alpha, beta, dt, *m_constraint_force_stream );
+  assert( m_impact_solution != nullptr );
+  m_impact_solution->setSolution( q, constraints, contact_bases, alpha, beta, dt );
 }
 #endif
 
@@ -204,7 +214,7 @@ void StabilizedImpactFrictionMap::serialize( std::ostream& output_stream ) const
   Utilities::serialize( m_external_warm_start_beta, output_stream );
   #ifdef USE_HDF5
   assert( m_write_constraint_forces == false );
-  assert( m_constraint_force_stream == nullptr );
+  assert( m_impact_solution == nullptr );
   #endif
 }
 
@@ -214,9 +224,9 @@ std::string StabilizedImpactFrictionMap::name() const
 }
 
 #ifdef USE_HDF5
-void StabilizedImpactFrictionMap::exportForcesNextStep( HDF5File& output_file )
+void StabilizedImpactFrictionMap::exportForcesNextStep( ImpactSolution& impact_solution )
 {
   m_write_constraint_forces = true;
-  m_constraint_force_stream = &output_file;
+  m_impact_solution = &impact_solution;
 }
 #endif
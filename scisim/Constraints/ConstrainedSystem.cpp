@@ -6,3 +6,9 @@
 #include "ConstrainedSystem.h"
 
 ConstrainedSystem::~ConstrainedSystem() = default;
+
+void ConstrainedSystem::computeRestitutionCoefficients( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& CoR ) const
+{}
+
+void ConstrainedSystem::computeFrictionCoefficients( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu ) const
+{}
@@ -26,6 +26,10 @@ public:
   virtual void getCachedConstraintImpulse( const Constraint& constraint, VectorXs& r  ) const = 0;
   virtual bool constraintCacheEmpty() const = 0;
 
+  // Per contact coefficients that replace the scene wide defaults; by default the defaults are kept
+  virtual void computeRestitutionCoefficients( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& CoR ) const;
+  virtual void computeFrictionCoefficients( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu ) const;
+
 protected:
 
   ConstrainedSystem() = default;
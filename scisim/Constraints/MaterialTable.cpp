@@ -0,0 +1,146 @@
+// MaterialTable.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "MaterialTable.h"
+
+#include "scisim/Constraints/Constraint.h"
+#include "scisim/Math/MathUtilities.h"
+#include "scisim/Utilities.h"
+
+#include <algorithm>
+#include <cmath>
+
+constexpr unsigned MaterialTable::MAX_MATERIALS;
+
+MaterialTable::MaterialTable()
+: m_body_materials()
+, m_num_materials( 0 )
+, m_CoR()
+, m_mu()
+{}
+
+MaterialTable::MaterialTable( std::istream& input_stream )
+: m_body_materials( Utilities::deserializeVector<unsigned>( input_stream ) )
+, m_num_materials( Utilities::deserialize<unsigned>( input_stream ) )
+, m_CoR( MathUtilities::deserialize<VectorXs>( input_stream ) )
+, m_mu( MathUtilities::deserialize<VectorXs>( input_stream ) )
+{
+  assert( m_num_materials <= MAX_MATERIALS );
+  assert( m_CoR.size() == m_num_materials * m_num_materials );
+  assert( m_mu.size() == m_num_materials * m_num_materials );
+}
+
+bool MaterialTable::empty() const
+{
+  return m_num_materials == 0;
+}
+
+unsigned MaterialTable::nbodies() const
+{
+  return unsigned( m_body_materials.size() );
+}
+
+void MaterialTable::resize( const unsigned nbodies )
+{
+  m_body_materials.resize( nbodies, 0 );
+}
+
+unsigned MaterialTable::material( const unsigned bdy_idx ) const
+{
+  assert( bdy_idx < m_body_materials.size() );
+  return m_body_materials[bdy_idx];
+}
+
+void MaterialTable::setMaterial( const unsigned bdy_idx, const unsigned material )
+{
+  assert( bdy_idx < m_body_materials.size() );
+  m_body_materials[bdy_idx] = material;
+}
+
+void MaterialTable::setPairCoefficients( const unsigned material0, const unsigned material1, const scalar& CoR, const scalar& mu )
+{
+  assert( std::isnan( CoR ) || ( CoR >= 0.0 && CoR <= 1.0 ) );
+  assert( std::isnan( mu ) || mu >= 0.0 );
+  assert( material0 < MAX_MATERIALS );
+  assert( material1 < MAX_MATERIALS );
+
+  // Grow the tables to hold both materials, new entries default to the scene wide coefficients
+  const unsigned new_num_materials{ std::max( m_num_materials, std::max( material0, material1 ) + 1 ) };
+  if( new_num_materials != m_num_materials )
+  {
+    VectorXs new_CoR{ VectorXs::Constant( new_num_materials * new_num_materials, SCALAR_NAN ) };
+    VectorXs new_mu{ VectorXs::Constant( new_num_materials * new_num_materials, SCALAR_NAN ) };
+    for( unsigned row = 0; row < m_num_materials; ++row )
+    {
+      new_CoR.segment( row * new_num_materials, m_num_materials ) = m_CoR.segment( row * m_num_materials, m_num_materials );
+      new_mu.segment( row * new_num_materials, m_num_materials ) = m_mu.segment( row * m_num_materials, m_num_materials );
+    }
+    m_CoR.swap( new_CoR );
+    m_mu.swap( new_mu );
+    m_num_materials = new_num_materials;
+  }
+
+  m_CoR( material0 * m_num_materials + material1 ) = CoR;
+  m_CoR( material1 * m_num_materials + material0 ) = CoR;
+  m_mu( material0 * m_num_materials + material1 ) = mu;
+  m_mu( material1 * m_num_materials + material0 ) = mu;
+}
+
+unsigned MaterialTable::numMaterials() const
+{
+  return m_num_materials;
+}
+
+void MaterialTable::restitutionCoefficients( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& CoR ) const
+{
+  fillCoefficients( m_CoR, active_set, CoR );
+}
+
+void MaterialTable::frictionCoefficients( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu ) const
+{
+  fillCoefficients( m_mu, active_set, mu );
+}
+
+void MaterialTable::fillCoefficients( const VectorXs& table, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& coefficients ) const
+{
+  assert( coefficients.size() == long( active_set.size() ) );
+  if( m_num_materials == 0 )
+  {
+    return;
+  }
+  // Static geometry has a negative body index
+  const auto material_of{ [this]( const int bdy_idx )
+    {
+      assert( bdy_idx < 0 || unsigned( bdy_idx ) < m_body_materials.size() );
+      return bdy_idx < 0 ? 0u : m_body_materials[bdy_idx];
+    }
+  };
+  for( std::vector<std::unique_ptr<Constraint>>::size_type con_idx = 0; con_idx < active_set.size(); ++con_idx )
+  {
+    std::pair<int,int> bodies;
+    active_set[con_idx]->getBodyIndices( bodies );
+    const unsigned material0{ material_of( bodies.first ) };
+    const unsigned material1{ material_of( bodies.second ) };
+    // Materials without any table entries keep the scene wide coefficient
+    if( material0 >= m_num_materials || material1 >= m_num_materials )
+    {
+      continue;
+    }
+    const scalar& coefficient{ table( material0 * m_num_materials + material1 ) };
+    if( !std::isnan( coefficient ) )
+    {
+      coefficients( con_idx ) = coefficient;
+    }
+  }
+}
+
+void MaterialTable::serialize( std::ostream& output_stream ) const
+{
+  assert( output_stream.good() );
+  Utilities::serialize( m_body_materials, output_stream );
+  Utilities::serialize( m_num_materials, output_stream );
+  MathUtilities::serialize( m_CoR, output_stream );
+  MathUtilities::serialize( m_mu, output_stream );
+}
@@ -0,0 +1,65 @@
+// MaterialTable.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Per-body material ids and a symmetric table of coefficients of restitution and friction for pairs of
+// materials. Contacts between a pair of materials with a table entry use that entry in place of the scene
+// wide coefficient, without a scripting callback. Static geometry is material 0.
+
+#ifndef MATERIAL_TABLE_H
+#define MATERIAL_TABLE_H
+
+#include "scisim/Math/MathDefines.h"
+
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+class Constraint;
+
+class MaterialTable final
+{
+
+public:
+
+  // The tables are dense, so material ids are kept small
+  static constexpr unsigned MAX_MATERIALS{ 256 };
+
+  // No pair entries, so every contact keeps the scene wide coefficients
+  MaterialTable();
+  explicit MaterialTable( std::istream& input_stream );
+
+  // True if no pair of materials has an entry
+  bool empty() const;
+
+  // Per-body storage; new bodies are material 0
+  unsigned nbodies() const;
+  void resize( const unsigned nbodies );
+  unsigned material( const unsigned bdy_idx ) const;
+  void setMaterial( const unsigned bdy_idx, const unsigned material );
+
+  // Coefficients for contacts between two materials, in either order, both less than MAX_MATERIALS. A nan
+  // coefficient keeps the scene wide value.
+  void setPairCoefficients( const unsigned material0, const unsigned material1, const scalar& CoR, const scalar& mu );
+  unsigned numMaterials() const;
+
+  // Overwrite the coefficient of each contact between a pair of materials with a table entry
+  void restitutionCoefficients( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& CoR ) const;
+  void frictionCoefficients( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu ) const;
+
+  void serialize( std::ostream& output_stream ) const;
+
+private:
+
+  void fillCoefficients( const VectorXs& table, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& coefficients ) const;
+
+  std::vector<unsigned> m_body_materials;
+  unsigned m_num_materials;
+  // Row major m_num_materials x m_num_materials tables, nan where the scene wide coefficient applies
+  VectorXs m_CoR;
+  VectorXs m_mu;
+
+};
+
+#endif
@@ -0,0 +1,121 @@
+// FrameReduction.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "FrameReduction.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <dirent.h>
+#include <iomanip>
+#include <limits>
+#include <thread>
+
+std::vector<std::string> FrameReduction::listFiles( const std::string& directory, const std::string& prefix, const std::string& suffix )
+{
+  DIR* const dir{ opendir( directory.c_str() ) };
+  if( dir == nullptr )
+  {
+    throw std::string{ "Failed to open directory: " } + directory;
+  }
+
+  std::vector<std::string> file_names;
+  for( const dirent* entry = readdir( dir ); entry != nullptr; entry = readdir( dir ) )
+  {
+    const std::string name{ entry->d_name };
+    if( name.size() >= prefix.size() + suffix.size() && name.compare( 0, prefix.size(), prefix ) == 0 && name.compare( name.size() - suffix.size(), suffix.size(), suffix ) == 0 )
+    {
+      file_names.emplace_back( name );
+    }
+  }
+  closedir( dir );
+
+  // Output files are numbered with a fixed width, so lexicographic order is frame order
+  std::sort( file_names.begin(), file_names.end() );
+  return file_names;
+}
+
+void FrameReduction::parallelFor( const unsigned num_items, const unsigned num_threads, const std::function<void(unsigned,unsigned)>& process )
+{
+  assert( num_threads > 0 );
+
+  std::atomic<unsigned> next_item{ 0 };
+  std::mutex error_mutex;
+  std::string error;
+
+  const auto process_items = [&]( const unsigned thread )
+  {
+    while( true )
+    {
+      const unsigned item{ next_item++ };
+      if( item >= num_items )
+      {
+        return;
+      }
+      try
+      {
+        process( thread, item );
+      }
+      catch( const std::string& item_error )
+      {
+        std::lock_guard<std::mutex> lock{ error_mutex };
+        if( error.empty() )
+        {
+          error = item_error;
+        }
+        // Stop handing out items
+        next_item = num_items;
+        return;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for( unsigned thread = 1; thread < std::min( num_threads, std::max( num_items, 1u ) ); ++thread )
+  {
+    threads.emplace_back( process_items, thread );
+  }
+  process_items( 0 );
+  for( std::thread& thread : threads )
+  {
+    thread.join();
+  }
+
+  if( !error.empty() )
+  {
+    throw error;
+  }
+}
+
+std::mutex& FrameReduction::hdf5Mutex()
+{
+  static std::mutex hdf5_mutex;
+  return hdf5_mutex;
+}
+
+void FrameReduction::writeTable( const std::vector<std::string>& columns, const std::vector<std::string>& labels, const std::vector<std::vector<scalar>>& rows, std::ostream& output_stream )
+{
+  assert( labels.size() == rows.size() );
+
+  output_stream << "# file";
+  for( const std::string& column : columns )
+  {
+    output_stream << ' ' << column;
+  }
+  output_stream << '\n';
+
+  output_stream << std::setprecision( std::numeric_limits<scalar>::max_digits10 );
+  for( std::vector<std::vector<scalar>>::size_type row = 0; row < rows.size(); ++row )
+  {
+    assert( rows[row].size() == columns.size() );
+    output_stream << labels[row];
+    for( const scalar& value : rows[row] )
+    {
+      output_stream << ' ' << value;
+    }
+    output_stream << '\n';
+  }
+  output_stream.flush();
+}
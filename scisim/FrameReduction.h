@@ -0,0 +1,41 @@
+// FrameReduction.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Support for the batch post-processing tools, which scan the per-frame output files of a simulation and
+// compute reductions such as energies, momenta, and collision counts for every frame in parallel.
+
+#ifndef FRAME_REDUCTION_H
+#define FRAME_REDUCTION_H
+
+#include "scisim/Math/MathDefines.h"
+
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace FrameReduction
+{
+
+  // Sorted names of the files in directory that begin with prefix and end with suffix; throws a std::string
+  // if the directory can not be read
+  std::vector<std::string> listFiles( const std::string& directory, const std::string& prefix, const std::string& suffix );
+
+  // Calls process( thread, item ) for every item in [0,num_items) on num_threads threads, which take items
+  // in order as they finish earlier ones. If process throws a std::string, the remaining items are skipped
+  // and the first error is rethrown once all threads finish.
+  void parallelFor( const unsigned num_items, const unsigned num_threads, const std::function<void(unsigned,unsigned)>& process );
+
+  // The serial HDF5 library is not thread safe, so threads must hold this lock while opening, reading, or
+  // closing files
+  std::mutex& hdf5Mutex();
+
+  // Writes one row per frame, labeled with the frame's file name, under a header naming the columns
+  void writeTable( const std::vector<std::string>& columns, const std::vector<std::string>& labels, const std::vector<std::vector<scalar>>& rows, std::ostream& output_stream );
+
+}
+
+#endif
@@ -1,7 +1,7 @@
 // HDF5File.cpp
 //
 // Breannan Smith
-// Last updated: 09/28/2015
+// Last updated: 10/19/2026
 
 #include "HDF5File.h"
 
@@ -11,6 +11,7 @@ using HDFGID = HDFID<H5Gclose>;
 using HDFTID = HDFID<H5Tclose>;
 using HDFSID = HDFID<H5Sclose>;
 using HDFDID = HDFID<H5Dclose>;
+using HDFPID = HDFID<H5Pclose>;
 
 HDF5File::HDF5File()
 : m_hdf_file_id( -1 )
@@ -59,6 +60,19 @@ void HDF5File::open( const std::string& file_name, const HDF5AccessType& access_
     case HDF5AccessType::READ_ONLY:
       m_hdf_file_id = H5Fopen( file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
       break;
+    case HDF5AccessType::READ_WRITE_EXISTING:
+      m_hdf_file_id = H5Fopen( file_name.c_str(), H5F_ACC_RDWR, H5P_DEFAULT );
+      break;
+    case HDF5AccessType::IN_MEMORY:
+    {
+      // Grow the in memory image a megabyte at a time and never write it to disk
+      const HDFPID access_property_id{ H5Pcreate( H5P_FILE_ACCESS ) };
+      if( access_property_id >= 0 && H5Pset_fapl_core( access_property_id, 1 << 20, 0 ) >= 0 )
+      {
+        m_hdf_file_id = H5Fcreate( file_name.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, access_property_id );
+      }
+      break;
+    }
   }
   // Check that the file successfully opened
   if( m_hdf_file_id < 0 )
@@ -72,6 +86,169 @@ bool HDF5File::is_open() const
   return m_hdf_file_id >= 0;
 }
 
+void HDF5File::flush() const
+{
+  assert( m_hdf_file_id >= 0 );
+  if( H5Fflush( m_hdf_file_id, H5F_SCOPE_LOCAL ) < 0 )
+  {
+    throw std::string{ "Failed to flush HDF file" };
+  }
+}
+
+void HDF5File::fileImage( std::vector<char>& image ) const
+{
+  assert( m_hdf_file_id >= 0 );
+  flush();
+  const ssize_t image_size{ H5Fget_file_image( m_hdf_file_id, nullptr, 0 ) };
+  if( image_size < 0 )
+  {
+    throw std::string{ "Failed to get size of HDF file image" };
+  }
+  image.resize( std::vector<char>::size_type( image_size ) );
+  if( H5Fget_file_image( m_hdf_file_id, image.data(), image.size() ) != image_size )
+  {
+    throw std::string{ "Failed to get HDF file image" };
+  }
+}
+
+bool HDF5File::exists( const std::string& full_name ) const
+{
+  assert( m_hdf_file_id >= 0 );
+  // H5Lexists fails if an intermediate group is missing, so check each level of the path in turn
+  std::string::size_type end{ 0 };
+  while( end != std::string::npos )
+  {
+    end = full_name.find( '/', end + 1 );
+    const std::string partial_name{ full_name.substr( 0, end ) };
+    const htri_t link_exists{ H5Lexists( m_hdf_file_id, partial_name.c_str(), H5P_DEFAULT ) };
+    if( link_exists < 0 )
+    {
+      throw std::string{ "Failed to query existence of: " } + partial_name;
+    }
+    if( link_exists == 0 )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HDF5File::remove( const std::string& full_name ) const
+{
+  assert( m_hdf_file_id >= 0 );
+  if( H5Ldelete( m_hdf_file_id, full_name.c_str(), H5P_DEFAULT ) < 0 )
+  {
+    throw std::string{ "Failed to remove: " } + full_name;
+  }
+}
+
+hsize_t HDF5File::numRows( const std::string& full_name ) const
+{
+  const auto split_name = splitFullName( full_name );
+  const HDFGID grp_id{ findGroup( split_name.first ) };
+  const HDFDID dataset_id{ H5Dopen2( grp_id, split_name.second.c_str(), H5P_DEFAULT ) };
+  if( dataset_id < 0 )
+  {
+    throw std::string{ "Failed to open HDF data set" };
+  }
+  const Eigen::ArrayXi dimensions{ getDimensions( dataset_id ) };
+  if( dimensions.size() != 2 )
+  {
+    throw std::string{ "Invalid dimensions for HDF data set with rows" };
+  }
+  return hsize_t( dimensions( 0 ) );
+}
+
+void HDF5File::truncateRows( const std::string& full_name, const hsize_t nrows ) const
+{
+  const auto split_name = splitFullName( full_name );
+  const HDFGID grp_id{ findGroup( split_name.first ) };
+  const HDFDID dataset_id{ H5Dopen2( grp_id, split_name.second.c_str(), H5P_DEFAULT ) };
+  if( dataset_id < 0 )
+  {
+    throw std::string{ "Failed to open HDF data set" };
+  }
+  const Eigen::ArrayXi dimensions{ getDimensions( dataset_id ) };
+  if( dimensions.size() != 2 )
+  {
+    throw std::string{ "Invalid dimensions for HDF data set with rows" };
+  }
+  if( nrows >= hsize_t( dimensions( 0 ) ) )
+  {
+    return;
+  }
+  const hsize_t new_dims[2] = { nrows, hsize_t( dimensions( 1 ) ) };
+  if( H5Dset_extent( dataset_id, new_dims ) < 0 )
+  {
+    throw std::string{ "Failed to truncate HDF data set" };
+  }
+}
+
+void HDF5File::createExtendibleDataSet( const std::string& full_name, const hid_t file_type, const hsize_t ncols, const hsize_t chunk_rows, const unsigned compression_level ) const
+{
+  assert( ncols > 0 ); assert( chunk_rows > 0 );
+  assert( compression_level <= 9 );
+
+  const auto split_name = splitFullName( full_name );
+
+  const hsize_t dims[2] = { 0, ncols };
+  const hsize_t max_dims[2] = { H5S_UNLIMITED, ncols };
+  const HDFSID dataspace_id{ H5Screate_simple( 2, dims, max_dims ) };
+  if( dataspace_id < 0 )
+  {
+    throw std::string{ "Failed to create HDF data space" };
+  }
+
+  // Extendible data sets must be chunked
+  const HDFPID property_id{ H5Pcreate( H5P_DATASET_CREATE ) };
+  if( property_id < 0 )
+  {
+    throw std::string{ "Failed to create HDF data set properties" };
+  }
+  const hsize_t chunk_dims[2] = { chunk_rows, ncols };
+  if( H5Pset_chunk( property_id, 2, chunk_dims ) < 0 )
+  {
+    throw std::string{ "Failed to set HDF chunk size" };
+  }
+  if( compression_level != 0 )
+  {
+    // Shuffling groups the bytes of each entry, which compresses better for slowly varying data
+    if( H5Pset_shuffle( property_id ) < 0 || H5Pset_deflate( property_id, compression_level ) < 0 )
+    {
+      throw std::string{ "Failed to set HDF compression" };
+    }
+  }
+
+  // Open the requested group
+  const HDFGID grp_id{ findOrCreateGroup( split_name.first ) };
+
+  const HDFDID dataset_id{ H5Dcreate2( grp_id, split_name.second.c_str(), file_type, dataspace_id, H5P_DEFAULT, property_id, H5P_DEFAULT ) };
+  if( dataset_id < 0 )
+  {
+    throw std::string{ "Failed to create HDF data set" };
+  }
+}
+
+hsize_t HDF5File::extendRows( const hid_t dataset_id, const hsize_t nrows, const hsize_t ncols )
+{
+  const Eigen::ArrayXi dimensions{ getDimensions( dataset_id ) };
+  if( dimensions.size() != 2 )
+  {
+    throw std::string{ "Invalid dimensions for HDF data set with rows" };
+  }
+  if( hsize_t( dimensions( 1 ) ) != ncols )
+  {
+    throw std::string{ "Appended rows do not match the column count of HDF data set" };
+  }
+  const hsize_t old_rows{ hsize_t( dimensions( 0 ) ) };
+  const hsize_t new_dims[2] = { old_rows + nrows, ncols };
+  if( H5Dset_extent( dataset_id, new_dims ) < 0 )
+  {
+    throw std::string{ "Failed to extend HDF data set" };
+  }
+  return old_rows;
+}
+
 void HDF5File::write( const std::string& full_name, const std::string& string_variable ) const
 {
   const auto split_name = splitFullName( full_name );
@@ -128,9 +305,15 @@ HDFID<H5Gclose> HDF5File::findOrCreateGroup( const std::string& group_name ) con
   {
     group_id = HDFGID{ H5Gopen2( m_hdf_file_id, "/", H5P_DEFAULT ) };
   }
-  else if( 0 == H5Lexists( m_hdf_file_id, group_name.c_str(), H5P_DEFAULT ) )
+  else if( !exists( group_name ) )
   {
-    group_id = HDFGID{ H5Gcreate2( m_hdf_file_id, group_name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT ) };
+    // Create any missing parent groups along with the requested group
+    const HDFPID link_property_id{ H5Pcreate( H5P_LINK_CREATE ) };
+    if( link_property_id < 0 || H5Pset_create_intermediate_group( link_property_id, 1 ) < 0 )
+    {
+      throw std::string{ "Failed to create HDF link properties" };
+    }
+    group_id = HDFGID{ H5Gcreate2( m_hdf_file_id, group_name.c_str(), link_property_id, H5P_DEFAULT, H5P_DEFAULT ) };
   }
   else
   {
@@ -1,7 +1,7 @@
 // HDF5File.h
 //
 // Breannan Smith
-// Last updated: 09/28/2015
+// Last updated: 10/19/2026
 
 // TODO: Store sparse matrix components in a struct to prevent polution of namespace
 // TODO: Support routines for users to create structs
@@ -12,7 +12,9 @@
 #ifndef HDF5_FILE_H
 #define HDF5_FILE_H
 
+#include <cstdint>
 #include <string>
+#include <vector>
 #include <Eigen/Core>
 #include <Eigen/Sparse>
 
@@ -88,6 +90,12 @@ namespace HDF5SupportedTypes
     return true;
   }
 
+  template<>
+  constexpr bool isSupportedEigenType<std::uint64_t>()
+  {
+    return true;
+  }
+
   template<>
   constexpr bool isSupportedEigenType<float>()
   {
@@ -104,7 +112,11 @@ namespace HDF5SupportedTypes
 enum class HDF5AccessType
 {
   READ_ONLY,
-  READ_WRITE
+  READ_WRITE,
+  // Opens an existing file for reading and writing without truncating it
+  READ_WRITE_EXISTING,
+  // Creates a file that is held in memory and never written to disk; see fileImage
+  IN_MEMORY
 };
 
 class HDF5File final
@@ -122,10 +134,28 @@ public:
 
   hid_t fileID();
 
+  // Native HDF5 type of ScalarType, e.g. for building compound types of scalar members
+  template<typename ScalarType>
+  static constexpr hid_t computeHDFType()
+  {
+    using std::is_same;
+    return is_same<ScalarType,double>::value ? H5T_NATIVE_DOUBLE : is_same<ScalarType,float>::value ? H5T_NATIVE_FLOAT : is_same<ScalarType,int>::value ? H5T_NATIVE_INT : is_same<ScalarType,unsigned>::value ? H5T_NATIVE_UINT : is_same<ScalarType,std::uint64_t>::value ? H5T_NATIVE_UINT64 : -1;
+  }
+
   void open( const std::string& file_name, const HDF5AccessType& access_type );
 
   bool is_open() const;
 
+  // Writes buffered data to disk so the file is readable while it remains open
+  void flush() const;
+
+  // Copies the contents of the file, as they would appear on disk, into image
+  void fileImage( std::vector<char>& image ) const;
+
+  bool exists( const std::string& full_name ) const;
+
+  void remove( const std::string& full_name ) const;
+
   HDFID<H5Gclose> findOrCreateGroup( const std::string& group_name ) const;
 
   HDFID<H5Gclose> findGroup( const std::string& group_name ) const;
@@ -150,7 +180,7 @@ public:
     using HDFDID = HDFID<H5Dclose>;
 
     using Scalar = typename Derived::Scalar;
-    static_assert( HDF5SupportedTypes::isSupportedEigenType<Scalar>(), "Error, scalar type of Eigen variable must be float, double, unsigned or integer" );
+    static_assert( HDF5SupportedTypes::isSupportedEigenType<Scalar>(), "Error, scalar type of Eigen variable must be float, double, unsigned, std::uint64_t or integer" );
 
     const auto split_name = splitFullName( full_name );
 
@@ -207,6 +237,93 @@ public:
     write( full_name + "_val", val );
   }
 
+  // Creates an empty two dimensional data set with ncols columns that grows along its rows. Entries are
+  // stored as FileScalar, converting on write, in chunks of chunk_rows rows that are deflated when
+  // compression_level is nonzero.
+  template<typename FileScalar>
+  void createExtendible( const std::string& full_name, const hsize_t ncols, const hsize_t chunk_rows, const unsigned compression_level ) const
+  {
+    static_assert( HDF5SupportedTypes::isSupportedEigenType<FileScalar>(), "Error, file type of extendible data set must be float, double, unsigned, std::uint64_t or integer" );
+    createExtendibleDataSet( full_name, computeHDFType<FileScalar>(), ncols, chunk_rows, compression_level );
+  }
+
+  template<typename Scalar>
+  typename std::enable_if<HDF5SupportedTypes::isSupportedEigenType<Scalar>()>::type
+  appendRows( const std::string& full_name, const Scalar& variable ) const
+  {
+    Eigen::Matrix<Scalar,1,1> output_mat;
+    output_mat << variable;
+    appendRows( full_name, output_mat );
+  }
+
+  // Appends the rows of eigen_variable to a data set created by createExtendible
+  template<typename Derived>
+  typename std::enable_if<!HDF5SupportedTypes::isSupportedEigenType<Derived>()>::type
+  appendRows( const std::string& full_name, const Eigen::DenseBase<Derived>& eigen_variable ) const
+  {
+    using HDFSID = HDFID<H5Sclose>;
+    using HDFGID = HDFID<H5Gclose>;
+    using HDFDID = HDFID<H5Dclose>;
+
+    using Scalar = typename Derived::Scalar;
+    static_assert( HDF5SupportedTypes::isSupportedEigenType<Scalar>(), "Error, scalar type of Eigen variable must be float, double, unsigned, std::uint64_t or integer" );
+
+    assert( eigen_variable.rows() >= 0 ); assert( eigen_variable.cols() >= 0 );
+    if( eigen_variable.rows() == 0 )
+    {
+      return;
+    }
+
+    const auto split_name = splitFullName( full_name );
+
+    // Open the requested group
+    const HDFGID grp_id{ findGroup( split_name.first ) };
+
+    const HDFDID dataset_id{ H5Dopen2( grp_id, split_name.second.c_str(), H5P_DEFAULT ) };
+    if( dataset_id < 0 )
+    {
+      throw std::string{ "Failed to open HDF data set" };
+    }
+
+    // Grow the data set and select the new rows
+    const hsize_t start[2] = { extendRows( dataset_id, hsize_t( eigen_variable.rows() ), hsize_t( eigen_variable.cols() ) ), 0 };
+    const hsize_t count[2] = { hsize_t( eigen_variable.rows() ), hsize_t( eigen_variable.cols() ) };
+    const HDFSID file_space_id{ H5Dget_space( dataset_id ) };
+    if( file_space_id < 0 )
+    {
+      throw std::string{ "Failed to open data space" };
+    }
+    if( H5Sselect_hyperslab( file_space_id, H5S_SELECT_SET, start, nullptr, count, nullptr ) < 0 )
+    {
+      throw std::string{ "Failed to select HDF hyperslab" };
+    }
+    const HDFSID memory_space_id{ H5Screate_simple( 2, count, nullptr ) };
+    if( memory_space_id < 0 )
+    {
+      throw std::string{ "Failed to create HDF data space" };
+    }
+
+    // Convert to row major format, if needed
+    Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> col_major_output_data;
+    if( isColumnMajor<Derived>() )
+    {
+      col_major_output_data.resize( eigen_variable.rows(), eigen_variable.cols() );
+      col_major_output_data = eigen_variable.derived().matrix();
+    }
+
+    const herr_t status_write{ H5Dwrite( dataset_id, computeHDFType<Scalar>(), memory_space_id, file_space_id, H5P_DEFAULT, isColumnMajor<Derived>() ? col_major_output_data.data() : eigen_variable.derived().data() ) };
+    if( status_write < 0 )
+    {
+      throw std::string{ "Failed to write HDF data" };
+    }
+  }
+
+  // Number of rows in a two dimensional data set
+  hsize_t numRows( const std::string& full_name ) const;
+
+  // Discards all rows of an extendible data set past the first nrows
+  void truncateRows( const std::string& full_name, const hsize_t nrows ) const;
+
   template<typename Scalar>
   typename std::enable_if<HDF5SupportedTypes::isSupportedEigenType<Scalar>(),Scalar>::type
   read( const std::string& full_name ) const
@@ -222,7 +339,7 @@ public:
     using HDFGID = HDFID<H5Gclose>;
 
     using Scalar = typename T::Scalar;
-    static_assert( HDF5SupportedTypes::isSupportedEigenType<Scalar>(), "Error, scalar type of Eigen variable must be float, double, unsigned or integer" );
+    static_assert( HDF5SupportedTypes::isSupportedEigenType<Scalar>(), "Error, scalar type of Eigen variable must be float, double, unsigned, std::uint64_t or integer" );
 
     T eigen_variable;
 
@@ -348,6 +465,11 @@ public:
 
 private:
 
+  void createExtendibleDataSet( const std::string& full_name, const hid_t file_type, const hsize_t ncols, const hsize_t chunk_rows, const unsigned compression_level ) const;
+
+  // Grows an extendible data set by nrows rows, returning the previous row count
+  static hsize_t extendRows( const hid_t dataset_id, const hsize_t nrows, const hsize_t ncols );
+
   template<typename Derived>
   static void extractDataCCS( const Eigen::SparseMatrixBase<Derived>& A, Eigen::Matrix<typename Derived::Index,Eigen::Dynamic,1>& outer_ptr, Eigen::Matrix<typename Derived::Index,Eigen::Dynamic,1>& inner_ptr, Eigen::Matrix<typename Derived::Scalar,Eigen::Dynamic,1>& val )
   {
@@ -381,6 +503,10 @@ private:
     {
       return H5T_NATIVE_UINT;
     }
+    else if( H5Tequal( dtype_id, H5T_NATIVE_UINT64 ) > 0 )
+    {
+      return H5T_NATIVE_UINT64;
+    }
     else return -1;
   }
 
@@ -416,13 +542,6 @@ private:
     return dimensions;
   }
 
-  template<typename ScalarType>
-  static constexpr hid_t computeHDFType()
-  {
-    using std::is_same;
-    return is_same<ScalarType,double>::value ? H5T_NATIVE_DOUBLE : is_same<ScalarType,float>::value ? H5T_NATIVE_FLOAT : is_same<ScalarType,int>::value ? H5T_NATIVE_INT : is_same<ScalarType,unsigned>::value ? H5T_NATIVE_UINT : -1;
-  }
-
   template<typename Derived>
   static constexpr bool isColumnMajor()
   {
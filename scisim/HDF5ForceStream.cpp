@@ -0,0 +1,203 @@
+// HDF5ForceStream.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "HDF5ForceStream.h"
+
+#include "scisim/ConstrainedMaps/ImpactMaps/ImpactSolution.h"
+
+#include <algorithm>
+#include <initializer_list>
+
+// Number of contacts in each chunk of the contact data sets
+static constexpr hsize_t CONTACT_CHUNK_ROWS{ 16384 };
+// Number of rows in each chunk of the per-frame index
+static constexpr hsize_t FRAME_INDEX_CHUNK_ROWS{ 1024 };
+// Wall clock time between flushes of appended frames
+static constexpr std::chrono::seconds FLUSH_INTERVAL{ 10 };
+
+using VectorXu64 = Eigen::Matrix<std::uint64_t,Eigen::Dynamic,1>;
+
+HDF5ForceStream::HDF5ForceStream()
+: m_file()
+, m_num_frames( 0 )
+, m_num_contacts( 0 )
+, m_ambient_space_dims( 0 )
+, m_single_precision( false )
+, m_force_threshold( 0.0 )
+, m_stored_contacts()
+, m_last_flush()
+{}
+
+void HDF5ForceStream::create( const std::string& file_name, const unsigned ambient_space_dims, const bool single_precision, const unsigned compression_level, const scalar& force_threshold )
+{
+  assert( ambient_space_dims == 2 || ambient_space_dims == 3 );
+  assert( compression_level <= 9 );
+  assert( force_threshold >= 0.0 );
+
+  m_file.open( file_name, HDF5AccessType::READ_WRITE );
+  m_num_frames = 0;
+  m_num_contacts = 0;
+  m_ambient_space_dims = ambient_space_dims;
+  m_single_precision = single_precision;
+  m_force_threshold = force_threshold;
+
+  // Record the storage settings so appended frames match after a resume
+  m_file.write( "storage/ambient_space_dimensions", ambient_space_dims );
+  m_file.write( "storage/single_precision", unsigned( single_precision ? 1 : 0 ) );
+  m_file.write( "storage/compression_level", compression_level );
+  m_file.write( "storage/force_threshold", double( force_threshold ) );
+
+  m_file.createExtendible<unsigned>( "frames/iteration", 1, FRAME_INDEX_CHUNK_ROWS, 0 );
+  m_file.createExtendible<double>( "frames/time", 1, FRAME_INDEX_CHUNK_ROWS, 0 );
+  m_file.createExtendible<double>( "frames/timestep", 1, FRAME_INDEX_CHUNK_ROWS, 0 );
+  m_file.createExtendible<std::uint64_t>( "frames/contact_end", 1, FRAME_INDEX_CHUNK_ROWS, 0 );
+
+  m_file.createExtendible<int>( "contacts/indices", 2, CONTACT_CHUNK_ROWS, compression_level );
+  for( const char* name : { "contacts/points", "contacts/normals", "contacts/forces" } )
+  {
+    if( single_precision )
+    {
+      m_file.createExtendible<float>( name, ambient_space_dims, CONTACT_CHUNK_ROWS, compression_level );
+    }
+    else
+    {
+      m_file.createExtendible<double>( name, ambient_space_dims, CONTACT_CHUNK_ROWS, compression_level );
+    }
+  }
+  flush();
+}
+
+void HDF5ForceStream::reopen( const std::string& file_name, const unsigned iteration )
+{
+  m_file.open( file_name, HDF5AccessType::READ_WRITE_EXISTING );
+
+  m_ambient_space_dims = m_file.read<unsigned>( "storage/ambient_space_dimensions" );
+  m_single_precision = m_file.read<unsigned>( "storage/single_precision" ) != 0;
+  m_force_threshold = scalar( m_file.read<double>( "storage/force_threshold" ) );
+
+  // Discard frames saved at or after the point of resumption
+  m_num_frames = 0;
+  if( m_file.numRows( "frames/iteration" ) != 0 )
+  {
+    const VectorXu iterations{ m_file.read<VectorXu>( "frames/iteration" ) };
+    m_num_frames = unsigned( std::lower_bound( iterations.data(), iterations.data() + iterations.size(), iteration ) - iterations.data() );
+  }
+  for( const char* name : { "frames/iteration", "frames/time", "frames/timestep", "frames/contact_end" } )
+  {
+    m_file.truncateRows( name, m_num_frames );
+  }
+
+  m_num_contacts = m_num_frames == 0 ? 0 : m_file.read<VectorXu64>( "frames/contact_end" )( m_num_frames - 1 );
+  for( const char* name : { "contacts/indices", "contacts/points", "contacts/normals", "contacts/forces" } )
+  {
+    m_file.truncateRows( name, m_num_contacts );
+  }
+  flush();
+}
+
+bool HDF5ForceStream::is_open() const
+{
+  return m_file.is_open();
+}
+
+unsigned HDF5ForceStream::numFrames() const
+{
+  return m_num_frames;
+}
+
+HDF5File& HDF5ForceStream::file()
+{
+  return m_file;
+}
+
+void HDF5ForceStream::flush()
+{
+  assert( m_file.is_open() );
+  m_file.flush();
+  m_last_flush = std::chrono::steady_clock::now();
+}
+
+void HDF5ForceStream::close()
+{
+  if( m_file.is_open() )
+  {
+    m_file.flush();
+    m_file = HDF5File{};
+  }
+}
+
+template<typename FileScalar>
+void HDF5ForceStream::appendContacts( const ImpactSolution& impact_solution )
+{
+  using RowMatrix = Eigen::Matrix<FileScalar,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>;
+
+  const Eigen::Index num_stored{ Eigen::Index( m_stored_contacts.size() ) };
+  Eigen::Matrix<int,Eigen::Dynamic,2,Eigen::RowMajor> indices{ num_stored, 2 };
+  RowMatrix points{ num_stored, m_ambient_space_dims };
+  RowMatrix normals{ num_stored, m_ambient_space_dims };
+  RowMatrix forces{ num_stored, m_ambient_space_dims };
+  for( Eigen::Index row = 0; row < num_stored; ++row )
+  {
+    const unsigned con{ m_stored_contacts[row] };
+    indices.row( row ) = impact_solution.indices().col( con ).transpose();
+    points.row( row ) = impact_solution.points().col( con ).transpose().template cast<FileScalar>();
+    normals.row( row ) = impact_solution.normals().col( con ).transpose().template cast<FileScalar>();
+    forces.row( row ) = impact_solution.forces().col( con ).transpose().template cast<FileScalar>();
+  }
+
+  m_file.appendRows( "contacts/indices", indices );
+  m_file.appendRows( "contacts/points", points );
+  m_file.appendRows( "contacts/normals", normals );
+  m_file.appendRows( "contacts/forces", forces );
+}
+
+void HDF5ForceStream::appendFrame( const unsigned iteration, const scalar& time, const scalar& timestep, const ImpactSolution& impact_solution )
+{
+  assert( m_file.is_open() );
+
+  // Select the contacts to store
+  m_stored_contacts.clear();
+  const unsigned ncons{ impact_solution.numContacts() };
+  if( ncons != 0 )
+  {
+    if( unsigned( impact_solution.forces().rows() ) != m_ambient_space_dims )
+    {
+      throw std::string{ "Contact forces do not match the dimension of the force file" };
+    }
+    for( unsigned con = 0; con < ncons; ++con )
+    {
+      if( impact_solution.forces().col( con ).norm() >= m_force_threshold )
+      {
+        m_stored_contacts.emplace_back( con );
+      }
+    }
+  }
+
+  if( !m_stored_contacts.empty() )
+  {
+    if( m_single_precision )
+    {
+      appendContacts<float>( impact_solution );
+    }
+    else
+    {
+      appendContacts<double>( impact_solution );
+    }
+    m_num_contacts += m_stored_contacts.size();
+  }
+
+  m_file.appendRows( "frames/iteration", iteration );
+  m_file.appendRows( "frames/time", double( time ) );
+  m_file.appendRows( "frames/timestep", double( timestep ) );
+  m_file.appendRows( "frames/contact_end", m_num_contacts );
+
+  ++m_num_frames;
+
+  // An interrupted run loses at most the frames appended since the last flush
+  if( std::chrono::steady_clock::now() - m_last_flush >= FLUSH_INTERVAL )
+  {
+    flush();
+  }
+}
@@ -0,0 +1,74 @@
+// HDF5ForceStream.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Stores the contact forces of an entire simulation in a single HDF5 file. The contacts of every frame are
+// appended as rows of chunked, extendible data sets, and a per-frame index records where each frame's
+// contacts end. Contacts whose force magnitude falls below a threshold can be dropped. Layout:
+//   frames/iteration, frames/time, frames/timestep : one row per frame
+//   frames/contact_end                             : end of each frame's rows in the contact data sets, 64 bit
+//   contacts/indices                               : body indices of each contact, as in ImpactSolution
+//   contacts/points, contacts/normals              : world space point and normal of each contact
+//   contacts/forces                                : world space force of each contact
+
+#ifndef HDF5_FORCE_STREAM_H
+#define HDF5_FORCE_STREAM_H
+
+#include "scisim/HDF5File.h"
+#include "scisim/Math/MathDefines.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+class ImpactSolution;
+
+class HDF5ForceStream final
+{
+
+public:
+
+  HDF5ForceStream();
+
+  // Creates a new force file, replacing any existing file. If single_precision is set points, normals,
+  // and forces are stored as float; compression_level is a deflate level in [0,9], with 0 disabling
+  // compression. Contacts with a force magnitude below force_threshold are not stored.
+  void create( const std::string& file_name, const unsigned ambient_space_dims, const bool single_precision, const unsigned compression_level, const scalar& force_threshold );
+
+  // Opens an existing force file and discards all frames from iteration onwards
+  void reopen( const std::string& file_name, const unsigned iteration );
+
+  bool is_open() const;
+
+  unsigned numFrames() const;
+
+  HDF5File& file();
+
+  // Frames are written to disk periodically; flush makes every appended frame readable
+  void flush();
+
+  // Flushes and closes the file
+  void close();
+
+  void appendFrame( const unsigned iteration, const scalar& time, const scalar& timestep, const ImpactSolution& impact_solution );
+
+private:
+
+  template<typename FileScalar>
+  void appendContacts( const ImpactSolution& impact_solution );
+
+  HDF5File m_file;
+  unsigned m_num_frames;
+  // Contacts accumulate over every frame of a run, so 32 bit counts can overflow
+  std::uint64_t m_num_contacts;
+  unsigned m_ambient_space_dims;
+  bool m_single_precision;
+  scalar m_force_threshold;
+  // Columns of the current frame's solution that are stored
+  std::vector<unsigned> m_stored_contacts;
+  std::chrono::steady_clock::time_point m_last_flush;
+
+};
+
+#endif
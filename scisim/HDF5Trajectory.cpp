@@ -0,0 +1,250 @@
+// HDF5Trajectory.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "HDF5Trajectory.h"
+
+#include <algorithm>
+#include <initializer_list>
+
+// Target number of entries in each chunk of q and v, about half a megabyte of doubles
+static constexpr hsize_t TRAJECTORY_CHUNK_ENTRIES{ 65536 };
+// Number of rows in each chunk of the per-frame index
+static constexpr hsize_t FRAME_INDEX_CHUNK_ROWS{ 1024 };
+// Wall clock time between flushes of appended frames
+static constexpr std::chrono::seconds FLUSH_INTERVAL{ 10 };
+
+HDF5Trajectory::HDF5Trajectory()
+: m_file()
+, m_num_frames( 0 )
+, m_num_segments( 0 )
+, m_segment_ndof( 0 )
+, m_segment_nstatic( 0 )
+, m_segment_nbodies( 0 )
+, m_segment_rows( 0 )
+, m_timestep_history_size( 0 )
+, m_last_flush()
+{}
+
+void HDF5Trajectory::create( const std::string& file_name, const bool single_precision, const unsigned compression_level )
+{
+  assert( compression_level <= 9 );
+
+  m_file.open( file_name, HDF5AccessType::READ_WRITE );
+  m_num_frames = 0;
+  m_num_segments = 0;
+  m_segment_ndof = 0;
+  m_segment_nstatic = 0;
+  m_segment_nbodies = 0;
+  m_segment_rows = 0;
+  m_timestep_history_size = 0;
+
+  // Record the storage settings so new segments match after a resume
+  m_file.write( "storage/single_precision", unsigned( single_precision ? 1 : 0 ) );
+  m_file.write( "storage/compression_level", compression_level );
+
+  m_file.createExtendible<unsigned>( "frames/iteration", 1, FRAME_INDEX_CHUNK_ROWS, 0 );
+  m_file.createExtendible<double>( "frames/time", 1, FRAME_INDEX_CHUNK_ROWS, 0 );
+  m_file.createExtendible<double>( "frames/timestep", 1, FRAME_INDEX_CHUNK_ROWS, 0 );
+  m_file.createExtendible<unsigned>( "frames/segment", 1, FRAME_INDEX_CHUNK_ROWS, 0 );
+  m_file.createExtendible<unsigned>( "frames/row", 1, FRAME_INDEX_CHUNK_ROWS, 0 );
+  m_file.createExtendible<unsigned>( "frames/timestep_history_end", 1, FRAME_INDEX_CHUNK_ROWS, 0 );
+  m_file.createExtendible<double>( "timestep_history", 1, FRAME_INDEX_CHUNK_ROWS, compression_level );
+  flush();
+}
+
+void HDF5Trajectory::reopen( const std::string& file_name, const unsigned num_frames )
+{
+  m_file.open( file_name, HDF5AccessType::READ_WRITE_EXISTING );
+
+  if( hsize_t( num_frames ) > m_file.numRows( "frames/iteration" ) )
+  {
+    throw std::string{ "Trajectory file " } + file_name + std::string{ " has fewer frames than the resumed simulation" };
+  }
+
+  // Discard frames written after the point of resumption
+  for( const char* name : { "frames/iteration", "frames/time", "frames/timestep", "frames/segment", "frames/row", "frames/timestep_history_end" } )
+  {
+    m_file.truncateRows( name, num_frames );
+  }
+  m_num_frames = num_frames;
+
+  unsigned last_segment{ 0 };
+  if( num_frames == 0 )
+  {
+    m_num_segments = 0;
+    m_segment_ndof = 0;
+    m_segment_nstatic = 0;
+    m_segment_nbodies = 0;
+    m_segment_rows = 0;
+    m_timestep_history_size = 0;
+  }
+  else
+  {
+    last_segment = m_file.read<VectorXu>( "frames/segment" )( num_frames - 1 );
+    m_num_segments = last_segment + 1;
+    m_segment_rows = m_file.read<VectorXu>( "frames/row" )( num_frames - 1 ) + 1;
+    m_timestep_history_size = m_file.read<VectorXu>( "frames/timestep_history_end" )( num_frames - 1 );
+    const std::string segment_name{ segmentName( last_segment ) };
+    m_segment_ndof = m_file.read<unsigned>( segment_name + "/ndof" );
+    m_segment_nstatic = m_file.read<unsigned>( segment_name + "/nstatic" );
+    m_segment_nbodies = m_file.read<unsigned>( segment_name + "/nbodies" );
+    if( m_segment_ndof != 0 )
+    {
+      m_file.truncateRows( segment_name + "/q", m_segment_rows );
+      m_file.truncateRows( segment_name + "/v", m_segment_rows );
+    }
+    if( m_segment_nstatic != 0 )
+    {
+      m_file.truncateRows( segment_name + "/static_geometry", m_segment_rows );
+    }
+    if( m_segment_nbodies != 0 )
+    {
+      m_file.truncateRows( segment_name + "/kinematically_scripted", m_segment_rows );
+    }
+  }
+  m_file.truncateRows( "timestep_history", m_timestep_history_size );
+
+  // Remove any segments started after the point of resumption
+  for( unsigned segment = m_num_segments; m_file.exists( segmentName( segment ) ); ++segment )
+  {
+    m_file.remove( segmentName( segment ) );
+  }
+  flush();
+}
+
+bool HDF5Trajectory::is_open() const
+{
+  return m_file.is_open();
+}
+
+unsigned HDF5Trajectory::numFrames() const
+{
+  return m_num_frames;
+}
+
+void HDF5Trajectory::flush()
+{
+  assert( m_file.is_open() );
+  m_file.flush();
+  m_last_flush = std::chrono::steady_clock::now();
+}
+
+void HDF5Trajectory::close()
+{
+  if( m_file.is_open() )
+  {
+    m_file.flush();
+    m_file = HDF5File{};
+  }
+}
+
+bool HDF5Trajectory::needsNewSegment( const unsigned ndof, const unsigned nstatic, const unsigned nbodies ) const
+{
+  return m_num_segments == 0 || ndof != m_segment_ndof || nstatic != m_segment_nstatic || nbodies != m_segment_nbodies;
+}
+
+std::string HDF5Trajectory::beginSegment( const unsigned ndof, const unsigned nstatic, const unsigned nbodies )
+{
+  assert( m_file.is_open() );
+
+  const std::string segment_name{ segmentName( m_num_segments ) };
+  m_file.write( segment_name + "/ndof", ndof );
+  m_file.write( segment_name + "/nstatic", nstatic );
+  m_file.write( segment_name + "/nbodies", nbodies );
+  // Data sets must have a nonzero number of columns, so empty frames only record a row count
+  if( ndof != 0 )
+  {
+    createScalarFrameData( segment_name + "/q", ndof );
+    createScalarFrameData( segment_name + "/v", ndof );
+  }
+  if( nstatic != 0 )
+  {
+    createScalarFrameData( segment_name + "/static_geometry", nstatic );
+  }
+  if( nbodies != 0 )
+  {
+    const unsigned compression_level{ m_file.read<unsigned>( "storage/compression_level" ) };
+    const hsize_t chunk_rows{ std::max( hsize_t( 1 ), TRAJECTORY_CHUNK_ENTRIES / hsize_t( nbodies ) ) };
+    m_file.createExtendible<unsigned>( segment_name + "/kinematically_scripted", nbodies, chunk_rows, compression_level );
+  }
+
+  ++m_num_segments;
+  m_segment_ndof = ndof;
+  m_segment_nstatic = nstatic;
+  m_segment_nbodies = nbodies;
+  m_segment_rows = 0;
+
+  return segment_name + "/static";
+}
+
+HDF5File& HDF5Trajectory::file()
+{
+  return m_file;
+}
+
+void HDF5Trajectory::appendFrame( const unsigned iteration, const scalar& time, const scalar& timestep, const std::vector<scalar>& timestep_history, const VectorXs& q, const VectorXs& v, const VectorXs& static_geometry, const VectorXu& kinematically_scripted )
+{
+  assert( m_file.is_open() );
+  assert( m_num_segments > 0 );
+  assert( q.size() == m_segment_ndof );
+  assert( v.size() == q.size() );
+  assert( static_geometry.size() == m_segment_nstatic );
+  assert( kinematically_scripted.size() == m_segment_nbodies );
+
+  const std::string segment_name{ segmentName( m_num_segments - 1 ) };
+  if( m_segment_ndof != 0 )
+  {
+    m_file.appendRows( segment_name + "/q", q.transpose() );
+    m_file.appendRows( segment_name + "/v", v.transpose() );
+  }
+  if( m_segment_nstatic != 0 )
+  {
+    m_file.appendRows( segment_name + "/static_geometry", static_geometry.transpose() );
+  }
+  if( m_segment_nbodies != 0 )
+  {
+    m_file.appendRows( segment_name + "/kinematically_scripted", kinematically_scripted.transpose() );
+  }
+
+  m_file.appendRows( "timestep_history", Eigen::Map<const VectorXs>{ timestep_history.data(), long( timestep_history.size() ) } );
+  m_timestep_history_size += unsigned( timestep_history.size() );
+
+  m_file.appendRows( "frames/iteration", iteration );
+  m_file.appendRows( "frames/time", double( time ) );
+  m_file.appendRows( "frames/timestep", double( timestep ) );
+  m_file.appendRows( "frames/segment", m_num_segments - 1 );
+  m_file.appendRows( "frames/row", m_segment_rows );
+  m_file.appendRows( "frames/timestep_history_end", m_timestep_history_size );
+
+  ++m_segment_rows;
+  ++m_num_frames;
+
+  // Keep the file readable if the simulation is interrupted without flushing after every frame
+  if( std::chrono::steady_clock::now() - m_last_flush >= FLUSH_INTERVAL )
+  {
+    flush();
+  }
+}
+
+std::string HDF5Trajectory::segmentName( const unsigned segment )
+{
+  return "segments/" + std::to_string( segment );
+}
+
+void HDF5Trajectory::createScalarFrameData( const std::string& name, const unsigned ncols )
+{
+  assert( ncols != 0 );
+  const bool single_precision{ m_file.read<unsigned>( "storage/single_precision" ) != 0 };
+  const unsigned compression_level{ m_file.read<unsigned>( "storage/compression_level" ) };
+  const hsize_t chunk_rows{ std::max( hsize_t( 1 ), TRAJECTORY_CHUNK_ENTRIES / hsize_t( ncols ) ) };
+  if( single_precision )
+  {
+    m_file.createExtendible<float>( name, ncols, chunk_rows, compression_level );
+  }
+  else
+  {
+    m_file.createExtendible<double>( name, ncols, chunk_rows, compression_level );
+  }
+}
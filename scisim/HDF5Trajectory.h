@@ -0,0 +1,84 @@
+// HDF5Trajectory.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Stores an entire simulation in a single HDF5 file. Data that does not change between frames is written
+// once per segment, and the configuration, velocity, scripted static geometry, and kinematically scripted
+// flags of each frame are appended as rows of chunked, extendible data sets. A new segment begins whenever
+// the number of degrees of freedom, static geometry entries, or bodies changes (e.g. a script inserts or
+// deletes bodies or planes). Layout:
+//   frames/iteration, frames/time, frames/timestep : one row per frame
+//   frames/segment, frames/row                     : segment of each frame and its row in the segment
+//   frames/timestep_history_end                    : end of each frame's entries in timestep_history
+//   timestep_history                               : timestep of every step taken
+//   segments/N/static                              : data written once for segment N
+//   segments/N/q, segments/N/v                     : one row per frame in segment N
+//   segments/N/static_geometry                     : one row of the simulation's static geometry state per frame
+//   segments/N/kinematically_scripted              : one row per frame, 1 for bodies the simulation held fixed
+
+#ifndef HDF5_TRAJECTORY_H
+#define HDF5_TRAJECTORY_H
+
+#include "scisim/HDF5File.h"
+#include "scisim/Math/MathDefines.h"
+
+#include <chrono>
+#include <vector>
+
+class HDF5Trajectory final
+{
+
+public:
+
+  HDF5Trajectory();
+
+  // Creates a new trajectory file, replacing any existing file. If single_precision is set q and v are
+  // stored as float; compression_level is a deflate level in [0,9], with 0 disabling compression.
+  void create( const std::string& file_name, const bool single_precision, const unsigned compression_level );
+
+  // Opens an existing trajectory file and discards all frames past the first num_frames
+  void reopen( const std::string& file_name, const unsigned num_frames );
+
+  bool is_open() const;
+
+  unsigned numFrames() const;
+
+  // Writes any buffered frames to disk, e.g. before a checkpoint that a resumed run will reopen the file from
+  void flush();
+
+  // Writes any buffered frames to disk and closes the file
+  void close();
+
+  // True if a frame with ndof degrees of freedom, nstatic static geometry entries, and nbodies bodies must start a new segment
+  bool needsNewSegment( const unsigned ndof, const unsigned nstatic, const unsigned nbodies ) const;
+
+  // Starts a new segment for such frames and returns the group that the segment's static data should be written to
+  std::string beginSegment( const unsigned ndof, const unsigned nstatic, const unsigned nbodies );
+
+  HDF5File& file();
+
+  // Frames are flushed to disk at most every few seconds of wall clock time, so an interrupted run loses at most the last few frames
+  void appendFrame( const unsigned iteration, const scalar& time, const scalar& timestep, const std::vector<scalar>& timestep_history, const VectorXs& q, const VectorXs& v, const VectorXs& static_geometry, const VectorXu& kinematically_scripted );
+
+private:
+
+  static std::string segmentName( const unsigned segment );
+
+  // Creates an extendible data set of the file's storage precision with ncols columns and one row per frame
+  void createScalarFrameData( const std::string& name, const unsigned ncols );
+
+  HDF5File m_file;
+  unsigned m_num_frames;
+  // Number of segments, the last of which receives new frames
+  unsigned m_num_segments;
+  unsigned m_segment_ndof;
+  unsigned m_segment_nstatic;
+  unsigned m_segment_nbodies;
+  unsigned m_segment_rows;
+  unsigned m_timestep_history_size;
+  std::chrono::steady_clock::time_point m_last_flush;
+
+};
+
+#endif
@@ -30,6 +30,39 @@ namespace MathUtilities
   // Checks if the the three vectors when stacked as [ a b c ] form an orthonormal matrix with positive determinant
   bool isRightHandedOrthoNormal( const Vector3s& a, const Vector3s& b, const Vector3s& c, const scalar& tol );
 
+  // Earliest fraction of a step in [0,1] at which two spheres, whose centers move linearly from the start to the
+  // end positions over the step, touch; infinity if they do not touch during the step
+  template <int N>
+  scalar sphereSphereTimeOfImpact( const Eigen::Matrix<scalar,N,1>& x0_start, const Eigen::Matrix<scalar,N,1>& x1_start, const Eigen::Matrix<scalar,N,1>& x0_end, const Eigen::Matrix<scalar,N,1>& x1_end, const scalar& r0, const scalar& r1 )
+  {
+    assert( r0 > 0.0 ); assert( r1 > 0.0 );
+
+    // Separation of the centers, assuming both move linearly over the step
+    const Eigen::Matrix<scalar,N,1> d{ x0_start - x1_start };
+    const Eigen::Matrix<scalar,N,1> e{ ( x0_end - x1_end ) - d };
+    const scalar c{ d.squaredNorm() - ( r0 + r1 ) * ( r0 + r1 ) };
+    if( c <= 0.0 )
+    {
+      return 0.0;
+    }
+    const scalar b{ d.dot( e ) };
+    const scalar a{ e.squaredNorm() };
+    // Only approaching spheres can collide
+    if( b >= 0.0 || a == 0.0 )
+    {
+      return SCALAR_INFINITY;
+    }
+    const scalar discriminant{ b * b - a * c };
+    if( discriminant < 0.0 )
+    {
+      return SCALAR_INFINITY;
+    }
+    // First root of |d + t e|^2 = (r0 + r1)^2
+    const scalar t{ ( - b - sqrt( discriminant ) ) / a };
+    assert( t >= 0.0 );
+    return t <= 1.0 ? t : SCALAR_INFINITY;
+  }
+
   // SPARSE MATRIX
 
   bool isSquare( const SparseMatrixsc& matrix );
@@ -9,24 +9,24 @@
 
 ScriptingCallback::~ScriptingCallback() = default;
 
-void ScriptingCallback::restitutionCoefficientCallback( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor )
+void ScriptingCallback::restitutionCoefficientCallback( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor )
 {
   if( name().empty() )
   {
     return;
   }
-  restitutionCoefficient( active_set, cor );
+  restitutionCoefficient( q, active_set, cor );
   assert( ( cor.array() >= 0.0 ).all() );
   assert( ( cor.array() <= 1.0 ).all() );
 }
 
-void ScriptingCallback::frictionCoefficientCallback( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu )
+void ScriptingCallback::frictionCoefficientCallback( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu )
 {
   if( name().empty() )
   {
     return;
   }
-  frictionCoefficient( active_set, mu );
+  frictionCoefficient( q, active_set, mu );
   assert( ( mu.array() >= 0.0 ).all() );
 }
 
@@ -25,9 +25,9 @@ public:
 
   virtual ~ScriptingCallback() = 0;
 
-  void restitutionCoefficientCallback( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor );
+  void restitutionCoefficientCallback( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor );
 
-  void frictionCoefficientCallback( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu );
+  void frictionCoefficientCallback( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu );
 
   void startOfSimCallback();
 
@@ -43,9 +43,9 @@ protected:
 
 private:
 
-  virtual void restitutionCoefficient( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor ) = 0;
+  virtual void restitutionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& cor ) = 0;
 
-  virtual void frictionCoefficient( const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu ) = 0;
+  virtual void frictionCoefficient( const VectorXs& q, const std::vector<std::unique_ptr<Constraint>>& active_set, VectorXs& mu ) = 0;
 
   virtual void startOfSim() = 0;
 
@@ -0,0 +1,301 @@
+// SleepingIslands.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "SleepingIslands.h"
+
+#include "scisim/Constraints/Constraint.h"
+#include "scisim/Utilities.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <set>
+
+static constexpr unsigned INVALID_ISLAND{ std::numeric_limits<unsigned>::max() };
+
+SleepingIslands::SleepingIslands()
+: m_linear_velocity_threshold( 0.0 )
+, m_kinetic_energy_threshold( 0.0 )
+, m_time_to_sleep( SCALAR_INFINITY )
+, m_asleep()
+, m_rest_time()
+, m_island()
+, m_next_island( 0 )
+, m_contacts()
+{}
+
+SleepingIslands::SleepingIslands( const scalar& linear_velocity_threshold, const scalar& kinetic_energy_threshold, const scalar& time_to_sleep )
+: m_linear_velocity_threshold( linear_velocity_threshold )
+, m_kinetic_energy_threshold( kinetic_energy_threshold )
+, m_time_to_sleep( time_to_sleep )
+, m_asleep()
+, m_rest_time()
+, m_island()
+, m_next_island( 0 )
+, m_contacts()
+{
+  assert( m_linear_velocity_threshold >= 0.0 );
+  assert( m_kinetic_energy_threshold >= 0.0 );
+  assert( m_time_to_sleep > 0.0 );
+}
+
+SleepingIslands::SleepingIslands( std::istream& input_stream )
+: m_linear_velocity_threshold( Utilities::deserialize<scalar>( input_stream ) )
+, m_kinetic_energy_threshold( Utilities::deserialize<scalar>( input_stream ) )
+, m_time_to_sleep( Utilities::deserialize<scalar>( input_stream ) )
+, m_asleep( Utilities::deserializeVector<bool>( input_stream ) )
+, m_rest_time( Utilities::deserializeVector<scalar>( input_stream ) )
+, m_island( Utilities::deserializeVector<unsigned>( input_stream ) )
+, m_next_island( Utilities::deserialize<unsigned>( input_stream ) )
+, m_contacts()
+{
+  assert( m_asleep.size() == m_rest_time.size() );
+  assert( m_asleep.size() == m_island.size() );
+}
+
+bool SleepingIslands::enabled() const
+{
+  return m_time_to_sleep != SCALAR_INFINITY;
+}
+
+const scalar& SleepingIslands::linearVelocityThreshold() const
+{
+  return m_linear_velocity_threshold;
+}
+
+const scalar& SleepingIslands::kineticEnergyThreshold() const
+{
+  return m_kinetic_energy_threshold;
+}
+
+const scalar& SleepingIslands::timeToSleep() const
+{
+  return m_time_to_sleep;
+}
+
+unsigned SleepingIslands::nbodies() const
+{
+  return unsigned( m_asleep.size() );
+}
+
+void SleepingIslands::resize( const unsigned nbodies )
+{
+  m_asleep.resize( nbodies, false );
+  m_rest_time.resize( nbodies, 0.0 );
+  m_island.resize( nbodies, INVALID_ISLAND );
+}
+
+void SleepingIslands::removeBodies( const Eigen::Ref<const VectorXu>& indices )
+{
+  if( indices.size() == 0 )
+  {
+    return;
+  }
+
+  std::vector<bool> remove( m_asleep.size(), false );
+  for( int idx = 0; idx < indices.size(); ++idx )
+  {
+    assert( indices( idx ) < remove.size() );
+    remove[ indices( idx ) ] = true;
+  }
+
+  std::vector<bool>::size_type copy_to{ 0 };
+  for( std::vector<bool>::size_type copy_from = 0; copy_from < remove.size(); ++copy_from )
+  {
+    if( remove[copy_from] )
+    {
+      continue;
+    }
+    m_asleep[copy_to] = m_asleep[copy_from];
+    m_rest_time[copy_to] = m_rest_time[copy_from];
+    m_island[copy_to] = m_island[copy_from];
+    ++copy_to;
+  }
+  m_asleep.resize( copy_to );
+  m_rest_time.resize( copy_to );
+  m_island.resize( copy_to );
+
+  // Body indices in the contact graph are no longer valid
+  m_contacts.clear();
+}
+
+bool SleepingIslands::asleep( const unsigned bdy_idx ) const
+{
+  assert( bdy_idx < m_asleep.size() );
+  return m_asleep[bdy_idx];
+}
+
+unsigned SleepingIslands::numAsleep() const
+{
+  return unsigned( std::count( m_asleep.cbegin(), m_asleep.cend(), true ) );
+}
+
+void SleepingIslands::wakeIslands( const std::vector<unsigned>& bodies )
+{
+  std::set<unsigned> islands;
+  for( const unsigned bdy_idx : bodies )
+  {
+    assert( bdy_idx < m_asleep.size() );
+    if( m_asleep[bdy_idx] )
+    {
+      assert( m_island[bdy_idx] != INVALID_ISLAND );
+      islands.insert( m_island[bdy_idx] );
+    }
+  }
+  if( islands.empty() )
+  {
+    return;
+  }
+
+  for( std::vector<bool>::size_type bdy_idx = 0; bdy_idx < m_asleep.size(); ++bdy_idx )
+  {
+    if( m_asleep[bdy_idx] && islands.count( m_island[bdy_idx] ) != 0 )
+    {
+      m_asleep[bdy_idx] = false;
+      m_rest_time[bdy_idx] = 0.0;
+      m_island[bdy_idx] = INVALID_ISLAND;
+    }
+  }
+}
+
+void SleepingIslands::wakeAll()
+{
+  std::fill( m_asleep.begin(), m_asleep.end(), false );
+  std::fill( m_rest_time.begin(), m_rest_time.end(), 0.0 );
+  std::fill( m_island.begin(), m_island.end(), INVALID_ISLAND );
+}
+
+void SleepingIslands::clearContacts()
+{
+  m_contacts.clear();
+}
+
+void SleepingIslands::addContacts( const std::vector<std::unique_ptr<Constraint>>& active_set )
+{
+  for( const std::unique_ptr<Constraint>& constraint : active_set )
+  {
+    std::pair<int,int> bodies;
+    constraint->getSimulatedBodyIndices( bodies );
+    // Contacts with static geometry and kinematic bodies do not join islands
+    if( bodies.first >= 0 && bodies.second >= 0 )
+    {
+      m_contacts.emplace_back( unsigned( bodies.first ), unsigned( bodies.second ) );
+    }
+  }
+}
+
+static unsigned findRoot( std::vector<unsigned>& parents, unsigned bdy_idx )
+{
+  while( parents[bdy_idx] != bdy_idx )
+  {
+    // Path halving
+    parents[bdy_idx] = parents[parents[bdy_idx]];
+    bdy_idx = parents[bdy_idx];
+  }
+  return bdy_idx;
+}
+
+unsigned SleepingIslands::update( const scalar& dt, const VectorXs& speeds, const VectorXs& kinetic_energies, const std::vector<bool>& fixed )
+{
+  assert( dt > 0.0 );
+  assert( speeds.size() == kinetic_energies.size() );
+  assert( unsigned( speeds.size() ) == m_asleep.size() );
+  assert( fixed.size() == m_asleep.size() );
+
+  if( !enabled() )
+  {
+    return 0;
+  }
+
+  const unsigned nbodies{ unsigned( m_asleep.size() ) };
+
+  // Advance the rest timers of awake, simulated bodies
+  for( unsigned bdy_idx = 0; bdy_idx < nbodies; ++bdy_idx )
+  {
+    if( m_asleep[bdy_idx] )
+    {
+      continue;
+    }
+    assert( m_island[bdy_idx] == INVALID_ISLAND );
+    if( fixed[bdy_idx] )
+    {
+      m_rest_time[bdy_idx] = 0.0;
+      continue;
+    }
+    if( speeds( bdy_idx ) <= m_linear_velocity_threshold && kinetic_energies( bdy_idx ) <= m_kinetic_energy_threshold )
+    {
+      m_rest_time[bdy_idx] += dt;
+    }
+    else
+    {
+      m_rest_time[bdy_idx] = 0.0;
+    }
+  }
+
+  // Group awake bodies into islands of touching bodies
+  std::vector<unsigned> parents( nbodies );
+  std::iota( parents.begin(), parents.end(), 0 );
+  for( const std::pair<unsigned,unsigned>& contact : m_contacts )
+  {
+    assert( contact.first < nbodies ); assert( contact.second < nbodies );
+    if( m_asleep[contact.first] || m_asleep[contact.second] || fixed[contact.first] || fixed[contact.second] )
+    {
+      continue;
+    }
+    const unsigned root0{ findRoot( parents, contact.first ) };
+    const unsigned root1{ findRoot( parents, contact.second ) };
+    if( root0 != root1 )
+    {
+      parents[ std::max( root0, root1 ) ] = std::min( root0, root1 );
+    }
+  }
+
+  // An island can only sleep if every body in it has rested long enough
+  std::vector<bool> island_rested( nbodies, true );
+  for( unsigned bdy_idx = 0; bdy_idx < nbodies; ++bdy_idx )
+  {
+    if( !m_asleep[bdy_idx] && !fixed[bdy_idx] && m_rest_time[bdy_idx] < m_time_to_sleep )
+    {
+      island_rested[ findRoot( parents, bdy_idx ) ] = false;
+    }
+  }
+
+  // Put rested islands to sleep, labeling each with a fresh island id
+  std::vector<unsigned> island_ids( nbodies, INVALID_ISLAND );
+  unsigned num_put_to_sleep{ 0 };
+  for( unsigned bdy_idx = 0; bdy_idx < nbodies; ++bdy_idx )
+  {
+    if( m_asleep[bdy_idx] || fixed[bdy_idx] )
+    {
+      continue;
+    }
+    const unsigned root{ findRoot( parents, bdy_idx ) };
+    if( !island_rested[root] )
+    {
+      continue;
+    }
+    if( island_ids[root] == INVALID_ISLAND )
+    {
+      island_ids[root] = m_next_island++;
+    }
+    m_asleep[bdy_idx] = true;
+    m_island[bdy_idx] = island_ids[root];
+    ++num_put_to_sleep;
+  }
+
+  return num_put_to_sleep;
+}
+
+void SleepingIslands::serialize( std::ostream& output_stream ) const
+{
+  assert( output_stream.good() );
+  Utilities::serialize( m_linear_velocity_threshold, output_stream );
+  Utilities::serialize( m_kinetic_energy_threshold, output_stream );
+  Utilities::serialize( m_time_to_sleep, output_stream );
+  Utilities::serialize( m_asleep, output_stream );
+  Utilities::serialize( m_rest_time, output_stream );
+  Utilities::serialize( m_island, output_stream );
+  Utilities::serialize( m_next_island, output_stream );
+}
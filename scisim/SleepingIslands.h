@@ -0,0 +1,77 @@
+// SleepingIslands.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Tracks how long each body has been at rest and puts connected islands of resting
+// bodies to sleep. Sleeping bodies are treated as kinematic with zero velocity by the
+// simulations until an awake body touches their island or a script wakes them.
+
+#ifndef SLEEPING_ISLANDS_H
+#define SLEEPING_ISLANDS_H
+
+#include "scisim/Math/MathDefines.h"
+
+#include <memory>
+#include <vector>
+
+class Constraint;
+
+class SleepingIslands final
+{
+
+public:
+
+  // Sleeping disabled
+  SleepingIslands();
+  SleepingIslands( const scalar& linear_velocity_threshold, const scalar& kinetic_energy_threshold, const scalar& time_to_sleep );
+  explicit SleepingIslands( std::istream& input_stream );
+
+  bool enabled() const;
+
+  const scalar& linearVelocityThreshold() const;
+  const scalar& kineticEnergyThreshold() const;
+  const scalar& timeToSleep() const;
+
+  // Per-body storage
+  unsigned nbodies() const;
+  // New bodies are awake and have not been at rest
+  void resize( const unsigned nbodies );
+  void removeBodies( const Eigen::Ref<const VectorXu>& indices );
+
+  bool asleep( const unsigned bdy_idx ) const;
+  unsigned numAsleep() const;
+
+  // Wakes each given body and every other body in its island
+  void wakeIslands( const std::vector<unsigned>& bodies );
+  void wakeAll();
+
+  // Contact graph used to build islands at the end of the step
+  void clearContacts();
+  void addContacts( const std::vector<std::unique_ptr<Constraint>>& active_set );
+
+  // Advances the rest timers of awake bodies by dt and puts islands whose bodies have all rested
+  // for at least timeToSleep() to sleep. Fixed bodies never sleep and do not join islands.
+  // speeds and kinetic_energies hold one entry per body. Returns the number of bodies put to sleep.
+  unsigned update( const scalar& dt, const VectorXs& speeds, const VectorXs& kinetic_energies, const std::vector<bool>& fixed );
+
+  void serialize( std::ostream& output_stream ) const;
+
+private:
+
+  scalar m_linear_velocity_threshold;
+  scalar m_kinetic_energy_threshold;
+  scalar m_time_to_sleep;
+
+  std::vector<bool> m_asleep;
+  // Time each body has continuously been below the rest thresholds
+  std::vector<scalar> m_rest_time;
+  // Island each sleeping body belongs to, invalid for awake bodies
+  std::vector<unsigned> m_island;
+  unsigned m_next_island;
+
+  std::vector<std::pair<unsigned,unsigned>> m_contacts;
+
+};
+
+#endif
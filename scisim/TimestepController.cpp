@@ -0,0 +1,169 @@
+// TimestepController.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "TimestepController.h"
+
+#include "scisim/Utilities.h"
+
+#include <algorithm>
+
+TimestepController::TimestepController()
+: m_max_refinements( 0 )
+, m_max_coarsenings( 0 )
+, m_max_penetration( SCALAR_INFINITY )
+, m_calm_penetration( 0.0 )
+, m_calm_steps_to_coarsen( 0 )
+, m_ticks( 0 )
+, m_level( 0 )
+, m_calm_steps( 0 )
+{}
+
+TimestepController::TimestepController( const unsigned max_refinements, const unsigned max_coarsenings, const scalar& max_penetration, const scalar& calm_penetration, const unsigned calm_steps_to_coarsen )
+: m_max_refinements( max_refinements )
+, m_max_coarsenings( max_coarsenings )
+, m_max_penetration( max_penetration )
+, m_calm_penetration( calm_penetration )
+, m_calm_steps_to_coarsen( calm_steps_to_coarsen )
+, m_ticks( 0 )
+, m_level( 0 )
+, m_calm_steps( 0 )
+{
+  assert( m_max_refinements + m_max_coarsenings < 8 * sizeof( std::intmax_t ) - 2 );
+  assert( m_max_penetration > 0.0 );
+  assert( m_calm_penetration >= 0.0 ); assert( m_calm_penetration <= m_max_penetration );
+  assert( m_calm_steps_to_coarsen > 0 );
+}
+
+TimestepController::TimestepController( std::istream& input_stream )
+: m_max_refinements( Utilities::deserialize<unsigned>( input_stream ) )
+, m_max_coarsenings( Utilities::deserialize<unsigned>( input_stream ) )
+, m_max_penetration( Utilities::deserialize<scalar>( input_stream ) )
+, m_calm_penetration( Utilities::deserialize<scalar>( input_stream ) )
+, m_calm_steps_to_coarsen( Utilities::deserialize<unsigned>( input_stream ) )
+, m_ticks( Utilities::deserialize<std::intmax_t>( input_stream ) )
+, m_level( Utilities::deserialize<int>( input_stream ) )
+, m_calm_steps( Utilities::deserialize<unsigned>( input_stream ) )
+{
+  assert( m_ticks >= 0 );
+  assert( m_level >= -int( m_max_refinements ) ); assert( m_level <= int( m_max_coarsenings ) );
+}
+
+bool TimestepController::adaptive() const
+{
+  return m_max_refinements != 0 || m_max_coarsenings != 0;
+}
+
+int TimestepController::level() const
+{
+  return m_level;
+}
+
+Rational<std::intmax_t> TimestepController::timestep( const Rational<std::intmax_t>& base_dt ) const
+{
+  assert( base_dt.positive() );
+  return stepTicks( m_level ) * base_dt / ( std::intmax_t( 1 ) << m_max_refinements );
+}
+
+Rational<std::intmax_t> TimestepController::time( const Rational<std::intmax_t>& base_dt ) const
+{
+  assert( base_dt.positive() );
+  return m_ticks * base_dt / ( std::intmax_t( 1 ) << m_max_refinements );
+}
+
+void TimestepController::startAtBaseStep( const unsigned base_step )
+{
+  m_ticks = std::intmax_t( base_step ) << m_max_refinements;
+  m_calm_steps = 0;
+  // Restart at the base timestep, which always divides the start time
+  m_level = std::min( m_level, 0 );
+}
+
+unsigned TimestepController::nextIteration() const
+{
+  const std::intmax_t step_ticks{ stepTicks( m_level ) };
+  assert( m_ticks % step_ticks == 0 );
+  return unsigned( ( m_ticks + step_ticks ) / step_ticks );
+}
+
+bool TimestepController::atMultipleOfBaseSteps( const unsigned num_base_steps ) const
+{
+  assert( num_base_steps > 0 );
+  return m_ticks % ( std::intmax_t( num_base_steps ) << m_max_refinements ) == 0;
+}
+
+bool TimestepController::rejectStep( const scalar& penetration_depth, const bool solve_succeeded )
+{
+  if( !adaptive() || ( solve_succeeded && penetration_depth <= m_max_penetration ) || m_level <= -int( m_max_refinements ) )
+  {
+    return false;
+  }
+  // Finer steps always divide the current time
+  --m_level;
+  m_calm_steps = 0;
+  return true;
+}
+
+void TimestepController::stepTaken( const scalar& penetration_depth, const bool solve_succeeded, const unsigned steps_per_save )
+{
+  assert( steps_per_save > 0 );
+
+  m_ticks += stepTicks( m_level );
+
+  if( !adaptive() )
+  {
+    return;
+  }
+
+  // Refine on deep penetration or a failed solve; finer steps always divide the current time
+  if( !solve_succeeded || penetration_depth > m_max_penetration )
+  {
+    if( m_level > -int( m_max_refinements ) )
+    {
+      --m_level;
+    }
+    m_calm_steps = 0;
+    return;
+  }
+
+  if( penetration_depth > m_calm_penetration )
+  {
+    m_calm_steps = 0;
+    return;
+  }
+
+  ++m_calm_steps;
+  if( m_calm_steps < m_calm_steps_to_coarsen || m_level >= int( m_max_coarsenings ) )
+  {
+    return;
+  }
+
+  // Only coarsen once the current time is aligned with the coarse step and the coarse step divides the output interval
+  const std::intmax_t coarse_ticks{ stepTicks( m_level + 1 ) };
+  const std::intmax_t save_ticks{ std::intmax_t( steps_per_save ) << m_max_refinements };
+  if( m_ticks % coarse_ticks == 0 && save_ticks % coarse_ticks == 0 )
+  {
+    ++m_level;
+    m_calm_steps = 0;
+  }
+}
+
+void TimestepController::serialize( std::ostream& output_stream ) const
+{
+  assert( output_stream.good() );
+  Utilities::serialize( m_max_refinements, output_stream );
+  Utilities::serialize( m_max_coarsenings, output_stream );
+  Utilities::serialize( m_max_penetration, output_stream );
+  Utilities::serialize( m_calm_penetration, output_stream );
+  Utilities::serialize( m_calm_steps_to_coarsen, output_stream );
+  Utilities::serialize( m_ticks, output_stream );
+  Utilities::serialize( m_level, output_stream );
+  Utilities::serialize( m_calm_steps, output_stream );
+}
+
+std::intmax_t TimestepController::stepTicks( const int level ) const
+{
+  assert( level >= -int( m_max_refinements ) ); assert( level <= int( m_max_coarsenings ) );
+  return std::intmax_t( 1 ) << ( level + int( m_max_refinements ) );
+}
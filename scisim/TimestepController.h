@@ -0,0 +1,78 @@
+// TimestepController.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Adapts the timestep by powers of two around a base timestep. Coarse steps are only taken when the
+// current time is a multiple of the coarse step, so the time at the end of every step is an integer
+// multiple of that step and iteration * dt remains exact. Coarsening is further limited to steps that
+// evenly divide the output interval so saved frames land on exact times.
+
+#ifndef TIMESTEP_CONTROLLER_H
+#define TIMESTEP_CONTROLLER_H
+
+#include "scisim/Math/MathDefines.h"
+#include "scisim/Math/Rational.h"
+
+#include <cstdint>
+
+class TimestepController final
+{
+
+public:
+
+  // Fixed timestep
+  TimestepController();
+  TimestepController( const unsigned max_refinements, const unsigned max_coarsenings, const scalar& max_penetration, const scalar& calm_penetration, const unsigned calm_steps_to_coarsen );
+  explicit TimestepController( std::istream& input_stream );
+
+  bool adaptive() const;
+
+  // The current timestep is base_dt * 2^level()
+  int level() const;
+  Rational<std::intmax_t> timestep( const Rational<std::intmax_t>& base_dt ) const;
+
+  // Time at the start of the next step
+  Rational<std::intmax_t> time( const Rational<std::intmax_t>& base_dt ) const;
+
+  // Moves the start time to the given number of base timesteps
+  void startAtBaseStep( const unsigned base_step );
+
+  // Iteration at the end of the next step, in units of the current timestep
+  unsigned nextIteration() const;
+
+  // True if the current time is an integer multiple of num_base_steps base timesteps
+  bool atMultipleOfBaseSteps( const unsigned num_base_steps ) const;
+
+  // Rejects a step whose deepest penetration exceeds the maximum or whose friction solve failed, halving the
+  // timestep without advancing time so the caller can restore the start of the step and take it again. Returns
+  // false, keeping the step, if it was acceptable or the timestep can not be refined further.
+  bool rejectStep( const scalar& penetration_depth, const bool solve_succeeded );
+
+  // Advances time by the current timestep and selects the next timestep. The timestep is halved if the
+  // penetration depth exceeds the maximum or the friction solve failed, and doubled after a run of steps
+  // with penetration below the calm threshold. steps_per_save is the output interval in base timesteps.
+  void stepTaken( const scalar& penetration_depth, const bool solve_succeeded, const unsigned steps_per_save );
+
+  void serialize( std::ostream& output_stream ) const;
+
+private:
+
+  // Length of a step at the given level in units of the finest timestep
+  std::intmax_t stepTicks( const int level ) const;
+
+  unsigned m_max_refinements;
+  unsigned m_max_coarsenings;
+  scalar m_max_penetration;
+  scalar m_calm_penetration;
+  unsigned m_calm_steps_to_coarsen;
+
+  // Time in units of the finest timestep, base_dt / 2^m_max_refinements
+  std::intmax_t m_ticks;
+  int m_level;
+  // Consecutive calm steps taken at the current level
+  unsigned m_calm_steps;
+
+};
+
+#endif
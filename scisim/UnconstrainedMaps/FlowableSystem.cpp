@@ -11,3 +11,9 @@ unsigned FlowableSystem::numBodies() const
 {
   return nvdofs() / numVelDoFsPerBody();
 }
+
+void FlowableSystem::clearSubstepConfigurations()
+{}
+
+void FlowableSystem::addSubstepConfiguration( const VectorXs& q )
+{}
@@ -46,6 +46,11 @@ public:
   // For the given velocity and the system's current configuration and mass, computes the angular momentum
   virtual void computeAngularMomentum( const VectorXs& v, VectorXs& L ) const = 0;
 
+  // Maps that subdivide a step report the configuration at the end of each intermediate substep, so that
+  // collision detection can sweep over the whole step. Systems without swept detection can ignore these.
+  virtual void clearSubstepConfigurations();
+  virtual void addSubstepConfiguration( const VectorXs& q );
+
 protected:
 
   FlowableSystem() = default;
@@ -0,0 +1,69 @@
+// SubsteppedMap.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include "SubsteppedMap.h"
+
+#include "FlowableSystem.h"
+#include "scisim/StringUtilities.h"
+#include "scisim/Utilities.h"
+
+SubsteppedMap::SubsteppedMap( std::unique_ptr<UnconstrainedMap> map, const unsigned num_substeps )
+: m_map( std::move( map ) )
+, m_num_substeps( num_substeps )
+{
+  assert( m_map != nullptr );
+  assert( m_num_substeps > 0 );
+}
+
+SubsteppedMap::~SubsteppedMap()
+{}
+
+void SubsteppedMap::flow( const VectorXs& q0, const VectorXs& v0, FlowableSystem& fsys, const unsigned iteration, const scalar& dt, VectorXs& q1, VectorXs& v1 )
+{
+  assert( iteration > 0 );
+  assert( q1.size() == q0.size() ); assert( v1.size() == v0.size() );
+
+  const scalar h{ dt / scalar( m_num_substeps ) };
+  // Fine iteration of the first substep, so each substep sees the same time as a single rate run with timestep h
+  const unsigned first_iteration{ ( iteration - 1 ) * m_num_substeps + 1 };
+
+  fsys.clearSubstepConfigurations();
+
+  VectorXs q{ q0 };
+  VectorXs v{ v0 };
+  for( unsigned substep = 0; substep < m_num_substeps; ++substep )
+  {
+    m_map->flow( q, v, fsys, first_iteration + substep, h, q1, v1 );
+    if( substep + 1 < m_num_substeps )
+    {
+      fsys.addSubstepConfiguration( q1 );
+      q.swap( q1 );
+      v.swap( v1 );
+    }
+  }
+}
+
+std::string SubsteppedMap::name() const
+{
+  return "substepped";
+}
+
+void SubsteppedMap::serialize( std::ostream& output_stream ) const
+{
+  assert( output_stream.good() );
+  Utilities::serialize( m_num_substeps, output_stream );
+  StringUtilities::serialize( m_map->name(), output_stream );
+  m_map->serialize( output_stream );
+}
+
+unsigned SubsteppedMap::numSubsteps() const
+{
+  return m_num_substeps;
+}
+
+const UnconstrainedMap& SubsteppedMap::map() const
+{
+  return *m_map;
+}
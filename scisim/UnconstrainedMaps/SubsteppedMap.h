@@ -0,0 +1,43 @@
+// SubsteppedMap.h
+//
+// agent
+// Last updated: 10/19/2026
+
+// Advances a wrapped unconstrained map over several equal substeps per call. This lets free flight be
+// integrated with a finer timestep than the one used for contact solves. The configuration at the end
+// of each intermediate substep is reported to the FlowableSystem so collision detection can sweep over
+// the whole step.
+
+#ifndef SUBSTEPPED_MAP_H
+#define SUBSTEPPED_MAP_H
+
+#include "UnconstrainedMap.h"
+
+#include <memory>
+
+class SubsteppedMap final : public UnconstrainedMap
+{
+
+public:
+
+  SubsteppedMap( std::unique_ptr<UnconstrainedMap> map, const unsigned num_substeps );
+  virtual ~SubsteppedMap() override;
+
+  virtual void flow( const VectorXs& q0, const VectorXs& v0, FlowableSystem& fsys, const unsigned iteration, const scalar& dt, VectorXs& q1, VectorXs& v1 ) override;
+
+  virtual std::string name() const override;
+
+  // Writes the number of substeps followed by the name and state of the wrapped map
+  virtual void serialize( std::ostream& output_stream ) const override;
+
+  unsigned numSubsteps() const;
+  const UnconstrainedMap& map() const;
+
+private:
+
+  std::unique_ptr<UnconstrainedMap> m_map;
+  unsigned m_num_substeps;
+
+};
+
+#endif
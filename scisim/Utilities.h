@@ -59,6 +59,22 @@ namespace Utilities
     }
   }
 
+  // Serializes a vector of shared pointers of non-trivially copyable objects that have a custom serialize method
+  template<typename T>
+  void serialize( const std::vector<std::shared_ptr<T>>& vector, std::ostream& output_stream )
+  {
+    static_assert( !std::is_trivially_copyable<T>::value, "Error in vector of shared_ptr custom serialization, type is trivially copyable." );
+    assert( output_stream.good() );
+    // Write out the length of the vector
+    serialize( vector.size(), output_stream );
+    // Output each element of the vector
+    for( typename std::vector<std::shared_ptr<T>>::size_type idx = 0; idx < vector.size(); ++idx )
+    {
+      assert( vector[idx] != nullptr );
+      vector[idx]->serialize( output_stream );
+    }
+  }
+
   // Serializes a vector of non-pointer and non-trivially copyable objects that have a custom serialize method
   template<typename T>
   typename std::enable_if<!std::is_trivially_copyable<T>::value>::type
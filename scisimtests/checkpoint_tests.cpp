@@ -0,0 +1,336 @@
+// checkpoint_tests.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "scisim/Math/MathDefines.h"
+#include "scisim/Checkpoint.h"
+
+// Layout of a section table entry: a 64 byte name followed by the offset, size, rows, and cols as 64 bit
+// integers and the scalar size and flags as 32 bit integers
+static constexpr std::size_t TABLE_ENTRY_SIZE{ 104 };
+static constexpr std::size_t ROWS_OFFSET{ 80 };
+static constexpr std::size_t COLS_OFFSET{ 88 };
+
+static SparseMatrixsc testSparseMatrix()
+{
+  SparseMatrixsc A{ 3, 4 };
+  A.insert( 0, 0 ) = 1.0;
+  A.insert( 2, 1 ) = -2.0;
+  A.insert( 1, 3 ) = 3.5;
+  A.makeCompressed();
+  return A;
+}
+
+static void writeTestCheckpoint( const VectorXs& q, const MatrixXs& B, const SparseMatrixsc& A, CheckpointWriter& checkpoint )
+{
+  checkpoint.addSection( "settings", std::string{ "settings bytes" } );
+  checkpoint.addArray( "q", q );
+  checkpoint.addArray( "B", B );
+  // A temporary the checkpoint takes ownership of
+  checkpoint.addArray( "indices", VectorXu{ VectorXu::LinSpaced( 5, 0, 4 ) } );
+  checkpoint.addSparseMatrix( "A", A );
+}
+
+static bool writeImageFile( const std::vector<char>& image, const std::string& file_name )
+{
+  std::ofstream output_stream{ file_name, std::ios::binary };
+  output_stream.write( image.data(), std::streamsize( image.size() ) );
+  return bool( output_stream );
+}
+
+// Start of the table entry of the named section within a checkpoint image
+static std::size_t findTableEntry( const std::vector<char>& image, const std::string& name )
+{
+  for( std::size_t entry_start = image.size() - TABLE_ENTRY_SIZE; entry_start >= TABLE_ENTRY_SIZE; entry_start -= TABLE_ENTRY_SIZE )
+  {
+    if( std::strncmp( image.data() + entry_start, name.c_str(), 64 ) == 0 )
+    {
+      return entry_start;
+    }
+  }
+  return 0;
+}
+
+static void setEntryField( std::vector<char>& image, const std::size_t entry_start, const std::size_t field_offset, const std::uint64_t value )
+{
+  std::memcpy( image.data() + entry_start + field_offset, &value, sizeof( value ) );
+}
+
+// True if reading the section throws
+template<typename Derived>
+static bool readArrayThrows( const std::string& file_name, const std::string& name )
+{
+  try
+  {
+    const CheckpointReader checkpoint{ file_name };
+    checkpoint.readArray<Derived>( name );
+  }
+  catch( const std::string& )
+  {
+    return true;
+  }
+  return false;
+}
+
+static bool readSparseMatrixThrows( const std::string& file_name, const std::string& name )
+{
+  try
+  {
+    const CheckpointReader checkpoint{ file_name };
+    SparseMatrixsc A;
+    checkpoint.readSparseMatrix( name, A );
+  }
+  catch( const std::string& )
+  {
+    return true;
+  }
+  return false;
+}
+
+static int testRoundTrip()
+{
+  const std::string file_name{ "checkpoint_tests_round_trip.bin" };
+  const VectorXs q{ VectorXs::LinSpaced( 7, -1.0, 2.0 ) };
+  const MatrixXs B{ MatrixXs::Random( 3, 2 ) };
+  const SparseMatrixsc A{ testSparseMatrix() };
+  {
+    CheckpointWriter checkpoint{ "test", 3 };
+    writeTestCheckpoint( q, B, A, checkpoint );
+    if( !checkpoint.writeFile( file_name ) )
+    {
+      std::cerr << "Failed to write " << file_name << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  int status{ EXIT_SUCCESS };
+  try
+  {
+    const CheckpointReader checkpoint{ file_name };
+    std::size_t settings_size;
+    const char* const settings{ checkpoint.sectionData( "settings", settings_size ) };
+    SparseMatrixsc A_read;
+    checkpoint.readSparseMatrix( "A", A_read );
+    if( checkpoint.kind() != "test" || checkpoint.schemaVersion() != 3 || checkpoint.isDelta() )
+    {
+      std::cerr << "Checkpoint header was not preserved." << std::endl;
+      status = EXIT_FAILURE;
+    }
+    else if( std::string( settings, settings_size ) != "settings bytes" )
+    {
+      std::cerr << "Byte section was not preserved." << std::endl;
+      status = EXIT_FAILURE;
+    }
+    else if( checkpoint.readArray<VectorXs>( "q" ) != q || checkpoint.readArray<MatrixXs>( "B" ) != B || checkpoint.readArray<VectorXu>( "indices" ) != VectorXu::LinSpaced( 5, 0, 4 ) )
+    {
+      std::cerr << "Array sections were not preserved." << std::endl;
+      status = EXIT_FAILURE;
+    }
+    else if( A_read.rows() != A.rows() || A_read.cols() != A.cols() || MatrixXs{ A_read } != MatrixXs{ A } )
+    {
+      std::cerr << "Sparse matrix was not preserved." << std::endl;
+      status = EXIT_FAILURE;
+    }
+  }
+  catch( const std::string& error )
+  {
+    std::cerr << error << std::endl;
+    status = EXIT_FAILURE;
+  }
+  std::remove( file_name.c_str() );
+  return status;
+}
+
+static int testDeltaRoundTrip()
+{
+  const std::string anchor_file_name{ "checkpoint_tests_anchor.bin" };
+  const std::string delta_file_name{ "checkpoint_tests_delta.bin" };
+  VectorXs q{ VectorXs::LinSpaced( 7, -1.0, 2.0 ) };
+  const MatrixXs B{ MatrixXs::Random( 3, 2 ) };
+  const SparseMatrixsc A{ testSparseMatrix() };
+
+  CheckpointWriter anchor{ "test", 3 };
+  writeTestCheckpoint( q, B, A, anchor );
+  if( !anchor.writeFile( anchor_file_name ) )
+  {
+    std::cerr << "Failed to write " << anchor_file_name << std::endl;
+    return EXIT_FAILURE;
+  }
+  // The anchor must keep the values it was written with
+  anchor.copyReferencedContents();
+  const VectorXs anchor_q{ q };
+  q( 3 ) = 10.0;
+
+  CheckpointWriter delta{ "test", 3 };
+  writeTestCheckpoint( q, B, A, delta );
+  delta.makeDelta( anchor, anchor_file_name );
+  if( delta.contentBytes() >= anchor.contentBytes() )
+  {
+    std::cerr << "Delta checkpoint stored unchanged sections." << std::endl;
+    std::remove( anchor_file_name.c_str() );
+    return EXIT_FAILURE;
+  }
+  if( !delta.writeFile( delta_file_name ) )
+  {
+    std::cerr << "Failed to write " << delta_file_name << std::endl;
+    std::remove( anchor_file_name.c_str() );
+    return EXIT_FAILURE;
+  }
+
+  int status{ EXIT_SUCCESS };
+  try
+  {
+    const CheckpointReader anchor_checkpoint{ anchor_file_name };
+    const CheckpointReader delta_checkpoint{ delta_file_name };
+    if( !delta_checkpoint.isDelta() || delta_checkpoint.readArray<VectorXs>( "q" ) != q || delta_checkpoint.readArray<MatrixXs>( "B" ) != B || anchor_checkpoint.readArray<VectorXs>( "q" ) != anchor_q )
+    {
+      std::cerr << "Delta checkpoint did not combine with its anchor." << std::endl;
+      status = EXIT_FAILURE;
+    }
+  }
+  catch( const std::string& error )
+  {
+    std::cerr << error << std::endl;
+    status = EXIT_FAILURE;
+  }
+  std::remove( anchor_file_name.c_str() );
+  std::remove( delta_file_name.c_str() );
+  return status;
+}
+
+// Rewrites the rows and cols of a section in a valid image and checks that reading it fails
+static int testCorruptShape( const std::string& file_name, const std::uint64_t rows, const std::uint64_t cols )
+{
+  const VectorXs q{ VectorXs::LinSpaced( 7, -1.0, 2.0 ) };
+  const MatrixXs B{ MatrixXs::Random( 3, 2 ) };
+  const SparseMatrixsc A{ testSparseMatrix() };
+  CheckpointWriter checkpoint{ "test", 3 };
+  writeTestCheckpoint( q, B, A, checkpoint );
+  std::vector<char> image;
+  checkpoint.writeImage( image );
+
+  const std::size_t entry_start{ findTableEntry( image, "B" ) };
+  if( entry_start == 0 )
+  {
+    std::cerr << "Failed to find the table entry of section B." << std::endl;
+    return EXIT_FAILURE;
+  }
+  setEntryField( image, entry_start, ROWS_OFFSET, rows );
+  setEntryField( image, entry_start, COLS_OFFSET, cols );
+  if( !writeImageFile( image, file_name ) )
+  {
+    std::cerr << "Failed to write " << file_name << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const bool rejected{ readArrayThrows<MatrixXs>( file_name, "B" ) };
+  std::remove( file_name.c_str() );
+  if( !rejected )
+  {
+    std::cerr << "Array with dimensions " << rows << " x " << cols << " larger than its section was accepted." << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+static int testCorruptSparseMatrix()
+{
+  const std::string file_name{ "checkpoint_tests_corrupt_sparse.bin" };
+  const SparseMatrixsc A{ testSparseMatrix() };
+  CheckpointWriter checkpoint{ "test", 3 };
+  checkpoint.addSparseMatrix( "A", A );
+  // A row index past the last row of the matrix
+  SparseMatrixsc A_bad{ A };
+  A_bad.innerIndexPtr()[1] = 3;
+  checkpoint.addSparseMatrix( "A_bad", A_bad );
+  if( !checkpoint.writeFile( file_name ) )
+  {
+    std::cerr << "Failed to write " << file_name << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const bool valid_rejected{ readSparseMatrixThrows( file_name, "A" ) };
+  const bool corrupt_rejected{ readSparseMatrixThrows( file_name, "A_bad" ) };
+  std::remove( file_name.c_str() );
+  if( valid_rejected )
+  {
+    std::cerr << "Valid sparse matrix was rejected." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if( !corrupt_rejected )
+  {
+    std::cerr << "Sparse matrix with an out of range row index was accepted." << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+static int testNotACheckpoint()
+{
+  const std::string file_name{ "checkpoint_tests_not_a_checkpoint.bin" };
+  const std::vector<char> image( 256, 'x' );
+  if( !writeImageFile( image, file_name ) )
+  {
+    std::cerr << "Failed to write " << file_name << std::endl;
+    return EXIT_FAILURE;
+  }
+  const bool detected{ CheckpointReader::isCheckpoint( file_name ) };
+  const bool rejected{ readArrayThrows<VectorXs>( file_name, "q" ) };
+  std::remove( file_name.c_str() );
+  if( detected || !rejected )
+  {
+    std::cerr << "File without the checkpoint magic number was accepted." << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+int main( int argc, char** argv )
+{
+  if( argc != 2 )
+  {
+    std::cerr << "Usage: " << argv[0] << " test_name" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string test_name( argv[1] );
+
+  if( test_name == "round_trip" )
+  {
+    return testRoundTrip();
+  }
+  else if( test_name == "delta_round_trip" )
+  {
+    return testDeltaRoundTrip();
+  }
+  else if( test_name == "truncated_array" )
+  {
+    return testCorruptShape( "checkpoint_tests_truncated_array.bin", 3, 3 );
+  }
+  else if( test_name == "overflowing_shape" )
+  {
+    // rows * cols * sizeof( scalar ) wraps around to 0
+    return testCorruptShape( "checkpoint_tests_overflowing_shape.bin", std::uint64_t( 1 ) << 32, std::uint64_t( 1 ) << 29 );
+  }
+  else if( test_name == "corrupt_sparse_matrix" )
+  {
+    return testCorruptSparseMatrix();
+  }
+  else if( test_name == "not_a_checkpoint" )
+  {
+    return testNotACheckpoint();
+  }
+
+  std::cerr << "Invalid test specified: " << test_name << std::endl;
+  return EXIT_FAILURE;
+}
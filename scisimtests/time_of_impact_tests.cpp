@@ -0,0 +1,137 @@
+// time_of_impact_tests.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <cmath>
+
+#include <Eigen/Geometry>
+
+#include "scisim/Math/MathDefines.h"
+#include "scisim/Math/MathUtilities.h"
+
+static bool matchesExpected( const scalar& computed, const scalar& expected )
+{
+  return expected == SCALAR_INFINITY ? computed == SCALAR_INFINITY : fabs( computed - expected ) <= 1.0e-9;
+}
+
+// Checks the planar motion in two dimensions and embedded in a tilted plane in three dimensions
+static int checkTimeOfImpact( const Vector2s& x0_start, const Vector2s& x1_start, const Vector2s& x0_end, const Vector2s& x1_end, const scalar& r, const scalar& expected )
+{
+  const scalar planar{ MathUtilities::sphereSphereTimeOfImpact<2>( x0_start, x1_start, x0_end, x1_end, r, r ) };
+  if( !matchesExpected( planar, expected ) )
+  {
+    std::cerr << "Expected a time of impact of " << expected << " for balls, obtained " << planar << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const Matrix33sr R{ Eigen::AngleAxis<scalar>{ 0.7, Vector3s{ 1.0, -2.0, 0.5 }.normalized() }.toRotationMatrix() };
+  const Vector3s offset{ 0.3, -1.2, 2.5 };
+  const auto embed = [&R,&offset]( const Vector2s& x ) { return Vector3s{ R * Vector3s{ x.x(), x.y(), 0.0 } + offset }; };
+  const scalar spatial{ MathUtilities::sphereSphereTimeOfImpact<3>( embed( x0_start ), embed( x1_start ), embed( x0_end ), embed( x1_end ), r, r ) };
+  if( !matchesExpected( spatial, expected ) )
+  {
+    std::cerr << "Expected a time of impact of " << expected << " for spheres, obtained " << spatial << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+// Equal spheres approaching head on touch when their centers are two radii apart
+static int testHeadOn()
+{
+  return checkTimeOfImpact( Vector2s{ -5.0, 0.0 }, Vector2s{ 5.0, 0.0 }, Vector2s{ 5.0, 0.0 }, Vector2s{ -5.0, 0.0 }, 1.0, 0.4 );
+}
+
+// Small, fast spheres pass through each other within the step, so the end configuration alone misses the collision
+static int testTunneling()
+{
+  return checkTimeOfImpact( Vector2s{ -5.0, 0.0 }, Vector2s{ 5.0, 0.0 }, Vector2s{ 5.0, 0.0 }, Vector2s{ -5.0, 0.0 }, 0.1, 0.49 );
+}
+
+// A moving sphere passes a resting one with an offset smaller than the sum of the radii
+static int testGlancing()
+{
+  return checkTimeOfImpact( Vector2s{ -5.0, 1.5 }, Vector2s{ 0.0, 0.0 }, Vector2s{ 5.0, 1.5 }, Vector2s{ 0.0, 0.0 }, 1.0, 0.5 - 0.1 * sqrt( 1.75 ) );
+}
+
+// A moving sphere passes a resting one with an offset larger than the sum of the radii
+static int testMiss()
+{
+  return checkTimeOfImpact( Vector2s{ -5.0, 2.5 }, Vector2s{ 0.0, 0.0 }, Vector2s{ 5.0, 2.5 }, Vector2s{ 0.0, 0.0 }, 1.0, SCALAR_INFINITY );
+}
+
+// Overlap is only reported for spheres that approach; these move apart
+static int testSeparating()
+{
+  return checkTimeOfImpact( Vector2s{ -3.0, 0.0 }, Vector2s{ 3.0, 0.0 }, Vector2s{ -5.0, 0.0 }, Vector2s{ 5.0, 0.0 }, 1.0, SCALAR_INFINITY );
+}
+
+// The spheres approach but do not reach each other by the end of the step
+static int testTooSlow()
+{
+  return checkTimeOfImpact( Vector2s{ -5.0, 0.0 }, Vector2s{ 5.0, 0.0 }, Vector2s{ -2.0, 0.0 }, Vector2s{ 2.0, 0.0 }, 1.0, SCALAR_INFINITY );
+}
+
+// Spheres moving together never change their separation
+static int testTranslating()
+{
+  return checkTimeOfImpact( Vector2s{ -5.0, 0.0 }, Vector2s{ 5.0, 0.0 }, Vector2s{ -4.0, 1.0 }, Vector2s{ 6.0, 1.0 }, 1.0, SCALAR_INFINITY );
+}
+
+// Spheres that overlap at the start of the step collide immediately
+static int testInitialContact()
+{
+  return checkTimeOfImpact( Vector2s{ -0.5, 0.0 }, Vector2s{ 0.5, 0.0 }, Vector2s{ -5.0, 0.0 }, Vector2s{ 5.0, 0.0 }, 1.0, 0.0 );
+}
+
+int main( int argc, char** argv )
+{
+  if( argc != 2 )
+  {
+    std::cerr << "Usage: " << argv[0] << " test_name" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string test_name{ argv[1] };
+
+  if( test_name == "head_on" )
+  {
+    return testHeadOn();
+  }
+  else if( test_name == "tunneling" )
+  {
+    return testTunneling();
+  }
+  else if( test_name == "glancing" )
+  {
+    return testGlancing();
+  }
+  else if( test_name == "miss" )
+  {
+    return testMiss();
+  }
+  else if( test_name == "separating" )
+  {
+    return testSeparating();
+  }
+  else if( test_name == "too_slow" )
+  {
+    return testTooSlow();
+  }
+  else if( test_name == "translating" )
+  {
+    return testTranslating();
+  }
+  else if( test_name == "initial_contact" )
+  {
+    return testInitialContact();
+  }
+
+  std::cerr << "Invalid test specified: " << test_name << std::endl;
+  return EXIT_FAILURE;
+}
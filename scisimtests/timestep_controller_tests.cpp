@@ -0,0 +1,152 @@
+// timestep_controller_tests.cpp
+//
+// agent
+// Last updated: 10/19/2026
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <cstdint>
+
+#include "scisim/Math/MathDefines.h"
+#include "scisim/Math/Rational.h"
+#include "scisim/TimestepController.h"
+
+int main( int argc, char** argv )
+{
+  if( argc != 2 )
+  {
+    std::cerr << "Usage: " << argv[0] << " test_name" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string test_name( argv[1] );
+
+  const Rational<std::intmax_t> base_dt{ 1, 100 };
+
+  if( test_name == "fixed_00" )
+  {
+    TimestepController controller;
+    for( unsigned step = 0; step < 5; ++step )
+    {
+      if( controller.nextIteration() != step + 1 )
+      {
+        std::cerr << "Fixed timestep controller returned incorrect iteration." << std::endl;
+        return EXIT_FAILURE;
+      }
+      controller.stepTaken( 1.0, false, 2 );
+    }
+    if( controller.timestep( base_dt ) != base_dt || controller.time( base_dt ) != Rational<std::intmax_t>{ 5, 100 } )
+    {
+      std::cerr << "Fixed timestep controller changed the timestep." << std::endl;
+      return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  }
+  else if( test_name == "refine_00" )
+  {
+    TimestepController controller{ 3, 2, 1.0, 0.25, 2 };
+    controller.stepTaken( 0.5, true, 4 );
+    controller.stepTaken( 2.0, true, 4 );
+    if( controller.timestep( base_dt ) != Rational<std::intmax_t>{ 1, 200 } )
+    {
+      std::cerr << "Deep penetration did not halve the timestep." << std::endl;
+      return EXIT_FAILURE;
+    }
+    // Time is 2 base steps, so the end of the next half step is the fifth half step
+    if( controller.nextIteration() != 5 )
+    {
+      std::cerr << "Refined timestep returned incorrect iteration." << std::endl;
+      return EXIT_FAILURE;
+    }
+    controller.stepTaken( 0.5, false, 4 );
+    if( controller.timestep( base_dt ) != Rational<std::intmax_t>{ 1, 400 } || controller.time( base_dt ) != Rational<std::intmax_t>{ 5, 200 } )
+    {
+      std::cerr << "Failed solve did not halve the timestep." << std::endl;
+      return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  }
+  else if( test_name == "coarsen_00" )
+  {
+    TimestepController controller{ 3, 2, 1.0, 0.25, 2 };
+    controller.stepTaken( 2.0, true, 4 );
+    // Calm steps return to the base timestep, then coarsen up to the maximum
+    for( unsigned step = 0; step < 8; ++step )
+    {
+      controller.stepTaken( 0.0, true, 4 );
+    }
+    if( controller.level() != 2 )
+    {
+      std::cerr << "Calm steps did not coarsen the timestep to the maximum." << std::endl;
+      return EXIT_FAILURE;
+    }
+    // Every coarse step ends on an output frame
+    for( unsigned step = 0; step < 3; ++step )
+    {
+      controller.stepTaken( 0.0, true, 4 );
+      if( !controller.atMultipleOfBaseSteps( 4 ) )
+      {
+        std::cerr << "Coarse timestep missed an output frame." << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    return EXIT_SUCCESS;
+  }
+  else if( test_name == "coarsen_01" )
+  {
+    TimestepController controller{ 3, 2, 1.0, 0.25, 2 };
+    // Saving every base step prevents coarsening
+    for( unsigned step = 0; step < 10; ++step )
+    {
+      controller.stepTaken( 0.0, true, 1 );
+    }
+    if( controller.level() != 0 || controller.time( base_dt ) != Rational<std::intmax_t>{ 10, 100 } )
+    {
+      std::cerr << "Timestep coarsened past the output interval." << std::endl;
+      return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  }
+  else if( test_name == "reject_00" )
+  {
+    TimestepController controller{ 2, 2, 1.0, 0.25, 2 };
+    controller.stepTaken( 0.5, true, 4 );
+    if( controller.rejectStep( 0.5, true ) )
+    {
+      std::cerr << "Acceptable step was rejected." << std::endl;
+      return EXIT_FAILURE;
+    }
+    // Deep penetration and failed solves are retaken from the same time with halved steps, down to the finest step
+    if( !controller.rejectStep( 2.0, true ) || !controller.rejectStep( 0.5, false ) )
+    {
+      std::cerr << "Step was not rejected." << std::endl;
+      return EXIT_FAILURE;
+    }
+    if( controller.timestep( base_dt ) != Rational<std::intmax_t>{ 1, 400 } || controller.time( base_dt ) != base_dt || controller.nextIteration() != 5 )
+    {
+      std::cerr << "Rejecting a step advanced time or did not refine the timestep." << std::endl;
+      return EXIT_FAILURE;
+    }
+    if( controller.rejectStep( 2.0, true ) )
+    {
+      std::cerr << "Step at the finest timestep was rejected." << std::endl;
+      return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  }
+  else if( test_name == "reject_01" )
+  {
+    // A fixed timestep never rejects steps
+    TimestepController controller;
+    if( controller.rejectStep( 2.0, false ) )
+    {
+      std::cerr << "Fixed timestep controller rejected a step." << std::endl;
+      return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  }
+
+  std::cerr << "Invalid test specified: " << test_name << std::endl;
+  return EXIT_FAILURE;
+}